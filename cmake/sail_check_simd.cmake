@@ -0,0 +1,68 @@
+# Intended to be included by SAIL.
+#
+function(sail_check_simd)
+    cmake_push_check_state(RESET)
+        # SSSE3 and AVX2 functions are compiled with target attributes (or without any flags with MSVC)
+        # and selected at runtime, so no global compiler flags are needed.
+        #
+        check_c_source_compiles(
+        "
+            #include <immintrin.h>
+
+            #ifdef _MSC_VER
+                #include <intrin.h>
+                #define TARGET(t)
+            #else
+                #define TARGET(t) __attribute__((target(t)))
+            #endif
+
+            TARGET(\"ssse3\") static __m128i shuffle128(__m128i a, __m128i b) {
+                return _mm_shuffle_epi8(a, b);
+            }
+
+            TARGET(\"avx2\") static __m256i shuffle256(__m256i a, __m256i b) {
+                return _mm256_shuffle_epi8(a, b);
+            }
+
+            int main(int argc, char *argv[]) {
+            #ifdef _MSC_VER
+                int info[4];
+                __cpuidex(info, 7, 0);
+                (void)_xgetbv(0);
+            #else
+                __builtin_cpu_init();
+                (void)__builtin_cpu_supports(\"avx2\");
+            #endif
+                (void)shuffle128;
+                (void)shuffle256;
+                return 0;
+            }
+        "
+        SAIL_HAVE_X86_SIMD
+        )
+        if (SAIL_HAVE_X86_SIMD)
+            set(SAIL_HAVE_X86_SIMD_DISPLAY ON CACHE INTERNAL "")
+        else()
+            set(SAIL_HAVE_X86_SIMD_DISPLAY OFF CACHE INTERNAL "")
+        endif()
+
+        # NEON is mandatory on AArch64, so no runtime detection is needed.
+        #
+        check_c_source_compiles(
+        "
+            #include <arm_neon.h>
+
+            int main(int argc, char *argv[]) {
+                const uint8x16_t a = vdupq_n_u8(1);
+                return vgetq_lane_u8(vqtbl1q_u8(a, a), 0);
+            }
+        "
+        SAIL_HAVE_NEON
+        )
+        if (SAIL_HAVE_NEON)
+            set(SAIL_HAVE_NEON_DISPLAY ON CACHE INTERNAL "")
+        else()
+            set(SAIL_HAVE_NEON_DISPLAY OFF CACHE INTERNAL "")
+        endif()
+    cmake_pop_check_state()
+endfunction()
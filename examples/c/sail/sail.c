@@ -267,6 +267,56 @@ static sail_status_t decode(int argc, char *argv[]) {
     return SAIL_OK;
 }
 
+static sail_status_t validate_impl(const char *path) {
+
+    SAIL_CHECK_PTR(path);
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    printf("File          : %s\n", path);
+    printf("Codec         : %s [%s]\n", codec_info->name, codec_info->description);
+    printf("Codec version : %s\n", codec_info->version);
+
+    /* Time counter. */
+    uint64_t start_time = sail_now();
+
+    struct sail_validation_stats stats = { 0 };
+    const sail_status_t status = sail_validate_file(path, &stats);
+
+    uint64_t elapsed_time = sail_now() - start_time;
+
+    printf("Frames        : %u\n", stats.frames);
+
+    if (stats.frames > 0) {
+        printf("Size          : %ux%u\n", stats.width, stats.height);
+        printf("Pixel format  : %s\n", sail_pixel_format_to_string(stats.pixel_format));
+        printf("Pixels        : %llu\n", (unsigned long long)stats.pixels);
+        printf("Buffer size   : %lu bytes\n", (unsigned long)stats.buffer_size);
+    }
+
+    printf("Validate time : %lu ms.\n", (unsigned long)elapsed_time);
+
+    if (status != SAIL_OK) {
+        fprintf(stderr, "Error: Broken image, decoder error %d.\n", status);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t validate(int argc, char *argv[]) {
+
+    if (argc != 3) {
+        print_invalid_argument();
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    SAIL_TRY(validate_impl(argv[2]));
+
+    return SAIL_OK;
+}
+
 static sail_status_t list_impl(bool verbose) {
 
     const struct sail_codec_bundle_node *codec_bundle_node = sail_codec_bundle_list();
@@ -334,6 +384,7 @@ static void help(const char *app) {
     fprintf(stderr, "    probe <PATH> - Retrieve information of the very first image frame found in the file.\n");
     fprintf(stderr, "                   In most cases probing doesn't decode the image data.\n");
     fprintf(stderr, "    decode <PATH> - Decode the whole file and print information of all its frames.\n");
+    fprintf(stderr, "    validate <PATH> - Decode the whole file without keeping its pixels and check it's not broken.\n");
 }
 
 int main(int argc, char *argv[]) {
@@ -364,6 +415,8 @@ int main(int argc, char *argv[]) {
         SAIL_TRY(probe(argc, argv));
     } else if (strcmp(argv[1], "decode") == 0) {
         SAIL_TRY(decode(argc, argv));
+    } else if (strcmp(argv[1], "validate") == 0) {
+        SAIL_TRY(validate(argc, argv));
     } else {
         print_invalid_argument();
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
@@ -206,4 +206,21 @@ std::tuple<image, codec_info> image_input::probe()
     return std::tuple<image, codec_info>{ image(sail_image), codec_info(sail_codec_info) };
 }
 
+image image_input::thumbnail(unsigned max_size)
+{
+    sail_image *sail_image = nullptr;
+
+    SAIL_AT_SCOPE_EXIT(
+        sail_destroy_image(sail_image);
+    );
+
+    SAIL_TRY_OR_EXECUTE(sail_load_thumbnail(&d->abstract_io_adapter->sail_io_c(), max_size, &sail_image),
+                        /* on error */ return {});
+
+    sail::image image(sail_image);
+    sail_image->pixels = nullptr;
+
+    return image;
+}
+
 }
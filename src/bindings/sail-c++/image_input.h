@@ -127,6 +127,14 @@ public:
      */
     std::tuple<image, codec_info> probe();
 
+    /*
+     * Loads a thumbnail of the image which longest side doesn't exceed the specified size.
+     * Embedded previews are used when possible. See sail_load_thumbnail().
+     *
+     * Returns an invalid image on error.
+     */
+    image thumbnail(unsigned max_size);
+
 private:
     class pimpl;
     std::unique_ptr<pimpl> d;
@@ -72,6 +72,13 @@ load_options& load_options::operator=(const sail::load_options &load_options)
 {
     set_options(load_options.options());
     set_tuning(load_options.tuning());
+    set_roi(load_options.roi_x(), load_options.roi_y(), load_options.roi_width(), load_options.roi_height());
+    set_max_dimensions(load_options.max_width(), load_options.max_height());
+    set_max_pixels(load_options.max_pixels());
+    set_max_memory(load_options.max_memory());
+    set_max_frames(load_options.max_frames());
+    set_max_meta_data_size(load_options.max_meta_data_size());
+    set_output_pixel_format(load_options.output_pixel_format());
 
     return *this;
 }
@@ -107,6 +114,61 @@ const sail::tuning& load_options::tuning() const
     return d->tuning;
 }
 
+unsigned load_options::roi_x() const
+{
+    return d->sail_load_options->roi_x;
+}
+
+unsigned load_options::roi_y() const
+{
+    return d->sail_load_options->roi_y;
+}
+
+unsigned load_options::roi_width() const
+{
+    return d->sail_load_options->roi_width;
+}
+
+unsigned load_options::roi_height() const
+{
+    return d->sail_load_options->roi_height;
+}
+
+unsigned load_options::max_width() const
+{
+    return d->sail_load_options->max_width;
+}
+
+unsigned load_options::max_height() const
+{
+    return d->sail_load_options->max_height;
+}
+
+std::uint64_t load_options::max_pixels() const
+{
+    return d->sail_load_options->max_pixels;
+}
+
+std::size_t load_options::max_memory() const
+{
+    return d->sail_load_options->max_memory;
+}
+
+unsigned load_options::max_frames() const
+{
+    return d->sail_load_options->max_frames;
+}
+
+std::size_t load_options::max_meta_data_size() const
+{
+    return d->sail_load_options->max_meta_data_size;
+}
+
+SailPixelFormat load_options::output_pixel_format() const
+{
+    return d->sail_load_options->output_pixel_format;
+}
+
 void load_options::set_options(int options)
 {
     d->sail_load_options->options = options;
@@ -117,6 +179,45 @@ void load_options::set_tuning(const sail::tuning &tuning)
     d->tuning = tuning;
 }
 
+void load_options::set_roi(unsigned x, unsigned y, unsigned width, unsigned height)
+{
+    d->sail_load_options->roi_x      = x;
+    d->sail_load_options->roi_y      = y;
+    d->sail_load_options->roi_width  = width;
+    d->sail_load_options->roi_height = height;
+}
+
+void load_options::set_max_dimensions(unsigned width, unsigned height)
+{
+    d->sail_load_options->max_width  = width;
+    d->sail_load_options->max_height = height;
+}
+
+void load_options::set_max_pixels(std::uint64_t max_pixels)
+{
+    d->sail_load_options->max_pixels = max_pixels;
+}
+
+void load_options::set_max_memory(std::size_t max_memory)
+{
+    d->sail_load_options->max_memory = max_memory;
+}
+
+void load_options::set_max_frames(unsigned max_frames)
+{
+    d->sail_load_options->max_frames = max_frames;
+}
+
+void load_options::set_max_meta_data_size(std::size_t max_meta_data_size)
+{
+    d->sail_load_options->max_meta_data_size = max_meta_data_size;
+}
+
+void load_options::set_output_pixel_format(SailPixelFormat output_pixel_format)
+{
+    d->sail_load_options->output_pixel_format = output_pixel_format;
+}
+
 load_options::load_options(const sail_load_options *ro)
     : load_options()
 {
@@ -127,6 +228,13 @@ load_options::load_options(const sail_load_options *ro)
 
     set_options(ro->options);
     set_tuning(utils_private::c_tuning_to_cpp_tuning(ro->tuning));
+    set_roi(ro->roi_x, ro->roi_y, ro->roi_width, ro->roi_height);
+    set_max_dimensions(ro->max_width, ro->max_height);
+    set_max_pixels(ro->max_pixels);
+    set_max_memory(ro->max_memory);
+    set_max_frames(ro->max_frames);
+    set_max_meta_data_size(ro->max_meta_data_size);
+    set_output_pixel_format(ro->output_pixel_format);
 }
 
 sail_status_t load_options::to_sail_load_options(sail_load_options **load_options) const
@@ -137,7 +245,18 @@ sail_status_t load_options::to_sail_load_options(sail_load_options **load_option
 
     SAIL_TRY(sail_alloc_load_options(&load_options_local));
 
-    load_options_local->options = d->sail_load_options->options;
+    load_options_local->options             = d->sail_load_options->options;
+    load_options_local->roi_x               = d->sail_load_options->roi_x;
+    load_options_local->roi_y               = d->sail_load_options->roi_y;
+    load_options_local->roi_width           = d->sail_load_options->roi_width;
+    load_options_local->roi_height          = d->sail_load_options->roi_height;
+    load_options_local->max_width           = d->sail_load_options->max_width;
+    load_options_local->max_height          = d->sail_load_options->max_height;
+    load_options_local->max_pixels          = d->sail_load_options->max_pixels;
+    load_options_local->max_memory          = d->sail_load_options->max_memory;
+    load_options_local->max_frames          = d->sail_load_options->max_frames;
+    load_options_local->max_meta_data_size  = d->sail_load_options->max_meta_data_size;
+    load_options_local->output_pixel_format = d->sail_load_options->output_pixel_format;
 
     SAIL_TRY_OR_CLEANUP(sail_alloc_hash_map(&load_options_local->tuning),
                         /* cleanup */ sail_destroy_load_options(load_options_local));
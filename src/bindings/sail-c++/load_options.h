@@ -26,6 +26,8 @@
 #ifndef SAIL_LOAD_OPTIONS_CPP_H
 #define SAIL_LOAD_OPTIONS_CPP_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -116,6 +118,62 @@ public:
      */
     const sail::tuning& tuning() const;
 
+    /*
+     * Returns the X coordinate of the region of interest.
+     */
+    unsigned roi_x() const;
+
+    /*
+     * Returns the Y coordinate of the region of interest.
+     */
+    unsigned roi_y() const;
+
+    /*
+     * Returns the width of the region of interest. 0 means the region of interest is not set.
+     */
+    unsigned roi_width() const;
+
+    /*
+     * Returns the height of the region of interest. 0 means the region of interest is not set.
+     */
+    unsigned roi_height() const;
+
+    /*
+     * Returns the maximum frame width. 0 means no limit.
+     */
+    unsigned max_width() const;
+
+    /*
+     * Returns the maximum frame height. 0 means no limit.
+     */
+    unsigned max_height() const;
+
+    /*
+     * Returns the maximum number of pixels in a frame. 0 means no limit.
+     */
+    std::uint64_t max_pixels() const;
+
+    /*
+     * Returns the maximum size of a single allocation depending on the image contents. 0 means no limit.
+     */
+    std::size_t max_memory() const;
+
+    /*
+     * Returns the maximum number of frames. 0 means no limit.
+     */
+    unsigned max_frames() const;
+
+    /*
+     * Returns the maximum total size of the meta data and the ICC profile of a frame. 0 means no limit.
+     */
+    std::size_t max_meta_data_size() const;
+
+    /*
+     * Returns the requested pixel format of loaded frames. SAIL_PIXEL_FORMAT_UNKNOWN means
+     * the pixel format closest to the stored one.
+     */
+    SailPixelFormat output_pixel_format() const;
+
     /*
      * Sets new or-ed manipulation options for loading operations. See SailOption.
      */
@@ -126,6 +184,48 @@ public:
      */
     void set_tuning(const sail::tuning &tuning);
 
+    /*
+     * Sets a new region of interest to load. Only the part of every frame intersecting
+     * the rectangle is loaded. Codecs with SAIL_CODEC_FEATURE_ROI don't decode the rest
+     * of the frame. Zero width or height resets the region of interest.
+     */
+    void set_roi(unsigned x, unsigned y, unsigned width, unsigned height);
+
+    /*
+     * Sets the maximum frame dimensions. Loading fails with SAIL_ERROR_LIMIT_EXCEEDED
+     * when a frame is larger. 0 means no limit.
+     */
+    void set_max_dimensions(unsigned width, unsigned height);
+
+    /*
+     * Sets the maximum number of pixels in a frame. 0 means no limit.
+     */
+    void set_max_pixels(std::uint64_t max_pixels);
+
+    /*
+     * Sets the maximum size of a single allocation depending on the image contents.
+     * For example, frame pixels or codec-internal canvases. 0 means no limit.
+     */
+    void set_max_memory(std::size_t max_memory);
+
+    /*
+     * Sets the maximum number of frames. 0 means no limit.
+     */
+    void set_max_frames(unsigned max_frames);
+
+    /*
+     * Sets the maximum total size of the meta data and the ICC profile of a frame. 0 means no limit.
+     */
+    void set_max_meta_data_size(std::size_t max_meta_data_size);
+
+    /*
+     * Sets the requested pixel format of loaded frames. Codecs produce it while decoding
+     * when possible. Otherwise, frames are converted right after loading. Loading fails
+     * with SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT when the conversion is not supported.
+     * SAIL_PIXEL_FORMAT_UNKNOWN loads frames in the pixel format closest to the stored one.
+     */
+    void set_output_pixel_format(SailPixelFormat output_pixel_format);
+
 private:
     /*
      * Makes a deep copy of the specified load options and stores the pointer for further use.
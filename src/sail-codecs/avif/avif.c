@@ -165,6 +165,27 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_avif(void *state, s
     avifRGBImageSetDefaults(&avif_state->rgb_image, avif_image);
     avif_state->rgb_image.depth = avif_private_round_depth(avif_state->rgb_image.depth);
 
+    /* Let libavif produce the requested pixel format. Otherwise, it's converted after loading. */
+    if (avif_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+        enum avifRGBFormat rgb_pixel_format;
+        uint32_t depth;
+        bool is_float;
+
+        if (avif_private_sail_pixel_format_to_rgb_format(avif_state->load_options->output_pixel_format, &rgb_pixel_format, &depth, &is_float)) {
+            avif_state->rgb_image.format = rgb_pixel_format;
+            avif_state->rgb_image.depth  = depth;
+#ifdef SAIL_AVIF_HAVE_HALF_FLOAT
+            avif_state->rgb_image.isFloat = is_float ? AVIF_TRUE : AVIF_FALSE;
+#endif
+        }
+    }
+
+#ifdef SAIL_AVIF_HAVE_HALF_FLOAT
+    const bool is_float = avif_state->rgb_image.isFloat;
+#else
+    const bool is_float = false;
+#endif
+
     if (avif_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
         SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
                             /* cleanup */ sail_destroy_image(image_local));
@@ -177,7 +198,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_avif(void *state, s
 
     image_local->width          = avif_image->width;
     image_local->height         = avif_image->height;
-    image_local->pixel_format   = avif_private_rgb_sail_pixel_format(avif_state->rgb_image.format, avif_state->rgb_image.depth);
+    image_local->pixel_format   = avif_private_rgb_sail_pixel_format(avif_state->rgb_image.format, avif_state->rgb_image.depth, is_float);
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
     image_local->delay          = (int)(avif_state->avif_decoder->imageTiming.duration * 1000);
 
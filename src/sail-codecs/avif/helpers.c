@@ -67,7 +67,20 @@ enum SailChromaSubsampling avif_private_sail_chroma_subsampling(enum avifPixelFo
     }
 }
 
-enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth) {
+enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth, bool is_float) {
+
+    if (is_float) {
+        if (depth != 16) {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+
+        switch (rgb_pixel_format) {
+            case AVIF_RGB_FORMAT_RGB:  return SAIL_PIXEL_FORMAT_BPP48_RGB_HALF;
+            case AVIF_RGB_FORMAT_RGBA: return SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF;
+
+            default: return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
 
     switch (depth) {
         case 8: {
@@ -100,6 +113,36 @@ enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_p
     }
 }
 
+bool avif_private_sail_pixel_format_to_rgb_format(enum SailPixelFormat pixel_format, enum avifRGBFormat *rgb_pixel_format, uint32_t *depth, bool *is_float) {
+
+    *is_float = false;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  *rgb_pixel_format = AVIF_RGB_FORMAT_RGB;  *depth = 8; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: *rgb_pixel_format = AVIF_RGB_FORMAT_RGBA; *depth = 8; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: *rgb_pixel_format = AVIF_RGB_FORMAT_ARGB; *depth = 8; return true;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  *rgb_pixel_format = AVIF_RGB_FORMAT_BGR;  *depth = 8; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: *rgb_pixel_format = AVIF_RGB_FORMAT_BGRA; *depth = 8; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: *rgb_pixel_format = AVIF_RGB_FORMAT_ABGR; *depth = 8; return true;
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:  *rgb_pixel_format = AVIF_RGB_FORMAT_RGB;  *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: *rgb_pixel_format = AVIF_RGB_FORMAT_RGBA; *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: *rgb_pixel_format = AVIF_RGB_FORMAT_ARGB; *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP48_BGR:  *rgb_pixel_format = AVIF_RGB_FORMAT_BGR;  *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: *rgb_pixel_format = AVIF_RGB_FORMAT_BGRA; *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: *rgb_pixel_format = AVIF_RGB_FORMAT_ABGR; *depth = 16; return true;
+
+#ifdef SAIL_AVIF_HAVE_HALF_FLOAT
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:  *rgb_pixel_format = AVIF_RGB_FORMAT_RGB;  *depth = 16; *is_float = true; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF: *rgb_pixel_format = AVIF_RGB_FORMAT_RGBA; *depth = 16; *is_float = true; return true;
+#endif
+
+        default: {
+            return false;
+        }
+    }
+}
+
 uint32_t avif_private_round_depth(uint32_t depth) {
 
     if (depth > 8) {
@@ -35,13 +35,20 @@
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+/* avifRGBImage.isFloat, half-float RGB output, was added in libavif 0.9.1. */
+#if AVIF_VERSION_MAJOR > 0 || AVIF_VERSION_MINOR > 9 || (AVIF_VERSION_MINOR == 9 && AVIF_VERSION_PATCH >= 1)
+    #define SAIL_AVIF_HAVE_HALF_FLOAT
+#endif
+
 struct sail_meta_data_node;
 
 SAIL_HIDDEN enum SailPixelFormat avif_private_sail_pixel_format(enum avifPixelFormat avif_pixel_format, uint32_t depth, bool has_alpha);
 
 SAIL_HIDDEN enum SailChromaSubsampling avif_private_sail_chroma_subsampling(enum avifPixelFormat avif_pixel_format);
 
-SAIL_HIDDEN enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth);
+SAIL_HIDDEN enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth, bool is_float);
+
+SAIL_HIDDEN bool avif_private_sail_pixel_format_to_rgb_format(enum SailPixelFormat pixel_format, enum avifRGBFormat *rgb_pixel_format, uint32_t *depth, bool *is_float);
 
 SAIL_HIDDEN uint32_t avif_private_round_depth(uint32_t depth);
 
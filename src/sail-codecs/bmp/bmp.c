@@ -84,7 +84,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_bmp(struct sail_io *io, const
     SAIL_TRY(alloc_bmp_state(io, load_options, NULL, &bmp_state));
     *state = bmp_state;
 
-    SAIL_TRY(bmp_private_read_init(io, bmp_state->load_options, &bmp_state->common_bmp_state, SAIL_READ_BMP_FILE_HEADER));
+    SAIL_TRY(bmp_private_read_init(io, bmp_state->load_options, &bmp_state->common_bmp_state, SAIL_READ_BMP_FILE_HEADER | SAIL_READ_BMP_ROI));
 
     return SAIL_OK;
 }
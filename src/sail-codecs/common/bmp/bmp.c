@@ -95,6 +95,10 @@ struct bmp_state {
     /* Number of bytes to pad scan lines to 4-byte boundary. */
     unsigned pad_bytes;
     bool flipped;
+
+    /* Region of interest. */
+    unsigned roi_x;
+    unsigned roi_y;
 };
 
 static sail_status_t alloc_bmp_state(struct bmp_state **bmp_state) {
@@ -116,6 +120,8 @@ static sail_status_t alloc_bmp_state(struct bmp_state **bmp_state) {
     (*bmp_state)->bytes_in_row     = 0;
     (*bmp_state)->pad_bytes        = 0;
     (*bmp_state)->flipped          = false;
+    (*bmp_state)->roi_x            = 0;
+    (*bmp_state)->roi_y            = 0;
 
     return SAIL_OK;
 }
@@ -353,6 +359,20 @@ sail_status_t bmp_private_read_seek_next_frame(void *state, struct sail_io *io,
         image_local->bytes_per_line = bmp_state->bytes_in_row;
     }
 
+    /* Region of interest. */
+    if (bmp_state->bmp_load_options & SAIL_READ_BMP_ROI) {
+        const unsigned width  = image_local->width;
+        const unsigned height = image_local->height;
+
+        SAIL_TRY_OR_CLEANUP(sail_intersect_roi(bmp_state->load_options, width, height,
+                                                &bmp_state->roi_x, &bmp_state->roi_y, &image_local->width, &image_local->height),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        if (image_local->width != width) {
+            image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+        }
+    }
+
     if (bmp_state->palette != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, bmp_state->palette_count, &image_local->palette),
                             /* cleanup */ sail_destroy_image(image_local));
@@ -386,152 +406,286 @@ sail_status_t bmp_private_read_seek_next_frame(void *state, struct sail_io *io,
     return SAIL_OK;
 }
 
-sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sail_image *image) {
-
-    struct bmp_state *bmp_state = state;
+/* Runs must not cross the end of scan line. */
+static sail_status_t check_rle_run(unsigned pixel_index, unsigned count, unsigned width) {
 
-    /* RLE-encoded images don't need to skip pad bytes. */
-    bool skip_pad_bytes = true;
+    if (pixel_index + count > width) {
+        SAIL_LOG_ERROR("BMP: RLE run of %u pixels at pixel %u exceeds the scan line width %u", count, pixel_index, width);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
 
-    for (unsigned i = image->height; i > 0; i--) {
-        unsigned char *scan = sail_scan_line(image, bmp_state->flipped ? (i - 1) : (image->height - i));
-
-        for (unsigned pixel_index = 0; pixel_index < image->width;) {
-            if (bmp_state->version >= SAIL_BMP_V3 && bmp_state->v3.compression == SAIL_BI_RLE4) {
-                skip_pad_bytes = false;
-
-                uint8_t marker;
-                SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
-
-                if (marker == SAIL_BMP_UNENCODED_RUN_MARKER) {
-                    uint8_t count_or_marker;
-                    SAIL_TRY(io->strict_read(io->stream, &count_or_marker, sizeof(count_or_marker)));
-
-                    if (count_or_marker == SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
-                        /* Jump to the end of scan line. +1 to avoid reading end-of-scan-line marker twice below. */
-                        pixel_index = image->width + 1;
-                    } else if (count_or_marker == SAIL_BMP_END_OF_RLE_DATA_MARKER) {
-                        SAIL_LOG_ERROR("BMP: Unexpected end-of-rle-data marker");
-                        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-                    } else if (count_or_marker == SAIL_BMP_DELTA_MARKER) {
-                        SAIL_LOG_ERROR("BMP: Delta marker is not supported");
-                        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
-                    } else {
-                        bool read_byte = true;
-                        uint8_t byte = 0;
-                        uint8_t index;
+    return SAIL_OK;
+}
 
-                        for (uint8_t k = 0; k < count_or_marker; k++) {
-                            if (read_byte) {
-                                SAIL_TRY(io->strict_read(io->stream, &byte, sizeof(byte)));
-                                index = (byte >> 4) & 0xf;
-                                read_byte = false;
-                            } else {
-                                index = byte & 0xf;
-                                read_byte = true;
-                            }
-
-                            *scan++ = index;
-                        }
+/* Reads the next scan line of the specified width in the file order. */
+static sail_status_t read_scan_line(const struct bmp_state *bmp_state, struct sail_io *io, unsigned width, unsigned char *scan) {
 
-                        /* Odd number of bytes is accompanied with an additional byte. */
-                        uint8_t number_of_unencoded_bytes = (count_or_marker + 1) / 2;
-                        if ((number_of_unencoded_bytes % 2) != 0) {
-                            SAIL_TRY(io->seek(io->stream, 1, SEEK_CUR));
-                        }
+    /* RLE-encoded images don't need to skip pad bytes. */
+    bool skip_pad_bytes = true;
 
-                        pixel_index += count_or_marker;
-                    }
+    for (unsigned pixel_index = 0; pixel_index < width;) {
+        if (bmp_state->version >= SAIL_BMP_V3 && bmp_state->v3.compression == SAIL_BI_RLE4) {
+            skip_pad_bytes = false;
+
+            uint8_t marker;
+            SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
+
+            if (marker == SAIL_BMP_UNENCODED_RUN_MARKER) {
+                uint8_t count_or_marker;
+                SAIL_TRY(io->strict_read(io->stream, &count_or_marker, sizeof(count_or_marker)));
+
+                if (count_or_marker == SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
+                    /* Jump to the end of scan line. +1 to avoid reading end-of-scan-line marker twice below. */
+                    pixel_index = width + 1;
+                } else if (count_or_marker == SAIL_BMP_END_OF_RLE_DATA_MARKER) {
+                    SAIL_LOG_ERROR("BMP: Unexpected end-of-rle-data marker");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+                } else if (count_or_marker == SAIL_BMP_DELTA_MARKER) {
+                    SAIL_LOG_ERROR("BMP: Delta marker is not supported");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
                 } else {
-                    /* Normal RLE: count + value. */
-                    bool high_4_bits = true;
-                    uint8_t index;
+                    SAIL_TRY(check_rle_run(pixel_index, count_or_marker, width));
 
-                    uint8_t byte;
-                    SAIL_TRY(io->strict_read(io->stream, &byte, sizeof(byte)));
+                    bool read_byte = true;
+                    uint8_t byte = 0;
+                    uint8_t index;
 
-                    for (uint8_t k = 0; k < marker; k++) {
-                        if (high_4_bits) {
+                    for (uint8_t k = 0; k < count_or_marker; k++) {
+                        if (read_byte) {
+                            SAIL_TRY(io->strict_read(io->stream, &byte, sizeof(byte)));
                             index = (byte >> 4) & 0xf;
-                            high_4_bits = false;
+                            read_byte = false;
                         } else {
                             index = byte & 0xf;
-                            high_4_bits = true;
+                            read_byte = true;
                         }
 
                         *scan++ = index;
                     }
 
-                    pixel_index += marker;
-                }
+                    /* Odd number of bytes is accompanied with an additional byte. */
+                    uint8_t number_of_unencoded_bytes = (count_or_marker + 1) / 2;
+                    if ((number_of_unencoded_bytes % 2) != 0) {
+                        SAIL_TRY(io->seek(io->stream, 1, SEEK_CUR));
+                    }
 
-                /* Read a possible end-of-scan-line marker at the end of line. */
-                if (pixel_index == image->width) {
-                    SAIL_TRY(bmp_private_skip_end_of_scan_line(io));
+                    pixel_index += count_or_marker;
                 }
-            } else if (bmp_state->version >= SAIL_BMP_V3 && bmp_state->v3.compression == SAIL_BI_RLE8) {
-                skip_pad_bytes = false;
-
-                uint8_t marker;
-                SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
-
-                if (marker == SAIL_BMP_UNENCODED_RUN_MARKER) {
-                    uint8_t count_or_marker;
-                    SAIL_TRY(io->strict_read(io->stream, &count_or_marker, sizeof(count_or_marker)));
-
-                    if (count_or_marker == SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
-                        /* Jump to the end of scan line. +1 to avoid reading end-of-scan-line marker twice below. */
-                        pixel_index = image->width + 1;
-                    } else if (count_or_marker == SAIL_BMP_END_OF_RLE_DATA_MARKER) {
-                        SAIL_LOG_ERROR("BMP: Unexpected end-of-rle-data marker");
-                        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-                    } else if (count_or_marker == SAIL_BMP_DELTA_MARKER) {
-                        SAIL_LOG_ERROR("BMP: Delta marker is not supported");
-                        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
-                    } else {
-                        for (uint8_t k = 0; k < count_or_marker; k++) {
-                            uint8_t index;
-                            SAIL_TRY(io->strict_read(io->stream, &index, sizeof(index)));
+            } else {
+                /* Normal RLE: count + value. */
+                SAIL_TRY(check_rle_run(pixel_index, marker, width));
 
-                            *scan++ = index;
-                        }
+                bool high_4_bits = true;
+                uint8_t index;
 
-                        /* Odd number of pixels is accompanied with an additional byte. */
-                        if ((count_or_marker % 2) != 0) {
-                            SAIL_TRY(io->seek(io->stream, 1, SEEK_CUR));
-                        }
+                uint8_t byte;
+                SAIL_TRY(io->strict_read(io->stream, &byte, sizeof(byte)));
 
-                        pixel_index += count_or_marker;
+                for (uint8_t k = 0; k < marker; k++) {
+                    if (high_4_bits) {
+                        index = (byte >> 4) & 0xf;
+                        high_4_bits = false;
+                    } else {
+                        index = byte & 0xf;
+                        high_4_bits = true;
                     }
+
+                    *scan++ = index;
+                }
+
+                pixel_index += marker;
+            }
+
+            /* Read a possible end-of-scan-line marker at the end of line. */
+            if (pixel_index == width) {
+                SAIL_TRY(bmp_private_skip_end_of_scan_line(io));
+            }
+        } else if (bmp_state->version >= SAIL_BMP_V3 && bmp_state->v3.compression == SAIL_BI_RLE8) {
+            skip_pad_bytes = false;
+
+            uint8_t marker;
+            SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
+
+            if (marker == SAIL_BMP_UNENCODED_RUN_MARKER) {
+                uint8_t count_or_marker;
+                SAIL_TRY(io->strict_read(io->stream, &count_or_marker, sizeof(count_or_marker)));
+
+                if (count_or_marker == SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
+                    /* Jump to the end of scan line. +1 to avoid reading end-of-scan-line marker twice below. */
+                    pixel_index = width + 1;
+                } else if (count_or_marker == SAIL_BMP_END_OF_RLE_DATA_MARKER) {
+                    SAIL_LOG_ERROR("BMP: Unexpected end-of-rle-data marker");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+                } else if (count_or_marker == SAIL_BMP_DELTA_MARKER) {
+                    SAIL_LOG_ERROR("BMP: Delta marker is not supported");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
                 } else {
-                    /* Normal RLE: count + value. */
-                    uint8_t index;
-                    SAIL_TRY(io->strict_read(io->stream, &index, sizeof(index)));
+                    SAIL_TRY(check_rle_run(pixel_index, count_or_marker, width));
+
+                    for (uint8_t k = 0; k < count_or_marker; k++) {
+                        uint8_t index;
+                        SAIL_TRY(io->strict_read(io->stream, &index, sizeof(index)));
 
-                    for (uint8_t k = 0; k < marker; k++) {
                         *scan++ = index;
                     }
 
-                    pixel_index += marker;
-                }
+                    /* Odd number of pixels is accompanied with an additional byte. */
+                    if ((count_or_marker % 2) != 0) {
+                        SAIL_TRY(io->seek(io->stream, 1, SEEK_CUR));
+                    }
 
-                /* Read a possible end-of-scan-line marker at the end of line. */
-                if (pixel_index == image->width) {
-                    SAIL_TRY(bmp_private_skip_end_of_scan_line(io));
+                    pixel_index += count_or_marker;
                 }
             } else {
-                /* Read a whole scan line. */
-                SAIL_TRY(io->strict_read(io->stream, scan, bmp_state->bytes_in_row));
-                pixel_index += image->width;
+                /* Normal RLE: count + value. */
+                SAIL_TRY(check_rle_run(pixel_index, marker, width));
+
+                uint8_t index;
+                SAIL_TRY(io->strict_read(io->stream, &index, sizeof(index)));
+
+                for (uint8_t k = 0; k < marker; k++) {
+                    *scan++ = index;
+                }
+
+                pixel_index += marker;
+            }
+
+            /* Read a possible end-of-scan-line marker at the end of line. */
+            if (pixel_index == width) {
+                SAIL_TRY(bmp_private_skip_end_of_scan_line(io));
             }
+        } else {
+            /* Read a whole scan line. */
+            SAIL_TRY(io->strict_read(io->stream, scan, bmp_state->bytes_in_row));
+            pixel_index += width;
+        }
+    }
+
+    /* Skip pad bytes. */
+    if (skip_pad_bytes) {
+        SAIL_TRY(io->seek(io->stream, bmp_state->pad_bytes, SEEK_CUR));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_pixels(const struct bmp_state *bmp_state, struct sail_io *io, struct sail_image *image) {
+
+    /* Validation decodes all the rows into the very first scan line. */
+    const bool validate = bmp_state->load_options->options & SAIL_OPTION_VALIDATE;
+
+    for (unsigned i = image->height; i > 0; i--) {
+        SAIL_TRY(sail_check_cancel_token(bmp_state->load_options->cancel_token));
+
+        unsigned char *scan = sail_scan_line(image, validate ? 0 : (bmp_state->flipped ? (i - 1) : (image->height - i)));
+
+        SAIL_TRY(read_scan_line(bmp_state, io, image->width, scan));
+    }
+
+    return SAIL_OK;
+}
+
+/* Reads the rows and columns of uncompressed pixels intersecting the region of interest. */
+static sail_status_t read_roi_pixels(const struct bmp_state *bmp_state, struct sail_io *io, struct sail_image *image) {
+
+    const unsigned height         = (bmp_state->version == SAIL_BMP_V1) ? bmp_state->v1.height : (unsigned)bmp_state->v2.height;
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+
+    const size_t file_bytes_per_line = (size_t)bmp_state->bytes_in_row + bmp_state->pad_bytes;
+    const size_t first_byte          = (size_t)bmp_state->roi_x * bits_per_pixel / 8;
+    const unsigned x_in_first_byte   = bmp_state->roi_x - (unsigned)(first_byte * 8 / bits_per_pixel);
+    const size_t bytes_to_read       = sail_bytes_per_line(x_in_first_byte + image->width, image->pixel_format);
+
+    unsigned char *scanline = NULL;
+
+    if (x_in_first_byte != 0) {
+        void *ptr;
+        SAIL_TRY(sail_malloc(bytes_to_read, &ptr));
+        scanline = ptr;
+    }
+
+    size_t offset;
+    SAIL_TRY_OR_CLEANUP(io->tell(io->stream, &offset),
+                        /* cleanup */ sail_free(scanline));
+
+    for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY_OR_CLEANUP(sail_check_cancel_token(bmp_state->load_options->cancel_token),
+                            /* cleanup */ sail_free(scanline));
+
+        const unsigned file_row = bmp_state->flipped ? height - 1 - (bmp_state->roi_y + row) : bmp_state->roi_y + row;
+
+        SAIL_TRY_OR_CLEANUP(io->seek(io->stream, (long)(offset + file_row * file_bytes_per_line + first_byte), SEEK_SET),
+                            /* cleanup */ sail_free(scanline));
+
+        if (scanline == NULL) {
+            SAIL_TRY_OR_CLEANUP(io->strict_read(io->stream, sail_scan_line(image, row), image->bytes_per_line),
+                                /* cleanup */ sail_free(scanline));
+        } else {
+            SAIL_TRY_OR_CLEANUP(io->strict_read(io->stream, scanline, bytes_to_read),
+                                /* cleanup */ sail_free(scanline));
+
+            sail_copy_scan_line_pixels(scanline, x_in_first_byte, image->width, image->pixel_format, sail_scan_line(image, row));
         }
+    }
+
+    sail_free(scanline);
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sail_image *image) {
+
+    const struct bmp_state *bmp_state = state;
+
+    const unsigned width  = (bmp_state->version == SAIL_BMP_V1) ? bmp_state->v1.width  : (unsigned)bmp_state->v2.width;
+    const unsigned height = (bmp_state->version == SAIL_BMP_V1) ? bmp_state->v1.height : (unsigned)bmp_state->v2.height;
+
+    if (!(bmp_state->bmp_load_options & SAIL_READ_BMP_ROI) || (image->width == width && image->height == height)) {
+        SAIL_TRY(read_pixels(bmp_state, io, image));
+        return SAIL_OK;
+    }
+
+    const bool rle = bmp_state->version >= SAIL_BMP_V3 &&
+                        (bmp_state->v3.compression == SAIL_BI_RLE4 || bmp_state->v3.compression == SAIL_BI_RLE8);
+
+    if (!rle) {
+        SAIL_TRY(read_roi_pixels(bmp_state, io, image));
+        return SAIL_OK;
+    }
+
+    /*
+     * RLE-encoded rows cannot be seeked to, so the rows are decoded one by one in the file order
+     * until the last row of the region. RLE4-encoded pixels are expanded to 8-bit.
+     */
+    const size_t scan_line_size = (bmp_state->v3.compression == SAIL_BI_RLE4) ? (size_t)bmp_state->bytes_in_row * 2 : bmp_state->bytes_in_row;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(scan_line_size, &ptr));
+    unsigned char *scan_line = ptr;
 
-        /* Skip pad bytes. */
-        if (skip_pad_bytes) {
-            SAIL_TRY(io->seek(io->stream, bmp_state->pad_bytes, SEEK_CUR));
+    /* Bottom-up frames end the region with its first row. */
+    const unsigned file_rows = bmp_state->flipped ? height - bmp_state->roi_y : bmp_state->roi_y + image->height;
+
+    for (unsigned file_row = 0; file_row < file_rows; file_row++) {
+        SAIL_TRY_OR_CLEANUP(sail_check_cancel_token(bmp_state->load_options->cancel_token),
+                            /* cleanup */ sail_free(scan_line));
+
+        /* Pixels after an early end-of-scan-line marker are not set by the decoder. */
+        memset(scan_line, 0, scan_line_size);
+
+        SAIL_TRY_OR_CLEANUP(read_scan_line(bmp_state, io, width, scan_line),
+                            /* cleanup */ sail_free(scan_line));
+
+        const unsigned frame_row = bmp_state->flipped ? height - 1 - file_row : file_row;
+
+        if (frame_row >= bmp_state->roi_y && frame_row < bmp_state->roi_y + image->height) {
+            sail_copy_scan_line_pixels(scan_line, bmp_state->roi_x, image->width, image->pixel_format,
+                                        sail_scan_line(image, frame_row - bmp_state->roi_y));
         }
     }
 
+    sail_free(scan_line);
+
     return SAIL_OK;
 }
 
@@ -46,6 +46,12 @@ enum SailBmpReadOptions {
      * ICO files have no BMP file headers.
      */
     SAIL_READ_BMP_FILE_HEADER = 1 << 0,
+
+    /*
+     * Load only the region of interest from the load options. Codecs passing this flag
+     * must declare SAIL_CODEC_FEATURE_ROI so SAIL doesn't crop the frames again.
+     */
+    SAIL_READ_BMP_ROI = 1 << 1,
 };
 
 SAIL_HIDDEN sail_status_t bmp_private_read_init(struct sail_io *io, const struct sail_load_options *load_options, void **state, int bmp_load_options);
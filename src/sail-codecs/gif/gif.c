@@ -153,6 +153,10 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_gif(struct sail_io *io, const
         memset(&gif_state->background, 0, sizeof(gif_state->background));
     }
 
+    /* The screen buffer has the size of the logical screen regardless of the frame sizes. */
+    SAIL_TRY(sail_check_dimensions_limit(gif_state->load_options, gif_state->gif->SWidth, gif_state->gif->SHeight));
+    SAIL_TRY(sail_check_memory_limit(gif_state->load_options, (uint64_t)gif_state->gif->SWidth * gif_state->gif->SHeight * 4));
+
     void *ptr;
 
     SAIL_TRY(sail_malloc(gif_state->gif->SWidth * sizeof(GifPixelType), &ptr));
@@ -323,7 +327,13 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_gif(void *state, st
                 }
             }
 
-            image_local->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+            /*
+             * Frames are composed of opaque pixels and transparent black ones, so they're
+             * premultiplied as is.
+             */
+            image_local->pixel_format = (gif_state->load_options->output_pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED)
+                                            ? SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+                                            : SAIL_PIXEL_FORMAT_BPP32_RGBA;
             image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
             break;
@@ -396,6 +406,8 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_gif(void *state, struct sail_
             }
 
             if (do_read) {
+                SAIL_TRY(sail_check_cancel_token(gif_state->load_options->cancel_token));
+
                 if (DGifGetLine(gif_state->gif, gif_state->buf, gif_state->width) == GIF_ERROR) {
                     SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif_state->gif->Error));
                     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
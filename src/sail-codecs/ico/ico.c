@@ -145,6 +145,11 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_ico(void *state, st
         SAIL_TRY(ico_private_probe_image_type(ico_state->io, &ico_image_type));
     } while (ico_image_type != SAIL_ICO_IMAGE_BMP);
 
+    /* The previous frame may have been skipped without loading. */
+    if (ico_state->common_bmp_state != NULL) {
+        SAIL_TRY(bmp_private_read_finish(&ico_state->common_bmp_state, ico_state->io));
+    }
+
     /* Continue to loading BMP. */
     struct sail_image *image_local;
 
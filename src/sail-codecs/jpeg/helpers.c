@@ -32,6 +32,10 @@
 
 #include "helpers.h"
 
+/* APP1 marker signature of EXIF data. */
+static const char EXIF_SIGNATURE[] = { 'E', 'x', 'i', 'f', '\0', '\0' };
+static const size_t EXIF_SIGNATURE_SIZE = sizeof(EXIF_SIGNATURE);
+
 void jpeg_private_my_output_message(j_common_ptr cinfo) {
     char buffer[JMSG_LENGTH_MAX];
 
@@ -63,6 +67,11 @@ enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLOR_SPACE colo
         case JCS_EXT_BGRA:  return SAIL_PIXEL_FORMAT_BPP32_BGRA;
         case JCS_EXT_ABGR:  return SAIL_PIXEL_FORMAT_BPP32_ABGR;
         case JCS_EXT_ARGB:  return SAIL_PIXEL_FORMAT_BPP32_ARGB;
+
+        case JCS_EXT_RGBX:  return SAIL_PIXEL_FORMAT_BPP32_RGBX;
+        case JCS_EXT_BGRX:  return SAIL_PIXEL_FORMAT_BPP32_BGRX;
+        case JCS_EXT_XBGR:  return SAIL_PIXEL_FORMAT_BPP32_XBGR;
+        case JCS_EXT_XRGB:  return SAIL_PIXEL_FORMAT_BPP32_XRGB;
 #endif
 
         case JCS_YCbCr:     return SAIL_PIXEL_FORMAT_BPP24_YCBCR;
@@ -96,6 +105,154 @@ J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixe
     }
 }
 
+J_COLOR_SPACE jpeg_private_output_color_space(J_COLOR_SPACE jpeg_color_space, enum SailPixelFormat pixel_format) {
+
+    /* libjpeg converts only YCbCr, RGB, and grayscale images into other color spaces. */
+    if (jpeg_color_space != JCS_YCbCr && jpeg_color_space != JCS_RGB && jpeg_color_space != JCS_GRAYSCALE) {
+        return JCS_UNKNOWN;
+    }
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            return (jpeg_color_space == JCS_RGB) ? JCS_UNKNOWN : JCS_GRAYSCALE;
+        }
+
+#ifdef SAIL_HAVE_JPEG_JCS_EXT
+        /* libjpeg-turbo also expands grayscale images into RGB. RGB565 is not here as libjpeg dithers it. */
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  return JCS_RGB;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  return JCS_EXT_BGR;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: return JCS_EXT_RGBA;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: return JCS_EXT_BGRA;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: return JCS_EXT_ABGR;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: return JCS_EXT_ARGB;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX: return JCS_EXT_RGBX;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX: return JCS_EXT_BGRX;
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR: return JCS_EXT_XBGR;
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB: return JCS_EXT_XRGB;
+#else
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: {
+            return (jpeg_color_space == JCS_GRAYSCALE) ? JCS_UNKNOWN : JCS_RGB;
+        }
+#endif
+
+        default: return JCS_UNKNOWN;
+    }
+}
+
+bool jpeg_private_can_read_raw_data(const struct jpeg_decompress_struct *decompress_context, enum SailPixelFormat pixel_format) {
+
+    /* Raw data skips color conversion, so the image must be stored in YCbCr. */
+    if (decompress_context->jpeg_color_space != JCS_YCbCr || decompress_context->num_components != 3) {
+        return false;
+    }
+
+    /* DCT scaling may change the component sizes in a different proportion. */
+    if (decompress_context->scale_num != decompress_context->scale_denom) {
+        return false;
+    }
+
+    const jpeg_component_info *components = decompress_context->comp_info;
+
+    if (components[1].h_samp_factor != 1 || components[1].v_samp_factor != 1 ||
+            components[2].h_samp_factor != 1 || components[2].v_samp_factor != 1) {
+        return false;
+    }
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP12_YUV420P:
+        case SAIL_PIXEL_FORMAT_BPP12_NV12: {
+            return components[0].h_samp_factor == 2 && components[0].v_samp_factor == 2;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_YUV444P: {
+            return components[0].h_samp_factor == 1 && components[0].v_samp_factor == 1;
+        }
+
+        default: {
+            return false;
+        }
+    }
+}
+
+size_t jpeg_private_raw_data_buffer_size(const struct jpeg_decompress_struct *decompress_context) {
+
+    size_t size = 0;
+
+    for (int component = 0; component < 3; component++) {
+        const jpeg_component_info *component_info = &decompress_context->comp_info[component];
+        size += (size_t)component_info->width_in_blocks * DCTSIZE * component_info->v_samp_factor * DCTSIZE;
+    }
+
+    return size;
+}
+
+sail_status_t jpeg_private_read_raw_data(struct jpeg_decompress_struct *decompress_context,
+                                            unsigned char *buffer,
+                                            const struct sail_cancel_token *cancel_token,
+                                            struct sail_image *image) {
+
+    void *planes[3];
+    unsigned planes_bytes_per_line[3];
+    unsigned planes_height[3];
+    sail_planes(image->pixel_format, image->pixels, image->height, image->bytes_per_line, planes, planes_bytes_per_line, planes_height);
+
+    /*
+     * libjpeg outputs whole blocks, so the blocks are padded to the iMCU size
+     * and may go past the planes. Read them into the buffer and copy the visible part.
+     */
+    JSAMPROW rows[3][2 * DCTSIZE];
+    JSAMPARRAY data[3] = { rows[0], rows[1], rows[2] };
+    unsigned components_width[3];
+
+    for (int component = 0; component < 3; component++) {
+        const jpeg_component_info *component_info = &decompress_context->comp_info[component];
+        components_width[component] = component_info->width_in_blocks * DCTSIZE;
+
+        for (int row = 0; row < component_info->v_samp_factor * DCTSIZE; row++) {
+            rows[component][row] = buffer;
+            buffer += components_width[component];
+        }
+    }
+
+    const bool nv12 = image->pixel_format == SAIL_PIXEL_FORMAT_BPP12_NV12;
+    const unsigned max_lines = decompress_context->max_v_samp_factor * DCTSIZE;
+
+    for (unsigned row = 0; row < image->height; row += max_lines) {
+        SAIL_TRY(sail_check_cancel_token(cancel_token));
+
+        /* A suspending data source or a truncated stream returns fewer lines and leaves the rows stale. */
+        if (jpeg_read_raw_data(decompress_context, data, max_lines) < max_lines) {
+            SAIL_LOG_ERROR("JPEG: Failed to read raw data at row %u", row);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        for (int component = 0; component < 3; component++) {
+            const jpeg_component_info *component_info = &decompress_context->comp_info[component];
+            const unsigned component_lines = component_info->v_samp_factor * DCTSIZE;
+            const unsigned first_line = row / max_lines * component_lines;
+            const unsigned plane = (nv12 && component > 0) ? 1 : component;
+
+            for (unsigned line = 0; line < component_lines && first_line + line < planes_height[plane]; line++) {
+                unsigned char *scan = (unsigned char *)planes[plane] + (size_t)(first_line + line) * planes_bytes_per_line[plane];
+
+                if (nv12 && component > 0) {
+                    const JSAMPLE *samples = rows[component][line];
+                    scan += component - 1;
+
+                    for (JDIMENSION column = 0; column < component_info->downsampled_width; column++) {
+                        scan[column * 2] = samples[column];
+                    }
+                } else {
+                    memcpy(scan, rows[component][line], component_info->downsampled_width);
+                }
+            }
+        }
+    }
+
+    return SAIL_OK;
+}
+
 sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node) {
 
     SAIL_CHECK_PTR(last_meta_data_node);
@@ -112,6 +269,21 @@ sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decomp
             SAIL_TRY_OR_CLEANUP(sail_set_variant_substring(meta_data_node->meta_data->value, (const char *)it->data, it->data_length),
                                 /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
 
+            *last_meta_data_node = meta_data_node;
+            last_meta_data_node = &meta_data_node->next;
+        } else if (it->marker == JPEG_APP0 + 1 && it->data_length > EXIF_SIGNATURE_SIZE &&
+                    memcmp(it->data, EXIF_SIGNATURE, EXIF_SIGNATURE_SIZE) == 0) {
+            /* Store EXIF without the "Exif\0\0" signature like other codecs do. */
+            struct sail_meta_data_node *meta_data_node;
+            SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node));
+
+            SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_EXIF, &meta_data_node->meta_data),
+                                /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
+            SAIL_TRY_OR_CLEANUP(sail_set_variant_data(meta_data_node->meta_data->value,
+                                                        it->data + EXIF_SIGNATURE_SIZE,
+                                                        it->data_length - EXIF_SIGNATURE_SIZE),
+                                /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
+
             *last_meta_data_node = meta_data_node;
             last_meta_data_node = &meta_data_node->next;
         }
@@ -130,6 +302,24 @@ sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress
                                 JPEG_COM,
                                 (JOCTET *)sail_variant_to_string(meta_data_node->meta_data->value),
                                 (unsigned)meta_data_node->meta_data->value->size - 1);
+        } else if (meta_data_node->meta_data->key == SAIL_META_DATA_EXIF &&
+                    meta_data_node->meta_data->value->type == SAIL_VARIANT_TYPE_DATA) {
+            const size_t exif_size = meta_data_node->meta_data->value->size;
+
+            if (exif_size > 0xffff - 2 - EXIF_SIGNATURE_SIZE) {
+                SAIL_LOG_WARNING("JPEG: Ignoring too large EXIF data (%u bytes)", (unsigned)exif_size);
+            } else {
+                const JOCTET *exif = sail_variant_to_data(meta_data_node->meta_data->value);
+
+                jpeg_write_m_header(compress_context, JPEG_APP0 + 1, (unsigned)(EXIF_SIGNATURE_SIZE + exif_size));
+
+                for (size_t i = 0; i < EXIF_SIGNATURE_SIZE; i++) {
+                    jpeg_write_m_byte(compress_context, EXIF_SIGNATURE[i]);
+                }
+                for (size_t i = 0; i < exif_size; i++) {
+                    jpeg_write_m_byte(compress_context, exif[i]);
+                }
+            }
         } else {
             SAIL_LOG_WARNING("JPEG: Ignoring unsupported binary key '%s'", sail_meta_data_to_string(meta_data_node->meta_data->key));
         }
@@ -254,3 +444,25 @@ bool jpeg_private_tuning_key_value_callback(const char *key, const struct sail_v
 
     return true;
 }
+
+bool jpeg_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct jpeg_decompress_struct *decompress_context = user_data;
+
+    if (strcmp(key, "jpeg-scale-denom") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned scale_denom = sail_variant_to_unsigned_int(value);
+
+            /* libjpeg scales by DCT to 1/1, 1/2, 1/4, or 1/8 of the original size. */
+            if (scale_denom == 1 || scale_denom == 2 || scale_denom == 4 || scale_denom == 8) {
+                SAIL_LOG_TRACE("JPEG: Scaling the image by 1/%u", scale_denom);
+                decompress_context->scale_num   = 1;
+                decompress_context->scale_denom = scale_denom;
+            } else {
+                SAIL_LOG_WARNING("JPEG: Ignoring unsupported scale denominator %u", scale_denom);
+            }
+        }
+    }
+
+    return true;
+}
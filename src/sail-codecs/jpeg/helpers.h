@@ -35,6 +35,8 @@
 #include <sail-common/common.h>
 #include <sail-common/export.h>
 
+struct sail_cancel_token;
+struct sail_image;
 struct sail_meta_data_node;
 struct sail_resolution;
 
@@ -51,6 +53,19 @@ SAIL_HIDDEN enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLO
 
 SAIL_HIDDEN J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixel_format);
 
+SAIL_HIDDEN J_COLOR_SPACE jpeg_private_output_color_space(J_COLOR_SPACE jpeg_color_space, enum SailPixelFormat pixel_format);
+
+/* Returns true if libjpeg can output the YCbCr planes of the planar pixel format as is, without upsampling. */
+SAIL_HIDDEN bool jpeg_private_can_read_raw_data(const struct jpeg_decompress_struct *decompress_context, enum SailPixelFormat pixel_format);
+
+SAIL_HIDDEN size_t jpeg_private_raw_data_buffer_size(const struct jpeg_decompress_struct *decompress_context);
+
+/* Reads the YCbCr planes into the planar image. The buffer holds one iMCU row of every component. */
+SAIL_HIDDEN sail_status_t jpeg_private_read_raw_data(struct jpeg_decompress_struct *decompress_context,
+                                                        unsigned char *buffer,
+                                                        const struct sail_cancel_token *cancel_token,
+                                                        struct sail_image *image);
+
 SAIL_HIDDEN sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node);
 
 SAIL_HIDDEN sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress_context, const struct sail_meta_data_node *meta_data_node);
@@ -65,4 +80,6 @@ SAIL_HIDDEN sail_status_t jpeg_private_write_resolution(struct jpeg_compress_str
 
 SAIL_HIDDEN bool jpeg_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
 
+SAIL_HIDDEN bool jpeg_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
 #endif
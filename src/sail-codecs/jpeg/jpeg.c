@@ -60,6 +60,15 @@ struct jpeg_state {
     bool frame_loaded;
     bool frame_saved;
     bool started_compress;
+
+    /* Region of interest. The scan line buffer is allocated only when the region is set. */
+    unsigned roi_y;
+    unsigned roi_x_in_scanline;
+    unsigned char *scanline;
+
+    /* Planar YCbCr output. The iMCU row buffer is allocated only when reading raw data. */
+    bool raw_data;
+    unsigned char *raw_data_buffer;
 };
 
 static sail_status_t alloc_jpeg_state(const struct sail_load_options *load_options,
@@ -80,6 +89,13 @@ static sail_status_t alloc_jpeg_state(const struct sail_load_options *load_optio
         .frame_loaded       = false,
         .frame_saved        = false,
         .started_compress   = false,
+
+        .roi_y             = 0,
+        .roi_x_in_scanline = 0,
+        .scanline          = NULL,
+
+        .raw_data        = false,
+        .raw_data_buffer = NULL,
     };
 
     return SAIL_OK;
@@ -94,6 +110,9 @@ static void destroy_jpeg_state(struct jpeg_state *jpeg_state) {
     sail_free(jpeg_state->decompress_context);
     sail_free(jpeg_state->compress_context);
 
+    sail_free(jpeg_state->scanline);
+    sail_free(jpeg_state->raw_data_buffer);
+
     sail_free(jpeg_state);
 }
 
@@ -131,6 +150,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const
 
     if (jpeg_state->load_options->options & SAIL_OPTION_META_DATA) {
         jpeg_save_markers(jpeg_state->decompress_context, JPEG_COM, 0xffff);
+        jpeg_save_markers(jpeg_state->decompress_context, JPEG_APP0 + 1, 0xffff);
     }
     if (jpeg_state->load_options->options & SAIL_OPTION_ICCP) {
         jpeg_save_markers(jpeg_state->decompress_context, JPEG_APP0 + 2, 0xFFFF);
@@ -145,9 +165,35 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const
         jpeg_state->decompress_context->out_color_space = jpeg_state->decompress_context->jpeg_color_space;
     }
 
+    /* Let libjpeg produce the requested pixel format. Otherwise, it's converted after loading. */
+    if (jpeg_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+        const J_COLOR_SPACE output_color_space = jpeg_private_output_color_space(jpeg_state->decompress_context->jpeg_color_space,
+                                                                                  jpeg_state->load_options->output_pixel_format);
+
+        if (output_color_space != JCS_UNKNOWN) {
+            jpeg_state->decompress_context->out_color_space = output_color_space;
+        }
+    }
+
     /* We don't want colormapped output. */
     jpeg_state->decompress_context->quantize_colors = false;
 
+    /* Handle tuning. */
+    if (jpeg_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(jpeg_state->load_options->tuning, jpeg_private_load_tuning_key_value_callback, jpeg_state->decompress_context);
+    }
+
+    /* Output YCbCr planes without color conversion and upsampling when they match the requested planar pixel format. */
+    const bool roi = jpeg_state->load_options->roi_width != 0 && jpeg_state->load_options->roi_height != 0;
+
+    if (!roi && !(jpeg_state->load_options->options & SAIL_OPTION_VALIDATE) &&
+            jpeg_private_can_read_raw_data(jpeg_state->decompress_context, jpeg_state->load_options->output_pixel_format)) {
+        SAIL_LOG_TRACE("JPEG: Reading raw YCbCr data");
+        jpeg_state->raw_data = true;
+        jpeg_state->decompress_context->out_color_space = JCS_YCbCr;
+        jpeg_state->decompress_context->raw_data_out    = true;
+    }
+
     /* Launch decompression! */
     jpeg_start_decompress(jpeg_state->decompress_context);
 
@@ -180,10 +226,47 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg(void *state, s
         image_local->source_image->compression  = SAIL_COMPRESSION_JPEG;
     }
 
+    /* Region of interest. */
+    unsigned roi_x, roi_width, roi_height;
+    SAIL_TRY_OR_CLEANUP(sail_intersect_roi(jpeg_state->load_options,
+                                            jpeg_state->decompress_context->output_width,
+                                            jpeg_state->decompress_context->output_height,
+                                            &roi_x, &jpeg_state->roi_y, &roi_width, &roi_height),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    if (roi_width != jpeg_state->decompress_context->output_width || roi_height != jpeg_state->decompress_context->output_height) {
+        jpeg_state->roi_x_in_scanline = roi_x;
+
+#ifdef SAIL_HAVE_JPEG_CROP
+        /* Decode only the iMCU columns intersecting the region. libjpeg aligns the offset to the iMCU boundary. */
+        if (roi_width != jpeg_state->decompress_context->output_width) {
+            JDIMENSION crop_x     = roi_x;
+            JDIMENSION crop_width = roi_width;
+
+            jpeg_crop_scanline(jpeg_state->decompress_context, &crop_x, &crop_width);
+            jpeg_state->roi_x_in_scanline = roi_x - crop_x;
+        }
+#endif
+
+        void *ptr;
+        SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)jpeg_state->decompress_context->output_width * jpeg_state->decompress_context->output_components, &ptr),
+                            /* cleanup */ sail_destroy_image(image_local));
+        jpeg_state->scanline = ptr;
+    }
+
+    if (jpeg_state->raw_data) {
+        void *ptr;
+        SAIL_TRY_OR_CLEANUP(sail_malloc(jpeg_private_raw_data_buffer_size(jpeg_state->decompress_context), &ptr),
+                            /* cleanup */ sail_destroy_image(image_local));
+        jpeg_state->raw_data_buffer = ptr;
+    }
+
     /* Image properties. */
-    image_local->width          = jpeg_state->decompress_context->output_width;
-    image_local->height         = jpeg_state->decompress_context->output_height;
-    image_local->pixel_format   = jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->out_color_space);
+    image_local->width          = roi_width;
+    image_local->height         = roi_height;
+    image_local->pixel_format   = jpeg_state->raw_data
+                                    ? jpeg_state->load_options->output_pixel_format
+                                    : jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->out_color_space);
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
     /* Read meta data. */
@@ -222,11 +305,49 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpeg(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (unsigned row = 0; row < image->height; row++) {
-        unsigned char *scanline = sail_scan_line(image, row);
+    /* Validation decodes all the rows into the very first scan line. */
+    const bool validate = jpeg_state->load_options->options & SAIL_OPTION_VALIDATE;
+
+    if (jpeg_state->raw_data) {
+        SAIL_TRY(jpeg_private_read_raw_data(jpeg_state->decompress_context,
+                                            jpeg_state->raw_data_buffer,
+                                            jpeg_state->load_options->cancel_token,
+                                            image));
+    } else if (jpeg_state->scanline == NULL) {
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_check_cancel_token(jpeg_state->load_options->cancel_token));
+
+            unsigned char *scanline = sail_scan_line(image, validate ? 0 : row);
 
-        JSAMPROW samprow = (JSAMPROW)scanline;
-        (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+            JSAMPROW samprow = (JSAMPROW)scanline;
+            (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+        }
+    } else {
+        JSAMPROW samprow = (JSAMPROW)jpeg_state->scanline;
+
+#ifdef SAIL_HAVE_JPEG_CROP
+        (void)jpeg_skip_scanlines(jpeg_state->decompress_context, jpeg_state->roi_y);
+#else
+        for (unsigned row = 0; row < jpeg_state->roi_y; row++) {
+            SAIL_TRY(sail_check_cancel_token(jpeg_state->load_options->cancel_token));
+            (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+        }
+#endif
+
+        const size_t offset = (size_t)jpeg_state->roi_x_in_scanline * jpeg_state->decompress_context->output_components;
+
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_check_cancel_token(jpeg_state->load_options->cancel_token));
+
+            (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+            memcpy(sail_scan_line(image, validate ? 0 : row), jpeg_state->scanline + offset, image->bytes_per_line);
+        }
+    }
+
+    /* libjpeg recovers from corrupt data with warnings like "Premature end of JPEG file". */
+    if (validate && jpeg_state->decompress_context->err->num_warnings > 0) {
+        SAIL_LOG_ERROR("JPEG: Corrupt image data, %ld warning(s)", jpeg_state->decompress_context->err->num_warnings);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
     }
 
     return SAIL_OK;
@@ -377,6 +498,11 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_jpeg(void *state, const struc
     }
 
     for (unsigned row = 0; row < image->height; row++) {
+        /* Abort compression so finish() doesn't complain about missing scan lines. */
+        SAIL_TRY_OR_CLEANUP(sail_check_cancel_token(jpeg_state->save_options->cancel_token),
+                            /* cleanup */ jpeg_abort_compress(jpeg_state->compress_context),
+                                          jpeg_state->started_compress = false);
+
         JSAMPROW samprow = (JSAMPROW)sail_scan_line(image, row);
         jpeg_write_scanlines(jpeg_state->compress_context, &samprow, 1);
     }
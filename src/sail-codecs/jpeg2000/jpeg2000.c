@@ -52,6 +52,10 @@ struct jpeg2000_state {
     /* Channel depth in bits scaled to a byte boundary. For example, 12 bit images are scaled to 16 bit. */
     unsigned channel_depth_scaled;
     unsigned shift;
+
+    /* Region of interest. */
+    unsigned roi_x;
+    unsigned roi_y;
 };
 
 static sail_status_t alloc_jpeg2000_state(const struct sail_load_options *load_options,
@@ -75,6 +79,8 @@ static sail_status_t alloc_jpeg2000_state(const struct sail_load_options *load_o
         .number_channels = 0,
         .matrix          = { NULL, NULL, NULL, NULL },
         .shift           = 0,
+        .roi_x           = 0,
+        .roi_y           = 0,
     };
 
     return SAIL_OK;
@@ -266,8 +272,11 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg2000(void *stat
         image_local->source_image->compression  = SAIL_COMPRESSION_JPEG_2000;
     }
 
-    image_local->width          = width;
-    image_local->height         = height;
+    /* Region of interest. JasPer decodes the whole image, but only the region is converted. */
+    SAIL_TRY_OR_CLEANUP(sail_intersect_roi(jpeg2000_state->load_options, width, height,
+                                            &jpeg2000_state->roi_x, &jpeg2000_state->roi_y, &image_local->width, &image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
+
     image_local->pixel_format   = pixel_format;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
@@ -283,7 +292,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpeg2000(void *state, struct
     for (unsigned row = 0; row < image->height; row++) {
         for (int channel = 0; channel < jpeg2000_state->number_channels; channel++) {
             if (jas_image_readcmpt(jpeg2000_state->jas_image, jpeg2000_state->channels[channel],
-                    0 /* x */, row /* y */, image->width /* width */, 1 /* height */,
+                    jpeg2000_state->roi_x /* x */, jpeg2000_state->roi_y + row /* y */, image->width /* width */, 1 /* height */,
                     jpeg2000_state->matrix[channel]) != 0) {
                 SAIL_LOG_ERROR("JPEG2000: Failed to read image row #%u", row);
                 SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
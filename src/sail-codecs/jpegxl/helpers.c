@@ -63,10 +63,23 @@ enum SailPixelFormat jpegxl_private_source_pixel_format_cmyk(uint32_t bits_per_s
     }
 }
 
-enum SailPixelFormat jpegxl_private_source_pixel_format(uint32_t bits_per_sample, uint32_t num_color_channels, uint32_t alpha_bits) {
+enum SailPixelFormat jpegxl_private_source_pixel_format(uint32_t bits_per_sample, uint32_t exponent_bits_per_sample,
+                                                        uint32_t num_color_channels, uint32_t alpha_bits) {
 
-    SAIL_LOG_TRACE("JPEGXL: Bits per sample(%u), number of channels(%u), alpha bits(%u)",
-        bits_per_sample, num_color_channels, alpha_bits);
+    SAIL_LOG_TRACE("JPEGXL: Bits per sample(%u), exponent bits per sample(%u), number of channels(%u), alpha bits(%u)",
+        bits_per_sample, exponent_bits_per_sample, num_color_channels, alpha_bits);
+
+    /* Floating point RGB samples. Floating point grayscale samples are converted into integers by libjxl. */
+    if (exponent_bits_per_sample > 0 && num_color_channels == 3) {
+        switch (bits_per_sample) {
+            case 16: return alpha_bits > 0 ? SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF  : SAIL_PIXEL_FORMAT_BPP48_RGB_HALF;
+            case 32: return alpha_bits > 0 ? SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT : SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT;
+
+            default: {
+                return SAIL_PIXEL_FORMAT_UNKNOWN;
+            }
+        }
+    }
 
     /*
      * Also update jpegxl_private_pixel_format_to_num_channels() with new pixel formats.
@@ -113,6 +126,16 @@ enum SailPixelFormat jpegxl_private_source_pixel_format_to_output(enum SailPixel
     }
 }
 
+enum SailPixelFormat jpegxl_private_requested_output_pixel_format(enum SailPixelFormat pixel_format, enum SailPixelFormat requested_pixel_format) {
+
+    /* libjxl decodes RGB images into half-float and float pixels directly. */
+    if (!sail_is_floating_point(requested_pixel_format) || !sail_is_rgb_family(pixel_format)) {
+        return pixel_format;
+    }
+
+    return requested_pixel_format;
+}
+
 unsigned jpegxl_private_pixel_format_to_num_channels(enum SailPixelFormat pixel_format) {
 
     switch(pixel_format) {
@@ -121,9 +144,13 @@ unsigned jpegxl_private_pixel_format_to_num_channels(enum SailPixelFormat pixel_
         case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:
         case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: return 2;
         case SAIL_PIXEL_FORMAT_BPP24_RGB:
-        case SAIL_PIXEL_FORMAT_BPP48_RGB:             return 3;
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:       return 3;
         case SAIL_PIXEL_FORMAT_BPP32_RGBA:
-        case SAIL_PIXEL_FORMAT_BPP64_RGBA:            return 4;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT:     return 4;
 
         default: {
             return 0;
@@ -144,6 +171,12 @@ JxlDataType jpegxl_private_pixel_format_to_jxl_data_type(enum SailPixelFormat pi
         case SAIL_PIXEL_FORMAT_BPP48_RGB:
         case SAIL_PIXEL_FORMAT_BPP64_RGBA:            return JXL_TYPE_UINT16;
 
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:       return JXL_TYPE_FLOAT16;
+
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT:     return JXL_TYPE_FLOAT;
+
         default: {
             return JXL_TYPE_UINT8;
         }
@@ -44,10 +44,13 @@ SAIL_HIDDEN bool jpegxl_private_is_cmyk(JxlDecoder *decoder, uint32_t num_extra_
 
 SAIL_HIDDEN enum SailPixelFormat jpegxl_private_source_pixel_format_cmyk(uint32_t bits_per_sample, uint32_t alpha_bits);
 
-SAIL_HIDDEN enum SailPixelFormat jpegxl_private_source_pixel_format(uint32_t bits_per_sample, uint32_t num_color_channels, uint32_t alpha_bits);
+SAIL_HIDDEN enum SailPixelFormat jpegxl_private_source_pixel_format(uint32_t bits_per_sample, uint32_t exponent_bits_per_sample,
+                                                                    uint32_t num_color_channels, uint32_t alpha_bits);
 
 SAIL_HIDDEN enum SailPixelFormat jpegxl_private_source_pixel_format_to_output(enum SailPixelFormat pixel_format);
 
+SAIL_HIDDEN enum SailPixelFormat jpegxl_private_requested_output_pixel_format(enum SailPixelFormat pixel_format, enum SailPixelFormat requested_pixel_format);
+
 SAIL_HIDDEN unsigned jpegxl_private_pixel_format_to_num_channels(enum SailPixelFormat pixel_format);
 
 SAIL_HIDDEN JxlDataType jpegxl_private_pixel_format_to_jxl_data_type(enum SailPixelFormat pixel_format);
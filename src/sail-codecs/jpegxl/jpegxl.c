@@ -221,6 +221,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpegxl(void *state,
                 } else {
                     jpegxl_state->source_image->pixel_format =
                         jpegxl_private_source_pixel_format(jpegxl_state->basic_info->bits_per_sample,
+                                                            jpegxl_state->basic_info->exponent_bits_per_sample,
                                                             jpegxl_state->basic_info->num_color_channels,
                                                             jpegxl_state->basic_info->alpha_bits);
                 }
@@ -278,7 +279,9 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpegxl(void *state,
 
                 image_local->width          = jpegxl_state->basic_info->xsize;
                 image_local->height         = jpegxl_state->basic_info->ysize;
-                image_local->pixel_format   = jpegxl_private_source_pixel_format_to_output(jpegxl_state->source_image->pixel_format);
+                image_local->pixel_format   = jpegxl_private_requested_output_pixel_format(
+                                                    jpegxl_private_source_pixel_format_to_output(jpegxl_state->source_image->pixel_format),
+                                                    jpegxl_state->load_options->output_pixel_format);
                 image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
                 if (jpegxl_state->basic_info->have_animation) {
@@ -144,10 +144,13 @@ sail_status_t pcx_private_build_palette(enum SailPixelFormat pixel_format, struc
     return SAIL_OK;
 }
 
-sail_status_t pcx_private_read_uncompressed(struct sail_io *io, unsigned bytes_per_plane_to_read, unsigned planes, unsigned char *buffer, struct sail_image *image) {
+sail_status_t pcx_private_read_uncompressed(struct sail_io *io, unsigned bytes_per_plane_to_read, unsigned planes, unsigned char *buffer, bool validate,
+                                            const struct sail_cancel_token *cancel_token, struct sail_image *image) {
 
     for (unsigned row = 0; row < image->height; row++) {
-        unsigned char *target_scan = sail_scan_line(image, row);
+        SAIL_TRY(sail_check_cancel_token(cancel_token));
+
+        unsigned char *target_scan = sail_scan_line(image, validate ? 0 : row);
 
         /* Read plane by plane and then merge them into the image pixels. */
         for (unsigned plane = 0; plane < planes; plane++) {
@@ -26,6 +26,7 @@
 #ifndef SAIL_PCX_HELPERS_H
 #define SAIL_PCX_HELPERS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <sail-common/common.h>
@@ -75,6 +76,11 @@ SAIL_HIDDEN sail_status_t pcx_private_sail_pixel_format(unsigned bits_per_plane,
 
 SAIL_HIDDEN sail_status_t pcx_private_build_palette(enum SailPixelFormat pixel_format, struct sail_io *io, uint8_t palette16[48], struct sail_palette **palette);
 
-SAIL_HIDDEN sail_status_t pcx_private_read_uncompressed(struct sail_io *io, unsigned bytes_per_plane_to_read, unsigned planes, unsigned char *buffer, struct sail_image *image);
+/*
+ * Reads all the rows into the very first scan line when 'validate' is true.
+ * Checks the cancellation token before every row.
+ */
+SAIL_HIDDEN sail_status_t pcx_private_read_uncompressed(struct sail_io *io, unsigned bytes_per_plane_to_read, unsigned planes, unsigned char *buffer, bool validate,
+                                                        const struct sail_cancel_token *cancel_token, struct sail_image *image);
 
 #endif
@@ -179,10 +179,16 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_pcx(void *state, struct sail_
 
     const struct pcx_state *pcx_state = state;
 
+    /* Validation decodes all the rows into the very first scan line. */
+    const bool validate = pcx_state->load_options->options & SAIL_OPTION_VALIDATE;
+
     if (pcx_state->pcx_header.encoding == SAIL_PCX_NO_ENCODING) {
-        SAIL_TRY(pcx_private_read_uncompressed(pcx_state->io, pcx_state->pcx_header.bytes_per_line, pcx_state->pcx_header.planes, pcx_state->scanline_buffer, image));
+        SAIL_TRY(pcx_private_read_uncompressed(pcx_state->io, pcx_state->pcx_header.bytes_per_line, pcx_state->pcx_header.planes, pcx_state->scanline_buffer,
+                                                    validate, pcx_state->load_options->cancel_token, image));
     } else {
         for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_check_cancel_token(pcx_state->load_options->cancel_token));
+
             unsigned buffer_offset = 0;
 
             /* Decode all planes of a single scan line. */
@@ -210,7 +216,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_pcx(void *state, struct sail_
             }
 
             /* Merge planes into the image pixels. */
-            unsigned char * const scan = sail_scan_line(image, row);
+            unsigned char * const scan = sail_scan_line(image, validate ? 0 : row);
 
             for (unsigned plane = 0; plane < pcx_state->pcx_header.planes; plane++) {
                 const unsigned buffer_plane_offset = plane * pcx_state->pcx_header.bytes_per_line;
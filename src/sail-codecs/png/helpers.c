@@ -196,6 +196,72 @@ enum SailPixelFormat png_private_png_color_type_to_pixel_format(int color_type,
     return SAIL_PIXEL_FORMAT_UNKNOWN;
 }
 
+enum SailPixelFormat png_private_set_output_transforms(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth, enum SailPixelFormat pixel_format) {
+
+    bool bgr;
+    bool alpha;
+    bool filler;
+    bool alpha_first = false;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  bgr = false; alpha = false; filler = false; break;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  bgr = true;  alpha = false; filler = false; break;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX: bgr = false; alpha = false; filler = true; break;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX: bgr = true;  alpha = false; filler = true; break;
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB: bgr = false; alpha = false; filler = true; alpha_first = true; break;
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR: bgr = true;  alpha = false; filler = true; alpha_first = true; break;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: bgr = false; alpha = true; filler = false; break;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: bgr = true;  alpha = true; filler = false; break;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: bgr = false; alpha = true; filler = false; alpha_first = true; break;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: bgr = true;  alpha = true; filler = false; alpha_first = true; break;
+
+        default: {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+
+    /* 16-bit images are left to the generic conversion. */
+    if (bit_depth > 8) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    /* libpng expands palette transparency into alpha. */
+    const bool source_alpha = (color_type & PNG_COLOR_MASK_ALPHA) != 0 ||
+                                (color_type == PNG_COLOR_TYPE_PALETTE && png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) != 0);
+
+    /* libpng cannot replace alpha with a filler. */
+    if (source_alpha && filler) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(png_ptr);
+    } else if ((color_type & PNG_COLOR_MASK_COLOR) == 0) {
+        if (bit_depth < 8) {
+            png_set_expand_gray_1_2_4_to_8(png_ptr);
+        }
+        png_set_gray_to_rgb(png_ptr);
+    }
+
+    if (source_alpha && !alpha) {
+        png_set_strip_alpha(png_ptr);
+    } else if (!source_alpha && alpha) {
+        png_set_add_alpha(png_ptr, 0xFF, alpha_first ? PNG_FILLER_BEFORE : PNG_FILLER_AFTER);
+    } else if (filler) {
+        png_set_filler(png_ptr, 0xFF, alpha_first ? PNG_FILLER_BEFORE : PNG_FILLER_AFTER);
+    } else if (source_alpha && alpha_first) {
+        png_set_swap_alpha(png_ptr);
+    }
+
+    if (bgr) {
+        png_set_bgr(png_ptr);
+    }
+
+    return pixel_format;
+}
+
 sail_status_t png_private_pixel_format_to_png_color_type(enum SailPixelFormat pixel_format, int *color_type, int *bit_depth) {
 
     SAIL_CHECK_PTR(color_type);
@@ -533,6 +599,62 @@ sail_status_t png_private_fetch_palette(png_structp png_ptr, png_infop info_ptr,
     return SAIL_OK;
 }
 
+sail_status_t png_private_write_palette(png_structp png_ptr, png_infop info_ptr, const struct sail_palette *palette) {
+
+    SAIL_CHECK_PTR(png_ptr);
+    SAIL_CHECK_PTR(info_ptr);
+    SAIL_CHECK_PTR(palette);
+
+    if (palette->color_count == 0 || palette->color_count > PNG_MAX_PALETTE_LENGTH) {
+        SAIL_LOG_ERROR("PNG: The palette has %u colors, must be 1-%d", palette->color_count, PNG_MAX_PALETTE_LENGTH);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    switch (palette->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: {
+            /* Deep copy palette. */
+            png_set_PLTE(png_ptr, info_ptr, palette->data, palette->color_count);
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
+            png_color colors[PNG_MAX_PALETTE_LENGTH];
+            png_byte transparency[PNG_MAX_PALETTE_LENGTH];
+            int transparency_length = 0;
+
+            const unsigned char *palette_ptr = palette->data;
+
+            for (unsigned i = 0; i < palette->color_count; i++) {
+                colors[i].red   = *palette_ptr++;
+                colors[i].green = *palette_ptr++;
+                colors[i].blue  = *palette_ptr++;
+                transparency[i] = *palette_ptr++;
+
+                /* Trailing opaque entries are omitted from tRNS. */
+                if (transparency[i] != 255) {
+                    transparency_length = (int)i + 1;
+                }
+            }
+
+            png_set_PLTE(png_ptr, info_ptr, colors, palette->color_count);
+
+            if (transparency_length > 0) {
+#ifdef PNG_tRNS_SUPPORTED
+                png_set_tRNS(png_ptr, info_ptr, transparency, transparency_length, NULL);
+#else
+                SAIL_LOG_WARNING("PNG: Palette transparency is not supported by libpng and will be lost");
+#endif
+            }
+            break;
+        }
+        default: {
+            SAIL_LOG_ERROR("PNG: Only BPP24-RGB and BPP32-RGBA palettes are currently supported");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+
+    return SAIL_OK;
+}
+
 #ifdef PNG_APNG_SUPPORTED
 sail_status_t png_private_blend_source(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned src_width, unsigned bytes_per_pixel) {
 
@@ -610,6 +732,20 @@ sail_status_t png_private_blend_over(void *dst_raw, unsigned dst_offset, const v
             }
             break;
         }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: {
+            const uint8_t *src = src_raw;
+            uint8_t *dst = (uint8_t *)dst_raw + dst_offset * bytes_per_pixel;
+
+            while (width--) {
+                const unsigned src_a_inv = 255 - *(src+3);
+
+                *dst = (uint8_t)(*src + (*dst * src_a_inv + 127) / 255); src++; dst++;
+                *dst = (uint8_t)(*src + (*dst * src_a_inv + 127) / 255); src++; dst++;
+                *dst = (uint8_t)(*src + (*dst * src_a_inv + 127) / 255); src++; dst++;
+                *dst = (uint8_t)(*src + (*dst * src_a_inv + 127) / 255); src++; dst++;
+            }
+            break;
+        }
         default: {
             SAIL_LOG_ERROR("Pixel format %s is not supported for blending operations", sail_pixel_format_to_string(pixel_format));
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
@@ -619,6 +755,19 @@ sail_status_t png_private_blend_over(void *dst_raw, unsigned dst_offset, const v
     return SAIL_OK;
 }
 
+void png_private_premultiply_rgba32(void *scanline, unsigned width) {
+
+    uint8_t *pixel = scanline;
+
+    for (unsigned column = 0; column < width; column++, pixel += 4) {
+        const unsigned a = *(pixel+3);
+
+        *(pixel+0) = (uint8_t)((*(pixel+0) * a + 127) / 255);
+        *(pixel+1) = (uint8_t)((*(pixel+1) * a + 127) / 255);
+        *(pixel+2) = (uint8_t)((*(pixel+2) * a + 127) / 255);
+    }
+}
+
 sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row) {
 
     SAIL_CHECK_PTR(png_ptr);
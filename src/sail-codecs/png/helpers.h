@@ -52,6 +52,13 @@ SAIL_HIDDEN void png_private_my_free_fn(png_structp png_ptr, void *ptr);
 
 SAIL_HIDDEN enum SailPixelFormat png_private_png_color_type_to_pixel_format(int color_type, int bit_depth);
 
+/*
+ * Sets up libpng transformations to produce the specified pixel format while reading rows.
+ * Returns the pixel format, or SAIL_PIXEL_FORMAT_UNKNOWN without setting up anything
+ * if libpng cannot produce it.
+ */
+SAIL_HIDDEN enum SailPixelFormat png_private_set_output_transforms(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth, enum SailPixelFormat pixel_format);
+
 SAIL_HIDDEN sail_status_t png_private_pixel_format_to_png_color_type(enum SailPixelFormat pixel_format, int *color_type, int *bit_depth);
 
 SAIL_HIDDEN sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_infop info_ptr, struct sail_meta_data_node **target_meta_data_node);
@@ -62,11 +69,15 @@ SAIL_HIDDEN sail_status_t png_private_fetch_iccp(png_structp png_ptr, png_infop
 
 SAIL_HIDDEN sail_status_t png_private_fetch_palette(png_structp png_ptr, png_infop info_ptr, struct sail_palette **palette);
 
+SAIL_HIDDEN sail_status_t png_private_write_palette(png_structp png_ptr, png_infop info_ptr, const struct sail_palette *palette);
+
 #ifdef PNG_APNG_SUPPORTED
 SAIL_HIDDEN sail_status_t png_private_blend_source(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned src_width, unsigned bytes_per_pixel);
 
 SAIL_HIDDEN sail_status_t png_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned width, enum SailPixelFormat pixel_format);
 
+SAIL_HIDDEN void png_private_premultiply_rgba32(void *scanline, unsigned width);
+
 SAIL_HIDDEN sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row);
 
 SAIL_HIDDEN sail_status_t png_private_alloc_rows(png_bytep **A, unsigned row_length, unsigned height);
@@ -65,9 +65,16 @@ struct png_state {
     int frames;
     int current_frame;
 
+    /* Region of interest. */
+    unsigned roi_x;
+    unsigned roi_y;
+    /* Scan line to read into when only a part of the frame is requested. */
+    void *roi_scanline;
+
     /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
     bool is_apng;
+    bool premultiplied;
     unsigned bytes_per_pixel;
 
     png_uint_32 next_frame_width;
@@ -111,10 +118,14 @@ static sail_status_t alloc_png_state(const struct sail_load_options *load_option
         .frame_saved       = false,
         .frames            = 0,
         .current_frame     = 0,
+        .roi_x             = 0,
+        .roi_y             = 0,
+        .roi_scanline      = NULL,
 
 /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
         .is_apng               = false,
+        .premultiplied         = false,
         .bytes_per_pixel       = 0,
 
         .next_frame_width      = 0,
@@ -153,9 +164,80 @@ static void destroy_png_state(struct png_state *png_state) {
 
     sail_destroy_image(png_state->first_image);
 
+    sail_free(png_state->roi_scanline);
+
     sail_free(png_state);
 }
 
+static sail_status_t read_frame_rows(struct png_state *png_state, struct sail_image *image) {
+
+    /* Validation decodes all the rows into the very first scan line. */
+    const bool validate = png_state->load_options->options & SAIL_OPTION_VALIDATE;
+
+    for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
+    #ifdef PNG_APNG_SUPPORTED
+        if (png_state->is_apng) {
+            for (unsigned row = 0; row < image->height; row++) {
+                SAIL_TRY(sail_check_cancel_token(png_state->load_options->cancel_token));
+
+                unsigned char *scanline = sail_scan_line(image, validate ? 0 : row);
+
+                memcpy(scanline, png_state->prev[row], png_state->first_image->bytes_per_line);
+
+                if (row >= png_state->next_frame_y_offset && row < png_state->next_frame_y_offset + png_state->next_frame_height) {
+                    png_read_row(png_state->png_ptr, (png_bytep)png_state->temp_scanline, NULL);
+
+                    if (png_state->premultiplied) {
+                        png_private_premultiply_rgba32(png_state->temp_scanline, png_state->next_frame_width);
+                    }
+
+                    /* Copy all pixel values including alpha. */
+                    if (png_state->current_frame == 1 || png_state->next_frame_blend_op == PNG_BLEND_OP_SOURCE) {
+                        SAIL_TRY(png_private_blend_source(scanline,
+                                                png_state->next_frame_x_offset,
+                                                png_state->temp_scanline,
+                                                png_state->next_frame_width,
+                                                png_state->bytes_per_pixel));
+                    } else { /* PNG_BLEND_OP_OVER */
+                        SAIL_TRY(png_private_blend_over(scanline,
+                                            png_state->next_frame_x_offset,
+                                            png_state->temp_scanline,
+                                            png_state->next_frame_width,
+                                            image->pixel_format));
+                    }
+
+                    /* Workaround: Apply disposal method only for images with bpp >= 8. */
+                    if (png_state->bytes_per_pixel > 0) {
+                        if (png_state->next_frame_dispose_op == PNG_DISPOSE_OP_BACKGROUND) {
+                            memset(png_state->prev[row] + png_state->next_frame_x_offset * png_state->bytes_per_pixel,
+                                    0,
+                                    (size_t)png_state->next_frame_width * png_state->bytes_per_pixel);
+                        } else if (png_state->next_frame_dispose_op == PNG_DISPOSE_OP_NONE) {
+                            memcpy(png_state->prev[row] + png_state->next_frame_x_offset * png_state->bytes_per_pixel,
+                                    scanline,
+                                    (size_t)png_state->next_frame_width * png_state->bytes_per_pixel);
+                        } else { /* PNG_DISPOSE_OP_PREVIOUS */
+                        }
+                    }
+                }
+            }
+        } else {
+            for (unsigned row = 0; row < image->height; row++) {
+                SAIL_TRY(sail_check_cancel_token(png_state->load_options->cancel_token));
+                png_read_row(png_state->png_ptr, sail_scan_line(image, validate ? 0 : row), NULL);
+            }
+        }
+    #else
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_check_cancel_token(png_state->load_options->cancel_token));
+            png_read_row(png_state->png_ptr, sail_scan_line(image, validate ? 0 : row), NULL);
+        }
+    #endif
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -206,10 +288,34 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const
                     /* filter method */ NULL);
 
     png_state->first_image->pixel_format = png_private_png_color_type_to_pixel_format(png_state->color_type, png_state->bit_depth);
+
+    /*
+     * Let libpng produce the requested pixel format. Otherwise, it's converted after loading.
+     * APNG frames are blended over the previous ones in the stored pixel format, so they're always converted.
+     * The only exception is 8-bit RGBA frames that are blended in premultiplied alpha space when it's requested.
+     */
+#ifdef PNG_APNG_SUPPORTED
+    const bool animated = png_get_valid(png_state->png_ptr, png_state->info_ptr, PNG_INFO_acTL) != 0;
+#else
+    const bool animated = false;
+#endif
+
+    if (png_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN && !animated) {
+        const enum SailPixelFormat output_pixel_format = png_private_set_output_transforms(png_state->png_ptr,
+                                                                                            png_state->info_ptr,
+                                                                                            png_state->color_type,
+                                                                                            png_state->bit_depth,
+                                                                                            png_state->load_options->output_pixel_format);
+
+        if (output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+            png_state->first_image->pixel_format = output_pixel_format;
+        }
+    }
+
     png_state->first_image->bytes_per_line = sail_bytes_per_line(png_state->first_image->width, png_state->first_image->pixel_format);
 
     /* Fetch palette. */
-    if (png_state->color_type == PNG_COLOR_TYPE_PALETTE) {
+    if (sail_is_indexed(png_state->first_image->pixel_format)) {
         SAIL_TRY(png_private_fetch_palette(png_state->png_ptr, png_state->info_ptr, &png_state->first_image->palette));
     }
 
@@ -230,6 +336,15 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const
     }
 
     if (png_state->is_apng) {
+        if (png_state->first_image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA &&
+                png_state->load_options->output_pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED) {
+            png_state->first_image->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+            png_state->premultiplied = true;
+        }
+
+        SAIL_TRY(sail_check_dimensions_limit(png_state->load_options, png_state->first_image->width, png_state->first_image->height));
+        SAIL_TRY(sail_check_memory_limit(png_state->load_options,
+                                            (uint64_t)png_state->first_image->bytes_per_line * png_state->first_image->height));
         SAIL_TRY(png_private_alloc_rows(&png_state->prev, png_state->first_image->bytes_per_line, png_state->first_image->height));
 
         if (png_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
@@ -365,6 +480,16 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_png(void *state, st
     }
 #endif
 
+    /* Region of interest. */
+    unsigned roi_width, roi_height;
+    SAIL_TRY_OR_CLEANUP(sail_intersect_roi(png_state->load_options, image_local->width, image_local->height,
+                                            &png_state->roi_x, &png_state->roi_y, &roi_width, &roi_height),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    image_local->width          = roi_width;
+    image_local->height         = roi_height;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
     png_state->current_frame++;
 
     *image = image_local;
@@ -385,57 +510,50 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_png(void *state, struct sail_
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
-    #ifdef PNG_APNG_SUPPORTED
-        if (png_state->is_apng) {
-            for (unsigned row = 0; row < image->height; row++) {
-                unsigned char *scanline = sail_scan_line(image, row);
+    if (image->width == png_state->first_image->width && image->height == png_state->first_image->height) {
+        SAIL_TRY(read_frame_rows(png_state, image));
+        return SAIL_OK;
+    }
 
-                memcpy(scanline, png_state->prev[row], png_state->first_image->bytes_per_line);
+    bool full_canvas = png_state->interlaced_passes > 1;
+#ifdef PNG_APNG_SUPPORTED
+    full_canvas = full_canvas || png_state->is_apng;
+#endif
 
-                if (row >= png_state->next_frame_y_offset && row < png_state->next_frame_y_offset + png_state->next_frame_height) {
-                    png_read_row(png_state->png_ptr, (png_bytep)png_state->temp_scanline, NULL);
+    if (full_canvas) {
+        /* Interlaced passes and animation frames update the whole canvas, so decode it entirely. */
+        SAIL_TRY(sail_check_memory_limit(png_state->load_options,
+                                            (uint64_t)png_state->first_image->bytes_per_line * png_state->first_image->height));
 
-                    /* Copy all pixel values including alpha. */
-                    if (png_state->current_frame == 1 || png_state->next_frame_blend_op == PNG_BLEND_OP_SOURCE) {
-                        SAIL_TRY(png_private_blend_source(scanline,
-                                                png_state->next_frame_x_offset,
-                                                png_state->temp_scanline,
-                                                png_state->next_frame_width,
-                                                png_state->bytes_per_pixel));
-                    } else { /* PNG_BLEND_OP_OVER */
-                        SAIL_TRY(png_private_blend_over(scanline,
-                                            png_state->next_frame_x_offset,
-                                            png_state->temp_scanline,
-                                            png_state->next_frame_width,
-                                            image->pixel_format));
-                    }
+        struct sail_image *canvas;
+        SAIL_TRY(sail_copy_image_skeleton(png_state->first_image, &canvas));
+
+        SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)canvas->bytes_per_line * canvas->height, &canvas->pixels),
+                            /* cleanup */ sail_destroy_image(canvas));
+        SAIL_TRY_OR_CLEANUP(read_frame_rows(png_state, canvas),
+                            /* cleanup */ sail_destroy_image(canvas));
 
-                    /* Workaround: Apply disposal method only for images with bpp >= 8. */
-                    if (png_state->bytes_per_pixel > 0) {
-                        if (png_state->next_frame_dispose_op == PNG_DISPOSE_OP_BACKGROUND) {
-                            memset(png_state->prev[row] + png_state->next_frame_x_offset * png_state->bytes_per_pixel,
-                                    0,
-                                    (size_t)png_state->next_frame_width * png_state->bytes_per_pixel);
-                        } else if (png_state->next_frame_dispose_op == PNG_DISPOSE_OP_NONE) {
-                            memcpy(png_state->prev[row] + png_state->next_frame_x_offset * png_state->bytes_per_pixel,
-                                    scanline,
-                                    (size_t)png_state->next_frame_width * png_state->bytes_per_pixel);
-                        } else { /* PNG_DISPOSE_OP_PREVIOUS */
-                        }
-                    }
-                }
-            }
-        } else {
-            for (unsigned row = 0; row < image->height; row++) {
-                png_read_row(png_state->png_ptr, sail_scan_line(image, row), NULL);
-            }
-        }
-    #else
         for (unsigned row = 0; row < image->height; row++) {
-            png_read_row(png_state->png_ptr, sail_scan_line(image, row), NULL);
+            sail_copy_scan_line_pixels(sail_scan_line(canvas, png_state->roi_y + row), png_state->roi_x, image->width,
+                                        image->pixel_format, sail_scan_line(image, row));
+        }
+
+        sail_destroy_image(canvas);
+    } else {
+        /* Rows below the region of interest are not decoded at all. */
+        if (png_state->roi_scanline == NULL) {
+            SAIL_TRY(sail_malloc(png_state->first_image->bytes_per_line, &png_state->roi_scanline));
+        }
+
+        for (unsigned row = 0; row < png_state->roi_y + image->height; row++) {
+            SAIL_TRY(sail_check_cancel_token(png_state->load_options->cancel_token));
+            png_read_row(png_state->png_ptr, png_state->roi_scanline, NULL);
+
+            if (row >= png_state->roi_y) {
+                sail_copy_scan_line_pixels(png_state->roi_scanline, png_state->roi_x, image->width,
+                                            image->pixel_format, sail_scan_line(image, row - png_state->roi_y));
+            }
         }
-    #endif
     }
 
     return SAIL_OK;
@@ -569,13 +687,7 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_png(void *state, co
             SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
         }
 
-        if (image->palette->pixel_format != SAIL_PIXEL_FORMAT_BPP24_RGB) {
-            SAIL_LOG_ERROR("PNG: Only BPP24-RGB palette is currently supported");
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
-        }
-
-        /* Deep copy palette. */
-        png_set_PLTE(png_state->png_ptr, png_state->info_ptr, image->palette->data, image->palette->color_count);
+        SAIL_TRY(png_private_write_palette(png_state->png_ptr, png_state->info_ptr, image->palette));
     }
 
     /* Save gamma. */
@@ -632,6 +744,10 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_png(void *state, const struct
 
     for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
         for (unsigned row = 0; row < image->height; row++) {
+            /* Don't let finish() write the end of the incomplete image. */
+            SAIL_TRY_OR_CLEANUP(sail_check_cancel_token(png_state->save_options->cancel_token),
+                                /* cleanup */ png_state->libpng_error = true);
+
             png_write_row(png_state->png_ptr, sail_scan_line(image, row));
         }
     }
@@ -649,12 +765,14 @@ SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_png(void **state) {
     /* Error handling setup. */
     if (png_state->png_ptr != NULL) {
         if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+            png_destroy_write_struct(&png_state->png_ptr, &png_state->info_ptr);
             destroy_png_state(png_state);
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
         }
     }
 
-    if (png_state->png_ptr != NULL && !png_state->libpng_error) {
+    /* Nothing to finish when saving was canceled before the first frame. */
+    if (png_state->png_ptr != NULL && !png_state->libpng_error && png_state->frame_saved) {
         png_write_end(png_state->png_ptr, png_state->info_ptr);
     }
 
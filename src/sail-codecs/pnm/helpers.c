@@ -100,32 +100,61 @@ sail_status_t pnm_private_read_word(struct sail_io *io, char *str, size_t str_si
     return SAIL_OK;
 }
 
-sail_status_t pnm_private_read_pixels(struct sail_io *io, struct sail_image *image, unsigned channels, unsigned bpc, double multiplier_to_full_range) {
-
-    for (unsigned row = 0; row < image->height; row++) {
-        uint8_t *scan8 = sail_scan_line(image, row);
-        uint16_t *scan16 = sail_scan_line(image, row);
-
-        for (unsigned column = 0; column < image->width; column++) {
-            for(unsigned channel = 0; channel < channels; channel++) {
-                char buffer[8];
-                SAIL_TRY(pnm_private_read_word(io, buffer, sizeof(buffer)));
-
-                unsigned value;
-            #ifdef _MSC_VER
-                if (sscanf_s(buffer, "%u", &value) != 1) {
-            #else
-                if (sscanf(buffer, "%u", &value) != 1) {
-            #endif
-                    SAIL_LOG_ERROR("PNM: Failed to read color value from '%s'", buffer);
-                    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-                }
-
-                if (SAIL_LIKELY(bpc == 8)) {
-                    *scan8++ = (uint8_t)(value * multiplier_to_full_range);
-                } else {
-                    *scan16++ = (uint16_t)(value * multiplier_to_full_range);
-                }
+sail_status_t pnm_private_read_bitmap_row(struct sail_io *io, unsigned width, void *scan) {
+
+    uint8_t *scan8 = scan;
+    unsigned shift = 8;
+
+    for (unsigned column = 0; column < width; column++) {
+        char first_char;
+        SAIL_TRY(pnm_private_skip_to_letters_numbers_force_read(io, &first_char));
+
+        const unsigned value = first_char - '0';
+
+        if (value != 0 && value != 1) {
+            SAIL_LOG_ERROR("PNM: Unexpected character '%c'", first_char);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        if (shift == 8) {
+            *scan8 = 0;
+        }
+
+        *scan8 |= (value << --shift);
+
+        if (shift == 0) {
+            scan8++;
+            shift = 8;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t pnm_private_read_row(struct sail_io *io, unsigned width, unsigned channels, unsigned bpc, double multiplier_to_full_range, void *scan) {
+
+    uint8_t *scan8 = scan;
+    uint16_t *scan16 = scan;
+
+    for (unsigned column = 0; column < width; column++) {
+        for(unsigned channel = 0; channel < channels; channel++) {
+            char buffer[8];
+            SAIL_TRY(pnm_private_read_word(io, buffer, sizeof(buffer)));
+
+            unsigned value;
+        #ifdef _MSC_VER
+            if (sscanf_s(buffer, "%u", &value) != 1) {
+        #else
+            if (sscanf(buffer, "%u", &value) != 1) {
+        #endif
+                SAIL_LOG_ERROR("PNM: Failed to read color value from '%s'", buffer);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            if (SAIL_LIKELY(bpc == 8)) {
+                *scan8++ = (uint8_t)(value * multiplier_to_full_range);
+            } else {
+                *scan16++ = (uint16_t)(value * multiplier_to_full_range);
             }
         }
     }
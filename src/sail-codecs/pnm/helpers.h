@@ -52,7 +52,9 @@ SAIL_HIDDEN sail_status_t pnm_private_skip_to_letters_numbers(struct sail_io *io
 
 SAIL_HIDDEN sail_status_t pnm_private_read_word(struct sail_io *io, char *str, size_t str_size);
 
-SAIL_HIDDEN sail_status_t pnm_private_read_pixels(struct sail_io *io, struct sail_image *image, unsigned channels, unsigned bpc, double multiplier_to_full_range);
+SAIL_HIDDEN sail_status_t pnm_private_read_bitmap_row(struct sail_io *io, unsigned width, void *scan);
+
+SAIL_HIDDEN sail_status_t pnm_private_read_row(struct sail_io *io, unsigned width, unsigned channels, unsigned bpc, double multiplier_to_full_range, void *scan);
 
 SAIL_HIDDEN enum SailPixelFormat pnm_private_rgb_sail_pixel_format(enum SailPnmVersion pnm_version, unsigned bpc);
 
@@ -47,6 +47,11 @@ struct pnm_state {
     enum SailPnmVersion version;
     double multiplier_to_full_range;
     unsigned bpc;
+
+    /* Full frame width and the region of interest. */
+    unsigned width;
+    unsigned roi_x;
+    unsigned roi_y;
 };
 
 static sail_status_t alloc_pnm_state(struct sail_io *io,
@@ -67,6 +72,10 @@ static sail_status_t alloc_pnm_state(struct sail_io *io,
 
         .multiplier_to_full_range = 0,
         .bpc                      = 0,
+
+        .width                    = 0,
+        .roi_x                    = 0,
+        .roi_y                    = 0,
     };
 
     return SAIL_OK;
@@ -217,8 +226,13 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_pnm(void *state, st
         }
     }
 
-    image_local->width          = w;
-    image_local->height         = h;
+    /* Region of interest. */
+    pnm_state->width = w;
+
+    SAIL_TRY_OR_CLEANUP(sail_intersect_roi(pnm_state->load_options, w, h,
+                                            &pnm_state->roi_x, &pnm_state->roi_y, &image_local->width, &image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
+
     image_local->pixel_format   = pixel_format;
     image_local->delay          = -1;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
@@ -239,55 +253,85 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_pnm(void *state, struct sail_
 
     const struct pnm_state *pnm_state = state;
 
-    switch (pnm_state->version) {
-        case SAIL_PNM_VERSION_P1: {
-            for (unsigned row = 0; row < image->height; row++) {
-                uint8_t *scan = sail_scan_line(image, row);
-                unsigned shift = 8;
-
-                for (unsigned column = 0; column < image->width; column++) {
-                    char first_char;
-                    SAIL_TRY(pnm_private_skip_to_letters_numbers_force_read(pnm_state->io, &first_char));
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+    const bool full_width         = image->width == pnm_state->width;
 
-                    const unsigned value = first_char - '0';
+    /* Validation decodes all the rows into the very first scan line. */
+    const bool validate = pnm_state->load_options->options & SAIL_OPTION_VALIDATE;
 
-                    if (value != 0 && value != 1) {
-                        SAIL_LOG_ERROR("PNM: Unexpected character '%c'", first_char);
-                        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-                    }
+    /* Scan line to read into when only a part of the frame is requested. */
+    unsigned char *scanline = NULL;
 
-                    if (shift == 8) {
-                        *scan = 0;
-                    }
+    if (!full_width || pnm_state->roi_y > 0) {
+        void *ptr;
+        SAIL_TRY(sail_malloc(sail_bytes_per_line(pnm_state->width, image->pixel_format), &ptr));
+        scanline = ptr;
+    }
 
-                    *scan |= (value << --shift);
+    switch (pnm_state->version) {
+        case SAIL_PNM_VERSION_P1:
+        case SAIL_PNM_VERSION_P2:
+        case SAIL_PNM_VERSION_P3: {
+            /* ASCII pixels are read sequentially. Rows after the region of interest are not read at all. */
+            for (unsigned row = 0; row < pnm_state->roi_y + image->height; row++) {
+                const bool in_roi = row >= pnm_state->roi_y;
+                void *scan = (in_roi && full_width) ? sail_scan_line(image, validate ? 0 : row - pnm_state->roi_y) : scanline;
+
+                if (pnm_state->version == SAIL_PNM_VERSION_P1) {
+                    SAIL_TRY_OR_CLEANUP(pnm_private_read_bitmap_row(pnm_state->io, pnm_state->width, scan),
+                                        /* cleanup */ sail_free(scanline));
+                } else {
+                    const unsigned channels = (pnm_state->version == SAIL_PNM_VERSION_P2) ? 1 : 3;
+
+                    SAIL_TRY_OR_CLEANUP(pnm_private_read_row(pnm_state->io, pnm_state->width, channels, pnm_state->bpc, pnm_state->multiplier_to_full_range, scan),
+                                        /* cleanup */ sail_free(scanline));
+                }
 
-                    if (shift == 0) {
-                        scan++;
-                        shift = 8;
-                    }
+                if (in_roi && !full_width) {
+                    sail_copy_scan_line_pixels(scanline, pnm_state->roi_x, image->width, image->pixel_format,
+                                                sail_scan_line(image, validate ? 0 : row - pnm_state->roi_y));
                 }
             }
             break;
         }
-        case SAIL_PNM_VERSION_P2: {
-            SAIL_TRY(pnm_private_read_pixels(pnm_state->io, image, 1, pnm_state->bpc, pnm_state->multiplier_to_full_range));
-            break;
-        }
-        case SAIL_PNM_VERSION_P3: {
-            SAIL_TRY(pnm_private_read_pixels(pnm_state->io, image, 3, pnm_state->bpc, pnm_state->multiplier_to_full_range));
-            break;
-        }
         case SAIL_PNM_VERSION_P4:
         case SAIL_PNM_VERSION_P5:
         case SAIL_PNM_VERSION_P6: {
+            /* Raw pixels are seeked to directly. */
+            const size_t file_bytes_per_line = sail_bytes_per_line(pnm_state->width, image->pixel_format);
+            const size_t first_byte          = (size_t)pnm_state->roi_x * bits_per_pixel / 8;
+            const unsigned x_in_first_byte   = pnm_state->roi_x - (unsigned)(first_byte * 8 / bits_per_pixel);
+            const size_t bytes_to_read       = sail_bytes_per_line(x_in_first_byte + image->width, image->pixel_format);
+
+            size_t offset;
+            SAIL_TRY_OR_CLEANUP(pnm_state->io->tell(pnm_state->io->stream, &offset),
+                                /* cleanup */ sail_free(scanline));
+
             for (unsigned row = 0; row < image->height; row++) {
-                SAIL_TRY(pnm_state->io->strict_read(pnm_state->io->stream, sail_scan_line(image, row), image->bytes_per_line));
+                /* Rows of the full width follow each other. */
+                if (row == 0 || !full_width) {
+                    SAIL_TRY_OR_CLEANUP(pnm_state->io->seek(pnm_state->io->stream,
+                                                            (long)(offset + (pnm_state->roi_y + row) * file_bytes_per_line + first_byte),
+                                                            SEEK_SET),
+                                        /* cleanup */ sail_free(scanline));
+                }
+
+                if (x_in_first_byte == 0) {
+                    SAIL_TRY_OR_CLEANUP(pnm_state->io->strict_read(pnm_state->io->stream, sail_scan_line(image, validate ? 0 : row), image->bytes_per_line),
+                                        /* cleanup */ sail_free(scanline));
+                } else {
+                    SAIL_TRY_OR_CLEANUP(pnm_state->io->strict_read(pnm_state->io->stream, scanline, bytes_to_read),
+                                        /* cleanup */ sail_free(scanline));
+
+                    sail_copy_scan_line_pixels(scanline, x_in_first_byte, image->width, image->pixel_format, sail_scan_line(image, validate ? 0 : row));
+                }
             }
             break;
         }
     }
 
+    sail_free(scanline);
+
     return SAIL_OK;
 }
 
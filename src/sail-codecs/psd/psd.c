@@ -250,6 +250,8 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_psd(void *state, struct sail_
     if (psd_state->compression == SAIL_PSD_COMPRESSION_RLE) {
         for (unsigned channel = 0; channel < psd_state->channels; channel++) {
             for (unsigned row = 0; row < image->height; row++) {
+                SAIL_TRY(sail_check_cancel_token(psd_state->load_options->cancel_token));
+
                 for (unsigned count = 0; count < image->width; ) {
                     unsigned char c;
                     SAIL_TRY(psd_state->io->strict_read(psd_state->io->stream, &c, sizeof(c)));
@@ -284,6 +286,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_psd(void *state, struct sail_
     } else {
         for (unsigned channel = 0; channel < psd_state->channels; channel++) {
             for (unsigned row = 0; row < image->height; row++) {
+                SAIL_TRY(sail_check_cancel_token(psd_state->load_options->cancel_token));
                 SAIL_TRY(psd_state->io->strict_read(psd_state->io->stream, psd_state->scan_buffer, psd_state->bytes_per_channel));
 
                 for (unsigned count = 0; count < psd_state->bytes_per_channel; count++) {
@@ -104,6 +104,10 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_qoi(struct sail_io *io, const
     *state = qoi_state;
 
     /* Cache the entire file as the QOI API requires. */
+    size_t image_data_size;
+    SAIL_TRY(sail_io_size(io, &image_data_size));
+    SAIL_TRY(sail_check_memory_limit(qoi_state->load_options, image_data_size));
+
     SAIL_TRY(sail_alloc_data_from_io_contents(io, &qoi_state->image_data, &qoi_state->image_data_size));
 
     return SAIL_OK;
@@ -119,6 +123,16 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_qoi(void *state, st
 
     qoi_state->frame_loaded = true;
 
+    /* qoi_decode() allocates the whole decoded image, so check the header first. */
+    if (qoi_state->image_data_size >= QOI_HEADER_SIZE) {
+        int p = 4;
+        const unsigned width  = qoi_read_32(qoi_state->image_data, &p);
+        const unsigned height = qoi_read_32(qoi_state->image_data, &p);
+
+        SAIL_TRY(sail_check_dimensions_limit(qoi_state->load_options, width, height));
+        SAIL_TRY(sail_check_memory_limit(qoi_state->load_options, (uint64_t)width * height * 4));
+    }
+
     /* Decode the image. */
     /* TODO Remove (int) when QOI supports size_t. */
     qoi_state->pixels = qoi_decode(qoi_state->image_data, (int)qoi_state->image_data_size, &qoi_state->qoi_desc, 0);
@@ -119,6 +119,9 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_svg(struct sail_io *io, const
     /* Read the entire image as the resvg API requires. */
     void *image_data;
     size_t image_size;
+    SAIL_TRY(sail_io_size(io, &image_size));
+    SAIL_TRY(sail_check_memory_limit(svg_state->load_options, image_size));
+
     SAIL_TRY(sail_alloc_data_from_io_contents(io, &image_data, &image_size));
 
 #ifdef SAIL_RESVG
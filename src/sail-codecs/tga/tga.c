@@ -50,6 +50,15 @@ struct tga_state {
     bool tga2;
     bool flipped_h;
     bool flipped_v;
+
+    /* Region of interest. */
+    unsigned roi_x;
+    unsigned roi_y;
+
+    /* RLE packets may span several scan lines. */
+    unsigned rle_count;
+    bool rle_packet;
+    unsigned char rle_pixel[4];
 };
 
 static sail_status_t alloc_tga_state(struct sail_io *io,
@@ -70,6 +79,12 @@ static sail_status_t alloc_tga_state(struct sail_io *io,
         .tga2          = false,
         .flipped_h     = false,
         .flipped_v     = false,
+
+        .roi_x         = 0,
+        .roi_y         = 0,
+
+        .rle_count     = 0,
+        .rle_packet    = false,
     };
 
     return SAIL_OK;
@@ -84,6 +99,52 @@ static void destroy_tga_state(struct tga_state *tga_state) {
     sail_free(tga_state);
 }
 
+/* Decodes the specified number of pixels continuing the current RLE packet if any. */
+static sail_status_t read_rle_pixels(struct tga_state *tga_state, unsigned pixel_size, unsigned pixels_num, unsigned char *pixels) {
+
+    for (unsigned i = 0; i < pixels_num; i++) {
+        if (tga_state->rle_count == 0) {
+            unsigned char marker;
+            SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, &marker, 1));
+
+            tga_state->rle_count  = (marker & 0x7F) + 1;
+
+            /* 7th bit set = RLE packet. */
+            tga_state->rle_packet = marker & 0x80;
+
+            if (tga_state->rle_packet) {
+                SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, tga_state->rle_pixel, pixel_size));
+            }
+        }
+
+        if (tga_state->rle_packet) {
+            memcpy(pixels, tga_state->rle_pixel, pixel_size);
+        } else {
+            SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, pixels, pixel_size));
+        }
+
+        pixels += pixel_size;
+        tga_state->rle_count--;
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Bottom-up images are put in reverse order so no vertical mirroring is needed.
+ * Validation decodes all the rows into the very first scan line.
+ */
+static void *roi_scan_line(const struct tga_state *tga_state, struct sail_image *image, unsigned first_file_row, unsigned file_row) {
+
+    if (tga_state->load_options->options & SAIL_OPTION_VALIDATE) {
+        return sail_scan_line(image, 0);
+    }
+
+    const unsigned row = file_row - first_file_row;
+
+    return sail_scan_line(image, tga_state->flipped_v ? image->height - 1 - row : row);
+}
+
 /*
  * Decoding functions.
  */
@@ -154,8 +215,11 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tga(void *state, st
         }
     }
 
-    image_local->width          = tga_state->file_header.width;
-    image_local->height         = tga_state->file_header.height;
+    /* Region of interest. */
+    SAIL_TRY_OR_CLEANUP(sail_intersect_roi(tga_state->load_options, tga_state->file_header.width, tga_state->file_header.height,
+                                            &tga_state->roi_x, &tga_state->roi_y, &image_local->width, &image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
+
     image_local->pixel_format   = pixel_format;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
@@ -196,53 +260,71 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_tga(void *state, struct sail_
 
     struct tga_state *tga_state = state;
 
+    const unsigned pixel_size            = (tga_state->file_header.bpp + 7) / 8;
+    const size_t file_bytes_per_line     = (size_t)tga_state->file_header.width * pixel_size;
+    const size_t roi_bytes_per_line      = (size_t)image->width * pixel_size;
+    const bool full_width                = image->width == tga_state->file_header.width;
+
+    /* Rows and columns of the region of interest as stored in the file. */
+    const unsigned file_x         = tga_state->flipped_h ? tga_state->file_header.width - tga_state->roi_x - image->width : tga_state->roi_x;
+    const unsigned first_file_row = tga_state->flipped_v ? tga_state->file_header.height - tga_state->roi_y - image->height : tga_state->roi_y;
+
     switch (tga_state->file_header.image_type) {
         case TGA_INDEXED:
         case TGA_TRUE_COLOR:
         case TGA_GRAY: {
-            SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
+            size_t offset;
+            SAIL_TRY(tga_state->io->tell(tga_state->io->stream, &offset));
+
+            for (unsigned file_row = first_file_row; file_row < first_file_row + image->height; file_row++) {
+                SAIL_TRY(sail_check_cancel_token(tga_state->load_options->cancel_token));
+
+                /* Rows of the full width follow each other. */
+                if (file_row == first_file_row || !full_width) {
+                    SAIL_TRY(tga_state->io->seek(tga_state->io->stream,
+                                                    (long)(offset + file_row * file_bytes_per_line + (size_t)file_x * pixel_size),
+                                                    SEEK_SET));
+                }
+
+                SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, roi_scan_line(tga_state, image, first_file_row, file_row), roi_bytes_per_line));
+            }
             break;
         }
         case TGA_INDEXED_RLE:
         case TGA_TRUE_COLOR_RLE:
         case TGA_GRAY_RLE: {
-            const unsigned pixel_size = (tga_state->file_header.bpp + 7) / 8;
-            const unsigned pixels_num = image->width * image->height;
-
-            unsigned char *pixels = image->pixels;
-
-            for (unsigned i = 0; i < pixels_num;) {
-                unsigned char marker;
-                SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, &marker, 1));
-
-                unsigned count = (marker & 0x7F) + 1;
+            unsigned char *scanline = NULL;
 
-                /* 7th bit set = RLE packet. */
-                if (marker & 0x80) {
-                    unsigned char pixel[4];
+            if (!full_width || first_file_row > 0) {
+                void *ptr;
+                SAIL_TRY(sail_malloc(file_bytes_per_line, &ptr));
+                scanline = ptr;
+            }
 
-                    SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, pixel, pixel_size));
+            /* Rows after the region of interest are not decoded at all. */
+            for (unsigned file_row = 0; file_row < first_file_row + image->height; file_row++) {
+                SAIL_TRY_OR_CLEANUP(sail_check_cancel_token(tga_state->load_options->cancel_token),
+                                    /* cleanup */ sail_free(scanline));
 
-                    for (unsigned j = 0; j < count; j++, i++) {
-                        memcpy(pixels, pixel, pixel_size);
-                        pixels += pixel_size;
-                    }
+                if (file_row >= first_file_row && full_width) {
+                    SAIL_TRY_OR_CLEANUP(read_rle_pixels(tga_state, pixel_size, image->width, roi_scan_line(tga_state, image, first_file_row, file_row)),
+                                        /* cleanup */ sail_free(scanline));
                 } else {
-                    for (unsigned j = 0; j < count; j++, i++) {
-                        SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, pixels, pixel_size));
-                        pixels += pixel_size;
+                    SAIL_TRY_OR_CLEANUP(read_rle_pixels(tga_state, pixel_size, tga_state->file_header.width, scanline),
+                                        /* cleanup */ sail_free(scanline));
+
+                    if (file_row >= first_file_row) {
+                        memcpy(roi_scan_line(tga_state, image, first_file_row, file_row), scanline + (size_t)file_x * pixel_size, roi_bytes_per_line);
                     }
                 }
             }
+
+            sail_free(scanline);
             break;
         }
     }
 
-    /* TODO: We can avoid this by putting pixels in reverse order like in the BMP codec. */
-    if (tga_state->flipped_v) {
-        sail_mirror_vertically(image);
-    }
-    if (tga_state->flipped_h) {
+    if (tga_state->flipped_h && !(tga_state->load_options->options & SAIL_OPTION_VALIDATE)) {
         sail_mirror_horizontally(image);
     }
 
@@ -47,6 +47,7 @@ struct tiff_state {
     bool libtiff_error;
     int save_compression;
     TIFFRGBAImage image;
+    bool image_started;
     int line;
 };
 
@@ -66,6 +67,7 @@ static sail_status_t alloc_tiff_state(const struct sail_load_options *load_optio
         .current_frame    = 0,
         .libtiff_error    = false,
         .save_compression = COMPRESSION_NONE,
+        .image_started    = false,
         .line             = 0,
     };
 
@@ -134,6 +136,12 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tiff(void *state, s
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    /* The previous frame may have been skipped without loading. */
+    if (tiff_state->image_started) {
+        TIFFRGBAImageEnd(&tiff_state->image);
+        tiff_state->image_started = false;
+    }
+
     struct sail_image *image_local;
     SAIL_TRY(sail_alloc_image(&image_local));
 
@@ -151,6 +159,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tiff(void *state, s
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    tiff_state->image_started = true;
     tiff_state->image.req_orientation = ORIENTATION_TOPLEFT;
 
     /* Fill the image properties. */
@@ -160,6 +169,15 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tiff(void *state, s
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    /* Region of interest. libtiff decodes only the strips and tiles intersecting it. */
+    unsigned roi_x, roi_y;
+    SAIL_TRY_OR_CLEANUP(sail_intersect_roi(tiff_state->load_options, image_local->width, image_local->height,
+                                            &roi_x, &roi_y, &image_local->width, &image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    tiff_state->image.col_offset = (int)roi_x;
+    tiff_state->image.row_offset = (int)roi_y;
+
     /* Fetch meta data. */
     if (tiff_state->load_options->options & SAIL_OPTION_META_DATA) {
         struct sail_meta_data_node **last_meta_data_node = &image_local->meta_data_node;
@@ -210,11 +228,30 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_tiff(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    if (!TIFFRGBAImageGet(&tiff_state->image, image->pixels, image->width, image->height)) {
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    const struct sail_cancel_token *cancel_token = tiff_state->load_options->cancel_token;
+
+    if (cancel_token == NULL) {
+        if (!TIFFRGBAImageGet(&tiff_state->image, image->pixels, image->width, image->height)) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    } else {
+        /* Decode in stripes to check the cancellation token in between. */
+        const int row_offset = tiff_state->image.row_offset;
+
+        for (unsigned row = 0; row < image->height; row += 64) {
+            SAIL_TRY(sail_check_cancel_token(cancel_token));
+
+            const unsigned rows = SAIL_MIN(64U, image->height - row);
+            tiff_state->image.row_offset = row_offset + (int)row;
+
+            if (!TIFFRGBAImageGet(&tiff_state->image, sail_scan_line(image, row), image->width, rows)) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+        }
     }
 
     TIFFRGBAImageEnd(&tiff_state->image);
+    tiff_state->image_started = false;
 
     return SAIL_OK;
 }
@@ -225,6 +262,10 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_tiff(void **state) {
 
     *state = NULL;
 
+    if (tiff_state->image_started) {
+        TIFFRGBAImageEnd(&tiff_state->image);
+    }
+
     if (tiff_state->tiff != NULL) {
         TIFFCleanup(tiff_state->tiff);
     }
@@ -325,6 +366,8 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_tiff(void *state, const struc
     }
 
     for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY(sail_check_cancel_token(tiff_state->save_options->cancel_token));
+
         if (TIFFWriteScanline(tiff_state->tiff, sail_scan_line(image, row), tiff_state->line++, 0) < 0) {
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
         }
@@ -25,6 +25,8 @@
 
 #include <string.h>
 
+#include <webp/decode.h>
+
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
@@ -41,12 +43,71 @@ void webp_private_fill_color(uint8_t *pixels, unsigned bytes_per_line, unsigned
     }
 }
 
-sail_status_t webp_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned width, unsigned bytes_per_pixel) {
+uint32_t webp_private_premultiply_color(uint32_t color) {
+
+    /* The color is copied into pixels as is, so alpha is the last byte in memory. */
+    uint8_t bytes[4];
+    memcpy(bytes, &color, sizeof(bytes));
+
+    for (unsigned i = 0; i < 3; i++) {
+        bytes[i] = (uint8_t)((bytes[i] * bytes[3] + 127) / 255);
+    }
+
+    memcpy(&color, bytes, sizeof(color));
+
+    return color;
+}
+
+sail_status_t webp_private_decode_into(const uint8_t *data, size_t data_size, bool premultiplied,
+                                        uint8_t *pixels, size_t pixels_size, unsigned bytes_per_line) {
+
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(pixels);
+
+    WebPDecoderConfig config;
+
+    if (!WebPInitDecoderConfig(&config)) {
+        SAIL_LOG_ERROR("WEBP: Failed to initialize the decoder configuration");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* libwebp premultiplies the pixels itself while decoding. */
+    config.output.colorspace         = premultiplied ? MODE_rgbA : MODE_RGBA;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba        = pixels;
+    config.output.u.RGBA.stride      = (int)bytes_per_line;
+    config.output.u.RGBA.size        = pixels_size;
+
+    const VP8StatusCode status = WebPDecode(data, data_size, &config);
+
+    WebPFreeDecBuffer(&config.output);
+
+    if (status != VP8_STATUS_OK) {
+        SAIL_LOG_ERROR("WEBP: Failed to decode image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t webp_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned width, unsigned bytes_per_pixel, bool premultiplied) {
 
     SAIL_CHECK_PTR(src_raw);
     SAIL_CHECK_PTR(dst_raw);
 
-    if (bytes_per_pixel == 4) {
+    if (bytes_per_pixel == 4 && premultiplied) {
+        const uint8_t *src = src_raw;
+        uint8_t *dst = (uint8_t *)dst_raw + dst_offset * bytes_per_pixel;
+
+        /* Premultiplied colors and alpha are blended with the same formula. */
+        while (width--) {
+            const unsigned src_a_inv = 255 - *(src+3);
+
+            for (unsigned i = 0; i < 4; i++, src++, dst++) {
+                *dst = (uint8_t)(*src + (*dst * src_a_inv + 127) / 255);
+            }
+        }
+    } else if (bytes_per_pixel == 4) {
         const uint8_t *src = src_raw;
         uint8_t *dst = (uint8_t *)dst_raw + dst_offset * bytes_per_pixel;
 
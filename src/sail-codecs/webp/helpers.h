@@ -26,6 +26,8 @@
 #ifndef SAIL_WEBP_HELPERS_H
 #define SAIL_WEBP_HELPERS_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <webp/demux.h>
@@ -37,8 +39,13 @@
 SAIL_HIDDEN void webp_private_fill_color(uint8_t *pixels, unsigned bytes_per_line, unsigned bytes_per_pixel,
                                             uint32_t color, unsigned x, unsigned y, unsigned width, unsigned height);
 
+SAIL_HIDDEN uint32_t webp_private_premultiply_color(uint32_t color);
+
+SAIL_HIDDEN sail_status_t webp_private_decode_into(const uint8_t *data, size_t data_size, bool premultiplied,
+                                                    uint8_t *pixels, size_t pixels_size, unsigned bytes_per_line);
+
 SAIL_HIDDEN sail_status_t webp_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw,
-                                                    unsigned width, unsigned bytes_per_pixel);
+                                                    unsigned width, unsigned bytes_per_pixel, bool premultiplied);
 
 SAIL_HIDDEN sail_status_t webp_private_fetch_iccp(WebPDemuxer *webp_demux, struct sail_iccp **iccp);
 
@@ -47,6 +47,7 @@ struct webp_state {
     WebPDemuxer *webp_demux;
     WebPIterator *webp_iterator;
     unsigned frame_number;
+    bool premultiplied;
     uint32_t background_color;
     uint32_t frame_count;
     unsigned bytes_per_pixel;
@@ -77,6 +78,7 @@ static sail_status_t alloc_webp_state(const struct sail_load_options *load_optio
         .webp_demux           = NULL,
         .webp_iterator        = NULL,
         .frame_number         = 0,
+        .premultiplied        = false,
         .background_color     = 0,
         .frame_count          = 0,
         .bytes_per_pixel      = 0,
@@ -134,6 +136,8 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_webp(struct sail_io *io, const
 
     SAIL_TRY(io->seek(io->stream, 0, SEEK_SET));
 
+    SAIL_TRY(sail_check_memory_limit(webp_state->load_options, webp_state->image_data_size));
+
     void *ptr;
     SAIL_TRY(sail_malloc(webp_state->image_data_size, &ptr));
     webp_state->image_data = ptr;
@@ -152,6 +156,13 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_webp(struct sail_io *io, const
     webp_state->background_color = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_BACKGROUND_COLOR);
     webp_state->frame_count      = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_FRAME_COUNT);
 
+    /* Compose frames in premultiplied alpha space when it's requested, so they're not converted afterwards. */
+    webp_state->premultiplied = webp_state->load_options->output_pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+
+    if (webp_state->premultiplied) {
+        webp_state->background_color = webp_private_premultiply_color(webp_state->background_color);
+    }
+
     /* Construct a canvas image. */
     struct sail_image *image_local;
     SAIL_TRY(sail_alloc_image(&image_local));
@@ -166,11 +177,17 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_webp(struct sail_io *io, const
 
     image_local->width          = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_CANVAS_WIDTH);
     image_local->height         = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_CANVAS_HEIGHT);
-    image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image_local->pixel_format   = webp_state->premultiplied ? SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED : SAIL_PIXEL_FORMAT_BPP32_RGBA;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
     webp_state->bytes_per_pixel = image_local->bytes_per_line / image_local->width;
 
+    /* The canvas is allocated on the first frame. */
+    SAIL_TRY_OR_CLEANUP(sail_check_dimensions_limit(webp_state->load_options, image_local->width, image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(sail_check_memory_limit(webp_state->load_options, (uint64_t)image_local->bytes_per_line * image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
+
     /* Fetch ICCP. */
     if (webp_state->load_options->options & SAIL_OPTION_ICCP) {
         SAIL_TRY_OR_CLEANUP(webp_private_fetch_iccp(webp_state->webp_demux, &image_local->iccp),
@@ -265,33 +282,30 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_webp(void *state, struct sail
 
     switch (webp_state->frame_blend_method) {
         case WEBP_MUX_NO_BLEND: {
-            if (WebPDecodeRGBAInto(webp_state->webp_iterator->fragment.bytes,
-                                    webp_state->webp_iterator->fragment.size,
-                                    (uint8_t *)webp_state->canvas_image->pixels + webp_state->canvas_image->bytes_per_line * webp_state->frame_y +
-                                        webp_state->frame_x * webp_state->bytes_per_pixel,
-                                    (size_t)webp_state->canvas_image->bytes_per_line * webp_state->canvas_image->height,
-                                    webp_state->canvas_image->bytes_per_line) == NULL) {
-                SAIL_LOG_ERROR("WEBP: Failed to decode image");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-            }
+            SAIL_TRY(webp_private_decode_into(webp_state->webp_iterator->fragment.bytes,
+                                                webp_state->webp_iterator->fragment.size,
+                                                webp_state->premultiplied,
+                                                (uint8_t *)webp_state->canvas_image->pixels + webp_state->canvas_image->bytes_per_line * webp_state->frame_y +
+                                                    webp_state->frame_x * webp_state->bytes_per_pixel,
+                                                (size_t)webp_state->canvas_image->bytes_per_line * webp_state->canvas_image->height,
+                                                webp_state->canvas_image->bytes_per_line));
             break;
         }
         case WEBP_MUX_BLEND: {
-            if (WebPDecodeRGBAInto(webp_state->webp_iterator->fragment.bytes,
-                                    webp_state->webp_iterator->fragment.size,
-                                    image->pixels,
-                                    (size_t)image->bytes_per_line * image->height,
-                                    webp_state->frame_width * webp_state->bytes_per_pixel) == NULL) {
-                SAIL_LOG_ERROR("WEBP: Failed to decode image");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-            }
+            SAIL_TRY(webp_private_decode_into(webp_state->webp_iterator->fragment.bytes,
+                                                webp_state->webp_iterator->fragment.size,
+                                                webp_state->premultiplied,
+                                                image->pixels,
+                                                (size_t)image->bytes_per_line * image->height,
+                                                webp_state->frame_width * webp_state->bytes_per_pixel));
 
             uint8_t *dst_scanline = (uint8_t *)sail_scan_line(webp_state->canvas_image, webp_state->frame_y) + webp_state->frame_x * webp_state->bytes_per_pixel;
             uint8_t *src_scanline = image->pixels;
 
             for (unsigned row = 0; row < webp_state->frame_height; row++, dst_scanline += webp_state->canvas_image->bytes_per_line,
                                                                           src_scanline += webp_state->frame_width * webp_state->bytes_per_pixel) {
-                SAIL_TRY(webp_private_blend_over(dst_scanline, 0, src_scanline, webp_state->frame_width, webp_state->bytes_per_pixel));
+                SAIL_TRY(webp_private_blend_over(dst_scanline, 0, src_scanline, webp_state->frame_width, webp_state->bytes_per_pixel,
+                                                    webp_state->premultiplied));
             }
             break;
         }
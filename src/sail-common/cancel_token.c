@@ -0,0 +1,73 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "sail-common.h"
+
+sail_status_t sail_alloc_cancel_token(struct sail_cancel_token **cancel_token) {
+
+    SAIL_CHECK_PTR(cancel_token);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_cancel_token), &ptr));
+    *cancel_token = ptr;
+
+    (*cancel_token)->is_canceled = NULL;
+    (*cancel_token)->user_data   = NULL;
+    (*cancel_token)->deadline    = 0;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_cancel_token(struct sail_cancel_token *cancel_token) {
+
+    if (cancel_token == NULL) {
+        return;
+    }
+
+    sail_free(cancel_token);
+}
+
+sail_status_t sail_check_cancel_token(const struct sail_cancel_token *cancel_token) {
+
+    if (cancel_token == NULL) {
+        return SAIL_OK;
+    }
+
+    if (cancel_token->is_canceled != NULL && cancel_token->is_canceled(cancel_token->user_data)) {
+        SAIL_LOG_DEBUG("The operation is canceled");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CANCELED);
+    }
+
+    if (cancel_token->deadline > 0 && sail_now() >= cancel_token->deadline) {
+        SAIL_LOG_DEBUG("The operation deadline is reached");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CANCELED);
+    }
+
+    return SAIL_OK;
+}
@@ -0,0 +1,88 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CANCEL_TOKEN_H
+#define SAIL_CANCEL_TOKEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cancellation token to abort long loading, saving, and conversion operations. Codecs and conversion
+ * functions check the token periodically, usually once per scan line, and abort with SAIL_ERROR_CANCELED.
+ *
+ * The token is not owned by load, save, or conversion options. It must stay alive until
+ * the operation is finished. The same token can be shared between multiple operations.
+ */
+struct sail_cancel_token {
+
+    /*
+     * Returns true if the operation must be aborted. It must be thread-safe if the token is shared
+     * between threads, for example, by checking an atomic flag. Can be NULL.
+     */
+    bool (*is_canceled)(void *user_data);
+
+    /* User data passed to is_canceled(). */
+    void *user_data;
+
+    /* Absolute deadline in milliseconds as returned by sail_now(). Zero means no deadline. */
+    uint64_t deadline;
+};
+
+typedef struct sail_cancel_token sail_cancel_token_t;
+
+/*
+ * Allocates a new cancellation token without a callback and a deadline.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_cancel_token(struct sail_cancel_token **cancel_token);
+
+/*
+ * Destroys the specified cancellation token.
+ */
+SAIL_EXPORT void sail_destroy_cancel_token(struct sail_cancel_token *cancel_token);
+
+/*
+ * Checks if the operation must be aborted because the token is canceled or its deadline is reached.
+ * The token can be NULL.
+ *
+ * Returns SAIL_OK if the operation can continue or SAIL_ERROR_CANCELED otherwise.
+ */
+SAIL_EXPORT sail_status_t sail_check_cancel_token(const struct sail_cancel_token *cancel_token);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -170,6 +170,33 @@ enum SailPixelFormat {
     SAIL_PIXEL_FORMAT_BPP40_YUVA,
     SAIL_PIXEL_FORMAT_BPP48_YUVA,
     SAIL_PIXEL_FORMAT_BPP64_YUVA,
+
+    /*
+     * Planar YUV formats with full range YCbCr components like in BPP24-YCBCR. The Y plane
+     * is followed by the chroma planes in the same pixel data. Bytes per line is the Y plane
+     * stride. See sail_planes().
+     */
+    SAIL_PIXEL_FORMAT_BPP12_YUV420P, /* I420: Y plane, then U and V planes subsampled 2x2 */
+    SAIL_PIXEL_FORMAT_BPP12_NV12,    /* Y plane, then interleaved UV plane subsampled 2x2 */
+    SAIL_PIXEL_FORMAT_BPP24_YUV444P, /* Y, U, and V planes without subsampling            */
+
+    /*
+     * RGBA formats with color channels premultiplied by alpha. Every color channel
+     * is less than or equal to alpha.
+     */
+    SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED,
+    SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED,
+    SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED,
+    SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED,
+
+    /*
+     * Half-float (IEEE 754 binary16) and float RGB formats for HDR images. 0.0 and 1.0 correspond
+     * to the minimum and maximum integer values. Color channels above 1.0 are brighter than SDR white.
+     */
+    SAIL_PIXEL_FORMAT_BPP48_RGB_HALF,
+    SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,
+    SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT,
+    SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT,
 };
 
 /* Chroma subsampling. See https://en.wikipedia.org/wiki/Chroma_subsampling */
@@ -318,6 +345,12 @@ enum SailCodecFeature {
 
     /* Can preserve the source image information. */
     SAIL_CODEC_FEATURE_SOURCE_IMAGE = 1 << 7,
+
+    /* Can load a region of interest without decoding the whole image. See sail_load_options.roi_width. */
+    SAIL_CODEC_FEATURE_ROI          = 1 << 8,
+
+    /* Can validate images decoding pixels into a single scan line. See SAIL_OPTION_VALIDATE. */
+    SAIL_CODEC_FEATURE_VALIDATE     = 1 << 9,
 };
 
 /* Load or save options. */
@@ -340,6 +373,35 @@ enum SailOption {
      * Specifying this option for saving operations has no effect.
      */
     SAIL_OPTION_SOURCE_IMAGE = 1 << 3,
+
+    /*
+     * Instruction to decode all the rows of a frame into its very first scan line and discard them.
+     * Used by sail_validate_io() for codecs with SAIL_CODEC_FEATURE_VALIDATE. Specifying this option
+     * for saving operations has no effect.
+     */
+    SAIL_OPTION_VALIDATE     = 1 << 4,
+
+    /*
+     * Instruction to rotate loaded frames upright according to their EXIF orientation. EXIF is loaded
+     * even without SAIL_OPTION_META_DATA, but it's kept in frames only with SAIL_OPTION_META_DATA.
+     * Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_AUTO_ORIENT  = 1 << 5,
+
+    /*
+     * Instruction to transform pixels of loaded frames from their embedded ICC profiles into sRGB
+     * and remove the profiles. ICC profiles are loaded even without SAIL_OPTION_ICCP. Frames with
+     * unsupported profiles or pixel formats are left as is and keep their profiles.
+     * See sail_transform_image_colors(). Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_COLOR_MANAGEMENT = 1 << 6,
+
+    /*
+     * Instruction to compute statistics of loaded frames into sail_image.statistics after all
+     * other load options are applied. Frames with unsupported pixel formats get no statistics.
+     * See sail_compute_image_statistics(). Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_STATISTICS   = 1 << 7,
 };
 
 #endif
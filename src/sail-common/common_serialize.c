@@ -123,6 +123,20 @@ const char* sail_pixel_format_to_string(enum SailPixelFormat pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP40_YUVA:            return "BPP40-YUVA";
         case SAIL_PIXEL_FORMAT_BPP48_YUVA:            return "BPP48-YUVA";
         case SAIL_PIXEL_FORMAT_BPP64_YUVA:            return "BPP64-YUVA";
+
+        case SAIL_PIXEL_FORMAT_BPP12_YUV420P:         return "BPP12-YUV420P";
+        case SAIL_PIXEL_FORMAT_BPP12_NV12:            return "BPP12-NV12";
+        case SAIL_PIXEL_FORMAT_BPP24_YUV444P:         return "BPP24-YUV444P";
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: return "BPP32-RGBA-PREMULTIPLIED";
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: return "BPP32-BGRA-PREMULTIPLIED";
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: return "BPP64-RGBA-PREMULTIPLIED";
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: return "BPP64-BGRA-PREMULTIPLIED";
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:        return "BPP48-RGB-HALF";
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:       return "BPP64-RGBA-HALF";
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:       return "BPP96-RGB-FLOAT";
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT:     return "BPP128-RGBA-FLOAT";
     }
 
     return NULL;
@@ -233,6 +247,20 @@ enum SailPixelFormat sail_pixel_format_from_string(const char *str) {
         case UINT64_C(8244605668934919965):  return SAIL_PIXEL_FORMAT_BPP40_YUVA;
         case UINT64_C(8244605669248003109):  return SAIL_PIXEL_FORMAT_BPP48_YUVA;
         case UINT64_C(8244605671674397475):  return SAIL_PIXEL_FORMAT_BPP64_YUVA;
+
+        case UINT64_C(13237220243473897185): return SAIL_PIXEL_FORMAT_BPP12_YUV420P;
+        case UINT64_C(8244605665138391390):  return SAIL_PIXEL_FORMAT_BPP12_NV12;
+        case UINT64_C(13237269467775537930): return SAIL_PIXEL_FORMAT_BPP24_YUV444P;
+
+        case UINT64_C(5755462582571748834):  return SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+        case UINT64_C(10184454581647182306): return SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED;
+        case UINT64_C(403932174454299175):   return SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED;
+        case UINT64_C(4832924173529732647):  return SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED;
+
+        case UINT64_C(12558027227981272355): return SAIL_PIXEL_FORMAT_BPP48_RGB_HALF;
+        case UINT64_C(8681486799609175842):  return SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF;
+        case UINT64_C(8836176276367984001):  return SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT;
+        case UINT64_C(8069583518561661742):  return SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT;
     }
 
     return SAIL_PIXEL_FORMAT_UNKNOWN;
@@ -509,6 +537,8 @@ const char* sail_codec_feature_to_string(enum SailCodecFeature codec_feature) {
         case SAIL_CODEC_FEATURE_INTERLACED:   return "INTERLACED";
         case SAIL_CODEC_FEATURE_ICCP:         return "ICCP";
         case SAIL_CODEC_FEATURE_SOURCE_IMAGE: return "SOURCE-IMAGE";
+        case SAIL_CODEC_FEATURE_ROI:          return "ROI";
+        case SAIL_CODEC_FEATURE_VALIDATE:     return "VALIDATE";
     }
 
     return NULL;
@@ -525,6 +555,8 @@ enum SailCodecFeature sail_codec_feature_from_string(const char *str) {
         case UINT64_C(8244927930303708800):  return SAIL_CODEC_FEATURE_INTERLACED;
         case UINT64_C(6384139556):           return SAIL_CODEC_FEATURE_ICCP;
         case UINT64_C(14115912967723543398): return SAIL_CODEC_FEATURE_SOURCE_IMAGE;
+        case UINT64_C(193468975):            return SAIL_CODEC_FEATURE_ROI;
+        case UINT64_C(7571636969648271):     return SAIL_CODEC_FEATURE_VALIDATE;
     }
 
     return SAIL_CODEC_FEATURE_UNKNOWN;
@@ -30,6 +30,23 @@
 
 #include "sail-common.h"
 
+/* 1, 2, and 4-bit pixels are packed starting from the most significant bit. */
+static void swap_packed_pixels(unsigned char *scan, unsigned x1, unsigned x2, unsigned bits_per_pixel) {
+
+    const size_t bit1 = (size_t)x1 * bits_per_pixel;
+    const size_t bit2 = (size_t)x2 * bits_per_pixel;
+
+    const unsigned shift1 = 8 - bits_per_pixel - (unsigned)(bit1 % 8);
+    const unsigned shift2 = 8 - bits_per_pixel - (unsigned)(bit2 % 8);
+    const unsigned mask   = (1U << bits_per_pixel) - 1;
+
+    const unsigned value1 = (scan[bit1 / 8] >> shift1) & mask;
+    const unsigned value2 = (scan[bit2 / 8] >> shift2) & mask;
+
+    scan[bit1 / 8] = (unsigned char)((scan[bit1 / 8] & ~(mask << shift1)) | (value2 << shift1));
+    scan[bit2 / 8] = (unsigned char)((scan[bit2 / 8] & ~(mask << shift2)) | (value1 << shift2));
+}
+
 sail_status_t sail_alloc_image(struct sail_image **image) {
 
     SAIL_CHECK_PTR(image);
@@ -50,6 +67,7 @@ sail_status_t sail_alloc_image(struct sail_image **image) {
     (*image)->meta_data_node = NULL;
     (*image)->iccp           = NULL;
     (*image)->source_image   = NULL;
+    (*image)->statistics     = NULL;
 
     return SAIL_OK;
 }
@@ -67,6 +85,7 @@ void sail_destroy_image(struct sail_image *image) {
     sail_destroy_meta_data_node_chain(image->meta_data_node);
     sail_destroy_iccp(image->iccp);
     sail_destroy_source_image(image->source_image);
+    sail_destroy_image_statistics(image->statistics);
 
     sail_free(image);
 }
@@ -81,7 +100,7 @@ sail_status_t sail_copy_image(const struct sail_image *source, struct sail_image
 
     /* Pixels. */
     if (source->pixels != NULL) {
-        const unsigned pixels_size = source->height * source->bytes_per_line;
+        const size_t pixels_size = sail_pixels_size(source->height, source->bytes_per_line, source->pixel_format);
 
         SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
                             /* cleanup */ sail_destroy_image(image_local));
@@ -96,6 +115,12 @@ sail_status_t sail_copy_image(const struct sail_image *source, struct sail_image
 
     }
 
+    /* Statistics describe the pixels, so skeletons don't get them. */
+    if (source->statistics != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_copy_image_statistics(source->statistics, &image_local->statistics),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
     *target = image_local;
 
     return SAIL_OK;
@@ -193,6 +218,11 @@ sail_status_t sail_mirror(struct sail_image *image, enum SailOrientation orienta
         case SAIL_ORIENTATION_MIRRORED_VERTICALLY: {
             SAIL_TRY(sail_check_image_valid(image));
 
+            if (sail_is_planar(image->pixel_format)) {
+                SAIL_LOG_ERROR("Planar pixels are not supported for the vertical mirroring");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+            }
+
             void *line;
             SAIL_TRY(sail_malloc(image->bytes_per_line, &line));
 
@@ -209,12 +239,25 @@ sail_status_t sail_mirror(struct sail_image *image, enum SailOrientation orienta
             SAIL_TRY(sail_check_image_valid(image));
 
             const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+            const bool packed = bits_per_pixel == 1 || bits_per_pixel == 2 || bits_per_pixel == 4;
 
-            if (bits_per_pixel % 8 != 0) {
-                SAIL_LOG_ERROR("Only byte-aligned pixels are supported for the horizontal mirroring");
+            if ((bits_per_pixel % 8 != 0 && !packed) || sail_is_planar(image->pixel_format)) {
+                SAIL_LOG_ERROR("Only byte-aligned or 1, 2, and 4-bit interleaved pixels are supported for the horizontal mirroring");
                 SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
             }
 
+            if (packed) {
+                for (unsigned row = 0; row < image->height; row++) {
+                    unsigned char *scan = sail_scan_line(image, row);
+
+                    for (unsigned col1 = 0, col2 = image->width - 1; col1 < col2; col1++, col2--) {
+                        swap_packed_pixels(scan, col1, col2, bits_per_pixel);
+                    }
+                }
+
+                break;
+            }
+
             const unsigned bytes_per_pixel = bits_per_pixel / 8;
 
             void *pixel;
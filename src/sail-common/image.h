@@ -37,6 +37,7 @@ extern "C" {
 #endif
 
 struct sail_iccp;
+struct sail_image_statistics;
 struct sail_meta_data_node;
 struct sail_palette;
 struct sail_resolution;
@@ -160,6 +161,15 @@ struct sail_image {
      * SAVE: Ignored.
      */
     struct sail_source_image *source_image;
+
+    /*
+     * Statistics of the pixels like histograms and the number of colors.
+     * See sail_compute_image_statistics().
+     *
+     * LOAD: Set by SAIL to valid statistics with SAIL_OPTION_STATISTICS or to NULL.
+     * SAVE: Ignored.
+     */
+    struct sail_image_statistics *statistics;
 };
 
 typedef struct sail_image sail_image_t;
@@ -216,7 +226,7 @@ SAIL_EXPORT sail_status_t sail_check_image_valid(const struct sail_image *image)
 SAIL_EXPORT sail_status_t sail_mirror_vertically(struct sail_image *image);
 
 /*
- * Mirrors the image horizontally. The image pixel size must be a multiple of 8,
+ * Mirrors the image horizontally. The image pixel size must be 1, 2, 4, or a multiple of 8,
  * e.g. 8, 16, 24 etc.
  *
  * Returns SAIL_OK on success.
@@ -227,8 +237,8 @@ SAIL_EXPORT sail_status_t sail_mirror_horizontally(struct sail_image *image);
  * Mirrors the image horizontally or vertically.
  *
  * Only SAIL_ORIENTATION_MIRRORED_HORIZONTALLY and SAIL_ORIENTATION_MIRRORED_VERTICALLY
- * values are accepted. When mirroring horizontally, the image pixel size must be a multiple of 8,
- * e.g. 8, 16, 24 etc.
+ * values are accepted. When mirroring horizontally, the image pixel size must be 1, 2, 4, or a multiple of 8,
+ * e.g. 8, 16, 24 etc. Use sail_rotate_image() from sail-manip for other orientations.
  *
  * Returns SAIL_OK on success.
  */
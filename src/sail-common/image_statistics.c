@@ -0,0 +1,61 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail-common.h"
+
+sail_status_t sail_alloc_image_statistics(struct sail_image_statistics **statistics) {
+
+    SAIL_CHECK_PTR(statistics);
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(1, sizeof(struct sail_image_statistics), &ptr));
+    *statistics = ptr;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_image_statistics(struct sail_image_statistics *statistics) {
+
+    sail_free(statistics);
+}
+
+sail_status_t sail_copy_image_statistics(const struct sail_image_statistics *source, struct sail_image_statistics **target) {
+
+    SAIL_CHECK_PTR(source);
+    SAIL_CHECK_PTR(target);
+
+    struct sail_image_statistics *target_local;
+    SAIL_TRY(sail_alloc_image_statistics(&target_local));
+
+    memcpy(target_local, source, sizeof(struct sail_image_statistics));
+
+    *target = target_local;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,119 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IMAGE_STATISTICS_H
+#define SAIL_IMAGE_STATISTICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of histogram bins of every channel. */
+#define SAIL_HISTOGRAM_BINS 256
+
+/* Distinct colors are counted up to this number, which is the largest palette size. */
+#define SAIL_STATISTICS_MAX_COLORS 256
+
+/*
+ * Channels of image statistics.
+ */
+enum SailStatisticsChannel {
+
+    SAIL_STATISTICS_CHANNEL_RED,
+    SAIL_STATISTICS_CHANNEL_GREEN,
+    SAIL_STATISTICS_CHANNEL_BLUE,
+    SAIL_STATISTICS_CHANNEL_ALPHA,
+};
+
+/*
+ * sail_image_statistics represents statistics of image pixels. Arrays are indexed with SailStatisticsChannel.
+ * Grayscale values are counted in the red, green, and blue channels. Images without alpha count
+ * every pixel as fully opaque.
+ *
+ * Computed with sail_compute_image_statistics() or while loading with SAIL_OPTION_STATISTICS.
+ */
+struct sail_image_statistics {
+
+    /* Number of pixels. */
+    uint64_t pixel_count;
+
+    /* Maximum channel value: 255 for images with up to 8 bits per channel and 65535 for 16 bits per channel. */
+    unsigned max_value;
+
+    /* Histograms of the channels. 16-bit values are counted in the bins of their most significant byte. */
+    uint64_t histograms[4][SAIL_HISTOGRAM_BINS];
+
+    /* Minimum, maximum, and mean values of the channels in the range [0; max_value]. */
+    unsigned min[4];
+    unsigned max[4];
+    double mean[4];
+
+    /* True if all the alpha values are max_value. */
+    bool opaque;
+
+    /* True if the red, green, and blue values of every pixel are equal. */
+    bool grayscale;
+
+    /*
+     * Number of distinct colors including alpha, or 0 if the image has more than
+     * SAIL_STATISTICS_MAX_COLORS colors.
+     */
+    unsigned color_count;
+};
+
+typedef struct sail_image_statistics sail_image_statistics_t;
+
+/*
+ * Allocates new image statistics with all the values set to zero.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_image_statistics(struct sail_image_statistics **statistics);
+
+/*
+ * Destroys the specified image statistics.
+ * Does nothing if the statistics is NULL.
+ */
+SAIL_EXPORT void sail_destroy_image_statistics(struct sail_image_statistics *statistics);
+
+/*
+ * Makes a deep copy of the specified image statistics.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_copy_image_statistics(const struct sail_image_statistics *source, struct sail_image_statistics **target);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
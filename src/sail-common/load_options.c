@@ -36,8 +36,20 @@ sail_status_t sail_alloc_load_options(struct sail_load_options **load_options) {
     SAIL_TRY(sail_malloc(sizeof(struct sail_load_options), &ptr));
     *load_options = ptr;
 
-    (*load_options)->options = 0;
-    (*load_options)->tuning  = NULL;
+    (*load_options)->options             = 0;
+    (*load_options)->tuning              = NULL;
+    (*load_options)->roi_x               = 0;
+    (*load_options)->roi_y               = 0;
+    (*load_options)->roi_width           = 0;
+    (*load_options)->roi_height          = 0;
+    (*load_options)->cancel_token        = NULL;
+    (*load_options)->max_width           = 0;
+    (*load_options)->max_height          = 0;
+    (*load_options)->max_pixels          = 0;
+    (*load_options)->max_memory          = 0;
+    (*load_options)->max_frames          = 0;
+    (*load_options)->max_meta_data_size  = 0;
+    (*load_options)->output_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
 
     return SAIL_OK;
 }
@@ -86,7 +98,19 @@ sail_status_t sail_copy_load_options(const struct sail_load_options *source, str
     struct sail_load_options *target_local;
     SAIL_TRY(sail_alloc_load_options(&target_local));
 
-    target_local->options = source->options;
+    target_local->options             = source->options;
+    target_local->roi_x               = source->roi_x;
+    target_local->roi_y               = source->roi_y;
+    target_local->roi_width           = source->roi_width;
+    target_local->roi_height          = source->roi_height;
+    target_local->cancel_token        = source->cancel_token;
+    target_local->max_width           = source->max_width;
+    target_local->max_height          = source->max_height;
+    target_local->max_pixels          = source->max_pixels;
+    target_local->max_memory          = source->max_memory;
+    target_local->max_frames          = source->max_frames;
+    target_local->max_meta_data_size  = source->max_meta_data_size;
+    target_local->output_pixel_format = source->output_pixel_format;
 
     if (source->tuning != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_hash_map(source->tuning, &target_local->tuning),
@@ -97,3 +121,73 @@ sail_status_t sail_copy_load_options(const struct sail_load_options *source, str
 
     return SAIL_OK;
 }
+
+sail_status_t sail_intersect_roi(const struct sail_load_options *load_options,
+                                    unsigned frame_width, unsigned frame_height,
+                                    unsigned *x, unsigned *y, unsigned *width, unsigned *height) {
+
+    SAIL_CHECK_PTR(x);
+    SAIL_CHECK_PTR(y);
+    SAIL_CHECK_PTR(width);
+    SAIL_CHECK_PTR(height);
+
+    if (load_options == NULL || load_options->roi_width == 0 || load_options->roi_height == 0) {
+        *x      = 0;
+        *y      = 0;
+        *width  = frame_width;
+        *height = frame_height;
+
+        return SAIL_OK;
+    }
+
+    if (load_options->roi_x >= frame_width || load_options->roi_y >= frame_height) {
+        SAIL_LOG_ERROR("Region of interest %ux%u+%u+%u lies outside of the %ux%u frame",
+                        load_options->roi_width, load_options->roi_height, load_options->roi_x, load_options->roi_y,
+                        frame_width, frame_height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    *x      = load_options->roi_x;
+    *y      = load_options->roi_y;
+    *width  = SAIL_MIN(load_options->roi_width,  frame_width  - load_options->roi_x);
+    *height = SAIL_MIN(load_options->roi_height, frame_height - load_options->roi_y);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_check_dimensions_limit(const struct sail_load_options *load_options, unsigned width, unsigned height) {
+
+    if (load_options == NULL) {
+        return SAIL_OK;
+    }
+
+    if ((load_options->max_width > 0 && width > load_options->max_width) ||
+            (load_options->max_height > 0 && height > load_options->max_height)) {
+        SAIL_LOG_ERROR("Frame dimensions %ux%u exceed the limit of %ux%u", width, height,
+                        load_options->max_width, load_options->max_height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    if (load_options->max_pixels > 0 && (uint64_t)width * height > load_options->max_pixels) {
+        SAIL_LOG_ERROR("Frame dimensions %ux%u exceed the limit of %llu pixels", width, height,
+                        (unsigned long long)load_options->max_pixels);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_check_memory_limit(const struct sail_load_options *load_options, uint64_t size) {
+
+    if (load_options == NULL || load_options->max_memory == 0) {
+        return SAIL_OK;
+    }
+
+    if (size > load_options->max_memory) {
+        SAIL_LOG_ERROR("Allocation of %llu bytes exceeds the limit of %llu bytes",
+                        (unsigned long long)size, (unsigned long long)load_options->max_memory);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    return SAIL_OK;
+}
@@ -26,6 +26,10 @@
 #ifndef SAIL_LOAD_OPTIONS_H
 #define SAIL_LOAD_OPTIONS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
@@ -33,6 +37,7 @@
 extern "C" {
 #endif
 
+struct sail_cancel_token;
 struct sail_hash_map;
 struct sail_load_features;
 
@@ -59,6 +64,57 @@ struct sail_load_options {
      * or forward compatible.
      */
     struct sail_hash_map *tuning;
+
+    /*
+     * Region of interest to load. When both roi_width and roi_height are not zero, only the part
+     * of every frame intersecting the rectangle is loaded. The rectangle is clipped to the frame size.
+     *
+     * The rectangle is in the stored frame coordinates, SAIL_OPTION_AUTO_ORIENT rotates frames afterwards.
+     *
+     * Codecs with SAIL_CODEC_FEATURE_ROI skip decoding rows (and where possible columns or tiles)
+     * outside of the rectangle. Frames of other codecs are loaded entirely and cropped afterwards.
+     */
+    unsigned roi_x;
+    unsigned roi_y;
+    unsigned roi_width;
+    unsigned roi_height;
+
+    /*
+     * Cancellation token checked while loading frames. Loading is aborted with SAIL_ERROR_CANCELED
+     * when the token is canceled or its deadline is reached. Not owned by the load options,
+     * so it's copied as a pointer. Can be NULL.
+     */
+    const struct sail_cancel_token *cancel_token;
+
+    /*
+     * Resource limits to reject decompression bombs and other malicious images before allocating
+     * memory for them. Loading fails with SAIL_ERROR_LIMIT_EXCEEDED when any limit is exceeded.
+     * Zero means no limit.
+     *
+     * max_width, max_height, and max_pixels limit the dimensions of every loaded frame.
+     * max_memory limits the size of every single allocation that depends on the image contents:
+     * frame pixels, and codec-internal buffers like animation canvases or whole-file buffers.
+     * max_frames limits the number of frames loaded with sail_load_next_frame().
+     * max_meta_data_size limits the total size of the meta data values and the ICC profile of every frame.
+     */
+    unsigned max_width;
+    unsigned max_height;
+    uint64_t max_pixels;
+    size_t max_memory;
+    unsigned max_frames;
+    size_t max_meta_data_size;
+
+    /*
+     * Pixel format of loaded frames. SAIL_PIXEL_FORMAT_UNKNOWN loads frames in the pixel format
+     * closest to the stored one, which is the default.
+     *
+     * Codecs produce the requested pixel format while decoding when the underlying library
+     * supports it. Frames of other codecs are converted with sail-manip right after loading,
+     * so loading fails with SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT when sail_can_convert() doesn't
+     * support converting the stored pixel format into the requested one. The original pixel format
+     * is still available in the source image with SAIL_OPTION_SOURCE_IMAGE.
+     */
+    enum SailPixelFormat output_pixel_format;
 };
 
 typedef struct sail_load_options sail_load_options_t;
@@ -90,6 +146,39 @@ SAIL_EXPORT sail_status_t sail_alloc_load_options_from_features(const struct sai
  */
 SAIL_EXPORT sail_status_t sail_copy_load_options(const struct sail_load_options *source, struct sail_load_options **target);
 
+/*
+ * Intersects the region of interest from the load options with a frame of the specified size.
+ * Assigns the whole frame to the output arguments if the region of interest is not set.
+ * Codecs with SAIL_CODEC_FEATURE_ROI use it to compute the region to decode.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS if the region of interest lies outside of the frame.
+ */
+SAIL_EXPORT sail_status_t sail_intersect_roi(const struct sail_load_options *load_options,
+                                                unsigned frame_width, unsigned frame_height,
+                                                unsigned *x, unsigned *y, unsigned *width, unsigned *height);
+
+/*
+ * Checks the frame dimensions against max_width, max_height, and max_pixels from the load options.
+ * Codecs that allocate buffers depending on the frame size use it to reject huge frames early.
+ * The load options can be NULL.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_LIMIT_EXCEEDED if any limit is exceeded.
+ */
+SAIL_EXPORT sail_status_t sail_check_dimensions_limit(const struct sail_load_options *load_options,
+                                                        unsigned width, unsigned height);
+
+/*
+ * Checks the size of a buffer to allocate against max_memory from the load options.
+ * Codecs use it before allocating internal buffers which size depends on the image contents.
+ * The load options can be NULL.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_LIMIT_EXCEEDED if the limit is exceeded.
+ */
+SAIL_EXPORT sail_status_t sail_check_memory_limit(const struct sail_load_options *load_options, uint64_t size);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
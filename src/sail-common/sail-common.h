@@ -30,6 +30,7 @@
 
 #include <sail-common/config.h>
 
+#include <sail-common/cancel_token.h>
 #include <sail-common/common.h>
 #include <sail-common/common_serialize.h>
 #include <sail-common/compiler_specifics.h>
@@ -38,6 +39,7 @@
 #include <sail-common/hash_map.h>
 #include <sail-common/iccp.h>
 #include <sail-common/image.h>
+#include <sail-common/image_statistics.h>
 #include <sail-common/io_common.h>
 #include <sail-common/load_features.h>
 #include <sail-common/load_options.h>
@@ -40,6 +40,7 @@ sail_status_t sail_alloc_save_options(struct sail_save_options **save_options) {
     (*save_options)->compression       = SAIL_COMPRESSION_UNKNOWN;
     (*save_options)->compression_level = 0;
     (*save_options)->tuning            = NULL;
+    (*save_options)->cancel_token      = NULL;
 
     return SAIL_OK;
 }
@@ -93,6 +94,7 @@ sail_status_t sail_copy_save_options(const struct sail_save_options *source, str
     target_local->options           = source->options;
     target_local->compression       = source->compression;
     target_local->compression_level = source->compression_level;
+    target_local->cancel_token      = source->cancel_token;
 
     if (source->tuning != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_hash_map(source->tuning, &target_local->tuning),
@@ -34,6 +34,7 @@
 extern "C" {
 #endif
 
+struct sail_cancel_token;
 struct sail_hash_map;
 struct sail_save_features;
 
@@ -67,6 +68,13 @@ struct sail_save_options {
 
     /* Codec-specific tuning options. */
     struct sail_hash_map *tuning;
+
+    /*
+     * Cancellation token checked while saving frames. Saving is aborted with SAIL_ERROR_CANCELED
+     * when the token is canceled or its deadline is reached. Not owned by the save options,
+     * so it's copied as a pointer. Can be NULL.
+     */
+    const struct sail_cancel_token *cancel_token;
 };
 
 typedef struct sail_save_options sail_save_options_t;
@@ -84,6 +84,9 @@ enum SailStatus {
     SAIL_ERROR_MISSING_PALETTE,
     SAIL_ERROR_UNSUPPORTED_FORMAT,
     SAIL_ERROR_BROKEN_IMAGE,
+    SAIL_ERROR_CANCELED,
+    SAIL_ERROR_LIMIT_EXCEEDED,
+    SAIL_ERROR_UNSUPPORTED_ICCP,
 
     /*
      * Codecs-specific errors.
@@ -336,6 +336,21 @@ unsigned sail_bits_per_pixel(enum SailPixelFormat pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP40_YUVA: return 40;
         case SAIL_PIXEL_FORMAT_BPP48_YUVA: return 48;
         case SAIL_PIXEL_FORMAT_BPP64_YUVA: return 64;
+
+        case SAIL_PIXEL_FORMAT_BPP12_YUV420P: return 12;
+        case SAIL_PIXEL_FORMAT_BPP12_NV12:    return 12;
+        case SAIL_PIXEL_FORMAT_BPP24_YUV444P: return 24;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: return 32;
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: return 64;
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:    return 48;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:   return 64;
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:   return 96;
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: return 128;
     }
 
     return 0;
@@ -411,10 +426,110 @@ bool sail_greater_bits_per_pixel(enum SailPixelFormat pixel_format1, enum SailPi
 
 unsigned sail_bytes_per_line(unsigned width, enum SailPixelFormat pixel_format) {
 
+    /* Y plane. */
+    if (sail_is_planar(pixel_format)) {
+        return width;
+    }
+
     const unsigned bits_per_pixel = sail_bits_per_pixel(pixel_format);
     return (unsigned)(((double)width * bits_per_pixel + 7) / 8);
 }
 
+size_t sail_pixels_size(unsigned height, unsigned bytes_per_line, enum SailPixelFormat pixel_format) {
+
+    void *planes[3];
+    unsigned planes_bytes_per_line[3];
+    unsigned planes_height[3];
+
+    const unsigned planes_count = sail_planes(pixel_format, NULL, height, bytes_per_line, planes, planes_bytes_per_line, planes_height);
+
+    size_t pixels_size = 0;
+
+    for (unsigned i = 0; i < planes_count; i++) {
+        pixels_size += (size_t)planes_height[i] * planes_bytes_per_line[i];
+    }
+
+    return pixels_size;
+}
+
+unsigned sail_planes(enum SailPixelFormat pixel_format, const void *pixels, unsigned height, unsigned bytes_per_line,
+                     void *planes[3], unsigned planes_bytes_per_line[3], unsigned planes_height[3]) {
+
+    unsigned planes_count;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP12_YUV420P: {
+            planes_count = 3;
+            planes_bytes_per_line[1] = planes_bytes_per_line[2] = (bytes_per_line + 1) / 2;
+            planes_height[1] = planes_height[2] = (height + 1) / 2;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP12_NV12: {
+            planes_count = 2;
+            planes_bytes_per_line[1] = (bytes_per_line + 1) / 2 * 2;
+            planes_height[1] = (height + 1) / 2;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_YUV444P: {
+            planes_count = 3;
+            planes_bytes_per_line[1] = planes_bytes_per_line[2] = bytes_per_line;
+            planes_height[1] = planes_height[2] = height;
+            break;
+        }
+        default: {
+            planes_count = 1;
+        }
+    }
+
+    planes_bytes_per_line[0] = bytes_per_line;
+    planes_height[0] = height;
+
+    unsigned char *plane = (unsigned char *)pixels;
+
+    for (unsigned i = 0; i < 3; i++) {
+        if (i < planes_count) {
+            planes[i] = plane;
+
+            if (plane != NULL) {
+                plane += (size_t)planes_height[i] * planes_bytes_per_line[i];
+            }
+        } else {
+            planes[i] = NULL;
+            planes_bytes_per_line[i] = 0;
+            planes_height[i] = 0;
+        }
+    }
+
+    return planes_count;
+}
+
+void sail_copy_scan_line_pixels(const void *source_scan, unsigned x, unsigned width,
+                                enum SailPixelFormat pixel_format, void *target_scan) {
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(pixel_format);
+
+    const unsigned char *source = source_scan;
+    unsigned char *target = target_scan;
+
+    if (bits_per_pixel % 8 == 0) {
+        memcpy(target, source + (size_t)x * bits_per_pixel / 8, (size_t)width * bits_per_pixel / 8);
+        return;
+    }
+
+    const size_t source_bit = (size_t)x * bits_per_pixel;
+    const size_t bits       = (size_t)width * bits_per_pixel;
+
+    memset(target, 0, (bits + 7) / 8);
+
+    for (size_t bit = 0; bit < bits; bit++) {
+        const size_t from = source_bit + bit;
+
+        if (source[from / 8] & (0x80 >> (from % 8))) {
+            target[bit / 8] |= (unsigned char)(0x80 >> (bit % 8));
+        }
+    }
+}
+
 bool sail_is_indexed(enum SailPixelFormat pixel_format) {
 
     switch (pixel_format) {
@@ -481,7 +596,61 @@ bool sail_is_rgb_family(enum SailPixelFormat pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP64_RGBA:
         case SAIL_PIXEL_FORMAT_BPP64_BGRA:
         case SAIL_PIXEL_FORMAT_BPP64_ARGB:
-        case SAIL_PIXEL_FORMAT_BPP64_ABGR: {
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR:
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED:
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool sail_is_premultiplied(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool sail_is_floating_point(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool sail_is_planar(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP12_YUV420P:
+        case SAIL_PIXEL_FORMAT_BPP12_NV12:
+        case SAIL_PIXEL_FORMAT_BPP24_YUV444P: {
             return true;
         }
         default: {
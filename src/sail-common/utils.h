@@ -135,9 +135,41 @@ SAIL_EXPORT bool sail_greater_bits_per_pixel(enum SailPixelFormat pixel_format1,
  *     (12 + 7 ) / 8                                 ==
  *     19 / 8                                        ==
  *     2 bytes per line
+ *
+ * For planar pixel formats, returns the number of bytes per line of the Y plane.
  */
 SAIL_EXPORT unsigned sail_bytes_per_line(unsigned width, enum SailPixelFormat pixel_format);
 
+/*
+ * Returns the number of bytes needed to hold pixels of the given height and bytes per line.
+ * For planar pixel formats, includes all the planes. For other pixel formats, returns
+ * height * bytes_per_line.
+ */
+SAIL_EXPORT size_t sail_pixels_size(unsigned height, unsigned bytes_per_line, enum SailPixelFormat pixel_format);
+
+/*
+ * Splits the pixels of the given height and bytes per line into planes. Saves the plane
+ * addresses, bytes per line, and heights into the arrays. Unused array elements are set to NULL
+ * and 0. Pixels may be NULL to calculate only the plane sizes.
+ *
+ * Chroma planes of the 4:2:0 pixel formats have (height + 1) / 2 scan lines. U and V planes
+ * of BPP12-YUV420P have (bytes_per_line + 1) / 2 bytes per line, and the UV plane of BPP12-NV12
+ * has this value multiplied by 2.
+ *
+ * Returns the number of planes: 3 for BPP12-YUV420P and BPP24-YUV444P, 2 for BPP12-NV12,
+ * and 1 for other pixel formats.
+ */
+SAIL_EXPORT unsigned sail_planes(enum SailPixelFormat pixel_format, const void *pixels, unsigned height, unsigned bytes_per_line,
+                                 void *planes[3], unsigned planes_bytes_per_line[3], unsigned planes_height[3]);
+
+/*
+ * Copies the specified number of pixels starting from the pixel x of the source scan line
+ * to the beginning of the target scan line. Handles sub-byte pixels packed starting
+ * from the most significant bit. Used to crop scan lines to regions of interest.
+ */
+SAIL_EXPORT void sail_copy_scan_line_pixels(const void *source_scan, unsigned x, unsigned width,
+                                            enum SailPixelFormat pixel_format, void *target_scan);
+
 /*
  * Returns true if the given pixel format is indexed and assumes having a palette.
  */
@@ -153,6 +185,21 @@ SAIL_EXPORT bool sail_is_grayscale(enum SailPixelFormat pixel_format);
  */
 SAIL_EXPORT bool sail_is_rgb_family(enum SailPixelFormat pixel_format);
 
+/*
+ * Returns true if the color channels of the given pixel format are premultiplied by alpha.
+ */
+SAIL_EXPORT bool sail_is_premultiplied(enum SailPixelFormat pixel_format);
+
+/*
+ * Returns true if the channels of the given pixel format are half-float or float values.
+ */
+SAIL_EXPORT bool sail_is_floating_point(enum SailPixelFormat pixel_format);
+
+/*
+ * Returns true if the given pixel format stores Y and chroma components in separate planes.
+ */
+SAIL_EXPORT bool sail_is_planar(enum SailPixelFormat pixel_format);
+
 /*
  * Prints the recent errno value with SAIL_LOG_ERROR(). The specified format must include '%s'.
  */
@@ -0,0 +1,296 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#ifdef SAIL_HAVE_NEON
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+static void premultiply8_c(const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input = input;
+    uint8_t *scan_output = output;
+
+    for (unsigned column = 0; column < width; column++, scan_input += 4, scan_output += 4) {
+        const unsigned alpha = scan_input[3];
+
+        scan_output[0] = premultiply_uint8(scan_input[0], alpha);
+        scan_output[1] = premultiply_uint8(scan_input[1], alpha);
+        scan_output[2] = premultiply_uint8(scan_input[2], alpha);
+        scan_output[3] = (uint8_t)alpha;
+    }
+}
+
+static void premultiply16_c(const void *input, void *output, unsigned width) {
+
+    const uint16_t *scan_input = input;
+    uint16_t *scan_output = output;
+
+    for (unsigned column = 0; column < width; column++, scan_input += 4, scan_output += 4) {
+        const unsigned alpha = scan_input[3];
+
+        scan_output[0] = premultiply_uint16(scan_input[0], alpha);
+        scan_output[1] = premultiply_uint16(scan_input[1], alpha);
+        scan_output[2] = premultiply_uint16(scan_input[2], alpha);
+        scan_output[3] = (uint16_t)alpha;
+    }
+}
+
+static void unpremultiply8_c(const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input = input;
+    uint8_t *scan_output = output;
+
+    for (unsigned column = 0; column < width; column++, scan_input += 4, scan_output += 4) {
+        const unsigned alpha = scan_input[3];
+
+        scan_output[0] = unpremultiply_uint8(scan_input[0], alpha);
+        scan_output[1] = unpremultiply_uint8(scan_input[1], alpha);
+        scan_output[2] = unpremultiply_uint8(scan_input[2], alpha);
+        scan_output[3] = (uint8_t)alpha;
+    }
+}
+
+static void unpremultiply16_c(const void *input, void *output, unsigned width) {
+
+    const uint16_t *scan_input = input;
+    uint16_t *scan_output = output;
+
+    for (unsigned column = 0; column < width; column++, scan_input += 4, scan_output += 4) {
+        const unsigned alpha = scan_input[3];
+
+        scan_output[0] = unpremultiply_uint16(scan_input[0], alpha);
+        scan_output[1] = unpremultiply_uint16(scan_input[1], alpha);
+        scan_output[2] = unpremultiply_uint16(scan_input[2], alpha);
+        scan_output[3] = (uint16_t)alpha;
+    }
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+/*
+ * Multiplies two pixels widened to 16-bit channels by their alphas and divides the products
+ * by 255 like div255_round() does. The alpha channel is multiplied by 255, so it's kept.
+ */
+SAIL_TARGET("ssse3")
+static inline __m128i premultiply_two_pixels_ssse3(__m128i pixels, __m128i alphas) {
+
+    const __m128i products = _mm_add_epi16(_mm_mullo_epi16(pixels, alphas), _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(products, _mm_srli_epi16(products, 8)), 8);
+}
+
+/* Premultiplies 4-pixel blocks starting from the first pixel. Returns the first unprocessed pixel. */
+SAIL_TARGET("ssse3")
+static unsigned premultiply8_blocks_ssse3(const uint8_t *input, uint8_t *output, unsigned first, unsigned width) {
+
+    const __m128i zero = _mm_setzero_si128();
+
+    /* Alphas of the lower and higher pixel pairs spread to 16-bit color channels, 255 in alpha channels. */
+    const __m128i lo_shuffle = _mm_setr_epi8(3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1);
+    const __m128i hi_shuffle = _mm_setr_epi8(11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1);
+    const __m128i alpha_fill = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+
+    unsigned column = first;
+
+    for (; width - column >= 4; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(input + column * 4));
+
+        const __m128i lo_alphas = _mm_or_si128(_mm_shuffle_epi8(pixels, lo_shuffle), alpha_fill);
+        const __m128i hi_alphas = _mm_or_si128(_mm_shuffle_epi8(pixels, hi_shuffle), alpha_fill);
+
+        const __m128i lo = premultiply_two_pixels_ssse3(_mm_unpacklo_epi8(pixels, zero), lo_alphas);
+        const __m128i hi = premultiply_two_pixels_ssse3(_mm_unpackhi_epi8(pixels, zero), hi_alphas);
+
+        _mm_storeu_si128((__m128i *)(output + column * 4), _mm_packus_epi16(lo, hi));
+    }
+
+    return column;
+}
+
+SAIL_TARGET("ssse3")
+static void premultiply8_ssse3(const void *input, void *output, unsigned width) {
+
+    const unsigned column = premultiply8_blocks_ssse3(input, output, 0, width);
+
+    premultiply8_c((const uint8_t *)input + column * 4, (uint8_t *)output + column * 4, width - column);
+}
+
+/* Same as premultiply8_ssse3() with 8-pixel blocks. Shuffling, unpacking, and packing within 128-bit lanes keep the pixel order. */
+SAIL_TARGET("avx2")
+static void premultiply8_avx2(const void *input, void *output, unsigned width) {
+
+    const uint8_t *input8 = input;
+    uint8_t *output8 = output;
+
+    const __m256i zero       = _mm256_setzero_si256();
+    const __m256i rounding   = _mm256_set1_epi16(128);
+    const __m256i lo_shuffle = _mm256_setr_epi8(3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1,
+                                                3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1);
+    const __m256i hi_shuffle = _mm256_setr_epi8(11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1,
+                                                11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1);
+    const __m256i alpha_fill = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+
+    unsigned column = 0;
+
+    for (; width - column >= 8; column += 8) {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i *)(input8 + column * 4));
+
+        const __m256i lo_alphas = _mm256_or_si256(_mm256_shuffle_epi8(pixels, lo_shuffle), alpha_fill);
+        const __m256i hi_alphas = _mm256_or_si256(_mm256_shuffle_epi8(pixels, hi_shuffle), alpha_fill);
+
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), lo_alphas), rounding);
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), hi_alphas), rounding);
+
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        _mm256_storeu_si256((__m256i *)(output8 + column * 4), _mm256_packus_epi16(lo, hi));
+    }
+
+    column = premultiply8_blocks_ssse3(input8, output8, column, width);
+
+    premultiply8_c(input8 + column * 4, output8 + column * 4, width - column);
+}
+
+/*
+ * Divides a pixel converted to floats by its alpha. The division is exact, so adding 0.5
+ * and truncating rounds exactly like unpremultiply_uint8() does. Zero alpha produces
+ * infinities and NaNs that are converted into the minimal integers and packed into zeros.
+ * Color channels greater than alpha are packed into 255 with saturation.
+ */
+SAIL_TARGET("ssse3")
+static inline __m128i unpremultiply_pixel_ssse3(__m128i pixel) {
+
+    const __m128 values = _mm_cvtepi32_ps(pixel);
+    const __m128 alphas = _mm_shuffle_ps(values, values, _MM_SHUFFLE(3, 3, 3, 3));
+
+    const __m128 quotients = _mm_div_ps(_mm_mul_ps(values, _mm_set1_ps(255.0f)), alphas);
+
+    return _mm_cvttps_epi32(_mm_add_ps(quotients, _mm_set1_ps(0.5f)));
+}
+
+SAIL_TARGET("ssse3")
+static void unpremultiply8_ssse3(const void *input, void *output, unsigned width) {
+
+    const uint8_t *input8 = input;
+    uint8_t *output8 = output;
+
+    const __m128i zero       = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000);
+
+    unsigned column = 0;
+
+    for (; width - column >= 4; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(input8 + column * 4));
+
+        const __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+        const __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+
+        const __m128i pixel0 = unpremultiply_pixel_ssse3(_mm_unpacklo_epi16(lo, zero));
+        const __m128i pixel1 = unpremultiply_pixel_ssse3(_mm_unpackhi_epi16(lo, zero));
+        const __m128i pixel2 = unpremultiply_pixel_ssse3(_mm_unpacklo_epi16(hi, zero));
+        const __m128i pixel3 = unpremultiply_pixel_ssse3(_mm_unpackhi_epi16(hi, zero));
+
+        const __m128i colors = _mm_packus_epi16(_mm_packs_epi32(pixel0, pixel1), _mm_packs_epi32(pixel2, pixel3));
+
+        /* Keep the input alpha. */
+        const __m128i result = _mm_or_si128(_mm_andnot_si128(alpha_mask, colors), _mm_and_si128(alpha_mask, pixels));
+
+        _mm_storeu_si128((__m128i *)(output8 + column * 4), result);
+    }
+
+    unpremultiply8_c(input8 + column * 4, output8 + column * 4, width - column);
+}
+#endif
+
+#ifdef SAIL_HAVE_NEON
+/* vraddhn_u16(x, (x + 128) >> 8) computes div255_round(x). */
+static inline uint8x8_t premultiply_neon(uint8x8_t values, uint8x8_t alphas) {
+
+    const uint16x8_t products = vmull_u8(values, alphas);
+
+    return vraddhn_u16(products, vrshrq_n_u16(products, 8));
+}
+
+static void premultiply8_neon(const void *input, void *output, unsigned width) {
+
+    const uint8_t *input8 = input;
+    uint8_t *output8 = output;
+
+    unsigned column = 0;
+
+    for (; width - column >= 8; column += 8) {
+        uint8x8x4_t pixels = vld4_u8(input8 + column * 4);
+
+        pixels.val[0] = premultiply_neon(pixels.val[0], pixels.val[3]);
+        pixels.val[1] = premultiply_neon(pixels.val[1], pixels.val[3]);
+        pixels.val[2] = premultiply_neon(pixels.val[2], pixels.val[3]);
+
+        vst4_u8(output8 + column * 4, pixels);
+    }
+
+    premultiply8_c(input8 + column * 4, output8 + column * 4, width - column);
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+void alpha_kernels_init(unsigned bytes_per_channel, struct alpha_kernels *kernels) {
+
+    if (bytes_per_channel == 2) {
+        kernels->premultiply   = premultiply16_c;
+        kernels->unpremultiply = unpremultiply16_c;
+        return;
+    }
+
+    kernels->premultiply   = premultiply8_c;
+    kernels->unpremultiply = unpremultiply8_c;
+
+#if defined SAIL_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        kernels->premultiply   = premultiply8_avx2;
+        kernels->unpremultiply = unpremultiply8_ssse3;
+    } else if (cpu_has_ssse3()) {
+        kernels->premultiply   = premultiply8_ssse3;
+        kernels->unpremultiply = unpremultiply8_ssse3;
+    }
+#elif defined SAIL_HAVE_NEON
+    kernels->premultiply = premultiply8_neon;
+#endif
+}
@@ -0,0 +1,55 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ALPHA_KERNELS_H
+#define SAIL_ALPHA_KERNELS_H
+
+#include <sail-common/export.h>
+
+/*
+ * Inner loops of conversions between straight and premultiplied alpha. Scan lines consist
+ * of 4-channel pixels with alpha in the last channel, so RGBA and BGRA share the kernels.
+ * Input and output may point to the same memory.
+ *
+ * Premultiplied color channels are rounded. Unpremultiplied color channels are rounded too,
+ * color channels greater than alpha become the maximum value, and zero alpha makes all
+ * the color channels zero.
+ *
+ * 8-bit channels are premultiplied with AVX2, SSSE3, or NEON, and unpremultiplied with SSSE3
+ * depending on the CPU. Plain C is used otherwise. All the implementations produce identical
+ * results.
+ */
+struct alpha_kernels {
+
+    void (*premultiply)(const void *input, void *output, unsigned width);
+    void (*unpremultiply)(const void *input, void *output, unsigned width);
+};
+
+/*
+ * Selects the fastest kernels for 1 or 2 bytes per channel supported by the CPU.
+ */
+SAIL_HIDDEN void alpha_kernels_init(unsigned bytes_per_channel, struct alpha_kernels *kernels);
+
+#endif
@@ -0,0 +1,789 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* Linear light is quantized into this number of steps before mapping it into output values. */
+#define OUTPUT_LUT_SIZE 65536
+
+/*
+ * Matrices closer to the identity matrix are not applied, so profiles with the same colorants use
+ * a single lookup table. The tolerance is a fraction of an output value step divided by the sRGB
+ * slope near black.
+ */
+static const double IDENTITY_MATRIX_TOLERANCE = 0.5 / (3 * 12.92);
+
+/* The number of transforms kept by sail_transform_image_colors(). */
+#define CACHE_SIZE 8
+
+struct sail_color_transform {
+
+    enum SailPixelFormat pixel_format;
+
+    unsigned channels;
+    unsigned bytes_per_channel;
+
+    /* Positions of the red, green, and blue channels in pixels. Grayscale pixels have the first one only. */
+    unsigned color_channels;
+    unsigned offsets[3];
+
+    /* Every value is mapped to itself, so there is nothing to do. */
+    bool identity;
+
+    bool use_matrix;
+    float matrix[3][3];
+
+    /*
+     * Without the matrix, input values are mapped straight into output values with 256 uint8_t
+     * or 65536 uint16_t entries. With the matrix, input values are mapped into linear float values,
+     * and linear values quantized into OUTPUT_LUT_SIZE steps are mapped into output values.
+     * Channels with the same curves share tables.
+     */
+    void *direct_luts[3];
+    void *linear_luts[3];
+    void *output_luts[3];
+
+    /* The number of cache entries and callers using the transform. Guarded by the cache lock. */
+    unsigned cache_references;
+};
+
+static bool transform_layout(enum SailPixelFormat pixel_format, struct sail_color_transform *transform) {
+
+    unsigned bytes_per_channel;
+    unsigned channels;
+    unsigned r, g, b;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:        { channels = 1; bytes_per_channel = 1; r = g = b = 0; break; }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:       { channels = 1; bytes_per_channel = 2; r = g = b = 0; break; }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: { channels = 2; bytes_per_channel = 1; r = g = b = 0; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: { channels = 2; bytes_per_channel = 2; r = g = b = 0; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: { channels = 3; bytes_per_channel = 1; r = 0; g = 1; b = 2; break; }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: { channels = 3; bytes_per_channel = 1; r = 2; g = 1; b = 0; break; }
+        case SAIL_PIXEL_FORMAT_BPP48_RGB: { channels = 3; bytes_per_channel = 2; r = 0; g = 1; b = 2; break; }
+        case SAIL_PIXEL_FORMAT_BPP48_BGR: { channels = 3; bytes_per_channel = 2; r = 2; g = 1; b = 0; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { channels = 4; bytes_per_channel = 1; r = 0; g = 1; b = 2; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: { channels = 4; bytes_per_channel = 1; r = 2; g = 1; b = 0; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: { channels = 4; bytes_per_channel = 1; r = 1; g = 2; b = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: { channels = 4; bytes_per_channel = 1; r = 3; g = 2; b = 1; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: { channels = 4; bytes_per_channel = 2; r = 0; g = 1; b = 2; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: { channels = 4; bytes_per_channel = 2; r = 2; g = 1; b = 0; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: { channels = 4; bytes_per_channel = 2; r = 1; g = 2; b = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: { channels = 4; bytes_per_channel = 2; r = 3; g = 2; b = 1; break; }
+
+        default: {
+            return false;
+        }
+    }
+
+    if (transform != NULL) {
+        transform->pixel_format      = pixel_format;
+        transform->channels          = channels;
+        transform->bytes_per_channel = bytes_per_channel;
+        transform->color_channels    = (channels < 3) ? 1 : 3;
+        transform->offsets[0]        = r;
+        transform->offsets[1]        = g;
+        transform->offsets[2]        = b;
+    }
+
+    return true;
+}
+
+static sail_status_t load_profile(const struct sail_iccp *iccp, struct icc_profile *profile) {
+
+    if (iccp == NULL) {
+        icc_srgb_profile(profile);
+    } else {
+        SAIL_TRY(icc_parse_profile(iccp->data, iccp->size, profile));
+    }
+
+    return SAIL_OK;
+}
+
+/* Frees tables shared between channels once. */
+static void destroy_luts(void *luts[3]) {
+
+    for (unsigned channel = 0; channel < 3; channel++) {
+        bool shared = false;
+
+        for (unsigned previous = 0; previous < channel; previous++) {
+            shared = shared || luts[previous] == luts[channel];
+        }
+
+        if (!shared) {
+            sail_free(luts[channel]);
+        }
+    }
+
+    luts[0] = luts[1] = luts[2] = NULL;
+}
+
+static inline unsigned quantize_linear(float value) {
+
+    value = (value < 0) ? 0 : (value > 1) ? 1 : value;
+
+    return (unsigned)(value * (OUTPUT_LUT_SIZE - 1) + 0.5f);
+}
+
+/* Curves are inverted by searching this number of samples. */
+#define CURVE_SAMPLES 65536
+
+static sail_status_t sample_curve(const struct icc_curve *curve, double **samples) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(CURVE_SAMPLES * sizeof(double), &ptr));
+    *samples = ptr;
+
+    for (unsigned i = 0; i < CURVE_SAMPLES; i++) {
+        (*samples)[i] = icc_evaluate_curve(curve, i / (double)(CURVE_SAMPLES - 1));
+    }
+
+    return SAIL_OK;
+}
+
+/* Returns the device value in [0; 1] that the sampled curve maps into the linear value. Curves are expected to grow. */
+static double invert_curve(const double *samples, double linear) {
+
+    if (linear <= samples[0]) {
+        return 0;
+    }
+    if (linear > samples[CURVE_SAMPLES - 1]) {
+        return 1;
+    }
+
+    /* samples[low] < linear <= samples[high] */
+    unsigned low = 0;
+    unsigned high = CURVE_SAMPLES - 1;
+
+    while (high - low > 1) {
+        const unsigned middle = (low + high) / 2;
+
+        if (samples[middle] < linear) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    return (low + (linear - samples[low]) / (samples[high] - samples[low])) / (CURVE_SAMPLES - 1);
+}
+
+static inline void store_value(void *lut, unsigned bytes_per_channel, unsigned index, double value) {
+
+    if (bytes_per_channel == 1) {
+        ((uint8_t *)lut)[index] = (uint8_t)(value * 255 + 0.5);
+    } else {
+        ((uint16_t *)lut)[index] = (uint16_t)(value * 65535 + 0.5);
+    }
+}
+
+/* Maps linear values quantized into OUTPUT_LUT_SIZE steps into output values. */
+static sail_status_t build_output_lut(const struct icc_curve *curve, unsigned bytes_per_channel, void **lut) {
+
+    double *samples;
+    SAIL_TRY(sample_curve(curve, &samples));
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)OUTPUT_LUT_SIZE * bytes_per_channel, lut),
+                        /* cleanup */ sail_free(samples));
+
+    for (unsigned i = 0; i < OUTPUT_LUT_SIZE; i++) {
+        store_value(*lut, bytes_per_channel, i, invert_curve(samples, i / (double)(OUTPUT_LUT_SIZE - 1)));
+    }
+
+    sail_free(samples);
+
+    return SAIL_OK;
+}
+
+static sail_status_t build_linear_lut(const struct icc_curve *curve, unsigned bytes_per_channel, void **lut) {
+
+    const unsigned entries = (bytes_per_channel == 1) ? 256 : 65536;
+
+    SAIL_TRY(sail_malloc(entries * sizeof(float), lut));
+    float *linear = *lut;
+
+    for (unsigned i = 0; i < entries; i++) {
+        linear[i] = (float)icc_evaluate_curve(curve, i / (double)(entries - 1));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t build_direct_lut(const struct icc_curve *source_curve, const struct icc_curve *target_curve,
+                                        unsigned bytes_per_channel, void **lut) {
+
+    double *samples;
+    SAIL_TRY(sample_curve(target_curve, &samples));
+
+    const unsigned entries = (bytes_per_channel == 1) ? 256 : 65536;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)entries * bytes_per_channel, lut),
+                        /* cleanup */ sail_free(samples));
+
+    /* Linear values are not quantized here. */
+    for (unsigned i = 0; i < entries; i++) {
+        const double linear = icc_evaluate_curve(source_curve, i / (double)(entries - 1));
+
+        store_value(*lut, bytes_per_channel, i, invert_curve(samples, linear));
+    }
+
+    sail_free(samples);
+
+    return SAIL_OK;
+}
+
+static bool invert_matrix(const double matrix[3][3], double inverse[3][3]) {
+
+    const double determinant = matrix[0][0] * (matrix[1][1] * matrix[2][2] - matrix[1][2] * matrix[2][1])
+                                - matrix[0][1] * (matrix[1][0] * matrix[2][2] - matrix[1][2] * matrix[2][0])
+                                + matrix[0][2] * (matrix[1][0] * matrix[2][1] - matrix[1][1] * matrix[2][0]);
+
+    if (fabs(determinant) < 1e-9) {
+        return false;
+    }
+
+    for (unsigned row = 0; row < 3; row++) {
+        for (unsigned column = 0; column < 3; column++) {
+            /* Cofactors of the transposed matrix. */
+            const unsigned r1 = (column + 1) % 3, r2 = (column + 2) % 3;
+            const unsigned c1 = (row + 1) % 3,    c2 = (row + 2) % 3;
+
+            inverse[row][column] = (matrix[r1][c1] * matrix[r2][c2] - matrix[r1][c2] * matrix[r2][c1]) / determinant;
+        }
+    }
+
+    return true;
+}
+
+/* Computes the matrix from the source linear RGB into the target linear RGB, and checks if it can be skipped. */
+static sail_status_t combine_matrices(const struct icc_profile *source_profile, const struct icc_profile *target_profile,
+                                        unsigned bytes_per_channel, float matrix[3][3], bool *identity) {
+
+    double target_inverse[3][3];
+
+    if (!invert_matrix(target_profile->matrix, target_inverse)) {
+        SAIL_LOG_ERROR("ICC: Target profile colorants are degenerate");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    const double tolerance = IDENTITY_MATRIX_TOLERANCE / ((bytes_per_channel == 1) ? 255 : 65535);
+
+    *identity = true;
+
+    for (unsigned row = 0; row < 3; row++) {
+        for (unsigned column = 0; column < 3; column++) {
+            double value = 0;
+
+            for (unsigned i = 0; i < 3; i++) {
+                value += target_inverse[row][i] * source_profile->matrix[i][column];
+            }
+
+            matrix[row][column] = (float)value;
+            *identity = *identity && fabs(value - (row == column ? 1 : 0)) < tolerance;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+/* Returns the index of the previous channel with the same curves, or the channel itself. */
+static unsigned find_shared_channel(const struct icc_profile *source_profile, const struct icc_profile *target_profile,
+                                    unsigned channel) {
+
+    for (unsigned previous = 0; previous < channel; previous++) {
+        if ((source_profile == NULL || icc_curves_equal(&source_profile->curves[previous], &source_profile->curves[channel]))
+                && (target_profile == NULL || icc_curves_equal(&target_profile->curves[previous], &target_profile->curves[channel]))) {
+            return previous;
+        }
+    }
+
+    return channel;
+}
+
+static bool is_identity_lut(const void *lut, unsigned bytes_per_channel) {
+
+    if (bytes_per_channel == 1) {
+        for (unsigned i = 0; i < 256; i++) {
+            if (((const uint8_t *)lut)[i] != i) {
+                return false;
+            }
+        }
+    } else {
+        for (unsigned i = 0; i < 65536; i++) {
+            if (((const uint16_t *)lut)[i] != i) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static sail_status_t build_luts(const struct icc_profile *source_profile, const struct icc_profile *target_profile,
+                                struct sail_color_transform *transform) {
+
+    const unsigned bytes_per_channel = transform->bytes_per_channel;
+
+    if (transform->color_channels == 1) {
+        /* Grayscale values are achromatic, so only the curves matter. */
+        SAIL_TRY(build_direct_lut(&source_profile->curves[0], &target_profile->curves[1], bytes_per_channel,
+                                    &transform->direct_luts[0]));
+        transform->direct_luts[1] = transform->direct_luts[0];
+        transform->direct_luts[2] = transform->direct_luts[0];
+
+        transform->identity = is_identity_lut(transform->direct_luts[0], bytes_per_channel);
+
+        return SAIL_OK;
+    }
+
+    /*
+     * RGB pixels with a grayscale profile come from converted grayscale frames. They are achromatic
+     * as well, so the gray curve is applied to every channel.
+     */
+    bool identity_matrix = true;
+
+    if (source_profile->color_space != ICC_COLOR_SPACE_GRAY) {
+        SAIL_TRY(combine_matrices(source_profile, target_profile, bytes_per_channel, transform->matrix, &identity_matrix));
+    }
+
+    transform->use_matrix = !identity_matrix;
+
+    if (transform->use_matrix) {
+        for (unsigned channel = 0; channel < 3; channel++) {
+            const unsigned shared_linear = find_shared_channel(source_profile, NULL, channel);
+            const unsigned shared_output = find_shared_channel(NULL, target_profile, channel);
+
+            if (shared_linear == channel) {
+                SAIL_TRY(build_linear_lut(&source_profile->curves[channel], bytes_per_channel, &transform->linear_luts[channel]));
+            } else {
+                transform->linear_luts[channel] = transform->linear_luts[shared_linear];
+            }
+
+            if (shared_output == channel) {
+                SAIL_TRY(build_output_lut(&target_profile->curves[channel], bytes_per_channel, &transform->output_luts[channel]));
+            } else {
+                transform->output_luts[channel] = transform->output_luts[shared_output];
+            }
+        }
+    } else {
+        transform->identity = true;
+
+        for (unsigned channel = 0; channel < 3; channel++) {
+            const unsigned shared = find_shared_channel(source_profile, target_profile, channel);
+
+            if (shared == channel) {
+                SAIL_TRY(build_direct_lut(&source_profile->curves[channel], &target_profile->curves[channel], bytes_per_channel,
+                                            &transform->direct_luts[channel]));
+                transform->identity = transform->identity && is_identity_lut(transform->direct_luts[channel], bytes_per_channel);
+            } else {
+                transform->direct_luts[channel] = transform->direct_luts[shared];
+            }
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static void direct_row8(const struct sail_color_transform *transform, uint8_t *scan, unsigned width) {
+
+    for (unsigned channel = 0; channel < transform->color_channels; channel++) {
+        const uint8_t *lut = transform->direct_luts[channel];
+        uint8_t *value = scan + transform->offsets[channel];
+
+        for (unsigned x = 0; x < width; x++, value += transform->channels) {
+            *value = lut[*value];
+        }
+    }
+}
+
+static void direct_row16(const struct sail_color_transform *transform, uint16_t *scan, unsigned width) {
+
+    for (unsigned channel = 0; channel < transform->color_channels; channel++) {
+        const uint16_t *lut = transform->direct_luts[channel];
+        uint16_t *value = scan + transform->offsets[channel];
+
+        for (unsigned x = 0; x < width; x++, value += transform->channels) {
+            *value = lut[*value];
+        }
+    }
+}
+
+#define MATRIX_ROW(type)                                                                                                  \
+    const float (*m)[3] = transform->matrix;                                                                              \
+    const float *linear_r = transform->linear_luts[0];                                                                    \
+    const float *linear_g = transform->linear_luts[1];                                                                    \
+    const float *linear_b = transform->linear_luts[2];                                                                    \
+    const type *output_r = transform->output_luts[0];                                                                     \
+    const type *output_g = transform->output_luts[1];                                                                     \
+    const type *output_b = transform->output_luts[2];                                                                     \
+    const unsigned offset_r = transform->offsets[0];                                                                      \
+    const unsigned offset_g = transform->offsets[1];                                                                      \
+    const unsigned offset_b = transform->offsets[2];                                                                      \
+                                                                                                                          \
+    for (unsigned x = 0; x < width; x++, scan += transform->channels) {                                                   \
+        const float r = linear_r[scan[offset_r]];                                                                         \
+        const float g = linear_g[scan[offset_g]];                                                                         \
+        const float b = linear_b[scan[offset_b]];                                                                         \
+                                                                                                                          \
+        scan[offset_r] = output_r[quantize_linear(m[0][0] * r + m[0][1] * g + m[0][2] * b)];                              \
+        scan[offset_g] = output_g[quantize_linear(m[1][0] * r + m[1][1] * g + m[1][2] * b)];                              \
+        scan[offset_b] = output_b[quantize_linear(m[2][0] * r + m[2][1] * g + m[2][2] * b)];                              \
+    }
+
+static void matrix_row8(const struct sail_color_transform *transform, uint8_t *scan, unsigned width) {
+
+    MATRIX_ROW(uint8_t)
+}
+
+static void matrix_row16(const struct sail_color_transform *transform, uint16_t *scan, unsigned width) {
+
+    MATRIX_ROW(uint16_t)
+}
+
+#undef MATRIX_ROW
+
+struct transform_job {
+
+    const struct sail_color_transform *transform;
+    struct sail_image *image;
+};
+
+static sail_status_t transform_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct transform_job *job = context;
+    const struct sail_color_transform *transform = job->transform;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        uint8_t *scan = (uint8_t *)job->image->pixels + (size_t)row * job->image->bytes_per_line;
+
+        if (transform->bytes_per_channel == 1) {
+            if (transform->use_matrix) {
+                matrix_row8(transform, scan, job->image->width);
+            } else {
+                direct_row8(transform, scan, job->image->width);
+            }
+        } else {
+            if (transform->use_matrix) {
+                matrix_row16(transform, (uint16_t *)scan, job->image->width);
+            } else {
+                direct_row16(transform, (uint16_t *)scan, job->image->width);
+            }
+        }
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Cache of transforms used by sail_transform_image_colors(). Profiles are identified by their
+ * sizes and hashes. Least recently used transforms are evicted first.
+ */
+struct cache_entry {
+
+    uint64_t source_hash;
+    size_t source_size;
+    uint64_t target_hash;
+    size_t target_size;
+    enum SailPixelFormat pixel_format;
+
+    /* Larger values are used more recently. */
+    uint64_t last_use;
+
+    /* NULL for empty entries. */
+    struct sail_color_transform *transform;
+};
+
+/* Everything below is guarded by cache_lock. */
+static manip_lock_t cache_lock = MANIP_LOCK_INITIALIZER;
+
+static struct cache_entry cache[CACHE_SIZE];
+static uint64_t cache_clock = 0;
+
+/* FNV-1a. NULL profiles, i.e. sRGB, get zero size. */
+static void hash_iccp(const struct sail_iccp *iccp, uint64_t *hash, size_t *size) {
+
+    *hash = 14695981039346656037ULL;
+    *size = 0;
+
+    if (iccp == NULL || iccp->data == NULL) {
+        return;
+    }
+
+    const uint8_t *data = iccp->data;
+
+    for (size_t i = 0; i < iccp->size; i++) {
+        *hash = (*hash ^ data[i]) * 1099511628211ULL;
+    }
+
+    *size = iccp->size;
+}
+
+/* Must be called under the cache lock. */
+static struct cache_entry *find_cache_entry(const struct cache_entry *key) {
+
+    for (unsigned i = 0; i < CACHE_SIZE; i++) {
+        struct cache_entry *entry = &cache[i];
+
+        if (entry->transform != NULL
+                && entry->source_hash == key->source_hash && entry->source_size == key->source_size
+                && entry->target_hash == key->target_hash && entry->target_size == key->target_size
+                && entry->pixel_format == key->pixel_format) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/* Must be called under the cache lock. Returns the transform to destroy outside of the lock or NULL. */
+static struct sail_color_transform *unreference_transform(struct sail_color_transform *transform) {
+
+    return (--transform->cache_references == 0) ? transform : NULL;
+}
+
+static sail_status_t acquire_transform(const struct sail_iccp *source_iccp, const struct sail_iccp *target_iccp,
+                                        enum SailPixelFormat pixel_format, struct sail_color_transform **transform) {
+
+    struct cache_entry key = { .pixel_format = pixel_format };
+    hash_iccp(source_iccp, &key.source_hash, &key.source_size);
+    hash_iccp(target_iccp, &key.target_hash, &key.target_size);
+
+    manip_lock(&cache_lock);
+
+    struct cache_entry *entry = find_cache_entry(&key);
+
+    if (entry != NULL) {
+        entry->last_use = ++cache_clock;
+        entry->transform->cache_references++;
+        *transform = entry->transform;
+        manip_unlock(&cache_lock);
+        return SAIL_OK;
+    }
+
+    manip_unlock(&cache_lock);
+
+    /* Build lookup tables without blocking other threads. */
+    struct sail_color_transform *transform_local;
+    SAIL_TRY(sail_alloc_color_transform(source_iccp, target_iccp, pixel_format, &transform_local));
+
+    struct sail_color_transform *evicted = NULL;
+
+    manip_lock(&cache_lock);
+
+    /* Another thread may have built the same transform meanwhile. */
+    entry = find_cache_entry(&key);
+
+    if (entry != NULL) {
+        evicted = transform_local;
+    } else {
+        entry = &cache[0];
+
+        for (unsigned i = 1; i < CACHE_SIZE && entry->transform != NULL; i++) {
+            if (cache[i].transform == NULL || cache[i].last_use < entry->last_use) {
+                entry = &cache[i];
+            }
+        }
+
+        if (entry->transform != NULL) {
+            evicted = unreference_transform(entry->transform);
+        }
+
+        *entry = key;
+        entry->transform = transform_local;
+        entry->transform->cache_references = 1;
+    }
+
+    entry->last_use = ++cache_clock;
+    entry->transform->cache_references++;
+    *transform = entry->transform;
+
+    manip_unlock(&cache_lock);
+
+    sail_destroy_color_transform(evicted);
+
+    return SAIL_OK;
+}
+
+static void release_transform(struct sail_color_transform *transform) {
+
+    manip_lock(&cache_lock);
+    struct sail_color_transform *unused = unreference_transform(transform);
+    manip_unlock(&cache_lock);
+
+    sail_destroy_color_transform(unused);
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_color_transform(const struct sail_iccp *source_iccp,
+                                         const struct sail_iccp *target_iccp,
+                                         enum SailPixelFormat pixel_format,
+                                         struct sail_color_transform **transform) {
+
+    SAIL_CHECK_PTR(transform);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_color_transform), &ptr));
+    struct sail_color_transform *transform_local = ptr;
+
+    memset(transform_local, 0, sizeof(*transform_local));
+
+    if (!transform_layout(pixel_format, transform_local)) {
+        SAIL_LOG_ERROR("Color transforms of %s pixels are not supported", sail_pixel_format_to_string(pixel_format));
+        sail_free(transform_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    struct icc_profile source_profile;
+    struct icc_profile target_profile;
+
+    SAIL_TRY_OR_CLEANUP(load_profile(source_iccp, &source_profile),
+                        /* cleanup */ sail_free(transform_local));
+    SAIL_TRY_OR_CLEANUP(load_profile(target_iccp, &target_profile),
+                        /* cleanup */ sail_free(transform_local));
+
+    const bool gray_pixels = transform_local->color_channels == 1;
+
+    if ((gray_pixels && source_profile.color_space != ICC_COLOR_SPACE_GRAY) ||
+            (!gray_pixels && target_profile.color_space != ICC_COLOR_SPACE_RGB)) {
+        SAIL_LOG_ERROR("ICC: Profile color spaces don't match %s pixels", sail_pixel_format_to_string(pixel_format));
+        sail_free(transform_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    SAIL_TRY_OR_CLEANUP(build_luts(&source_profile, &target_profile, transform_local),
+                        /* cleanup */ sail_destroy_color_transform(transform_local));
+
+    *transform = transform_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_color_transform(struct sail_color_transform *transform) {
+
+    if (transform == NULL) {
+        return;
+    }
+
+    destroy_luts(transform->direct_luts);
+    destroy_luts(transform->linear_luts);
+    destroy_luts(transform->output_luts);
+
+    sail_free(transform);
+}
+
+sail_status_t sail_apply_color_transform(const struct sail_color_transform *transform, struct sail_image *image) {
+
+    SAIL_CHECK_PTR(transform);
+    SAIL_TRY(sail_check_image_valid(image));
+
+    if (image->pixel_format != transform->pixel_format) {
+        SAIL_LOG_ERROR("Color transform of %s pixels cannot be applied to %s pixels",
+                        sail_pixel_format_to_string(transform->pixel_format), sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (transform->identity) {
+        return SAIL_OK;
+    }
+
+    struct transform_job job = { .transform = transform, .image = image };
+
+    SAIL_TRY(parallel_for_rows(image->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image->width), 0,
+                                transform_row_block, &job));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_transform_image_colors(struct sail_image *image, const struct sail_iccp *target_iccp) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+
+    struct sail_color_transform *transform;
+    SAIL_TRY(acquire_transform(image->iccp, target_iccp, image->pixel_format, &transform));
+
+    struct sail_iccp *iccp = NULL;
+
+    if (target_iccp != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_copy_iccp(target_iccp, &iccp),
+                            /* cleanup */ release_transform(transform));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_apply_color_transform(transform, image),
+                        /* cleanup */ sail_destroy_iccp(iccp), release_transform(transform));
+
+    release_transform(transform);
+
+    sail_destroy_iccp(image->iccp);
+    image->iccp = iccp;
+
+    return SAIL_OK;
+}
+
+bool sail_can_transform_colors(enum SailPixelFormat pixel_format) {
+
+    return transform_layout(pixel_format, NULL);
+}
+
+void sail_clear_color_transform_cache(void) {
+
+    struct sail_color_transform *unused[CACHE_SIZE];
+
+    manip_lock(&cache_lock);
+
+    for (unsigned i = 0; i < CACHE_SIZE; i++) {
+        unused[i] = (cache[i].transform == NULL) ? NULL : unreference_transform(cache[i].transform);
+        cache[i].transform = NULL;
+    }
+
+    manip_unlock(&cache_lock);
+
+    for (unsigned i = 0; i < CACHE_SIZE; i++) {
+        sail_destroy_color_transform(unused[i]);
+    }
+}
@@ -0,0 +1,122 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_COLOR_TRANSFORM_H
+#define SAIL_COLOR_TRANSFORM_H
+
+#include <stdbool.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_color_transform;
+struct sail_iccp;
+struct sail_image;
+
+/*
+ * Allocates a new color transform of pixels in the specified pixel format from the source ICC profile
+ * into the target ICC profile. NULL profiles mean sRGB. The transform builds lookup tables once, so it
+ * can be applied to many images with sail_apply_color_transform() without repeating this work.
+ *
+ * Only matrix/TRC profiles are supported, i.e. RGB profiles with colorant and tone reproduction
+ * curve tags, and grayscale profiles with a gray tone reproduction curve. Profiles built on lookup
+ * tables are rejected. RGB pixels require an RGB target profile. Their source profile may also be
+ * a grayscale one, e.g. for grayscale frames converted into RGB; the gray curve is applied to every
+ * channel in this case. Grayscale pixels require a grayscale source profile and any target profile;
+ * the green curve of RGB target profiles is used in this case.
+ *
+ * The profile data is not referenced after the function returns.
+ *
+ * Allowed pixel formats:
+ *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA
+ *   - SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA
+ *   - 24 and 48-bit RGB and BGR
+ *   - 32 and 64-bit RGBX, BGRX, XRGB, XBGR, RGBA, BGRA, ARGB, and ABGR
+ *
+ * Returns SAIL_ERROR_UNSUPPORTED_ICCP if the profiles are not supported.
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_color_transform(const struct sail_iccp *source_iccp,
+                                                     const struct sail_iccp *target_iccp,
+                                                     enum SailPixelFormat pixel_format,
+                                                     struct sail_color_transform **transform);
+
+/*
+ * Destroys the specified color transform. Does nothing if the transform is NULL.
+ */
+SAIL_EXPORT void sail_destroy_color_transform(struct sail_color_transform *transform);
+
+/*
+ * Transforms the image pixels in place with the color transform. The image must have the transform
+ * pixel format. The image ICC profile is ignored and left as is. Alpha and X channels are not changed.
+ *
+ * RGB pixels are mapped into linear light with lookup tables, multiplied by a 3x3 matrix, and mapped
+ * back with lookup tables of 65536 entries. When the profiles have the same colorants, and for grayscale
+ * pixels, every channel is mapped with a single lookup table. Scan lines are processed with up to
+ * sail_max_threads() threads.
+ *
+ * The transform is not modified, so it can be used from multiple threads simultaneously.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_apply_color_transform(const struct sail_color_transform *transform, struct sail_image *image);
+
+/*
+ * Transforms the image pixels in place from the image ICC profile into the target ICC profile.
+ * NULL profiles mean sRGB, so images without ICC profiles are treated as sRGB images. Replaces
+ * the image ICC profile with a copy of the target profile, or removes it if the target profile is NULL.
+ *
+ * Color transforms are cached by the profile hashes and pixel formats, so transforming many images
+ * with the same profiles builds lookup tables only once. See sail_alloc_color_transform() for the supported
+ * profiles and pixel formats. If the function fails, the image is left untouched.
+ *
+ * Returns SAIL_ERROR_UNSUPPORTED_ICCP if the profiles are not supported.
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_transform_image_colors(struct sail_image *image, const struct sail_iccp *target_iccp);
+
+/*
+ * Returns true if color transforms support the pixel format.
+ */
+SAIL_EXPORT bool sail_can_transform_colors(enum SailPixelFormat pixel_format);
+
+/*
+ * Destroys color transforms cached by sail_transform_image_colors().
+ */
+SAIL_EXPORT void sail_clear_color_transform_cache(void);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -33,9 +33,13 @@ sail_status_t sail_alloc_conversion_options(struct sail_conversion_options **opt
     SAIL_TRY(sail_malloc(sizeof(struct sail_conversion_options), &ptr));
     *options = ptr;
 
-    (*options)->options      = SAIL_CONVERSION_OPTION_DROP_ALPHA;
-    (*options)->background48 = (sail_rgb48_t){ 0, 0, 0 };
-    (*options)->background24 = (sail_rgb24_t){ 0, 0, 0 };
+    (*options)->options        = SAIL_CONVERSION_OPTION_DROP_ALPHA;
+    (*options)->background48   = (sail_rgb48_t){ 0, 0, 0 };
+    (*options)->background24   = (sail_rgb24_t){ 0, 0, 0 };
+    (*options)->cancel_token   = NULL;
+    (*options)->max_threads    = 0;
+    (*options)->tone_map_white = 0;
+    (*options)->gamma          = 0;
 
     return SAIL_OK;
 }
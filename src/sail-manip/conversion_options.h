@@ -36,6 +36,8 @@
 extern "C" {
 #endif
 
+struct sail_cancel_token;
+
 /*
  * Options to control image conversion behavior.
  */
@@ -57,6 +59,34 @@ struct sail_conversion_options {
      * when options has SAIL_CONVERSION_OPTION_BLEND_ALPHA.
      */
     sail_rgb24_t background24;
+
+    /*
+     * Cancellation token checked while converting scan lines. Conversion is aborted with SAIL_ERROR_CANCELED
+     * when the token is canceled or its deadline is reached. Not owned by the conversion options. Can be NULL.
+     */
+    const struct sail_cancel_token *cancel_token;
+
+    /*
+     * Maximum number of threads, including the calling thread, used to convert the image.
+     * Zero means the global limit set with sail_set_max_threads(). Values above the global limit
+     * are clamped to it. Set to 1 to convert in the calling thread only.
+     */
+    unsigned max_threads;
+
+    /*
+     * Color value mapped to the maximum output value when SAIL_CONVERSION_OPTION_TONE_MAP
+     * is set. Brighter values are clipped. Values less than 1.0, including zero, mean 4.0.
+     */
+    float tone_map_white;
+
+    /*
+     * Gamma of the pixels when options has SAIL_CONVERSION_OPTION_LINEAR_LIGHT. Values less than 1.0
+     * are encoding gammas like 0.45455 stored in PNG files, values greater than 1.0 are decoding gammas
+     * like 2.2. Zero means the gamma of the input image when converting images, and sRGB when converting
+     * pixel buffers or with conversion plans. 1.0 means sRGB too as it's the default image gamma when
+     * the actual gamma is unknown.
+     */
+    double gamma;
 };
 
 typedef struct sail_conversion_options sail_conversion_options_t;
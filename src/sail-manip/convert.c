@@ -28,6 +28,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sail-manip/sail-manip.h>
 
@@ -124,6 +125,78 @@ static inline void pixel_consumer_rgba64_kind(const struct output_context *outpu
     *scan16 += 4;
 }
 
+static inline void pixel_consumer_premultiplied_rgba32_kind(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    uint8_t *pixel = *scan8;
+
+    pixel_consumer_rgba32_kind(output_context, scan8, scan16, rgba32, rgba64);
+
+    const unsigned alpha = pixel[output_context->a];
+
+    pixel[output_context->r] = premultiply_uint8(pixel[output_context->r], alpha);
+    pixel[output_context->g] = premultiply_uint8(pixel[output_context->g], alpha);
+    pixel[output_context->b] = premultiply_uint8(pixel[output_context->b], alpha);
+}
+
+static inline void pixel_consumer_premultiplied_rgba64_kind(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    uint16_t *pixel = *scan16;
+
+    pixel_consumer_rgba64_kind(output_context, scan8, scan16, rgba32, rgba64);
+
+    const unsigned alpha = pixel[output_context->a];
+
+    pixel[output_context->r] = premultiply_uint16(pixel[output_context->r], alpha);
+    pixel[output_context->g] = premultiply_uint16(pixel[output_context->g], alpha);
+    pixel[output_context->b] = premultiply_uint16(pixel[output_context->b], alpha);
+}
+
+/* Gets 16-bit values of the pixel with alpha blended or dropped like the integer consumers do. */
+static inline void fill_floating_point_values(const struct output_context *output_context, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64, uint16_t values[4]) {
+
+    const int a = (output_context->a >= 0) ? 3 : -1;
+
+    if (rgba32 != NULL) {
+        fill_rgba64_pixel_from_uint8_values(rgba32, values, 0, 1, 2, a, output_context->options);
+    } else {
+        fill_rgba64_pixel_from_uint16_values(rgba64, values, 0, 1, 2, a, output_context->options);
+    }
+}
+
+static inline void pixel_consumer_half_kind(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    (void)scan16;
+
+    uint16_t values[4];
+    fill_floating_point_values(output_context, rgba32, rgba64, values);
+
+    const unsigned channels = (output_context->a >= 0) ? 4 : 3;
+    uint16_t *pixel = (uint16_t *)*scan8;
+
+    for (unsigned c = 0; c < channels; c++) {
+        pixel[c] = float_to_half(values[c] / 65535.0f);
+    }
+
+    *scan8 += channels * sizeof(uint16_t);
+}
+
+static inline void pixel_consumer_float_kind(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    (void)scan16;
+
+    uint16_t values[4];
+    fill_floating_point_values(output_context, rgba32, rgba64, values);
+
+    const unsigned channels = (output_context->a >= 0) ? 4 : 3;
+    float *pixel = (float *)*scan8;
+
+    for (unsigned c = 0; c < channels; c++) {
+        pixel[c] = values[c] / 65535.0f;
+    }
+
+    *scan8 += channels * sizeof(float);
+}
+
 static inline void pixel_consumer_ycbcr(const struct output_context *output_context, uint8_t **scan8, uint16_t ** scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
     (void)scan16;
@@ -167,6 +240,16 @@ static bool verify_and_construct_rgba_indexes_silent(enum SailPixelFormat output
         case SAIL_PIXEL_FORMAT_BPP64_ARGB: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 1; *g = 2; *b = 3; *a = 0;  break; }
         case SAIL_PIXEL_FORMAT_BPP64_ABGR: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 3; *g = 2; *b = 1; *a = 0;  break; }
 
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_premultiplied_rgba32_kind; *r = 0; *g = 1; *b = 2; *a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_premultiplied_rgba32_kind; *r = 2; *g = 1; *b = 0; *a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_premultiplied_rgba64_kind; *r = 0; *g = 1; *b = 2; *a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_premultiplied_rgba64_kind; *r = 2; *g = 1; *b = 0; *a = 3; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:    { *pixel_consumer = pixel_consumer_half_kind;  *r = 0; *g = 1; *b = 2; *a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:   { *pixel_consumer = pixel_consumer_half_kind;  *r = 0; *g = 1; *b = 2; *a = 3;  break; }
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:   { *pixel_consumer = pixel_consumer_float_kind; *r = 0; *g = 1; *b = 2; *a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: { *pixel_consumer = pixel_consumer_float_kind; *r = 0; *g = 1; *b = 2; *a = 3;  break; }
+
         case SAIL_PIXEL_FORMAT_BPP24_YCBCR: { *pixel_consumer = pixel_consumer_ycbcr; *r = *g = *b = *a = -1; /* unused. */ break; }
 
         default: {
@@ -187,104 +270,94 @@ static sail_status_t verify_and_construct_rgba_indexes_verbose(enum SailPixelFor
     }
 }
 
-static sail_status_t convert_from_indexed(const struct sail_image *image,
-                                            const unsigned input_bit_shift, const unsigned bit_shift_decrease_by,
-                                            const unsigned input_bit_mask, const unsigned bit_mask_shift_by,
-                                            pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
-
-    sail_status_t status = SAIL_OK;
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) shared(status)
-    for (row = 0; row < image->height; row++) {
-        #pragma omp flush(status)
-        if (status == SAIL_OK) {
-            const uint8_t  *scan_input    = sail_scan_line(image, row);
-                  uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
-                  uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
-
-            for (unsigned column = 0; column < image->width;) {
-                unsigned bit_shift = input_bit_shift;
-                unsigned bit_mask = input_bit_mask;
-                const uint8_t byte = *scan_input++;
-
-                while (bit_mask > 0 && column < image->width) {
-                    const uint8_t index = (byte & bit_mask) >> bit_shift;
-
-                    sail_rgba32_t rgba32;
-                    SAIL_TRY_OR_EXECUTE(get_palette_rgba32(image->palette, index, &rgba32),
-                                        /* on error */ status = __sail_status);
-                    #pragma omp flush(status)
-                    pixel_consumer(output_context, &scan_output8, &scan_output16, &rgba32, NULL);
-
-                    bit_shift -= bit_shift_decrease_by;
-                    bit_mask >>= bit_mask_shift_by;
-                    column++;
-                }
-            }
-        }
-    }
-
-    return SAIL_OK;
-}
-
-static sail_status_t convert_from_bpp1_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
-
-    SAIL_TRY(convert_from_indexed(image, 7, 1, /* 10000000 */ 0x80, 1, pixel_consumer, output_context));
-
-    return SAIL_OK;
-}
-
-static sail_status_t convert_from_bpp2_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+/*
+ * Output pixels for every possible input value of an indexed or up to 8-bit grayscale image,
+ * so such images are converted with a single lookup per pixel.
+ */
+struct pixel_lut {
+    /*
+     * Up to 256 output pixels of up to 16 bytes each, i.e. BPP128-RGBA-FLOAT. uint64_t ensures alignment
+     * for 16-bit and floating point outputs.
+     */
+    uint64_t entries[256 * 2];
+    /* Number of valid entries. Indexes beyond it are out of the palette range. */
+    unsigned count;
+    /* Output pixel size in bytes. */
+    unsigned pixel_size;
+    /* Input bits per pixel: 1, 2, 4, or 8. */
+    unsigned bits_per_pixel;
+    /* Input pixel values for every byte of 1, 2, and 4-bit images. */
+    uint8_t unpacked[256][8];
+};
 
-    SAIL_TRY(convert_from_indexed(image, 6, 2, /* 11000000 */ 0xC0, 2, pixel_consumer, output_context));
+static bool pixel_lut_supported(enum SailPixelFormat input_pixel_format) {
 
-    return SAIL_OK;
+    switch (input_pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP2_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE:
+        case SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE:
+        case SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE:
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
 }
 
-static sail_status_t convert_from_bpp4_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+/* Output pixels are produced with the pixel consumer or, if it's not NULL, with the linear light converter from BPP32-RGBA. */
+static sail_status_t build_pixel_lut(enum SailPixelFormat input_pixel_format, const struct sail_palette *palette,
+                                        enum SailPixelFormat output_pixel_format,
+                                        pixel_consumer_t pixel_consumer, const struct output_context *output_context,
+                                        const struct linear_light_converter *linear_light,
+                                        struct pixel_lut *lut) {
 
-    SAIL_TRY(convert_from_indexed(image, 4, 4, /* 11110000 */ 0xF0, 4, pixel_consumer, output_context));
+    lut->bits_per_pixel = sail_bits_per_pixel(input_pixel_format);
+    lut->pixel_size     = sail_bits_per_pixel(output_pixel_format) / 8;
 
-    return SAIL_OK;
-}
+    const unsigned max_count = 1U << lut->bits_per_pixel;
 
-static sail_status_t convert_from_bpp8_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+    /* X channels are not written by pixel consumers. Fill them with 255. */
+    memset(lut->entries, 0xFF, sizeof(lut->entries));
+    lut->count = 0;
 
-    SAIL_TRY(convert_from_indexed(image, 0, 0, /* 11111111 */ 0xFF, 8, pixel_consumer, output_context));
+    for (unsigned i = 0; i < max_count; i++) {
+        uint8_t  *entry8  = (uint8_t *)lut->entries + i * lut->pixel_size;
+        uint16_t *entry16 = (uint16_t *)entry8;
 
-    return SAIL_OK;
-}
+        sail_rgba32_t rgba32;
 
-static sail_status_t convert_from_grayscale_up_to_bpp8(const struct sail_image *image,
-                                                        const unsigned input_bit_shift, const unsigned bit_shift_decrease_by,
-                                                        const unsigned input_bit_mask, const unsigned bit_mask_shift_by,
-                                                        const unsigned multiplicator_to_255,
-                                                        pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
-
-    unsigned row;
+        if (sail_is_indexed(input_pixel_format)) {
+            if (i >= palette->color_count) {
+                break;
+            }
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
-        const uint8_t  *scan_input    = sail_scan_line(image, row);
-              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
-              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+            SAIL_TRY(get_palette_rgba32(palette, i, &rgba32));
+        } else {
+            spread_gray8_to_rgba32((uint8_t)(i * (255 / (max_count - 1))), &rgba32);
+        }
 
-        for (unsigned column = 0; column < image->width;) {
-            unsigned bit_shift = input_bit_shift;
-            unsigned bit_mask = input_bit_mask;
-            const uint8_t byte = *scan_input++;
+        if (linear_light != NULL) {
+            linear_light_convert_row(linear_light, &rgba32, entry8, 1);
+        } else {
+            pixel_consumer(output_context, &entry8, &entry16, &rgba32, NULL);
+        }
 
-            while (bit_mask > 0 && column < image->width) {
-                const uint8_t index = (byte & bit_mask) >> bit_shift;
+        lut->count = i + 1;
+    }
 
-                sail_rgba32_t rgba32;
-                spread_gray8_to_rgba32((uint8_t)(index * multiplicator_to_255), &rgba32);
-                pixel_consumer(output_context, &scan_output8, &scan_output16, &rgba32, NULL);
+    /* Table-driven unpacking of 1, 2, and 4-bit pixels from the most significant bits. */
+    if (lut->bits_per_pixel < 8) {
+        const unsigned pixels_per_byte = 8 / lut->bits_per_pixel;
+        const unsigned mask = max_count - 1;
 
-                bit_shift -= bit_shift_decrease_by;
-                bit_mask >>= bit_mask_shift_by;
-                column++;
+        for (unsigned byte = 0; byte < 256; byte++) {
+            for (unsigned k = 0; k < pixels_per_byte; k++) {
+                lut->unpacked[byte][k] = (uint8_t)((byte >> (8 - lut->bits_per_pixel * (k + 1))) & mask);
             }
         }
     }
@@ -292,40 +365,51 @@ static sail_status_t convert_from_grayscale_up_to_bpp8(const struct sail_image *
     return SAIL_OK;
 }
 
-static sail_status_t convert_from_bpp1_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
-
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 7, 1, /* 10000000 */ 0x80, 1, 255, pixel_consumer, output_context));
-
-    return SAIL_OK;
+static inline void copy_lut_pixel(uint8_t *scan_output, const uint8_t *entry, unsigned pixel_size) {
+
+    switch (pixel_size) {
+        case 1: { *scan_output = *entry;            break; }
+        case 2: { memcpy(scan_output, entry, 2);    break; }
+        case 3: { memcpy(scan_output, entry, 3);    break; }
+        case 4: { memcpy(scan_output, entry, 4);    break; }
+        case 6: { memcpy(scan_output, entry, 6);    break; }
+        case 8: { memcpy(scan_output, entry, 8);    break; }
+        case 12: { memcpy(scan_output, entry, 12);  break; }
+        default: { memcpy(scan_output, entry, 16);  break; }
+    }
 }
 
-static sail_status_t convert_from_bpp2_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
-
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 6, 2, /* 11000000 */ 0xC0, 2, 85, pixel_consumer, output_context));
-
-    return SAIL_OK;
-}
+static sail_status_t convert_with_pixel_lut(const struct sail_image *image, struct sail_image *image_output, const struct pixel_lut *lut) {
 
-static sail_status_t convert_from_bpp4_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+    const uint8_t *entries = (const uint8_t *)lut->entries;
+    const unsigned pixels_per_byte = 8 / lut->bits_per_pixel;
 
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 4, 4, /* 11110000 */ 0xF0, 4, 17, pixel_consumer, output_context));
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan_input  = sail_scan_line(image, row);
+              uint8_t *scan_output = sail_scan_line(image_output, row);
 
-    return SAIL_OK;
-}
+        for (unsigned column = 0; column < image->width;) {
+            const uint8_t byte = *scan_input++;
+            const uint8_t *values = (pixels_per_byte == 1) ? &byte : lut->unpacked[byte];
 
-static sail_status_t convert_from_bpp8_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+            for (unsigned k = 0; k < pixels_per_byte && column < image->width; k++, column++) {
+                if (values[k] >= lut->count) {
+                    SAIL_LOG_ERROR("Palette index %u is out of range [0; %u)", values[k], lut->count);
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+                }
 
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 0, 0, /* 11111111 */ 0xFF, 8, 1, pixel_consumer, output_context));
+                copy_lut_pixel(scan_output, entries + values[k] * lut->pixel_size, lut->pixel_size);
+                scan_output += lut->pixel_size;
+            }
+        }
+    }
 
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp16_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -342,10 +426,7 @@ static sail_status_t convert_from_bpp16_grayscale(const struct sail_image *image
 
 static sail_status_t convert_from_bpp16_grayscale_alpha(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -364,10 +445,7 @@ static sail_status_t convert_from_bpp16_grayscale_alpha(const struct sail_image
 
 static sail_status_t convert_from_bpp32_grayscale_alpha(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -386,10 +464,7 @@ static sail_status_t convert_from_bpp32_grayscale_alpha(const struct sail_image
 
 static sail_status_t convert_from_bpp16_rgb555(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -407,10 +482,7 @@ static sail_status_t convert_from_bpp16_rgb555(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp16_bgr555(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -428,10 +500,7 @@ static sail_status_t convert_from_bpp16_bgr555(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp16_rgb565(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -449,10 +518,7 @@ static sail_status_t convert_from_bpp16_rgb565(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp16_bgr565(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -470,10 +536,7 @@ static sail_status_t convert_from_bpp16_bgr565(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp24_rgb_kind(const struct sail_image *image, int ri, int gi, int bi, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -491,10 +554,7 @@ static sail_status_t convert_from_bpp24_rgb_kind(const struct sail_image *image,
 
 static sail_status_t convert_from_bpp48_rgb_kind(const struct sail_image *image, int ri, int gi, int bi, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -512,10 +572,7 @@ static sail_status_t convert_from_bpp48_rgb_kind(const struct sail_image *image,
 
 static sail_status_t convert_from_bpp32_rgba_kind(const struct sail_image *image, int ri, int gi, int bi, int ai, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -533,10 +590,7 @@ static sail_status_t convert_from_bpp32_rgba_kind(const struct sail_image *image
 
 static sail_status_t convert_from_bpp64_rgba_kind(const struct sail_image *image, int ri, int gi, int bi, int ai, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -552,12 +606,100 @@ static sail_status_t convert_from_bpp64_rgba_kind(const struct sail_image *image
     return SAIL_OK;
 }
 
-static sail_status_t convert_from_bpp32_cmyk(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+static sail_status_t convert_from_bpp32_premultiplied_rgba_kind(const struct sail_image *image, int ri, int gi, int bi, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t  *scan_input    = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const unsigned alpha = *(scan_input+3);
+            const sail_rgba32_t rgba32 = {
+                unpremultiply_uint8(*(scan_input+ri), alpha),
+                unpremultiply_uint8(*(scan_input+gi), alpha),
+                unpremultiply_uint8(*(scan_input+bi), alpha),
+                (uint8_t)alpha
+            };
+
+            pixel_consumer(output_context, &scan_output8, &scan_output16, &rgba32, NULL);
+            scan_input += 4;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t convert_from_bpp64_premultiplied_rgba_kind(const struct sail_image *image, int ri, int gi, int bi, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint16_t *scan_input    = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const unsigned alpha = *(scan_input+3);
+            const sail_rgba64_t rgba64 = {
+                unpremultiply_uint16(*(scan_input+ri), alpha),
+                unpremultiply_uint16(*(scan_input+gi), alpha),
+                unpremultiply_uint16(*(scan_input+bi), alpha),
+                (uint16_t)alpha
+            };
 
-    unsigned row;
+            pixel_consumer(output_context, &scan_output8, &scan_output16, NULL, &rgba64);
+            scan_input += 4;
+        }
+    }
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    return SAIL_OK;
+}
+
+/* Values are clipped or tone mapped into 16-bit values. */
+static sail_status_t convert_from_floating_point_rgba_kind(const struct sail_image *image, unsigned channels, bool half, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    float inv_white_squared = 0;
+    const bool tone_map = tone_map_requested(output_context->options, &inv_white_squared);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint16_t *scan_input16 = sail_scan_line(image, row);
+        const float    *scan_input32 = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            float values[4] = { 0, 0, 0, 1 };
+
+            for (unsigned c = 0; c < channels; c++) {
+                values[c] = half ? half_to_float(scan_input16[c]) : scan_input32[c];
+            }
+
+            if (tone_map) {
+                const float factor = tone_map_factor(values[0], values[1], values[2], inv_white_squared);
+
+                values[0] *= factor;
+                values[1] *= factor;
+                values[2] *= factor;
+            }
+
+            const sail_rgba64_t rgba64 = {
+                (uint16_t)float_to_uint(values[0], 65535.0f),
+                (uint16_t)float_to_uint(values[1], 65535.0f),
+                (uint16_t)float_to_uint(values[2], 65535.0f),
+                (uint16_t)float_to_uint(values[3], 65535.0f)
+            };
+
+            pixel_consumer(output_context, &scan_output8, &scan_output16, NULL, &rgba64);
+            scan_input16 += channels;
+            scan_input32 += channels;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t convert_from_bpp32_cmyk(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    for (unsigned row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -576,10 +718,7 @@ static sail_status_t convert_from_bpp32_cmyk(const struct sail_image *image, pix
 
 static sail_status_t convert_from_bpp24_ycbcr(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -598,10 +737,7 @@ static sail_status_t convert_from_bpp24_ycbcr(const struct sail_image *image, pi
 
 static sail_status_t convert_from_bpp32_ycck(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
+    for (unsigned row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
               uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
@@ -618,170 +754,370 @@ static sail_status_t convert_from_bpp32_ycck(const struct sail_image *image, pix
     return SAIL_OK;
 }
 
-static sail_status_t conversion_impl(
-    const struct sail_image *image,
-    struct sail_image *image_output,
-    pixel_consumer_t pixel_consumer,
-    int r, /* Index of the RED component.   */
-    int g, /* Index of the GREEN component. */
-    int b, /* Index of the BLUE component.  */
-    int a, /* Index of the ALPHA component. */
-    const struct sail_conversion_options *options) {
+/*
+ * Conversion plan. Everything that depends only on the pixel formats, options, and palette
+ * is selected once, so the plan can be executed many times.
+ */
+struct sail_conversion_plan {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    unsigned width;
+
+    /*
+     * Planar pixels are converted through BPP24-YCbCr scan lines. Everything below converts scan lines
+     * between these pixel formats. The conversion is skipped when they are equal.
+     */
+    enum SailPixelFormat rows_input_pixel_format;
+    enum SailPixelFormat rows_output_pixel_format;
+
+    /* Points to options_copy or NULL. */
+    const struct sail_conversion_options *options;
+    struct sail_conversion_options options_copy;
+
+    /* Generic conversion through the intermediate RGBA pixels. */
+    pixel_consumer_t pixel_consumer;
+    int r; /* Index of the RED component.   */
+    int g; /* Index of the GREEN component. */
+    int b; /* Index of the BLUE component.  */
+    int a; /* Index of the ALPHA component. */
+
+    /* Faster paths in the order of preference. Unused ones are false or NULL. */
+    void (*alpha_kernel)(const void *input, void *output, unsigned width);
+    bool use_linear_light;
+    struct linear_light_converter linear_light;
+    bool use_simd_converter;
+    struct simd_converter simd_converter;
+    row_kernel_t row_kernel;
+    struct pixel_lut *pixel_lut;
+};
 
-    const struct output_context output_context = { image_output, r, g, b, a, options };
+/* Returns the straight alpha counterpart of the premultiplied pixel format. */
+static enum SailPixelFormat straight_pixel_format(enum SailPixelFormat pixel_format) {
 
-    /* After adding a new input pixel format, also update the switch in sail_can_convert(). */
-    switch (image->pixel_format) {
-        case SAIL_PIXEL_FORMAT_BPP1_INDEXED: {
-            SAIL_TRY(convert_from_bpp1_indexed(image, pixel_consumer, &output_context));
-            break;
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: return SAIL_PIXEL_FORMAT_BPP32_RGBA;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: return SAIL_PIXEL_FORMAT_BPP32_BGRA;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: return SAIL_PIXEL_FORMAT_BPP64_RGBA;
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: return SAIL_PIXEL_FORMAT_BPP64_BGRA;
+
+        default: {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
         }
-        case SAIL_PIXEL_FORMAT_BPP2_INDEXED: {
-            SAIL_TRY(convert_from_bpp2_indexed(image, pixel_consumer, &output_context));
-            break;
+    }
+}
+
+static void cleanup_conversion_plan(struct sail_conversion_plan *plan) {
+
+    if (plan->use_linear_light) {
+        linear_light_cleanup_converter(&plan->linear_light);
+        plan->use_linear_light = false;
+    }
+
+    sail_free(plan->pixel_lut);
+    plan->pixel_lut = NULL;
+}
+
+/* The image gamma is used in linear light conversions. Zero means unknown. */
+static sail_status_t init_conversion_plan(enum SailPixelFormat input_pixel_format,
+                                            enum SailPixelFormat output_pixel_format,
+                                            unsigned width,
+                                            const struct sail_palette *palette,
+                                            double gamma,
+                                            const struct sail_conversion_options *options,
+                                            struct sail_conversion_plan *plan) {
+
+    plan->input_pixel_format       = input_pixel_format;
+    plan->output_pixel_format      = output_pixel_format;
+    plan->width                    = width;
+    plan->rows_input_pixel_format  = sail_is_planar(input_pixel_format) ? SAIL_PIXEL_FORMAT_BPP24_YCBCR : input_pixel_format;
+    plan->rows_output_pixel_format = sail_is_planar(output_pixel_format) ? SAIL_PIXEL_FORMAT_BPP24_YCBCR : output_pixel_format;
+    plan->alpha_kernel             = NULL;
+    plan->use_linear_light         = false;
+    plan->use_simd_converter       = false;
+    plan->row_kernel               = NULL;
+    plan->pixel_lut                = NULL;
+
+    input_pixel_format  = plan->rows_input_pixel_format;
+    output_pixel_format = plan->rows_output_pixel_format;
+
+    if (options == NULL) {
+        plan->options = NULL;
+    } else {
+        plan->options_copy = *options;
+        plan->options = &plan->options_copy;
+    }
+
+    SAIL_TRY(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &plan->pixel_consumer, &plan->r, &plan->g, &plan->b, &plan->a));
+
+    /* Premultiply or unpremultiply alpha without reordering the channels. */
+    const bool premultiply   = sail_is_premultiplied(output_pixel_format) && straight_pixel_format(output_pixel_format) == input_pixel_format;
+    const bool unpremultiply = sail_is_premultiplied(input_pixel_format) && straight_pixel_format(input_pixel_format) == output_pixel_format;
+
+    if (premultiply || unpremultiply) {
+        struct alpha_kernels alpha_kernels;
+        alpha_kernels_init(sail_bits_per_pixel(input_pixel_format) / 32, &alpha_kernels);
+
+        plan->alpha_kernel = premultiply ? alpha_kernels.premultiply : alpha_kernels.unpremultiply;
+        return SAIL_OK;
+    }
+
+    /* Blend alpha and compute luma in linear light. */
+    if (linear_light_needed(input_pixel_format, output_pixel_format, plan->options)) {
+        SAIL_TRY(linear_light_init_converter(input_pixel_format, output_pixel_format, gamma, plan->options, &plan->linear_light));
+        plan->use_linear_light = true;
+        return SAIL_OK;
+    }
+
+    /* Shuffle channels with SIMD when possible. */
+    if (simd_converter_init(input_pixel_format, output_pixel_format, plan->options, &plan->simd_converter)) {
+        plan->use_simd_converter = true;
+        return SAIL_OK;
+    }
+
+    /* Convert directly without the intermediate RGBA pixels when possible. */
+    plan->row_kernel = find_row_kernel(input_pixel_format, output_pixel_format);
+
+    if (plan->row_kernel == NULL) {
+        plan->row_kernel = find_float_kernel(input_pixel_format, output_pixel_format);
+    }
+
+    if (plan->row_kernel != NULL) {
+        return SAIL_OK;
+    }
+
+    /* Look up output pixels of indexed and up to 8-bit grayscale images. */
+    if (pixel_lut_supported(input_pixel_format)) {
+        if (sail_is_indexed(input_pixel_format)) {
+            SAIL_CHECK_PTR(palette);
         }
-        case SAIL_PIXEL_FORMAT_BPP4_INDEXED: {
-            SAIL_TRY(convert_from_bpp4_indexed(image, pixel_consumer, &output_context));
-            break;
+
+        const struct output_context output_context = { NULL, plan->r, plan->g, plan->b, plan->a, plan->options };
+
+        void *ptr;
+        SAIL_TRY(sail_malloc(sizeof(struct pixel_lut), &ptr));
+        plan->pixel_lut = ptr;
+
+        /* Palette colors are blended and converted to grayscale in linear light once. */
+        const bool linear_light = sail_is_indexed(input_pixel_format)
+                                    && linear_light_needed(SAIL_PIXEL_FORMAT_BPP32_RGBA, output_pixel_format, plan->options);
+        struct linear_light_converter linear_light_converter;
+
+        if (linear_light) {
+            SAIL_TRY_OR_CLEANUP(linear_light_init_converter(SAIL_PIXEL_FORMAT_BPP32_RGBA, output_pixel_format, gamma, plan->options, &linear_light_converter),
+                                /* cleanup */ cleanup_conversion_plan(plan));
         }
-        case SAIL_PIXEL_FORMAT_BPP8_INDEXED: {
-            SAIL_TRY(convert_from_bpp8_indexed(image, pixel_consumer, &output_context));
-            break;
+
+        const sail_status_t status = build_pixel_lut(input_pixel_format, palette, output_pixel_format, plan->pixel_consumer, &output_context,
+                                                        linear_light ? &linear_light_converter : NULL, plan->pixel_lut);
+
+        if (linear_light) {
+            linear_light_cleanup_converter(&linear_light_converter);
         }
-        case SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp1_grayscale(image, pixel_consumer, &output_context));
-            break;
+
+        SAIL_TRY_OR_CLEANUP(status,
+                            /* cleanup */ cleanup_conversion_plan(plan));
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Converts all the rows of the image with the plan. The output pixel format is taken from the plan
+ * as image_output may be the input image when updating in place.
+ */
+static sail_status_t convert_rows(const struct sail_conversion_plan *plan, const struct sail_image *image, struct sail_image *image_output) {
+
+    if (plan->alpha_kernel != NULL) {
+        for (unsigned row = 0; row < image->height; row++) {
+            plan->alpha_kernel(sail_scan_line(image, row), sail_scan_line(image_output, row), image->width);
         }
-        case SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp2_grayscale(image, pixel_consumer, &output_context));
-            break;
+
+        return SAIL_OK;
+    }
+
+    if (plan->use_linear_light) {
+        for (unsigned row = 0; row < image->height; row++) {
+            linear_light_convert_row(&plan->linear_light, sail_scan_line(image, row), sail_scan_line(image_output, row), image->width);
         }
-        case SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp4_grayscale(image, pixel_consumer, &output_context));
-            break;
+
+        return SAIL_OK;
+    }
+
+    if (plan->use_simd_converter) {
+        for (unsigned row = 0; row < image->height; row++) {
+            plan->simd_converter.convert_row(&plan->simd_converter, sail_scan_line(image, row), sail_scan_line(image_output, row), image->width);
         }
-        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp8_grayscale(image, pixel_consumer, &output_context));
-            break;
+
+        return SAIL_OK;
+    }
+
+    if (plan->row_kernel != NULL) {
+        for (unsigned row = 0; row < image->height; row++) {
+            plan->row_kernel(sail_scan_line(image, row), sail_scan_line(image_output, row), image->width, plan->options);
         }
+
+        return SAIL_OK;
+    }
+
+    if (plan->pixel_lut != NULL) {
+        SAIL_TRY(convert_with_pixel_lut(image, image_output, plan->pixel_lut));
+        return SAIL_OK;
+    }
+
+    const struct output_context output_context = { image_output, plan->r, plan->g, plan->b, plan->a, plan->options };
+
+    /* After adding a new input pixel format, also update the switch in sail_can_convert(). */
+    switch (image->pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp16_grayscale(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_grayscale(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: {
-            SAIL_TRY(convert_from_bpp16_grayscale_alpha(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_grayscale_alpha(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: {
-            SAIL_TRY(convert_from_bpp32_grayscale_alpha(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_grayscale_alpha(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_RGB555: {
-            SAIL_TRY(convert_from_bpp16_rgb555(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_rgb555(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_BGR555: {
-            SAIL_TRY(convert_from_bpp16_bgr555(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_bgr555(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_RGB565: {
-            SAIL_TRY(convert_from_bpp16_rgb565(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_rgb565(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_BGR565: {
-            SAIL_TRY(convert_from_bpp16_bgr565(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_bgr565(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP24_RGB: {
-            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 0, 1, 2, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 0, 1, 2, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP24_BGR: {
-            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 2, 1, 0, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP48_RGB: {
-            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 0, 1, 2, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 0, 1, 2, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP48_BGR: {
-            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 2, 1, 0, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_RGBX: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_BGRX: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_XRGB: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_XBGR: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, 3, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_BGRA: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, 3, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_ARGB: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, 0, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_ABGR: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, 0, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_RGBX: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_BGRX: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_XRGB: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_XBGR: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, -1, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_RGBA: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, 3, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_BGRA: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, 3, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_ARGB: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, 0, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_ABGR: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, 0, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp32_premultiplied_rgba_kind(image, 0, 1, 2, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp32_premultiplied_rgba_kind(image, 2, 1, 0, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp64_premultiplied_rgba_kind(image, 0, 1, 2, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp64_premultiplied_rgba_kind(image, 2, 1, 0, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF: {
+            SAIL_TRY(convert_from_floating_point_rgba_kind(image, 3, true, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF: {
+            SAIL_TRY(convert_from_floating_point_rgba_kind(image, 4, true, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT: {
+            SAIL_TRY(convert_from_floating_point_rgba_kind(image, 3, false, plan->pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: {
+            SAIL_TRY(convert_from_floating_point_rgba_kind(image, 4, false, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_CMYK: {
-            SAIL_TRY(convert_from_bpp32_cmyk(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_cmyk(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP24_YCBCR: {
-            SAIL_TRY(convert_from_bpp24_ycbcr(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp24_ycbcr(image, plan->pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_YCCK: {
-            SAIL_TRY(convert_from_bpp32_ycck(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_ycck(image, plan->pixel_consumer, &output_context));
             break;
         }
         default: {
@@ -793,6 +1129,177 @@ static sail_status_t conversion_impl(
     return SAIL_OK;
 }
 
+struct conversion_job {
+    const struct sail_conversion_plan *plan;
+    const struct sail_image *image;
+    struct sail_image *image_output;
+    const struct sail_cancel_token *cancel_token;
+
+    /* Planes of planar images. */
+    struct planar_pixels planar_input;
+    struct planar_pixels planar_output;
+};
+
+static sail_status_t convert_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct conversion_job *job = context;
+
+    if (job->cancel_token != NULL) {
+        SAIL_TRY(sail_check_cancel_token(job->cancel_token));
+    }
+
+    struct sail_image block = *job->image;
+    block.pixels = sail_scan_line(job->image, first_row);
+    block.height = row_count;
+
+    struct sail_image block_output = *job->image_output;
+    block_output.pixels = sail_scan_line(job->image_output, first_row);
+    block_output.height = row_count;
+
+    SAIL_TRY(convert_rows(job->plan, &block, &block_output));
+
+    return SAIL_OK;
+}
+
+/*
+ * Converts planar scan lines through BPP24-YCbCr scan lines. The temporary scan lines are allocated
+ * per block, so the memory usage doesn't depend on the image height.
+ */
+static sail_status_t convert_planar_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct conversion_job *job = context;
+    const struct sail_conversion_plan *plan = job->plan;
+    const unsigned width = job->image->width;
+
+    if (job->cancel_token != NULL) {
+        SAIL_TRY(sail_check_cancel_token(job->cancel_token));
+    }
+
+    const bool planar_input  = sail_is_planar(plan->input_pixel_format);
+    const bool planar_output = sail_is_planar(plan->output_pixel_format);
+
+    struct sail_image block = *job->image;
+    block.pixels = planar_input ? NULL : sail_scan_line(job->image, first_row);
+    block.height = row_count;
+
+    struct sail_image block_output = *job->image_output;
+    block_output.pixels = planar_output ? NULL : sail_scan_line(job->image_output, first_row);
+    block_output.height = row_count;
+
+    /* Unpack straight into the output. */
+    if (!planar_output && plan->output_pixel_format == SAIL_PIXEL_FORMAT_BPP24_YCBCR) {
+        unpack_planar_rows(&job->planar_input, width, first_row, row_count, block_output.pixels, block_output.bytes_per_line);
+        return SAIL_OK;
+    }
+
+    /* Pack straight from the input. */
+    if (!planar_input && plan->input_pixel_format == SAIL_PIXEL_FORMAT_BPP24_YCBCR) {
+        pack_planar_rows(block.pixels, block.bytes_per_line, width, first_row, row_count, &job->planar_output);
+        return SAIL_OK;
+    }
+
+    struct sail_image ycbcr;
+    memset(&ycbcr, 0, sizeof(ycbcr));
+
+    ycbcr.width          = width;
+    ycbcr.height         = row_count;
+    ycbcr.bytes_per_line = sail_bytes_per_line(width, SAIL_PIXEL_FORMAT_BPP24_YCBCR);
+    ycbcr.pixel_format   = SAIL_PIXEL_FORMAT_BPP24_YCBCR;
+    SAIL_TRY(sail_malloc((size_t)row_count * ycbcr.bytes_per_line, &ycbcr.pixels));
+
+    if (planar_input) {
+        unpack_planar_rows(&job->planar_input, width, first_row, row_count, ycbcr.pixels, ycbcr.bytes_per_line);
+
+        if (planar_output) {
+            pack_planar_rows(ycbcr.pixels, ycbcr.bytes_per_line, width, first_row, row_count, &job->planar_output);
+        } else {
+            SAIL_TRY_OR_CLEANUP(convert_rows(plan, &ycbcr, &block_output),
+                                /* cleanup */ sail_free(ycbcr.pixels));
+        }
+    } else {
+        SAIL_TRY_OR_CLEANUP(convert_rows(plan, &block, &ycbcr),
+                            /* cleanup */ sail_free(ycbcr.pixels));
+
+        pack_planar_rows(ycbcr.pixels, ycbcr.bytes_per_line, width, first_row, row_count, &job->planar_output);
+    }
+
+    sail_free(ycbcr.pixels);
+
+    return SAIL_OK;
+}
+
+static sail_status_t conversion_impl(const struct sail_conversion_plan *plan, const struct sail_image *image, struct sail_image *image_output) {
+
+    struct conversion_job job = {
+        plan,
+        image,
+        image_output,
+        (plan->options == NULL) ? NULL : plan->options->cancel_token,
+        { SAIL_PIXEL_FORMAT_UNKNOWN, { NULL, NULL, NULL }, { 0, 0, 0 } },
+        { SAIL_PIXEL_FORMAT_UNKNOWN, { NULL, NULL, NULL }, { 0, 0, 0 } }
+    };
+
+    const bool planar_input  = sail_is_planar(plan->input_pixel_format);
+    const bool planar_output = sail_is_planar(plan->output_pixel_format);
+
+    if (planar_input) {
+        init_planar_pixels(image->pixel_format, image->pixels, image->height, image->bytes_per_line, &job.planar_input);
+    }
+    if (planar_output) {
+        init_planar_pixels(image_output->pixel_format, image_output->pixels, image_output->height, image_output->bytes_per_line, &job.planar_output);
+    }
+
+    /* Check the cancellation token at least every CANCEL_CHECK_ROWS scan lines. */
+    unsigned rows_per_block = SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image->width);
+
+    if (job.cancel_token != NULL) {
+        rows_per_block = SAIL_MIN(rows_per_block, CANCEL_CHECK_ROWS);
+    }
+
+    /* Pairs of scan lines share 4:2:0 chroma, so blocks must start at even scan lines. */
+    if (planar_input || planar_output) {
+        rows_per_block = (rows_per_block + 1) / 2 * 2;
+    }
+
+    const unsigned max_threads = (plan->options == NULL) ? 0 : plan->options->max_threads;
+
+    SAIL_TRY(parallel_for_rows(image->height, rows_per_block, max_threads,
+                                (planar_input || planar_output) ? convert_planar_row_block : convert_row_block,
+                                (void *)&job));
+
+    return SAIL_OK;
+}
+
+/*
+ * Wraps the caller's pixel buffer into a temporary image that the conversion functions understand.
+ * The image doesn't own the pixels and must not be destroyed.
+ */
+static void wrap_pixels(enum SailPixelFormat pixel_format, unsigned width, unsigned height,
+                        const void *pixels, unsigned bytes_per_line, struct sail_image *image) {
+
+    memset(image, 0, sizeof(*image));
+
+    image->pixels         = (void *)pixels;
+    image->width          = width;
+    image->height         = height;
+    image->bytes_per_line = bytes_per_line;
+    image->pixel_format   = pixel_format;
+}
+
+static sail_status_t check_pixels_valid(enum SailPixelFormat pixel_format, unsigned width,
+                                        const void *pixels, unsigned bytes_per_line) {
+
+    SAIL_CHECK_PTR(pixels);
+
+    if (bytes_per_line < sail_bytes_per_line(width, pixel_format)) {
+        SAIL_LOG_ERROR("Bytes per line %u is too small for %u %s pixels",
+                        bytes_per_line, width, sail_pixel_format_to_string(pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -814,22 +1321,35 @@ sail_status_t sail_convert_image_with_options(const struct sail_image *image,
     SAIL_TRY(sail_check_image_valid(image));
     SAIL_CHECK_PTR(image_output);
 
-    int r, g, b, a;
-    pixel_consumer_t pixel_consumer;
-    SAIL_TRY(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &pixel_consumer, &r, &g, &b, &a));
+    /* Indexed pixels need a new palette. */
+    if (sail_is_indexed(output_pixel_format)) {
+        const enum SailDithering dithering = (options != NULL && (options->options & SAIL_CONVERSION_OPTION_DITHER))
+                                                ? SAIL_DITHERING_FLOYD_STEINBERG
+                                                : SAIL_DITHERING_NONE;
+
+        SAIL_TRY(sail_quantize_image_with_options(image, output_pixel_format, 0 /* max colors */, dithering, options, image_output));
+
+        return SAIL_OK;
+    }
+
+    struct sail_conversion_plan plan;
+    SAIL_TRY(init_conversion_plan(image->pixel_format, output_pixel_format, image->width, image->palette, image->gamma, options, &plan));
 
     struct sail_image *image_local;
-    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+    SAIL_TRY_OR_CLEANUP(sail_copy_image_skeleton(image, &image_local),
+                        /* cleanup */ cleanup_conversion_plan(&plan));
 
     image_local->pixel_format = output_pixel_format;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
-    const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
+    const size_t pixels_size = sail_pixels_size(image_local->height, image_local->bytes_per_line, image_local->pixel_format);
     SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
-                        /* cleanup */ sail_destroy_image(image_local));
+                        /* cleanup */ sail_destroy_image(image_local), cleanup_conversion_plan(&plan));
+
+    SAIL_TRY_OR_CLEANUP(conversion_impl(&plan, image, image_local),
+                        /* cleanup */ sail_destroy_image(image_local), cleanup_conversion_plan(&plan));
 
-    SAIL_TRY_OR_CLEANUP(conversion_impl(image, image_local, pixel_consumer, r, g, b, a, options),
-                        /* cleanup */ sail_destroy_image(image_local));
+    cleanup_conversion_plan(&plan);
 
     *image_output = image_local;
 
@@ -849,32 +1369,214 @@ sail_status_t sail_update_image_with_options(struct sail_image *image,
 
     SAIL_TRY(sail_check_image_valid(image));
 
-    int r, g, b, a;
-    pixel_consumer_t pixel_consumer;
-    SAIL_TRY(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &pixel_consumer, &r, &g, &b, &a));
+    struct sail_conversion_plan plan;
+    SAIL_TRY(init_conversion_plan(image->pixel_format, output_pixel_format, image->width, image->palette, image->gamma, options, &plan));
 
     if (image->pixel_format == output_pixel_format) {
+        cleanup_conversion_plan(&plan);
         return SAIL_OK;
     }
 
-    const bool new_image_fits_into_existing = sail_greater_equal_bits_per_pixel(image->pixel_format, output_pixel_format);
-
-    if (!new_image_fits_into_existing) {
-        SAIL_LOG_ERROR("Updating from %s to %s cannot be done as the output is larger than the input",
+    if (!sail_can_update(image->pixel_format, output_pixel_format)) {
+        cleanup_conversion_plan(&plan);
+        SAIL_LOG_ERROR("Updating from %s to %s cannot be done in place",
                         sail_pixel_format_to_string(image->pixel_format), sail_pixel_format_to_string(output_pixel_format));
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
     }
 
-    SAIL_TRY(conversion_impl(image, image, pixel_consumer, r, g, b, a, options));
+    SAIL_TRY_OR_CLEANUP(conversion_impl(&plan, image, image),
+                        /* cleanup */ cleanup_conversion_plan(&plan));
+
+    cleanup_conversion_plan(&plan);
 
     image->pixel_format = output_pixel_format;
 
     return SAIL_OK;
 }
 
+sail_status_t sail_alloc_conversion_plan(enum SailPixelFormat input_pixel_format,
+                                         enum SailPixelFormat output_pixel_format,
+                                         unsigned width,
+                                         const struct sail_palette *palette,
+                                         const struct sail_conversion_options *options,
+                                         struct sail_conversion_plan **plan) {
+
+    SAIL_CHECK_PTR(plan);
+
+    if (width == 0) {
+        SAIL_LOG_ERROR("Conversion plan width must be greater than zero");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if (!sail_can_convert(input_pixel_format, output_pixel_format)) {
+        SAIL_LOG_ERROR("Conversion from %s to %s is not currently supported",
+                        sail_pixel_format_to_string(input_pixel_format), sail_pixel_format_to_string(output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_conversion_plan), &ptr));
+    struct sail_conversion_plan *plan_local = ptr;
+
+    SAIL_TRY_OR_CLEANUP(init_conversion_plan(input_pixel_format, output_pixel_format, width, palette, 0 /* gamma */, options, plan_local),
+                        /* cleanup */ sail_free(plan_local));
+
+    *plan = plan_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_conversion_plan(struct sail_conversion_plan *plan) {
+
+    if (plan == NULL) {
+        return;
+    }
+
+    cleanup_conversion_plan(plan);
+    sail_free(plan);
+}
+
+sail_status_t sail_convert_image_with_plan(const struct sail_conversion_plan *plan,
+                                           const struct sail_image *image,
+                                           struct sail_image *image_output) {
+
+    SAIL_CHECK_PTR(image);
+
+    SAIL_TRY(sail_convert_rows_with_plan(plan, image, 0, image->height, image_output));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_convert_rows_with_plan(const struct sail_conversion_plan *plan,
+                                          const struct sail_image *image,
+                                          unsigned first_row,
+                                          unsigned row_count,
+                                          struct sail_image *image_output) {
+
+    SAIL_CHECK_PTR(plan);
+    SAIL_TRY(sail_check_image_skeleton_valid(image));
+    SAIL_CHECK_PTR(image->pixels);
+    SAIL_TRY(sail_check_image_skeleton_valid(image_output));
+    SAIL_CHECK_PTR(image_output->pixels);
+
+    if (image->pixel_format != plan->input_pixel_format || image_output->pixel_format != plan->output_pixel_format) {
+        SAIL_LOG_ERROR("The conversion plan from %s to %s cannot convert %s images to %s",
+                        sail_pixel_format_to_string(plan->input_pixel_format), sail_pixel_format_to_string(plan->output_pixel_format),
+                        sail_pixel_format_to_string(image->pixel_format), sail_pixel_format_to_string(image_output->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (image->width != plan->width || image_output->width != plan->width) {
+        SAIL_LOG_ERROR("The conversion plan width %u doesn't match the image widths %u and %u",
+                        plan->width, image->width, image_output->width);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if (first_row > image->height || row_count > image->height - first_row || image_output->height != image->height) {
+        SAIL_LOG_ERROR("Rows [%u; %u) are out of the image heights %u and %u",
+                        first_row, first_row + row_count, image->height, image_output->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if ((sail_is_planar(image->pixel_format) || sail_is_planar(image_output->pixel_format)) &&
+            (first_row != 0 || row_count != image->height)) {
+        SAIL_LOG_ERROR("Planar pixels can be converted only entirely");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (row_count == 0) {
+        return SAIL_OK;
+    }
+
+    struct sail_image rows = *image;
+    rows.pixels = sail_scan_line(image, first_row);
+    rows.height = row_count;
+
+    struct sail_image rows_output = *image_output;
+    rows_output.pixels = sail_scan_line(image_output, first_row);
+    rows_output.height = row_count;
+
+    SAIL_TRY(conversion_impl(plan, &rows, &rows_output));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_convert_pixels(enum SailPixelFormat input_pixel_format,
+                                  const void *input,
+                                  unsigned input_bytes_per_line,
+                                  enum SailPixelFormat output_pixel_format,
+                                  void *output,
+                                  unsigned output_bytes_per_line,
+                                  unsigned width,
+                                  unsigned height,
+                                  const struct sail_palette *palette,
+                                  const struct sail_conversion_options *options) {
+
+    if (width == 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    SAIL_TRY(check_pixels_valid(input_pixel_format, width, input, input_bytes_per_line));
+    SAIL_TRY(check_pixels_valid(output_pixel_format, width, output, output_bytes_per_line));
+
+    if (height == 0) {
+        return SAIL_OK;
+    }
+
+    struct sail_conversion_plan plan;
+    SAIL_TRY(init_conversion_plan(input_pixel_format, output_pixel_format, width, palette, 0 /* gamma */, options, &plan));
+
+    struct sail_image image;
+    wrap_pixels(input_pixel_format, width, height, input, input_bytes_per_line, &image);
+
+    struct sail_image image_output;
+    wrap_pixels(output_pixel_format, width, height, output, output_bytes_per_line, &image_output);
+
+    SAIL_TRY_OR_CLEANUP(conversion_impl(&plan, &image, &image_output),
+                        /* cleanup */ cleanup_conversion_plan(&plan));
+
+    cleanup_conversion_plan(&plan);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_convert_pixels_with_plan(const struct sail_conversion_plan *plan,
+                                            const void *input,
+                                            unsigned input_bytes_per_line,
+                                            void *output,
+                                            unsigned output_bytes_per_line,
+                                            unsigned height) {
+
+    SAIL_CHECK_PTR(plan);
+    SAIL_TRY(check_pixels_valid(plan->input_pixel_format, plan->width, input, input_bytes_per_line));
+    SAIL_TRY(check_pixels_valid(plan->output_pixel_format, plan->width, output, output_bytes_per_line));
+
+    if (height == 0) {
+        return SAIL_OK;
+    }
+
+    struct sail_image image;
+    wrap_pixels(plan->input_pixel_format, plan->width, height, input, input_bytes_per_line, &image);
+
+    struct sail_image image_output;
+    wrap_pixels(plan->output_pixel_format, plan->width, height, output, output_bytes_per_line, &image_output);
+
+    SAIL_TRY(conversion_impl(plan, &image, &image_output));
+
+    return SAIL_OK;
+}
+
 bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
 
-    /* After adding a new input pixel format, also update the switch in conversion_impl(). */
+    /* Planar pixels are converted through BPP24-YCbCr. */
+    if (sail_is_planar(input_pixel_format)) {
+        input_pixel_format = SAIL_PIXEL_FORMAT_BPP24_YCBCR;
+    }
+    if (sail_is_planar(output_pixel_format)) {
+        output_pixel_format = SAIL_PIXEL_FORMAT_BPP24_YCBCR;
+    }
+
+    /* After adding a new input pixel format, also update the switch in convert_rows(). */
     switch (input_pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
         case SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE:
@@ -911,8 +1613,17 @@ bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFor
         case SAIL_PIXEL_FORMAT_BPP64_BGRA:
         case SAIL_PIXEL_FORMAT_BPP64_ARGB:
         case SAIL_PIXEL_FORMAT_BPP64_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:
+        case SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT:
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT:
         case SAIL_PIXEL_FORMAT_BPP32_CMYK:
-        case SAIL_PIXEL_FORMAT_BPP24_YCBCR: {
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR:
+        case SAIL_PIXEL_FORMAT_BPP32_YCCK: {
             int r, g, b, a;
             pixel_consumer_t pixel_consumer;
             return verify_and_construct_rgba_indexes_silent(output_pixel_format, &pixel_consumer, &r, &g, &b, &a);
@@ -923,6 +1634,17 @@ bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFor
     }
 }
 
+bool sail_can_update(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+    /* Chroma planes are located after the Y plane and would overwrite unread pixels. */
+    if (sail_is_planar(input_pixel_format) || sail_is_planar(output_pixel_format)) {
+        return false;
+    }
+
+    return sail_can_convert(input_pixel_format, output_pixel_format) &&
+            sail_greater_equal_bits_per_pixel(input_pixel_format, output_pixel_format);
+}
+
 /* Sorted by priority. */
 static const enum SailPixelFormat GRAYSCALE_CANDIDATES[] = {
 
@@ -955,6 +1677,11 @@ static const enum SailPixelFormat GRAYSCALE_CANDIDATES[] = {
     SAIL_PIXEL_FORMAT_BPP64_BGRX,
     SAIL_PIXEL_FORMAT_BPP64_XRGB,
     SAIL_PIXEL_FORMAT_BPP64_XBGR,
+
+    SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,
+    SAIL_PIXEL_FORMAT_BPP48_RGB_HALF,
+    SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT,
+    SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT,
 };
 
 static const size_t GRAYSCALE_CANDIDATES_LENGTH = sizeof(GRAYSCALE_CANDIDATES) / sizeof(GRAYSCALE_CANDIDATES[0]);
@@ -989,8 +1716,16 @@ static const enum SailPixelFormat INDEXED_OR_FULL_COLOR_CANDIDATES[] = {
     SAIL_PIXEL_FORMAT_BPP64_XRGB,
     SAIL_PIXEL_FORMAT_BPP64_XBGR,
 
+    SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,
+    SAIL_PIXEL_FORMAT_BPP48_RGB_HALF,
+    SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT,
+    SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT,
+
     SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
     SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+
+    /* Lossy, so the last resort. */
+    SAIL_PIXEL_FORMAT_BPP8_INDEXED,
 };
 
 static const size_t INDEXED_OR_FULL_COLOR_CANDIDATES_LENGTH = sizeof(INDEXED_OR_FULL_COLOR_CANDIDATES) / sizeof(INDEXED_OR_FULL_COLOR_CANDIDATES[0]);
@@ -1040,6 +1775,72 @@ enum SailPixelFormat sail_closest_pixel_format_from_save_features(enum SailPixel
     return sail_closest_pixel_format(input_pixel_format, save_features->pixel_formats, save_features->pixel_formats_length);
 }
 
+/* Returns true if the save features have the pixel format. */
+static bool save_features_have_pixel_format(const struct sail_save_features *save_features, enum SailPixelFormat pixel_format) {
+
+    for (unsigned i = 0; i < save_features->pixel_formats_length; i++) {
+        if (save_features->pixel_formats[i] == pixel_format) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+enum SailPixelFormat sail_closest_pixel_format_from_statistics(enum SailPixelFormat input_pixel_format,
+                                                               const struct sail_image_statistics *statistics,
+                                                               const struct sail_save_features *save_features) {
+
+    if (input_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN || statistics == NULL || save_features == NULL) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    const bool bits8 = statistics->max_value == 255;
+    const bool opaque = statistics->opaque;
+    const bool grayscale = statistics->grayscale;
+    const bool indexed = bits8 && statistics->color_count > 0 && sail_can_quantize(input_pixel_format);
+
+    /* Lossless candidates sorted by their size. */
+    const struct {
+        enum SailPixelFormat pixel_format;
+        bool allowed;
+    } candidates[] = {
+        { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,        bits8 && grayscale && opaque },
+        { SAIL_PIXEL_FORMAT_BPP8_INDEXED,          indexed },
+        { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA, bits8 && grayscale },
+        { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,       !bits8 && grayscale && opaque },
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,             bits8 && opaque },
+        { SAIL_PIXEL_FORMAT_BPP24_BGR,             bits8 && opaque },
+        { SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA, !bits8 && grayscale },
+        { SAIL_PIXEL_FORMAT_BPP32_RGBA,            bits8 },
+        { SAIL_PIXEL_FORMAT_BPP32_BGRA,            bits8 },
+        { SAIL_PIXEL_FORMAT_BPP32_ARGB,            bits8 },
+        { SAIL_PIXEL_FORMAT_BPP32_ABGR,            bits8 },
+        { SAIL_PIXEL_FORMAT_BPP48_RGB,             !bits8 && opaque },
+        { SAIL_PIXEL_FORMAT_BPP48_BGR,             !bits8 && opaque },
+        { SAIL_PIXEL_FORMAT_BPP64_RGBA,            !bits8 },
+        { SAIL_PIXEL_FORMAT_BPP64_BGRA,            !bits8 },
+        { SAIL_PIXEL_FORMAT_BPP64_ARGB,            !bits8 },
+        { SAIL_PIXEL_FORMAT_BPP64_ABGR,            !bits8 },
+    };
+
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        const enum SailPixelFormat pixel_format = candidates[i].pixel_format;
+
+        if (!candidates[i].allowed || !save_features_have_pixel_format(save_features, pixel_format)) {
+            continue;
+        }
+
+        /* Indexed pixel formats are produced by quantizing. */
+        if (pixel_format == input_pixel_format || pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED
+                || sail_can_convert(input_pixel_format, pixel_format)) {
+            return pixel_format;
+        }
+    }
+
+    return sail_closest_pixel_format_from_save_features(input_pixel_format, save_features);
+}
+
 sail_status_t sail_convert_image_for_saving(const struct sail_image *image,
                                             const struct sail_save_features *save_features,
                                             struct sail_image **image_output) {
@@ -38,7 +38,10 @@ extern "C" {
 #endif
 
 struct sail_conversion_options;
+struct sail_conversion_plan;
 struct sail_image;
+struct sail_image_statistics;
+struct sail_palette;
 struct sail_save_features;
 
 /*
@@ -49,10 +52,34 @@ struct sail_save_features;
  * use sail_convert_image_with_options().
  *
  * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * BPP64-RGBA formats first, and only then to the requested output format. Conversions from
+ * grayscale and RGB-like formats into grayscale and RGB-like formats are done directly. Conversions between
+ * BPP8-GRAYSCALE, 24, 32, 48, and 64-bit RGB-like formats into 24 and 32-bit RGB-like formats
+ * that don't blend alpha use AVX2, SSSE3, or NEON instructions when the CPU supports them.
+ * In this case, X channels are filled with 255.
  *
- * The image ICC profile is not involved in the conversion procedure.
+ * Planar pixels are converted through BPP24-YCbCr. Subsampled chroma is replicated when reading
+ * and averaged over 2x2 pixels when writing.
+ *
+ * Premultiplied pixels are unpremultiplied when reading and premultiplied when writing. Conversions
+ * between straight and premultiplied RGBA or BGRA of the same depth are done directly, 8-bit ones
+ * with AVX2, SSSE3, or NEON instructions when the CPU supports them.
+ *
+ * Half-float and float pixels are clipped to [0; 1] when converting into integer pixel formats unless
+ * SAIL_CONVERSION_OPTION_TONE_MAP is set. Conversions from RGB and RGBA half-float and float formats into
+ * 8-bit and 16-bit RGB and RGBA formats, and between half-float and float, are done directly with AVX2
+ * and F16C instructions when the CPU supports them.
+ *
+ * Alpha is blended and luma is computed in gamma-encoded values unless SAIL_CONVERSION_OPTION_LINEAR_LIGHT
+ * is set. With the option, such conversions linearize pixels with lookup tables built once per the image
+ * gamma and cached.
+ *
+ * Indexed output pixel formats are produced with sail_quantize_image_with_options() with the maximum
+ * number of colors. The images are dithered with the Floyd-Steinberg algorithm when options have
+ * SAIL_CONVERSION_OPTION_DITHER.
+ *
+ * The image ICC profile is not involved in the conversion procedure. Use sail_transform_image_colors()
+ * to transform pixels between ICC profiles.
  *
  * The resulting image gets updated pixel format and bytes per line. Other properties are copied from
  * the original image.
@@ -88,8 +115,27 @@ struct sail_save_features;
  *   - SAIL_PIXEL_FORMAT_BPP64_ARGB
  *   - SAIL_PIXEL_FORMAT_BPP64_ABGR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP12_YUV420P
+ *   - SAIL_PIXEL_FORMAT_BPP12_NV12
+ *   - SAIL_PIXEL_FORMAT_BPP24_YUV444P
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP1_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP2_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP4_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP8_INDEXED
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_convert_image(const struct sail_image *image,
@@ -102,10 +148,21 @@ SAIL_EXPORT sail_status_t sail_convert_image(const struct sail_image *image,
  * Options (which may be NULL) control the conversion behavior.
  *
  * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * BPP64-RGBA formats first, and only then to the requested output format. Conversions from
+ * grayscale and RGB-like formats into grayscale and RGB-like formats are done directly. Conversions between
+ * BPP8-GRAYSCALE, 24, 32, 48, and 64-bit RGB-like formats into 24 and 32-bit RGB-like formats
+ * that don't blend alpha use AVX2, SSSE3, or NEON instructions when the CPU supports them.
+ * In this case, X channels are filled with 255.
  *
- * The image ICC profile (if any) is not involved into the conversion procedure.
+ * Planar pixels are converted through BPP24-YCbCr. Subsampled chroma is replicated when reading
+ * and averaged over 2x2 pixels when writing.
+ *
+ * Indexed output pixel formats are produced with sail_quantize_image_with_options() with the maximum
+ * number of colors. The images are dithered with the Floyd-Steinberg algorithm when options have
+ * SAIL_CONVERSION_OPTION_DITHER.
+ *
+ * The image ICC profile (if any) is not involved into the conversion procedure. Use sail_transform_image_colors()
+ * to transform pixels between ICC profiles.
  *
  * The resulting image gets updated pixel format and bytes per line. Other properties are copied from
  * the original image.
@@ -141,8 +198,27 @@ SAIL_EXPORT sail_status_t sail_convert_image(const struct sail_image *image,
  *   - SAIL_PIXEL_FORMAT_BPP64_ARGB
  *   - SAIL_PIXEL_FORMAT_BPP64_ABGR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP12_YUV420P
+ *   - SAIL_PIXEL_FORMAT_BPP12_NV12
+ *   - SAIL_PIXEL_FORMAT_BPP24_YUV444P
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP1_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP2_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP4_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP8_INDEXED
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_convert_image_with_options(const struct sail_image *image,
@@ -158,19 +234,25 @@ SAIL_EXPORT sail_status_t sail_convert_image_with_options(const struct sail_imag
  * when converting RGBA pixels to RGB. If you need to control this behavior,
  * use sail_update_image_with_options().
  *
- * Doesn't reallocate pixels. For example, when updating 100x100 BPP32-RGBA image
- * to BPP24-RGB, the resulting pixel data will have 10'000 unused bytes at the end.
+ * Converts pixels in place without temporary buffers and doesn't reallocate them. Scan lines keep
+ * their positions and bytes per line, so every scan line may have unused bytes at the end. For example,
+ * when updating 100x100 BPP32-RGBA image to BPP24-RGB, every scan line will have 100 unused bytes
+ * at the end. Use sail_can_update() to check if the pixel formats can be updated.
  *
  * The updating procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * BPP64-RGBA formats first, and only then to the requested output format. Conversions from
+ * grayscale and RGB-like formats into grayscale and RGB-like formats are done directly. Conversions between
+ * BPP8-GRAYSCALE, 24, 32, 48, and 64-bit RGB-like formats into 24 and 32-bit RGB-like formats
+ * that don't blend alpha use AVX2, SSSE3, or NEON instructions when the CPU supports them.
+ * In this case, X channels are filled with 255.
  *
- * The image ICC profile (if any) is not involved into the conversion procedure.
+ * The image ICC profile (if any) is not involved into the conversion procedure. Use sail_transform_image_colors()
+ * to transform pixels between ICC profiles.
  *
- * The image gets updated pixel format and bytes per line. Other properties stay as is.
+ * The image gets updated pixel format. Other properties stay as is.
  *
  * Allowed input pixel formats:
- *   - Anything that produces equal or smaller image except LUV and LAB which are not supported
+ *   - Anything that produces equal or smaller pixels except LUV, LAB, and planar pixel formats
  *
  * Allowed output pixel formats:
  *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
@@ -200,6 +282,16 @@ SAIL_EXPORT sail_status_t sail_convert_image_with_options(const struct sail_imag
  *   - SAIL_PIXEL_FORMAT_BPP64_ARGB
  *   - SAIL_PIXEL_FORMAT_BPP64_ABGR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
  * Returns SAIL_OK on success.
@@ -212,19 +304,25 @@ SAIL_EXPORT sail_status_t sail_update_image(struct sail_image *image, enum SailP
  *
  * Options (which may be NULL) control the conversion behavior.
  *
- * Doesn't reallocate pixels. For example, when updating 100x100 BPP32-RGBA image
- * to BPP24-RGB, the resulting pixel data will have 10'000 unused bytes at the end.
+ * Converts pixels in place without temporary buffers and doesn't reallocate them. Scan lines keep
+ * their positions and bytes per line, so every scan line may have unused bytes at the end. For example,
+ * when updating 100x100 BPP32-RGBA image to BPP24-RGB, every scan line will have 100 unused bytes
+ * at the end. Use sail_can_update() to check if the pixel formats can be updated.
  *
  * The updating procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * BPP64-RGBA formats first, and only then to the requested output format. Conversions from
+ * grayscale and RGB-like formats into grayscale and RGB-like formats are done directly. Conversions between
+ * BPP8-GRAYSCALE, 24, 32, 48, and 64-bit RGB-like formats into 24 and 32-bit RGB-like formats
+ * that don't blend alpha use AVX2, SSSE3, or NEON instructions when the CPU supports them.
+ * In this case, X channels are filled with 255.
  *
- * The image ICC profile (if any) is not involved into the conversion procedure.
+ * The image ICC profile (if any) is not involved into the conversion procedure. Use sail_transform_image_colors()
+ * to transform pixels between ICC profiles.
  *
- * The image gets updated pixel format and bytes per line. Other properties stay as is.
+ * The image gets updated pixel format. Other properties stay as is.
  *
  * Allowed input pixel formats:
- *   - Anything that produces equal or smaller image except LUV and LAB which are not supported
+ *   - Anything that produces equal or smaller pixels except LUV, LAB, and planar pixel formats
  *
  * Allowed output pixel formats:
  *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
@@ -254,6 +352,16 @@ SAIL_EXPORT sail_status_t sail_update_image(struct sail_image *image, enum SailP
  *   - SAIL_PIXEL_FORMAT_BPP64_ARGB
  *   - SAIL_PIXEL_FORMAT_BPP64_ABGR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
  * Returns SAIL_OK on success.
@@ -262,12 +370,140 @@ SAIL_EXPORT sail_status_t sail_update_image_with_options(struct sail_image *imag
                                                          enum SailPixelFormat output_pixel_format,
                                                          const struct sail_conversion_options *options);
 
+/*
+ * Allocates a new conversion plan from the input pixel format to the output pixel format
+ * for images of the specified width. The plan selects the conversion procedure and builds
+ * lookup tables once, so it can be executed many times with sail_convert_image_with_plan()
+ * and sail_convert_rows_with_plan() without repeating this work.
+ *
+ * The palette is required for indexed input pixel formats and is ignored otherwise.
+ * Its colors are captured at allocation time, so changing or freeing the palette afterwards
+ * doesn't affect the plan. Options (which may be NULL) are copied into the plan.
+ *
+ * Allowed input and output pixel formats are the same as in sail_convert_image() except indexed
+ * output pixel formats.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_conversion_plan(enum SailPixelFormat input_pixel_format,
+                                                     enum SailPixelFormat output_pixel_format,
+                                                     unsigned width,
+                                                     const struct sail_palette *palette,
+                                                     const struct sail_conversion_options *options,
+                                                     struct sail_conversion_plan **plan);
+
+/*
+ * Destroys the specified conversion plan. Does nothing if the plan is NULL.
+ */
+SAIL_EXPORT void sail_destroy_conversion_plan(struct sail_conversion_plan *plan);
+
+/*
+ * Converts the input image into the preallocated output image with the conversion plan.
+ *
+ * The input and output images must have the plan pixel formats, the plan width, and
+ * equal heights. The output image must have its pixels allocated. The image palette
+ * is not used; the plan palette is used instead.
+ *
+ * The plan is not modified, so it can be used from multiple threads simultaneously.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_convert_image_with_plan(const struct sail_conversion_plan *plan,
+                                                       const struct sail_image *image,
+                                                       struct sail_image *image_output);
+
+/*
+ * Converts the scan lines [first_row; first_row + row_count) of the input image into
+ * the same scan lines of the preallocated output image with the conversion plan. Other
+ * scan lines of the output image are left untouched.
+ *
+ * This function can be used to convert images in stripes or to split the work between
+ * threads. See sail_convert_image_with_plan() for the requirements.
+ *
+ * Planar pixels cannot be converted partially, so for planar input or output pixel formats
+ * the scan lines must cover the whole image.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_convert_rows_with_plan(const struct sail_conversion_plan *plan,
+                                                      const struct sail_image *image,
+                                                      unsigned first_row,
+                                                      unsigned row_count,
+                                                      struct sail_image *image_output);
+
+/*
+ * Converts width x height pixels from the input buffer into the output buffer. Scan lines
+ * of the buffers are input_bytes_per_line and output_bytes_per_line bytes apart, so this
+ * function can convert a range of scan lines of a larger image, or a rectangle inside it
+ * when the buffers point to its top left pixel. For pixel formats with less than 8 bits
+ * per pixel, the rectangle must start at a byte boundary.
+ *
+ * This function can be used to convert scan lines while they are still in the CPU cache
+ * right after decoding, or to split the conversion between threads of a custom scheduler.
+ *
+ * The palette is required for indexed input pixel formats and is ignored otherwise.
+ * Options (which may be NULL) control the conversion behavior.
+ *
+ * The input and output buffers must not overlap unless they are the same buffer with the same
+ * bytes per line, and the output pixel format is not larger than the input pixel format.
+ *
+ * For planar pixel formats, bytes per line is the Y plane stride, and the buffer must hold all
+ * the planes of the whole image as described in sail_planes().
+ *
+ * Allowed input and output pixel formats are the same as in sail_convert_image() except indexed
+ * output pixel formats. Use sail_alloc_conversion_plan() and sail_convert_pixels_with_plan() to convert many buffers
+ * with the same pixel formats faster.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_convert_pixels(enum SailPixelFormat input_pixel_format,
+                                              const void *input,
+                                              unsigned input_bytes_per_line,
+                                              enum SailPixelFormat output_pixel_format,
+                                              void *output,
+                                              unsigned output_bytes_per_line,
+                                              unsigned width,
+                                              unsigned height,
+                                              const struct sail_palette *palette,
+                                              const struct sail_conversion_options *options);
+
+/*
+ * Converts the specified number of scan lines of the plan width from the input buffer into
+ * the output buffer with the conversion plan. See sail_convert_pixels() for the details.
+ *
+ * The plan is not modified, so it can be used from multiple threads simultaneously.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_convert_pixels_with_plan(const struct sail_conversion_plan *plan,
+                                                        const void *input,
+                                                        unsigned input_bytes_per_line,
+                                                        void *output,
+                                                        unsigned output_bytes_per_line,
+                                                        unsigned height);
+
 /*
  * Returns true if the conversion or updating functions can convert or update from the input
  * pixel format to the output pixel format.
+ *
+ * Indexed output pixel formats need a new palette, so only sail_convert_image() and
+ * sail_convert_image_with_options() produce them. Use sail_can_quantize() to check them.
  */
 SAIL_EXPORT bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format);
 
+/*
+ * Returns true if the updating functions can update from the input pixel format to the output
+ * pixel format in place, i.e. the conversion is supported and the output pixel is not larger
+ * than the input pixel. Planar pixel formats cannot be updated.
+ *
+ * All such pairs are converted front to back within every scan line. Pixels are read entirely
+ * before writing, so writes never reach pixels that are not read yet. Conversions from grayscale
+ * and RGB-like formats into grayscale and RGB-like formats use specialized row kernels or SIMD
+ * instructions. Other conversions from indexed and up to 8-bit grayscale formats use lookup tables.
+ * Other pairs convert pixel by pixel.
+ */
+SAIL_EXPORT bool sail_can_update(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format);
+
 /*
  * Returns the closest pixel format to the input pixel format from the list.
  *
@@ -289,6 +525,21 @@ SAIL_EXPORT enum SailPixelFormat sail_closest_pixel_format(enum SailPixelFormat
 SAIL_EXPORT enum SailPixelFormat sail_closest_pixel_format_from_save_features(enum SailPixelFormat input_pixel_format,
                                                                                const struct sail_save_features *save_features);
 
+/*
+ * Returns the cheapest pixel format from the save features that keeps every pixel of an image with
+ * the statistics intact. Opaque images lose alpha, grayscale images are saved as grayscale, and images
+ * with up to SAIL_STATISTICS_MAX_COLORS colors are saved as BPP8-INDEXED if sail_can_quantize() supports
+ * the input pixel format. Falls back to sail_closest_pixel_format_from_save_features() if the save features
+ * have none of the cheaper pixel formats.
+ *
+ * Compute the statistics with sail_compute_image_statistics() or while loading with SAIL_OPTION_STATISTICS.
+ *
+ * Returns SAIL_PIXEL_FORMAT_UNKNOWN if no candidates found at all.
+ */
+SAIL_EXPORT enum SailPixelFormat sail_closest_pixel_format_from_statistics(enum SailPixelFormat input_pixel_format,
+                                                                           const struct sail_image_statistics *statistics,
+                                                                           const struct sail_save_features *save_features);
+
 /*
  * Converts the image to be suitable for saving in the output format described by the save features
  * (from the appropriate codec info).
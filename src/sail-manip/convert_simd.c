@@ -0,0 +1,446 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#ifdef SAIL_HAVE_NEON
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+/* Shuffle index to zero the output byte. Works with both pshufb and tbl. */
+static const uint8_t SHUFFLE_ZERO = 0x80;
+
+/* Fills the number of channels and the positions of the R, G, B, and A channels in a pixel, or -1. */
+static bool pixel_layout(enum SailPixelFormat pixel_format, unsigned *channels, unsigned *bytes_per_channel, int layout[4]) {
+
+    int r, g, b, a;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: { *channels = 1; *bytes_per_channel = 1; r = g = b = 0; a = -1; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: { *channels = 3; *bytes_per_channel = 1; r = 0; g = 1; b = 2; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: { *channels = 3; *bytes_per_channel = 1; r = 2; g = 1; b = 0; a = -1; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB: { *channels = 3; *bytes_per_channel = 2; r = 0; g = 1; b = 2; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP48_BGR: { *channels = 3; *bytes_per_channel = 2; r = 2; g = 1; b = 0; a = -1; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX: { *channels = 4; *bytes_per_channel = 1; r = 0; g = 1; b = 2; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX: { *channels = 4; *bytes_per_channel = 1; r = 2; g = 1; b = 0; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB: { *channels = 4; *bytes_per_channel = 1; r = 1; g = 2; b = 3; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR: { *channels = 4; *bytes_per_channel = 1; r = 3; g = 2; b = 1; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { *channels = 4; *bytes_per_channel = 1; r = 0; g = 1; b = 2; a = 3;  break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: { *channels = 4; *bytes_per_channel = 1; r = 2; g = 1; b = 0; a = 3;  break; }
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: { *channels = 4; *bytes_per_channel = 1; r = 1; g = 2; b = 3; a = 0;  break; }
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: { *channels = 4; *bytes_per_channel = 1; r = 3; g = 2; b = 1; a = 0;  break; }
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBX: { *channels = 4; *bytes_per_channel = 2; r = 0; g = 1; b = 2; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_BGRX: { *channels = 4; *bytes_per_channel = 2; r = 2; g = 1; b = 0; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_XRGB: { *channels = 4; *bytes_per_channel = 2; r = 1; g = 2; b = 3; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_XBGR: { *channels = 4; *bytes_per_channel = 2; r = 3; g = 2; b = 1; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: { *channels = 4; *bytes_per_channel = 2; r = 0; g = 1; b = 2; a = 3;  break; }
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: { *channels = 4; *bytes_per_channel = 2; r = 2; g = 1; b = 0; a = 3;  break; }
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: { *channels = 4; *bytes_per_channel = 2; r = 1; g = 2; b = 3; a = 0;  break; }
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: { *channels = 4; *bytes_per_channel = 2; r = 3; g = 2; b = 1; a = 0;  break; }
+
+        default: {
+            return false;
+        }
+    }
+
+    layout[0] = r;
+    layout[1] = g;
+    layout[2] = b;
+    layout[3] = a;
+
+    return true;
+}
+
+/*
+ * Returns the minimum number of remaining pixels in a scan line to convert the specified
+ * number of blocks without reading or writing beyond the scan line.
+ */
+static unsigned min_pixels_for_blocks(const struct simd_converter *converter, unsigned blocks, unsigned read_span, unsigned write_span) {
+
+    const unsigned input_bytes_per_pixel = converter->input_channels * converter->input_bytes_per_channel;
+
+    const unsigned read_pixels  = (read_span  + input_bytes_per_pixel - 1) / input_bytes_per_pixel;
+    const unsigned write_pixels = (write_span + converter->output_channels - 1) / converter->output_channels;
+
+    return SAIL_MAX(blocks * converter->pixels_per_block, SAIL_MAX(read_pixels, write_pixels));
+}
+
+/* Converts pixels one by one. Every pixel is read entirely before writing to support converting in place. */
+static void convert_row_c(const struct simd_converter *converter, const void *input, void *output, unsigned width) {
+
+    uint8_t *scan_output = output;
+    uint8_t pixel[4];
+
+    if (converter->input_bytes_per_channel == 1) {
+        const uint8_t *scan_input = input;
+
+        for (unsigned column = 0; column < width; column++) {
+            for (unsigned c = 0; c < converter->output_channels; c++) {
+                pixel[c] = (converter->map[c] >= 0) ? scan_input[converter->map[c]] : 255;
+            }
+
+            memcpy(scan_output, pixel, converter->output_channels);
+
+            scan_input  += converter->input_channels;
+            scan_output += converter->output_channels;
+        }
+    } else {
+        const uint16_t *scan_input = input;
+
+        for (unsigned column = 0; column < width; column++) {
+            for (unsigned c = 0; c < converter->output_channels; c++) {
+                pixel[c] = (converter->map[c] >= 0) ? (uint8_t)(scan_input[converter->map[c]] / 257) : 255;
+            }
+
+            memcpy(scan_output, pixel, converter->output_channels);
+
+            scan_input  += converter->input_channels;
+            scan_output += converter->output_channels;
+        }
+    }
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+/* Divides 16-bit values by 257 exactly as (v * 65281) >> 24 and packs them into bytes. */
+SAIL_TARGET("ssse3")
+static inline __m128i pack_div257_ssse3(__m128i lo, __m128i hi) {
+
+    const __m128i multiplier = _mm_set1_epi16((short)65281);
+
+    lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, multiplier), 8);
+    hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, multiplier), 8);
+
+    return _mm_packus_epi16(lo, hi);
+}
+
+SAIL_TARGET("avx2")
+static inline __m256i pack_div257_avx2(__m256i lo, __m256i hi) {
+
+    const __m256i multiplier = _mm256_set1_epi16((short)65281);
+
+    lo = _mm256_srli_epi16(_mm256_mulhi_epu16(lo, multiplier), 8);
+    hi = _mm256_srli_epi16(_mm256_mulhi_epu16(hi, multiplier), 8);
+
+    /* Packs within 128-bit lanes, so every lane gets its own block. */
+    return _mm256_packus_epi16(lo, hi);
+}
+
+SAIL_TARGET("ssse3")
+static void convert_row8_ssse3(const struct simd_converter *converter, const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = converter->pixels_per_block * converter->input_channels;
+    const unsigned output_step = converter->pixels_per_block * converter->output_channels;
+    const unsigned min_pixels  = min_pixels_for_blocks(converter, 1, 16, 16);
+
+    const __m128i shuffle = _mm_loadu_si128((const __m128i *)converter->shuffle);
+    const __m128i fill    = _mm_loadu_si128((const __m128i *)converter->fill);
+
+    unsigned column = 0;
+
+    for (; width - column >= min_pixels; column += converter->pixels_per_block) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)scan_input);
+
+        _mm_storeu_si128((__m128i *)scan_output, _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), fill));
+
+        scan_input  += input_step;
+        scan_output += output_step;
+    }
+
+    convert_row_c(converter, scan_input, scan_output, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void convert_row16_ssse3(const struct simd_converter *converter, const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = converter->pixels_per_block * converter->input_channels * 2;
+    const unsigned output_step = converter->pixels_per_block * converter->output_channels;
+    const unsigned min_pixels  = min_pixels_for_blocks(converter, 1, 32, 16);
+
+    const __m128i shuffle = _mm_loadu_si128((const __m128i *)converter->shuffle);
+    const __m128i fill    = _mm_loadu_si128((const __m128i *)converter->fill);
+
+    unsigned column = 0;
+
+    for (; width - column >= min_pixels; column += converter->pixels_per_block) {
+        const __m128i pixels = pack_div257_ssse3(_mm_loadu_si128((const __m128i *)scan_input),
+                                                    _mm_loadu_si128((const __m128i *)(scan_input + 16)));
+
+        _mm_storeu_si128((__m128i *)scan_output, _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), fill));
+
+        scan_input  += input_step;
+        scan_output += output_step;
+    }
+
+    convert_row_c(converter, scan_input, scan_output, width - column);
+}
+
+SAIL_TARGET("avx2")
+static inline __m256i load_two_blocks_avx2(const uint8_t *first, const uint8_t *second) {
+
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)first)),
+                                    _mm_loadu_si128((const __m128i *)second), 1);
+}
+
+SAIL_TARGET("avx2")
+static inline void store_two_blocks_avx2(__m256i pixels, uint8_t *scan_output, unsigned output_step) {
+
+    if (output_step == 16) {
+        _mm256_storeu_si256((__m256i *)scan_output, pixels);
+    } else {
+        _mm_storeu_si128((__m128i *)scan_output, _mm256_castsi256_si128(pixels));
+        _mm_storeu_si128((__m128i *)(scan_output + output_step), _mm256_extracti128_si256(pixels, 1));
+    }
+}
+
+SAIL_TARGET("avx2")
+static void convert_row8_avx2(const struct simd_converter *converter, const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = converter->pixels_per_block * converter->input_channels;
+    const unsigned output_step = converter->pixels_per_block * converter->output_channels;
+    const unsigned min_pixels  = min_pixels_for_blocks(converter, 2, input_step + 16, output_step + 16);
+
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)converter->shuffle));
+    const __m256i fill    = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)converter->fill));
+
+    unsigned column = 0;
+
+    for (; width - column >= min_pixels; column += 2 * converter->pixels_per_block) {
+        const __m256i pixels = load_two_blocks_avx2(scan_input, scan_input + input_step);
+
+        store_two_blocks_avx2(_mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle), fill), scan_output, output_step);
+
+        scan_input  += 2 * input_step;
+        scan_output += 2 * output_step;
+    }
+
+    convert_row8_ssse3(converter, scan_input, scan_output, width - column);
+}
+
+SAIL_TARGET("avx2")
+static void convert_row16_avx2(const struct simd_converter *converter, const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = converter->pixels_per_block * converter->input_channels * 2;
+    const unsigned output_step = converter->pixels_per_block * converter->output_channels;
+    const unsigned min_pixels  = min_pixels_for_blocks(converter, 2, input_step + 32, output_step + 16);
+
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)converter->shuffle));
+    const __m256i fill    = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)converter->fill));
+
+    unsigned column = 0;
+
+    for (; width - column >= min_pixels; column += 2 * converter->pixels_per_block) {
+        const __m256i lo = load_two_blocks_avx2(scan_input,      scan_input + input_step);
+        const __m256i hi = load_two_blocks_avx2(scan_input + 16, scan_input + input_step + 16);
+
+        const __m256i pixels = pack_div257_avx2(lo, hi);
+
+        store_two_blocks_avx2(_mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle), fill), scan_output, output_step);
+
+        scan_input  += 2 * input_step;
+        scan_output += 2 * output_step;
+    }
+
+    convert_row16_ssse3(converter, scan_input, scan_output, width - column);
+}
+#endif
+
+#ifdef SAIL_HAVE_NEON
+/* Divides 16-bit values by 257 exactly as (v * 65281) >> 24 and packs them into bytes. */
+static inline uint8x16_t pack_div257_neon(uint16x8_t lo, uint16x8_t hi) {
+
+    const uint16x4_t multiplier = vdup_n_u16(65281);
+
+    lo = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(lo), multiplier), 16), vshrn_n_u32(vmull_u16(vget_high_u16(lo), multiplier), 16));
+    hi = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(hi), multiplier), 16), vshrn_n_u32(vmull_u16(vget_high_u16(hi), multiplier), 16));
+
+    return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+}
+
+static void convert_row8_neon(const struct simd_converter *converter, const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = converter->pixels_per_block * converter->input_channels;
+    const unsigned output_step = converter->pixels_per_block * converter->output_channels;
+    const unsigned min_pixels  = min_pixels_for_blocks(converter, 1, 16, 16);
+
+    const uint8x16_t shuffle = vld1q_u8(converter->shuffle);
+    const uint8x16_t fill    = vld1q_u8(converter->fill);
+
+    unsigned column = 0;
+
+    for (; width - column >= min_pixels; column += converter->pixels_per_block) {
+        vst1q_u8(scan_output, vorrq_u8(vqtbl1q_u8(vld1q_u8(scan_input), shuffle), fill));
+
+        scan_input  += input_step;
+        scan_output += output_step;
+    }
+
+    convert_row_c(converter, scan_input, scan_output, width - column);
+}
+
+static void convert_row16_neon(const struct simd_converter *converter, const void *input, void *output, unsigned width) {
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = converter->pixels_per_block * converter->input_channels * 2;
+    const unsigned output_step = converter->pixels_per_block * converter->output_channels;
+    const unsigned min_pixels  = min_pixels_for_blocks(converter, 1, 32, 16);
+
+    const uint8x16_t shuffle = vld1q_u8(converter->shuffle);
+    const uint8x16_t fill    = vld1q_u8(converter->fill);
+
+    unsigned column = 0;
+
+    for (; width - column >= min_pixels; column += converter->pixels_per_block) {
+        const uint8x16_t pixels = pack_div257_neon(vld1q_u16((const uint16_t *)scan_input),
+                                                    vld1q_u16((const uint16_t *)(scan_input + 16)));
+
+        vst1q_u8(scan_output, vorrq_u8(vqtbl1q_u8(pixels, shuffle), fill));
+
+        scan_input  += input_step;
+        scan_output += output_step;
+    }
+
+    convert_row_c(converter, scan_input, scan_output, width - column);
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+bool simd_converter_init(enum SailPixelFormat input_pixel_format,
+                            enum SailPixelFormat output_pixel_format,
+                            const struct sail_conversion_options *options,
+                            struct simd_converter *converter) {
+
+    int input_layout[4];
+    int output_layout[4];
+    unsigned output_bytes_per_channel;
+
+    if (!pixel_layout(input_pixel_format, &converter->input_channels, &converter->input_bytes_per_channel, input_layout) ||
+            !pixel_layout(output_pixel_format, &converter->output_channels, &output_bytes_per_channel, output_layout)) {
+        return false;
+    }
+
+    if (converter->output_channels < 3 || output_bytes_per_channel != 1) {
+        return false;
+    }
+
+    /* Blending alpha into the background is done by the generic conversion. */
+    if (input_layout[3] >= 0 && output_layout[3] < 0 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
+        return false;
+    }
+
+    /* Unused X channels are filled with 255. */
+    for (unsigned c = 0; c < 4; c++) {
+        converter->map[c] = -1;
+    }
+
+    for (unsigned c = 0; c < 3; c++) {
+        converter->map[output_layout[c]] = input_layout[c];
+    }
+
+    if (output_layout[3] >= 0) {
+        converter->map[output_layout[3]] = input_layout[3];
+    }
+
+    converter->pixels_per_block = SAIL_MIN(16 / converter->input_channels, 16 / converter->output_channels);
+
+    for (unsigned i = 0; i < 16; i++) {
+        const unsigned pixel   = i / converter->output_channels;
+        const unsigned channel = i % converter->output_channels;
+
+        if (pixel < converter->pixels_per_block) {
+            if (converter->map[channel] >= 0) {
+                converter->shuffle[i] = (uint8_t)(pixel * converter->input_channels + converter->map[channel]);
+                converter->fill[i]    = 0;
+            } else {
+                converter->shuffle[i] = SHUFFLE_ZERO;
+                converter->fill[i]    = 255;
+            }
+        } else if (converter->input_bytes_per_channel == 1 && converter->input_channels == converter->output_channels) {
+            /*
+             * Bytes beyond the block are overwritten by the next block. When converting in place,
+             * they still belong to the unconverted input, so keep them intact.
+             */
+            converter->shuffle[i] = (uint8_t)i;
+            converter->fill[i]    = 0;
+        } else {
+            converter->shuffle[i] = SHUFFLE_ZERO;
+            converter->fill[i]    = 0;
+        }
+    }
+
+    const bool input16 = converter->input_bytes_per_channel == 2;
+
+    converter->convert_row = convert_row_c;
+
+#if defined SAIL_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        converter->convert_row = input16 ? convert_row16_avx2 : convert_row8_avx2;
+    } else if (cpu_has_ssse3()) {
+        converter->convert_row = input16 ? convert_row16_ssse3 : convert_row8_ssse3;
+    }
+#elif defined SAIL_HAVE_NEON
+    converter->convert_row = input16 ? convert_row16_neon : convert_row8_neon;
+#else
+    (void)input16;
+#endif
+
+    return true;
+}
@@ -0,0 +1,78 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CONVERT_SIMD_H
+#define SAIL_CONVERT_SIMD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/pixel.h>
+
+struct sail_conversion_options;
+
+/*
+ * Scan line converter from 8-bit and 16-bit RGB-like pixel formats and BPP8-GRAYSCALE
+ * to 8-bit RGB-like pixel formats. Every output channel is either an input channel or 255.
+ * 16-bit input channels are divided by 257 with truncation exactly like the generic conversion does.
+ *
+ * Uses AVX2, SSSE3, or NEON depending on the CPU, and plain C otherwise.
+ */
+struct simd_converter {
+
+    /* Converts a scan line. Input and output may point to the same memory when converting in place. */
+    void (*convert_row)(const struct simd_converter *converter, const void *input, void *output, unsigned width);
+
+    /* 1, 3, or 4 input channels of 1 or 2 bytes each. */
+    unsigned input_channels;
+    unsigned input_bytes_per_channel;
+
+    /* 3 or 4 output channels of 1 byte each. */
+    unsigned output_channels;
+
+    /* The number of pixels converted with a single 16-byte shuffle. */
+    unsigned pixels_per_block;
+
+    /* Input channel index for every output channel or -1 to output 255. */
+    int map[4];
+
+    /* Byte shuffle of a block and a mask to OR the shuffled bytes with. */
+    uint8_t shuffle[16];
+    uint8_t fill[16];
+};
+
+/*
+ * Initializes the converter if the conversion is supported by it. Conversions that blend alpha
+ * into a background are not supported.
+ *
+ * Returns true if the converter is initialized.
+ */
+SAIL_HIDDEN bool simd_converter_init(enum SailPixelFormat input_pixel_format,
+                                        enum SailPixelFormat output_pixel_format,
+                                        const struct sail_conversion_options *options,
+                                        struct simd_converter *converter);
+
+#endif
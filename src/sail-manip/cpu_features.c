@@ -0,0 +1,98 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+/*
+ * Public functions.
+ */
+
+#ifdef SAIL_HAVE_X86_SIMD
+#ifdef _MSC_VER
+bool cpu_has_ssse3(void) {
+
+    int info[4];
+    __cpuid(info, 1);
+
+    return (info[2] & (1 << 9)) != 0;
+}
+
+bool cpu_has_avx2(void) {
+
+    int info[4];
+    __cpuid(info, 1);
+
+    /* The OS must save the AVX registers. */
+    const int osxsave_and_avx = (1 << 27) | (1 << 28);
+
+    if ((info[2] & osxsave_and_avx) != osxsave_and_avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+
+    return (info[1] & (1 << 5)) != 0;
+}
+
+bool cpu_has_f16c(void) {
+
+    int info[4];
+    __cpuid(info, 1);
+
+    /* The OS must save the AVX registers. */
+    const int osxsave_avx_and_f16c = (1 << 27) | (1 << 28) | (1 << 29);
+
+    return (info[2] & osxsave_avx_and_f16c) == osxsave_avx_and_f16c && (_xgetbv(0) & 6) == 6;
+}
+#else
+bool cpu_has_ssse3(void) {
+
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+}
+
+bool cpu_has_avx2(void) {
+
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool cpu_has_f16c(void) {
+
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("f16c");
+}
+#endif
+#endif
@@ -0,0 +1,60 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CPU_FEATURES_H
+#define SAIL_CPU_FEATURES_H
+
+#include <stdbool.h>
+
+#include <sail-common/export.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    /*
+     * Functions with SIMD intrinsics are compiled for the instruction set with target
+     * attributes and selected at runtime. MSVC compiles intrinsics without any flags.
+     */
+    #if defined(__GNUC__) || defined(__clang__)
+        #define SAIL_TARGET(t) __attribute__((target(t)))
+    #else
+        #define SAIL_TARGET(t)
+    #endif
+
+/*
+ * Returns true if the CPU supports SSSE3.
+ */
+SAIL_HIDDEN bool cpu_has_ssse3(void);
+
+/*
+ * Returns true if the CPU supports AVX2 and the OS saves the AVX registers.
+ */
+SAIL_HIDDEN bool cpu_has_avx2(void);
+
+/*
+ * Returns true if the CPU supports F16C half-float conversions and the OS saves the AVX registers.
+ */
+SAIL_HIDDEN bool cpu_has_f16c(void);
+#endif
+
+#endif
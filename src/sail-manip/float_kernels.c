@@ -0,0 +1,292 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+/* Converts pixels one by one. Also converts the pixels left after the SIMD loop. */
+static void float_row_c(const void *input, void *output, unsigned width, unsigned channels, bool half,
+                        unsigned output_bytes, bool tone_map, float inv_white_squared) {
+
+    const uint16_t *input16  = input;
+    const float    *input32  = input;
+          uint8_t  *output8  = output;
+          uint16_t *output16 = output;
+
+    const float max = (output_bytes == 1) ? 255.0f : 65535.0f;
+
+    for (unsigned column = 0; column < width; column++) {
+        float values[4];
+
+        for (unsigned c = 0; c < channels; c++) {
+            values[c] = half ? half_to_float(input16[c]) : input32[c];
+        }
+
+        if (tone_map) {
+            const float factor = tone_map_factor(values[0], values[1], values[2], inv_white_squared);
+
+            values[0] *= factor;
+            values[1] *= factor;
+            values[2] *= factor;
+        }
+
+        for (unsigned c = 0; c < channels; c++) {
+            if (output_bytes == 1) {
+                output8[c] = (uint8_t)float_to_uint(values[c], max);
+            } else {
+                output16[c] = (uint16_t)float_to_uint(values[c], max);
+            }
+        }
+
+        input16  += channels;
+        input32  += channels;
+        output8  += channels;
+        output16 += channels;
+    }
+}
+
+static void float_row(const void *input, void *output, unsigned width, const struct sail_conversion_options *options,
+                        unsigned channels, bool half, unsigned output_bytes) {
+
+    float inv_white_squared = 0;
+    const bool tone_map = tone_map_requested(options, &inv_white_squared);
+
+    float_row_c(input, output, width, channels, half, output_bytes, tone_map, inv_white_squared);
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+/*
+ * Converts 8 values per iteration. Every float operation matches float_row_c(), so the results are identical.
+ * Scan lines are processed front to back, and every block is read entirely before writing, so in-place
+ * conversions never overwrite unread pixels.
+ */
+SAIL_TARGET("avx2,f16c")
+static void float_row_avx2(const void *input, void *output, unsigned width, const struct sail_conversion_options *options,
+                            unsigned channels, bool half, unsigned output_bytes) {
+
+    float inv_white_squared = 0;
+    const bool tone_map = tone_map_requested(options, &inv_white_squared);
+
+    /* Tone mapping needs whole pixels in a register. RGB pixels don't fit evenly. */
+    if (tone_map && channels != 4) {
+        float_row_c(input, output, width, channels, half, output_bytes, tone_map, inv_white_squared);
+        return;
+    }
+
+    const uint16_t *input16  = input;
+    const float    *input32  = input;
+          uint8_t  *output8  = output;
+          uint16_t *output16 = output;
+
+    /* Only whole pixels are converted here: 2 RGBA pixels per vector, or 8 RGB pixels per 3 vectors. */
+    const size_t count      = (size_t)width * channels;
+    const size_t simd_count = count - count % (channels == 4 ? 8 : 24);
+
+    const __m256 zero                = _mm256_setzero_ps();
+    const __m256 one                 = _mm256_set1_ps(1.0f);
+    const __m256 rounding            = _mm256_set1_ps(0.5f);
+    const __m256 max                 = _mm256_set1_ps(output_bytes == 1 ? 255.0f : 65535.0f);
+    const __m256 inv_white_squared_v = _mm256_set1_ps(inv_white_squared);
+
+    for (size_t i = 0; i < simd_count; i += 8) {
+        __m256 values = half ? _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(input16 + i)))
+                                : _mm256_loadu_ps(input32 + i);
+
+        if (tone_map) {
+            /* max(R, G, B) in the color channels of both pixels, in the same order as tone_map_factor() does. */
+            const __m256 gbra   = _mm256_permute_ps(values, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m256 brga   = _mm256_permute_ps(values, _MM_SHUFFLE(3, 1, 0, 2));
+            const __m256 m      = _mm256_max_ps(_mm256_max_ps(_mm256_max_ps(values, gbra), brga), zero);
+            const __m256 factor = _mm256_div_ps(_mm256_add_ps(one, _mm256_mul_ps(m, inv_white_squared_v)), _mm256_add_ps(one, m));
+
+            /* Keep alpha. */
+            values = _mm256_blend_ps(_mm256_mul_ps(values, factor), values, 0x88);
+        }
+
+        values = _mm256_min_ps(_mm256_max_ps(values, zero), one);
+
+        const __m256i ints  = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(values, max), rounding));
+        const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(ints), _mm256_extracti128_si256(ints, 1));
+
+        if (output_bytes == 1) {
+            _mm_storel_epi64((__m128i *)(output8 + i), _mm_packus_epi16(words, words));
+        } else {
+            _mm_storeu_si128((__m128i *)(output16 + i), words);
+        }
+    }
+
+    const void *input_left = half ? (const void *)(input16 + simd_count) : (const void *)(input32 + simd_count);
+    void *output_left      = (output_bytes == 1) ? (void *)(output8 + simd_count) : (void *)(output16 + simd_count);
+
+    float_row_c(input_left, output_left, width - (unsigned)(simd_count / channels), channels, half, output_bytes, tone_map, inv_white_squared);
+}
+#endif
+
+/* Conversions between half-float and float keep values outside of [0; 1]. */
+static void half_to_float_row_c(const uint16_t *input, float *output, size_t count) {
+
+    for (size_t i = 0; i < count; i++) {
+        output[i] = half_to_float(input[i]);
+    }
+}
+
+static void float_to_half_row_c(const float *input, uint16_t *output, size_t count) {
+
+    for (size_t i = 0; i < count; i++) {
+        output[i] = float_to_half(input[i]);
+    }
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+SAIL_TARGET("avx2,f16c")
+static void half_to_float_row_f16c(const uint16_t *input, float *output, size_t count) {
+
+    size_t i = 0;
+
+    for (; count - i >= 8; i += 8) {
+        _mm256_storeu_ps(output + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(input + i))));
+    }
+
+    half_to_float_row_c(input + i, output + i, count - i);
+}
+
+SAIL_TARGET("avx2,f16c")
+static void float_to_half_row_f16c(const float *input, uint16_t *output, size_t count) {
+
+    size_t i = 0;
+
+    for (; count - i >= 8; i += 8) {
+        _mm_storeu_si128((__m128i *)(output + i), _mm256_cvtps_ph(_mm256_loadu_ps(input + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    float_to_half_row_c(input + i, output + i, count - i);
+}
+#endif
+
+#define DEFINE_HALF_FLOAT_KERNEL(name, impl, input_type, output_type, channels)                                \
+    static void name(const void *input, void *output, unsigned width, const struct sail_conversion_options *options) { \
+        (void)options;                                                                                          \
+        impl((const input_type *)input, (output_type *)output, (size_t)width * channels);                       \
+    }
+
+DEFINE_HALF_FLOAT_KERNEL(half_to_float_rgb_c,   half_to_float_row_c, uint16_t, float,    3)
+DEFINE_HALF_FLOAT_KERNEL(half_to_float_rgba_c,  half_to_float_row_c, uint16_t, float,    4)
+DEFINE_HALF_FLOAT_KERNEL(float_to_half_rgb_c,   float_to_half_row_c, float,    uint16_t, 3)
+DEFINE_HALF_FLOAT_KERNEL(float_to_half_rgba_c,  float_to_half_row_c, float,    uint16_t, 4)
+
+#ifdef SAIL_HAVE_X86_SIMD
+DEFINE_HALF_FLOAT_KERNEL(half_to_float_rgb_f16c,  half_to_float_row_f16c, uint16_t, float,    3)
+DEFINE_HALF_FLOAT_KERNEL(half_to_float_rgba_f16c, half_to_float_row_f16c, uint16_t, float,    4)
+DEFINE_HALF_FLOAT_KERNEL(float_to_half_rgb_f16c,  float_to_half_row_f16c, float,    uint16_t, 3)
+DEFINE_HALF_FLOAT_KERNEL(float_to_half_rgba_f16c, float_to_half_row_f16c, float,    uint16_t, 4)
+#endif
+
+/* Input and output pixel formats, number of channels, half-float input, and output bytes per channel. */
+#define FLOAT_KERNELS(X)                                \
+    X(BPP48_RGB_HALF,    BPP24_RGB,  3, true,  1)       \
+    X(BPP48_RGB_HALF,    BPP48_RGB,  3, true,  2)       \
+    X(BPP64_RGBA_HALF,   BPP32_RGBA, 4, true,  1)       \
+    X(BPP64_RGBA_HALF,   BPP64_RGBA, 4, true,  2)       \
+    X(BPP96_RGB_FLOAT,   BPP24_RGB,  3, false, 1)       \
+    X(BPP96_RGB_FLOAT,   BPP48_RGB,  3, false, 2)       \
+    X(BPP128_RGBA_FLOAT, BPP32_RGBA, 4, false, 1)       \
+    X(BPP128_RGBA_FLOAT, BPP64_RGBA, 4, false, 2)
+
+#define DEFINE_FLOAT_KERNEL(input, output, channels, half, output_bytes)                                       \
+    static void float_row_##input##_to_##output(const void *input_scan, void *output_scan, unsigned width,    \
+                                                const struct sail_conversion_options *options) {               \
+        float_row(input_scan, output_scan, width, options, channels, half, output_bytes);                      \
+    }
+
+FLOAT_KERNELS(DEFINE_FLOAT_KERNEL)
+
+#ifdef SAIL_HAVE_X86_SIMD
+#define DEFINE_FLOAT_KERNEL_AVX2(input, output, channels, half, output_bytes)                                  \
+    SAIL_TARGET("avx2,f16c")                                                                                   \
+    static void float_row_##input##_to_##output##_avx2(const void *input_scan, void *output_scan,             \
+                                                        unsigned width,                                        \
+                                                        const struct sail_conversion_options *options) {       \
+        float_row_avx2(input_scan, output_scan, width, options, channels, half, output_bytes);                 \
+    }
+
+FLOAT_KERNELS(DEFINE_FLOAT_KERNEL_AVX2)
+#endif
+
+/*
+ * Public functions.
+ */
+
+row_kernel_t find_float_kernel(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+#ifdef SAIL_HAVE_X86_SIMD
+    const bool use_avx2 = cpu_has_avx2() && cpu_has_f16c();
+
+    #define FIND_FLOAT_KERNEL(input, output, channels, half, output_bytes)                                     \
+        if (input_pixel_format == SAIL_PIXEL_FORMAT_##input && output_pixel_format == SAIL_PIXEL_FORMAT_##output) { \
+            return use_avx2 ? float_row_##input##_to_##output##_avx2 : float_row_##input##_to_##output;         \
+        }
+#else
+    #define FIND_FLOAT_KERNEL(input, output, channels, half, output_bytes)                                     \
+        if (input_pixel_format == SAIL_PIXEL_FORMAT_##input && output_pixel_format == SAIL_PIXEL_FORMAT_##output) { \
+            return float_row_##input##_to_##output;                                                             \
+        }
+#endif
+
+    FLOAT_KERNELS(FIND_FLOAT_KERNEL)
+
+    #undef FIND_FLOAT_KERNEL
+
+#ifdef SAIL_HAVE_X86_SIMD
+    const bool use_f16c = cpu_has_f16c();
+
+    #define SELECT_HALF_FLOAT_KERNEL(name) (use_f16c ? name##_f16c : name##_c)
+#else
+    #define SELECT_HALF_FLOAT_KERNEL(name) name##_c
+#endif
+
+    if (input_pixel_format == SAIL_PIXEL_FORMAT_BPP48_RGB_HALF && output_pixel_format == SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT) {
+        return SELECT_HALF_FLOAT_KERNEL(half_to_float_rgb);
+    } else if (input_pixel_format == SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF && output_pixel_format == SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT) {
+        return SELECT_HALF_FLOAT_KERNEL(half_to_float_rgba);
+    } else if (input_pixel_format == SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT && output_pixel_format == SAIL_PIXEL_FORMAT_BPP48_RGB_HALF) {
+        return SELECT_HALF_FLOAT_KERNEL(float_to_half_rgb);
+    } else if (input_pixel_format == SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT && output_pixel_format == SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF) {
+        return SELECT_HALF_FLOAT_KERNEL(float_to_half_rgba);
+    }
+
+    #undef SELECT_HALF_FLOAT_KERNEL
+
+    return NULL;
+}
@@ -0,0 +1,45 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#ifndef SAIL_FLOAT_KERNELS_H
+#define SAIL_FLOAT_KERNELS_H
+
+#include <sail-common/export.h>
+#include <sail-common/pixel.h>
+
+#include <sail-manip/row_kernels.h>
+
+/*
+ * Returns a row kernel from half-float or float RGB and RGBA pixel formats into 8-bit or 16-bit
+ * integer pixel formats with the same channels, e.g. BPP64-RGBA-HALF into BPP32-RGBA, or between
+ * half-float and float pixel formats with the same channels. Returns NULL if there is no such kernel.
+ *
+ * Into integers, color values are clipped to [0; 1], or tone mapped with SAIL_CONVERSION_OPTION_TONE_MAP,
+ * and rounded. Between half-float and float, values are kept as is. The kernels use AVX2 and F16C
+ * instructions when the CPU supports them. Tone mapping RGB pixels is done in plain C. All the
+ * implementations produce identical results.
+ */
+SAIL_HIDDEN row_kernel_t find_float_kernel(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format);
+
+#endif
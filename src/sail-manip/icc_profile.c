@@ -0,0 +1,359 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+#define ICC_SIGNATURE(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+/* The header is followed by the tag count and 12-byte tag entries. */
+static const size_t ICC_HEADER_SIZE = 128;
+static const size_t ICC_TAG_ENTRY_SIZE = 12;
+
+static inline uint16_t read_be16(const uint8_t *data) {
+
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static inline uint32_t read_be32(const uint8_t *data) {
+
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+static inline double read_s15_fixed16(const uint8_t *data) {
+
+    return (double)(int32_t)read_be32(data) / 65536.0;
+}
+
+static const uint8_t *find_tag(const uint8_t *data, size_t data_size, uint32_t signature, uint32_t *tag_size) {
+
+    const uint32_t tag_count = read_be32(data + ICC_HEADER_SIZE);
+
+    for (uint32_t i = 0; i < tag_count; i++) {
+        const uint8_t *entry = data + ICC_HEADER_SIZE + 4 + (size_t)i * ICC_TAG_ENTRY_SIZE;
+
+        if (read_be32(entry) != signature) {
+            continue;
+        }
+
+        const uint32_t offset = read_be32(entry + 4);
+        const uint32_t size   = read_be32(entry + 8);
+
+        if (offset > data_size || size > data_size - offset) {
+            SAIL_LOG_ERROR("ICC: Tag %c%c%c%c is out of the profile bounds",
+                            entry[0], entry[1], entry[2], entry[3]);
+            return NULL;
+        }
+
+        *tag_size = size;
+        return data + offset;
+    }
+
+    return NULL;
+}
+
+static sail_status_t parse_xyz(const uint8_t *data, size_t data_size, uint32_t signature, double xyz[3]) {
+
+    uint32_t tag_size;
+    const uint8_t *tag = find_tag(data, data_size, signature, &tag_size);
+
+    if (tag == NULL) {
+        SAIL_LOG_ERROR("ICC: Only matrix/TRC profiles are supported");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    if (tag_size < 20 || read_be32(tag) != ICC_SIGNATURE('X', 'Y', 'Z', ' ')) {
+        SAIL_LOG_ERROR("ICC: Invalid colorant tag");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    for (unsigned i = 0; i < 3; i++) {
+        xyz[i] = read_s15_fixed16(tag + 8 + i * 4);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t parse_curve(const uint8_t *data, size_t data_size, uint32_t signature, struct icc_curve *curve) {
+
+    memset(curve, 0, sizeof(*curve));
+
+    uint32_t tag_size;
+    const uint8_t *tag = find_tag(data, data_size, signature, &tag_size);
+
+    if (tag == NULL) {
+        SAIL_LOG_ERROR("ICC: Only matrix/TRC profiles are supported");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    if (tag_size < 12) {
+        SAIL_LOG_ERROR("ICC: Curve tag is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    switch (read_be32(tag)) {
+        case ICC_SIGNATURE('c', 'u', 'r', 'v'): {
+            const uint32_t entries = read_be32(tag + 8);
+
+            if (entries > (tag_size - 12) / 2) {
+                SAIL_LOG_ERROR("ICC: Curve table is truncated");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+            }
+
+            if (entries == 0) {
+                curve->type = ICC_CURVE_IDENTITY;
+            } else if (entries == 1) {
+                /* u8Fixed8 gamma. */
+                curve->type          = ICC_CURVE_PARAMETRIC;
+                curve->function_type = 0;
+                curve->params[0]     = read_be16(tag + 12) / 256.0;
+            } else {
+                curve->type       = ICC_CURVE_TABLE;
+                curve->table      = tag + 12;
+                curve->table_size = entries;
+            }
+
+            return SAIL_OK;
+        }
+        case ICC_SIGNATURE('p', 'a', 'r', 'a'): {
+            static const unsigned PARAMS_COUNT[] = { 1, 3, 4, 5, 7 };
+
+            const unsigned function_type = read_be16(tag + 8);
+
+            if (function_type > 4 || PARAMS_COUNT[function_type] > (tag_size - 12) / 4) {
+                SAIL_LOG_ERROR("ICC: Invalid parametric curve of type %u", function_type);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+            }
+
+            curve->type          = ICC_CURVE_PARAMETRIC;
+            curve->function_type = function_type;
+
+            for (unsigned i = 0; i < PARAMS_COUNT[function_type]; i++) {
+                curve->params[i] = read_s15_fixed16(tag + 12 + i * 4);
+            }
+
+            return SAIL_OK;
+        }
+        default: {
+            SAIL_LOG_ERROR("ICC: Unsupported curve type %c%c%c%c", tag[0], tag[1], tag[2], tag[3]);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+        }
+    }
+}
+
+static double evaluate_parametric_curve(const struct icc_curve *curve, double x) {
+
+    const double g = curve->params[0];
+    const double a = curve->params[1];
+    const double b = curve->params[2];
+    const double c = curve->params[3];
+    const double d = curve->params[4];
+    const double e = curve->params[5];
+    const double f = curve->params[6];
+
+    /* Powers of negative numbers are undefined, so the linear segments start where a * x + b crosses zero. */
+    switch (curve->function_type) {
+        case 0: {
+            return pow(x, g);
+        }
+        case 1: {
+            return (a * x + b >= 0) ? pow(a * x + b, g) : 0;
+        }
+        case 2: {
+            return (a * x + b >= 0) ? pow(a * x + b, g) + c : c;
+        }
+        case 3: {
+            return (x >= d) ? pow(SAIL_MAX(a * x + b, 0), g) : c * x;
+        }
+        default: {
+            return (x >= d) ? pow(SAIL_MAX(a * x + b, 0), g) + e : c * x + f;
+        }
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t icc_parse_profile(const void *data, size_t data_size, struct icc_profile *profile) {
+
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(profile);
+
+    const uint8_t *bytes = data;
+
+    if (data_size < ICC_HEADER_SIZE + 4) {
+        SAIL_LOG_ERROR("ICC: Profile is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    /* Trust the declared size only when it's smaller than the data. */
+    data_size = SAIL_MIN(data_size, SAIL_MAX(read_be32(bytes), ICC_HEADER_SIZE + 4));
+
+    const uint32_t tag_count = read_be32(bytes + ICC_HEADER_SIZE);
+
+    if (tag_count > (data_size - ICC_HEADER_SIZE - 4) / ICC_TAG_ENTRY_SIZE) {
+        SAIL_LOG_ERROR("ICC: Tag table is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    if (read_be32(bytes + 20) != ICC_SIGNATURE('X', 'Y', 'Z', ' ')) {
+        SAIL_LOG_ERROR("ICC: Only profiles with the XYZ connection space are supported");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+    }
+
+    switch (read_be32(bytes + 16)) {
+        case ICC_SIGNATURE('G', 'R', 'A', 'Y'): {
+            profile->color_space = ICC_COLOR_SPACE_GRAY;
+
+            SAIL_TRY(parse_curve(bytes, data_size, ICC_SIGNATURE('k', 'T', 'R', 'C'), &profile->curves[0]));
+
+            profile->curves[1] = profile->curves[0];
+            profile->curves[2] = profile->curves[0];
+
+            return SAIL_OK;
+        }
+        case ICC_SIGNATURE('R', 'G', 'B', ' '): {
+            profile->color_space = ICC_COLOR_SPACE_RGB;
+
+            static const uint32_t COLORANTS[] = {
+                ICC_SIGNATURE('r', 'X', 'Y', 'Z'),
+                ICC_SIGNATURE('g', 'X', 'Y', 'Z'),
+                ICC_SIGNATURE('b', 'X', 'Y', 'Z'),
+            };
+            static const uint32_t CURVES[] = {
+                ICC_SIGNATURE('r', 'T', 'R', 'C'),
+                ICC_SIGNATURE('g', 'T', 'R', 'C'),
+                ICC_SIGNATURE('b', 'T', 'R', 'C'),
+            };
+
+            for (unsigned channel = 0; channel < 3; channel++) {
+                double xyz[3];
+                SAIL_TRY(parse_xyz(bytes, data_size, COLORANTS[channel], xyz));
+
+                for (unsigned i = 0; i < 3; i++) {
+                    profile->matrix[i][channel] = xyz[i];
+                }
+
+                SAIL_TRY(parse_curve(bytes, data_size, CURVES[channel], &profile->curves[channel]));
+            }
+
+            return SAIL_OK;
+        }
+        default: {
+            SAIL_LOG_ERROR("ICC: Only RGB and grayscale profiles are supported");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_ICCP);
+        }
+    }
+}
+
+void icc_srgb_profile(struct icc_profile *profile) {
+
+    /* The sRGB primaries adapted to D50 with the Bradford transform as in the ICC sRGB profiles. */
+    static const double SRGB_MATRIX[3][3] = {
+        { 0.4360747, 0.3850649, 0.1430804 },
+        { 0.2225045, 0.7168786, 0.0606169 },
+        { 0.0139322, 0.0971045, 0.7141733 },
+    };
+
+    memset(profile, 0, sizeof(*profile));
+
+    profile->color_space = ICC_COLOR_SPACE_RGB;
+
+    /* Round as in profiles, so embedded sRGB profiles have exactly the same colorants. */
+    for (unsigned row = 0; row < 3; row++) {
+        for (unsigned column = 0; column < 3; column++) {
+            profile->matrix[row][column] = floor(SRGB_MATRIX[row][column] * 65536 + 0.5) / 65536;
+        }
+    }
+
+    profile->curves[0].type          = ICC_CURVE_PARAMETRIC;
+    profile->curves[0].function_type = 3;
+    profile->curves[0].params[0]     = 2.4;
+    profile->curves[0].params[1]     = 1 / 1.055;
+    profile->curves[0].params[2]     = 0.055 / 1.055;
+    profile->curves[0].params[3]     = 1 / 12.92;
+    profile->curves[0].params[4]     = 0.04045;
+
+    profile->curves[1] = profile->curves[0];
+    profile->curves[2] = profile->curves[0];
+}
+
+double icc_evaluate_curve(const struct icc_curve *curve, double x) {
+
+    double y;
+
+    switch (curve->type) {
+        case ICC_CURVE_IDENTITY: {
+            y = x;
+            break;
+        }
+        case ICC_CURVE_TABLE: {
+            const double position = x * (curve->table_size - 1);
+            const unsigned index = (unsigned)position;
+
+            if (index >= curve->table_size - 1) {
+                y = read_be16(curve->table + (curve->table_size - 1) * 2) / 65535.0;
+            } else {
+                const double y0 = read_be16(curve->table + index * 2) / 65535.0;
+                const double y1 = read_be16(curve->table + (index + 1) * 2) / 65535.0;
+
+                y = y0 + (y1 - y0) * (position - index);
+            }
+            break;
+        }
+        default: {
+            y = evaluate_parametric_curve(curve, x);
+            break;
+        }
+    }
+
+    return (y < 0) ? 0 : (y > 1) ? 1 : y;
+}
+
+bool icc_curves_equal(const struct icc_curve *curve1, const struct icc_curve *curve2) {
+
+    if (curve1->type != curve2->type || curve1->function_type != curve2->function_type
+            || curve1->table != curve2->table || curve1->table_size != curve2->table_size) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < 7; i++) {
+        if (curve1->params[i] != curve2->params[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
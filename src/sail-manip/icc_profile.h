@@ -0,0 +1,101 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ICC_PROFILE_H
+#define SAIL_ICC_PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+/*
+ * Parsed matrix/TRC ICC profiles. Such profiles convert device values into the D50 PCSXYZ
+ * with a tone reproduction curve per channel followed by a 3x3 matrix. Profiles built on
+ * lookup tables (A2B0 and friends) are not supported.
+ */
+enum IccColorSpace {
+
+    ICC_COLOR_SPACE_GRAY,
+    ICC_COLOR_SPACE_RGB,
+};
+
+enum IccCurveType {
+
+    ICC_CURVE_IDENTITY,
+    ICC_CURVE_TABLE,
+    ICC_CURVE_PARAMETRIC,
+};
+
+struct icc_curve {
+
+    enum IccCurveType type;
+
+    /* Parametric function type from 0 to 4 and its g, a, b, c, d, e, f parameters. Gamma curves are type 0. */
+    unsigned function_type;
+    double params[7];
+
+    /* Shallow pointer to big-endian 16-bit table entries inside the profile data. */
+    const uint8_t *table;
+    unsigned table_size;
+};
+
+struct icc_profile {
+
+    enum IccColorSpace color_space;
+
+    /* Columns are the red, green, and blue colorants in the D50 PCSXYZ. Set for RGB profiles only. */
+    double matrix[3][3];
+
+    /* Red, green, and blue tone curves. Gray profiles have the first one only. */
+    struct icc_curve curves[3];
+};
+
+/*
+ * Parses the matrix/TRC ICC profile. The parsed curves point into the data, so it must outlive the profile.
+ *
+ * Returns SAIL_ERROR_UNSUPPORTED_ICCP for profiles of other color spaces and profiles
+ * without matrix/TRC tags.
+ */
+SAIL_HIDDEN sail_status_t icc_parse_profile(const void *data, size_t data_size, struct icc_profile *profile);
+
+/*
+ * Fills the profile with the built-in sRGB IEC61966-2.1 profile.
+ */
+SAIL_HIDDEN void icc_srgb_profile(struct icc_profile *profile);
+
+/*
+ * Maps the device value in [0; 1] into the linear value in [0; 1].
+ */
+SAIL_HIDDEN double icc_evaluate_curve(const struct icc_curve *curve, double x);
+
+/*
+ * Returns true if the curves are the same.
+ */
+SAIL_HIDDEN bool icc_curves_equal(const struct icc_curve *curve1, const struct icc_curve *curve2);
+
+#endif
@@ -0,0 +1,471 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* The number of tables kept by linear_light_acquire_tables(). */
+#define CACHE_SIZE 4
+
+/* Least recently used tables are evicted first. */
+struct cache_entry {
+
+    /* Larger values are used more recently. */
+    uint64_t last_use;
+
+    /* NULL for empty entries. */
+    struct linear_light_tables *tables;
+};
+
+/* Everything below is guarded by cache_lock. */
+static manip_lock_t cache_lock = MANIP_LOCK_INITIALIZER;
+
+static struct cache_entry cache[CACHE_SIZE];
+static uint64_t cache_clock = 0;
+
+/* Decoding exponent of the image gamma. Zero means sRGB. */
+static double gamma_exponent(double gamma) {
+
+    /* 1 is the default gamma of images without gamma information. */
+    if (!(gamma > 0 && gamma < 100) || fabs(gamma - 1) < 1e-6) {
+        return 0;
+    }
+
+    return (gamma < 1) ? 1 / gamma : gamma;
+}
+
+static double decode(double value, double exponent) {
+
+    if (exponent == 0) {
+        return (value <= 0.04045) ? value / 12.92 : pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    return pow(value, exponent);
+}
+
+static double encode(double value, double exponent) {
+
+    if (exponent == 0) {
+        return (value <= 0.0031308) ? value * 12.92 : 1.055 * pow(value, 1 / 2.4) - 0.055;
+    }
+
+    return pow(value, 1 / exponent);
+}
+
+static sail_status_t build_tables(double exponent, struct linear_light_tables **tables) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct linear_light_tables), &ptr));
+    struct linear_light_tables *tables_local = ptr;
+
+    tables_local->exponent   = exponent;
+    tables_local->references = 0;
+
+    for (unsigned i = 0; i < 256; i++) {
+        tables_local->to_linear8[i] = (uint16_t)floor(decode(i / 255.0, exponent) * 65535 + 0.5);
+    }
+
+    for (unsigned i = 0; i < 65536; i++) {
+        tables_local->to_linear16[i]    = (uint16_t)floor(decode(i / 65535.0, exponent) * 65535 + 0.5);
+
+        const double encoded = encode(i / 65535.0, exponent);
+        tables_local->from_linear8[i]   = (uint8_t)floor(encoded * 255 + 0.5);
+        tables_local->from_linear16[i]  = (uint16_t)floor(encoded * 65535 + 0.5);
+    }
+
+    *tables = tables_local;
+
+    return SAIL_OK;
+}
+
+/* Must be called under the cache lock. */
+static struct cache_entry *find_cache_entry(double exponent) {
+
+    for (unsigned i = 0; i < CACHE_SIZE; i++) {
+        if (cache[i].tables != NULL && cache[i].tables->exponent == exponent) {
+            return &cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Must be called under the cache lock. Returns the tables to destroy outside of the lock or NULL. */
+static struct linear_light_tables *unreference_tables(struct linear_light_tables *tables) {
+
+    return (--tables->references == 0) ? tables : NULL;
+}
+
+static inline unsigned load_channel(const uint8_t *scan, unsigned bytes, int index) {
+
+    return (bytes == 1) ? scan[index] : ((const uint16_t *)scan)[index];
+}
+
+static inline void store_channel(uint8_t *scan, unsigned bytes, int index, unsigned value) {
+
+    if (bytes == 1) {
+        scan[index] = (uint8_t)value;
+    } else {
+        ((uint16_t *)scan)[index] = (uint16_t)value;
+    }
+}
+
+/* 16-bit values are truncated exactly like narrow_uint16() does. */
+static inline unsigned scale_channel(unsigned value, unsigned input_bytes, unsigned output_bytes) {
+
+    if (input_bytes == output_bytes) {
+        return value;
+    } else if (input_bytes == 1) {
+        return widen_uint8(value);
+    } else {
+        return narrow_uint16(value);
+    }
+}
+
+static inline unsigned to_linear(const struct linear_light_tables *tables, unsigned value, unsigned bytes) {
+
+    return (bytes == 1) ? tables->to_linear8[value] : tables->to_linear16[value];
+}
+
+static inline unsigned from_linear(const struct linear_light_tables *tables, unsigned value, unsigned bytes) {
+
+    return (bytes == 1) ? tables->from_linear8[value] : tables->from_linear16[value];
+}
+
+static inline bool is_color_channel(const struct linear_light_layout *layout, unsigned channel) {
+
+    return (int)channel == layout->r || (int)channel == layout->g || (int)channel == layout->b;
+}
+
+/*
+ * Public functions.
+ */
+
+bool linear_light_layout(enum SailPixelFormat pixel_format, struct linear_light_layout *layout) {
+
+    static const struct {
+        enum SailPixelFormat pixel_format;
+        struct linear_light_layout layout;
+    } LAYOUTS[] = {
+        { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,        { 1, 1, 0, 0, 0, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,       { 2, 1, 0, 0, 0, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA, { 1, 2, 0, 0, 0,  1 } },
+        { SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA, { 2, 2, 0, 0, 0,  1 } },
+
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,  { 1, 3, 0, 1, 2, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP24_BGR,  { 1, 3, 2, 1, 0, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP48_RGB,  { 2, 3, 0, 1, 2, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP48_BGR,  { 2, 3, 2, 1, 0, -1 } },
+
+        { SAIL_PIXEL_FORMAT_BPP32_RGBX, { 1, 4, 0, 1, 2, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP32_BGRX, { 1, 4, 2, 1, 0, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP32_XRGB, { 1, 4, 1, 2, 3, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP32_XBGR, { 1, 4, 3, 2, 1, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP32_RGBA, { 1, 4, 0, 1, 2,  3 } },
+        { SAIL_PIXEL_FORMAT_BPP32_BGRA, { 1, 4, 2, 1, 0,  3 } },
+        { SAIL_PIXEL_FORMAT_BPP32_ARGB, { 1, 4, 1, 2, 3,  0 } },
+        { SAIL_PIXEL_FORMAT_BPP32_ABGR, { 1, 4, 3, 2, 1,  0 } },
+
+        { SAIL_PIXEL_FORMAT_BPP64_RGBX, { 2, 4, 0, 1, 2, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP64_BGRX, { 2, 4, 2, 1, 0, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP64_XRGB, { 2, 4, 1, 2, 3, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP64_XBGR, { 2, 4, 3, 2, 1, -1 } },
+        { SAIL_PIXEL_FORMAT_BPP64_RGBA, { 2, 4, 0, 1, 2,  3 } },
+        { SAIL_PIXEL_FORMAT_BPP64_BGRA, { 2, 4, 2, 1, 0,  3 } },
+        { SAIL_PIXEL_FORMAT_BPP64_ARGB, { 2, 4, 1, 2, 3,  0 } },
+        { SAIL_PIXEL_FORMAT_BPP64_ABGR, { 2, 4, 3, 2, 1,  0 } },
+    };
+
+    for (size_t i = 0; i < sizeof(LAYOUTS) / sizeof(LAYOUTS[0]); i++) {
+        if (LAYOUTS[i].pixel_format == pixel_format) {
+            *layout = LAYOUTS[i].layout;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+enum SailPixelFormat linear_light_pixel_format16(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:        return SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: return SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA;
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:             return SAIL_PIXEL_FORMAT_BPP48_RGB;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:             return SAIL_PIXEL_FORMAT_BPP48_BGR;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:            return SAIL_PIXEL_FORMAT_BPP64_RGBX;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:            return SAIL_PIXEL_FORMAT_BPP64_BGRX;
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:            return SAIL_PIXEL_FORMAT_BPP64_XRGB;
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:            return SAIL_PIXEL_FORMAT_BPP64_XBGR;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:            return SAIL_PIXEL_FORMAT_BPP64_RGBA;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:            return SAIL_PIXEL_FORMAT_BPP64_BGRA;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:            return SAIL_PIXEL_FORMAT_BPP64_ARGB;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR:            return SAIL_PIXEL_FORMAT_BPP64_ABGR;
+
+        default: {
+            struct linear_light_layout layout;
+
+            return (linear_light_layout(pixel_format, &layout) && layout.bytes == 2) ? pixel_format : SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+}
+
+sail_status_t linear_light_acquire_tables(double gamma, const struct linear_light_tables **tables) {
+
+    SAIL_CHECK_PTR(tables);
+
+    const double exponent = gamma_exponent(gamma);
+
+    manip_lock(&cache_lock);
+
+    struct cache_entry *entry = find_cache_entry(exponent);
+
+    if (entry != NULL) {
+        entry->last_use = ++cache_clock;
+        entry->tables->references++;
+        *tables = entry->tables;
+        manip_unlock(&cache_lock);
+        return SAIL_OK;
+    }
+
+    manip_unlock(&cache_lock);
+
+    /* Build the tables without blocking other threads. */
+    struct linear_light_tables *tables_local;
+    SAIL_TRY(build_tables(exponent, &tables_local));
+
+    struct linear_light_tables *evicted = NULL;
+
+    manip_lock(&cache_lock);
+
+    /* Another thread may have built the same tables meanwhile. */
+    entry = find_cache_entry(exponent);
+
+    if (entry != NULL) {
+        evicted = tables_local;
+    } else {
+        entry = &cache[0];
+
+        for (unsigned i = 1; i < CACHE_SIZE && entry->tables != NULL; i++) {
+            if (cache[i].tables == NULL || cache[i].last_use < entry->last_use) {
+                entry = &cache[i];
+            }
+        }
+
+        if (entry->tables != NULL) {
+            evicted = unreference_tables(entry->tables);
+        }
+
+        entry->tables = tables_local;
+        entry->tables->references = 1;
+    }
+
+    entry->last_use = ++cache_clock;
+    entry->tables->references++;
+    *tables = entry->tables;
+
+    manip_unlock(&cache_lock);
+
+    sail_free(evicted);
+
+    return SAIL_OK;
+}
+
+void linear_light_release_tables(const struct linear_light_tables *tables) {
+
+    if (tables == NULL) {
+        return;
+    }
+
+    manip_lock(&cache_lock);
+    struct linear_light_tables *unused = unreference_tables((struct linear_light_tables *)tables);
+    manip_unlock(&cache_lock);
+
+    sail_free(unused);
+}
+
+bool linear_light_needed(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format,
+                            const struct sail_conversion_options *options) {
+
+    if (options == NULL || (options->options & SAIL_CONVERSION_OPTION_LINEAR_LIGHT) == 0) {
+        return false;
+    }
+
+    struct linear_light_layout input;
+    struct linear_light_layout output;
+
+    if (!linear_light_layout(input_pixel_format, &input) || !linear_light_layout(output_pixel_format, &output)) {
+        return false;
+    }
+
+    const bool luma  = input.channels >= 3 && output.channels <= 2;
+    const bool blend = input.a >= 0 && output.a < 0 && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA);
+
+    return luma || blend;
+}
+
+sail_status_t linear_light_init_converter(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format,
+                                            double image_gamma, const struct sail_conversion_options *options,
+                                            struct linear_light_converter *converter) {
+
+    SAIL_CHECK_PTR(converter);
+
+    if (!linear_light_layout(input_pixel_format, &converter->input) || !linear_light_layout(output_pixel_format, &converter->output)) {
+        SAIL_LOG_ERROR("Conversion from %s to %s in linear light is not supported",
+                        sail_pixel_format_to_string(input_pixel_format), sail_pixel_format_to_string(output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const double gamma = (options != NULL && options->gamma > 0) ? options->gamma : image_gamma;
+    SAIL_TRY(linear_light_acquire_tables(gamma, &converter->tables));
+
+    converter->blend = converter->input.a >= 0 && converter->output.a < 0
+                        && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA);
+
+    /* 8-bit pixels are blended with the 24-bit background like the other conversions do. */
+    if (converter->blend && converter->input.bytes == 1 && converter->output.bytes == 1) {
+        converter->background[0] = converter->tables->to_linear8[options->background24.component1];
+        converter->background[1] = converter->tables->to_linear8[options->background24.component2];
+        converter->background[2] = converter->tables->to_linear8[options->background24.component3];
+    } else if (converter->blend) {
+        converter->background[0] = converter->tables->to_linear16[options->background48.component1];
+        converter->background[1] = converter->tables->to_linear16[options->background48.component2];
+        converter->background[2] = converter->tables->to_linear16[options->background48.component3];
+    } else {
+        converter->background[0] = converter->background[1] = converter->background[2] = 0;
+    }
+
+    return SAIL_OK;
+}
+
+void linear_light_cleanup_converter(struct linear_light_converter *converter) {
+
+    linear_light_release_tables(converter->tables);
+    converter->tables = NULL;
+}
+
+void linear_light_convert_row(const struct linear_light_converter *converter, const void *input, void *output, unsigned width) {
+
+    const struct linear_light_tables *tables = converter->tables;
+    const struct linear_light_layout *in  = &converter->input;
+    const struct linear_light_layout *out = &converter->output;
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = in->bytes * in->channels;
+    const unsigned output_step = out->bytes * out->channels;
+    const unsigned input_max   = (in->bytes == 1) ? 255 : 65535;
+    const bool luma = in->channels >= 3 && out->channels <= 2;
+
+    for (unsigned column = 0; column < width; column++) {
+        const unsigned r = load_channel(scan_input, in->bytes, in->r);
+        const unsigned g = load_channel(scan_input, in->bytes, in->g);
+        const unsigned b = load_channel(scan_input, in->bytes, in->b);
+        const unsigned a = (in->a >= 0) ? load_channel(scan_input, in->bytes, in->a) : input_max;
+
+        const bool blend = converter->blend && a < input_max;
+
+        if (!blend && (!luma || (r == g && g == b))) {
+            /* Nothing to mix. Gray pixels have the same luma in any space. */
+            store_channel(scan_output, out->bytes, out->r, scale_channel(r, in->bytes, out->bytes));
+            store_channel(scan_output, out->bytes, out->g, scale_channel(g, in->bytes, out->bytes));
+            store_channel(scan_output, out->bytes, out->b, scale_channel(b, in->bytes, out->bytes));
+        } else {
+            unsigned values[3] = {
+                to_linear(tables, r, in->bytes),
+                to_linear(tables, g, in->bytes),
+                to_linear(tables, b, in->bytes),
+            };
+
+            if (blend) {
+                const unsigned alpha = (in->bytes == 1) ? widen_uint8(a) : a;
+
+                for (unsigned c = 0; c < 3; c++) {
+                    values[c] = blend_uint16(values[c], alpha, converter->background[c]);
+                }
+            }
+
+            if (luma) {
+                store_channel(scan_output, out->bytes, out->r, from_linear(tables, rgb_to_gray(values[0], values[1], values[2]), out->bytes));
+            } else {
+                store_channel(scan_output, out->bytes, out->r, from_linear(tables, values[0], out->bytes));
+                store_channel(scan_output, out->bytes, out->g, from_linear(tables, values[1], out->bytes));
+                store_channel(scan_output, out->bytes, out->b, from_linear(tables, values[2], out->bytes));
+            }
+        }
+
+        if (out->a >= 0) {
+            store_channel(scan_output, out->bytes, out->a, scale_channel(a, in->bytes, out->bytes));
+        }
+
+        scan_input  += input_step;
+        scan_output += output_step;
+    }
+}
+
+void linear_light_decode_row(const struct linear_light_tables *tables, const struct linear_light_layout *layout,
+                                const void *input, uint16_t *output, unsigned width) {
+
+    const uint8_t *scan_input = input;
+    const unsigned count = width * layout->channels;
+
+    for (unsigned i = 0, channel = 0; i < count; i++) {
+        const unsigned value = load_channel(scan_input, layout->bytes, (int)i);
+
+        output[i] = (uint16_t)(is_color_channel(layout, channel) ? to_linear(tables, value, layout->bytes) : scale_channel(value, layout->bytes, 2));
+
+        if (++channel == layout->channels) {
+            channel = 0;
+        }
+    }
+}
+
+void linear_light_encode_row(const struct linear_light_tables *tables, const struct linear_light_layout *layout,
+                                const uint16_t *input, void *output, unsigned width) {
+
+    uint8_t *scan_output = output;
+    const unsigned count = width * layout->channels;
+
+    for (unsigned i = 0, channel = 0; i < count; i++) {
+        const unsigned value = input[i];
+
+        store_channel(scan_output, layout->bytes, (int)i,
+                        is_color_channel(layout, channel) ? from_linear(tables, value, layout->bytes) : scale_channel(value, 2, layout->bytes));
+
+        if (++channel == layout->channels) {
+            channel = 0;
+        }
+    }
+}
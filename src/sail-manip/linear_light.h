@@ -0,0 +1,149 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_LINEAR_LIGHT_H
+#define SAIL_LINEAR_LIGHT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_conversion_options;
+
+/*
+ * Lookup tables between gamma-encoded 8 or 16-bit values and 16-bit linear light values.
+ * Tables are built once per transfer function and shared between threads. They're never
+ * modified after building.
+ */
+struct linear_light_tables {
+
+    /* Decoding exponent of the transfer function or zero for sRGB. */
+    double exponent;
+
+    /* The number of cache entries and callers using the tables. Guarded by the cache lock. */
+    unsigned references;
+
+    uint16_t to_linear8[256];
+    uint16_t to_linear16[65536];
+    uint8_t  from_linear8[65536];
+    uint16_t from_linear16[65536];
+};
+
+/*
+ * Channel layout of grayscale and RGB-like pixel formats: bytes per channel, number
+ * of channels, and indexes of the RED, GREEN, BLUE, and ALPHA channels. Grayscale pixels have
+ * the same index for the color channels. Missing alpha has -1 index.
+ */
+struct linear_light_layout {
+
+    unsigned bytes;
+    unsigned channels;
+    int r;
+    int g;
+    int b;
+    int a;
+};
+
+/*
+ * Converts scan lines between a pair of pixel formats blending alpha and computing luma
+ * in linear light.
+ */
+struct linear_light_converter {
+
+    const struct linear_light_tables *tables;
+    struct linear_light_layout input;
+    struct linear_light_layout output;
+
+    /* Alpha is blended with the linearized 16-bit background. */
+    bool blend;
+    uint16_t background[3];
+};
+
+/*
+ * Returns the layout of grayscale (with or without alpha) and 24-64-bit RGB-like pixel formats.
+ * Returns false for other pixel formats.
+ */
+SAIL_HIDDEN bool linear_light_layout(enum SailPixelFormat pixel_format, struct linear_light_layout *layout);
+
+/*
+ * Returns the pixel format with the same channels and 16 bits per channel. Returns
+ * SAIL_PIXEL_FORMAT_UNKNOWN if the pixel format has no layout.
+ */
+SAIL_HIDDEN enum SailPixelFormat linear_light_pixel_format16(enum SailPixelFormat pixel_format);
+
+/*
+ * Returns the tables for the image gamma. Gamma values below 1 are encoding gammas like 0.45455
+ * in PNG files, and gamma values above 1 are decoding gammas like 2.2. Zero, 1, and invalid values
+ * mean sRGB. The tables are cached, so the same tables are returned for the same gamma until they're
+ * evicted. Release them with linear_light_release_tables().
+ */
+SAIL_HIDDEN sail_status_t linear_light_acquire_tables(double gamma, const struct linear_light_tables **tables);
+
+/*
+ * Releases the tables acquired with linear_light_acquire_tables(). Does nothing if the tables are NULL.
+ */
+SAIL_HIDDEN void linear_light_release_tables(const struct linear_light_tables *tables);
+
+/*
+ * Returns true if the options request linear light, and converting the pixels blends alpha
+ * or computes luma. Other conversions don't depend on the transfer function.
+ */
+SAIL_HIDDEN bool linear_light_needed(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format,
+                                        const struct sail_conversion_options *options);
+
+/*
+ * Initializes the converter. sail_conversion_options.gamma overrides the image gamma if it's set.
+ * Clean the converter up with linear_light_cleanup_converter().
+ */
+SAIL_HIDDEN sail_status_t linear_light_init_converter(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format,
+                                                        double image_gamma, const struct sail_conversion_options *options,
+                                                        struct linear_light_converter *converter);
+
+SAIL_HIDDEN void linear_light_cleanup_converter(struct linear_light_converter *converter);
+
+/*
+ * Converts a scan line. Opaque pixels that don't need luma are copied without linearizing,
+ * so they don't lose precision. Input and output may point to the same memory when converting in place.
+ */
+SAIL_HIDDEN void linear_light_convert_row(const struct linear_light_converter *converter, const void *input, void *output, unsigned width);
+
+/*
+ * Linearizes color channels of the scan line into 16-bit channels of the same layout. Alpha and
+ * X channels are scaled to 16 bits.
+ */
+SAIL_HIDDEN void linear_light_decode_row(const struct linear_light_tables *tables, const struct linear_light_layout *layout,
+                                            const void *input, uint16_t *output, unsigned width);
+
+/*
+ * Encodes 16-bit linear color channels of the scan line back into the layout. Alpha and X channels
+ * are scaled from 16 bits.
+ */
+SAIL_HIDDEN void linear_light_encode_row(const struct linear_light_tables *tables, const struct linear_light_layout *layout,
+                                            const uint16_t *input, void *output, unsigned width);
+
+#endif
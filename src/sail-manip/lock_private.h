@@ -0,0 +1,55 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#ifndef SAIL_LOCK_PRIVATE_H
+#define SAIL_LOCK_PRIVATE_H
+
+#include <sail-common/config.h>
+#include <sail-common/export.h>
+
+#ifdef SAIL_WIN32
+    #include <Windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+/*
+ * Statically initialized exclusive lock for global caches and the thread pool. SRW locks are used
+ * on Windows, and mutexes elsewhere, so the lock can also be waited on with condition variables.
+ */
+#ifdef SAIL_WIN32
+    typedef SRWLOCK manip_lock_t;
+    #define MANIP_LOCK_INITIALIZER SRWLOCK_INIT
+#else
+    typedef pthread_mutex_t manip_lock_t;
+    #define MANIP_LOCK_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#endif
+
+SAIL_HIDDEN void manip_lock(manip_lock_t *lock);
+
+SAIL_HIDDEN void manip_unlock(manip_lock_t *lock);
+
+#endif
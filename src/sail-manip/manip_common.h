@@ -49,6 +49,61 @@ enum SailConversionOption {
      *   output_pixel = opacity * input_pixel + (1 - opacity) * background
      */
     SAIL_CONVERSION_OPTION_BLEND_ALPHA = 1 << 1,
+
+    /*
+     * Tone map half-float and float pixels into the output range instead of clipping
+     * color values above 1.0. Uses the extended Reinhard operator applied to the brightest
+     * color channel, so hues are kept. See sail_conversion_options.tone_map_white.
+     */
+    SAIL_CONVERSION_OPTION_TONE_MAP    = 1 << 2,
+
+    /*
+     * Blend alpha and compute luma in linear light instead of gamma-encoded values. Pixels are
+     * linearized into 16-bit values with lookup tables, blended or converted to grayscale, and
+     * encoded back. See sail_conversion_options.gamma. Applies to conversions between grayscale
+     * (with or without alpha), indexed, and 24-64-bit RGB-like pixel formats. Other conversions
+     * ignore this option.
+     */
+    SAIL_CONVERSION_OPTION_LINEAR_LIGHT = 1 << 3,
+
+    /*
+     * Dither with the Floyd-Steinberg algorithm when converting into indexed pixel formats.
+     * See sail_quantize_image().
+     */
+    SAIL_CONVERSION_OPTION_DITHER       = 1 << 4,
+};
+
+/*
+ * Scaling algorithms.
+ */
+enum SailScaling {
+
+    /* Takes the input pixel nearest to the center of every output pixel. The fastest. */
+    SAIL_SCALING_NEAREST_NEIGHBOR,
+
+    /* Interpolates linearly between the nearest input pixels. */
+    SAIL_SCALING_BILINEAR,
+
+    /* Averages the input pixels covered by every output pixel. Good for downscaling. */
+    SAIL_SCALING_BOX,
+
+    /* Lanczos filter with 3 lobes. The sharpest and the slowest. */
+    SAIL_SCALING_LANCZOS3,
+};
+
+/*
+ * Dithering algorithms used when quantizing images into indexed pixel formats.
+ */
+enum SailDithering {
+
+    /* Maps every pixel to the nearest palette color. The fastest, may produce banding. */
+    SAIL_DITHERING_NONE,
+
+    /* Diffuses quantization errors into the neighbor pixels. The smoothest, but not parallel. */
+    SAIL_DITHERING_FLOYD_STEINBERG,
+
+    /* Adds thresholds from an 8x8 Bayer matrix. Produces a regular pattern that compresses better. */
+    SAIL_DITHERING_ORDERED,
 };
 
 #endif
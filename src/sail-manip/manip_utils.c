@@ -25,11 +25,6 @@
 
 #include <sail-manip/sail-manip.h>
 
-/* https://en.wikipedia.org/wiki/Grayscale */
-static const double R_TO_GRAY_COEFFICIENT = 0.299;
-static const double G_TO_GRAY_COEFFICIENT = 0.587;
-static const double B_TO_GRAY_COEFFICIENT = 0.114;
-
 sail_status_t get_palette_rgba32(const struct sail_palette *palette, unsigned index, sail_rgba32_t *rgba32) {
 
     if (index >= palette->color_count) {
@@ -73,13 +68,13 @@ void spread_gray8_to_rgba32(uint8_t value, sail_rgba32_t *rgba32) {
 
 void spread_gray16_to_rgba32(uint16_t value, sail_rgba32_t *rgba32) {
 
-    rgba32->component1 = rgba32->component2 = rgba32->component3 = (uint8_t)(value / 257.0);
+    rgba32->component1 = rgba32->component2 = rgba32->component3 = narrow_uint16(value);
     rgba32->component4 = 255;
 }
 
 void spread_gray8_to_rgba64(uint8_t value, sail_rgba64_t *rgba64) {
 
-    rgba64->component1 = rgba64->component2 = rgba64->component3 = (uint16_t)value * 257;
+    rgba64->component1 = rgba64->component2 = rgba64->component3 = widen_uint8(value);
     rgba64->component4 = 65535;
 }
 
@@ -94,18 +89,16 @@ void fill_gray8_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
     sail_rgb24_t rgb24;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgb24.component1 = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        rgb24.component2 = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        rgb24.component3 = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        rgb24.component1 = blend_uint8(rgba32->component1, rgba32->component4, options->background24.component1);
+        rgb24.component2 = blend_uint8(rgba32->component2, rgba32->component4, options->background24.component2);
+        rgb24.component3 = blend_uint8(rgba32->component3, rgba32->component4, options->background24.component3);
     } else {
         rgb24.component1 = rgba32->component1;
         rgb24.component2 = rgba32->component2;
         rgb24.component3 = rgba32->component3;
     }
 
-    *scan = (uint8_t)((R_TO_GRAY_COEFFICIENT * rgb24.component1) + (G_TO_GRAY_COEFFICIENT * rgb24.component2) + (B_TO_GRAY_COEFFICIENT * rgb24.component3));
+    *scan = (uint8_t)rgb_to_gray(rgb24.component1, rgb24.component2, rgb24.component3);
 }
 
 void fill_gray8_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, const struct sail_conversion_options *options) {
@@ -113,18 +106,16 @@ void fill_gray8_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *s
     sail_rgb24_t rgb24;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgb24.component1 = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        rgb24.component2 = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        rgb24.component3 = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        rgb24.component1 = narrow_uint16(blend_uint16(rgba64->component1, rgba64->component4, options->background48.component1));
+        rgb24.component2 = narrow_uint16(blend_uint16(rgba64->component2, rgba64->component4, options->background48.component2));
+        rgb24.component3 = narrow_uint16(blend_uint16(rgba64->component3, rgba64->component4, options->background48.component3));
     } else {
-        rgb24.component1 = (uint8_t)(rgba64->component1 / 257.0);
-        rgb24.component2 = (uint8_t)(rgba64->component2 / 257.0);
-        rgb24.component3 = (uint8_t)(rgba64->component3 / 257.0);
+        rgb24.component1 = narrow_uint16(rgba64->component1);
+        rgb24.component2 = narrow_uint16(rgba64->component2);
+        rgb24.component3 = narrow_uint16(rgba64->component3);
     }
 
-    *scan = (uint8_t)((R_TO_GRAY_COEFFICIENT * rgb24.component1) + (G_TO_GRAY_COEFFICIENT * rgb24.component2) + (B_TO_GRAY_COEFFICIENT * rgb24.component3));
+    *scan = (uint8_t)rgb_to_gray(rgb24.component1, rgb24.component2, rgb24.component3);
 }
 
 void fill_gray16_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, const struct sail_conversion_options *options) {
@@ -132,18 +123,18 @@ void fill_gray16_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *
     sail_rgb48_t rgb48;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
+        const uint16_t alpha = widen_uint8(rgba32->component4);
 
-        rgb48.component1 = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        rgb48.component2 = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        rgb48.component3 = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        rgb48.component1 = blend_uint16(widen_uint8(rgba32->component1), alpha, options->background48.component1);
+        rgb48.component2 = blend_uint16(widen_uint8(rgba32->component2), alpha, options->background48.component2);
+        rgb48.component3 = blend_uint16(widen_uint8(rgba32->component3), alpha, options->background48.component3);
     } else {
-        rgb48.component1 = rgba32->component1 * 257;
-        rgb48.component2 = rgba32->component2 * 257;
-        rgb48.component3 = rgba32->component3 * 257;
+        rgb48.component1 = widen_uint8(rgba32->component1);
+        rgb48.component2 = widen_uint8(rgba32->component2);
+        rgb48.component3 = widen_uint8(rgba32->component3);
     }
 
-    *scan = (uint16_t)((R_TO_GRAY_COEFFICIENT * rgb48.component1) + (G_TO_GRAY_COEFFICIENT * rgb48.component2) + (B_TO_GRAY_COEFFICIENT * rgb48.component3));
+    *scan = (uint16_t)rgb_to_gray(rgb48.component1, rgb48.component2, rgb48.component3);
 }
 
 void fill_gray16_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, const struct sail_conversion_options *options) {
@@ -151,28 +142,24 @@ void fill_gray16_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t
     sail_rgb48_t rgb48;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgb48.component1 = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        rgb48.component2 = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        rgb48.component3 = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        rgb48.component1 = blend_uint16(rgba64->component1, rgba64->component4, options->background48.component1);
+        rgb48.component2 = blend_uint16(rgba64->component2, rgba64->component4, options->background48.component2);
+        rgb48.component3 = blend_uint16(rgba64->component3, rgba64->component4, options->background48.component3);
     } else {
         rgb48.component1 = rgba64->component1;
         rgb48.component2 = rgba64->component2;
         rgb48.component3 = rgba64->component3;
     }
 
-    *scan = (uint16_t)((R_TO_GRAY_COEFFICIENT * rgb48.component1) + (G_TO_GRAY_COEFFICIENT * rgb48.component2) + (B_TO_GRAY_COEFFICIENT * rgb48.component3));
+    *scan = (uint16_t)rgb_to_gray(rgb48.component1, rgb48.component2, rgb48.component3);
 }
 
 void fill_rgb24_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        *(scan+g) = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        *(scan+b) = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        *(scan+r) = blend_uint8(rgba32->component1, rgba32->component4, options->background24.component1);
+        *(scan+g) = blend_uint8(rgba32->component2, rgba32->component4, options->background24.component2);
+        *(scan+b) = blend_uint8(rgba32->component3, rgba32->component4, options->background24.component3);
     } else {
         *(scan+r) = rgba32->component1;
         *(scan+g) = rgba32->component2;
@@ -183,41 +170,37 @@ void fill_rgb24_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
 void fill_rgb24_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        *(scan+g) = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        *(scan+b) = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        *(scan+r) = narrow_uint16(blend_uint16(rgba64->component1, rgba64->component4, options->background48.component1));
+        *(scan+g) = narrow_uint16(blend_uint16(rgba64->component2, rgba64->component4, options->background48.component2));
+        *(scan+b) = narrow_uint16(blend_uint16(rgba64->component3, rgba64->component4, options->background48.component3));
     } else {
-        *(scan+r) = (uint8_t)(rgba64->component1 / 257.0);
-        *(scan+g) = (uint8_t)(rgba64->component2 / 257.0);
-        *(scan+b) = (uint8_t)(rgba64->component3 / 257.0);
+        *(scan+r) = narrow_uint16(rgba64->component1);
+        *(scan+g) = narrow_uint16(rgba64->component2);
+        *(scan+b) = narrow_uint16(rgba64->component3);
     }
 }
 
 void fill_rgb48_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
+        const uint16_t alpha = widen_uint8(rgba32->component4);
 
-        *(scan+r) = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16(widen_uint8(rgba32->component1), alpha, options->background48.component1);
+        *(scan+g) = blend_uint16(widen_uint8(rgba32->component2), alpha, options->background48.component2);
+        *(scan+b) = blend_uint16(widen_uint8(rgba32->component3), alpha, options->background48.component3);
     } else {
-        *(scan+r) = rgba32->component1 * 257;
-        *(scan+g) = rgba32->component2 * 257;
-        *(scan+b) = rgba32->component3 * 257;
+        *(scan+r) = widen_uint8(rgba32->component1);
+        *(scan+g) = widen_uint8(rgba32->component2);
+        *(scan+b) = widen_uint8(rgba32->component3);
     }
 }
 
 void fill_rgb48_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16(rgba64->component1, rgba64->component4, options->background48.component1);
+        *(scan+g) = blend_uint16(rgba64->component2, rgba64->component4, options->background48.component2);
+        *(scan+b) = blend_uint16(rgba64->component3, rgba64->component4, options->background48.component3);
     } else {
         *(scan+r) = rgba64->component1;
         *(scan+g) = rgba64->component2;
@@ -228,11 +211,9 @@ void fill_rgb48_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *
 void fill_rgba32_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        *(scan+g) = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        *(scan+b) = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        *(scan+r) = blend_uint8(rgba32->component1, rgba32->component4, options->background24.component1);
+        *(scan+g) = blend_uint8(rgba32->component2, rgba32->component4, options->background24.component2);
+        *(scan+b) = blend_uint8(rgba32->component3, rgba32->component4, options->background24.component3);
     } else {
         *(scan+r) = rgba32->component1;
         *(scan+g) = rgba32->component2;
@@ -247,49 +228,45 @@ void fill_rgba32_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *s
 void fill_rgba32_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        *(scan+g) = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        *(scan+b) = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        *(scan+r) = narrow_uint16(blend_uint16(rgba64->component1, rgba64->component4, options->background48.component1));
+        *(scan+g) = narrow_uint16(blend_uint16(rgba64->component2, rgba64->component4, options->background48.component2));
+        *(scan+b) = narrow_uint16(blend_uint16(rgba64->component3, rgba64->component4, options->background48.component3));
     } else {
-        *(scan+r) = (uint8_t)(rgba64->component1 / 257.0);
-        *(scan+g) = (uint8_t)(rgba64->component2 / 257.0);
-        *(scan+b) = (uint8_t)(rgba64->component3 / 257.0);
+        *(scan+r) = narrow_uint16(rgba64->component1);
+        *(scan+g) = narrow_uint16(rgba64->component2);
+        *(scan+b) = narrow_uint16(rgba64->component3);
     }
 
     if (a >= 0) {
-        *(scan+a) = (uint8_t)(rgba64->component4 / 257.0);
+        *(scan+a) = narrow_uint16(rgba64->component4);
     }
 }
 
 void fill_rgba64_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
+        const uint16_t alpha = widen_uint8(rgba32->component4);
 
-        *(scan+r) = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16(widen_uint8(rgba32->component1), alpha, options->background48.component1);
+        *(scan+g) = blend_uint16(widen_uint8(rgba32->component2), alpha, options->background48.component2);
+        *(scan+b) = blend_uint16(widen_uint8(rgba32->component3), alpha, options->background48.component3);
     } else {
-        *(scan+r) = rgba32->component1 * 257;
-        *(scan+g) = rgba32->component2 * 257;
-        *(scan+b) = rgba32->component3 * 257;
+        *(scan+r) = widen_uint8(rgba32->component1);
+        *(scan+g) = widen_uint8(rgba32->component2);
+        *(scan+b) = widen_uint8(rgba32->component3);
     }
 
     if (a >= 0) {
-        *(scan+a) = rgba32->component4 * 257;
+        *(scan+a) = widen_uint8(rgba32->component4);
     }
 }
 
 void fill_rgba64_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16(rgba64->component1, rgba64->component4, options->background48.component1);
+        *(scan+g) = blend_uint16(rgba64->component2, rgba64->component4, options->background48.component2);
+        *(scan+b) = blend_uint16(rgba64->component3, rgba64->component4, options->background48.component3);
     } else {
         *(scan+r) = rgba64->component1;
         *(scan+g) = rgba64->component2;
@@ -306,11 +283,9 @@ void fill_ycbcr_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
     sail_rgba32_t rgba32_no_alpha;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgba32_no_alpha.component1 = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        rgba32_no_alpha.component2 = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        rgba32_no_alpha.component3 = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        rgba32_no_alpha.component1 = blend_uint8(rgba32->component1, rgba32->component4, options->background24.component1);
+        rgba32_no_alpha.component2 = blend_uint8(rgba32->component2, rgba32->component4, options->background24.component2);
+        rgba32_no_alpha.component3 = blend_uint8(rgba32->component3, rgba32->component4, options->background24.component3);
     } else {
         rgba32_no_alpha = *rgba32;
     }
@@ -323,16 +298,28 @@ void fill_ycbcr_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *s
     sail_rgba32_t rgba32_no_alpha;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgba32_no_alpha.component1 = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        rgba32_no_alpha.component2 = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        rgba32_no_alpha.component3 = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        rgba32_no_alpha.component1 = narrow_uint16(blend_uint16(rgba64->component1, rgba64->component4, options->background48.component1));
+        rgba32_no_alpha.component2 = narrow_uint16(blend_uint16(rgba64->component2, rgba64->component4, options->background48.component2));
+        rgba32_no_alpha.component3 = narrow_uint16(blend_uint16(rgba64->component3, rgba64->component4, options->background48.component3));
     } else {
-        rgba32_no_alpha.component1 = (uint8_t)(rgba64->component1 / 257.0);
-        rgba32_no_alpha.component2 = (uint8_t)(rgba64->component2 / 257.0);
-        rgba32_no_alpha.component3 = (uint8_t)(rgba64->component3 / 257.0);
+        rgba32_no_alpha.component1 = narrow_uint16(rgba64->component1);
+        rgba32_no_alpha.component2 = narrow_uint16(rgba64->component2);
+        rgba32_no_alpha.component3 = narrow_uint16(rgba64->component3);
     }
 
     convert_rgba32_to_ycbcr24(&rgba32_no_alpha, scan+0, scan+1, scan+2);
 }
+
+bool tone_map_requested(const struct sail_conversion_options *options, float *inv_white_squared) {
+
+    if (options == NULL || (options->options & SAIL_CONVERSION_OPTION_TONE_MAP) == 0) {
+        return false;
+    }
+
+    /* White points below 1.0 would brighten SDR values, so they mean the default one. */
+    const float white = options->tone_map_white >= 1.0f ? options->tone_map_white : 4.0f;
+
+    *inv_white_squared = 1.0f / (white * white);
+
+    return true;
+}
@@ -26,7 +26,9 @@
 #ifndef SAIL_MANIP_UTILS_H
 #define SAIL_MANIP_UTILS_H
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <sail-common/export.h>
 #include <sail-common/status.h>
@@ -34,6 +36,236 @@
 struct sail_conversion_options;
 struct sail_palette;
 
+/*
+ * Fixed-point helpers.
+ */
+
+/* https://en.wikipedia.org/wiki/Grayscale. 0.299, 0.587, and 0.114 scaled by 65536. */
+#define SAIL_R_TO_GRAY_WEIGHT 19595U
+#define SAIL_G_TO_GRAY_WEIGHT 38470U
+#define SAIL_B_TO_GRAY_WEIGHT 7471U
+
+/* Rounds x / 255 for x in [0; 65535]. */
+static inline uint32_t div255_round(uint32_t x) {
+
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+/* Rounds x / 65535 for x in [0; 65535 * 65535]. */
+static inline uint32_t div65535_round(uint32_t x) {
+
+    x += 32768;
+    return (x + (x >> 16)) >> 16;
+}
+
+/* Converts a 16-bit value to 8 bits with truncation. */
+static inline uint8_t narrow_uint16(unsigned value) {
+
+    return (uint8_t)(value / 257);
+}
+
+/* Converts an 8-bit value to 16 bits. 255 becomes 65535. */
+static inline uint16_t widen_uint8(unsigned value) {
+
+    return (uint16_t)(value * 257);
+}
+
+/* Blends an 8-bit value with the background using the 8-bit alpha. */
+static inline uint8_t blend_uint8(unsigned value, unsigned alpha, unsigned background) {
+
+    return (uint8_t)div255_round(value * alpha + background * (255 - alpha));
+}
+
+/* Blends a 16-bit value with the background using the 16-bit alpha. */
+static inline uint16_t blend_uint16(unsigned value, unsigned alpha, unsigned background) {
+
+    return (uint16_t)div65535_round(value * alpha + background * (65535 - alpha));
+}
+
+/* Premultiplies an 8-bit value by the 8-bit alpha. */
+static inline uint8_t premultiply_uint8(unsigned value, unsigned alpha) {
+
+    return (uint8_t)div255_round(value * alpha);
+}
+
+/* Premultiplies a 16-bit value by the 16-bit alpha. */
+static inline uint16_t premultiply_uint16(unsigned value, unsigned alpha) {
+
+    return (uint16_t)div65535_round(value * alpha);
+}
+
+/* Divides a premultiplied 8-bit value by the 8-bit alpha with rounding. Zero alpha gives zero. */
+static inline uint8_t unpremultiply_uint8(unsigned value, unsigned alpha) {
+
+    if (alpha == 0) {
+        return 0;
+    }
+
+    return (value >= alpha) ? 255 : (uint8_t)((value * 255 + alpha / 2) / alpha);
+}
+
+/* Divides a premultiplied 16-bit value by the 16-bit alpha with rounding. Zero alpha gives zero. */
+static inline uint16_t unpremultiply_uint16(unsigned value, unsigned alpha) {
+
+    if (alpha == 0) {
+        return 0;
+    }
+
+    return (value >= alpha) ? 65535 : (uint16_t)((value * 65535U + alpha / 2) / alpha);
+}
+
+/*
+ * Floating point helpers.
+ */
+
+/* Converts an IEEE 754 half-float value to float exactly. */
+static inline float half_to_float(uint16_t value) {
+
+    const uint32_t sign     = (uint32_t)(value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1F;
+    const uint32_t mantissa = value & 0x3FF;
+
+    uint32_t bits;
+
+    if (exponent == 0x1F) {
+        /* Infinity or NaN. NaNs become quiet like F16C makes them. */
+        bits = sign | 0x7F800000 | (mantissa << 13) | (mantissa != 0 ? 0x400000 : 0);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else {
+        /* Zero or subnormal, mantissa * 2^-24. */
+        const float result = (float)mantissa * (1.0f / 16777216.0f);
+        return sign != 0 ? -result : result;
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+/* Converts a float value to IEEE 754 half-float with rounding to nearest even like F16C does. */
+static inline uint16_t float_to_half(float value) {
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    const uint32_t abs  = bits & 0x7FFFFFFF;
+
+    if (abs >= 0x7F800000) {
+        /* Infinity or quiet NaN. */
+        return (uint16_t)(sign | 0x7C00 | (abs > 0x7F800000 ? 0x200 | ((abs >> 13) & 0x3FF) : 0));
+    }
+
+    /* 65520 and above round to infinity. */
+    if (abs >= 0x477FF000) {
+        return (uint16_t)(sign | 0x7C00);
+    }
+
+    /* Below 2^-14 the result is subnormal. Below 2^-25 it's zero. */
+    if (abs < 0x38800000) {
+        if (abs < 0x33000000) {
+            return sign;
+        }
+
+        const uint32_t shift     = 126 - (abs >> 23);
+        const uint32_t mantissa  = (abs & 0x7FFFFF) | 0x800000;
+        const uint32_t remainder = mantissa & ((1U << shift) - 1);
+        const uint32_t halfway   = 1U << (shift - 1);
+        uint32_t result = mantissa >> shift;
+
+        if (remainder > halfway || (remainder == halfway && (result & 1))) {
+            result++;
+        }
+
+        return (uint16_t)(sign | result);
+    }
+
+    /* Rebias the exponent and round the mantissa to 10 bits. A carry correctly increments the exponent. */
+    uint32_t result = (abs - 0x38000000) >> 13;
+    const uint32_t remainder = abs & 0x1FFF;
+
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) {
+        result++;
+    }
+
+    return (uint16_t)(sign | result);
+}
+
+/*
+ * Clips the value to [0; 1] and scales it to [0; max] with rounding. NaN becomes 0. SIMD kernels
+ * do exactly the same float operations, so they produce the same results.
+ */
+static inline unsigned float_to_uint(float value, float max) {
+
+    value = value > 0.0f ? value : 0.0f;
+    value = value < 1.0f ? value : 1.0f;
+
+    return (unsigned)(value * max + 0.5f);
+}
+
+/*
+ * Returns the factor to multiply R, G, and B by to tone map them with the extended Reinhard operator
+ * applied to max(R, G, B). Keeps the hue, maps 0 to 0 and the white point to 1.
+ */
+static inline float tone_map_factor(float r, float g, float b, float inv_white_squared) {
+
+    float m = r > g ? r : g;
+    m = m > b ? m : b;
+    m = m > 0.0f ? m : 0.0f;
+
+    return (1.0f + m * inv_white_squared) / (1.0f + m);
+}
+
+/* Computes the luma of 8-bit or 16-bit R, G, and B values with rounding. */
+static inline unsigned rgb_to_gray(unsigned r, unsigned g, unsigned b) {
+
+    return (SAIL_R_TO_GRAY_WEIGHT * r + SAIL_G_TO_GRAY_WEIGHT * g + SAIL_B_TO_GRAY_WEIGHT * b + 32768) >> 16;
+}
+
+/*
+ * Hash set of distinct packed colors. Must be a power of two and at least twice as large as
+ * the largest number of colors collected, i.e. 256.
+ */
+#define COLOR_SET_BITS 10
+#define COLOR_SET_SIZE (1 << COLOR_SET_BITS)
+
+struct color_set {
+    uint64_t colors[COLOR_SET_SIZE];
+    bool used[COLOR_SET_SIZE];
+    unsigned count;
+
+    /* A new color was added to a set with max_count colors. */
+    bool overflow;
+};
+
+/* Returns false and marks the set as overflown if the color is new and the set already has max_count colors. */
+static inline bool add_to_color_set(struct color_set *set, uint64_t color, unsigned max_count) {
+
+    unsigned slot = (unsigned)((color * 0x9E3779B97F4A7C15ULL) >> (64 - COLOR_SET_BITS));
+
+    while (set->used[slot]) {
+        if (set->colors[slot] == color) {
+            return true;
+        }
+
+        slot = (slot + 1) & (COLOR_SET_SIZE - 1);
+    }
+
+    if (set->count == max_count) {
+        set->overflow = true;
+        return false;
+    }
+
+    set->used[slot] = true;
+    set->colors[slot] = color;
+    set->count++;
+
+    return true;
+}
+
 SAIL_HIDDEN sail_status_t get_palette_rgba32(const struct sail_palette *palette, unsigned index, sail_rgba32_t *rgba32);
 
 SAIL_HIDDEN void spread_gray8_to_rgba32(uint8_t value, sail_rgba32_t *rgba32);
@@ -72,4 +304,10 @@ SAIL_HIDDEN void fill_ycbcr_pixel_from_uint8_values(const sail_rgba32_t *rgba32,
 
 SAIL_HIDDEN void fill_ycbcr_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, const struct sail_conversion_options *options);
 
+/*
+ * Returns true if the options request tone mapping of floating point pixels, and 1 / white^2
+ * for tone_map_factor() in inv_white_squared.
+ */
+SAIL_HIDDEN bool tone_map_requested(const struct sail_conversion_options *options, float *inv_white_squared);
+
 #endif
@@ -0,0 +1,327 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#ifdef SAIL_HAVE_NEON
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Number of vectors of squared differences accumulated in 32-bit lanes before widening
+ * them to 64 bits. Every vector adds up to 4 * 255^2 to a lane.
+ */
+#define FLUSH_VECTORS 4096
+
+static uint64_t squared_error_c(const uint8_t *samples1, const uint8_t *samples2, size_t count) {
+
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const int diff = (int)samples1[i] - (int)samples2[i];
+        sum += (uint64_t)(diff * diff);
+    }
+
+    return sum;
+}
+
+static void block_sums_c(const uint8_t *scan1, size_t stride1, const uint8_t *scan2, size_t stride2,
+                         unsigned count, struct ssim_block_sums *sums) {
+
+    for (unsigned block = 0; block < count; block++) {
+        uint32_t sum1 = 0, sum2 = 0, sum_squares = 0, sum_products = 0;
+
+        for (unsigned y = 0; y < 4; y++) {
+            const uint8_t *pixels1 = scan1 + y * stride1 + block * 4;
+            const uint8_t *pixels2 = scan2 + y * stride2 + block * 4;
+
+            for (unsigned x = 0; x < 4; x++) {
+                const uint32_t a = pixels1[x];
+                const uint32_t b = pixels2[x];
+
+                sum1         += a;
+                sum2         += b;
+                sum_squares  += a * a + b * b;
+                sum_products += a * b;
+            }
+        }
+
+        sums[block].sum1         = sum1;
+        sums[block].sum_squares  = sum_squares;
+        sums[block].sum2         = sum2;
+        sums[block].sum_products = sum_products;
+    }
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+SAIL_TARGET("ssse3")
+static uint64_t squared_error_ssse3(const uint8_t *samples1, const uint8_t *samples2, size_t count) {
+
+    const __m128i zero = _mm_setzero_si128();
+    const size_t simd_count = count - count % 16;
+
+    __m128i total = zero;
+    size_t i = 0;
+
+    while (i < simd_count) {
+        const size_t end = (simd_count - i > (size_t)FLUSH_VECTORS * 16) ? i + (size_t)FLUSH_VECTORS * 16 : simd_count;
+        __m128i acc = zero;
+
+        for (; i < end; i += 16) {
+            const __m128i a = _mm_loadu_si128((const __m128i *)(samples1 + i));
+            const __m128i b = _mm_loadu_si128((const __m128i *)(samples2 + i));
+
+            /* |a - b| fits 8 bits. */
+            const __m128i diff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+            const __m128i lo   = _mm_unpacklo_epi8(diff, zero);
+            const __m128i hi   = _mm_unpackhi_epi8(diff, zero);
+
+            acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+        }
+
+        total = _mm_add_epi64(total, _mm_add_epi64(_mm_unpacklo_epi32(acc, zero), _mm_unpackhi_epi32(acc, zero)));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, total);
+
+    return lanes[0] + lanes[1] + squared_error_c(samples1 + i, samples2 + i, count - i);
+}
+
+SAIL_TARGET("avx2")
+static uint64_t squared_error_avx2(const uint8_t *samples1, const uint8_t *samples2, size_t count) {
+
+    const __m256i zero = _mm256_setzero_si256();
+    const size_t simd_count = count - count % 32;
+
+    __m256i total = zero;
+    size_t i = 0;
+
+    while (i < simd_count) {
+        const size_t end = (simd_count - i > (size_t)FLUSH_VECTORS * 32) ? i + (size_t)FLUSH_VECTORS * 32 : simd_count;
+        __m256i acc = zero;
+
+        for (; i < end; i += 32) {
+            const __m256i a = _mm256_loadu_si256((const __m256i *)(samples1 + i));
+            const __m256i b = _mm256_loadu_si256((const __m256i *)(samples2 + i));
+
+            const __m256i diff = _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+            const __m256i lo   = _mm256_unpacklo_epi8(diff, zero);
+            const __m256i hi   = _mm256_unpackhi_epi8(diff, zero);
+
+            acc = _mm256_add_epi32(acc, _mm256_add_epi32(_mm256_madd_epi16(lo, lo), _mm256_madd_epi16(hi, hi)));
+        }
+
+        total = _mm256_add_epi64(total, _mm256_add_epi64(_mm256_unpacklo_epi32(acc, zero), _mm256_unpackhi_epi32(acc, zero)));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, total);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + squared_error_c(samples1 + i, samples2 + i, count - i);
+}
+
+/* Computes 2 blocks per iteration. */
+SAIL_TARGET("ssse3")
+static void block_sums_ssse3(const uint8_t *scan1, size_t stride1, const uint8_t *scan2, size_t stride2,
+                             unsigned count, struct ssim_block_sums *sums) {
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    unsigned block = 0;
+
+    for (; block + 2 <= count; block += 2) {
+        __m128i sum1 = zero, sum2 = zero, squares = zero, products = zero;
+
+        for (unsigned y = 0; y < 4; y++) {
+            const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(scan1 + y * stride1 + block * 4)), zero);
+            const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(scan2 + y * stride2 + block * 4)), zero);
+
+            sum1     = _mm_add_epi16(sum1, a);
+            sum2     = _mm_add_epi16(sum2, b);
+            squares  = _mm_add_epi32(squares, _mm_add_epi32(_mm_madd_epi16(a, a), _mm_madd_epi16(b, b)));
+            products = _mm_add_epi32(products, _mm_madd_epi16(a, b));
+        }
+
+        /* [sum1 0, sum1 1, sum2 0, sum2 1] and [squares 0, squares 1, products 0, products 1]. */
+        const __m128i sums12           = _mm_hadd_epi32(_mm_madd_epi16(sum1, ones), _mm_madd_epi16(sum2, ones));
+        const __m128i squares_products = _mm_hadd_epi32(squares, products);
+
+        const __m128i lo = _mm_unpacklo_epi32(sums12, squares_products);
+        const __m128i hi = _mm_unpackhi_epi32(sums12, squares_products);
+
+        _mm_storeu_si128((__m128i *)(sums + block),     _mm_unpacklo_epi64(lo, hi));
+        _mm_storeu_si128((__m128i *)(sums + block + 1), _mm_unpackhi_epi64(lo, hi));
+    }
+
+    block_sums_c(scan1 + block * 4, stride1, scan2 + block * 4, stride2, count - block, sums + block);
+}
+
+/* Computes 4 blocks per iteration. Same as block_sums_ssse3() in both 128-bit lanes. */
+SAIL_TARGET("avx2")
+static void block_sums_avx2(const uint8_t *scan1, size_t stride1, const uint8_t *scan2, size_t stride2,
+                            unsigned count, struct ssim_block_sums *sums) {
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    unsigned block = 0;
+
+    for (; block + 4 <= count; block += 4) {
+        __m256i sum1 = zero, sum2 = zero, squares = zero, products = zero;
+
+        for (unsigned y = 0; y < 4; y++) {
+            const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(scan1 + y * stride1 + block * 4)));
+            const __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(scan2 + y * stride2 + block * 4)));
+
+            sum1     = _mm256_add_epi16(sum1, a);
+            sum2     = _mm256_add_epi16(sum2, b);
+            squares  = _mm256_add_epi32(squares, _mm256_add_epi32(_mm256_madd_epi16(a, a), _mm256_madd_epi16(b, b)));
+            products = _mm256_add_epi32(products, _mm256_madd_epi16(a, b));
+        }
+
+        const __m256i sums12           = _mm256_hadd_epi32(_mm256_madd_epi16(sum1, ones), _mm256_madd_epi16(sum2, ones));
+        const __m256i squares_products = _mm256_hadd_epi32(squares, products);
+
+        const __m256i lo = _mm256_unpacklo_epi32(sums12, squares_products);
+        const __m256i hi = _mm256_unpackhi_epi32(sums12, squares_products);
+
+        /* Blocks 0 and 2, blocks 1 and 3. */
+        const __m256i even = _mm256_unpacklo_epi64(lo, hi);
+        const __m256i odd  = _mm256_unpackhi_epi64(lo, hi);
+
+        _mm256_storeu_si256((__m256i *)(sums + block),     _mm256_permute2x128_si256(even, odd, 0x20));
+        _mm256_storeu_si256((__m256i *)(sums + block + 2), _mm256_permute2x128_si256(even, odd, 0x31));
+    }
+
+    block_sums_c(scan1 + block * 4, stride1, scan2 + block * 4, stride2, count - block, sums + block);
+}
+#endif
+
+#ifdef SAIL_HAVE_NEON
+static uint64_t squared_error_neon(const uint8_t *samples1, const uint8_t *samples2, size_t count) {
+
+    const size_t simd_count = count - count % 16;
+
+    uint64x2_t total = vdupq_n_u64(0);
+    size_t i = 0;
+
+    while (i < simd_count) {
+        const size_t end = (simd_count - i > (size_t)FLUSH_VECTORS * 16) ? i + (size_t)FLUSH_VECTORS * 16 : simd_count;
+        uint32x4_t acc = vdupq_n_u32(0);
+
+        for (; i < end; i += 16) {
+            const uint8x16_t diff = vabdq_u8(vld1q_u8(samples1 + i), vld1q_u8(samples2 + i));
+
+            acc = vpadalq_u16(acc, vmull_u8(vget_low_u8(diff), vget_low_u8(diff)));
+            acc = vpadalq_u16(acc, vmull_u8(vget_high_u8(diff), vget_high_u8(diff)));
+        }
+
+        total = vpadalq_u32(total, acc);
+    }
+
+    return vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1) + squared_error_c(samples1 + i, samples2 + i, count - i);
+}
+
+/* Computes 2 blocks per iteration. */
+static void block_sums_neon(const uint8_t *scan1, size_t stride1, const uint8_t *scan2, size_t stride2,
+                            unsigned count, struct ssim_block_sums *sums) {
+
+    unsigned block = 0;
+
+    for (; block + 2 <= count; block += 2) {
+        uint16x8_t sum1     = vdupq_n_u16(0);
+        uint16x8_t sum2     = vdupq_n_u16(0);
+        uint32x4_t squares  = vdupq_n_u32(0);
+        uint32x4_t products = vdupq_n_u32(0);
+
+        for (unsigned y = 0; y < 4; y++) {
+            const uint8x8_t a = vld1_u8(scan1 + y * stride1 + block * 4);
+            const uint8x8_t b = vld1_u8(scan2 + y * stride2 + block * 4);
+
+            sum1     = vaddw_u8(sum1, a);
+            sum2     = vaddw_u8(sum2, b);
+            squares  = vpadalq_u16(squares, vmull_u8(a, a));
+            squares  = vpadalq_u16(squares, vmull_u8(b, b));
+            products = vpadalq_u16(products, vmull_u8(a, b));
+        }
+
+        const uint32x4_t pairs1 = vpaddlq_u16(sum1);
+        const uint32x4_t pairs2 = vpaddlq_u16(sum2);
+
+        /* [block 0, block 1]. */
+        const uint32x2_t block_sum1     = vpadd_u32(vget_low_u32(pairs1), vget_high_u32(pairs1));
+        const uint32x2_t block_sum2     = vpadd_u32(vget_low_u32(pairs2), vget_high_u32(pairs2));
+        const uint32x2_t block_squares  = vpadd_u32(vget_low_u32(squares), vget_high_u32(squares));
+        const uint32x2_t block_products = vpadd_u32(vget_low_u32(products), vget_high_u32(products));
+
+        sums[block].sum1             = vget_lane_u32(block_sum1, 0);
+        sums[block].sum_squares      = vget_lane_u32(block_squares, 0);
+        sums[block].sum2             = vget_lane_u32(block_sum2, 0);
+        sums[block].sum_products     = vget_lane_u32(block_products, 0);
+        sums[block + 1].sum1         = vget_lane_u32(block_sum1, 1);
+        sums[block + 1].sum_squares  = vget_lane_u32(block_squares, 1);
+        sums[block + 1].sum2         = vget_lane_u32(block_sum2, 1);
+        sums[block + 1].sum_products = vget_lane_u32(block_products, 1);
+    }
+
+    block_sums_c(scan1 + block * 4, stride1, scan2 + block * 4, stride2, count - block, sums + block);
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+void metric_kernels_init(struct metric_kernels *kernels) {
+
+    kernels->squared_error = squared_error_c;
+    kernels->block_sums    = block_sums_c;
+
+#if defined SAIL_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        kernels->squared_error = squared_error_avx2;
+        kernels->block_sums    = block_sums_avx2;
+    } else if (cpu_has_ssse3()) {
+        kernels->squared_error = squared_error_ssse3;
+        kernels->block_sums    = block_sums_ssse3;
+    }
+#elif defined SAIL_HAVE_NEON
+    kernels->squared_error = squared_error_neon;
+    kernels->block_sums    = block_sums_neon;
+#endif
+}
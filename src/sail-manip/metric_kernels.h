@@ -0,0 +1,68 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_METRIC_KERNELS_H
+#define SAIL_METRIC_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+
+/*
+ * Sums of a 4x4 block of two images used to compute SSIM. The field order matches
+ * the order the SIMD kernels store the sums in.
+ */
+struct ssim_block_sums {
+
+    uint32_t sum1;
+    uint32_t sum_squares;
+    uint32_t sum2;
+    uint32_t sum_products;
+};
+
+/*
+ * Inner loops of image quality metrics over 8-bit samples. The kernels use AVX2, SSSE3, or NEON
+ * depending on the CPU, and plain C otherwise. All the implementations produce identical results.
+ */
+struct metric_kernels {
+
+    /* Returns the sum of squared differences of count samples. */
+    uint64_t (*squared_error)(const uint8_t *samples1, const uint8_t *samples2, size_t count);
+
+    /*
+     * Computes the sums of count 4x4 blocks of two grayscale images starting from the specified
+     * scan lines. Strides are the distances between scan lines in bytes.
+     */
+    void (*block_sums)(const uint8_t *scan1, size_t stride1, const uint8_t *scan2, size_t stride2,
+                       unsigned count, struct ssim_block_sums *sums);
+};
+
+/*
+ * Selects the fastest kernels supported by the CPU.
+ */
+SAIL_HIDDEN void metric_kernels_init(struct metric_kernels *kernels);
+
+#endif
@@ -0,0 +1,356 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* SSIM stabilization constants for 8-bit samples. */
+static const double SSIM_C1 = (0.01 * 255) * (0.01 * 255);
+static const double SSIM_C2 = (0.03 * 255) * (0.03 * 255);
+
+static double ssim_from_sums(double sum1, double sum2, double sum_squares, double sum_products, double count) {
+
+    const double mean1 = sum1 / count;
+    const double mean2 = sum2 / count;
+
+    /* Sum of the variances of both images. */
+    const double variances  = sum_squares / count - mean1 * mean1 - mean2 * mean2;
+    const double covariance = sum_products / count - mean1 * mean2;
+
+    return ((2 * mean1 * mean2 + SSIM_C1) * (2 * covariance + SSIM_C2)) /
+            ((mean1 * mean1 + mean2 * mean2 + SSIM_C1) * (variances + SSIM_C2));
+}
+
+/* Converts both images into the pixel format unless they already have it. Converted images must be destroyed. */
+static sail_status_t prepare_images(const struct sail_image *image1, const struct sail_image *image2,
+                                    enum SailPixelFormat pixel_format, const struct sail_conversion_options *options,
+                                    struct sail_image **converted1, struct sail_image **converted2) {
+
+    SAIL_TRY(sail_check_image_valid(image1));
+    SAIL_TRY(sail_check_image_valid(image2));
+
+    if (image1->width != image2->width || image1->height != image2->height) {
+        SAIL_LOG_ERROR("Cannot compare images of different dimensions %ux%u and %ux%u",
+                        image1->width, image1->height, image2->width, image2->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    *converted1 = NULL;
+    *converted2 = NULL;
+
+    if (image1->pixel_format != pixel_format) {
+        SAIL_TRY(sail_convert_image_with_options(image1, pixel_format, options, converted1));
+    }
+
+    if (image2->pixel_format != pixel_format) {
+        SAIL_TRY_OR_CLEANUP(sail_convert_image_with_options(image2, pixel_format, options, converted2),
+                            /* cleanup */ sail_destroy_image(*converted1));
+    }
+
+    return SAIL_OK;
+}
+
+struct squared_error_job {
+
+    const struct sail_image *image1;
+    const struct sail_image *image2;
+
+    size_t row_bytes;
+    unsigned rows_per_block;
+
+    struct metric_kernels kernels;
+
+    /* Sums of squared errors of every block. */
+    uint64_t *sums;
+};
+
+static sail_status_t squared_error_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    struct squared_error_job *job = context;
+
+    uint64_t sum = 0;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        sum += job->kernels.squared_error(sail_scan_line(job->image1, row), sail_scan_line(job->image2, row), job->row_bytes);
+    }
+
+    job->sums[first_row / job->rows_per_block] = sum;
+
+    return SAIL_OK;
+}
+
+static sail_status_t compute_psnr(const struct sail_image *image1, const struct sail_image *image2,
+                                  unsigned max_threads, double *psnr) {
+
+    struct squared_error_job job = {
+        image1,
+        image2,
+        (size_t)image1->width * (sail_bits_per_pixel(image1->pixel_format) / 8),
+        SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image1->width),
+        { NULL, NULL },
+        NULL
+    };
+
+    metric_kernels_init(&job.kernels);
+
+    const unsigned block_count = (image1->height + job.rows_per_block - 1) / job.rows_per_block;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(uint64_t) * block_count, &ptr));
+    job.sums = ptr;
+
+    SAIL_TRY_OR_CLEANUP(parallel_for_rows(image1->height, job.rows_per_block, max_threads, squared_error_row_block, &job),
+                        /* cleanup */ sail_free(ptr));
+
+    uint64_t sum = 0;
+
+    for (unsigned block = 0; block < block_count; block++) {
+        sum += job.sums[block];
+    }
+
+    sail_free(ptr);
+
+    if (sum == 0) {
+        *psnr = INFINITY;
+    } else {
+        const double mean_squared_error = (double)sum / ((double)job.row_bytes * image1->height);
+        *psnr = 10 * log10(255.0 * 255.0 / mean_squared_error);
+    }
+
+    return SAIL_OK;
+}
+
+struct ssim_job {
+
+    const struct sail_image *image1;
+    const struct sail_image *image2;
+
+    /* Number of 4x4 blocks in a row. */
+    unsigned block_columns;
+    unsigned rows_per_block;
+
+    struct metric_kernels kernels;
+
+    /* Sums of window indexes of every block. */
+    double *sums;
+};
+
+static void compute_block_row(const struct ssim_job *job, unsigned block_row, struct ssim_block_sums *sums) {
+
+    job->kernels.block_sums(sail_scan_line(job->image1, block_row * 4), job->image1->bytes_per_line,
+                            sail_scan_line(job->image2, block_row * 4), job->image2->bytes_per_line,
+                            job->block_columns, sums);
+}
+
+/*
+ * Processes the rows of windows. A window row consists of 2x2 blocks from the same block row
+ * and the next one, so block sums are kept for two block rows at a time.
+ */
+static sail_status_t ssim_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    struct ssim_job *job = context;
+
+    const unsigned block_columns = job->block_columns;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct ssim_block_sums) * block_columns * 2, &ptr));
+
+    struct ssim_block_sums *top    = ptr;
+    struct ssim_block_sums *bottom = top + block_columns;
+
+    compute_block_row(job, first_row, top);
+
+    double sum = 0;
+
+    for (unsigned window_row = first_row; window_row < first_row + row_count; window_row++) {
+        compute_block_row(job, window_row + 1, bottom);
+
+        for (unsigned column = 0; column + 1 < block_columns; column++) {
+            const struct ssim_block_sums *s = top + column;
+            const struct ssim_block_sums *t = bottom + column;
+
+            sum += ssim_from_sums(s[0].sum1 + s[1].sum1 + t[0].sum1 + t[1].sum1,
+                                  s[0].sum2 + s[1].sum2 + t[0].sum2 + t[1].sum2,
+                                  s[0].sum_squares + s[1].sum_squares + t[0].sum_squares + t[1].sum_squares,
+                                  s[0].sum_products + s[1].sum_products + t[0].sum_products + t[1].sum_products,
+                                  64);
+        }
+
+        struct ssim_block_sums *tmp = top;
+        top    = bottom;
+        bottom = tmp;
+    }
+
+    sail_free(ptr);
+
+    job->sums[first_row / job->rows_per_block] = sum;
+
+    return SAIL_OK;
+}
+
+/* Compares images smaller than a window as a single window. */
+static double compute_small_ssim(const struct sail_image *image1, const struct sail_image *image2) {
+
+    uint64_t sum1 = 0, sum2 = 0, sum_squares = 0, sum_products = 0;
+
+    for (unsigned row = 0; row < image1->height; row++) {
+        const uint8_t *scan1 = sail_scan_line(image1, row);
+        const uint8_t *scan2 = sail_scan_line(image2, row);
+
+        for (unsigned column = 0; column < image1->width; column++) {
+            const uint64_t a = scan1[column];
+            const uint64_t b = scan2[column];
+
+            sum1         += a;
+            sum2         += b;
+            sum_squares  += a * a + b * b;
+            sum_products += a * b;
+        }
+    }
+
+    return ssim_from_sums((double)sum1, (double)sum2, (double)sum_squares, (double)sum_products,
+                            (double)image1->width * image1->height);
+}
+
+static sail_status_t compute_ssim(const struct sail_image *image1, const struct sail_image *image2,
+                                  unsigned max_threads, double *ssim) {
+
+    const unsigned block_columns = image1->width / 4;
+    const unsigned block_rows    = image1->height / 4;
+
+    if (block_columns < 2 || block_rows < 2) {
+        *ssim = compute_small_ssim(image1, image2);
+        return SAIL_OK;
+    }
+
+    const unsigned window_rows = block_rows - 1;
+
+    struct ssim_job job = {
+        image1,
+        image2,
+        block_columns,
+        SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / (image1->width * 4)),
+        { NULL, NULL },
+        NULL
+    };
+
+    metric_kernels_init(&job.kernels);
+
+    const unsigned block_count = (window_rows + job.rows_per_block - 1) / job.rows_per_block;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(double) * block_count, &ptr));
+    job.sums = ptr;
+
+    SAIL_TRY_OR_CLEANUP(parallel_for_rows(window_rows, job.rows_per_block, max_threads, ssim_row_block, &job),
+                        /* cleanup */ sail_free(ptr));
+
+    double sum = 0;
+
+    for (unsigned block = 0; block < block_count; block++) {
+        sum += job.sums[block];
+    }
+
+    sail_free(ptr);
+
+    *ssim = sum / ((double)window_rows * (block_columns - 1));
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_compute_psnr(const struct sail_image *image1, const struct sail_image *image2, double *psnr) {
+
+    SAIL_TRY(sail_compute_psnr_with_options(image1, image2, NULL, psnr));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_compute_psnr_with_options(const struct sail_image *image1, const struct sail_image *image2,
+                                             const struct sail_conversion_options *options, double *psnr) {
+
+    SAIL_CHECK_PTR(image1);
+    SAIL_CHECK_PTR(image2);
+    SAIL_CHECK_PTR(psnr);
+
+    const enum SailPixelFormat pixel_format = (sail_is_grayscale(image1->pixel_format) && sail_is_grayscale(image2->pixel_format))
+                                                ? SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
+                                                : SAIL_PIXEL_FORMAT_BPP24_RGB;
+
+    struct sail_image *converted1;
+    struct sail_image *converted2;
+    SAIL_TRY(prepare_images(image1, image2, pixel_format, options, &converted1, &converted2));
+
+    SAIL_TRY_OR_CLEANUP(compute_psnr((converted1 == NULL) ? image1 : converted1,
+                                     (converted2 == NULL) ? image2 : converted2,
+                                     (options == NULL) ? 0 : options->max_threads,
+                                     psnr),
+                        /* cleanup */ sail_destroy_image(converted2), sail_destroy_image(converted1));
+
+    sail_destroy_image(converted2);
+    sail_destroy_image(converted1);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_compute_ssim(const struct sail_image *image1, const struct sail_image *image2, double *ssim) {
+
+    SAIL_TRY(sail_compute_ssim_with_options(image1, image2, NULL, ssim));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_compute_ssim_with_options(const struct sail_image *image1, const struct sail_image *image2,
+                                             const struct sail_conversion_options *options, double *ssim) {
+
+    SAIL_CHECK_PTR(image1);
+    SAIL_CHECK_PTR(image2);
+    SAIL_CHECK_PTR(ssim);
+
+    struct sail_image *converted1;
+    struct sail_image *converted2;
+    SAIL_TRY(prepare_images(image1, image2, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &converted1, &converted2));
+
+    SAIL_TRY_OR_CLEANUP(compute_ssim((converted1 == NULL) ? image1 : converted1,
+                                     (converted2 == NULL) ? image2 : converted2,
+                                     (options == NULL) ? 0 : options->max_threads,
+                                     ssim),
+                        /* cleanup */ sail_destroy_image(converted2), sail_destroy_image(converted1));
+
+    sail_destroy_image(converted2);
+    sail_destroy_image(converted1);
+
+    return SAIL_OK;
+}
@@ -0,0 +1,94 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_METRICS_H
+#define SAIL_METRICS_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_conversion_options;
+struct sail_image;
+
+/*
+ * Computes the peak signal-to-noise ratio of the second image relative to the first one in decibels.
+ * The images must have the same dimensions. Identical images get INFINITY.
+ *
+ * The mean squared error is computed over 8-bit samples: both images are converted into BPP8-GRAYSCALE
+ * if they are both grayscale, and into BPP24-RGB otherwise. Images that already have the pixel format
+ * are used as is. Alpha is dropped. Scan lines are compared with up to sail_max_threads() threads.
+ *
+ * Allowed input pixel formats: the ones sail_can_convert() returns true for with the above output
+ * pixel formats.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_compute_psnr(const struct sail_image *image1, const struct sail_image *image2, double *psnr);
+
+/*
+ * Computes the peak signal-to-noise ratio of the second image relative to the first one. Same as
+ * sail_compute_psnr(), but options (which may be NULL) control the conversion behavior, e.g. blending
+ * alpha into a background, and the maximum number of threads.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_compute_psnr_with_options(const struct sail_image *image1, const struct sail_image *image2,
+                                                         const struct sail_conversion_options *options, double *psnr);
+
+/*
+ * Computes the structural similarity index of the second image relative to the first one in the range [-1; 1],
+ * where 1 means identical images. The images must have the same dimensions.
+ *
+ * The index is computed over luma: both images are converted into BPP8-GRAYSCALE unless they already
+ * have it. Alpha is dropped. The index is the mean of the indexes of 8x8 windows placed every 4 pixels,
+ * so up to 3 trailing columns and rows are not taken into account. Images smaller than 8x8 pixels are
+ * compared as a single window. Windows are processed with up to sail_max_threads() threads.
+ *
+ * Allowed input pixel formats: the ones sail_can_convert() returns true for with BPP8-GRAYSCALE output.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_compute_ssim(const struct sail_image *image1, const struct sail_image *image2, double *ssim);
+
+/*
+ * Computes the structural similarity index of the second image relative to the first one. Same as
+ * sail_compute_ssim(), but options (which may be NULL) control the conversion behavior, e.g. blending
+ * alpha into a background, and the maximum number of threads.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_compute_ssim_with_options(const struct sail_image *image1, const struct sail_image *image2,
+                                                         const struct sail_conversion_options *options, double *ssim);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
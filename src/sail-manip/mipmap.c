@@ -0,0 +1,322 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* A single level fed with scan lines of the previous level or the source image. */
+struct mipmap_level {
+    struct sail_image *image;
+
+    /* The number of input scan lines received and output scan lines produced so far. */
+    unsigned received;
+    unsigned produced;
+
+    /* 2x2 blocks are averaged when the box filter halves both sizes exactly. */
+    bool halve;
+
+    /* The even input scan line waiting for its pair. */
+    const void *pending;
+
+    /* Otherwise, input scan lines are blended horizontally into the ring buffer and then vertically. */
+    struct scale_weights horizontal;
+    struct scale_weights vertical;
+
+    uint8_t *ring;
+    unsigned ring_size;
+    unsigned ring_bytes_per_line;
+};
+
+struct mipmap_job {
+    struct scale_kernels kernels;
+    unsigned channels;
+
+    struct mipmap_level *levels;
+    unsigned levels_count;
+
+    /* Input scan lines of the vertical pass. */
+    const void **rows;
+};
+
+/*
+ * Returns the number of the latest input scan lines to keep. Output scan line i is produced right after
+ * the input scan lines up to the largest end of the previous output scan lines have been received.
+ */
+static unsigned mipmap_ring_size(const struct scale_weights *vertical, unsigned output_size) {
+
+    unsigned end  = 0;
+    unsigned size = 1;
+
+    for (unsigned i = 0; i < output_size; i++) {
+        end  = SAIL_MAX(end, vertical->bounds[i] + vertical->counts[i]);
+        size = SAIL_MAX(size, end - vertical->bounds[i]);
+    }
+
+    return size;
+}
+
+static void destroy_mipmap_level(struct mipmap_level *level) {
+
+    destroy_scale_weights(&level->horizontal);
+    destroy_scale_weights(&level->vertical);
+    sail_free(level->ring);
+}
+
+/* Allocates the level image and the filter state. The image is owned by the caller. */
+static sail_status_t init_mipmap_level(const struct sail_image *image, unsigned input_width, unsigned input_height,
+                                        enum SailScaling algorithm, struct mipmap_level *level) {
+
+    const unsigned width  = SAIL_MAX(1U, input_width  / 2);
+    const unsigned height = SAIL_MAX(1U, input_height / 2);
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->bytes_per_line = sail_bytes_per_line(width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image_local->bytes_per_line * height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    level->image = image_local;
+    level->halve = algorithm == SAIL_SCALING_BOX && input_width == width * 2 && input_height == height * 2;
+
+    if (level->halve) {
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(init_scale_weights(input_width, width, algorithm, &level->horizontal));
+    SAIL_TRY(init_scale_weights(input_height, height, algorithm, &level->vertical));
+
+    level->ring_size           = mipmap_ring_size(&level->vertical, height);
+    level->ring_bytes_per_line = width * (sail_bits_per_pixel(image_local->pixel_format) / 8);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc((size_t)level->ring_bytes_per_line * level->ring_size, &ptr));
+    level->ring = ptr;
+
+    return SAIL_OK;
+}
+
+static void cleanup_mipmap_job(struct mipmap_job *job) {
+
+    if (job->levels != NULL) {
+        for (unsigned i = 0; i < job->levels_count; i++) {
+            destroy_mipmap_level(&job->levels[i]);
+        }
+    }
+
+    sail_free(job->levels);
+    sail_free(job->rows);
+}
+
+/* Feeds the next input scan line into the level. Every produced output scan line is fed into the next level right away. */
+static void feed_mipmap_level(struct mipmap_job *job, unsigned index, const void *scan_input) {
+
+    if (index == job->levels_count) {
+        return;
+    }
+
+    struct mipmap_level *level = &job->levels[index];
+    const unsigned width = level->image->width;
+
+    if (level->halve) {
+        if (level->received++ % 2 == 0) {
+            level->pending = scan_input;
+            return;
+        }
+
+        void *scan_output = sail_scan_line(level->image, level->produced++);
+
+        job->kernels.halve(level->pending, scan_input, job->channels, scan_output, width);
+        feed_mipmap_level(job, index + 1, scan_output);
+
+        return;
+    }
+
+    job->kernels.blend_pixels(&level->horizontal, job->channels, scan_input,
+                              level->ring + (size_t)(level->received % level->ring_size) * level->ring_bytes_per_line, width);
+    level->received++;
+
+    const struct scale_weights *vertical = &level->vertical;
+
+    while (level->produced < level->image->height
+            && vertical->bounds[level->produced] + vertical->counts[level->produced] <= level->received) {
+        const unsigned first = vertical->bounds[level->produced];
+        const unsigned count = vertical->counts[level->produced];
+
+        for (unsigned k = 0; k < count; k++) {
+            job->rows[k] = level->ring + (size_t)((first + k) % level->ring_size) * level->ring_bytes_per_line;
+        }
+
+        void *scan_output = sail_scan_line(level->image, level->produced);
+
+        job->kernels.blend_rows(job->rows, vertical->coefficients + (size_t)level->produced * vertical->max_count,
+                                count, scan_output, width * job->channels);
+        level->produced++;
+
+        feed_mipmap_level(job, index + 1, scan_output);
+    }
+}
+
+/* Returns the number of levels down to 1x1 pixels limited by the requested number. */
+static unsigned mipmap_levels_count(unsigned width, unsigned height, unsigned levels) {
+
+    unsigned count = 0;
+
+    while ((width > 1 || height > 1) && (levels == 0 || count < levels)) {
+        width  = SAIL_MAX(1U, width  / 2);
+        height = SAIL_MAX(1U, height / 2);
+        count++;
+    }
+
+    return count;
+}
+
+static sail_status_t generate_mipmaps_impl(const struct sail_image *image, unsigned channels, unsigned bytes_per_channel,
+                                            enum SailScaling algorithm, struct sail_mipmap_chain *chain, struct mipmap_job *job) {
+
+    scale_kernels_init(bytes_per_channel, &job->kernels);
+    job->channels = channels;
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(job->levels_count, sizeof(struct mipmap_level), &ptr));
+    job->levels = ptr;
+
+    unsigned input_width  = image->width;
+    unsigned input_height = image->height;
+    unsigned max_count    = 1;
+
+    for (unsigned i = 0; i < job->levels_count; i++) {
+        struct mipmap_level *level = &job->levels[i];
+
+        const sail_status_t status = init_mipmap_level(image, input_width, input_height, algorithm, level);
+
+        /* The chain owns the level images even if the filter state failed to allocate. */
+        if (level->image != NULL) {
+            chain->levels[chain->levels_count++] = level->image;
+        }
+
+        SAIL_TRY(status);
+
+        input_width  = level->image->width;
+        input_height = level->image->height;
+        max_count    = SAIL_MAX(max_count, level->vertical.max_count);
+    }
+
+    SAIL_TRY(sail_malloc(sizeof(void *) * max_count, &ptr));
+    job->rows = ptr;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        feed_mipmap_level(job, 0, sail_scan_line(image, row));
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_generate_mipmaps(const struct sail_image *image,
+                                    unsigned levels,
+                                    enum SailScaling algorithm,
+                                    struct sail_mipmap_chain **chain) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(chain);
+
+    unsigned channels;
+    unsigned bytes_per_channel;
+
+    if (!scale_layout(image->pixel_format, &channels, &bytes_per_channel)) {
+        SAIL_LOG_ERROR("Generating mipmaps of %s pixels is not supported", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    switch (algorithm) {
+        case SAIL_SCALING_NEAREST_NEIGHBOR:
+        case SAIL_SCALING_BILINEAR:
+        case SAIL_SCALING_BOX:
+        case SAIL_SCALING_LANCZOS3: {
+            break;
+        }
+
+        default: {
+            SAIL_LOG_ERROR("Unknown scaling algorithm %d", algorithm);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_mipmap_chain), &ptr));
+    struct sail_mipmap_chain *chain_local = ptr;
+
+    chain_local->levels       = NULL;
+    chain_local->levels_count = 0;
+
+    struct mipmap_job job = {
+        .levels       = NULL,
+        .levels_count = mipmap_levels_count(image->width, image->height, levels),
+        .rows         = NULL,
+    };
+
+    if (job.levels_count > 0) {
+        SAIL_TRY_OR_CLEANUP(sail_calloc(job.levels_count, sizeof(struct sail_image *), &ptr),
+                            /* cleanup */ sail_destroy_mipmap_chain(chain_local));
+        chain_local->levels = ptr;
+
+        SAIL_TRY_OR_CLEANUP(generate_mipmaps_impl(image, channels, bytes_per_channel, algorithm, chain_local, &job),
+                            /* cleanup */ cleanup_mipmap_job(&job), sail_destroy_mipmap_chain(chain_local));
+
+        cleanup_mipmap_job(&job);
+    }
+
+    *chain = chain_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_mipmap_chain(struct sail_mipmap_chain *chain) {
+
+    if (chain == NULL) {
+        return;
+    }
+
+    for (unsigned i = 0; i < chain->levels_count; i++) {
+        sail_destroy_image(chain->levels[i]);
+    }
+
+    sail_free(chain->levels);
+    sail_free(chain);
+}
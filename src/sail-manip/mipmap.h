@@ -0,0 +1,97 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_MIPMAP_H
+#define SAIL_MIPMAP_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#include <sail-manip/manip_common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * sail_mipmap_chain represents successively downscaled levels of an image.
+ */
+struct sail_mipmap_chain {
+
+    /*
+     * Levels from the largest to the smallest. The first level is half the size of the source image,
+     * and every next level is half the size of the previous one. Odd sizes are rounded down, and
+     * sizes never get less than 1 pixel. The source image itself is not included.
+     */
+    struct sail_image **levels;
+
+    /* Number of levels. */
+    unsigned levels_count;
+};
+
+typedef struct sail_mipmap_chain sail_mipmap_chain_t;
+
+/*
+ * Generates mipmap levels of the image with the algorithm. Levels is the maximum number of levels
+ * to generate, or 0 to generate all the levels down to 1x1 pixels.
+ *
+ * All the levels are generated in a single pass over the source scan lines. Every output scan line
+ * of a level is immediately fed into the next level while it's still in the CPU cache, so neither
+ * the source image nor the levels are read again. Scan lines are processed in the calling thread.
+ *
+ * SAIL_SCALING_BOX averages 2x2 blocks of pixels with SSSE3 or NEON instructions when the CPU
+ * supports them. Levels with odd input sizes are filtered with the box filter widened to cover
+ * all the input pixels. SAIL_SCALING_BILINEAR and SAIL_SCALING_LANCZOS3 produce sharper levels
+ * with the same filters sail_scale_image() uses. SAIL_SCALING_NEAREST_NEIGHBOR takes the pixels
+ * under the centers of the output pixels.
+ *
+ * Every channel is filtered independently, alpha is not premultiplied. See sail_scale_image().
+ *
+ * The levels get updated width, height, and bytes per line. Other properties are copied from
+ * the original image.
+ *
+ * Allowed pixel formats: the ones sail_can_scale() returns true for.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_generate_mipmaps(const struct sail_image *image,
+                                                unsigned levels,
+                                                enum SailScaling algorithm,
+                                                struct sail_mipmap_chain **chain);
+
+/*
+ * Destroys the specified mipmap chain and all its levels.
+ * Does nothing if the chain is NULL.
+ */
+SAIL_EXPORT void sail_destroy_mipmap_chain(struct sail_mipmap_chain *chain);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
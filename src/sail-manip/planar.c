@@ -0,0 +1,164 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+void init_planar_pixels(enum SailPixelFormat pixel_format, const void *pixels, unsigned height,
+                        unsigned bytes_per_line, struct planar_pixels *planar_pixels) {
+
+    void *planes[3];
+    unsigned planes_height[3];
+
+    sail_planes(pixel_format, pixels, height, bytes_per_line, planes, planar_pixels->bytes_per_line, planes_height);
+
+    planar_pixels->pixel_format = pixel_format;
+
+    for (unsigned i = 0; i < 3; i++) {
+        planar_pixels->planes[i] = planes[i];
+    }
+}
+
+void unpack_planar_rows(const struct planar_pixels *planar_pixels, unsigned width, unsigned first_row, unsigned row_count,
+                        uint8_t *output, unsigned output_bytes_per_line) {
+
+    const uint8_t * const *planes = (const uint8_t * const *)planar_pixels->planes;
+    const unsigned *bytes_per_line = planar_pixels->bytes_per_line;
+
+    for (unsigned i = 0; i < row_count; i++) {
+        const unsigned row = first_row + i;
+
+        const uint8_t *scan_y = planes[0] + (size_t)row * bytes_per_line[0];
+        uint8_t *scan_output  = output + (size_t)i * output_bytes_per_line;
+
+        switch (planar_pixels->pixel_format) {
+            case SAIL_PIXEL_FORMAT_BPP12_YUV420P: {
+                const uint8_t *scan_u = planes[1] + (size_t)(row / 2) * bytes_per_line[1];
+                const uint8_t *scan_v = planes[2] + (size_t)(row / 2) * bytes_per_line[2];
+
+                for (unsigned column = 0; column < width; column++) {
+                    *scan_output++ = scan_y[column];
+                    *scan_output++ = scan_u[column / 2];
+                    *scan_output++ = scan_v[column / 2];
+                }
+                break;
+            }
+            case SAIL_PIXEL_FORMAT_BPP12_NV12: {
+                const uint8_t *scan_uv = planes[1] + (size_t)(row / 2) * bytes_per_line[1];
+
+                for (unsigned column = 0; column < width; column++) {
+                    *scan_output++ = scan_y[column];
+                    *scan_output++ = scan_uv[column / 2 * 2 + 0];
+                    *scan_output++ = scan_uv[column / 2 * 2 + 1];
+                }
+                break;
+            }
+            default: {
+                const uint8_t *scan_u = planes[1] + (size_t)row * bytes_per_line[1];
+                const uint8_t *scan_v = planes[2] + (size_t)row * bytes_per_line[2];
+
+                for (unsigned column = 0; column < width; column++) {
+                    *scan_output++ = scan_y[column];
+                    *scan_output++ = scan_u[column];
+                    *scan_output++ = scan_v[column];
+                }
+            }
+        }
+    }
+}
+
+/* Averages the chroma component of 2x2 pixels. Missing pixels at the right and bottom edges are replicated. */
+static inline uint8_t average_chroma(const uint8_t *scan1, const uint8_t *scan2, unsigned column1, unsigned column2, unsigned component) {
+
+    const unsigned sum = scan1[column1 * 3 + component] + scan1[column2 * 3 + component] +
+                            scan2[column1 * 3 + component] + scan2[column2 * 3 + component];
+
+    return (uint8_t)((sum + 2) / 4);
+}
+
+void pack_planar_rows(const uint8_t *input, unsigned input_bytes_per_line, unsigned width, unsigned first_row, unsigned row_count,
+                      const struct planar_pixels *planar_pixels) {
+
+    uint8_t * const *planes = planar_pixels->planes;
+    const unsigned *bytes_per_line = planar_pixels->bytes_per_line;
+
+    const bool full_chroma = planar_pixels->pixel_format == SAIL_PIXEL_FORMAT_BPP24_YUV444P;
+
+    for (unsigned i = 0; i < row_count; i++) {
+        const unsigned row = first_row + i;
+
+        const uint8_t *scan_input = input + (size_t)i * input_bytes_per_line;
+        uint8_t *scan_y = planes[0] + (size_t)row * bytes_per_line[0];
+
+        if (full_chroma) {
+            uint8_t *scan_u = planes[1] + (size_t)row * bytes_per_line[1];
+            uint8_t *scan_v = planes[2] + (size_t)row * bytes_per_line[2];
+
+            for (unsigned column = 0; column < width; column++) {
+                scan_y[column] = *scan_input++;
+                scan_u[column] = *scan_input++;
+                scan_v[column] = *scan_input++;
+            }
+        } else {
+            for (unsigned column = 0; column < width; column++) {
+                scan_y[column] = scan_input[column * 3];
+            }
+        }
+    }
+
+    if (full_chroma) {
+        return;
+    }
+
+    /* 4:2:0 chroma. */
+    for (unsigned i = 0; i < row_count; i += 2) {
+        const unsigned chroma_row = (first_row + i) / 2;
+
+        const uint8_t *scan_input1 = input + (size_t)i * input_bytes_per_line;
+        const uint8_t *scan_input2 = (i + 1 < row_count) ? scan_input1 + input_bytes_per_line : scan_input1;
+
+        if (planar_pixels->pixel_format == SAIL_PIXEL_FORMAT_BPP12_NV12) {
+            uint8_t *scan_uv = planes[1] + (size_t)chroma_row * bytes_per_line[1];
+
+            for (unsigned column = 0; column < width; column += 2) {
+                const unsigned column2 = (column + 1 < width) ? column + 1 : column;
+
+                *scan_uv++ = average_chroma(scan_input1, scan_input2, column, column2, 1);
+                *scan_uv++ = average_chroma(scan_input1, scan_input2, column, column2, 2);
+            }
+        } else {
+            uint8_t *scan_u = planes[1] + (size_t)chroma_row * bytes_per_line[1];
+            uint8_t *scan_v = planes[2] + (size_t)chroma_row * bytes_per_line[2];
+
+            for (unsigned column = 0; column < width; column += 2) {
+                const unsigned column2 = (column + 1 < width) ? column + 1 : column;
+
+                *scan_u++ = average_chroma(scan_input1, scan_input2, column, column2, 1);
+                *scan_v++ = average_chroma(scan_input1, scan_input2, column, column2, 2);
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PLANAR_H
+#define SAIL_PLANAR_H
+
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+
+/* Planes of planar YUV pixels. See sail_planes(). */
+struct planar_pixels {
+    enum SailPixelFormat pixel_format;
+    uint8_t *planes[3];
+    unsigned bytes_per_line[3];
+};
+
+SAIL_HIDDEN void init_planar_pixels(enum SailPixelFormat pixel_format, const void *pixels, unsigned height,
+                                    unsigned bytes_per_line, struct planar_pixels *planar_pixels);
+
+/*
+ * Converts the scan lines [first_row; first_row + row_count) of the planar pixels into
+ * BPP24-YCbCr scan lines. Subsampled chroma is replicated.
+ */
+SAIL_HIDDEN void unpack_planar_rows(const struct planar_pixels *planar_pixels, unsigned width, unsigned first_row, unsigned row_count,
+                                    uint8_t *output, unsigned output_bytes_per_line);
+
+/*
+ * Converts BPP24-YCbCr scan lines into the scan lines [first_row; first_row + row_count) of the planar
+ * pixels. Subsampled chroma is averaged over 2x2 pixels, so for 4:2:0 pixel formats first_row must be
+ * even, and row_count must be even unless the scan lines end the image.
+ */
+SAIL_HIDDEN void pack_planar_rows(const uint8_t *input, unsigned input_bytes_per_line, unsigned width, unsigned first_row, unsigned row_count,
+                                  const struct planar_pixels *planar_pixels);
+
+#endif
@@ -0,0 +1,1112 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* The palette is refined over evenly spaced scan lines with about this number of pixels. */
+static const uint64_t REFINE_PIXELS = 1 << 20;
+
+/*
+ * Histogram bins. Opaque pixels are reduced to 5 bits per channel, translucent pixels to 4 bits
+ * per color channel and 3 bits of alpha. Transparent pixels share the last bin.
+ */
+#define OPAQUE_BINS      32768
+#define TRANSLUCENT_BINS 32768
+#define HISTOGRAM_SIZE   (OPAQUE_BINS + TRANSLUCENT_BINS + 1)
+
+/* Direct-mapped cache of the nearest palette colors. Must be a power of two. */
+#define NEAREST_CACHE_BITS 12
+#define NEAREST_CACHE_SIZE (1 << NEAREST_CACHE_BITS)
+
+#define MAX_PALETTE_COLORS 256
+
+/* Cells of the RGB cube used to search the nearest opaque colors. */
+#define CELL_BITS         4
+#define CELLS_PER_CHANNEL (1 << CELL_BITS)
+#define CELL_COUNT        (CELLS_PER_CHANNEL * CELLS_PER_CHANNEL * CELLS_PER_CHANNEL)
+
+/* Squared differences of R, G, B, and A are weighted by their visual importance. */
+static const int CHANNEL_WEIGHTS[4] = { 3, 4, 2, 4 };
+
+/* 8x8 Bayer matrix for ordered dithering. */
+static const uint8_t BAYER_MATRIX[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+
+/* Colors are packed into 32-bit values. Transparent pixels are all the same. */
+static inline uint32_t pack_color(const uint8_t *pixel) {
+
+    if (pixel[3] == 0) {
+        return 0;
+    }
+
+    return (uint32_t)pixel[0] | ((uint32_t)pixel[1] << 8) | ((uint32_t)pixel[2] << 16) | ((uint32_t)pixel[3] << 24);
+}
+
+static inline void unpack_color(uint32_t color, int channels[4]) {
+
+    channels[0] = (int)(color & 0xFF);
+    channels[1] = (int)((color >> 8) & 0xFF);
+    channels[2] = (int)((color >> 16) & 0xFF);
+    channels[3] = (int)(color >> 24);
+}
+
+static inline unsigned histogram_bin(const uint8_t *pixel) {
+
+    if (pixel[3] == 255) {
+        return ((unsigned)(pixel[0] >> 3) << 10) | ((unsigned)(pixel[1] >> 3) << 5) | (unsigned)(pixel[2] >> 3);
+    } else if (pixel[3] == 0) {
+        return OPAQUE_BINS + TRANSLUCENT_BINS;
+    } else {
+        return OPAQUE_BINS + (((unsigned)(pixel[3] >> 5) << 12) | ((unsigned)(pixel[0] >> 4) << 8)
+                                | ((unsigned)(pixel[1] >> 4) << 4) | (unsigned)(pixel[2] >> 4));
+    }
+}
+
+/* The color in the center of the bin. */
+static void histogram_bin_color(unsigned bin, uint8_t channels[4]) {
+
+    if (bin < OPAQUE_BINS) {
+        channels[0] = (uint8_t)(((bin >> 10) & 0x1F) << 3 | 4);
+        channels[1] = (uint8_t)(((bin >> 5) & 0x1F) << 3 | 4);
+        channels[2] = (uint8_t)((bin & 0x1F) << 3 | 4);
+        channels[3] = 255;
+    } else if (bin == OPAQUE_BINS + TRANSLUCENT_BINS) {
+        memset(channels, 0, 4);
+    } else {
+        bin -= OPAQUE_BINS;
+
+        channels[0] = (uint8_t)(((bin >> 8) & 0xF) << 4 | 8);
+        channels[1] = (uint8_t)(((bin >> 4) & 0xF) << 4 | 8);
+        channels[2] = (uint8_t)((bin & 0xF) << 4 | 8);
+        channels[3] = (uint8_t)((bin >> 12) << 5 | 16);
+    }
+}
+
+static inline int color_distance(const int a[4], const int b[4]) {
+
+    int distance = 0;
+
+    for (unsigned c = 0; c < 4; c++) {
+        distance += CHANNEL_WEIGHTS[c] * (a[c] - b[c]) * (a[c] - b[c]);
+    }
+
+    return distance;
+}
+
+/*
+ * Palette.
+ */
+struct quantize_palette {
+    unsigned count;
+    int colors[MAX_PALETTE_COLORS][4];
+};
+
+/* Translucent colors go first to keep PNG transparency chunks short. */
+static void order_palette(struct quantize_palette *palette) {
+
+    unsigned translucent = 0;
+
+    for (unsigned i = 0; i < palette->count; i++) {
+        if (palette->colors[i][3] != 255) {
+            if (i != translucent) {
+                int color[4];
+                memcpy(color, palette->colors[i], sizeof(color));
+                memmove(palette->colors[translucent + 1], palette->colors[translucent], (i - translucent) * sizeof(palette->colors[0]));
+                memcpy(palette->colors[translucent], color, sizeof(color));
+            }
+
+            translucent++;
+        }
+    }
+}
+
+/*
+ * Nearest color search.
+ *
+ * Opaque colors are searched with locally sorted search. The RGB cube is split into cells, and every
+ * cell gets the list of palette colors that can be the nearest to any color inside the cell. These
+ * are the colors not farther from the cell than the farthest point of the cell from the palette color
+ * closest to it.
+ *
+ * Translucent colors are searched among the palette colors sorted by green. The search goes from
+ * the closest green value in both directions until the green difference alone exceeds the best distance.
+ */
+struct nearest_search {
+    unsigned count;
+    /* Sorted by green. */
+    int colors[MAX_PALETTE_COLORS][4];
+    uint8_t indexes[MAX_PALETTE_COLORS];
+
+    /* Candidates of every cell are at [cell_offsets[cell]; cell_offsets[cell + 1]) in the sorted colors. */
+    unsigned cell_offsets[CELL_COUNT + 1];
+    uint8_t *candidates;
+};
+
+static inline unsigned cell_of(const int color[4]) {
+
+    return ((unsigned)color[0] >> (8 - CELL_BITS) << (2 * CELL_BITS)) | ((unsigned)color[1] >> (8 - CELL_BITS) << CELL_BITS)
+            | ((unsigned)color[2] >> (8 - CELL_BITS));
+}
+
+/* Minimum and maximum weighted squared distances from the color to the opaque cell. */
+static void cell_distances(unsigned cell, const int color[4], int *min_distance, int *max_distance) {
+
+    const int cell_size = 1 << (8 - CELL_BITS);
+    const int alpha = 255 - color[3];
+
+    *min_distance = *max_distance = CHANNEL_WEIGHTS[3] * alpha * alpha;
+
+    for (unsigned c = 0; c < 3; c++) {
+        const int low = (int)((cell >> ((2 - c) * CELL_BITS)) & (CELLS_PER_CHANNEL - 1)) * cell_size;
+        const int high = low + cell_size - 1;
+
+        const int min_difference = (color[c] < low) ? low - color[c] : ((color[c] > high) ? color[c] - high : 0);
+        const int max_difference = SAIL_MAX(color[c] - low, high - color[c]);
+
+        *min_distance += CHANNEL_WEIGHTS[c] * min_difference * min_difference;
+        *max_distance += CHANNEL_WEIGHTS[c] * max_difference * max_difference;
+    }
+}
+
+static sail_status_t init_nearest_search(const struct quantize_palette *palette, struct nearest_search *search) {
+
+    search->count = palette->count;
+
+    /* Insertion sort is fine for 256 colors. */
+    for (unsigned i = 0; i < palette->count; i++) {
+        unsigned k = i;
+
+        while (k > 0 && search->colors[k - 1][1] > palette->colors[i][1]) {
+            memcpy(search->colors[k], search->colors[k - 1], sizeof(search->colors[0]));
+            search->indexes[k] = search->indexes[k - 1];
+            k--;
+        }
+
+        memcpy(search->colors[k], palette->colors[i], sizeof(search->colors[0]));
+        search->indexes[k] = (uint8_t)i;
+    }
+
+    /* Every cell usually has a few candidates. The buffer grows when needed. */
+    size_t capacity = CELL_COUNT * 8;
+    void *ptr;
+    SAIL_TRY(sail_malloc(capacity, &ptr));
+    search->candidates = ptr;
+
+    unsigned offset = 0;
+
+    for (unsigned cell = 0; cell < CELL_COUNT; cell++) {
+        int min_distances[MAX_PALETTE_COLORS];
+        int bound = INT_MAX;
+
+        for (unsigned i = 0; i < search->count; i++) {
+            int max_distance;
+            cell_distances(cell, search->colors[i], &min_distances[i], &max_distance);
+            bound = SAIL_MIN(bound, max_distance);
+        }
+
+        if (offset + search->count > capacity) {
+            capacity *= 2;
+            SAIL_TRY_OR_CLEANUP(sail_realloc(capacity, &ptr),
+                                /* cleanup */ sail_free(search->candidates));
+            search->candidates = ptr;
+        }
+
+        search->cell_offsets[cell] = offset;
+
+        for (unsigned i = 0; i < search->count; i++) {
+            if (min_distances[i] <= bound) {
+                search->candidates[offset++] = (uint8_t)i;
+            }
+        }
+    }
+
+    search->cell_offsets[CELL_COUNT] = offset;
+
+    return SAIL_OK;
+}
+
+static void cleanup_nearest_search(struct nearest_search *search) {
+
+    sail_free(search->candidates);
+}
+
+static uint8_t find_nearest(const struct nearest_search *search, const int color[4]) {
+
+    int best_distance = INT_MAX;
+    unsigned best = 0;
+
+    if (color[3] == 255) {
+        const unsigned cell = cell_of(color);
+
+        for (unsigned k = search->cell_offsets[cell]; k < search->cell_offsets[cell + 1]; k++) {
+            const unsigned i = search->candidates[k];
+            const int distance = color_distance(search->colors[i], color);
+
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = i;
+            }
+        }
+
+        return search->indexes[best];
+    }
+
+    unsigned low = 0;
+    unsigned high = search->count;
+
+    while (low < high) {
+        const unsigned middle = (low + high) / 2;
+
+        if (search->colors[middle][1] < color[1]) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    int down = (int)low - 1;
+    unsigned up = low;
+
+    while (down >= 0 || up < search->count) {
+        if (up < search->count) {
+            const int green = search->colors[up][1] - color[1];
+
+            if (CHANNEL_WEIGHTS[1] * green * green >= best_distance) {
+                up = search->count;
+            } else {
+                const int distance = color_distance(search->colors[up], color);
+
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = up;
+                }
+
+                up++;
+            }
+        }
+
+        if (down >= 0) {
+            const int green = color[1] - search->colors[down][1];
+
+            if (CHANNEL_WEIGHTS[1] * green * green >= best_distance) {
+                down = -1;
+            } else {
+                const int distance = color_distance(search->colors[down], color);
+
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = (unsigned)down;
+                }
+
+                down--;
+            }
+        }
+    }
+
+    return search->indexes[best];
+}
+
+/* Every thread has its own cache, so it's not locked. */
+struct nearest_cache {
+    uint32_t colors[NEAREST_CACHE_SIZE];
+    uint8_t indexes[NEAREST_CACHE_SIZE];
+};
+
+static void init_nearest_cache(const struct nearest_search *search, struct nearest_cache *cache) {
+
+    /* Every slot initially holds the valid entry for the transparent color. */
+    const int transparent[4] = { 0, 0, 0, 0 };
+    const uint8_t index = find_nearest(search, transparent);
+
+    memset(cache->colors, 0, sizeof(cache->colors));
+    memset(cache->indexes, index, sizeof(cache->indexes));
+}
+
+static inline uint8_t find_nearest_cached(const struct nearest_search *search, struct nearest_cache *cache, uint32_t color) {
+
+    const unsigned slot = (unsigned)((color * 2654435761U) >> (32 - NEAREST_CACHE_BITS));
+
+    if (cache->colors[slot] != color) {
+        int channels[4];
+        unpack_color(color, channels);
+
+        cache->colors[slot] = color;
+        cache->indexes[slot] = find_nearest(search, channels);
+    }
+
+    return cache->indexes[slot];
+}
+
+/* Returns true and fills the palette if the image has at most max_colors distinct colors. */
+static bool collect_exact_colors(const struct sail_image *rgba, unsigned max_colors, struct color_set *set, struct quantize_palette *palette) {
+
+    memset(set, 0, sizeof(*set));
+
+    for (unsigned row = 0; row < rgba->height; row++) {
+        const uint8_t *scan = sail_scan_line(rgba, row);
+        uint32_t previous = pack_color(scan);
+
+        if (!add_to_color_set(set, previous, max_colors)) {
+            return false;
+        }
+
+        for (unsigned column = 1; column < rgba->width; column++) {
+            const uint32_t color = pack_color(scan + column * 4);
+
+            if (color != previous) {
+                if (!add_to_color_set(set, color, max_colors)) {
+                    return false;
+                }
+
+                previous = color;
+            }
+        }
+    }
+
+    palette->count = 0;
+
+    for (unsigned i = 0; i < COLOR_SET_SIZE; i++) {
+        if (set->used[i]) {
+            unpack_color((uint32_t)set->colors[i], palette->colors[palette->count++]);
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Statistics collected in parallel.
+ */
+struct palette_sums {
+    uint64_t counts[MAX_PALETTE_COLORS];
+    uint64_t sums[MAX_PALETTE_COLORS][4];
+};
+
+struct statistics_job {
+    const struct sail_image *rgba;
+    unsigned rows_per_block;
+    /* Every row_step-th scan line is processed. */
+    unsigned row_step;
+    /* One histogram of HISTOGRAM_SIZE bins per block. */
+    uint32_t *histograms;
+    /* Or one set of sums per block. */
+    struct palette_sums *sums;
+    const struct nearest_search *search;
+};
+
+static sail_status_t histogram_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct statistics_job *job = context;
+    uint32_t *histogram = job->histograms + (size_t)(first_row / job->rows_per_block) * HISTOGRAM_SIZE;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        const uint8_t *scan = sail_scan_line(job->rgba, row);
+
+        for (unsigned column = 0; column < job->rgba->width; column++, scan += 4) {
+            histogram[histogram_bin(scan)]++;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t sums_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct statistics_job *job = context;
+    struct palette_sums *sums = job->sums + first_row / job->rows_per_block;
+
+    struct nearest_cache cache;
+    init_nearest_cache(job->search, &cache);
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        const uint8_t *scan = sail_scan_line(job->rgba, row * job->row_step);
+
+        for (unsigned column = 0; column < job->rgba->width; column++, scan += 4) {
+            const uint32_t color = pack_color(scan);
+            const uint8_t index = find_nearest_cached(job->search, &cache, color);
+
+            sums->counts[index]++;
+            sums->sums[index][0] += color & 0xFF;
+            sums->sums[index][1] += (color >> 8) & 0xFF;
+            sums->sums[index][2] += (color >> 16) & 0xFF;
+            sums->sums[index][3] += color >> 24;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static unsigned statistics_rows_per_block(unsigned width, unsigned height) {
+
+    const unsigned min_rows = SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / width);
+
+    return SAIL_MAX(min_rows, (height + STATISTICS_BLOCKS - 1) / STATISTICS_BLOCKS);
+}
+
+/*
+ * Median cut.
+ */
+struct histogram_color {
+    uint8_t channels[4];
+    uint32_t count;
+};
+
+struct color_box {
+    unsigned begin;
+    unsigned end;
+    /* Weighted squared error of the colors against their mean. */
+    double error;
+    /* Channel with the largest weighted variance. */
+    unsigned channel;
+};
+
+static void measure_box(const struct histogram_color *colors, struct color_box *box) {
+
+    double count = 0;
+    double sums[4] = { 0, 0, 0, 0 };
+    double squares[4] = { 0, 0, 0, 0 };
+
+    for (unsigned i = box->begin; i < box->end; i++) {
+        const double weight = colors[i].count;
+        count += weight;
+
+        for (unsigned c = 0; c < 4; c++) {
+            const double value = colors[i].channels[c];
+            sums[c]    += weight * value;
+            squares[c] += weight * value * value;
+        }
+    }
+
+    box->error = 0;
+    box->channel = 0;
+    double max_variance = -1;
+
+    for (unsigned c = 0; c < 4; c++) {
+        const double variance = CHANNEL_WEIGHTS[c] * (squares[c] - sums[c] * sums[c] / count);
+        box->error += variance;
+
+        if (variance > max_variance) {
+            max_variance = variance;
+            box->channel = c;
+        }
+    }
+}
+
+/* Stable counting sort of the box colors by the channel. */
+static void sort_box(struct histogram_color *colors, struct histogram_color *temp, const struct color_box *box) {
+
+    unsigned offsets[257];
+    memset(offsets, 0, sizeof(offsets));
+
+    for (unsigned i = box->begin; i < box->end; i++) {
+        offsets[colors[i].channels[box->channel] + 1]++;
+    }
+    for (unsigned v = 1; v < 257; v++) {
+        offsets[v] += offsets[v - 1];
+    }
+    for (unsigned i = box->begin; i < box->end; i++) {
+        temp[offsets[colors[i].channels[box->channel]]++] = colors[i];
+    }
+
+    memcpy(colors + box->begin, temp, (box->end - box->begin) * sizeof(colors[0]));
+}
+
+/* Splits the box at the weighted median. Both halves get at least one color. */
+static unsigned split_box(const struct histogram_color *colors, const struct color_box *box) {
+
+    uint64_t total = 0;
+
+    for (unsigned i = box->begin; i < box->end; i++) {
+        total += colors[i].count;
+    }
+
+    uint64_t accumulated = 0;
+    unsigned split = box->begin + 1;
+
+    for (unsigned i = box->begin; i < box->end - 1; i++) {
+        accumulated += colors[i].count;
+        split = i + 1;
+
+        if (accumulated * 2 >= total) {
+            break;
+        }
+    }
+
+    return split;
+}
+
+static void box_mean(const struct histogram_color *colors, const struct color_box *box, int mean[4]) {
+
+    uint64_t count = 0;
+    uint64_t sums[4] = { 0, 0, 0, 0 };
+
+    for (unsigned i = box->begin; i < box->end; i++) {
+        count += colors[i].count;
+
+        for (unsigned c = 0; c < 4; c++) {
+            sums[c] += (uint64_t)colors[i].count * colors[i].channels[c];
+        }
+    }
+
+    for (unsigned c = 0; c < 4; c++) {
+        mean[c] = (int)((sums[c] + count / 2) / count);
+    }
+}
+
+static sail_status_t median_cut(const uint32_t *histogram, unsigned max_colors, struct quantize_palette *palette) {
+
+    unsigned color_count = 0;
+
+    for (unsigned bin = 0; bin < HISTOGRAM_SIZE; bin++) {
+        if (histogram[bin] > 0) {
+            color_count++;
+        }
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc((size_t)color_count * 2 * sizeof(struct histogram_color), &ptr));
+    struct histogram_color *colors = ptr;
+    struct histogram_color *temp = colors + color_count;
+
+    for (unsigned bin = 0, i = 0; bin < HISTOGRAM_SIZE; bin++) {
+        if (histogram[bin] > 0) {
+            histogram_bin_color(bin, colors[i].channels);
+            colors[i].count = histogram[bin];
+            i++;
+        }
+    }
+
+    struct color_box boxes[MAX_PALETTE_COLORS];
+    unsigned box_count = 1;
+
+    boxes[0].begin = 0;
+    boxes[0].end = color_count;
+    measure_box(colors, &boxes[0]);
+
+    while (box_count < max_colors) {
+        /* Split the box with the largest error. */
+        int largest = -1;
+
+        for (unsigned i = 0; i < box_count; i++) {
+            if (boxes[i].end - boxes[i].begin > 1 && boxes[i].error > 0 && (largest < 0 || boxes[i].error > boxes[largest].error)) {
+                largest = (int)i;
+            }
+        }
+
+        if (largest < 0) {
+            break;
+        }
+
+        struct color_box *box = &boxes[largest];
+        sort_box(colors, temp, box);
+
+        const unsigned split = split_box(colors, box);
+
+        boxes[box_count].begin = split;
+        boxes[box_count].end = box->end;
+        box->end = split;
+
+        measure_box(colors, box);
+        measure_box(colors, &boxes[box_count]);
+        box_count++;
+    }
+
+    palette->count = box_count;
+
+    for (unsigned i = 0; i < box_count; i++) {
+        box_mean(colors, &boxes[i], palette->colors[i]);
+    }
+
+    sail_free(colors);
+
+    return SAIL_OK;
+}
+
+/* The search is only used as a temporary storage. */
+static sail_status_t build_palette(const struct sail_image *rgba, unsigned max_colors, unsigned max_threads,
+                                    struct nearest_search *search, struct quantize_palette *palette) {
+
+    unsigned rows_per_block = statistics_rows_per_block(rgba->width, rgba->height);
+    unsigned block_count = (rgba->height + rows_per_block - 1) / rows_per_block;
+
+    void *ptr;
+    SAIL_TRY(sail_calloc((size_t)block_count * HISTOGRAM_SIZE, sizeof(uint32_t), &ptr));
+
+    struct statistics_job job = {
+        rgba,
+        rows_per_block,
+        1,
+        ptr,
+        NULL,
+        NULL
+    };
+
+    SAIL_TRY_OR_CLEANUP(parallel_for_rows(rgba->height, rows_per_block, max_threads, histogram_row_block, &job),
+                        /* cleanup */ sail_free(job.histograms));
+
+    /* Counts don't overflow as images have less than 2^32 pixels. */
+    for (unsigned block = 1; block < block_count; block++) {
+        const uint32_t *histogram = job.histograms + (size_t)block * HISTOGRAM_SIZE;
+
+        for (unsigned bin = 0; bin < HISTOGRAM_SIZE; bin++) {
+            job.histograms[bin] += histogram[bin];
+        }
+    }
+
+    SAIL_TRY_OR_CLEANUP(median_cut(job.histograms, max_colors, palette),
+                        /* cleanup */ sail_free(job.histograms));
+
+    sail_free(job.histograms);
+
+    /* Refine the palette with one k-means pass over the actual pixels. */
+    const uint64_t pixel_count = (uint64_t)rgba->width * rgba->height;
+    const unsigned row_step = (unsigned)((pixel_count + REFINE_PIXELS - 1) / REFINE_PIXELS);
+    const unsigned sampled_rows = (rgba->height + row_step - 1) / row_step;
+
+    rows_per_block = statistics_rows_per_block(rgba->width, sampled_rows);
+    block_count = (sampled_rows + rows_per_block - 1) / rows_per_block;
+
+    job.rows_per_block = rows_per_block;
+    job.row_step = row_step;
+
+    SAIL_TRY(init_nearest_search(palette, search));
+
+    SAIL_TRY_OR_CLEANUP(sail_calloc(block_count, sizeof(struct palette_sums), &ptr),
+                        /* cleanup */ cleanup_nearest_search(search));
+    job.sums = ptr;
+    job.search = search;
+
+    SAIL_TRY_OR_CLEANUP(parallel_for_rows(sampled_rows, rows_per_block, max_threads, sums_row_block, &job),
+                        /* cleanup */ sail_free(job.sums), cleanup_nearest_search(search));
+
+    cleanup_nearest_search(search);
+
+    for (unsigned block = 1; block < block_count; block++) {
+        for (unsigned i = 0; i < palette->count; i++) {
+            job.sums->counts[i] += job.sums[block].counts[i];
+
+            for (unsigned c = 0; c < 4; c++) {
+                job.sums->sums[i][c] += job.sums[block].sums[i][c];
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < palette->count; i++) {
+        const uint64_t count = job.sums->counts[i];
+
+        if (count > 0) {
+            for (unsigned c = 0; c < 4; c++) {
+                palette->colors[i][c] = (int)((job.sums->sums[i][c] + count / 2) / count);
+            }
+        }
+    }
+
+    sail_free(job.sums);
+
+    return SAIL_OK;
+}
+
+/*
+ * Mapping pixels to palette indexes.
+ */
+struct mapping_job {
+    const struct sail_image *rgba;
+    struct sail_image *image_output;
+    const struct nearest_search *search;
+    enum SailDithering dithering;
+    /* Amplitude of ordered dithering. */
+    int spread;
+    const struct sail_cancel_token *cancel_token;
+};
+
+static inline uint8_t clamp_channel(int value) {
+
+    return (uint8_t)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+}
+
+/* Packs 8-bit indexes into 1, 2, and 4-bit pixels from the most significant bits. */
+static void store_indexes(const uint8_t *indexes, unsigned width, unsigned bits_per_pixel, uint8_t *scan) {
+
+    const unsigned pixels_per_byte = 8 / bits_per_pixel;
+
+    for (unsigned column = 0; column < width; column += pixels_per_byte) {
+        uint8_t byte = 0;
+
+        for (unsigned k = 0; k < pixels_per_byte; k++) {
+            const uint8_t index = (column + k < width) ? indexes[column + k] : 0;
+            byte |= (uint8_t)(index << (8 - bits_per_pixel * (k + 1)));
+        }
+
+        *scan++ = byte;
+    }
+}
+
+static sail_status_t alloc_index_row(const struct sail_image *image_output, uint8_t **indexes) {
+
+    if (image_output->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED) {
+        *indexes = NULL;
+    } else {
+        void *ptr;
+        SAIL_TRY(sail_malloc(image_output->width, &ptr));
+        *indexes = ptr;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t map_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct mapping_job *job = context;
+    const unsigned bits_per_pixel = sail_bits_per_pixel(job->image_output->pixel_format);
+    const unsigned width = job->rgba->width;
+
+    if (job->cancel_token != NULL) {
+        SAIL_TRY(sail_check_cancel_token(job->cancel_token));
+    }
+
+    uint8_t *index_row;
+    SAIL_TRY(alloc_index_row(job->image_output, &index_row));
+
+    struct nearest_cache cache;
+    init_nearest_cache(job->search, &cache);
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        const uint8_t *scan = sail_scan_line(job->rgba, row);
+        uint8_t *scan_output = sail_scan_line(job->image_output, row);
+        uint8_t *indexes = (index_row == NULL) ? scan_output : index_row;
+
+        if (job->dithering == SAIL_DITHERING_ORDERED) {
+            const uint8_t *thresholds = BAYER_MATRIX[row & 7];
+
+            for (unsigned column = 0; column < width; column++, scan += 4) {
+                /* Alpha is not dithered, so opaque and transparent pixels stay such. */
+                if (scan[3] == 0) {
+                    indexes[column] = find_nearest_cached(job->search, &cache, 0);
+                    continue;
+                }
+
+                const int offset = ((int)thresholds[column & 7] * 2 - 63) * job->spread / 128;
+                const uint8_t pixel[4] = {
+                    clamp_channel(scan[0] + offset),
+                    clamp_channel(scan[1] + offset),
+                    clamp_channel(scan[2] + offset),
+                    scan[3]
+                };
+
+                indexes[column] = find_nearest_cached(job->search, &cache, pack_color(pixel));
+            }
+        } else {
+            for (unsigned column = 0; column < width; column++, scan += 4) {
+                indexes[column] = find_nearest_cached(job->search, &cache, pack_color(scan));
+            }
+        }
+
+        if (index_row != NULL) {
+            store_indexes(index_row, width, bits_per_pixel, scan_output);
+        }
+    }
+
+    sail_free(index_row);
+
+    return SAIL_OK;
+}
+
+/*
+ * Floyd-Steinberg dithering in serpentine order. Errors of color channels are kept in 1/16 units.
+ * Errors don't flow into or out of transparent pixels.
+ */
+static sail_status_t map_floyd_steinberg(const struct mapping_job *job, const struct quantize_palette *palette) {
+
+    const unsigned width = job->rgba->width;
+    const unsigned bits_per_pixel = sail_bits_per_pixel(job->image_output->pixel_format);
+
+    uint8_t *index_row;
+    SAIL_TRY(alloc_index_row(job->image_output, &index_row));
+
+    /* Two rows of errors with an extra pixel on both sides. */
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_calloc((size_t)(width + 2) * 2 * 3, sizeof(int), &ptr),
+                        /* cleanup */ sail_free(index_row));
+    int *error_rows = ptr;
+    int *errors = error_rows;
+    int *next_errors = error_rows + (width + 2) * 3;
+
+    struct nearest_cache cache;
+    init_nearest_cache(job->search, &cache);
+
+    for (unsigned row = 0; row < job->rgba->height; row++) {
+        if (job->cancel_token != NULL && row % CANCEL_CHECK_ROWS == 0) {
+            SAIL_TRY_OR_CLEANUP(sail_check_cancel_token(job->cancel_token),
+                                /* cleanup */ sail_free(error_rows), sail_free(index_row));
+        }
+
+        const uint8_t *scan = sail_scan_line(job->rgba, row);
+        uint8_t *scan_output = sail_scan_line(job->image_output, row);
+        uint8_t *indexes = (index_row == NULL) ? scan_output : index_row;
+
+        const bool reverse = (row % 2) == 1;
+        const int step = reverse ? -1 : 1;
+
+        memset(next_errors, 0, (size_t)(width + 2) * 3 * sizeof(int));
+
+        for (unsigned i = 0; i < width; i++) {
+            const unsigned column = reverse ? width - 1 - i : i;
+            const uint8_t *pixel = scan + column * 4;
+
+            if (pixel[3] == 0) {
+                indexes[column] = find_nearest_cached(job->search, &cache, 0);
+                continue;
+            }
+
+            /* Errors of the pixel are at column + 1. */
+            int *error = errors + (column + 1) * 3;
+            int *next_error = next_errors + (column + 1) * 3;
+
+            const uint8_t adjusted[4] = {
+                clamp_channel(pixel[0] + (error[0] + 8) / 16),
+                clamp_channel(pixel[1] + (error[1] + 8) / 16),
+                clamp_channel(pixel[2] + (error[2] + 8) / 16),
+                pixel[3]
+            };
+
+            const uint8_t index = find_nearest_cached(job->search, &cache, pack_color(adjusted));
+            indexes[column] = index;
+
+            for (int c = 0; c < 3; c++) {
+                const int difference = adjusted[c] - palette->colors[index][c];
+
+                error[step * 3 + c]       += difference * 7;
+                next_error[-step * 3 + c] += difference * 3;
+                next_error[c]             += difference * 5;
+                next_error[step * 3 + c]  += difference;
+            }
+        }
+
+        if (index_row != NULL) {
+            store_indexes(index_row, width, bits_per_pixel, scan_output);
+        }
+
+        int *swap = errors;
+        errors = next_errors;
+        next_errors = swap;
+    }
+
+    sail_free(error_rows);
+    sail_free(index_row);
+
+    return SAIL_OK;
+}
+
+static sail_status_t store_palette(const struct quantize_palette *palette, struct sail_palette **sail_palette) {
+
+    bool translucent = false;
+
+    for (unsigned i = 0; i < palette->count; i++) {
+        if (palette->colors[i][3] != 255) {
+            translucent = true;
+            break;
+        }
+    }
+
+    struct sail_palette *palette_local;
+    SAIL_TRY(sail_alloc_palette_for_data(translucent ? SAIL_PIXEL_FORMAT_BPP32_RGBA : SAIL_PIXEL_FORMAT_BPP24_RGB,
+                                            palette->count, &palette_local));
+
+    uint8_t *entry = palette_local->data;
+
+    for (unsigned i = 0; i < palette->count; i++) {
+        *entry++ = (uint8_t)palette->colors[i][0];
+        *entry++ = (uint8_t)palette->colors[i][1];
+        *entry++ = (uint8_t)palette->colors[i][2];
+
+        if (translucent) {
+            *entry++ = (uint8_t)palette->colors[i][3];
+        }
+    }
+
+    *sail_palette = palette_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t quantize_impl(const struct sail_image *rgba, unsigned max_colors, enum SailDithering dithering,
+                                    const struct sail_conversion_options *options, struct sail_image *image_output) {
+
+    const unsigned max_threads = (options == NULL) ? 0 : options->max_threads;
+
+    /* Large structures are allocated together. The compiler aligns every member. */
+    struct quantize_state {
+        struct color_set set;
+        struct nearest_search search;
+        struct quantize_palette palette;
+    };
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct quantize_state), &ptr));
+
+    struct quantize_state *state = ptr;
+    struct color_set *set = &state->set;
+    struct nearest_search *search = &state->search;
+    struct quantize_palette *palette = &state->palette;
+
+    /* Dithering is useless when all the colors fit into the palette. */
+    if (collect_exact_colors(rgba, max_colors, set, palette)) {
+        dithering = SAIL_DITHERING_NONE;
+    } else {
+        SAIL_TRY_OR_CLEANUP(build_palette(rgba, max_colors, max_threads, search, palette),
+                            /* cleanup */ sail_free(ptr));
+    }
+
+    order_palette(palette);
+
+    SAIL_TRY_OR_CLEANUP(init_nearest_search(palette, search),
+                        /* cleanup */ sail_free(ptr));
+
+    const struct mapping_job job = {
+        rgba,
+        image_output,
+        search,
+        dithering,
+        (int)(128 / cbrt(palette->count)),
+        (options == NULL) ? NULL : options->cancel_token
+    };
+
+    const sail_status_t status = (dithering == SAIL_DITHERING_FLOYD_STEINBERG)
+                                    ? map_floyd_steinberg(&job, palette)
+                                    : parallel_for_rows(rgba->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / rgba->width), max_threads,
+                                                        map_row_block, (void *)&job);
+
+    cleanup_nearest_search(search);
+
+    SAIL_TRY_OR_CLEANUP(status,
+                        /* cleanup */ sail_free(ptr));
+
+    SAIL_TRY_OR_CLEANUP(store_palette(palette, &image_output->palette),
+                        /* cleanup */ sail_free(ptr));
+
+    sail_free(ptr);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_quantize_image(const struct sail_image *image,
+                                  enum SailPixelFormat output_pixel_format,
+                                  unsigned max_colors,
+                                  enum SailDithering dithering,
+                                  struct sail_image **image_output) {
+
+    SAIL_TRY(sail_quantize_image_with_options(image, output_pixel_format, max_colors, dithering, NULL /* options */, image_output));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_quantize_image_with_options(const struct sail_image *image,
+                                               enum SailPixelFormat output_pixel_format,
+                                               unsigned max_colors,
+                                               enum SailDithering dithering,
+                                               const struct sail_conversion_options *options,
+                                               struct sail_image **image_output) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(image_output);
+
+    if (!sail_is_indexed(output_pixel_format) || !sail_can_quantize(image->pixel_format)) {
+        SAIL_LOG_ERROR("Cannot quantize %s pixels into %s pixels",
+                        sail_pixel_format_to_string(image->pixel_format),
+                        sail_pixel_format_to_string(output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const unsigned max_colors_limit = 1U << sail_bits_per_pixel(output_pixel_format);
+
+    if (max_colors > max_colors_limit) {
+        SAIL_LOG_ERROR("Cannot quantize into %u colors of %s pixels", max_colors, sail_pixel_format_to_string(output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (max_colors == 0) {
+        max_colors = max_colors_limit;
+    }
+
+    struct sail_image *rgba = NULL;
+
+    if (options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
+        /* Blend alpha through RGB to get opaque pixels. */
+        struct sail_image *rgb;
+        SAIL_TRY(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP24_RGB, options, &rgb));
+        SAIL_TRY_OR_CLEANUP(sail_convert_image(rgb, SAIL_PIXEL_FORMAT_BPP32_RGBA, &rgba),
+                            /* cleanup */ sail_destroy_image(rgb));
+        sail_destroy_image(rgb);
+    } else if (image->pixel_format != SAIL_PIXEL_FORMAT_BPP32_RGBA) {
+        SAIL_TRY(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, options, &rgba));
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_copy_image_skeleton(image, &image_local),
+                        /* cleanup */ sail_destroy_image(rgba));
+
+    image_local->pixel_format = output_pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image_local->bytes_per_line * image_local->height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local), sail_destroy_image(rgba));
+
+    SAIL_TRY_OR_CLEANUP(quantize_impl((rgba == NULL) ? image : rgba, max_colors, dithering, options, image_local),
+                        /* cleanup */ sail_destroy_image(image_local), sail_destroy_image(rgba));
+
+    sail_destroy_image(rgba);
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
+
+bool sail_can_quantize(enum SailPixelFormat pixel_format) {
+
+    return sail_can_convert(pixel_format, SAIL_PIXEL_FORMAT_BPP32_RGBA);
+}
@@ -0,0 +1,104 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_QUANTIZE_H
+#define SAIL_QUANTIZE_H
+
+#include <stdbool.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#include <sail-manip/manip_common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_conversion_options;
+struct sail_image;
+
+/*
+ * Quantizes the input image into the indexed output pixel format and saves the result
+ * in the output image with a new palette of up to max_colors colors. Zero max_colors means
+ * the maximum number of colors of the output pixel format, i.e. 2, 4, 16, or 256.
+ *
+ * Images with no more distinct colors than max_colors are converted losslessly. Otherwise,
+ * the palette is built with the variance-based median cut over a histogram of reduced colors
+ * refined with one pass of k-means over the actual pixels, and pixels are mapped to the nearest
+ * palette colors with the dithering algorithm. Histograms are collected and pixels are mapped
+ * with up to sail_max_threads() threads. Floyd-Steinberg dithering maps pixels in the calling thread.
+ *
+ * Translucent pixels produce BPP32-RGBA palettes with translucent colors placed first. Other images
+ * produce BPP24-RGB palettes.
+ *
+ * Options (which may be NULL) control the conversion of the input pixels into BPP32-RGBA before
+ * quantizing. With SAIL_CONVERSION_OPTION_BLEND_ALPHA, alpha is blended into the background first,
+ * so the palette is always BPP24-RGB.
+ *
+ * The resulting image gets the output pixel format, bytes per line, and the new palette. Other
+ * properties are copied from the original image.
+ *
+ * Allowed input pixel formats: the ones sail_can_quantize() returns true for.
+ *
+ * Allowed output pixel formats:
+ *   - SAIL_PIXEL_FORMAT_BPP1_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP2_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP4_INDEXED
+ *   - SAIL_PIXEL_FORMAT_BPP8_INDEXED
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_quantize_image(const struct sail_image *image,
+                                              enum SailPixelFormat output_pixel_format,
+                                              unsigned max_colors,
+                                              enum SailDithering dithering,
+                                              struct sail_image **image_output);
+
+/*
+ * Quantizes the input image into the indexed output pixel format. Same as sail_quantize_image(),
+ * but options (which may be NULL) control the conversion behavior.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_quantize_image_with_options(const struct sail_image *image,
+                                                           enum SailPixelFormat output_pixel_format,
+                                                           unsigned max_colors,
+                                                           enum SailDithering dithering,
+                                                           const struct sail_conversion_options *options,
+                                                           struct sail_image **image_output);
+
+/*
+ * Returns true if images of the pixel format can be quantized with sail_quantize_image().
+ */
+SAIL_EXPORT bool sail_can_quantize(enum SailPixelFormat pixel_format);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
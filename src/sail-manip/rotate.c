@@ -0,0 +1,365 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Output pixel (row, column) is the input pixel (x, y) where x = row and y = column when transposing,
+ * and x = column and y = row otherwise. Then x and y are flipped when requested.
+ */
+struct rotate_job {
+
+    const struct sail_image *image;
+    struct sail_image *image_output;
+
+    unsigned bits_per_pixel;
+
+    /* Zero for pixels smaller than a byte. */
+    unsigned bytes_per_pixel;
+
+    bool transpose;
+    bool flip_x;
+    bool flip_y;
+
+    /* Width and height of the tiles transposed at once, a multiple of the kernel block size. */
+    unsigned tile_size;
+    struct rotate_kernels kernels;
+};
+
+static bool rotate_layout(enum SailPixelFormat pixel_format, unsigned *bits_per_pixel) {
+
+    if (sail_is_planar(pixel_format)) {
+        return false;
+    }
+
+    *bits_per_pixel = sail_bits_per_pixel(pixel_format);
+
+    switch (*bits_per_pixel) {
+        case 0: {
+            return false;
+        }
+        case 1:
+        case 2:
+        case 4: {
+            return true;
+        }
+        default: {
+            return *bits_per_pixel % 8 == 0;
+        }
+    }
+}
+
+static sail_status_t init_rotate_job(enum SailOrientation orientation, struct rotate_job *job) {
+
+    job->transpose = false;
+    job->flip_x    = false;
+    job->flip_y    = false;
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_NORMAL:                            { break; }
+        case SAIL_ORIENTATION_ROTATED_90:                        { job->transpose = true; job->flip_y = true; break; }
+        case SAIL_ORIENTATION_ROTATED_180:                       { job->flip_x = true;    job->flip_y = true; break; }
+        case SAIL_ORIENTATION_ROTATED_270:                       { job->transpose = true; job->flip_x = true; break; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY:             { job->flip_x = true; break; }
+        case SAIL_ORIENTATION_MIRRORED_VERTICALLY:               { job->flip_y = true; break; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90:  { job->transpose = true; job->flip_x = true; job->flip_y = true; break; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270: { job->transpose = true; break; }
+
+        default: {
+            SAIL_LOG_ERROR("Unsupported orientation %d", orientation);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    if (!rotate_layout(job->image->pixel_format, &job->bits_per_pixel)) {
+        SAIL_LOG_ERROR("Rotating %s pixels is not supported", sail_pixel_format_to_string(job->image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    job->bytes_per_pixel = job->bits_per_pixel / 8;
+
+    rotate_kernels_init(job->bytes_per_pixel, &job->kernels);
+
+    /* Input and output tiles of up to 32 KiB together, both are multiples of any block size. */
+    job->tile_size = (job->bytes_per_pixel > 4) ? 32 : 64;
+
+    return SAIL_OK;
+}
+
+static inline unsigned input_x(const struct rotate_job *job, unsigned x) {
+
+    return job->flip_x ? job->image->width - 1 - x : x;
+}
+
+static inline unsigned input_y(const struct rotate_job *job, unsigned y) {
+
+    return job->flip_y ? job->image->height - 1 - y : y;
+}
+
+/* 1, 2, and 4-bit pixels are packed starting from the most significant bit. */
+static inline unsigned get_packed_pixel(const uint8_t *scan, unsigned x, unsigned bits_per_pixel) {
+
+    const size_t bit = (size_t)x * bits_per_pixel;
+
+    return (scan[bit / 8] >> (8 - bits_per_pixel - bit % 8)) & ((1U << bits_per_pixel) - 1);
+}
+
+static inline void set_packed_pixel(uint8_t *scan, unsigned x, unsigned bits_per_pixel, unsigned value) {
+
+    const size_t bit = (size_t)x * bits_per_pixel;
+    const unsigned shift = 8 - bits_per_pixel - (unsigned)(bit % 8);
+
+    scan[bit / 8] |= (uint8_t)(value << shift);
+}
+
+static sail_status_t rotate_packed_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct rotate_job *job = context;
+
+    const struct sail_image *image_output = job->image_output;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        uint8_t *scan_output = sail_scan_line(image_output, row);
+
+        memset(scan_output, 0, image_output->bytes_per_line);
+
+        for (unsigned column = 0; column < image_output->width; column++) {
+            const unsigned x = input_x(job, job->transpose ? row : column);
+            const unsigned y = input_y(job, job->transpose ? column : row);
+
+            set_packed_pixel(scan_output, column, job->bits_per_pixel,
+                                get_packed_pixel(sail_scan_line(job->image, y), x, job->bits_per_pixel));
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static inline void reverse_pixels_c(const uint8_t *input, uint8_t *output, unsigned width, unsigned bytes_per_pixel) {
+
+    for (unsigned x = 0; x < width; x++) {
+        memcpy(output + (size_t)x * bytes_per_pixel, input + (size_t)(width - 1 - x) * bytes_per_pixel, bytes_per_pixel);
+    }
+}
+
+/* Pixels of common sizes are copied with constant-size memcpy() calls. */
+static void reverse_pixels(const uint8_t *input, uint8_t *output, unsigned width, unsigned bytes_per_pixel) {
+
+    switch (bytes_per_pixel) {
+        case 1:  { reverse_pixels_c(input, output, width, 1); break; }
+        case 2:  { reverse_pixels_c(input, output, width, 2); break; }
+        case 3:  { reverse_pixels_c(input, output, width, 3); break; }
+        case 4:  { reverse_pixels_c(input, output, width, 4); break; }
+        case 6:  { reverse_pixels_c(input, output, width, 6); break; }
+        case 8:  { reverse_pixels_c(input, output, width, 8); break; }
+        default: { reverse_pixels_c(input, output, width, bytes_per_pixel); break; }
+    }
+}
+
+/* Copies scan lines when the image is not transposed. */
+static sail_status_t flip_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct rotate_job *job = context;
+
+    const unsigned width = job->image_output->width;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        const uint8_t *scan_input = sail_scan_line(job->image, input_y(job, row));
+        uint8_t *scan_output = sail_scan_line(job->image_output, row);
+
+        if (job->flip_x) {
+            reverse_pixels(scan_input, scan_output, width, job->bytes_per_pixel);
+        } else {
+            memcpy(scan_output, scan_input, (size_t)width * job->bytes_per_pixel);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+/* Copies output pixels one by one. */
+static void transpose_pixels(const struct rotate_job *job, unsigned first_row, unsigned row_count, unsigned first_column, unsigned column_count) {
+
+    const unsigned bytes_per_pixel = job->bytes_per_pixel;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        uint8_t *scan_output = (uint8_t *)sail_scan_line(job->image_output, row) + (size_t)first_column * bytes_per_pixel;
+        const size_t offset = (size_t)input_x(job, row) * bytes_per_pixel;
+
+        for (unsigned column = first_column; column < first_column + column_count; column++) {
+            memcpy(scan_output, (const uint8_t *)sail_scan_line(job->image, input_y(job, column)) + offset, bytes_per_pixel);
+            scan_output += bytes_per_pixel;
+        }
+    }
+}
+
+/*
+ * Transposes the block of output pixels starting at the row and column. Flipped input rows are
+ * read with a negative stride. Flipped input columns become output rows written with a negative stride.
+ */
+static void transpose_block_at(const struct rotate_job *job, ptrdiff_t input_stride, ptrdiff_t output_stride, unsigned row, unsigned column) {
+
+    const unsigned block_size = job->kernels.block_size;
+
+    const unsigned x = job->flip_x ? job->image->width - block_size - row : row;
+    const unsigned output_row = job->flip_x ? row + block_size - 1 : row;
+
+    job->kernels.transpose_block((const uint8_t *)sail_scan_line(job->image, input_y(job, column)) + (size_t)x * job->bytes_per_pixel,
+                                    input_stride,
+                                    (uint8_t *)sail_scan_line(job->image_output, output_row) + (size_t)column * job->bytes_per_pixel,
+                                    output_stride);
+}
+
+/* Transposes tiles row by row, so the input and output pixels of every tile stay in the cache. */
+static sail_status_t transpose_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct rotate_job *job = context;
+
+    const unsigned width      = job->image_output->width;
+    const unsigned last_row   = first_row + row_count;
+    const unsigned block_size = job->kernels.block_size;
+
+    const ptrdiff_t input_stride  = job->flip_y ? -(ptrdiff_t)job->image->bytes_per_line : (ptrdiff_t)job->image->bytes_per_line;
+    const ptrdiff_t output_stride = job->flip_x ? -(ptrdiff_t)job->image_output->bytes_per_line : (ptrdiff_t)job->image_output->bytes_per_line;
+
+    for (unsigned tile_row = first_row; tile_row < last_row; tile_row += job->tile_size) {
+        const unsigned tile_rows = SAIL_MIN(job->tile_size, last_row - tile_row);
+
+        for (unsigned tile_column = 0; tile_column < width; tile_column += job->tile_size) {
+            const unsigned tile_columns = SAIL_MIN(job->tile_size, width - tile_column);
+
+            unsigned row = 0;
+
+            if (job->kernels.transpose_block != NULL) {
+                for (; tile_rows - row >= block_size; row += block_size) {
+                    unsigned column = 0;
+
+                    for (; tile_columns - column >= block_size; column += block_size) {
+                        transpose_block_at(job, input_stride, output_stride, tile_row + row, tile_column + column);
+                    }
+
+                    transpose_pixels(job, tile_row + row, block_size, tile_column + column, tile_columns - column);
+                }
+            }
+
+            transpose_pixels(job, tile_row + row, tile_rows - row, tile_column, tile_columns);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t rotate_impl(struct rotate_job *job) {
+
+    const struct sail_image *image_output = job->image_output;
+
+    if (job->bytes_per_pixel == 0) {
+        SAIL_TRY(parallel_for_rows(image_output->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image_output->width), 0,
+                                    rotate_packed_row_block, job));
+    } else if (job->transpose) {
+        /* Whole rows of tiles. */
+        const unsigned tile_rows = SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / (job->tile_size * image_output->width));
+
+        SAIL_TRY(parallel_for_rows(image_output->height, tile_rows * job->tile_size, 0,
+                                    transpose_row_block, job));
+    } else {
+        SAIL_TRY(parallel_for_rows(image_output->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image_output->width), 0,
+                                    flip_row_block, job));
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_rotate_image(const struct sail_image *image,
+                                enum SailOrientation orientation,
+                                struct sail_image **image_output) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(image_output);
+
+    struct rotate_job job = { .image = image };
+    SAIL_TRY(init_rotate_job(orientation, &job));
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+
+    if (job.transpose) {
+        image_local->width  = image->height;
+        image_local->height = image->width;
+
+        if (image_local->resolution != NULL) {
+            const double x = image_local->resolution->x;
+
+            image_local->resolution->x = image_local->resolution->y;
+            image_local->resolution->y = x;
+        }
+    }
+
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    if (image->palette != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_copy_palette(image->palette, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image_local->bytes_per_line * image_local->height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    job.image_output = image_local;
+
+    SAIL_TRY_OR_CLEANUP(rotate_impl(&job),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_transpose_image(const struct sail_image *image, struct sail_image **image_output) {
+
+    SAIL_TRY(sail_rotate_image(image, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270, image_output));
+
+    return SAIL_OK;
+}
+
+bool sail_can_rotate(enum SailPixelFormat pixel_format) {
+
+    unsigned bits_per_pixel;
+
+    return rotate_layout(pixel_format, &bits_per_pixel);
+}
@@ -0,0 +1,87 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ROTATE_H
+#define SAIL_ROTATE_H
+
+#include <stdbool.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * Rotates or mirrors the input image and saves the result in the output image. The orientation
+ * specifies the transformation:
+ *   - SAIL_ORIENTATION_NORMAL copies the image
+ *   - SAIL_ORIENTATION_ROTATED_90, SAIL_ORIENTATION_ROTATED_180, and SAIL_ORIENTATION_ROTATED_270
+ *     rotate the image clockwise
+ *   - SAIL_ORIENTATION_MIRRORED_HORIZONTALLY and SAIL_ORIENTATION_MIRRORED_VERTICALLY mirror the image
+ *   - SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90 and SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270
+ *     mirror the image horizontally and then rotate it clockwise. The latter transposes the image.
+ *
+ * These are the transformations that display images with the matching EXIF orientations upright.
+ *
+ * Rotations by 90 and 270 degrees transpose the image in small tiles that fit into the CPU cache.
+ * 8, 16, 32, and 64-bit pixels are transposed with AVX2, SSSE3, or NEON instructions when the CPU
+ * supports them. Scan lines are processed with up to sail_max_threads() threads.
+ *
+ * The resulting image gets swapped width, height, and resolution when the transformation rotates
+ * the image by 90 or 270 degrees. Other properties, including the palette, are copied from
+ * the original image.
+ *
+ * Allowed pixel formats: interleaved pixel formats with 1, 2, 4, or a multiple of 8 bits per pixel.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_rotate_image(const struct sail_image *image,
+                                            enum SailOrientation orientation,
+                                            struct sail_image **image_output);
+
+/*
+ * Swaps rows and columns of the input image and saves the result in the output image.
+ * Same as sail_rotate_image() with SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_transpose_image(const struct sail_image *image, struct sail_image **image_output);
+
+/*
+ * Returns true if images of the pixel format can be rotated with sail_rotate_image().
+ */
+SAIL_EXPORT bool sail_can_rotate(enum SailPixelFormat pixel_format);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,389 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#ifdef SAIL_HAVE_NEON
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+/* Blocks transposed with plain C. Pixels of the same size are copied with constant-size memcpy() calls. */
+enum { C_BLOCK_SIZE = 8 };
+
+static inline void transpose_block_c(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride, unsigned bytes_per_pixel) {
+
+    for (unsigned j = 0; j < C_BLOCK_SIZE; j++) {
+        uint8_t *output_row = output + (ptrdiff_t)j * output_stride;
+        const uint8_t *input_column = input + (size_t)j * bytes_per_pixel;
+
+        for (unsigned i = 0; i < C_BLOCK_SIZE; i++) {
+            memcpy(output_row + (size_t)i * bytes_per_pixel, input_column + (ptrdiff_t)i * input_stride, bytes_per_pixel);
+        }
+    }
+}
+
+static void transpose_block1_c(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+    transpose_block_c(input, input_stride, output, output_stride, 1);
+}
+
+static void transpose_block2_c(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+    transpose_block_c(input, input_stride, output, output_stride, 2);
+}
+
+static void transpose_block3_c(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+    transpose_block_c(input, input_stride, output, output_stride, 3);
+}
+
+static void transpose_block4_c(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+    transpose_block_c(input, input_stride, output, output_stride, 4);
+}
+
+static void transpose_block6_c(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+    transpose_block_c(input, input_stride, output, output_stride, 6);
+}
+
+static void transpose_block8_c(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+    transpose_block_c(input, input_stride, output, output_stride, 8);
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+/*
+ * Rows are transposed by interleaving pairs of rows, then pairs of the results with twice larger
+ * elements, and so on until every register holds whole columns.
+ */
+SAIL_TARGET("ssse3")
+static void transpose_block1_ssse3(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const __m128i r0 = _mm_loadl_epi64((const __m128i *)(input));
+    const __m128i r1 = _mm_loadl_epi64((const __m128i *)(input + input_stride));
+    const __m128i r2 = _mm_loadl_epi64((const __m128i *)(input + 2 * input_stride));
+    const __m128i r3 = _mm_loadl_epi64((const __m128i *)(input + 3 * input_stride));
+    const __m128i r4 = _mm_loadl_epi64((const __m128i *)(input + 4 * input_stride));
+    const __m128i r5 = _mm_loadl_epi64((const __m128i *)(input + 5 * input_stride));
+    const __m128i r6 = _mm_loadl_epi64((const __m128i *)(input + 6 * input_stride));
+    const __m128i r7 = _mm_loadl_epi64((const __m128i *)(input + 7 * input_stride));
+
+    const __m128i t0 = _mm_unpacklo_epi8(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi8(r2, r3);
+    const __m128i t2 = _mm_unpacklo_epi8(r4, r5);
+    const __m128i t3 = _mm_unpacklo_epi8(r6, r7);
+
+    const __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+    const __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+    const __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+    const __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+
+    /* Every register holds two columns. */
+    const __m128i v0 = _mm_unpacklo_epi32(u0, u2);
+    const __m128i v1 = _mm_unpackhi_epi32(u0, u2);
+    const __m128i v2 = _mm_unpacklo_epi32(u1, u3);
+    const __m128i v3 = _mm_unpackhi_epi32(u1, u3);
+
+    _mm_storel_epi64((__m128i *)(output),                     v0);
+    _mm_storel_epi64((__m128i *)(output + output_stride),     _mm_unpackhi_epi64(v0, v0));
+    _mm_storel_epi64((__m128i *)(output + 2 * output_stride), v1);
+    _mm_storel_epi64((__m128i *)(output + 3 * output_stride), _mm_unpackhi_epi64(v1, v1));
+    _mm_storel_epi64((__m128i *)(output + 4 * output_stride), v2);
+    _mm_storel_epi64((__m128i *)(output + 5 * output_stride), _mm_unpackhi_epi64(v2, v2));
+    _mm_storel_epi64((__m128i *)(output + 6 * output_stride), v3);
+    _mm_storel_epi64((__m128i *)(output + 7 * output_stride), _mm_unpackhi_epi64(v3, v3));
+}
+
+SAIL_TARGET("ssse3")
+static void transpose_block2_ssse3(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const __m128i r0 = _mm_loadu_si128((const __m128i *)(input));
+    const __m128i r1 = _mm_loadu_si128((const __m128i *)(input + input_stride));
+    const __m128i r2 = _mm_loadu_si128((const __m128i *)(input + 2 * input_stride));
+    const __m128i r3 = _mm_loadu_si128((const __m128i *)(input + 3 * input_stride));
+    const __m128i r4 = _mm_loadu_si128((const __m128i *)(input + 4 * input_stride));
+    const __m128i r5 = _mm_loadu_si128((const __m128i *)(input + 5 * input_stride));
+    const __m128i r6 = _mm_loadu_si128((const __m128i *)(input + 6 * input_stride));
+    const __m128i r7 = _mm_loadu_si128((const __m128i *)(input + 7 * input_stride));
+
+    const __m128i t0 = _mm_unpacklo_epi16(r0, r1);
+    const __m128i t1 = _mm_unpackhi_epi16(r0, r1);
+    const __m128i t2 = _mm_unpacklo_epi16(r2, r3);
+    const __m128i t3 = _mm_unpackhi_epi16(r2, r3);
+    const __m128i t4 = _mm_unpacklo_epi16(r4, r5);
+    const __m128i t5 = _mm_unpackhi_epi16(r4, r5);
+    const __m128i t6 = _mm_unpacklo_epi16(r6, r7);
+    const __m128i t7 = _mm_unpackhi_epi16(r6, r7);
+
+    /* Halves of two columns: the first four rows, and then the last four rows. */
+    const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+    const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+    const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+    const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+    const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+    const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+    const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+    const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+    _mm_storeu_si128((__m128i *)(output),                     _mm_unpacklo_epi64(u0, u4));
+    _mm_storeu_si128((__m128i *)(output + output_stride),     _mm_unpackhi_epi64(u0, u4));
+    _mm_storeu_si128((__m128i *)(output + 2 * output_stride), _mm_unpacklo_epi64(u1, u5));
+    _mm_storeu_si128((__m128i *)(output + 3 * output_stride), _mm_unpackhi_epi64(u1, u5));
+    _mm_storeu_si128((__m128i *)(output + 4 * output_stride), _mm_unpacklo_epi64(u2, u6));
+    _mm_storeu_si128((__m128i *)(output + 5 * output_stride), _mm_unpackhi_epi64(u2, u6));
+    _mm_storeu_si128((__m128i *)(output + 6 * output_stride), _mm_unpacklo_epi64(u3, u7));
+    _mm_storeu_si128((__m128i *)(output + 7 * output_stride), _mm_unpackhi_epi64(u3, u7));
+}
+
+/* 4x4 blocks. */
+SAIL_TARGET("ssse3")
+static void transpose_block4_ssse3(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const __m128i r0 = _mm_loadu_si128((const __m128i *)(input));
+    const __m128i r1 = _mm_loadu_si128((const __m128i *)(input + input_stride));
+    const __m128i r2 = _mm_loadu_si128((const __m128i *)(input + 2 * input_stride));
+    const __m128i r3 = _mm_loadu_si128((const __m128i *)(input + 3 * input_stride));
+
+    const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+    _mm_storeu_si128((__m128i *)(output),                     _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128((__m128i *)(output + output_stride),     _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128((__m128i *)(output + 2 * output_stride), _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128((__m128i *)(output + 3 * output_stride), _mm_unpackhi_epi64(t2, t3));
+}
+
+/* 8x8 blocks. Unpacking works within 128-bit lanes, so the lanes are swapped at the end. */
+SAIL_TARGET("avx2")
+static void transpose_block4_avx2(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const __m256i r0 = _mm256_loadu_si256((const __m256i *)(input));
+    const __m256i r1 = _mm256_loadu_si256((const __m256i *)(input + input_stride));
+    const __m256i r2 = _mm256_loadu_si256((const __m256i *)(input + 2 * input_stride));
+    const __m256i r3 = _mm256_loadu_si256((const __m256i *)(input + 3 * input_stride));
+    const __m256i r4 = _mm256_loadu_si256((const __m256i *)(input + 4 * input_stride));
+    const __m256i r5 = _mm256_loadu_si256((const __m256i *)(input + 5 * input_stride));
+    const __m256i r6 = _mm256_loadu_si256((const __m256i *)(input + 6 * input_stride));
+    const __m256i r7 = _mm256_loadu_si256((const __m256i *)(input + 7 * input_stride));
+
+    const __m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+    const __m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+    const __m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+    const __m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+    const __m256i t4 = _mm256_unpacklo_epi32(r4, r5);
+    const __m256i t5 = _mm256_unpackhi_epi32(r4, r5);
+    const __m256i t6 = _mm256_unpacklo_epi32(r6, r7);
+    const __m256i t7 = _mm256_unpackhi_epi32(r6, r7);
+
+    /* Lanes hold columns j and j + 4 of four rows. */
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    _mm256_storeu_si256((__m256i *)(output),                     _mm256_permute2x128_si256(u0, u4, 0x20));
+    _mm256_storeu_si256((__m256i *)(output + output_stride),     _mm256_permute2x128_si256(u1, u5, 0x20));
+    _mm256_storeu_si256((__m256i *)(output + 2 * output_stride), _mm256_permute2x128_si256(u2, u6, 0x20));
+    _mm256_storeu_si256((__m256i *)(output + 3 * output_stride), _mm256_permute2x128_si256(u3, u7, 0x20));
+    _mm256_storeu_si256((__m256i *)(output + 4 * output_stride), _mm256_permute2x128_si256(u0, u4, 0x31));
+    _mm256_storeu_si256((__m256i *)(output + 5 * output_stride), _mm256_permute2x128_si256(u1, u5, 0x31));
+    _mm256_storeu_si256((__m256i *)(output + 6 * output_stride), _mm256_permute2x128_si256(u2, u6, 0x31));
+    _mm256_storeu_si256((__m256i *)(output + 7 * output_stride), _mm256_permute2x128_si256(u3, u7, 0x31));
+}
+
+/* 4x4 blocks. */
+SAIL_TARGET("avx2")
+static void transpose_block8_avx2(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const __m256i r0 = _mm256_loadu_si256((const __m256i *)(input));
+    const __m256i r1 = _mm256_loadu_si256((const __m256i *)(input + input_stride));
+    const __m256i r2 = _mm256_loadu_si256((const __m256i *)(input + 2 * input_stride));
+    const __m256i r3 = _mm256_loadu_si256((const __m256i *)(input + 3 * input_stride));
+
+    const __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+    const __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+    const __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+    const __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+
+    _mm256_storeu_si256((__m256i *)(output),                     _mm256_permute2x128_si256(t0, t2, 0x20));
+    _mm256_storeu_si256((__m256i *)(output + output_stride),     _mm256_permute2x128_si256(t1, t3, 0x20));
+    _mm256_storeu_si256((__m256i *)(output + 2 * output_stride), _mm256_permute2x128_si256(t0, t2, 0x31));
+    _mm256_storeu_si256((__m256i *)(output + 3 * output_stride), _mm256_permute2x128_si256(t1, t3, 0x31));
+}
+#endif
+
+#ifdef SAIL_HAVE_NEON
+static void transpose_block1_neon(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const uint8x8x2_t b0 = vtrn_u8(vld1_u8(input),                    vld1_u8(input + input_stride));
+    const uint8x8x2_t b1 = vtrn_u8(vld1_u8(input + 2 * input_stride), vld1_u8(input + 3 * input_stride));
+    const uint8x8x2_t b2 = vtrn_u8(vld1_u8(input + 4 * input_stride), vld1_u8(input + 5 * input_stride));
+    const uint8x8x2_t b3 = vtrn_u8(vld1_u8(input + 6 * input_stride), vld1_u8(input + 7 * input_stride));
+
+    const uint16x4x2_t c0 = vtrn_u16(vreinterpret_u16_u8(b0.val[0]), vreinterpret_u16_u8(b1.val[0]));
+    const uint16x4x2_t c1 = vtrn_u16(vreinterpret_u16_u8(b0.val[1]), vreinterpret_u16_u8(b1.val[1]));
+    const uint16x4x2_t c2 = vtrn_u16(vreinterpret_u16_u8(b2.val[0]), vreinterpret_u16_u8(b3.val[0]));
+    const uint16x4x2_t c3 = vtrn_u16(vreinterpret_u16_u8(b2.val[1]), vreinterpret_u16_u8(b3.val[1]));
+
+    /* Columns j and j + 4. */
+    const uint32x2x2_t d0 = vtrn_u32(vreinterpret_u32_u16(c0.val[0]), vreinterpret_u32_u16(c2.val[0]));
+    const uint32x2x2_t d1 = vtrn_u32(vreinterpret_u32_u16(c1.val[0]), vreinterpret_u32_u16(c3.val[0]));
+    const uint32x2x2_t d2 = vtrn_u32(vreinterpret_u32_u16(c0.val[1]), vreinterpret_u32_u16(c2.val[1]));
+    const uint32x2x2_t d3 = vtrn_u32(vreinterpret_u32_u16(c1.val[1]), vreinterpret_u32_u16(c3.val[1]));
+
+    vst1_u8(output,                     vreinterpret_u8_u32(d0.val[0]));
+    vst1_u8(output + output_stride,     vreinterpret_u8_u32(d1.val[0]));
+    vst1_u8(output + 2 * output_stride, vreinterpret_u8_u32(d2.val[0]));
+    vst1_u8(output + 3 * output_stride, vreinterpret_u8_u32(d3.val[0]));
+    vst1_u8(output + 4 * output_stride, vreinterpret_u8_u32(d0.val[1]));
+    vst1_u8(output + 5 * output_stride, vreinterpret_u8_u32(d1.val[1]));
+    vst1_u8(output + 6 * output_stride, vreinterpret_u8_u32(d2.val[1]));
+    vst1_u8(output + 7 * output_stride, vreinterpret_u8_u32(d3.val[1]));
+}
+
+static void transpose_block2_neon(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const uint16x8x2_t b0 = vtrnq_u16(vld1q_u16((const uint16_t *)(input)),
+                                      vld1q_u16((const uint16_t *)(input + input_stride)));
+    const uint16x8x2_t b1 = vtrnq_u16(vld1q_u16((const uint16_t *)(input + 2 * input_stride)),
+                                      vld1q_u16((const uint16_t *)(input + 3 * input_stride)));
+    const uint16x8x2_t b2 = vtrnq_u16(vld1q_u16((const uint16_t *)(input + 4 * input_stride)),
+                                      vld1q_u16((const uint16_t *)(input + 5 * input_stride)));
+    const uint16x8x2_t b3 = vtrnq_u16(vld1q_u16((const uint16_t *)(input + 6 * input_stride)),
+                                      vld1q_u16((const uint16_t *)(input + 7 * input_stride)));
+
+    /* Columns j and j + 4 of four rows. */
+    const uint32x4x2_t c0 = vtrnq_u32(vreinterpretq_u32_u16(b0.val[0]), vreinterpretq_u32_u16(b1.val[0]));
+    const uint32x4x2_t c1 = vtrnq_u32(vreinterpretq_u32_u16(b0.val[1]), vreinterpretq_u32_u16(b1.val[1]));
+    const uint32x4x2_t c2 = vtrnq_u32(vreinterpretq_u32_u16(b2.val[0]), vreinterpretq_u32_u16(b3.val[0]));
+    const uint32x4x2_t c3 = vtrnq_u32(vreinterpretq_u32_u16(b2.val[1]), vreinterpretq_u32_u16(b3.val[1]));
+
+    vst1q_u32((uint32_t *)(output),                     vcombine_u32(vget_low_u32(c0.val[0]),  vget_low_u32(c2.val[0])));
+    vst1q_u32((uint32_t *)(output + output_stride),     vcombine_u32(vget_low_u32(c1.val[0]),  vget_low_u32(c3.val[0])));
+    vst1q_u32((uint32_t *)(output + 2 * output_stride), vcombine_u32(vget_low_u32(c0.val[1]),  vget_low_u32(c2.val[1])));
+    vst1q_u32((uint32_t *)(output + 3 * output_stride), vcombine_u32(vget_low_u32(c1.val[1]),  vget_low_u32(c3.val[1])));
+    vst1q_u32((uint32_t *)(output + 4 * output_stride), vcombine_u32(vget_high_u32(c0.val[0]), vget_high_u32(c2.val[0])));
+    vst1q_u32((uint32_t *)(output + 5 * output_stride), vcombine_u32(vget_high_u32(c1.val[0]), vget_high_u32(c3.val[0])));
+    vst1q_u32((uint32_t *)(output + 6 * output_stride), vcombine_u32(vget_high_u32(c0.val[1]), vget_high_u32(c2.val[1])));
+    vst1q_u32((uint32_t *)(output + 7 * output_stride), vcombine_u32(vget_high_u32(c1.val[1]), vget_high_u32(c3.val[1])));
+}
+
+/* 4x4 blocks. */
+static void transpose_block4_neon(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride) {
+
+    const uint32x4x2_t b0 = vtrnq_u32(vld1q_u32((const uint32_t *)(input)),
+                                      vld1q_u32((const uint32_t *)(input + input_stride)));
+    const uint32x4x2_t b1 = vtrnq_u32(vld1q_u32((const uint32_t *)(input + 2 * input_stride)),
+                                      vld1q_u32((const uint32_t *)(input + 3 * input_stride)));
+
+    vst1q_u32((uint32_t *)(output),                     vcombine_u32(vget_low_u32(b0.val[0]),  vget_low_u32(b1.val[0])));
+    vst1q_u32((uint32_t *)(output + output_stride),     vcombine_u32(vget_low_u32(b0.val[1]),  vget_low_u32(b1.val[1])));
+    vst1q_u32((uint32_t *)(output + 2 * output_stride), vcombine_u32(vget_high_u32(b0.val[0]), vget_high_u32(b1.val[0])));
+    vst1q_u32((uint32_t *)(output + 3 * output_stride), vcombine_u32(vget_high_u32(b0.val[1]), vget_high_u32(b1.val[1])));
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+void rotate_kernels_init(unsigned bytes_per_pixel, struct rotate_kernels *kernels) {
+
+    kernels->block_size = C_BLOCK_SIZE;
+
+    switch (bytes_per_pixel) {
+        case 1: kernels->transpose_block = transpose_block1_c; break;
+        case 2: kernels->transpose_block = transpose_block2_c; break;
+        case 3: kernels->transpose_block = transpose_block3_c; break;
+        case 4: kernels->transpose_block = transpose_block4_c; break;
+        case 6: kernels->transpose_block = transpose_block6_c; break;
+        case 8: kernels->transpose_block = transpose_block8_c; break;
+
+        default: {
+            kernels->transpose_block = NULL;
+            return;
+        }
+    }
+
+#if defined SAIL_HAVE_X86_SIMD
+    const bool avx2 = cpu_has_avx2();
+    const bool ssse3 = cpu_has_ssse3();
+
+    switch (bytes_per_pixel) {
+        case 1: {
+            if (ssse3) {
+                kernels->transpose_block = transpose_block1_ssse3;
+            }
+            break;
+        }
+        case 2: {
+            if (ssse3) {
+                kernels->transpose_block = transpose_block2_ssse3;
+            }
+            break;
+        }
+        case 4: {
+            if (avx2) {
+                kernels->transpose_block = transpose_block4_avx2;
+            } else if (ssse3) {
+                kernels->block_size      = 4;
+                kernels->transpose_block = transpose_block4_ssse3;
+            }
+            break;
+        }
+        case 8: {
+            if (avx2) {
+                kernels->block_size      = 4;
+                kernels->transpose_block = transpose_block8_avx2;
+            }
+            break;
+        }
+    }
+#elif defined SAIL_HAVE_NEON
+    switch (bytes_per_pixel) {
+        case 1: kernels->transpose_block = transpose_block1_neon; break;
+        case 2: kernels->transpose_block = transpose_block2_neon; break;
+        case 4: {
+            kernels->block_size      = 4;
+            kernels->transpose_block = transpose_block4_neon;
+            break;
+        }
+    }
+#endif
+}
@@ -0,0 +1,54 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ROTATE_KERNELS_H
+#define SAIL_ROTATE_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+
+/*
+ * Inner loop of rotations. Transposes a square block of block_size x block_size pixels:
+ * output row j gets input column j. Strides are in bytes and can be negative to flip the rows
+ * of the block. 1, 2, 4, and 8-byte pixels are transposed with AVX2, SSSE3, or NEON instructions
+ * depending on the CPU, other pixel sizes with plain C.
+ */
+struct rotate_kernels {
+
+    /* Block width and height in pixels. */
+    unsigned block_size;
+
+    /* NULL if there is no kernel for the pixel size, so every pixel is copied separately. */
+    void (*transpose_block)(const uint8_t *input, ptrdiff_t input_stride, uint8_t *output, ptrdiff_t output_stride);
+};
+
+/*
+ * Selects the fastest kernel for the number of bytes per pixel supported by the CPU.
+ */
+SAIL_HIDDEN void rotate_kernels_init(unsigned bytes_per_pixel, struct rotate_kernels *kernels);
+
+#endif
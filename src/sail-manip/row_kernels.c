@@ -0,0 +1,295 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Force inlining to fold the layout constants into every kernel. Unoptimized builds
+ * call the generic code instead to not blow up in size.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__OPTIMIZE__)
+    #define ROW_KERNEL_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+    #define ROW_KERNEL_INLINE static __forceinline
+#else
+    #define ROW_KERNEL_INLINE static inline
+#endif
+
+/*
+ * Pixel format layouts: bytes per channel, number of channels, and indexes
+ * of the RED, GREEN, BLUE, and ALPHA channels (-1 if there is no such channel).
+ */
+#define LAYOUT_BPP8_GRAYSCALE        1, 1, 0, 0, 0, -1
+#define LAYOUT_BPP16_GRAYSCALE       2, 1, 0, 0, 0, -1
+#define LAYOUT_BPP16_GRAYSCALE_ALPHA 1, 2, 0, 0, 0,  1
+#define LAYOUT_BPP32_GRAYSCALE_ALPHA 2, 2, 0, 0, 0,  1
+
+#define LAYOUT_BPP24_RGB             1, 3, 0, 1, 2, -1
+#define LAYOUT_BPP24_BGR             1, 3, 2, 1, 0, -1
+#define LAYOUT_BPP48_RGB             2, 3, 0, 1, 2, -1
+#define LAYOUT_BPP48_BGR             2, 3, 2, 1, 0, -1
+
+#define LAYOUT_BPP32_RGBX            1, 4, 0, 1, 2, -1
+#define LAYOUT_BPP32_BGRX            1, 4, 2, 1, 0, -1
+#define LAYOUT_BPP32_XRGB            1, 4, 1, 2, 3, -1
+#define LAYOUT_BPP32_XBGR            1, 4, 3, 2, 1, -1
+#define LAYOUT_BPP32_RGBA            1, 4, 0, 1, 2,  3
+#define LAYOUT_BPP32_BGRA            1, 4, 2, 1, 0,  3
+#define LAYOUT_BPP32_ARGB            1, 4, 1, 2, 3,  0
+#define LAYOUT_BPP32_ABGR            1, 4, 3, 2, 1,  0
+
+#define LAYOUT_BPP64_RGBX            2, 4, 0, 1, 2, -1
+#define LAYOUT_BPP64_BGRX            2, 4, 2, 1, 0, -1
+#define LAYOUT_BPP64_XRGB            2, 4, 1, 2, 3, -1
+#define LAYOUT_BPP64_XBGR            2, 4, 3, 2, 1, -1
+#define LAYOUT_BPP64_RGBA            2, 4, 0, 1, 2,  3
+#define LAYOUT_BPP64_BGRA            2, 4, 2, 1, 0,  3
+#define LAYOUT_BPP64_ARGB            2, 4, 1, 2, 3,  0
+#define LAYOUT_BPP64_ABGR            2, 4, 3, 2, 1,  0
+
+#define INPUT_PIXEL_FORMATS(X) \
+    X(BPP8_GRAYSCALE) X(BPP16_GRAYSCALE) X(BPP16_GRAYSCALE_ALPHA) X(BPP32_GRAYSCALE_ALPHA) \
+    X(BPP24_RGB) X(BPP24_BGR) X(BPP48_RGB) X(BPP48_BGR) \
+    X(BPP32_RGBX) X(BPP32_BGRX) X(BPP32_XRGB) X(BPP32_XBGR) X(BPP32_RGBA) X(BPP32_BGRA) X(BPP32_ARGB) X(BPP32_ABGR) \
+    X(BPP64_RGBX) X(BPP64_BGRX) X(BPP64_XRGB) X(BPP64_XBGR) X(BPP64_RGBA) X(BPP64_BGRA) X(BPP64_ARGB) X(BPP64_ABGR)
+
+#define OUTPUT_PIXEL_FORMATS(X, input) \
+    X(input, BPP8_GRAYSCALE) X(input, BPP16_GRAYSCALE) \
+    X(input, BPP24_RGB) X(input, BPP24_BGR) X(input, BPP48_RGB) X(input, BPP48_BGR) \
+    X(input, BPP32_RGBX) X(input, BPP32_BGRX) X(input, BPP32_XRGB) X(input, BPP32_XBGR) \
+    X(input, BPP32_RGBA) X(input, BPP32_BGRA) X(input, BPP32_ARGB) X(input, BPP32_ABGR) \
+    X(input, BPP64_RGBX) X(input, BPP64_BGRX) X(input, BPP64_XRGB) X(input, BPP64_XBGR) \
+    X(input, BPP64_RGBA) X(input, BPP64_BGRA) X(input, BPP64_ARGB) X(input, BPP64_ABGR)
+
+ROW_KERNEL_INLINE unsigned load_channel(const uint8_t *scan, unsigned bytes, int index) {
+
+    return (bytes == 1) ? scan[index] : ((const uint16_t *)scan)[index];
+}
+
+ROW_KERNEL_INLINE void store_channel(uint8_t *scan, unsigned bytes, int index, unsigned value) {
+
+    if (bytes == 1) {
+        scan[index] = (uint8_t)value;
+    } else {
+        ((uint16_t *)scan)[index] = (uint16_t)value;
+    }
+}
+
+/* 16-bit values are truncated exactly like narrow_uint16() does. */
+ROW_KERNEL_INLINE unsigned scale_channel(unsigned value, unsigned input_bytes, unsigned output_bytes) {
+
+    if (input_bytes == output_bytes) {
+        return value;
+    } else if (input_bytes == 1) {
+        return value * 257;
+    } else {
+        return value / 257;
+    }
+}
+
+/*
+ * Blends the pixel with the background and scales it to the output channel size. Produces the same results
+ * as the generic fill_*_pixel_from_*_values() functions. Blending is not a hot path, so the function is not
+ * inlined to keep the kernels small.
+ */
+static void blend_pixel(unsigned r, unsigned g, unsigned b, unsigned a, unsigned input_bytes, unsigned output_bytes,
+                        const struct sail_conversion_options *options, unsigned values[3]) {
+
+    const unsigned input_values[3] = { r, g, b };
+    const unsigned background24[3] = { options->background24.component1, options->background24.component2, options->background24.component3 };
+    const unsigned background48[3] = { options->background48.component1, options->background48.component2, options->background48.component3 };
+
+    for (unsigned c = 0; c < 3; c++) {
+        if (input_bytes == 1 && output_bytes == 1) {
+            values[c] = blend_uint8(input_values[c], a, background24[c]);
+        } else if (input_bytes == 1) {
+            values[c] = blend_uint16(widen_uint8(input_values[c]), widen_uint8(a), background48[c]);
+        } else if (output_bytes == 1) {
+            values[c] = narrow_uint16(blend_uint16(input_values[c], a, background48[c]));
+        } else {
+            values[c] = blend_uint16(input_values[c], a, background48[c]);
+        }
+    }
+}
+
+/* Stores the color channels already scaled to the output channel size. Grayscale output gets their luma. */
+ROW_KERNEL_INLINE void store_color(uint8_t *scan_output, unsigned output_bytes, unsigned output_channels, int ro, int go, int bo,
+                                    unsigned r, unsigned g, unsigned b) {
+
+    if (output_channels == 1) {
+        store_channel(scan_output, output_bytes, 0, rgb_to_gray(r, g, b));
+    } else {
+        store_channel(scan_output, output_bytes, ro, r);
+        store_channel(scan_output, output_bytes, go, g);
+        store_channel(scan_output, output_bytes, bo, b);
+    }
+}
+
+/*
+ * The output pixel is never larger than the input one when converting in place. Scan lines are
+ * processed front to back, and every pixel is read entirely before writing, so writes never reach
+ * pixels that are not read yet.
+ */
+ROW_KERNEL_INLINE void convert_row(const void *input, void *output, unsigned width, const struct sail_conversion_options *options,
+                                    unsigned input_bytes, unsigned input_channels, int ri, int gi, int bi, int ai,
+                                    unsigned output_bytes, unsigned output_channels, int ro, int go, int bo, int ao) {
+
+    const uint8_t *scan_input  = input;
+          uint8_t *scan_output = output;
+
+    const unsigned input_step  = input_bytes * input_channels;
+    const unsigned output_step = output_bytes * output_channels;
+    const unsigned input_max   = (input_bytes == 1) ? 255 : 65535;
+    const unsigned output_max  = (output_bytes == 1) ? 255 : 65535;
+
+    /* X channels of 4-channel outputs without alpha are set to the maximum like the vectorized kernels do. */
+    const int xo = (output_channels == 4 && ao < 0) ? 6 - ro - go - bo : -1;
+
+    /* Alpha is blended only when the input has it and the output has not. */
+    const bool blend = ai >= 0 && ao < 0 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA);
+
+    if (blend) {
+        for (unsigned column = 0; column < width; column++) {
+            const unsigned r = load_channel(scan_input, input_bytes, ri);
+            const unsigned g = load_channel(scan_input, input_bytes, gi);
+            const unsigned b = load_channel(scan_input, input_bytes, bi);
+            const unsigned a = load_channel(scan_input, input_bytes, ai);
+
+            if (a < input_max) {
+                unsigned values[3];
+                blend_pixel(r, g, b, a, input_bytes, output_bytes, options, values);
+                store_color(scan_output, output_bytes, output_channels, ro, go, bo, values[0], values[1], values[2]);
+            } else {
+                store_color(scan_output, output_bytes, output_channels, ro, go, bo,
+                            scale_channel(r, input_bytes, output_bytes),
+                            scale_channel(g, input_bytes, output_bytes),
+                            scale_channel(b, input_bytes, output_bytes));
+            }
+
+            if (xo >= 0) {
+                store_channel(scan_output, output_bytes, xo, output_max);
+            }
+
+            scan_input  += input_step;
+            scan_output += output_step;
+        }
+    } else {
+        for (unsigned column = 0; column < width; column++) {
+            const unsigned r = load_channel(scan_input, input_bytes, ri);
+            const unsigned g = load_channel(scan_input, input_bytes, gi);
+            const unsigned b = load_channel(scan_input, input_bytes, bi);
+            const unsigned a = (ai >= 0) ? load_channel(scan_input, input_bytes, ai) : input_max;
+
+            store_color(scan_output, output_bytes, output_channels, ro, go, bo,
+                        scale_channel(r, input_bytes, output_bytes),
+                        scale_channel(g, input_bytes, output_bytes),
+                        scale_channel(b, input_bytes, output_bytes));
+
+            if (ao >= 0) {
+                store_channel(scan_output, output_bytes, ao, scale_channel(a, input_bytes, output_bytes));
+            } else if (xo >= 0) {
+                store_channel(scan_output, output_bytes, xo, output_max);
+            }
+
+            scan_input  += input_step;
+            scan_output += output_step;
+        }
+    }
+}
+
+/* Instantiates convert_row() for every pair of the input and output pixel formats. */
+#define DEFINE_ROW_KERNEL(input, output)                                                                \
+    static void convert_row_##input##_to_##output(const void *input_scan, void *output_scan,            \
+                                                    unsigned width,                                     \
+                                                    const struct sail_conversion_options *options) {    \
+        convert_row(input_scan, output_scan, width, options, LAYOUT_##input, LAYOUT_##output);          \
+    }
+
+#define DEFINE_ROW_KERNELS(input) OUTPUT_PIXEL_FORMATS(DEFINE_ROW_KERNEL, input)
+
+INPUT_PIXEL_FORMATS(DEFINE_ROW_KERNELS)
+
+/* Dispatch table indexes. */
+#define INPUT_INDEX(input) INPUT_INDEX_##input,
+enum { INPUT_PIXEL_FORMATS(INPUT_INDEX) INPUT_PIXEL_FORMATS_COUNT };
+
+#define OUTPUT_INDEX(input, output) OUTPUT_INDEX_##output,
+enum { OUTPUT_PIXEL_FORMATS(OUTPUT_INDEX, unused) OUTPUT_PIXEL_FORMATS_COUNT };
+
+#define ROW_KERNEL_ENTRY(input, output) convert_row_##input##_to_##output,
+#define ROW_KERNEL_ENTRIES(input) { OUTPUT_PIXEL_FORMATS(ROW_KERNEL_ENTRY, input) },
+
+static const row_kernel_t ROW_KERNELS[INPUT_PIXEL_FORMATS_COUNT][OUTPUT_PIXEL_FORMATS_COUNT] = {
+    INPUT_PIXEL_FORMATS(ROW_KERNEL_ENTRIES)
+};
+
+#define INPUT_INDEX_CASE(input) case SAIL_PIXEL_FORMAT_##input: return INPUT_INDEX_##input;
+#define OUTPUT_INDEX_CASE(input, output) case SAIL_PIXEL_FORMAT_##output: return OUTPUT_INDEX_##output;
+
+static int input_index(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        INPUT_PIXEL_FORMATS(INPUT_INDEX_CASE)
+
+        default: {
+            return -1;
+        }
+    }
+}
+
+static int output_index(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        OUTPUT_PIXEL_FORMATS(OUTPUT_INDEX_CASE, unused)
+
+        default: {
+            return -1;
+        }
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+row_kernel_t find_row_kernel(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+    const int input  = input_index(input_pixel_format);
+    const int output = output_index(output_pixel_format);
+
+    if (input < 0 || output < 0) {
+        return NULL;
+    }
+
+    return ROW_KERNELS[input][output];
+}
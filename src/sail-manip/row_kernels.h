@@ -0,0 +1,47 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ROW_KERNELS_H
+#define SAIL_ROW_KERNELS_H
+
+#include <sail-common/export.h>
+#include <sail-common/pixel.h>
+
+struct sail_conversion_options;
+
+/*
+ * Converts a scan line between a fixed pair of pixel formats. Channel offsets are compile-time
+ * constants, so no intermediate RGBA pixel is built. Options may be NULL. Input and output may
+ * point to the same memory when converting in place.
+ */
+typedef void (*row_kernel_t)(const void *input, void *output, unsigned width, const struct sail_conversion_options *options);
+
+/*
+ * Returns a specialized row kernel from grayscale (with or without alpha) or RGB-like input
+ * pixel formats into grayscale or RGB-like output pixel formats. Returns NULL if there is no such kernel.
+ */
+SAIL_HIDDEN row_kernel_t find_row_kernel(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format);
+
+#endif
@@ -30,13 +30,36 @@
 
 #include <sail-common/sail-common.h>
 
+#include <sail-manip/color_transform.h>
 #include <sail-manip/conversion_options.h>
 #include <sail-manip/convert.h>
 #include <sail-manip/manip_common.h>
+#include <sail-manip/metrics.h>
+#include <sail-manip/mipmap.h>
+#include <sail-manip/quantize.h>
+#include <sail-manip/rotate.h>
+#include <sail-manip/scale.h>
+#include <sail-manip/statistics.h>
+#include <sail-manip/thread_pool.h>
 
 #ifdef SAIL_BUILD
+    #include <sail-manip/alpha_kernels.h>
     #include <sail-manip/cmyk.h>
+    #include <sail-manip/convert_simd.h>
+    #include <sail-manip/cpu_features.h>
+    #include <sail-manip/float_kernels.h>
+    #include <sail-manip/icc_profile.h>
+    #include <sail-manip/linear_light.h>
+    #include <sail-manip/lock_private.h>
     #include <sail-manip/manip_utils.h>
+    #include <sail-manip/metric_kernels.h>
+    #include <sail-manip/planar.h>
+    #include <sail-manip/rotate_kernels.h>
+    #include <sail-manip/row_kernels.h>
+    #include <sail-manip/scale_kernels.h>
+    #include <sail-manip/scale_weights.h>
+    #include <sail-manip/statistics_kernels.h>
+    #include <sail-manip/thread_pool_private.h>
     #include <sail-manip/ycbcr.h>
     #include <sail-manip/ycck.h>
 #endif
@@ -0,0 +1,435 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+struct scale_job {
+    const struct sail_image *image;
+    struct sail_image *image_output;
+
+    unsigned channels;
+    unsigned bytes_per_pixel;
+
+    struct scale_kernels kernels;
+    struct scale_weights horizontal;
+    struct scale_weights vertical;
+
+    /* Output of the horizontal pass and input of the vertical pass. Points to the input image when the width is unchanged. */
+    uint8_t *intermediate;
+    unsigned intermediate_bytes_per_line;
+
+    /* Input column of every output column for the nearest neighbor scaling. */
+    unsigned *columns;
+};
+
+static sail_status_t scale_nearest_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct scale_job *job = context;
+
+    const struct sail_image *image = job->image;
+    struct sail_image *image_output = job->image_output;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        /* Sample from the centers of the output pixels. */
+        const unsigned input_row = (unsigned)(((uint64_t)row * 2 + 1) * image->height / ((uint64_t)image_output->height * 2));
+
+        const uint8_t *scan_input = sail_scan_line(image, input_row);
+        uint8_t *scan_output = sail_scan_line(image_output, row);
+
+        for (unsigned column = 0; column < image_output->width; column++) {
+            memcpy(scan_output, scan_input + (size_t)job->columns[column] * job->bytes_per_pixel, job->bytes_per_pixel);
+            scan_output += job->bytes_per_pixel;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+/* Blends input scan lines horizontally. Writes into the output image when the height is unchanged. */
+static sail_status_t scale_horizontally_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct scale_job *job = context;
+
+    const bool final = job->image->height == job->image_output->height;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        void *scan_output = final
+                            ? sail_scan_line(job->image_output, row)
+                            : job->intermediate + (size_t)row * job->intermediate_bytes_per_line;
+
+        job->kernels.blend_pixels(&job->horizontal, job->channels, sail_scan_line(job->image, row), scan_output, job->image_output->width);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t scale_vertically_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct scale_job *job = context;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(void *) * job->vertical.max_count, &ptr));
+    const void **rows = ptr;
+
+    const unsigned values = job->image_output->width * job->channels;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        const unsigned first = job->vertical.bounds[row];
+        const unsigned count = job->vertical.counts[row];
+
+        for (unsigned k = 0; k < count; k++) {
+            rows[k] = job->intermediate + (size_t)(first + k) * job->intermediate_bytes_per_line;
+        }
+
+        job->kernels.blend_rows(rows, job->vertical.coefficients + (size_t)row * job->vertical.max_count,
+                                count, sail_scan_line(job->image_output, row), values);
+    }
+
+    sail_free(rows);
+
+    return SAIL_OK;
+}
+
+static void cleanup_scale_job(struct scale_job *job) {
+
+    destroy_scale_weights(&job->horizontal);
+    destroy_scale_weights(&job->vertical);
+    sail_free(job->columns);
+}
+
+static sail_status_t scale_nearest(struct scale_job *job) {
+
+    const struct sail_image *image = job->image;
+    const struct sail_image *image_output = job->image_output;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(unsigned) * image_output->width, &ptr));
+    job->columns = ptr;
+
+    for (unsigned column = 0; column < image_output->width; column++) {
+        job->columns[column] = (unsigned)(((uint64_t)column * 2 + 1) * image->width / ((uint64_t)image_output->width * 2));
+    }
+
+    SAIL_TRY(parallel_for_rows(image_output->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image_output->width), 0,
+                                scale_nearest_row_block, job));
+
+    return SAIL_OK;
+}
+
+/* Scales horizontally into an intermediate buffer and then vertically. Skips the passes that don't change the size. */
+static sail_status_t scale_separable(struct scale_job *job, enum SailScaling algorithm) {
+
+    const struct sail_image *image = job->image;
+    const struct sail_image *image_output = job->image_output;
+
+    scale_kernels_init(job->bytes_per_pixel / job->channels, &job->kernels);
+
+    const bool horizontal = image->width  != image_output->width;
+    const bool vertical   = image->height != image_output->height;
+
+    uint8_t *intermediate = NULL;
+
+    if (horizontal) {
+        SAIL_TRY(init_scale_weights(image->width, image_output->width, algorithm, &job->horizontal));
+
+        if (vertical) {
+            job->intermediate_bytes_per_line = image_output->width * job->bytes_per_pixel;
+
+            void *ptr;
+            SAIL_TRY(sail_malloc((size_t)job->intermediate_bytes_per_line * image->height, &ptr));
+            intermediate = ptr;
+            job->intermediate = intermediate;
+        }
+
+        SAIL_TRY_OR_CLEANUP(parallel_for_rows(image->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image->width), 0,
+                                                scale_horizontally_row_block, job),
+                            /* cleanup */ sail_free(intermediate));
+    } else {
+        job->intermediate = image->pixels;
+        job->intermediate_bytes_per_line = image->bytes_per_line;
+    }
+
+    if (vertical) {
+        SAIL_TRY_OR_CLEANUP(init_scale_weights(image->height, image_output->height, algorithm, &job->vertical),
+                            /* cleanup */ sail_free(intermediate));
+
+        SAIL_TRY_OR_CLEANUP(parallel_for_rows(image_output->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image_output->width), 0,
+                                                scale_vertically_row_block, job),
+                            /* cleanup */ sail_free(intermediate));
+    }
+
+    sail_free(intermediate);
+
+    return SAIL_OK;
+}
+
+static sail_status_t scale_impl(const struct sail_image *image, enum SailScaling algorithm, struct sail_image *image_output) {
+
+    struct scale_job job;
+    memset(&job, 0, sizeof(job));
+
+    job.image           = image;
+    job.image_output    = image_output;
+    job.bytes_per_pixel = sail_bits_per_pixel(image->pixel_format) / 8;
+
+    unsigned bytes_per_channel;
+    if (!scale_layout(image->pixel_format, &job.channels, &bytes_per_channel)) {
+        SAIL_LOG_ERROR("Scaling %s pixels is not supported", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    /* Nothing to filter. */
+    if (image->width == image_output->width && image->height == image_output->height) {
+        for (unsigned row = 0; row < image->height; row++) {
+            memcpy(sail_scan_line(image_output, row), sail_scan_line(image, row), (size_t)image->width * job.bytes_per_pixel);
+        }
+
+        return SAIL_OK;
+    }
+
+    switch (algorithm) {
+        case SAIL_SCALING_NEAREST_NEIGHBOR: {
+            SAIL_TRY_OR_CLEANUP(scale_nearest(&job),
+                                /* cleanup */ cleanup_scale_job(&job));
+            break;
+        }
+        case SAIL_SCALING_BILINEAR:
+        case SAIL_SCALING_BOX:
+        case SAIL_SCALING_LANCZOS3: {
+            SAIL_TRY_OR_CLEANUP(scale_separable(&job, algorithm),
+                                /* cleanup */ cleanup_scale_job(&job));
+            break;
+        }
+
+        default: {
+            SAIL_LOG_ERROR("Unknown scaling algorithm %d", algorithm);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    cleanup_scale_job(&job);
+
+    return SAIL_OK;
+}
+
+/* Linearizes or encodes scan lines for scaling in linear light. */
+struct linear_light_job {
+    const struct linear_light_tables *tables;
+    struct linear_light_layout layout;
+    const struct sail_image *image;
+    struct sail_image *image_output;
+    bool decode;
+};
+
+static sail_status_t linear_light_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    const struct linear_light_job *job = context;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        if (job->decode) {
+            linear_light_decode_row(job->tables, &job->layout, sail_scan_line(job->image, row), sail_scan_line(job->image_output, row), job->image->width);
+        } else {
+            linear_light_encode_row(job->tables, &job->layout, sail_scan_line(job->image, row), sail_scan_line(job->image_output, row), job->image->width);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t linear_light_convert(const struct linear_light_tables *tables, const struct linear_light_layout *layout,
+                                            const struct sail_image *image, struct sail_image *image_output, bool decode) {
+
+    struct linear_light_job job = { tables, *layout, image, image_output, decode };
+
+    SAIL_TRY(parallel_for_rows(image->height, SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image->width), 0,
+                                linear_light_row_block, &job));
+
+    return SAIL_OK;
+}
+
+/* Allocates an image with pixels and without other properties. */
+static sail_status_t alloc_image_with_pixels(unsigned width, unsigned height, enum SailPixelFormat pixel_format, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(width, pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image_local->bytes_per_line * height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Scales 16-bit linear pixels and encodes them into the output image. */
+static sail_status_t scale_linear_light_impl(const struct linear_light_tables *tables, const struct linear_light_layout *layout,
+                                                const struct sail_image *image, enum SailPixelFormat pixel_format16,
+                                                enum SailScaling algorithm, struct sail_image *image_output) {
+
+    struct sail_image *linear;
+    SAIL_TRY(alloc_image_with_pixels(image->width, image->height, pixel_format16, &linear));
+
+    SAIL_TRY_OR_CLEANUP(linear_light_convert(tables, layout, image, linear, true /* decode */),
+                        /* cleanup */ sail_destroy_image(linear));
+
+    struct sail_image *linear_scaled;
+    SAIL_TRY_OR_CLEANUP(alloc_image_with_pixels(image_output->width, image_output->height, pixel_format16, &linear_scaled),
+                        /* cleanup */ sail_destroy_image(linear));
+
+    SAIL_TRY_OR_CLEANUP(scale_impl(linear, algorithm, linear_scaled),
+                        /* cleanup */ sail_destroy_image(linear_scaled), sail_destroy_image(linear));
+
+    sail_destroy_image(linear);
+
+    SAIL_TRY_OR_CLEANUP(linear_light_convert(tables, layout, linear_scaled, image_output, false /* decode */),
+                        /* cleanup */ sail_destroy_image(linear_scaled));
+
+    sail_destroy_image(linear_scaled);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_scale_image(const struct sail_image *image,
+                               unsigned width,
+                               unsigned height,
+                               enum SailScaling algorithm,
+                               struct sail_image **image_output) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(image_output);
+
+    if (width == 0 || height == 0) {
+        SAIL_LOG_ERROR("Cannot scale to %ux%u", width, height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->bytes_per_line = sail_bytes_per_line(width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image_local->bytes_per_line * height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    SAIL_TRY_OR_CLEANUP(scale_impl(image, algorithm, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_scale_image_into(const struct sail_image *image,
+                                    enum SailScaling algorithm,
+                                    struct sail_image *image_output) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_TRY(sail_check_image_valid(image_output));
+
+    if (image_output->pixel_format != image->pixel_format) {
+        SAIL_LOG_ERROR("Cannot scale %s pixels into %s pixels",
+                        sail_pixel_format_to_string(image->pixel_format),
+                        sail_pixel_format_to_string(image_output->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    SAIL_TRY(scale_impl(image, algorithm, image_output));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_scale_image_linear(const struct sail_image *image,
+                                      unsigned width,
+                                      unsigned height,
+                                      enum SailScaling algorithm,
+                                      struct sail_image **image_output) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(image_output);
+
+    if (width == 0 || height == 0) {
+        SAIL_LOG_ERROR("Cannot scale to %ux%u", width, height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    struct linear_light_layout layout;
+    const enum SailPixelFormat pixel_format16 = linear_light_pixel_format16(image->pixel_format);
+
+    if (pixel_format16 == SAIL_PIXEL_FORMAT_UNKNOWN || !linear_light_layout(image->pixel_format, &layout)) {
+        SAIL_LOG_ERROR("Scaling %s pixels in linear light is not supported", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->bytes_per_line = sail_bytes_per_line(width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image_local->bytes_per_line * height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    const struct linear_light_tables *tables;
+    SAIL_TRY_OR_CLEANUP(linear_light_acquire_tables(image->gamma, &tables),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    SAIL_TRY_OR_CLEANUP(scale_linear_light_impl(tables, &layout, image, pixel_format16, algorithm, image_local),
+                        /* cleanup */ linear_light_release_tables(tables), sail_destroy_image(image_local));
+
+    linear_light_release_tables(tables);
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
+
+bool sail_can_scale(enum SailPixelFormat pixel_format) {
+
+    unsigned channels;
+    unsigned bytes_per_channel;
+
+    return scale_layout(pixel_format, &channels, &bytes_per_channel);
+}
@@ -0,0 +1,122 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_SCALE_H
+#define SAIL_SCALE_H
+
+#include <stdbool.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#include <sail-manip/manip_common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * Scales the input image to the specified size with the algorithm and saves the result
+ * in the output image.
+ *
+ * Bilinear, box, and Lanczos filters are applied horizontally and then vertically with
+ * precomputed weights. When downscaling, the filters are widened to cover all the input
+ * pixels. 8-bit channels are blended with AVX2, SSSE3, or NEON instructions when
+ * the CPU supports them. Scan lines are processed with up to sail_max_threads() threads.
+ *
+ * Every channel is filtered independently, alpha is not premultiplied. Convert the image into
+ * a premultiplied pixel format first to prevent colors of transparent pixels from bleeding
+ * into the neighbors.
+ *
+ * The resulting image gets updated width, height, and bytes per line. Other properties are copied from
+ * the original image.
+ *
+ * Allowed pixel formats:
+ *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA
+ *   - SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA
+ *   - 24, 32, 48, and 64-bit RGB-like pixel formats
+ *   - Premultiplied pixel formats
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_scale_image(const struct sail_image *image,
+                                           unsigned width,
+                                           unsigned height,
+                                           enum SailScaling algorithm,
+                                           struct sail_image **image_output);
+
+/*
+ * Scales the input image with the algorithm into the output image that is allocated by the caller.
+ * The output image must have the same pixel format. Its width and height set the new size.
+ * Its bytes per line may be larger than required. Other properties of the output image are left intact.
+ *
+ * See sail_scale_image() for the details.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_scale_image_into(const struct sail_image *image,
+                                                enum SailScaling algorithm,
+                                                struct sail_image *image_output);
+
+/*
+ * Scales the input image like sail_scale_image() does, but filters the pixels in linear light,
+ * so downscaled highlights and edges keep their brightness. Color channels are linearized into
+ * 16-bit values with lookup tables built once per image gamma, scaled, and encoded back. Alpha is
+ * not linearized.
+ *
+ * Gamma values less than 1.0 are encoding gammas like 0.45455 stored in PNG files, values greater
+ * than 1.0 are decoding gammas like 2.2. The default gamma 1.0 means sRGB.
+ *
+ * Allowed pixel formats:
+ *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA
+ *   - SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA
+ *   - 24, 32, 48, and 64-bit RGB-like pixel formats
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_scale_image_linear(const struct sail_image *image,
+                                                  unsigned width,
+                                                  unsigned height,
+                                                  enum SailScaling algorithm,
+                                                  struct sail_image **image_output);
+
+/*
+ * Returns true if images of the pixel format can be scaled with sail_scale_image().
+ */
+SAIL_EXPORT bool sail_can_scale(enum SailPixelFormat pixel_format);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,606 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#ifdef SAIL_HAVE_NEON
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+/* Added to sums before the shift to round to the nearest. */
+static const int32_t ROUNDING = 1 << (SCALE_PRECISION_BITS - 1);
+
+static inline uint8_t clamp8(int32_t sum) {
+
+    const int32_t value = sum >> SCALE_PRECISION_BITS;
+
+    return (uint8_t)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+}
+
+static inline uint16_t clamp16(int64_t sum) {
+
+    const int64_t value = sum >> SCALE_PRECISION_BITS;
+
+    return (uint16_t)((value < 0) ? 0 : ((value > 65535) ? 65535 : value));
+}
+
+/* Blends the bytes [first; bytes) of the scan lines. */
+static void blend_rows8_range_c(const uint8_t *const *rows, const int16_t *coefficients, unsigned count, uint8_t *output, unsigned first, unsigned bytes) {
+
+    for (unsigned i = first; i < bytes; i++) {
+        int32_t sum = ROUNDING;
+
+        for (unsigned k = 0; k < count; k++) {
+            sum += rows[k][i] * coefficients[k];
+        }
+
+        output[i] = clamp8(sum);
+    }
+}
+
+static void blend_rows8_c(const void *const *rows, const int16_t *coefficients, unsigned count, void *output, unsigned values) {
+
+    blend_rows8_range_c((const uint8_t *const *)rows, coefficients, count, output, 0, values);
+}
+
+static void blend_rows16_c(const void *const *rows, const int16_t *coefficients, unsigned count, void *output, unsigned values) {
+
+    const uint16_t *const *rows16 = (const uint16_t *const *)rows;
+    uint16_t *output16 = output;
+
+    for (unsigned i = 0; i < values; i++) {
+        int64_t sum = ROUNDING;
+
+        for (unsigned k = 0; k < count; k++) {
+            sum += (int64_t)rows16[k][i] * coefficients[k];
+        }
+
+        output16[i] = clamp16(sum);
+    }
+}
+
+static void blend_pixels8_c(const struct scale_weights *weights, unsigned channels, const void *input, void *output, unsigned width) {
+
+    uint8_t *scan_output = output;
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t *pixels = (const uint8_t *)input + (size_t)weights->bounds[column] * channels;
+        const int16_t *coefficients = weights->coefficients + (size_t)column * weights->max_count;
+
+        for (unsigned c = 0; c < channels; c++) {
+            int32_t sum = ROUNDING;
+
+            for (unsigned k = 0; k < weights->counts[column]; k++) {
+                sum += pixels[k * channels + c] * coefficients[k];
+            }
+
+            *scan_output++ = clamp8(sum);
+        }
+    }
+}
+
+static void blend_pixels16_c(const struct scale_weights *weights, unsigned channels, const void *input, void *output, unsigned width) {
+
+    uint16_t *scan_output = output;
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint16_t *pixels = (const uint16_t *)input + (size_t)weights->bounds[column] * channels;
+        const int16_t *coefficients = weights->coefficients + (size_t)column * weights->max_count;
+
+        for (unsigned c = 0; c < channels; c++) {
+            int64_t sum = ROUNDING;
+
+            for (unsigned k = 0; k < weights->counts[column]; k++) {
+                sum += (int64_t)pixels[k * channels + c] * coefficients[k];
+            }
+
+            *scan_output++ = clamp16(sum);
+        }
+    }
+}
+
+/* Averages the output pixels [first; width) from 2x2 blocks of input pixels. */
+static void halve8_range_c(const uint8_t *row0, const uint8_t *row1, unsigned channels, uint8_t *output, unsigned first, unsigned width) {
+
+    for (unsigned column = first; column < width; column++) {
+        const uint8_t *top    = row0 + (size_t)column * 2 * channels;
+        const uint8_t *bottom = row1 + (size_t)column * 2 * channels;
+        uint8_t *scan_output  = output + (size_t)column * channels;
+
+        for (unsigned c = 0; c < channels; c++) {
+            scan_output[c] = (uint8_t)((top[c] + top[c + channels] + bottom[c] + bottom[c + channels] + 2) >> 2);
+        }
+    }
+}
+
+static void halve8_c(const void *row0, const void *row1, unsigned channels, void *output, unsigned width) {
+
+    halve8_range_c(row0, row1, channels, output, 0, width);
+}
+
+static void halve16_c(const void *row0, const void *row1, unsigned channels, void *output, unsigned width) {
+
+    const uint16_t *top    = row0;
+    const uint16_t *bottom = row1;
+    uint16_t *scan_output  = output;
+
+    for (unsigned column = 0; column < width; column++) {
+        for (unsigned c = 0; c < channels; c++) {
+            const uint32_t sum = (uint32_t)top[c] + top[c + channels] + bottom[c] + bottom[c + channels];
+
+            *scan_output++ = (uint16_t)((sum + 2) >> 2);
+        }
+
+        top    += 2 * channels;
+        bottom += 2 * channels;
+    }
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+/* Packs two coefficients to multiply interleaved pairs of 16-bit values with a single instruction. */
+static inline int32_t coefficient_pair(int16_t first, int16_t second) {
+
+    return (int32_t)((uint32_t)(uint16_t)first | ((uint32_t)(uint16_t)second << 16));
+}
+
+/*
+ * Blends 16-byte blocks starting from the first byte. Pairs of scan lines are interleaved
+ * into 16-bit values and multiplied by pairs of coefficients. An odd scan line is paired
+ * with zeros. Returns the first unprocessed byte.
+ */
+SAIL_TARGET("ssse3")
+static unsigned blend_rows8_blocks_ssse3(const uint8_t *const *rows, const int16_t *coefficients, unsigned count, uint8_t *output, unsigned first, unsigned bytes) {
+
+    const __m128i zero     = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi32(ROUNDING);
+
+    unsigned i = first;
+
+    for (; bytes - i >= 16; i += 16) {
+        __m128i sum0 = rounding;
+        __m128i sum1 = rounding;
+        __m128i sum2 = rounding;
+        __m128i sum3 = rounding;
+
+        for (unsigned k = 0; k < count; k += 2) {
+            const bool pair = k + 1 < count;
+
+            const __m128i a = _mm_loadu_si128((const __m128i *)(rows[k] + i));
+            const __m128i b = pair ? _mm_loadu_si128((const __m128i *)(rows[k + 1] + i)) : zero;
+            const __m128i c = _mm_set1_epi32(coefficient_pair(coefficients[k], pair ? coefficients[k + 1] : 0));
+
+            const __m128i lo = _mm_unpacklo_epi8(a, b);
+            const __m128i hi = _mm_unpackhi_epi8(a, b);
+
+            sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), c));
+            sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), c));
+            sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), c));
+            sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), c));
+        }
+
+        /* Saturating packs clamp the values exactly like clamp8() does. */
+        const __m128i lo16 = _mm_packs_epi32(_mm_srai_epi32(sum0, SCALE_PRECISION_BITS), _mm_srai_epi32(sum1, SCALE_PRECISION_BITS));
+        const __m128i hi16 = _mm_packs_epi32(_mm_srai_epi32(sum2, SCALE_PRECISION_BITS), _mm_srai_epi32(sum3, SCALE_PRECISION_BITS));
+
+        _mm_storeu_si128((__m128i *)(output + i), _mm_packus_epi16(lo16, hi16));
+    }
+
+    return i;
+}
+
+SAIL_TARGET("ssse3")
+static void blend_rows8_ssse3(const void *const *rows, const int16_t *coefficients, unsigned count, void *output, unsigned values) {
+
+    const uint8_t *const *rows8 = (const uint8_t *const *)rows;
+
+    const unsigned i = blend_rows8_blocks_ssse3(rows8, coefficients, count, output, 0, values);
+
+    blend_rows8_range_c(rows8, coefficients, count, output, i, values);
+}
+
+/* Same as blend_rows8_blocks_ssse3() with 32-byte blocks. Unpacking and packing within 128-bit lanes keep the byte order. */
+SAIL_TARGET("avx2")
+static void blend_rows8_avx2(const void *const *rows, const int16_t *coefficients, unsigned count, void *output, unsigned values) {
+
+    const uint8_t *const *rows8 = (const uint8_t *const *)rows;
+    uint8_t *output8 = output;
+
+    const __m256i zero     = _mm256_setzero_si256();
+    const __m256i rounding = _mm256_set1_epi32(ROUNDING);
+
+    unsigned i = 0;
+
+    for (; values - i >= 32; i += 32) {
+        __m256i sum0 = rounding;
+        __m256i sum1 = rounding;
+        __m256i sum2 = rounding;
+        __m256i sum3 = rounding;
+
+        for (unsigned k = 0; k < count; k += 2) {
+            const bool pair = k + 1 < count;
+
+            const __m256i a = _mm256_loadu_si256((const __m256i *)(rows8[k] + i));
+            const __m256i b = pair ? _mm256_loadu_si256((const __m256i *)(rows8[k + 1] + i)) : zero;
+            const __m256i c = _mm256_set1_epi32(coefficient_pair(coefficients[k], pair ? coefficients[k + 1] : 0));
+
+            const __m256i lo = _mm256_unpacklo_epi8(a, b);
+            const __m256i hi = _mm256_unpackhi_epi8(a, b);
+
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), c));
+            sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), c));
+            sum2 = _mm256_add_epi32(sum2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), c));
+            sum3 = _mm256_add_epi32(sum3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), c));
+        }
+
+        const __m256i lo16 = _mm256_packs_epi32(_mm256_srai_epi32(sum0, SCALE_PRECISION_BITS), _mm256_srai_epi32(sum1, SCALE_PRECISION_BITS));
+        const __m256i hi16 = _mm256_packs_epi32(_mm256_srai_epi32(sum2, SCALE_PRECISION_BITS), _mm256_srai_epi32(sum3, SCALE_PRECISION_BITS));
+
+        _mm256_storeu_si256((__m256i *)(output8 + i), _mm256_packus_epi16(lo16, hi16));
+    }
+
+    i = blend_rows8_blocks_ssse3(rows8, coefficients, count, output8, i, values);
+
+    blend_rows8_range_c(rows8, coefficients, count, output8, i, values);
+}
+
+/* Interleaves the channels of two 4-channel pixels into pairs of 16-bit values. */
+SAIL_TARGET("ssse3")
+static inline __m128i interleave_two_pixels_ssse3(__m128i pixels) {
+
+    const __m128i shuffle = _mm_setr_epi8(0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6, -1, 3, -1, 7, -1);
+
+    return _mm_shuffle_epi8(pixels, shuffle);
+}
+
+SAIL_TARGET("ssse3")
+static void blend_pixels8_ssse3(const struct scale_weights *weights, unsigned channels, const void *input, void *output, unsigned width) {
+
+    if (channels != 4) {
+        blend_pixels8_c(weights, channels, input, output, width);
+        return;
+    }
+
+    const __m128i rounding = _mm_set1_epi32(ROUNDING);
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t *pixels = (const uint8_t *)input + (size_t)weights->bounds[column] * 4;
+        const int16_t *coefficients = weights->coefficients + (size_t)column * weights->max_count;
+        const unsigned count = weights->counts[column];
+
+        __m128i sum = rounding;
+        unsigned k = 0;
+
+        for (; k + 2 <= count; k += 2) {
+            const __m128i two = interleave_two_pixels_ssse3(_mm_loadl_epi64((const __m128i *)(pixels + k * 4)));
+            const __m128i c = _mm_set1_epi32(coefficient_pair(coefficients[k], coefficients[k + 1]));
+
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(two, c));
+        }
+
+        /* The last odd pixel is paired with zeros. */
+        if (k < count) {
+            int32_t pixel;
+            memcpy(&pixel, pixels + k * 4, sizeof(pixel));
+
+            const __m128i one = interleave_two_pixels_ssse3(_mm_cvtsi32_si128(pixel));
+            const __m128i c = _mm_set1_epi32(coefficient_pair(coefficients[k], 0));
+
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(one, c));
+        }
+
+        sum = _mm_srai_epi32(sum, SCALE_PRECISION_BITS);
+        sum = _mm_packs_epi32(sum, sum);
+        sum = _mm_packus_epi16(sum, sum);
+
+        const int32_t value = _mm_cvtsi128_si32(sum);
+        memcpy((uint8_t *)output + (size_t)column * 4, &value, sizeof(value));
+    }
+}
+/*
+ * Gathers the even or odd pixels of 2x2 blocks from two 16-byte loads into 16-bit values.
+ * The shuffles take the bytes from the first and the second load, and the results are ORed.
+ */
+struct halve_shuffles_ssse3 {
+    __m128i first[4];
+    __m128i second[4];
+};
+
+/*
+ * Builds the shuffles of 16 output values for 1, 2, or 4 channels, and 12 output values for 3 channels.
+ * The second load starts at byte 16, or at byte 8 for 3 channels to stay within 24 input bytes.
+ * The shuffles go in the order: even low, even high, odd low, odd high 16-bit values.
+ */
+SAIL_TARGET("ssse3")
+static void init_halve_shuffles_ssse3(unsigned channels, unsigned values, unsigned second_offset, struct halve_shuffles_ssse3 *shuffles) {
+
+    int8_t first[4][16];
+    int8_t second[4][16];
+
+    memset(first,  -1, sizeof(first));
+    memset(second, -1, sizeof(second));
+
+    for (unsigned i = 0; i < values; i++) {
+        const unsigned even = i / channels * 2 * channels + i % channels;
+
+        for (unsigned odd = 0; odd < 2; odd++) {
+            const unsigned source = even + odd * channels;
+            const unsigned index  = odd * 2 + i / 8;
+            const unsigned lane   = i % 8 * 2;
+
+            if (source < 16) {
+                first[index][lane] = (int8_t)source;
+            } else {
+                second[index][lane] = (int8_t)(source - second_offset);
+            }
+        }
+    }
+
+    for (unsigned k = 0; k < 4; k++) {
+        shuffles->first[k]  = _mm_loadu_si128((const __m128i *)first[k]);
+        shuffles->second[k] = _mm_loadu_si128((const __m128i *)second[k]);
+    }
+}
+
+/* Sums the even and odd pixels of a single scan line into the low and high 16-bit values. */
+SAIL_TARGET("ssse3")
+static inline void halve_sum_ssse3(const uint8_t *input, unsigned second_offset, const struct halve_shuffles_ssse3 *shuffles, __m128i *lo, __m128i *hi) {
+
+    const __m128i a = _mm_loadu_si128((const __m128i *)input);
+    const __m128i b = _mm_loadu_si128((const __m128i *)(input + second_offset));
+
+    __m128i v[4];
+
+    for (unsigned k = 0; k < 4; k++) {
+        v[k] = _mm_or_si128(_mm_shuffle_epi8(a, shuffles->first[k]), _mm_shuffle_epi8(b, shuffles->second[k]));
+    }
+
+    *lo = _mm_add_epi16(*lo, _mm_add_epi16(v[0], v[2]));
+    *hi = _mm_add_epi16(*hi, _mm_add_epi16(v[1], v[3]));
+}
+
+SAIL_TARGET("ssse3")
+static void halve8_ssse3(const void *row0, const void *row1, unsigned channels, void *output, unsigned width) {
+
+    const uint8_t *top    = row0;
+    const uint8_t *bottom = row1;
+    uint8_t *output8      = output;
+
+    /* 3 channels don't fit 16 values, so 4 pixels are averaged from 24 input bytes. */
+    const unsigned values        = (channels == 3) ? 12 : 16;
+    const unsigned pixels        = values / channels;
+    const unsigned second_offset = (channels == 3) ? 8 : 16;
+
+    struct halve_shuffles_ssse3 shuffles;
+    init_halve_shuffles_ssse3(channels, values, second_offset, &shuffles);
+
+    const __m128i rounding = _mm_set1_epi16(2);
+
+    unsigned column = 0;
+
+    for (; width - column >= pixels; column += pixels) {
+        const size_t input_offset = (size_t)column * 2 * channels;
+
+        __m128i lo = rounding;
+        __m128i hi = rounding;
+
+        halve_sum_ssse3(top    + input_offset, second_offset, &shuffles, &lo, &hi);
+        halve_sum_ssse3(bottom + input_offset, second_offset, &shuffles, &lo, &hi);
+
+        const __m128i result = _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2));
+        uint8_t *scan_output = output8 + (size_t)column * channels;
+
+        if (values == 16) {
+            _mm_storeu_si128((__m128i *)scan_output, result);
+        } else {
+            const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(result, 8));
+
+            _mm_storel_epi64((__m128i *)scan_output, result);
+            memcpy(scan_output + 8, &tail, sizeof(tail));
+        }
+    }
+
+    halve8_range_c(top, bottom, channels, output8, column, width);
+}
+#endif
+
+#ifdef SAIL_HAVE_NEON
+static inline int16x8_t widen_neon(uint8x8_t bytes) {
+
+    return vreinterpretq_s16_u16(vmovl_u8(bytes));
+}
+
+static void blend_rows8_neon(const void *const *rows, const int16_t *coefficients, unsigned count, void *output, unsigned values) {
+
+    const uint8_t *const *rows8 = (const uint8_t *const *)rows;
+    uint8_t *output8 = output;
+
+    unsigned i = 0;
+
+    for (; values - i >= 16; i += 16) {
+        int32x4_t sum0 = vdupq_n_s32(ROUNDING);
+        int32x4_t sum1 = sum0;
+        int32x4_t sum2 = sum0;
+        int32x4_t sum3 = sum0;
+
+        for (unsigned k = 0; k < count; k++) {
+            const uint8x16_t a = vld1q_u8(rows8[k] + i);
+            const int16x8_t lo = widen_neon(vget_low_u8(a));
+            const int16x8_t hi = widen_neon(vget_high_u8(a));
+
+            sum0 = vmlal_n_s16(sum0, vget_low_s16(lo),  coefficients[k]);
+            sum1 = vmlal_n_s16(sum1, vget_high_s16(lo), coefficients[k]);
+            sum2 = vmlal_n_s16(sum2, vget_low_s16(hi),  coefficients[k]);
+            sum3 = vmlal_n_s16(sum3, vget_high_s16(hi), coefficients[k]);
+        }
+
+        /* Saturating narrowing clamps the values exactly like clamp8() does. */
+        const int16x8_t lo16 = vcombine_s16(vqshrn_n_s32(sum0, SCALE_PRECISION_BITS), vqshrn_n_s32(sum1, SCALE_PRECISION_BITS));
+        const int16x8_t hi16 = vcombine_s16(vqshrn_n_s32(sum2, SCALE_PRECISION_BITS), vqshrn_n_s32(sum3, SCALE_PRECISION_BITS));
+
+        vst1q_u8(output8 + i, vcombine_u8(vqmovun_s16(lo16), vqmovun_s16(hi16)));
+    }
+
+    blend_rows8_range_c(rows8, coefficients, count, output8, i, values);
+}
+
+static void blend_pixels8_neon(const struct scale_weights *weights, unsigned channels, const void *input, void *output, unsigned width) {
+
+    if (channels != 4) {
+        blend_pixels8_c(weights, channels, input, output, width);
+        return;
+    }
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t *pixels = (const uint8_t *)input + (size_t)weights->bounds[column] * 4;
+        const int16_t *coefficients = weights->coefficients + (size_t)column * weights->max_count;
+
+        int32x4_t sum = vdupq_n_s32(ROUNDING);
+
+        for (unsigned k = 0; k < weights->counts[column]; k++) {
+            uint32_t pixel;
+            memcpy(&pixel, pixels + k * 4, sizeof(pixel));
+
+            sum = vmlal_n_s16(sum, vget_low_s16(widen_neon(vcreate_u8(pixel))), coefficients[k]);
+        }
+
+        const int16x4_t value16 = vqshrn_n_s32(sum, SCALE_PRECISION_BITS);
+        const uint8x8_t value8 = vqmovun_s16(vcombine_s16(value16, value16));
+
+        const uint32_t value = vget_lane_u32(vreinterpret_u32_u8(value8), 0);
+        memcpy((uint8_t *)output + (size_t)column * 4, &value, sizeof(value));
+    }
+}
+/* Averages 16 input pixels of every channel into 8 output pixels. Rounding narrowing shifts add 2 before dividing by 4. */
+static inline uint8x8_t halve_channel_neon(uint8x16_t top, uint8x16_t bottom) {
+
+    return vrshrn_n_u16(vaddq_u16(vpaddlq_u8(top), vpaddlq_u8(bottom)), 2);
+}
+
+static void halve8_neon(const void *row0, const void *row1, unsigned channels, void *output, unsigned width) {
+
+    const uint8_t *top    = row0;
+    const uint8_t *bottom = row1;
+    uint8_t *output8      = output;
+
+    unsigned column = 0;
+
+    for (; width - column >= 8; column += 8) {
+        const size_t input_offset = (size_t)column * 2 * channels;
+        uint8_t *scan_output = output8 + (size_t)column * channels;
+
+        switch (channels) {
+            case 1: {
+                vst1_u8(scan_output, halve_channel_neon(vld1q_u8(top + input_offset), vld1q_u8(bottom + input_offset)));
+                break;
+            }
+            case 2: {
+                const uint8x16x2_t a = vld2q_u8(top + input_offset);
+                const uint8x16x2_t b = vld2q_u8(bottom + input_offset);
+                uint8x8x2_t result;
+
+                for (unsigned c = 0; c < 2; c++) {
+                    result.val[c] = halve_channel_neon(a.val[c], b.val[c]);
+                }
+
+                vst2_u8(scan_output, result);
+                break;
+            }
+            case 3: {
+                const uint8x16x3_t a = vld3q_u8(top + input_offset);
+                const uint8x16x3_t b = vld3q_u8(bottom + input_offset);
+                uint8x8x3_t result;
+
+                for (unsigned c = 0; c < 3; c++) {
+                    result.val[c] = halve_channel_neon(a.val[c], b.val[c]);
+                }
+
+                vst3_u8(scan_output, result);
+                break;
+            }
+            default: {
+                const uint8x16x4_t a = vld4q_u8(top + input_offset);
+                const uint8x16x4_t b = vld4q_u8(bottom + input_offset);
+                uint8x8x4_t result;
+
+                for (unsigned c = 0; c < 4; c++) {
+                    result.val[c] = halve_channel_neon(a.val[c], b.val[c]);
+                }
+
+                vst4_u8(scan_output, result);
+                break;
+            }
+        }
+    }
+
+    halve8_range_c(top, bottom, channels, output8, column, width);
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+void scale_kernels_init(unsigned bytes_per_channel, struct scale_kernels *kernels) {
+
+    if (bytes_per_channel == 2) {
+        kernels->blend_rows   = blend_rows16_c;
+        kernels->blend_pixels = blend_pixels16_c;
+        kernels->halve        = halve16_c;
+        return;
+    }
+
+    kernels->blend_rows   = blend_rows8_c;
+    kernels->blend_pixels = blend_pixels8_c;
+    kernels->halve        = halve8_c;
+
+#if defined SAIL_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        kernels->blend_rows   = blend_rows8_avx2;
+        kernels->blend_pixels = blend_pixels8_ssse3;
+        kernels->halve        = halve8_ssse3;
+    } else if (cpu_has_ssse3()) {
+        kernels->blend_rows   = blend_rows8_ssse3;
+        kernels->blend_pixels = blend_pixels8_ssse3;
+        kernels->halve        = halve8_ssse3;
+    }
+#elif defined SAIL_HAVE_NEON
+    kernels->blend_rows   = blend_rows8_neon;
+    kernels->blend_pixels = blend_pixels8_neon;
+    kernels->halve        = halve8_neon;
+#endif
+}
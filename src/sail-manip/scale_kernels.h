@@ -0,0 +1,57 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_SCALE_KERNELS_H
+#define SAIL_SCALE_KERNELS_H
+
+#include <stdint.h>
+
+#include <sail-common/export.h>
+
+#include <sail-manip/scale_weights.h>
+
+/*
+ * Inner loops of scaling. Results are rounded and clamped to the channel range. 8-bit channels
+ * are blended with AVX2, SSSE3, or NEON depending on the CPU, and plain C otherwise. 2x2 blocks
+ * of 8-bit channels are averaged with SSSE3 or NEON. All the implementations produce identical results.
+ */
+struct scale_kernels {
+
+    /* Blends the input scan lines with the coefficients into the first channel values of the output scan line. */
+    void (*blend_rows)(const void *const *rows, const int16_t *coefficients, unsigned count, void *output, unsigned values);
+
+    /* Blends the input pixels with the weights into the output scan line of the specified width. */
+    void (*blend_pixels)(const struct scale_weights *weights, unsigned channels, const void *input, void *output, unsigned width);
+
+    /* Averages 2x2 blocks of the two input scan lines into the output scan line of the specified width. The input scan lines are twice as wide. */
+    void (*halve)(const void *row0, const void *row1, unsigned channels, void *output, unsigned width);
+};
+
+/*
+ * Selects the fastest kernels for 1 or 2 bytes per channel supported by the CPU.
+ */
+SAIL_HIDDEN void scale_kernels_init(unsigned bytes_per_channel, struct scale_kernels *kernels);
+
+#endif
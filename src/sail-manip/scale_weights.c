@@ -0,0 +1,227 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+static const double PI = 3.14159265358979323846;
+
+/* The filter is non-zero in (-support; support). */
+static double filter_support(enum SailScaling algorithm) {
+
+    switch (algorithm) {
+        case SAIL_SCALING_BILINEAR: return 1;
+        case SAIL_SCALING_LANCZOS3: return 3;
+
+        default: return 0.5;
+    }
+}
+
+static double sinc(double x) {
+
+    if (x == 0) {
+        return 1;
+    }
+
+    x *= PI;
+
+    return sin(x) / x;
+}
+
+static double filter(enum SailScaling algorithm, double x) {
+
+    switch (algorithm) {
+        case SAIL_SCALING_BILINEAR: {
+            x = fabs(x);
+            return (x < 1) ? 1 - x : 0;
+        }
+        case SAIL_SCALING_LANCZOS3: {
+            return (fabs(x) < 3) ? sinc(x) * sinc(x / 3) : 0;
+        }
+
+        default: {
+            /* Half-open, so an input pixel on the border between two output pixels belongs to a single one. */
+            return (x > -0.5 && x <= 0.5) ? 1 : 0;
+        }
+    }
+}
+
+/* Every output pixel takes the input pixel under its center. */
+static void init_nearest_weights(unsigned input_size, unsigned output_size, struct scale_weights *weights) {
+
+    for (unsigned i = 0; i < output_size; i++) {
+        weights->bounds[i]       = (unsigned)(((uint64_t)i * 2 + 1) * input_size / ((uint64_t)output_size * 2));
+        weights->counts[i]       = 1;
+        weights->coefficients[i] = 1 << SCALE_PRECISION_BITS;
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+bool scale_layout(enum SailPixelFormat pixel_format, unsigned *channels, unsigned *bytes_per_channel) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:        { *channels = 1; *bytes_per_channel = 1; return true; }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:       { *channels = 1; *bytes_per_channel = 2; return true; }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: { *channels = 2; *bytes_per_channel = 1; return true; }
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: { *channels = 2; *bytes_per_channel = 2; return true; }
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: { *channels = 3; *bytes_per_channel = 1; return true; }
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_BGR: { *channels = 3; *bytes_per_channel = 2; return true; }
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: { *channels = 4; *bytes_per_channel = 1; return true; }
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP64_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP64_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: { *channels = 4; *bytes_per_channel = 2; return true; }
+
+        default: {
+            return false;
+        }
+    }
+}
+
+void destroy_scale_weights(struct scale_weights *weights) {
+
+    sail_free(weights->bounds);
+    sail_free(weights->counts);
+    sail_free(weights->coefficients);
+}
+
+sail_status_t init_scale_weights(unsigned input_size, unsigned output_size, enum SailScaling algorithm, struct scale_weights *weights) {
+
+    const double scale        = (double)input_size / output_size;
+    const double filter_scale = SAIL_MAX(scale, 1.0);
+    const double support      = filter_support(algorithm) * filter_scale;
+
+    *weights = (struct scale_weights) {
+        .bounds       = NULL,
+        .counts       = NULL,
+        .coefficients = NULL,
+        .max_count    = (algorithm == SAIL_SCALING_NEAREST_NEIGHBOR) ? 1 : (unsigned)ceil(support) * 2 + 1,
+    };
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(unsigned) * output_size, &ptr));
+    weights->bounds = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(unsigned) * output_size, &ptr),
+                        /* cleanup */ destroy_scale_weights(weights));
+    weights->counts = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(int16_t) * output_size * weights->max_count, &ptr),
+                        /* cleanup */ destroy_scale_weights(weights));
+    weights->coefficients = ptr;
+
+    if (algorithm == SAIL_SCALING_NEAREST_NEIGHBOR) {
+        init_nearest_weights(input_size, output_size, weights);
+        return SAIL_OK;
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(double) * weights->max_count, &ptr),
+                        /* cleanup */ destroy_scale_weights(weights));
+    double *values = ptr;
+
+    for (unsigned i = 0; i < output_size; i++) {
+        const double center = (i + 0.5) * scale;
+
+        const unsigned first = (unsigned)SAIL_MAX(0.0, floor(center - support + 0.5));
+        const unsigned last  = (unsigned)SAIL_MIN((double)input_size, floor(center + support + 0.5));
+
+        double sum = 0;
+
+        for (unsigned j = first; j < last; j++) {
+            values[j - first] = filter(algorithm, (j + 0.5 - center) / filter_scale);
+            sum += values[j - first];
+        }
+
+        /* The coefficients sum up to exactly 1, so solid colors stay intact. */
+        int16_t *coefficients = weights->coefficients + (size_t)i * weights->max_count;
+        unsigned count = last - first;
+        unsigned largest = 0;
+        int total = 0;
+
+        for (unsigned k = 0; k < count; k++) {
+            coefficients[k] = (int16_t)lround(values[k] / sum * (1 << SCALE_PRECISION_BITS));
+            total += coefficients[k];
+
+            if (coefficients[k] > coefficients[largest]) {
+                largest = k;
+            }
+        }
+
+        coefficients[largest] = (int16_t)(coefficients[largest] + (1 << SCALE_PRECISION_BITS) - total);
+
+        /* Skip input pixels with zero coefficients at the ends. For example, every output pixel takes a single input pixel when the size is unchanged. */
+        unsigned skip = 0;
+
+        while (coefficients[skip] == 0) {
+            skip++;
+        }
+        while (coefficients[count - 1] == 0) {
+            count--;
+        }
+
+        memmove(coefficients, coefficients + skip, sizeof(int16_t) * (count - skip));
+
+        weights->bounds[i] = first + skip;
+        weights->counts[i] = count - skip;
+    }
+
+    sail_free(values);
+
+    return SAIL_OK;
+}
+
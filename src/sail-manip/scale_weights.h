@@ -0,0 +1,73 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_SCALE_WEIGHTS_H
+#define SAIL_SCALE_WEIGHTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#include <sail-manip/manip_common.h>
+
+/* Scaling coefficients are fixed-point numbers with this number of fractional bits. */
+#define SCALE_PRECISION_BITS 14
+
+/*
+ * Coefficients of input pixels along a single axis. Output pixel i blends counts[i] input
+ * pixels starting from bounds[i]. Coefficients of every output pixel sum up to 1 << SCALE_PRECISION_BITS.
+ */
+struct scale_weights {
+
+    unsigned *bounds;
+    unsigned *counts;
+
+    /* max_count coefficients for every output pixel. */
+    int16_t *coefficients;
+    unsigned max_count;
+};
+
+/*
+ * Returns the number of channels and bytes per channel of the pixel format. Channels are blended
+ * independently, so only their number and size matter. Returns false if the pixel format cannot be scaled.
+ */
+SAIL_HIDDEN bool scale_layout(enum SailPixelFormat pixel_format, unsigned *channels, unsigned *bytes_per_channel);
+
+/*
+ * Computes the coefficients of input pixels for every output pixel. When downscaling,
+ * the filter is stretched to cover all the input pixels. The nearest neighbor algorithm
+ * takes a single input pixel under the center of every output pixel.
+ */
+SAIL_HIDDEN sail_status_t init_scale_weights(unsigned input_size, unsigned output_size, enum SailScaling algorithm, struct scale_weights *weights);
+
+/*
+ * Frees the arrays of the weights. Doesn't free the structure itself.
+ */
+SAIL_HIDDEN void destroy_scale_weights(struct scale_weights *weights);
+
+#endif
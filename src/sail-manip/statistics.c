@@ -0,0 +1,477 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* Pixel formats that are not analyzed as is are converted into this one. */
+static const enum SailPixelFormat FALLBACK_PIXEL_FORMAT = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+
+/* Positions of the analyzed channels in pixels. */
+struct statistics_layout {
+
+    unsigned bytes_per_channel;
+    unsigned bytes_per_pixel;
+
+    /* Byte offsets of the red, green, blue, and alpha values. Grayscale values have a single offset. Alpha is -1 if absent. */
+    int offsets[4];
+
+    bool grayscale;
+};
+
+static bool statistics_layout(enum SailPixelFormat pixel_format, struct statistics_layout *layout) {
+
+    /* Offsets in channels. */
+    unsigned channels;
+    int r, g, b, a;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:       { channels = 1; r = g = b = 0; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA:  { channels = 2; r = g = b = 0; a =  1; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:  { channels = 3; r = 0; g = 1; b = 2; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:
+        case SAIL_PIXEL_FORMAT_BPP48_BGR:  { channels = 3; r = 2; g = 1; b = 0; a = -1; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBX: { channels = 4; r = 0; g = 1; b = 2; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRX: { channels = 4; r = 2; g = 1; b = 0; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP64_XRGB: { channels = 4; r = 1; g = 2; b = 3; a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP64_XBGR: { channels = 4; r = 3; g = 2; b = 1; a = -1; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: { channels = 4; r = 0; g = 1; b = 2; a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: { channels = 4; r = 2; g = 1; b = 0; a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: { channels = 4; r = 1; g = 2; b = 3; a = 0; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: { channels = 4; r = 3; g = 2; b = 1; a = 0; break; }
+
+        default: {
+            return false;
+        }
+    }
+
+    const unsigned bytes_per_channel = sail_bits_per_pixel(pixel_format) / 8 / channels;
+
+    layout->bytes_per_channel = bytes_per_channel;
+    layout->bytes_per_pixel   = channels * bytes_per_channel;
+    layout->offsets[0]        = r * (int)bytes_per_channel;
+    layout->offsets[1]        = g * (int)bytes_per_channel;
+    layout->offsets[2]        = b * (int)bytes_per_channel;
+    layout->offsets[3]        = (a < 0) ? -1 : a * (int)bytes_per_channel;
+    layout->grayscale         = sail_is_grayscale(pixel_format);
+
+    return true;
+}
+
+static inline unsigned channel_value(const uint8_t *pixel, int offset, unsigned bytes_per_channel) {
+
+    if (bytes_per_channel == 1) {
+        return pixel[offset];
+    }
+
+    uint16_t value;
+    memcpy(&value, pixel + offset, sizeof(value));
+
+    return value;
+}
+
+/* Packs the red, green, blue, and alpha values into 16-bit fields. Padding bytes are not taken into account. */
+static inline uint64_t pack_color(const struct statistics_layout *layout, const uint8_t *pixel, unsigned bytes_per_channel) {
+
+    const uint64_t alpha = (layout->offsets[3] < 0) ? 0 : channel_value(pixel, layout->offsets[3], bytes_per_channel);
+
+    return (uint64_t)channel_value(pixel, layout->offsets[0], bytes_per_channel)
+            | ((uint64_t)channel_value(pixel, layout->offsets[1], bytes_per_channel) << 16)
+            | ((uint64_t)channel_value(pixel, layout->offsets[2], bytes_per_channel) << 32)
+            | (alpha << 48);
+}
+
+/* Adds the colors of the scan line to the set. Runs of identical colors are looked up once. */
+static inline void count_colors_row_generic(const struct statistics_layout *layout, const uint8_t *scan, unsigned width,
+                                            unsigned bytes_per_channel, struct color_set *set) {
+
+    const unsigned bytes_per_pixel = layout->bytes_per_pixel;
+
+    uint64_t previous = pack_color(layout, scan, bytes_per_channel);
+
+    if (!add_to_color_set(set, previous, SAIL_STATISTICS_MAX_COLORS)) {
+        return;
+    }
+
+    for (unsigned column = 1; column < width; column++) {
+        const uint64_t color = pack_color(layout, scan + (size_t)column * bytes_per_pixel, bytes_per_channel);
+
+        if (color == previous) {
+            continue;
+        }
+
+        if (!add_to_color_set(set, color, SAIL_STATISTICS_MAX_COLORS)) {
+            return;
+        }
+
+        previous = color;
+    }
+}
+
+static void count_colors_row(const struct statistics_layout *layout, const uint8_t *scan, unsigned width, struct color_set *set) {
+
+    /* Constant channel sizes let the compiler drop the branches from the pixel loop. */
+    if (layout->bytes_per_channel == 1) {
+        count_colors_row_generic(layout, scan, width, 1, set);
+    } else {
+        count_colors_row_generic(layout, scan, width, 2, set);
+    }
+}
+
+/*
+ * Statistics of a block of scan lines.
+ */
+struct statistics_block {
+
+    /* Two sets of histograms for even and odd pixels, so equal neighbors don't wait for each other's increments. */
+    uint64_t histograms[2][4][SAIL_HISTOGRAM_BINS];
+
+    /* Sums, minimum, and maximum values of 16-bit channels. 8-bit ones are derived from the histograms. */
+    uint64_t sums[4];
+    unsigned min[4];
+    unsigned max[4];
+
+    bool grayscale;
+    struct color_set colors;
+};
+
+struct statistics_job {
+
+    const struct sail_image *image;
+    struct statistics_layout layout;
+    struct statistics_kernels kernels;
+    unsigned rows_per_block;
+
+    struct statistics_block *blocks;
+};
+
+static void histogram_row8(const uint8_t *values, unsigned width, unsigned bytes_per_pixel, uint64_t *even, uint64_t *odd) {
+
+    unsigned column = 0;
+
+    for (; column + 2 <= width; column += 2) {
+        even[values[0]]++;
+        odd[values[bytes_per_pixel]]++;
+        values += 2 * bytes_per_pixel;
+    }
+
+    if (column < width) {
+        even[values[0]]++;
+    }
+}
+
+static void histogram_row16(const uint8_t *values, unsigned width, unsigned bytes_per_pixel, uint64_t *histogram,
+                            uint64_t *sum, unsigned *min, unsigned *max) {
+
+    uint64_t sum_local = 0;
+    unsigned min_local = *min;
+    unsigned max_local = *max;
+
+    for (unsigned column = 0; column < width; column++) {
+        uint16_t value;
+        memcpy(&value, values, sizeof(value));
+        values += bytes_per_pixel;
+
+        histogram[value >> 8]++;
+        sum_local += value;
+        min_local = SAIL_MIN(min_local, (unsigned)value);
+        max_local = SAIL_MAX(max_local, (unsigned)value);
+    }
+
+    *sum += sum_local;
+    *min = min_local;
+    *max = max_local;
+}
+
+static bool is_gray_row16(const uint8_t *scan, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3]) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t *pixel = scan + (size_t)column * bytes_per_pixel;
+        uint16_t r, g, b;
+
+        memcpy(&r, pixel + offsets[0], sizeof(r));
+        memcpy(&g, pixel + offsets[1], sizeof(g));
+        memcpy(&b, pixel + offsets[2], sizeof(b));
+
+        if (r != g || g != b) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static sail_status_t statistics_row_block(void *context, unsigned first_row, unsigned row_count) {
+
+    struct statistics_job *job = context;
+
+    const struct statistics_layout *layout = &job->layout;
+    const unsigned width = job->image->width;
+    const unsigned offsets[3] = { (unsigned)layout->offsets[0], (unsigned)layout->offsets[1], (unsigned)layout->offsets[2] };
+
+    struct statistics_block *block = job->blocks + first_row / job->rows_per_block;
+
+    for (unsigned c = 0; c < 4; c++) {
+        block->min[c] = UINT_MAX;
+    }
+
+    block->grayscale = true;
+
+    for (unsigned row = first_row; row < first_row + row_count; row++) {
+        const uint8_t *scan = sail_scan_line(job->image, row);
+
+        /* Grayscale values are counted once and copied into green and blue after merging. */
+        for (unsigned c = 0; c < 4; c++) {
+            if (layout->offsets[c] < 0 || (layout->grayscale && (c == 1 || c == 2))) {
+                continue;
+            }
+
+            if (layout->bytes_per_channel == 1) {
+                histogram_row8(scan + layout->offsets[c], width, layout->bytes_per_pixel,
+                                block->histograms[0][c], block->histograms[1][c]);
+            } else {
+                histogram_row16(scan + layout->offsets[c], width, layout->bytes_per_pixel, block->histograms[0][c],
+                                &block->sums[c], &block->min[c], &block->max[c]);
+            }
+        }
+
+        if (block->grayscale && !layout->grayscale) {
+            block->grayscale = (layout->bytes_per_channel == 1)
+                                ? job->kernels.is_gray_row(scan, width, layout->bytes_per_pixel, offsets)
+                                : is_gray_row16(scan, width, layout->bytes_per_pixel, offsets);
+        }
+
+        if (!block->colors.overflow) {
+            count_colors_row(layout, scan, width, &block->colors);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+/* Merges the blocks into the statistics. */
+static void merge_statistics_blocks(const struct statistics_job *job, unsigned block_count, struct sail_image_statistics *statistics) {
+
+    const struct statistics_layout *layout = &job->layout;
+    const uint64_t pixel_count = (uint64_t)job->image->width * job->image->height;
+
+    statistics->pixel_count = pixel_count;
+    statistics->max_value   = (layout->bytes_per_channel == 1) ? 255 : 65535;
+    statistics->grayscale   = true;
+
+    struct color_set colors;
+    memset(&colors, 0, sizeof(colors));
+
+    for (unsigned c = 0; c < 4; c++) {
+        statistics->min[c] = UINT_MAX;
+        statistics->max[c] = 0;
+    }
+
+    uint64_t sums[4] = { 0, 0, 0, 0 };
+
+    for (unsigned i = 0; i < block_count; i++) {
+        const struct statistics_block *block = &job->blocks[i];
+
+        for (unsigned c = 0; c < 4; c++) {
+            for (unsigned bin = 0; bin < SAIL_HISTOGRAM_BINS; bin++) {
+                statistics->histograms[c][bin] += block->histograms[0][c][bin] + block->histograms[1][c][bin];
+            }
+
+            sums[c] += block->sums[c];
+            statistics->min[c] = SAIL_MIN(statistics->min[c], block->min[c]);
+            statistics->max[c] = SAIL_MAX(statistics->max[c], block->max[c]);
+        }
+
+        statistics->grayscale = statistics->grayscale && block->grayscale;
+
+        if (block->colors.overflow) {
+            colors.overflow = true;
+        }
+
+        for (unsigned slot = 0; slot < COLOR_SET_SIZE && !colors.overflow; slot++) {
+            if (block->colors.used[slot]) {
+                add_to_color_set(&colors, block->colors.colors[slot], SAIL_STATISTICS_MAX_COLORS);
+            }
+        }
+    }
+
+    statistics->color_count = colors.overflow ? 0 : colors.count;
+
+    for (unsigned c = 0; c < 4; c++) {
+        /* Every pixel of images without alpha is fully opaque. */
+        if (layout->offsets[c] < 0) {
+            statistics->histograms[c][SAIL_HISTOGRAM_BINS - 1] = pixel_count;
+            statistics->min[c]  = statistics->max_value;
+            statistics->max[c]  = statistics->max_value;
+            statistics->mean[c] = statistics->max_value;
+            continue;
+        }
+
+        if (layout->grayscale && (c == 1 || c == 2)) {
+            continue;
+        }
+
+        /* 8-bit values are the bins. */
+        if (layout->bytes_per_channel == 1) {
+            bool found = false;
+
+            for (unsigned bin = 0; bin < SAIL_HISTOGRAM_BINS; bin++) {
+                if (statistics->histograms[c][bin] > 0) {
+                    if (!found) {
+                        statistics->min[c] = bin;
+                        found = true;
+                    }
+
+                    statistics->max[c] = bin;
+                    sums[c] += statistics->histograms[c][bin] * bin;
+                }
+            }
+        }
+
+        statistics->mean[c] = (double)sums[c] / (double)pixel_count;
+    }
+
+    if (layout->grayscale) {
+        for (unsigned c = 1; c < 3; c++) {
+            memcpy(statistics->histograms[c], statistics->histograms[0], sizeof(statistics->histograms[0]));
+            statistics->min[c]  = statistics->min[0];
+            statistics->max[c]  = statistics->max[0];
+            statistics->mean[c] = statistics->mean[0];
+        }
+    }
+
+    statistics->opaque = statistics->min[SAIL_STATISTICS_CHANNEL_ALPHA] == statistics->max_value;
+}
+
+static sail_status_t compute_statistics(const struct sail_image *image, const struct statistics_layout *layout,
+                                        unsigned max_threads, struct sail_image_statistics *statistics) {
+
+    const unsigned min_rows = SAIL_MAX(1U, PARALLEL_BLOCK_PIXELS / image->width);
+
+    struct statistics_job job = {
+        .image          = image,
+        .layout         = *layout,
+        .rows_per_block = SAIL_MAX(min_rows, (image->height + STATISTICS_BLOCKS - 1) / STATISTICS_BLOCKS),
+        .blocks         = NULL,
+    };
+
+    statistics_kernels_init(&job.kernels);
+
+    const unsigned block_count = (image->height + job.rows_per_block - 1) / job.rows_per_block;
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(block_count, sizeof(struct statistics_block), &ptr));
+    job.blocks = ptr;
+
+    SAIL_TRY_OR_CLEANUP(parallel_for_rows(image->height, job.rows_per_block, max_threads, statistics_row_block, &job),
+                        /* cleanup */ sail_free(job.blocks));
+
+    merge_statistics_blocks(&job, block_count, statistics);
+
+    sail_free(job.blocks);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_compute_image_statistics(const struct sail_image *image, struct sail_image_statistics **statistics) {
+
+    SAIL_TRY(sail_compute_image_statistics_with_options(image, NULL, statistics));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_compute_image_statistics_with_options(const struct sail_image *image,
+                                                         const struct sail_conversion_options *options,
+                                                         struct sail_image_statistics **statistics) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(statistics);
+
+    const unsigned max_threads = (options == NULL) ? 0 : options->max_threads;
+
+    struct statistics_layout layout;
+    struct sail_image *converted = NULL;
+
+    if (!statistics_layout(image->pixel_format, &layout)) {
+        if (!sail_can_convert(image->pixel_format, FALLBACK_PIXEL_FORMAT)) {
+            SAIL_LOG_ERROR("Computing statistics of %s pixels is not supported", sail_pixel_format_to_string(image->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+
+        SAIL_TRY(sail_convert_image_with_options(image, FALLBACK_PIXEL_FORMAT, options, &converted));
+        statistics_layout(FALLBACK_PIXEL_FORMAT, &layout);
+    }
+
+    struct sail_image_statistics *statistics_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_statistics(&statistics_local),
+                        /* cleanup */ sail_destroy_image(converted));
+
+    SAIL_TRY_OR_CLEANUP(compute_statistics((converted == NULL) ? image : converted, &layout, max_threads, statistics_local),
+                        /* cleanup */ sail_destroy_image_statistics(statistics_local), sail_destroy_image(converted));
+
+    sail_destroy_image(converted);
+
+    *statistics = statistics_local;
+
+    return SAIL_OK;
+}
+
+bool sail_can_compute_image_statistics(enum SailPixelFormat pixel_format) {
+
+    struct statistics_layout layout;
+
+    return statistics_layout(pixel_format, &layout) || sail_can_convert(pixel_format, FALLBACK_PIXEL_FORMAT);
+}
@@ -0,0 +1,85 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_STATISTICS_H
+#define SAIL_STATISTICS_H
+
+#include <stdbool.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_conversion_options;
+struct sail_image;
+struct sail_image_statistics;
+
+/*
+ * Computes per-channel histograms, minimum, maximum, and mean values, and checks whether the image
+ * is fully opaque, grayscale, and uses at most SAIL_STATISTICS_MAX_COLORS colors. See sail_image_statistics.
+ *
+ * Everything is computed in a single pass over the pixels. Scan lines are processed in blocks with up
+ * to sail_max_threads() threads. Grayscale checks of 8-bit pixels use AVX2, SSSE3, or NEON instructions
+ * when the CPU supports them. Distinct colors are counted until there are too many of them.
+ *
+ * Pixels of the following formats are analyzed as is:
+ *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE
+ *   - SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA
+ *   - SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA
+ *   - 24, 32, 48, and 64-bit RGB-like pixel formats
+ *   - Premultiplied pixel formats. Their values are analyzed as stored.
+ *
+ * Other pixel formats are converted into BPP32-RGBA first if sail_can_convert() supports it.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_compute_image_statistics(const struct sail_image *image, struct sail_image_statistics **statistics);
+
+/*
+ * Computes statistics of the image. Same as sail_compute_image_statistics(), but options (which may be NULL)
+ * control the conversion behavior of pixel formats that are not analyzed as is, and the maximum number of threads.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_compute_image_statistics_with_options(const struct sail_image *image,
+                                                                     const struct sail_conversion_options *options,
+                                                                     struct sail_image_statistics **statistics);
+
+/*
+ * Returns true if statistics of images of the pixel format can be computed with sail_compute_image_statistics().
+ */
+SAIL_EXPORT bool sail_can_compute_image_statistics(enum SailPixelFormat pixel_format);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
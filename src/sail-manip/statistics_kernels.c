@@ -0,0 +1,221 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#ifdef SAIL_HAVE_NEON
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+/* Checks the pixels [first; width). */
+static bool is_gray_row_range_c(const uint8_t *scan, unsigned first, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3]) {
+
+    for (unsigned column = first; column < width; column++) {
+        const uint8_t *pixel = scan + (size_t)column * bytes_per_pixel;
+
+        if (pixel[offsets[0]] != pixel[offsets[1]] || pixel[offsets[1]] != pixel[offsets[2]]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool is_gray_row_c(const uint8_t *scan, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3]) {
+
+    return is_gray_row_range_c(scan, 0, width, bytes_per_pixel, offsets);
+}
+
+#ifdef SAIL_HAVE_X86_SIMD
+/*
+ * Builds a shuffle that replaces red with green, green with blue, and blue with red in every whole pixel
+ * of 16 bytes. Other bytes stay in place. The shuffled vector equals the original one only if all the
+ * pixels are gray.
+ */
+static void gray_shuffle_bytes(unsigned bytes_per_pixel, const unsigned offsets[3], int8_t shuffle[16]) {
+
+    const unsigned pixels = 16 / bytes_per_pixel;
+
+    for (unsigned i = 0; i < 16; i++) {
+        shuffle[i] = (int8_t)i;
+    }
+
+    for (unsigned p = 0; p < pixels; p++) {
+        const unsigned base = p * bytes_per_pixel;
+
+        shuffle[base + offsets[0]] = (int8_t)(base + offsets[1]);
+        shuffle[base + offsets[1]] = (int8_t)(base + offsets[2]);
+        shuffle[base + offsets[2]] = (int8_t)(base + offsets[0]);
+    }
+}
+
+/* Checks whole pixels in 16-byte blocks starting from the first pixel. Returns the first unchecked pixel, or width if a pixel is not gray. */
+SAIL_TARGET("ssse3")
+static unsigned is_gray_blocks_ssse3(const uint8_t *scan, unsigned first, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3], bool *gray) {
+
+    int8_t bytes[16];
+    gray_shuffle_bytes(bytes_per_pixel, offsets, bytes);
+
+    const __m128i shuffle = _mm_loadu_si128((const __m128i *)bytes);
+    const unsigned pixels = 16 / bytes_per_pixel;
+
+    __m128i difference = _mm_setzero_si128();
+    unsigned column = first;
+
+    /* 16 bytes are loaded, so the block must not reach beyond the last pixel. */
+    for (; ((size_t)width - column) * bytes_per_pixel >= 16; column += pixels) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(scan + (size_t)column * bytes_per_pixel));
+
+        difference = _mm_or_si128(difference, _mm_xor_si128(v, _mm_shuffle_epi8(v, shuffle)));
+    }
+
+    *gray = _mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())) == 0xFFFF;
+
+    return column;
+}
+
+SAIL_TARGET("ssse3")
+static bool is_gray_row_ssse3(const uint8_t *scan, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3]) {
+
+    if (bytes_per_pixel != 3 && bytes_per_pixel != 4) {
+        return is_gray_row_c(scan, width, bytes_per_pixel, offsets);
+    }
+
+    bool gray;
+    const unsigned column = is_gray_blocks_ssse3(scan, 0, width, bytes_per_pixel, offsets, &gray);
+
+    return gray && is_gray_row_range_c(scan, column, width, bytes_per_pixel, offsets);
+}
+
+/* Same as is_gray_row_ssse3() with 32-byte blocks of 4-byte pixels. Shuffles work within 128-bit lanes that hold whole pixels. */
+SAIL_TARGET("avx2")
+static bool is_gray_row_avx2(const uint8_t *scan, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3]) {
+
+    if (bytes_per_pixel != 4) {
+        return is_gray_row_ssse3(scan, width, bytes_per_pixel, offsets);
+    }
+
+    int8_t bytes[16];
+    gray_shuffle_bytes(bytes_per_pixel, offsets, bytes);
+
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)bytes));
+
+    __m256i difference = _mm256_setzero_si256();
+    unsigned column = 0;
+
+    for (; width - column >= 8; column += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(scan + (size_t)column * 4));
+
+        difference = _mm256_or_si256(difference, _mm256_xor_si256(v, _mm256_shuffle_epi8(v, shuffle)));
+    }
+
+    if (!_mm256_testz_si256(difference, difference)) {
+        return false;
+    }
+
+    bool gray;
+    column = is_gray_blocks_ssse3(scan, column, width, bytes_per_pixel, offsets, &gray);
+
+    return gray && is_gray_row_range_c(scan, column, width, bytes_per_pixel, offsets);
+}
+#endif
+
+#ifdef SAIL_HAVE_NEON
+static bool is_gray_row_neon(const uint8_t *scan, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3]) {
+
+    if (bytes_per_pixel != 3 && bytes_per_pixel != 4) {
+        return is_gray_row_c(scan, width, bytes_per_pixel, offsets);
+    }
+
+    /* Structure loads split 16 pixels into channels. */
+    uint8x16_t difference = vdupq_n_u8(0);
+    unsigned column = 0;
+
+    for (; width - column >= 16; column += 16) {
+        const uint8_t *pixels = scan + (size_t)column * bytes_per_pixel;
+        uint8x16_t channels[4];
+
+        if (bytes_per_pixel == 3) {
+            const uint8x16x3_t v = vld3q_u8(pixels);
+            channels[0] = v.val[0];
+            channels[1] = v.val[1];
+            channels[2] = v.val[2];
+            channels[3] = vdupq_n_u8(0);
+        } else {
+            const uint8x16x4_t v = vld4q_u8(pixels);
+            channels[0] = v.val[0];
+            channels[1] = v.val[1];
+            channels[2] = v.val[2];
+            channels[3] = v.val[3];
+        }
+
+        const uint8x16_t r = channels[offsets[0]];
+        const uint8x16_t g = channels[offsets[1]];
+        const uint8x16_t b = channels[offsets[2]];
+
+        difference = vorrq_u8(difference, vorrq_u8(veorq_u8(r, g), veorq_u8(g, b)));
+    }
+
+    const uint8x8_t folded = vorr_u8(vget_low_u8(difference), vget_high_u8(difference));
+
+    if (vget_lane_u64(vreinterpret_u64_u8(folded), 0) != 0) {
+        return false;
+    }
+
+    return is_gray_row_range_c(scan, column, width, bytes_per_pixel, offsets);
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+void statistics_kernels_init(struct statistics_kernels *kernels) {
+
+    kernels->is_gray_row = is_gray_row_c;
+
+#if defined SAIL_HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        kernels->is_gray_row = is_gray_row_avx2;
+    } else if (cpu_has_ssse3()) {
+        kernels->is_gray_row = is_gray_row_ssse3;
+    }
+#elif defined SAIL_HAVE_NEON
+    kernels->is_gray_row = is_gray_row_neon;
+#endif
+}
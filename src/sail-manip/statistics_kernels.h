@@ -0,0 +1,52 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_STATISTICS_KERNELS_H
+#define SAIL_STATISTICS_KERNELS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+
+/*
+ * Inner loops of image statistics over 8-bit channels. The kernels use AVX2, SSSE3, or NEON
+ * depending on the CPU, and plain C otherwise. All the implementations produce identical results.
+ */
+struct statistics_kernels {
+
+    /*
+     * Returns true if the red, green, and blue values are equal in every pixel of the scan line.
+     * Offsets are the byte offsets of the red, green, and blue values in pixels.
+     */
+    bool (*is_gray_row)(const uint8_t *scan, unsigned width, unsigned bytes_per_pixel, const unsigned offsets[3]);
+};
+
+/*
+ * Selects the fastest kernels supported by the CPU.
+ */
+SAIL_HIDDEN void statistics_kernels_init(struct statistics_kernels *kernels);
+
+#endif
@@ -0,0 +1,403 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <sail-common/config.h>
+
+#ifdef SAIL_THREAD_POOL
+    #ifdef SAIL_WIN32
+        #include <Windows.h>
+    #else
+        #include <pthread.h>
+        #include <unistd.h>
+    #endif
+#elif defined _OPENMP
+    #include <omp.h>
+#endif
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+#if defined SAIL_THREAD_POOL || defined _OPENMP
+/* Upper limit of threads to protect against misconfiguration. */
+static const unsigned MAX_THREADS = 256;
+#endif
+
+/* Runs all blocks in the calling thread. */
+static sail_status_t process_serially(unsigned row_count, unsigned rows_per_block, parallel_rows_func_t func, void *context) {
+
+    for (unsigned first_row = 0; first_row < row_count; first_row += rows_per_block) {
+        SAIL_TRY(func(context, first_row, SAIL_MIN(rows_per_block, row_count - first_row)));
+    }
+
+    return SAIL_OK;
+}
+
+#ifdef SAIL_THREAD_POOL
+
+/*
+ * A parallel loop. The calling thread adds the job to the queue, processes its blocks
+ * together with the workers, waits for the workers to leave the job, and removes it.
+ */
+struct parallel_job {
+    parallel_rows_func_t func;
+    void *context;
+
+    unsigned row_count;
+    unsigned rows_per_block;
+
+    /* First row of the next unclaimed block. */
+    unsigned next_row;
+
+    /* Number of workers processing blocks of the job and its limit. */
+    unsigned helpers;
+    unsigned max_helpers;
+
+    /* Status of the first failed block. */
+    sail_status_t status;
+
+    struct parallel_job *next;
+};
+
+/* Everything below is guarded by pool_lock. */
+static manip_lock_t pool_lock = MANIP_LOCK_INITIALIZER;
+
+#ifdef SAIL_WIN32
+    static CONDITION_VARIABLE work_available = CONDITION_VARIABLE_INIT;
+    static CONDITION_VARIABLE helper_finished = CONDITION_VARIABLE_INIT;
+#else
+    static pthread_cond_t work_available = PTHREAD_COND_INITIALIZER;
+    static pthread_cond_t helper_finished = PTHREAD_COND_INITIALIZER;
+#endif
+
+static struct parallel_job *pool_jobs = NULL;
+static unsigned pool_worker_count = 0;
+static unsigned global_max_threads = 0;
+
+/* Set in worker threads and in the calling thread while it processes blocks. */
+static SAIL_THREAD_LOCAL bool inside_parallel_loop = false;
+
+#ifdef SAIL_WIN32
+static void wait_pool(CONDITION_VARIABLE *condition) {
+    SleepConditionVariableSRW(condition, &pool_lock, INFINITE, 0);
+}
+
+static void wake_pool(CONDITION_VARIABLE *condition) {
+    WakeAllConditionVariable(condition);
+}
+#else
+static void wait_pool(pthread_cond_t *condition) {
+    pthread_cond_wait(condition, &pool_lock);
+}
+
+static void wake_pool(pthread_cond_t *condition) {
+    pthread_cond_broadcast(condition);
+}
+#endif
+
+static unsigned cpu_count(void) {
+
+#ifdef SAIL_WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    const long count = (long)system_info.dwNumberOfProcessors;
+#else
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return (count > 0) ? (unsigned)count : 1;
+}
+
+/* Must be called with the pool locked. Claims and processes blocks until there are no more. */
+static void process_blocks_locked(struct parallel_job *job) {
+
+    while (job->status == SAIL_OK && job->next_row < job->row_count) {
+        const unsigned first_row = job->next_row;
+        const unsigned row_count = SAIL_MIN(job->rows_per_block, job->row_count - first_row);
+
+        job->next_row += row_count;
+
+        manip_unlock(&pool_lock);
+        const sail_status_t status = job->func(job->context, first_row, row_count);
+        manip_lock(&pool_lock);
+
+        if (status != SAIL_OK && job->status == SAIL_OK) {
+            job->status = status;
+        }
+    }
+}
+
+/* Must be called with the pool locked. */
+static struct parallel_job* find_job_locked(void) {
+
+    for (struct parallel_job *job = pool_jobs; job != NULL; job = job->next) {
+        if (job->status == SAIL_OK && job->next_row < job->row_count && job->helpers < job->max_helpers) {
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+static void worker_loop(void) {
+
+    inside_parallel_loop = true;
+
+    manip_lock(&pool_lock);
+
+    for (;;) {
+        struct parallel_job *job = find_job_locked();
+
+        if (job == NULL) {
+            wait_pool(&work_available);
+            continue;
+        }
+
+        job->helpers++;
+        process_blocks_locked(job);
+        job->helpers--;
+
+        if (job->helpers == 0) {
+            wake_pool(&helper_finished);
+        }
+    }
+}
+
+#ifdef SAIL_WIN32
+static DWORD WINAPI worker_main(LPVOID arg) {
+    (void)arg;
+    worker_loop();
+    return 0;
+}
+#else
+static void* worker_main(void *arg) {
+    (void)arg;
+    worker_loop();
+    return NULL;
+}
+#endif
+
+/*
+ * Must be called with the pool locked. Workers are detached and live until the process exits.
+ * Failing to start a worker is not fatal as the calling thread always processes blocks too.
+ */
+static void start_workers_locked(unsigned worker_count) {
+
+    while (pool_worker_count < worker_count) {
+#ifdef SAIL_WIN32
+        HANDLE thread = CreateThread(NULL, 0, worker_main, NULL, 0, NULL);
+
+        if (thread == NULL) {
+            SAIL_LOG_WARNING("Failed to start a conversion worker thread. Error: 0x%X", GetLastError());
+            return;
+        }
+
+        CloseHandle(thread);
+#else
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, worker_main, NULL) != 0) {
+            SAIL_LOG_WARNING("Failed to start a conversion worker thread");
+            return;
+        }
+
+        pthread_detach(thread);
+#endif
+
+        pool_worker_count++;
+    }
+}
+
+sail_status_t parallel_for_rows(unsigned row_count, unsigned rows_per_block, unsigned max_threads,
+                                parallel_rows_func_t func, void *context) {
+
+    SAIL_CHECK_PTR(func);
+
+    rows_per_block = SAIL_MAX(rows_per_block, 1U);
+    const unsigned block_count = (row_count == 0) ? 0 : (row_count - 1) / rows_per_block + 1;
+
+    /* Nested loops run serially to avoid oversubscribing the cores. */
+    if (block_count <= 1 || inside_parallel_loop) {
+        SAIL_TRY(process_serially(row_count, rows_per_block, func, context));
+        return SAIL_OK;
+    }
+
+    manip_lock(&pool_lock);
+
+    unsigned thread_count = (global_max_threads == 0) ? cpu_count() : global_max_threads;
+
+    if (max_threads > 0) {
+        thread_count = SAIL_MIN(thread_count, max_threads);
+    }
+
+    thread_count = SAIL_MIN(SAIL_MIN(thread_count, MAX_THREADS), block_count);
+
+    if (thread_count <= 1) {
+        manip_unlock(&pool_lock);
+        SAIL_TRY(process_serially(row_count, rows_per_block, func, context));
+        return SAIL_OK;
+    }
+
+    start_workers_locked(thread_count - 1);
+
+    struct parallel_job job = {
+        func,
+        context,
+        row_count,
+        rows_per_block,
+        0,
+        0,
+        thread_count - 1,
+        SAIL_OK,
+        NULL
+    };
+
+    /* Append to keep the jobs served in order. */
+    struct parallel_job **tail = &pool_jobs;
+
+    while (*tail != NULL) {
+        tail = &(*tail)->next;
+    }
+
+    *tail = &job;
+
+    wake_pool(&work_available);
+
+    inside_parallel_loop = true;
+    process_blocks_locked(&job);
+    inside_parallel_loop = false;
+
+    while (job.helpers > 0) {
+        wait_pool(&helper_finished);
+    }
+
+    for (struct parallel_job **node = &pool_jobs; *node != NULL; node = &(*node)->next) {
+        if (*node == &job) {
+            *node = job.next;
+            break;
+        }
+    }
+
+    manip_unlock(&pool_lock);
+
+    SAIL_TRY(job.status);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+void sail_set_max_threads(unsigned max_threads) {
+
+    manip_lock(&pool_lock);
+    global_max_threads = max_threads;
+    manip_unlock(&pool_lock);
+}
+
+unsigned sail_max_threads(void) {
+
+    manip_lock(&pool_lock);
+    const unsigned max_threads = global_max_threads;
+    manip_unlock(&pool_lock);
+
+    return max_threads;
+}
+
+#else /* SAIL_THREAD_POOL */
+
+static unsigned global_max_threads = 0;
+
+sail_status_t parallel_for_rows(unsigned row_count, unsigned rows_per_block, unsigned max_threads,
+                                parallel_rows_func_t func, void *context) {
+
+    SAIL_CHECK_PTR(func);
+
+    rows_per_block = SAIL_MAX(rows_per_block, 1U);
+
+#ifdef _OPENMP
+    const unsigned block_count = (row_count == 0) ? 0 : (row_count - 1) / rows_per_block + 1;
+
+    unsigned thread_count = (global_max_threads == 0) ? (unsigned)omp_get_num_procs() : global_max_threads;
+
+    if (max_threads > 0) {
+        thread_count = SAIL_MIN(thread_count, max_threads);
+    }
+
+    thread_count = SAIL_MIN(SAIL_MIN(thread_count, MAX_THREADS), block_count);
+
+    if (thread_count > 1 && !omp_in_parallel()) {
+        sail_status_t status = SAIL_OK;
+        unsigned block;
+
+        #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) num_threads(thread_count) shared(status)
+        for (block = 0; block < block_count; block++) {
+            #pragma omp flush(status)
+            if (status == SAIL_OK) {
+                const unsigned first_row = block * rows_per_block;
+                const sail_status_t block_status = func(context, first_row, SAIL_MIN(rows_per_block, row_count - first_row));
+
+                if (block_status != SAIL_OK) {
+                    #pragma omp critical
+                    status = block_status;
+                    #pragma omp flush(status)
+                }
+            }
+        }
+
+        SAIL_TRY(status);
+
+        return SAIL_OK;
+    }
+#else
+    (void)max_threads;
+#endif
+
+    SAIL_TRY(process_serially(row_count, rows_per_block, func, context));
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+void sail_set_max_threads(unsigned max_threads) {
+
+    global_max_threads = max_threads;
+}
+
+unsigned sail_max_threads(void) {
+
+    return global_max_threads;
+}
+
+#endif /* SAIL_THREAD_POOL */
@@ -0,0 +1,59 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_THREAD_POOL_H
+#define SAIL_THREAD_POOL_H
+
+#include <sail-common/export.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Sets the global maximum number of threads, including the calling thread, used to convert
+ * a single image. Zero means the number of CPU cores, which is the default.
+ *
+ * Conversions share a single pool of worker threads, so converting many images from
+ * different threads simultaneously doesn't create more threads than this limit. Conversions
+ * started from inside another conversion run in the calling thread. Use the max_threads
+ * field of sail_conversion_options to lower the limit for a single call.
+ *
+ * Affects conversions started after the call.
+ */
+SAIL_EXPORT void sail_set_max_threads(unsigned max_threads);
+
+/*
+ * Returns the global maximum number of threads set with sail_set_max_threads().
+ * Zero means the number of CPU cores.
+ */
+SAIL_EXPORT unsigned sail_max_threads(void);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_THREAD_POOL_PRIVATE_H
+#define SAIL_THREAD_POOL_PRIVATE_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+/* Blocks of scan lines processed by a single thread have about this number of pixels. */
+#define PARALLEL_BLOCK_PIXELS 32768U
+
+/* Number of scan lines processed between cancellation checks. */
+#define CANCEL_CHECK_ROWS 64U
+
+/*
+ * Image statistics are collected in up to STATISTICS_BLOCKS blocks of scan lines in parallel and merged.
+ * Every block has its own histograms, so their number is limited to keep memory usage low.
+ */
+#define STATISTICS_BLOCKS 16U
+
+/*
+ * Processes the scan lines [first_row; first_row + row_count). Called from multiple threads
+ * simultaneously with disjoint ranges.
+ */
+typedef sail_status_t (*parallel_rows_func_t)(void *context, unsigned first_row, unsigned row_count);
+
+/*
+ * Splits row_count scan lines into blocks of rows_per_block scan lines and processes them
+ * with up to max_threads threads including the calling thread. Zero max_threads means
+ * the global limit. Runs in the calling thread when there is a single block or when called
+ * from a worker thread. Stops processing new blocks after the first failure and returns
+ * its status.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t parallel_for_rows(unsigned row_count, unsigned rows_per_block, unsigned max_threads,
+                                            parallel_rows_func_t func, void *context);
+
+#endif
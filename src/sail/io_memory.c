@@ -187,8 +187,8 @@ static sail_status_t io_memory_seek(void *stream, long offset, int whence) {
     if (new_pos >= mem_io_buffer_info->length) {
         new_pos = mem_io_buffer_info->length;
         mem_io_buffer_info->accessible_length = mem_io_buffer_info->length;
-    } else if (new_pos >= mem_io_buffer_info->accessible_length) {
-        mem_io_buffer_info->accessible_length = new_pos + 1;
+    } else if (new_pos > mem_io_buffer_info->accessible_length) {
+        mem_io_buffer_info->accessible_length = new_pos;
     }
 
     mem_io_buffer_info->pos = new_pos;
@@ -236,6 +236,39 @@ static sail_status_t io_memory_eof(void *stream, bool *result) {
     return SAIL_OK;
 }
 
+/* Accessible length is the length of data that can be read before writing. */
+static sail_status_t alloc_io_read_write_memory(void *buffer, size_t length, size_t accessible_length, struct sail_io **io) {
+
+    struct sail_io *io_local;
+    SAIL_TRY(sail_alloc_io(&io_local));
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct mem_io_write_stream), &ptr),
+                        /* cleanup */ sail_destroy_io(io_local));
+    struct mem_io_write_stream *mem_io_write_stream = ptr;
+
+    mem_io_write_stream->mem_io_buffer_info.length            = length;
+    mem_io_write_stream->mem_io_buffer_info.accessible_length = accessible_length;
+    mem_io_write_stream->mem_io_buffer_info.pos               = 0;
+    mem_io_write_stream->buffer                               = buffer;
+
+    io_local->features       = SAIL_IO_FEATURE_SEEKABLE;
+    io_local->stream         = mem_io_write_stream;
+    io_local->tolerant_read  = io_memory_tolerant_read;
+    io_local->strict_read    = io_memory_strict_read;
+    io_local->tolerant_write = io_memory_tolerant_write;
+    io_local->strict_write   = io_memory_strict_write;
+    io_local->seek           = io_memory_seek;
+    io_local->tell           = io_memory_tell;
+    io_local->flush          = io_memory_flush;
+    io_local->close          = io_memory_close;
+    io_local->eof            = io_memory_eof;
+
+    *io = io_local;
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -283,32 +316,19 @@ sail_status_t sail_alloc_io_read_write_memory(void *buffer, size_t length, struc
 
     SAIL_LOG_DEBUG("Opening memory buffer of size %lu for reading/writing", length);
 
-    struct sail_io *io_local;
-    SAIL_TRY(sail_alloc_io(&io_local));
+    SAIL_TRY(alloc_io_read_write_memory(buffer, length, length, io));
 
-    void *ptr;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct mem_io_write_stream), &ptr),
-                        /* cleanup */ sail_destroy_io(io_local));
-    struct mem_io_write_stream *mem_io_write_stream = ptr;
+    return SAIL_OK;
+}
 
-    mem_io_write_stream->mem_io_buffer_info.length            = length;
-    mem_io_write_stream->mem_io_buffer_info.accessible_length = length;
-    mem_io_write_stream->mem_io_buffer_info.pos               = 0;
-    mem_io_write_stream->buffer                               = buffer;
+sail_status_t sail_alloc_io_write_memory(void *buffer, size_t length, struct sail_io **io) {
 
-    io_local->features       = SAIL_IO_FEATURE_SEEKABLE;
-    io_local->stream         = mem_io_write_stream;
-    io_local->tolerant_read  = io_memory_tolerant_read;
-    io_local->strict_read    = io_memory_strict_read;
-    io_local->tolerant_write = io_memory_tolerant_write;
-    io_local->strict_write   = io_memory_strict_write;
-    io_local->seek           = io_memory_seek;
-    io_local->tell           = io_memory_tell;
-    io_local->flush          = io_memory_flush;
-    io_local->close          = io_memory_close;
-    io_local->eof            = io_memory_eof;
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(io);
 
-    *io = io_local;
+    SAIL_LOG_DEBUG("Opening memory buffer of size %lu for writing", length);
+
+    SAIL_TRY(alloc_io_read_write_memory(buffer, length, 0, io));
 
     return SAIL_OK;
 }
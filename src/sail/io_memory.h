@@ -51,6 +51,15 @@ SAIL_EXPORT sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t l
  */
 SAIL_EXPORT sail_status_t sail_alloc_io_read_write_memory(void *buffer, size_t length, struct sail_io **io);
 
+/*
+ * Opens the specified memory buffer for writing, and allocates a new I/O object for it.
+ * Unlike sail_alloc_io_read_write_memory(), the buffer is considered empty, so the end
+ * of the stream is the end of the written data, and only the written data can be read back.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_write_memory(void *buffer, size_t length, struct sail_io **io);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -0,0 +1,188 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+static const uint16_t EXIF_TAG_ORIENTATION = 0x0112;
+static const size_t   EXIF_IFD_ENTRY_SIZE  = 12;
+
+static uint16_t read_uint16(const unsigned char *data, bool big_endian) {
+
+    return big_endian ? (uint16_t)((data[0] << 8) | data[1])
+                      : (uint16_t)((data[1] << 8) | data[0]);
+}
+
+static uint32_t read_uint32(const unsigned char *data, bool big_endian) {
+
+    return big_endian ? ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3]
+                      : ((uint32_t)data[3] << 24) | ((uint32_t)data[2] << 16) | ((uint32_t)data[1] << 8) | data[0];
+}
+
+/* EXIF orientations are the transformations that display images upright. */
+static enum SailOrientation exif_orientation_to_sail_orientation(uint16_t value) {
+
+    switch (value) {
+        case 2: return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY;
+        case 3: return SAIL_ORIENTATION_ROTATED_180;
+        case 4: return SAIL_ORIENTATION_MIRRORED_VERTICALLY;
+        case 5: return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270;
+        case 6: return SAIL_ORIENTATION_ROTATED_90;
+        case 7: return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90;
+        case 8: return SAIL_ORIENTATION_ROTATED_270;
+
+        default: {
+            return SAIL_ORIENTATION_NORMAL;
+        }
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t fetch_exif_orientation(void *exif, size_t exif_size, bool reset, enum SailOrientation *orientation) {
+
+    SAIL_CHECK_PTR(exif);
+    SAIL_CHECK_PTR(orientation);
+
+    *orientation = SAIL_ORIENTATION_NORMAL;
+
+    unsigned char *tiff = exif;
+    size_t tiff_size = exif_size;
+
+    /* Skip the APP1 signature if any. */
+    if (tiff_size >= 6 && memcmp(tiff, "Exif\0\0", 6) == 0) {
+        tiff      += 6;
+        tiff_size -= 6;
+    }
+
+    /* TIFF header: byte order, magic number, and IFD0 offset. */
+    if (tiff_size < 8) {
+        return SAIL_OK;
+    }
+
+    bool big_endian;
+
+    if (tiff[0] == 'M' && tiff[1] == 'M') {
+        big_endian = true;
+    } else if (tiff[0] == 'I' && tiff[1] == 'I') {
+        big_endian = false;
+    } else {
+        SAIL_LOG_TRACE("EXIF: Unknown byte order");
+        return SAIL_OK;
+    }
+
+    const size_t ifd_offset = read_uint32(tiff + 4, big_endian);
+
+    if (ifd_offset < 8 || ifd_offset > tiff_size - 2) {
+        return SAIL_OK;
+    }
+
+    const unsigned entries = read_uint16(tiff + ifd_offset, big_endian);
+
+    if (ifd_offset + 2 + entries * EXIF_IFD_ENTRY_SIZE > tiff_size) {
+        return SAIL_OK;
+    }
+
+    for (unsigned i = 0; i < entries; i++) {
+        unsigned char *entry = tiff + ifd_offset + 2 + i * EXIF_IFD_ENTRY_SIZE;
+
+        if (read_uint16(entry, big_endian) != EXIF_TAG_ORIENTATION) {
+            continue;
+        }
+
+        /* SHORT values are stored in the first two bytes of the value field. */
+        *orientation = exif_orientation_to_sail_orientation(read_uint16(entry + 8, big_endian));
+
+        if (reset) {
+            entry[8] = big_endian ? 0 : 1;
+            entry[9] = big_endian ? 1 : 0;
+        }
+
+        break;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t auto_orient_image(struct sail_image *image, bool keep_meta_data) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+
+    enum SailOrientation orientation = SAIL_ORIENTATION_NORMAL;
+
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        if (node->meta_data->key == SAIL_META_DATA_EXIF && node->meta_data->value->type == SAIL_VARIANT_TYPE_DATA) {
+            SAIL_TRY(fetch_exif_orientation(sail_variant_to_data(node->meta_data->value), node->meta_data->value->size,
+                                            keep_meta_data, &orientation));
+            break;
+        }
+    }
+
+    if (!keep_meta_data) {
+        sail_destroy_meta_data_node_chain(image->meta_data_node);
+        image->meta_data_node = NULL;
+    }
+
+    if (image->source_image != NULL) {
+        image->source_image->orientation = orientation;
+    }
+
+    if (orientation == SAIL_ORIENTATION_NORMAL) {
+        return SAIL_OK;
+    }
+
+    SAIL_LOG_TRACE("Applying the %s EXIF orientation", sail_orientation_to_string(orientation));
+
+    struct sail_image *rotated_image;
+    SAIL_TRY(sail_rotate_image(image, orientation, &rotated_image));
+
+    /* Take the rotated pixels and the resolution with swapped axes. */
+    void *pixels = image->pixels;
+    struct sail_resolution *resolution = image->resolution;
+
+    image->pixels         = rotated_image->pixels;
+    image->resolution     = rotated_image->resolution;
+    image->width          = rotated_image->width;
+    image->height         = rotated_image->height;
+    image->bytes_per_line = rotated_image->bytes_per_line;
+
+    rotated_image->pixels     = pixels;
+    rotated_image->resolution = resolution;
+    sail_destroy_image(rotated_image);
+
+    return SAIL_OK;
+}
@@ -0,0 +1,57 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ORIENTATION_PRIVATE_H
+#define SAIL_ORIENTATION_PRIVATE_H
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_image;
+
+/*
+ * Reads the orientation tag from IFD0 of the specified EXIF data. The data can start
+ * with the "Exif\0\0" APP1 signature. Assigns SAIL_ORIENTATION_NORMAL if the tag is not found
+ * or the data is broken. When 'reset' is true, the tag is set to the normal orientation.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t fetch_exif_orientation(void *exif, size_t exif_size, bool reset, enum SailOrientation *orientation);
+
+/*
+ * Rotates the loaded frame in place according to the EXIF orientation from its meta data.
+ * The orientation tag is reset afterwards, so saving the frame doesn't rotate it once again.
+ * Destroys the meta data when 'keep_meta_data' is false. Assigns the EXIF orientation
+ * to the source image if any.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t auto_orient_image(struct sail_image *image, bool keep_meta_data);
+
+#endif
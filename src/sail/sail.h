@@ -42,6 +42,7 @@
 #include <sail/sail_deep_diver.h>
 #include <sail/sail_junior.h>
 #include <sail/sail_technical_diver.h>
+#include <sail/validation_stats.h>
 
 #ifdef SAIL_BUILD
     #include <sail/codec.h>
@@ -51,8 +52,12 @@
     #include <sail/codec_layout.h>
     #include <sail/context_private.h>
     #include <sail/ini.h>
+    #include <sail/orientation_private.h>
     #include <sail/sail_private.h>
     #include <sail/sail_technical_diver_private.h>
+    #include <sail/target_quality_private.h>
+    #include <sail/thumbnail_private.h>
+    #include <sail/validate_private.h>
     #ifdef SAIL_THREAD_SAFE
         #include <sail/threading.h>
     #endif
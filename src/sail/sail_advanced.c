@@ -23,11 +23,14 @@
     SOFTWARE.
 */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 
 #include <sail/sail.h>
 
+#include <sail-manip/color_transform.h>
+
 sail_status_t sail_probe_io(struct sail_io *io, struct sail_image **image, const struct sail_codec_info **codec_info) {
 
     SAIL_CHECK_PTR(io);
@@ -48,14 +51,17 @@ sail_status_t sail_probe_io(struct sail_io *io, struct sail_image **image, const
                         /* cleanup */ codec->v8->load_finish(&state),
                                       sail_destroy_load_options(load_options_local));
 
-    sail_destroy_load_options(load_options_local);
-
     struct sail_image *image_local;
 
+    /* Codecs keep the pointer to the load options until finished. */
     SAIL_TRY_OR_CLEANUP(codec->v8->load_seek_next_frame(state, &image_local),
-                        /* cleanup */ codec->v8->load_finish(&state));
+                        /* cleanup */ codec->v8->load_finish(&state),
+                                      sail_destroy_load_options(load_options_local));
     SAIL_TRY_OR_CLEANUP(codec->v8->load_finish(&state),
-                        /* ceanup */ sail_destroy_image(image_local));
+                        /* ceanup */ sail_destroy_image(image_local),
+                                      sail_destroy_load_options(load_options_local));
+
+    sail_destroy_load_options(load_options_local);
 
     *image = image_local;
 
@@ -77,6 +83,81 @@ sail_status_t sail_probe_memory(const void *buffer, size_t buffer_size, struct s
     return SAIL_OK;
 }
 
+sail_status_t sail_load_thumbnail(struct sail_io *io, unsigned max_size, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(image);
+
+    if (max_size == 0) {
+        SAIL_LOG_ERROR("Thumbnail size must be greater than zero");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    SAIL_TRY(load_thumbnail(io, NULL, max_size, image));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_thumbnail_from_file(const char *path, unsigned max_size, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(image);
+
+    if (max_size == 0) {
+        SAIL_LOG_ERROR("Thumbnail size must be greater than zero");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &io));
+
+    SAIL_TRY_OR_CLEANUP(load_thumbnail(io, codec_info, max_size, image),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_thumbnail_from_memory(const void *buffer, size_t buffer_size, unsigned max_size, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(buffer);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(buffer, buffer_size, &io));
+
+    SAIL_TRY_OR_CLEANUP(sail_load_thumbnail(io, max_size, image),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_validate_io(struct sail_io *io, struct sail_validation_stats *stats) {
+
+    SAIL_TRY(sail_validate_io_with_options(io, NULL, stats));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_validate_file(const char *path, struct sail_validation_stats *stats) {
+
+    SAIL_TRY(sail_validate_file_with_options(path, NULL, stats));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_validate_memory(const void *buffer, size_t buffer_size, struct sail_validation_stats *stats) {
+
+    SAIL_TRY(sail_validate_memory_with_options(buffer, buffer_size, NULL, stats));
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_start_loading_from_file(const char *path, const struct sail_codec_info *codec_info, void **state) {
 
     SAIL_TRY(sail_start_loading_from_file_with_options(path, codec_info, NULL, state));
@@ -111,14 +192,80 @@ sail_status_t sail_load_next_frame(void *state, struct sail_image **image) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
     }
 
+    /* Seek first so images with exactly max_frames frames still end with SAIL_ERROR_NO_MORE_FRAMES. */
+    if (state_of_mind->load_options->max_frames > 0 && state_of_mind->frames_loaded >= state_of_mind->load_options->max_frames) {
+        SAIL_LOG_ERROR("The number of frames exceeds the limit of %u", state_of_mind->load_options->max_frames);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    /* Reject huge frames before allocating pixels. */
+    SAIL_TRY_OR_CLEANUP(check_load_limits(state_of_mind->load_options, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(check_output_pixel_format(state_of_mind->load_options, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    /*
+     * Codecs with SAIL_CODEC_FEATURE_ROI return regions of interest themselves.
+     * Frames of other codecs are loaded entirely and cropped.
+     */
+    const bool crop = !(state_of_mind->codec_info->load_features->features & SAIL_CODEC_FEATURE_ROI);
+    unsigned roi_x = 0, roi_y = 0, roi_width = 0, roi_height = 0;
+
+    if (crop) {
+        SAIL_TRY_OR_CLEANUP(sail_intersect_roi(state_of_mind->load_options, image_local->width, image_local->height,
+                                                &roi_x, &roi_y, &roi_width, &roi_height),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    /* Don't allocate pixels for nothing if the deadline is already reached. */
+    SAIL_TRY_OR_CLEANUP(sail_check_cancel_token(state_of_mind->load_options->cancel_token),
+                        /* cleanup */ sail_destroy_image(image_local));
+
     /* Allocate pixels. */
-    const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
+    const size_t pixels_size = sail_pixels_size(image_local->height, image_local->bytes_per_line, image_local->pixel_format);
     SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
                         /* cleanup */ sail_destroy_image(image_local));
 
     SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_frame(state_of_mind->state, image_local),
                         /* cleanup */ sail_destroy_image(image_local));
 
+    if (crop) {
+        SAIL_TRY_OR_CLEANUP(crop_image(image_local, roi_x, roi_y, roi_width, roi_height),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    /* Transform colors before converting while pixels have full precision when possible. */
+    const bool manage_colors = state_of_mind->load_options->options & SAIL_OPTION_COLOR_MANAGEMENT;
+    const bool transform_colors_first = manage_colors && sail_can_transform_colors(image_local->pixel_format);
+
+    if (transform_colors_first) {
+        SAIL_TRY_OR_CLEANUP(transform_colors_to_srgb(image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    /* Convert after cropping to touch only the pixels the caller wants. */
+    SAIL_TRY_OR_CLEANUP(convert_to_output_pixel_format(state_of_mind->load_options, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    if (manage_colors && !transform_colors_first) {
+        SAIL_TRY_OR_CLEANUP(transform_colors_to_srgb(image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    if (state_of_mind->load_options->options & SAIL_OPTION_AUTO_ORIENT) {
+        SAIL_TRY_OR_CLEANUP(auto_orient_image(image_local, !state_of_mind->drop_meta_data),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    /* Analyze the final pixels. */
+    if (state_of_mind->load_options->options & SAIL_OPTION_STATISTICS) {
+        SAIL_TRY_OR_CLEANUP(compute_image_statistics(image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    state_of_mind->frames_loaded++;
+
     *image = image_local;
 
     return SAIL_OK;
@@ -177,6 +324,8 @@ sail_status_t sail_write_next_frame(void *state, const struct sail_image *image)
     SAIL_TRY(allowed_write_output_pixel_format(state_of_mind->codec_info->save_features,
                                                 image->pixel_format));
 
+    SAIL_TRY(sail_check_cancel_token(state_of_mind->save_options->cancel_token));
+
     SAIL_TRY(state_of_mind->codec->v8->save_seek_next_frame(state_of_mind->state, image));
     SAIL_TRY(state_of_mind->codec->v8->save_frame(state_of_mind->state, image));
 
@@ -36,6 +36,9 @@ extern "C" {
 #endif
 
 struct sail_codec_info;
+struct sail_image;
+struct sail_io;
+struct sail_validation_stats;
 
 /*
  * Loads an image from the specified I/O source and returns its properties without pixels.
@@ -64,6 +67,77 @@ SAIL_EXPORT sail_status_t sail_probe_io(struct sail_io *io, struct sail_image **
 SAIL_EXPORT sail_status_t sail_probe_memory(const void *buffer, size_t buffer_size,
                                             struct sail_image **image, const struct sail_codec_info **codec_info);
 
+/*
+ * Loads a thumbnail of the image from the specified I/O source. The longest side of the thumbnail
+ * doesn't exceed the specified size.
+ *
+ * SAIL returns the smallest embedded preview not smaller than the requested size without decoding
+ * the main image when possible. Supported previews are EXIF IFD1 JPEG thumbnails, PSD thumbnail
+ * image resources, and pages of multi-paged images like ICO sizes or TIFF subfiles. Otherwise,
+ * the first frame is decoded and downscaled, using downscaling while decoding when the codec supports it.
+ * Images smaller than the requested size are never upscaled.
+ *
+ * Thumbnails are downscaled with the nearest neighbor filter.
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_thumbnail(struct sail_io *io, unsigned max_size, struct sail_image **image);
+
+/*
+ * Loads a thumbnail of the specified image file. See sail_load_thumbnail().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_thumbnail_from_file(const char *path, unsigned max_size, struct sail_image **image);
+
+/*
+ * Loads a thumbnail of the image from the specified memory buffer. See sail_load_thumbnail().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_thumbnail_from_memory(const void *buffer, size_t buffer_size,
+                                                          unsigned max_size, struct sail_image **image);
+
+/*
+ * Decodes all the frames of the image from the specified I/O source, discards the pixels,
+ * and fills the statistics. Use it to check that an image is not broken without keeping
+ * it in memory.
+ *
+ * Codecs with SAIL_CODEC_FEATURE_VALIDATE decode every frame into a single scan line,
+ * so the memory usage is O(row). Frames of other codecs are allocated entirely and freed
+ * right after decoding. On error, the statistics describe the frames decoded successfully
+ * before the broken one.
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_validate_io(struct sail_io *io, struct sail_validation_stats *stats);
+
+/*
+ * Validates the specified image file. See sail_validate_io().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_validate_file(const char *path, struct sail_validation_stats *stats);
+
+/*
+ * Validates the image from the specified memory buffer. See sail_validate_io().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_validate_memory(const void *buffer, size_t buffer_size, struct sail_validation_stats *stats);
+
 /*
  * Starts loading the specified image file. Pass codec info if you would like to start loading
  * with a specific codec. If not, just pass NULL, and SAIL will detect it automatically.
@@ -70,6 +70,54 @@ sail_status_t sail_start_loading_from_memory_with_options(const void *buffer, si
     return SAIL_OK;
 }
 
+sail_status_t sail_validate_io_with_options(struct sail_io *io, const struct sail_load_options *load_options,
+                                            struct sail_validation_stats *stats) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(stats);
+
+    SAIL_TRY(validate_image(io, NULL, load_options, stats));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_validate_file_with_options(const char *path, const struct sail_load_options *load_options,
+                                              struct sail_validation_stats *stats) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(stats);
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &io));
+
+    SAIL_TRY_OR_CLEANUP(validate_image(io, codec_info, load_options, stats),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_validate_memory_with_options(const void *buffer, size_t buffer_size,
+                                                const struct sail_load_options *load_options,
+                                                struct sail_validation_stats *stats) {
+
+    SAIL_CHECK_PTR(buffer);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(buffer, buffer_size, &io));
+
+    SAIL_TRY_OR_CLEANUP(sail_validate_io_with_options(io, load_options, stats),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_start_saving_into_file_with_options(const char *path, const struct sail_codec_info *codec_info,
                                                        const struct sail_save_options *save_options, void **state) {
 
@@ -99,7 +147,7 @@ sail_status_t sail_start_saving_into_memory_with_options(void *buffer, size_t bu
     SAIL_CHECK_PTR(codec_info);
 
     struct sail_io *io;
-    SAIL_TRY(sail_alloc_io_read_write_memory(buffer, buffer_size, &io));
+    SAIL_TRY(sail_alloc_io_write_memory(buffer, buffer_size, &io));
 
     /* The I/O object will be destroyed in this function. */
     SAIL_TRY(start_saving_io_with_options(io, true, codec_info, save_options, state));
@@ -107,6 +155,23 @@ sail_status_t sail_start_saving_into_memory_with_options(void *buffer, size_t bu
     return SAIL_OK;
 }
 
+sail_status_t sail_save_into_memory_with_target_quality(void *buffer, size_t buffer_size,
+                                                        const struct sail_image *image,
+                                                        const struct sail_codec_info *codec_info,
+                                                        const struct sail_save_options *save_options,
+                                                        double min_ssim, size_t *written, double *compression_level) {
+
+    SAIL_CHECK_PTR(buffer);
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(codec_info);
+    SAIL_CHECK_PTR(written);
+
+    SAIL_TRY(save_with_target_quality(buffer, buffer_size, image, codec_info, save_options,
+                                      min_ssim, written, compression_level));
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_stop_saving_with_written(void *state, size_t *written) {
 
     SAIL_TRY(stop_saving(state, written));
@@ -36,9 +36,11 @@ extern "C" {
 #endif
 
 struct sail_codec_info;
+struct sail_image;
 struct sail_io;
 struct sail_load_options;
 struct sail_save_options;
+struct sail_validation_stats;
 
 /*
  * Starts loading the specified image file with the specified load options. Pass codec info if you would like
@@ -86,6 +88,34 @@ SAIL_EXPORT sail_status_t sail_start_loading_from_memory_with_options(const void
                                                                       const struct sail_codec_info *codec_info,
                                                                       const struct sail_load_options *load_options, void **state);
 
+/*
+ * Validates the image from the specified I/O source like sail_validate_io() does, and applies the resource
+ * limits and the cancellation token from the specified load options. Other load options are ignored.
+ * If you do not need specific load options, just pass NULL.
+ *
+ * Returns SAIL_OK on success. Returns SAIL_ERROR_LIMIT_EXCEEDED when a frame exceeds the limits.
+ */
+SAIL_EXPORT sail_status_t sail_validate_io_with_options(struct sail_io *io, const struct sail_load_options *load_options,
+                                                        struct sail_validation_stats *stats);
+
+/*
+ * Validates the specified image file with the specified load options. See sail_validate_io_with_options().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_validate_file_with_options(const char *path, const struct sail_load_options *load_options,
+                                                          struct sail_validation_stats *stats);
+
+/*
+ * Validates the image from the specified memory buffer with the specified load options.
+ * See sail_validate_io_with_options().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_validate_memory_with_options(const void *buffer, size_t buffer_size,
+                                                            const struct sail_load_options *load_options,
+                                                            struct sail_validation_stats *stats);
+
 /*
  * Starts saving the specified image file with the specified save options. Pass codec info if you would like
  * to start saving with a specific codec. If not, just pass NULL, and SAIL will detect it automatically.
@@ -134,9 +164,42 @@ SAIL_EXPORT sail_status_t sail_start_saving_into_memory_with_options(void *buffe
                                                                      const struct sail_save_options *save_options, void **state);
 
 
+/*
+ * Saves the specified image into the specified memory buffer with the compression level of the codec
+ * selected to meet the quality target. Useful for lossy codecs like JPEG to avoid wasting bytes
+ * on a fixed compression level that is too low for some images.
+ *
+ * The compression level range of the codec is binary searched:
+ *   - If min_ssim is greater than zero, the highest compression level is selected which output decoded back
+ *     has the structural similarity index (see sail_compute_ssim()) of at least min_ssim relative to the image.
+ *     The lowest compression level is selected if no level reaches min_ssim.
+ *   - The buffer size is the byte budget. If the output doesn't fit into the buffer, or min_ssim is zero,
+ *     the lowest compression level is selected which output fits. So the budget takes precedence over the quality.
+ *
+ * The search assumes that higher compression levels give smaller outputs of lower quality. Every search step
+ * encodes the image into a temporary memory buffer, and decodes it back if min_ssim is greater than zero.
+ * The image is converted into grayscale to compute SSIM only once. Every target takes about log2 steps
+ * of the number of compression levels, e.g. 7 steps for the 101 levels of JPEG.
+ *
+ * Save options (which may be NULL) are used for all the steps, except the compression level. If the image
+ * pixel format is not supported by the codec, an error is returned.
+ *
+ * Assigns the number of bytes written to the 'written' argument and the selected compression level
+ * to the 'compression_level' argument if it's not NULL.
+ *
+ * Returns SAIL_OK on success. Returns SAIL_ERROR_UNSUPPORTED_COMPRESSION if the codec doesn't support
+ * compression levels, and SAIL_ERROR_WRITE_IO if the output doesn't fit into the buffer with any compression level.
+ */
+SAIL_EXPORT sail_status_t sail_save_into_memory_with_target_quality(void *buffer, size_t buffer_size,
+                                                                    const struct sail_image *image,
+                                                                    const struct sail_codec_info *codec_info,
+                                                                    const struct sail_save_options *save_options,
+                                                                    double min_ssim, size_t *written, double *compression_level);
+
 /*
  * Stops saving started by sail_start_saving_into_file() and brothers. Closes the underlying I/O target.
  * Assigns the number of bytes written to the 'written' argument. Does nothing if the state is NULL.
+ * For memory buffers, it's the size of the saved data, not the buffer size.
  *
  * It is essential to always stop saving to free memory and I/O resources. Failure to do so
  * will lead to memory leaks.
@@ -25,6 +25,11 @@
 
 #include <sail/sail.h>
 
+#include <sail-manip/color_transform.h>
+#include <sail-manip/conversion_options.h>
+#include <sail-manip/convert.h>
+#include <sail-manip/statistics.h>
+
 /*
  * Private functions.
  */
@@ -159,3 +164,162 @@ sail_status_t allowed_write_output_pixel_format(const struct sail_save_features
     print_unsupported_write_pixel_format(pixel_format);
     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
 }
+
+sail_status_t crop_image(struct sail_image *image, unsigned x, unsigned y, unsigned width, unsigned height) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+
+    if (x == 0 && y == 0 && width == image->width && height == image->height) {
+        return SAIL_OK;
+    }
+
+    if (width == 0 || height == 0 || x + width > image->width || y + height > image->height) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if (sail_is_planar(image->pixel_format)) {
+        SAIL_LOG_ERROR("Cannot crop %s pixels", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const unsigned bytes_per_line = sail_bytes_per_line(width, image->pixel_format);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc((size_t)bytes_per_line * height, &ptr));
+    unsigned char *pixels = ptr;
+
+    for (unsigned row = 0; row < height; row++) {
+        sail_copy_scan_line_pixels(sail_scan_line(image, y + row), x, width, image->pixel_format,
+                                    pixels + (size_t)row * bytes_per_line);
+    }
+
+    sail_free(image->pixels);
+
+    image->pixels         = pixels;
+    image->width          = width;
+    image->height         = height;
+    image->bytes_per_line = bytes_per_line;
+
+    return SAIL_OK;
+}
+
+sail_status_t check_load_limits(const struct sail_load_options *load_options, const struct sail_image *image) {
+
+    SAIL_TRY(sail_check_dimensions_limit(load_options, image->width, image->height));
+    SAIL_TRY(sail_check_memory_limit(load_options, sail_pixels_size(image->height, image->bytes_per_line, image->pixel_format)));
+
+    if (load_options->max_meta_data_size == 0) {
+        return SAIL_OK;
+    }
+
+    uint64_t meta_data_size = (image->iccp == NULL) ? 0 : image->iccp->size;
+
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        if (node->meta_data->value != NULL) {
+            meta_data_size += node->meta_data->value->size;
+        }
+    }
+
+    if (meta_data_size > load_options->max_meta_data_size) {
+        SAIL_LOG_ERROR("Meta data size of %llu bytes exceeds the limit of %llu bytes",
+                        (unsigned long long)meta_data_size, (unsigned long long)load_options->max_meta_data_size);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t check_output_pixel_format(const struct sail_load_options *load_options, const struct sail_image *image) {
+
+    if (load_options->output_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN || image->pixel_format == load_options->output_pixel_format) {
+        return SAIL_OK;
+    }
+
+    if (!sail_can_convert(image->pixel_format, load_options->output_pixel_format)) {
+        SAIL_LOG_ERROR("Cannot load %s pixels as %s",
+                        sail_pixel_format_to_string(image->pixel_format),
+                        sail_pixel_format_to_string(load_options->output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t convert_to_output_pixel_format(const struct sail_load_options *load_options, struct sail_image *image) {
+
+    const enum SailPixelFormat output_pixel_format = load_options->output_pixel_format;
+
+    if (output_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN || image->pixel_format == output_pixel_format) {
+        return SAIL_OK;
+    }
+
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, output_pixel_format);
+    const uint64_t pixels_size = sail_pixels_size(image->height, bytes_per_line, output_pixel_format);
+
+    SAIL_TRY(sail_check_memory_limit(load_options, pixels_size));
+
+    void *pixels;
+    SAIL_TRY(sail_malloc((size_t)pixels_size, &pixels));
+
+    const struct sail_conversion_options conversion_options = {
+        .options      = 0,
+        .cancel_token = load_options->cancel_token,
+    };
+
+    SAIL_TRY_OR_CLEANUP(sail_convert_pixels(image->pixel_format, image->pixels, image->bytes_per_line,
+                                            output_pixel_format, pixels, bytes_per_line,
+                                            image->width, image->height, image->palette, &conversion_options),
+                        /* cleanup */ sail_free(pixels));
+
+    sail_free(image->pixels);
+
+    image->pixels         = pixels;
+    image->pixel_format   = output_pixel_format;
+    image->bytes_per_line = bytes_per_line;
+
+    /* The palette is useless for non-indexed pixels. */
+    sail_destroy_palette(image->palette);
+    image->palette = NULL;
+
+    return SAIL_OK;
+}
+
+sail_status_t transform_colors_to_srgb(struct sail_image *image) {
+
+    /* No profile means sRGB. */
+    if (image->iccp == NULL) {
+        return SAIL_OK;
+    }
+
+    if (!sail_can_transform_colors(image->pixel_format)) {
+        SAIL_LOG_WARNING("Cannot transform colors of %s pixels, keeping the ICC profile", sail_pixel_format_to_string(image->pixel_format));
+        return SAIL_OK;
+    }
+
+    const sail_status_t status = sail_transform_image_colors(image, NULL);
+
+    if (status == SAIL_ERROR_UNSUPPORTED_ICCP) {
+        SAIL_LOG_WARNING("Cannot transform colors with the unsupported ICC profile, keeping it");
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+sail_status_t compute_image_statistics(struct sail_image *image) {
+
+    if (!sail_can_compute_image_statistics(image->pixel_format)) {
+        SAIL_LOG_WARNING("Cannot compute statistics of %s pixels", sail_pixel_format_to_string(image->pixel_format));
+        return SAIL_OK;
+    }
+
+    struct sail_image_statistics *statistics;
+    SAIL_TRY(sail_compute_image_statistics(image, &statistics));
+
+    sail_destroy_image_statistics(image->statistics);
+    image->statistics = statistics;
+
+    return SAIL_OK;
+}
@@ -35,6 +35,7 @@
 
 struct sail_codec_info;
 struct sail_codec;
+struct sail_image;
 struct sail_save_features;
 
 struct hidden_state {
@@ -51,6 +52,12 @@ struct hidden_state {
     /* Shallow pointers to internal data structures so no need to free these. */
     const struct sail_codec_info *codec_info;
     const struct sail_codec *codec;
+
+    /* The number of frames loaded so far to enforce max_frames from the load options. */
+    unsigned frames_loaded;
+
+    /* Meta data is loaded only to find the EXIF orientation for SAIL_OPTION_AUTO_ORIENT. */
+    bool drop_meta_data;
 };
 
 SAIL_HIDDEN sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info,
@@ -62,4 +69,40 @@ SAIL_HIDDEN sail_status_t stop_saving(void *state, size_t *written);
 
 SAIL_HIDDEN sail_status_t allowed_write_output_pixel_format(const struct sail_save_features *save_features, enum SailPixelFormat pixel_format);
 
+/*
+ * Crops the image pixels in place to the specified rectangle that must lie inside the image.
+ * Used to apply regions of interest to frames of codecs without SAIL_CODEC_FEATURE_ROI.
+ */
+SAIL_HIDDEN sail_status_t crop_image(struct sail_image *image, unsigned x, unsigned y, unsigned width, unsigned height);
+
+/*
+ * Checks the frame returned by a codec against the resource limits from the load options
+ * before allocating its pixels.
+ */
+SAIL_HIDDEN sail_status_t check_load_limits(const struct sail_load_options *load_options, const struct sail_image *image);
+
+/*
+ * Checks that the frame returned by a codec can be converted into the output pixel format
+ * from the load options before allocating its pixels.
+ */
+SAIL_HIDDEN sail_status_t check_output_pixel_format(const struct sail_load_options *load_options, const struct sail_image *image);
+
+/*
+ * Converts the loaded frame into the output pixel format from the load options when the codec
+ * hasn't produced it natively. Does nothing when no output pixel format is requested.
+ */
+SAIL_HIDDEN sail_status_t convert_to_output_pixel_format(const struct sail_load_options *load_options, struct sail_image *image);
+
+/*
+ * Transforms the loaded frame from its ICC profile into sRGB for SAIL_OPTION_COLOR_MANAGEMENT.
+ * Unsupported profiles and pixel formats are not errors, such frames are left as is.
+ */
+SAIL_HIDDEN sail_status_t transform_colors_to_srgb(struct sail_image *image);
+
+/*
+ * Computes statistics of the loaded frame into image->statistics for SAIL_OPTION_STATISTICS.
+ * Unsupported pixel formats are not errors, such frames get no statistics.
+ */
+SAIL_HIDDEN sail_status_t compute_image_statistics(struct sail_image *image);
+
 #endif
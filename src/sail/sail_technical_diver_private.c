@@ -74,13 +74,15 @@ sail_status_t start_loading_io_with_options(struct sail_io *io, bool own_io,
                         /* cleanup */ if (own_io) sail_destroy_io(io));
     struct hidden_state *state_of_mind = ptr;
 
-    state_of_mind->io           = io;
-    state_of_mind->own_io       = own_io;
-    state_of_mind->load_options = NULL;
-    state_of_mind->save_options = NULL;
-    state_of_mind->state        = NULL;
-    state_of_mind->codec_info   = codec_info;
-    state_of_mind->codec        = NULL;
+    state_of_mind->io             = io;
+    state_of_mind->own_io         = own_io;
+    state_of_mind->load_options   = NULL;
+    state_of_mind->save_options   = NULL;
+    state_of_mind->state          = NULL;
+    state_of_mind->codec_info     = codec_info;
+    state_of_mind->codec          = NULL;
+    state_of_mind->frames_loaded  = 0;
+    state_of_mind->drop_meta_data = false;
 
     SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info(state_of_mind->codec_info, &state_of_mind->codec),
                         /* cleanup */ destroy_hidden_state(state_of_mind));
@@ -93,6 +95,17 @@ sail_status_t start_loading_io_with_options(struct sail_io *io, bool own_io,
                             /* cleanup */ destroy_hidden_state(state_of_mind));
     }
 
+    /* EXIF orientation is stored in meta data. */
+    if ((state_of_mind->load_options->options & SAIL_OPTION_AUTO_ORIENT) && !(state_of_mind->load_options->options & SAIL_OPTION_META_DATA)) {
+        state_of_mind->load_options->options |= SAIL_OPTION_META_DATA;
+        state_of_mind->drop_meta_data = true;
+    }
+
+    /* Color management needs the source ICC profiles. */
+    if (state_of_mind->load_options->options & SAIL_OPTION_COLOR_MANAGEMENT) {
+        state_of_mind->load_options->options |= SAIL_OPTION_ICCP;
+    }
+
     SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_init(state_of_mind->io, state_of_mind->load_options, &state_of_mind->state),
                         /* cleanup */ state_of_mind->codec->v8->load_finish(&state_of_mind->state),
                                       destroy_hidden_state(state_of_mind));
@@ -125,13 +138,15 @@ sail_status_t start_saving_io_with_options(struct sail_io *io, bool own_io,
                         /* cleanup */ if (own_io) sail_destroy_io(io));
     struct hidden_state *state_of_mind = ptr;
 
-    state_of_mind->io           = io;
-    state_of_mind->own_io       = own_io;
-    state_of_mind->load_options = NULL;
-    state_of_mind->save_options = NULL;
-    state_of_mind->state        = NULL;
-    state_of_mind->codec_info   = codec_info;
-    state_of_mind->codec        = NULL;
+    state_of_mind->io             = io;
+    state_of_mind->own_io         = own_io;
+    state_of_mind->load_options   = NULL;
+    state_of_mind->save_options   = NULL;
+    state_of_mind->state          = NULL;
+    state_of_mind->codec_info     = codec_info;
+    state_of_mind->codec          = NULL;
+    state_of_mind->frames_loaded  = 0;
+    state_of_mind->drop_meta_data = false;
 
     SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info(state_of_mind->codec_info, &state_of_mind->codec),
                         /* cleanup */ destroy_hidden_state(state_of_mind));
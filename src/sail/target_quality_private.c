@@ -0,0 +1,305 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* Extra space of the temporary buffer for headers and meta data. */
+static const size_t SCRATCH_EXTRA_SIZE = 1024 * 1024;
+
+struct quality_search {
+
+    /* Output buffer. Holds the output of stored_step. */
+    void *buffer;
+    size_t buffer_size;
+    int stored_step;
+    size_t stored_size;
+
+    /* Temporary buffer large enough for any compression level. */
+    void *scratch;
+    size_t scratch_size;
+
+    const struct sail_image *image;
+    const struct sail_codec_info *codec_info;
+    struct sail_save_options *save_options;
+
+    /* Grayscale copy of the image to compute SSIM against. */
+    const struct sail_image *reference;
+
+    double min_level;
+    double max_level;
+    double step;
+};
+
+static double step_to_level(const struct quality_search *search, int step) {
+
+    const double level = search->min_level + step * search->step;
+
+    return (level > search->max_level) ? search->max_level : level;
+}
+
+static sail_status_t encode(struct quality_search *search, int step, size_t *written) {
+
+    search->save_options->compression_level = step_to_level(search, step);
+
+    void *state = NULL;
+
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_memory_with_options(search->scratch, search->scratch_size,
+                                                                   search->codec_info, search->save_options, &state),
+                        /* cleanup */ sail_stop_saving(state));
+
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, search->image),
+                        /* cleanup */ sail_stop_saving(state));
+
+    SAIL_TRY(sail_stop_saving_with_written(state, written));
+
+    return SAIL_OK;
+}
+
+/* Copies the output of the step from the temporary buffer into the output buffer if it fits. */
+static void store(struct quality_search *search, int step, size_t written) {
+
+    if (written <= search->buffer_size) {
+        memcpy(search->buffer, search->scratch, written);
+
+        search->stored_step = step;
+        search->stored_size = written;
+    }
+}
+
+static sail_status_t measure_ssim(const struct quality_search *search, size_t written, double *ssim) {
+
+    struct sail_image *decoded;
+    SAIL_TRY(sail_load_from_memory(search->scratch, written, &decoded));
+
+    SAIL_TRY_OR_CLEANUP(sail_compute_ssim(search->reference, decoded, ssim),
+                        /* cleanup */ sail_destroy_image(decoded));
+
+    sail_destroy_image(decoded);
+
+    return SAIL_OK;
+}
+
+/*
+ * Finds the highest step in [0; last_step] which output reaches the SSIM target. Returns -1 when
+ * no step reaches it. Stores the output of the found step if it fits.
+ */
+static sail_status_t search_ssim(struct quality_search *search, int last_step, double min_ssim,
+                                 int *found_step, size_t *found_size) {
+
+    int low = 0;
+    int high = last_step;
+
+    *found_step = -1;
+
+    while (low <= high) {
+        const int middle = low + (high - low) / 2;
+
+        size_t written;
+        SAIL_TRY(encode(search, middle, &written));
+
+        double ssim;
+        SAIL_TRY(measure_ssim(search, written, &ssim));
+
+        SAIL_LOG_TRACE("Compression level %.2f: %llu bytes, SSIM %.5f", step_to_level(search, middle), (unsigned long long)written, ssim);
+
+        if (ssim >= min_ssim) {
+            *found_step = middle;
+            *found_size = written;
+            store(search, middle, written);
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Finds the lowest step in [first_step; last_step] which output fits into the output buffer.
+ * Returns -1 when no step fits. Stores the output of the found step.
+ */
+static sail_status_t search_size(struct quality_search *search, int first_step, int last_step, int *found_step) {
+
+    int low = first_step;
+    int high = last_step;
+
+    *found_step = -1;
+
+    while (low <= high) {
+        const int middle = low + (high - low) / 2;
+
+        size_t written;
+        SAIL_TRY(encode(search, middle, &written));
+
+        SAIL_LOG_TRACE("Compression level %.2f: %llu bytes", step_to_level(search, middle), (unsigned long long)written);
+
+        if (written <= search->buffer_size) {
+            *found_step = middle;
+            store(search, middle, written);
+            high = middle - 1;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t search_step(struct quality_search *search, int last_step, double min_ssim, int *step) {
+
+    int found_step = -1;
+    size_t found_size = 0;
+
+    if (min_ssim > 0) {
+        SAIL_TRY(search_ssim(search, last_step, min_ssim, &found_step, &found_size));
+
+        /* The target is unreachable, so get as close to it as possible. */
+        if (found_step < 0) {
+            SAIL_LOG_DEBUG("SSIM %.5f is unreachable, using the lowest compression level", min_ssim);
+            SAIL_TRY(encode(search, 0, &found_size));
+            store(search, 0, found_size);
+            found_step = 0;
+        }
+
+        if (found_size <= search->buffer_size) {
+            *step = found_step;
+            return SAIL_OK;
+        }
+
+        /* The byte budget takes precedence over the quality. */
+        SAIL_TRY(search_size(search, found_step + 1, last_step, &found_step));
+    } else {
+        SAIL_TRY(search_size(search, 0, last_step, &found_step));
+    }
+
+    if (found_step < 0) {
+        SAIL_LOG_ERROR("The image doesn't fit into %llu bytes with any compression level", (unsigned long long)search->buffer_size);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+    }
+
+    *step = found_step;
+
+    return SAIL_OK;
+}
+
+static sail_status_t save_with_search(struct quality_search *search, double min_ssim, size_t *written, double *compression_level) {
+
+    const int last_step = (int)((search->max_level - search->min_level) / search->step + 0.5);
+
+    int step;
+    SAIL_TRY(search_step(search, last_step, min_ssim, &step));
+
+    /* Every search stores the output of the step it finds, so this is a safety net. */
+    if (search->stored_step != step) {
+        size_t written_local;
+        SAIL_TRY(encode(search, step, &written_local));
+        store(search, step, written_local);
+    }
+
+    SAIL_LOG_DEBUG("Selected compression level %.2f: %llu bytes", step_to_level(search, step), (unsigned long long)search->stored_size);
+
+    *written = search->stored_size;
+
+    if (compression_level != NULL) {
+        *compression_level = step_to_level(search, step);
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t save_with_target_quality(void *buffer, size_t buffer_size, const struct sail_image *image,
+                                       const struct sail_codec_info *codec_info,
+                                       const struct sail_save_options *save_options,
+                                       double min_ssim, size_t *written, double *compression_level) {
+
+    const struct sail_compression_level *levels = codec_info->save_features->compression_level;
+
+    if (levels == NULL || levels->max_level <= levels->min_level) {
+        SAIL_LOG_ERROR("%s codec doesn't support compression levels", codec_info->name);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    struct quality_search search = {
+        buffer,
+        buffer_size,
+        -1,
+        0,
+        NULL,
+        (size_t)image->bytes_per_line * image->height * 2 + SCRATCH_EXTRA_SIZE,
+        image,
+        codec_info,
+        NULL,
+        NULL,
+        levels->min_level,
+        levels->max_level,
+        (levels->step > 0) ? levels->step : 1
+    };
+
+    if (save_options == NULL) {
+        SAIL_TRY(sail_alloc_save_options_from_features(codec_info->save_features, &search.save_options));
+    } else {
+        SAIL_TRY(sail_copy_save_options(save_options, &search.save_options));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(search.scratch_size, &search.scratch),
+                        /* cleanup */ sail_destroy_save_options(search.save_options));
+
+    /* The image is compared with the decoded outputs over and over, so convert it once. */
+    struct sail_image *reference = NULL;
+
+    if (min_ssim > 0 && image->pixel_format != SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE) {
+        SAIL_TRY_OR_CLEANUP(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &reference),
+                            /* cleanup */ sail_free(search.scratch),
+                                          sail_destroy_save_options(search.save_options));
+    }
+
+    search.reference = (reference == NULL) ? image : reference;
+
+    SAIL_TRY_OR_CLEANUP(save_with_search(&search, min_ssim, written, compression_level),
+                        /* cleanup */ sail_destroy_image(reference),
+                                      sail_free(search.scratch),
+                                      sail_destroy_save_options(search.save_options));
+
+    sail_destroy_image(reference);
+    sail_free(search.scratch);
+    sail_destroy_save_options(search.save_options);
+
+    return SAIL_OK;
+}
@@ -0,0 +1,602 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h> /* SEEK_SET */
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* EXIF tags of the JPEG thumbnail in IFD1. */
+static const uint16_t EXIF_TAG_JPEG_INTERCHANGE_FORMAT        = 0x0201;
+static const uint16_t EXIF_TAG_JPEG_INTERCHANGE_FORMAT_LENGTH = 0x0202;
+static const uint16_t EXIF_TYPE_SHORT                         = 3;
+static const size_t   EXIF_IFD_ENTRY_SIZE                     = 12;
+
+/* PSD image resources with JPEG thumbnails. The obsolete one stores BGR pixels. */
+static const uint16_t PSD_RESOURCE_THUMBNAIL     = 1036;
+static const uint16_t PSD_RESOURCE_THUMBNAIL_BGR = 1033;
+static const uint32_t PSD_THUMBNAIL_FORMAT_JPEG  = 1;
+static const size_t   PSD_THUMBNAIL_HEADER_SIZE  = 28;
+static const size_t   PSD_FILE_HEADER_SIZE       = 26;
+
+/* Supported scale denominators of the JPEG codec, the largest one goes first. */
+static const unsigned JPEG_SCALE_DENOMS[] = { 8, 4, 2 };
+
+static uint16_t read_uint16(const unsigned char *data, bool big_endian) {
+
+    return big_endian ? (uint16_t)((data[0] << 8) | data[1])
+                      : (uint16_t)((data[1] << 8) | data[0]);
+}
+
+static uint32_t read_uint32(const unsigned char *data, bool big_endian) {
+
+    return big_endian ? ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3]
+                      : ((uint32_t)data[3] << 24) | ((uint32_t)data[2] << 16) | ((uint32_t)data[1] << 8) | data[0];
+}
+
+/* Returns true if the image is not smaller than the requested thumbnail size. */
+static bool fits_thumbnail_size(unsigned width, unsigned height, unsigned max_size) {
+
+    return SAIL_MAX(width, height) >= max_size;
+}
+
+static uint64_t area(unsigned width, unsigned height) {
+
+    return (uint64_t)width * height;
+}
+
+static sail_status_t rewind_io(struct sail_io *io, size_t offset) {
+
+    SAIL_TRY(io->seek(io->stream, (long)offset, SEEK_SET));
+
+    return SAIL_OK;
+}
+
+/* Skips the frame without loading it. Valid for multi-paged codecs only. */
+static sail_status_t skip_frame(void *state) {
+
+    struct hidden_state *state_of_mind = state;
+
+    struct sail_image *image;
+    SAIL_TRY(state_of_mind->codec->v8->load_seek_next_frame(state_of_mind->state, &image));
+
+    sail_destroy_image(image);
+
+    return SAIL_OK;
+}
+
+static sail_status_t probe_first_frame(struct sail_io *io, size_t offset,
+                                       const struct sail_codec_info *codec_info, struct sail_image **image) {
+
+    SAIL_TRY(rewind_io(io, offset));
+
+    void *state;
+    SAIL_TRY(sail_start_loading_from_io_with_options(io, codec_info, NULL, &state));
+
+    struct hidden_state *state_of_mind = state;
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_seek_next_frame(state_of_mind->state, image),
+                        /* cleanup */ sail_stop_loading(state));
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(*image));
+
+    return SAIL_OK;
+}
+
+/* Finds the smallest page fitting the requested size. Leaves 'index' untouched if nothing better is found. */
+static sail_status_t find_smallest_page(struct sail_io *io, size_t offset,
+                                        const struct sail_codec_info *codec_info, unsigned max_size,
+                                        uint64_t *best_area, unsigned *index) {
+
+    SAIL_TRY(rewind_io(io, offset));
+
+    /* Don't waste time on meta data and ICC profiles. */
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options(&load_options));
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_io_with_options(io, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    struct hidden_state *state_of_mind = state;
+
+    for (unsigned page = 0; ; page++) {
+        struct sail_image *image;
+
+        /* Treat broken pages as the end of the list. */
+        if (state_of_mind->codec->v8->load_seek_next_frame(state_of_mind->state, &image) != SAIL_OK) {
+            break;
+        }
+
+        if (fits_thumbnail_size(image->width, image->height, max_size) && area(image->width, image->height) < *best_area) {
+            *best_area = area(image->width, image->height);
+            *index = page;
+        }
+
+        sail_destroy_image(image);
+    }
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_page(struct sail_io *io, size_t offset,
+                               const struct sail_codec_info *codec_info, const struct sail_load_options *load_options,
+                               unsigned index, struct sail_image **image) {
+
+    SAIL_TRY(rewind_io(io, offset));
+
+    void *state;
+    SAIL_TRY(sail_start_loading_from_io_with_options(io, codec_info, load_options, &state));
+
+    for (unsigned page = 0; page < index; page++) {
+        SAIL_TRY_OR_CLEANUP(skip_frame(state),
+                            /* cleanup */ sail_stop_loading(state));
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, &image_local),
+                        /* cleanup */ sail_stop_loading(state));
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Decodes the first frame. Asks the codec to downscale while decoding when possible. */
+static sail_status_t load_main_image(struct sail_io *io, size_t offset,
+                                     const struct sail_codec_info *codec_info, const struct sail_image *main_image,
+                                     unsigned max_size, struct sail_image **image) {
+
+    unsigned scale_denom = 1;
+
+    if (strcmp(codec_info->name, "JPEG") == 0) {
+        for (size_t i = 0; i < sizeof(JPEG_SCALE_DENOMS) / sizeof(JPEG_SCALE_DENOMS[0]); i++) {
+            const unsigned denom = JPEG_SCALE_DENOMS[i];
+
+            if (fits_thumbnail_size((main_image->width + denom - 1) / denom, (main_image->height + denom - 1) / denom, max_size)) {
+                scale_denom = denom;
+                break;
+            }
+        }
+    }
+
+    if (scale_denom == 1) {
+        SAIL_TRY(load_page(io, offset, codec_info, NULL, 0, image));
+        return SAIL_OK;
+    }
+
+    SAIL_LOG_TRACE("Downscaling %s by 1/%u while decoding", codec_info->name, scale_denom);
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    struct sail_variant *value;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_variant(&value),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+    SAIL_TRY_OR_CLEANUP(sail_set_variant_unsigned_int(value, scale_denom),
+                        /* cleanup */ sail_destroy_variant(value),
+                                      sail_destroy_load_options(load_options));
+    SAIL_TRY_OR_CLEANUP(sail_alloc_hash_map(&load_options->tuning),
+                        /* cleanup */ sail_destroy_variant(value),
+                                      sail_destroy_load_options(load_options));
+    SAIL_TRY_OR_CLEANUP(sail_put_hash_map(load_options->tuning, "jpeg-scale-denom", value),
+                        /* cleanup */ sail_destroy_variant(value),
+                                      sail_destroy_load_options(load_options));
+
+    sail_destroy_variant(value);
+
+    SAIL_TRY_OR_CLEANUP(load_page(io, offset, codec_info, load_options, 0, image),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t fetch_exif_thumbnail(const void *exif, size_t exif_size, const void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(exif);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    *data      = NULL;
+    *data_size = 0;
+
+    const unsigned char *tiff = exif;
+    size_t tiff_size = exif_size;
+
+    /* Skip the APP1 signature if any. */
+    if (tiff_size >= 6 && memcmp(tiff, "Exif\0\0", 6) == 0) {
+        tiff      += 6;
+        tiff_size -= 6;
+    }
+
+    /* TIFF header: byte order, magic number, and IFD0 offset. */
+    if (tiff_size < 8) {
+        return SAIL_OK;
+    }
+
+    bool big_endian;
+
+    if (tiff[0] == 'M' && tiff[1] == 'M') {
+        big_endian = true;
+    } else if (tiff[0] == 'I' && tiff[1] == 'I') {
+        big_endian = false;
+    } else {
+        SAIL_LOG_TRACE("EXIF: Unknown byte order");
+        return SAIL_OK;
+    }
+
+    /* Skip IFD0 to get the IFD1 offset. */
+    size_t ifd_offset = read_uint32(tiff + 4, big_endian);
+
+    if (ifd_offset < 8 || ifd_offset > tiff_size - 2) {
+        return SAIL_OK;
+    }
+
+    size_t next_ifd_offset = ifd_offset + 2 + read_uint16(tiff + ifd_offset, big_endian) * EXIF_IFD_ENTRY_SIZE;
+
+    if (next_ifd_offset > tiff_size - 4) {
+        return SAIL_OK;
+    }
+
+    ifd_offset = read_uint32(tiff + next_ifd_offset, big_endian);
+
+    /* No IFD1. */
+    if (ifd_offset < 8 || ifd_offset > tiff_size - 2) {
+        return SAIL_OK;
+    }
+
+    const unsigned entries = read_uint16(tiff + ifd_offset, big_endian);
+
+    if (ifd_offset + 2 + entries * EXIF_IFD_ENTRY_SIZE > tiff_size) {
+        return SAIL_OK;
+    }
+
+    size_t jpeg_offset = 0;
+    size_t jpeg_size = 0;
+
+    for (unsigned i = 0; i < entries; i++) {
+        const unsigned char *entry = tiff + ifd_offset + 2 + i * EXIF_IFD_ENTRY_SIZE;
+
+        const uint16_t tag   = read_uint16(entry, big_endian);
+        const uint16_t type  = read_uint16(entry + 2, big_endian);
+        const uint32_t value = (type == EXIF_TYPE_SHORT) ? read_uint16(entry + 8, big_endian) : read_uint32(entry + 8, big_endian);
+
+        if (tag == EXIF_TAG_JPEG_INTERCHANGE_FORMAT) {
+            jpeg_offset = value;
+        } else if (tag == EXIF_TAG_JPEG_INTERCHANGE_FORMAT_LENGTH) {
+            jpeg_size = value;
+        }
+    }
+
+    if (jpeg_offset == 0 || jpeg_size == 0 || jpeg_offset > tiff_size || jpeg_size > tiff_size - jpeg_offset) {
+        return SAIL_OK;
+    }
+
+    *data      = tiff + jpeg_offset;
+    *data_size = jpeg_size;
+
+    return SAIL_OK;
+}
+
+sail_status_t fetch_psd_thumbnail(struct sail_io *io, void **data, size_t *data_size, bool *bgr) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+    SAIL_CHECK_PTR(bgr);
+
+    *data = NULL;
+
+    unsigned char buffer[PSD_THUMBNAIL_HEADER_SIZE];
+
+    /* Skip the file header and the color mode data. */
+    SAIL_TRY(io->strict_read(io->stream, buffer, PSD_FILE_HEADER_SIZE));
+
+    if (memcmp(buffer, "8BPS", 4) != 0) {
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(io->strict_read(io->stream, buffer, 4));
+    SAIL_TRY(io->seek(io->stream, (long)read_uint32(buffer, true), SEEK_CUR));
+
+    /* Walk through the image resources. */
+    SAIL_TRY(io->strict_read(io->stream, buffer, 4));
+    uint64_t resources_size = read_uint32(buffer, true);
+
+    while (resources_size > 0) {
+        /* Signature, ID, and the Pascal name length. */
+        SAIL_TRY(io->strict_read(io->stream, buffer, 7));
+
+        if (memcmp(buffer, "8BIM", 4) != 0) {
+            SAIL_LOG_TRACE("PSD: Invalid image resource signature");
+            break;
+        }
+
+        const uint16_t id = read_uint16(buffer + 4, true);
+
+        /* The name including its length byte is padded to an even size. */
+        const unsigned name_size = ((unsigned)buffer[6] + 2) & ~1U;
+        SAIL_TRY(io->seek(io->stream, (long)name_size - 1, SEEK_CUR));
+
+        SAIL_TRY(io->strict_read(io->stream, buffer, 4));
+        const uint32_t resource_size = read_uint32(buffer, true);
+        const uint64_t padded_resource_size = ((uint64_t)resource_size + 1) & ~UINT64_C(1);
+
+        const uint64_t block_size = 6 + name_size + 4 + padded_resource_size;
+
+        if (block_size > resources_size) {
+            break;
+        }
+
+        resources_size -= block_size;
+
+        if ((id == PSD_RESOURCE_THUMBNAIL || id == PSD_RESOURCE_THUMBNAIL_BGR) && resource_size > PSD_THUMBNAIL_HEADER_SIZE) {
+            SAIL_TRY(io->strict_read(io->stream, buffer, PSD_THUMBNAIL_HEADER_SIZE));
+
+            if (read_uint32(buffer, true) == PSD_THUMBNAIL_FORMAT_JPEG) {
+                const size_t jpeg_size = resource_size - PSD_THUMBNAIL_HEADER_SIZE;
+
+                void *ptr;
+                SAIL_TRY(sail_malloc(jpeg_size, &ptr));
+                SAIL_TRY_OR_CLEANUP(io->strict_read(io->stream, ptr, jpeg_size),
+                                    /* cleanup */ sail_free(ptr));
+
+                *data      = ptr;
+                *data_size = jpeg_size;
+                *bgr       = (id == PSD_RESOURCE_THUMBNAIL_BGR);
+
+                return SAIL_OK;
+            }
+
+            SAIL_TRY(io->seek(io->stream, (long)(padded_resource_size - PSD_THUMBNAIL_HEADER_SIZE), SEEK_CUR));
+        } else {
+            SAIL_TRY(io->seek(io->stream, (long)padded_resource_size, SEEK_CUR));
+        }
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t downscale_image(struct sail_image *image, unsigned max_size) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+
+    const unsigned longest = SAIL_MAX(image->width, image->height);
+
+    if (longest <= max_size) {
+        return SAIL_OK;
+    }
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+
+    if (bits_per_pixel == 0 || sail_is_planar(image->pixel_format)) {
+        SAIL_LOG_ERROR("Cannot downscale %s pixels", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const unsigned width          = SAIL_MAX(1, (unsigned)((uint64_t)image->width  * max_size / longest));
+    const unsigned height         = SAIL_MAX(1, (unsigned)((uint64_t)image->height * max_size / longest));
+    const unsigned bytes_per_line = sail_bytes_per_line(width, image->pixel_format);
+
+    /* Average the covered pixels when possible, it gives far smoother thumbnails. */
+    if (sail_can_scale(image->pixel_format)) {
+        struct sail_image *scaled_image;
+        SAIL_TRY(sail_scale_image(image, width, height, SAIL_SCALING_BOX, &scaled_image));
+
+        sail_free(image->pixels);
+
+        image->pixels         = scaled_image->pixels;
+        image->width          = scaled_image->width;
+        image->height         = scaled_image->height;
+        image->bytes_per_line = scaled_image->bytes_per_line;
+
+        scaled_image->pixels = NULL;
+        sail_destroy_image(scaled_image);
+
+        return SAIL_OK;
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc((size_t)bytes_per_line * height, &ptr));
+    unsigned char *pixels = ptr;
+
+    for (unsigned row = 0; row < height; row++) {
+        /* Sample from the centers of the destination pixels. */
+        const unsigned src_row = (unsigned)(((uint64_t)row * 2 + 1) * image->height / (height * 2));
+        const unsigned char *src_scan = sail_scan_line(image, src_row);
+        unsigned char *dst_scan = pixels + (size_t)row * bytes_per_line;
+
+        if (bits_per_pixel % 8 == 0) {
+            const unsigned bytes_per_pixel = bits_per_pixel / 8;
+
+            for (unsigned column = 0; column < width; column++) {
+                const unsigned src_column = (unsigned)(((uint64_t)column * 2 + 1) * image->width / (width * 2));
+
+                memcpy(dst_scan + (size_t)column * bytes_per_pixel, src_scan + (size_t)src_column * bytes_per_pixel, bytes_per_pixel);
+            }
+        } else {
+            /* 1-bit, 2-bit, and 4-bit pixels are packed starting from the most significant bit. */
+            const unsigned mask = (1U << bits_per_pixel) - 1;
+
+            memset(dst_scan, 0, bytes_per_line);
+
+            for (unsigned column = 0; column < width; column++) {
+                const unsigned src_column = (unsigned)(((uint64_t)column * 2 + 1) * image->width / (width * 2));
+
+                const size_t src_bit = (size_t)src_column * bits_per_pixel;
+                const size_t dst_bit = (size_t)column * bits_per_pixel;
+
+                const unsigned value = (src_scan[src_bit / 8] >> (8 - bits_per_pixel - src_bit % 8)) & mask;
+                dst_scan[dst_bit / 8] |= (unsigned char)(value << (8 - bits_per_pixel - dst_bit % 8));
+            }
+        }
+    }
+
+    sail_free(image->pixels);
+
+    image->pixels         = pixels;
+    image->width          = width;
+    image->height         = height;
+    image->bytes_per_line = bytes_per_line;
+
+    return SAIL_OK;
+}
+
+sail_status_t load_thumbnail(struct sail_io *io, const struct sail_codec_info *codec_info, unsigned max_size, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(image);
+
+    size_t offset;
+    SAIL_TRY(io->tell(io->stream, &offset));
+
+    if (codec_info == NULL) {
+        SAIL_TRY(sail_codec_info_by_magic_number_from_io(io, &codec_info));
+    }
+
+    /* Image properties and meta data of the main image. */
+    struct sail_image *main_image;
+    SAIL_TRY(probe_first_frame(io, offset, codec_info, &main_image));
+
+    uint64_t best_area = area(main_image->width, main_image->height);
+    struct sail_image *image_local = NULL;
+
+    /* Images smaller than the requested size are loaded as is. */
+    if (!fits_thumbnail_size(main_image->width, main_image->height, max_size)) {
+        SAIL_TRY_OR_CLEANUP(load_page(io, offset, codec_info, NULL, 0, &image_local),
+                            /* cleanup */ sail_destroy_image(main_image));
+
+        sail_destroy_image(main_image);
+        *image = image_local;
+
+        return SAIL_OK;
+    }
+
+    /* Embedded JPEG previews: EXIF IFD1 or PSD image resources. */
+    const void *embedded_data = NULL;
+    size_t embedded_data_size = 0;
+    void *psd_data = NULL;
+    bool bgr = false;
+
+    for (const struct sail_meta_data_node *node = main_image->meta_data_node; node != NULL; node = node->next) {
+        if (node->meta_data->key == SAIL_META_DATA_EXIF && node->meta_data->value->type == SAIL_VARIANT_TYPE_DATA) {
+            SAIL_TRY_OR_CLEANUP(fetch_exif_thumbnail(sail_variant_to_data(node->meta_data->value), node->meta_data->value->size,
+                                                     &embedded_data, &embedded_data_size),
+                                /* cleanup */ sail_destroy_image(main_image));
+            break;
+        }
+    }
+
+    if (embedded_data == NULL && strcmp(codec_info->name, "PSD") == 0) {
+        size_t psd_data_size = 0;
+
+        SAIL_TRY_OR_CLEANUP(rewind_io(io, offset),
+                            /* cleanup */ sail_destroy_image(main_image));
+        SAIL_TRY_OR_EXECUTE(fetch_psd_thumbnail(io, &psd_data, &psd_data_size, &bgr),
+                            /* on error */ SAIL_LOG_TRACE("PSD: Failed to read the thumbnail resource"));
+
+        embedded_data      = psd_data;
+        embedded_data_size = psd_data_size;
+    }
+
+    if (embedded_data != NULL) {
+        struct sail_image *embedded_image;
+
+        if (sail_probe_memory(embedded_data, embedded_data_size, &embedded_image, NULL) == SAIL_OK) {
+            if (fits_thumbnail_size(embedded_image->width, embedded_image->height, max_size) &&
+                    area(embedded_image->width, embedded_image->height) < best_area) {
+                SAIL_TRY_OR_EXECUTE(sail_load_from_memory(embedded_data, embedded_data_size, &image_local),
+                                    /* on error */ SAIL_LOG_TRACE("Failed to load the embedded thumbnail, falling back to decoding"));
+
+                if (image_local != NULL) {
+                    best_area = area(image_local->width, image_local->height);
+                }
+            }
+
+            sail_destroy_image(embedded_image);
+        }
+
+        /* The obsolete PSD thumbnail is decoded as RGB, but it's actually BGR. */
+        if (image_local != NULL && bgr && image_local->pixel_format == SAIL_PIXEL_FORMAT_BPP24_RGB) {
+            image_local->pixel_format = SAIL_PIXEL_FORMAT_BPP24_BGR;
+        }
+    }
+
+    sail_free(psd_data);
+
+    /* Reduced-resolution pages of multi-paged images like ICO sizes or TIFF subfiles. */
+    if (codec_info->load_features->features & SAIL_CODEC_FEATURE_MULTI_PAGED) {
+        unsigned index = 0;
+        const uint64_t embedded_area = best_area;
+
+        SAIL_TRY_OR_CLEANUP(find_smallest_page(io, offset, codec_info, max_size, &best_area, &index),
+                            /* cleanup */ sail_destroy_image(image_local),
+                                          sail_destroy_image(main_image));
+
+        if (best_area < embedded_area) {
+            sail_destroy_image(image_local);
+            image_local = NULL;
+
+            SAIL_TRY_OR_CLEANUP(load_page(io, offset, codec_info, NULL, index, &image_local),
+                                /* cleanup */ sail_destroy_image(main_image));
+        }
+    }
+
+    /* No suitable previews. Decode the main image. */
+    if (image_local == NULL) {
+        SAIL_TRY_OR_CLEANUP(load_main_image(io, offset, codec_info, main_image, max_size, &image_local),
+                            /* cleanup */ sail_destroy_image(main_image));
+    }
+
+    sail_destroy_image(main_image);
+
+    SAIL_TRY_OR_CLEANUP(downscale_image(image_local, max_size),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,76 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_THUMBNAIL_PRIVATE_H
+#define SAIL_THUMBNAIL_PRIVATE_H
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_codec_info;
+struct sail_image;
+struct sail_io;
+
+/*
+ * Finds a JPEG thumbnail referenced by IFD1 of the specified EXIF data. The data can start
+ * with the "Exif\0\0" APP1 signature. Assigns a shallow pointer into the EXIF data to the 'data'
+ * argument, or NULL if no thumbnail is found.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t fetch_exif_thumbnail(const void *exif, size_t exif_size, const void **data, size_t *data_size);
+
+/*
+ * Reads the JPEG thumbnail image resource of the PSD file starting at the current I/O position.
+ * Assigns NULL to the 'data' argument if no thumbnail is found. Sets 'bgr' to true when
+ * the thumbnail is stored in the obsolete BGR resource.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t fetch_psd_thumbnail(struct sail_io *io, void **data, size_t *data_size, bool *bgr);
+
+/*
+ * Downscales the image in place so that its longest side doesn't exceed the specified size.
+ * Uses the box filter for pixel formats supported by sail_scale_image(), and the nearest
+ * neighbor filter for the rest. Does nothing if the image already fits.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t downscale_image(struct sail_image *image, unsigned max_size);
+
+/*
+ * Loads the smallest embedded preview of the image in the I/O source which longest side is not less
+ * than the specified size. Falls back to decoding the first frame. See sail_load_thumbnail().
+ * Detects the codec by magic number if the codec info is NULL.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t load_thumbnail(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                         unsigned max_size, struct sail_image **image);
+
+#endif
@@ -0,0 +1,151 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <sail/sail.h>
+
+/*
+ * Private functions.
+ */
+
+static sail_status_t validate_next_frame(void *state, bool scan_line_only, struct sail_validation_stats *stats) {
+
+    struct hidden_state *state_of_mind = state;
+
+    struct sail_image *image;
+    SAIL_TRY(state_of_mind->codec->v8->load_seek_next_frame(state_of_mind->state, &image));
+
+    if (image->pixels != NULL) {
+        SAIL_LOG_ERROR("Internal error in %s codec: codecs must not allocate pixels", state_of_mind->codec_info->name);
+        sail_destroy_image(image);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    const struct sail_load_options *load_options = state_of_mind->load_options;
+
+    /* Seek first so images with exactly max_frames frames still end with SAIL_ERROR_NO_MORE_FRAMES. */
+    if (load_options->max_frames > 0 && stats->frames >= load_options->max_frames) {
+        SAIL_LOG_ERROR("The number of frames exceeds the limit of %u", load_options->max_frames);
+        sail_destroy_image(image);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    /* Codecs with SAIL_CODEC_FEATURE_VALIDATE decode all the rows into the very first scan line. */
+    const size_t buffer_size = scan_line_only ? image->bytes_per_line : sail_pixels_size(image->height, image->bytes_per_line, image->pixel_format);
+
+    /* Reject huge frames before allocating pixels. */
+    SAIL_TRY_OR_CLEANUP(sail_check_dimensions_limit(load_options, image->width, image->height),
+                        /* cleanup */ sail_destroy_image(image));
+    SAIL_TRY_OR_CLEANUP(sail_check_memory_limit(load_options, buffer_size),
+                        /* cleanup */ sail_destroy_image(image));
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(buffer_size, &image->pixels),
+                        /* cleanup */ sail_destroy_image(image));
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_frame(state_of_mind->state, image),
+                        /* cleanup */ sail_destroy_image(image));
+
+    if (stats->frames == 0) {
+        stats->pixel_format = image->pixel_format;
+    }
+
+    stats->frames++;
+    stats->width       = SAIL_MAX(stats->width, image->width);
+    stats->height      = SAIL_MAX(stats->height, image->height);
+    stats->pixels     += (uint64_t)image->width * image->height;
+    stats->buffer_size = SAIL_MAX(stats->buffer_size, buffer_size);
+
+    sail_destroy_image(image);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t validate_image(struct sail_io *io, const struct sail_codec_info *codec_info,
+                             const struct sail_load_options *load_options, struct sail_validation_stats *stats) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(stats);
+
+    *stats = (struct sail_validation_stats) {
+        .pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN,
+    };
+
+    if (codec_info == NULL) {
+        SAIL_TRY(sail_codec_info_by_magic_number_from_io(io, &codec_info));
+    }
+
+    const bool scan_line_only = codec_info->load_features->features & SAIL_CODEC_FEATURE_VALIDATE;
+
+    struct sail_load_options *validate_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &validate_options));
+
+    if (scan_line_only) {
+        validate_options->options |= SAIL_OPTION_VALIDATE;
+    }
+
+    if (load_options != NULL) {
+        validate_options->cancel_token       = load_options->cancel_token;
+        validate_options->max_width          = load_options->max_width;
+        validate_options->max_height         = load_options->max_height;
+        validate_options->max_pixels         = load_options->max_pixels;
+        validate_options->max_memory         = load_options->max_memory;
+        validate_options->max_frames         = load_options->max_frames;
+        validate_options->max_meta_data_size = load_options->max_meta_data_size;
+    }
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_io_with_options(io, codec_info, validate_options, &state),
+                        /* cleanup */ sail_destroy_load_options(validate_options));
+
+    sail_destroy_load_options(validate_options);
+
+    sail_status_t status;
+
+    while ((status = validate_next_frame(state, scan_line_only, stats)) == SAIL_OK) {
+    }
+
+    if (status != SAIL_ERROR_NO_MORE_FRAMES) {
+        sail_stop_loading(state);
+        return status;
+    }
+
+    /* Images without frames are broken. */
+    if (stats->frames == 0) {
+        sail_stop_loading(state);
+        SAIL_LOG_ERROR("The image has no frames");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
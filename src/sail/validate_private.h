@@ -0,0 +1,47 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_VALIDATE_PRIVATE_H
+#define SAIL_VALIDATE_PRIVATE_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_codec_info;
+struct sail_io;
+struct sail_load_options;
+struct sail_validation_stats;
+
+/*
+ * Decodes all the frames of the image in the I/O source and discards the pixels.
+ * See sail_validate_io_with_options(). Detects the codec by magic number if the codec info is NULL.
+ * Applies the resource limits and the cancellation token from the load options if they're not NULL.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t validate_image(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                         const struct sail_load_options *load_options, struct sail_validation_stats *stats);
+
+#endif
@@ -0,0 +1,71 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_VALIDATION_STATS_H
+#define SAIL_VALIDATION_STATS_H
+
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+
+#include <sail-common/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A structure representing statistics gathered by sail_validate_io() and friends.
+ */
+struct sail_validation_stats {
+
+    /* Number of successfully decoded frames. */
+    unsigned frames;
+
+    /* Maximum width and height among the decoded frames. */
+    unsigned width;
+    unsigned height;
+
+    /* Pixel format of the first decoded frame. */
+    enum SailPixelFormat pixel_format;
+
+    /* Total number of decoded pixels in all the frames. */
+    uint64_t pixels;
+
+    /*
+     * Size of the largest pixel buffer allocated during validation. Equals to the length
+     * of the longest scan line for codecs with SAIL_CODEC_FEATURE_VALIDATE, and to the size
+     * of the largest frame for other codecs.
+     */
+    size_t buffer_size;
+};
+
+typedef struct sail_validation_stats sail_validation_stats_t;
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
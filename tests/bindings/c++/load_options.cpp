@@ -53,6 +53,12 @@ static MunitResult test_load_options_construct(const MunitParameter params[], vo
 
         munit_assert(load_options.options() == SAIL_OPTION_META_DATA);
         munit_assert(load_options.tuning().empty());
+        munit_assert(load_options.roi_width() == 0);
+        munit_assert(load_options.roi_height() == 0);
+        munit_assert(load_options.max_width() == 0);
+        munit_assert(load_options.max_memory() == 0);
+        munit_assert(load_options.max_frames() == 0);
+        munit_assert(load_options.output_pixel_format() == SAIL_PIXEL_FORMAT_UNKNOWN);
     }
 
     return MUNIT_OK;
@@ -80,10 +86,28 @@ static MunitResult test_load_options_copy(const MunitParameter params[], void *u
         munit_assert(first_codec.load_features().to_options(&load_options) == SAIL_OK);
         load_options.tuning()["key"] = 10.0;
         munit_assert_double(load_options.tuning()["key"].value<double>(), ==, 10.0);
+        load_options.set_roi(1, 2, 3, 4);
+        load_options.set_max_dimensions(5, 6);
+        load_options.set_max_pixels(7);
+        load_options.set_max_memory(8);
+        load_options.set_max_frames(9);
+        load_options.set_max_meta_data_size(10);
+        load_options.set_output_pixel_format(SAIL_PIXEL_FORMAT_BPP32_BGRA);
 
         const sail::load_options load_options2 = load_options;
         munit_assert(load_options.options() == load_options2.options());
         munit_assert(load_options.tuning()  == load_options2.tuning());
+        munit_assert(load_options2.roi_x()      == 1);
+        munit_assert(load_options2.roi_y()      == 2);
+        munit_assert(load_options2.roi_width()  == 3);
+        munit_assert(load_options2.roi_height() == 4);
+        munit_assert(load_options2.max_width()  == 5);
+        munit_assert(load_options2.max_height() == 6);
+        munit_assert(load_options2.max_pixels() == 7);
+        munit_assert(load_options2.max_memory() == 8);
+        munit_assert(load_options2.max_frames() == 9);
+        munit_assert(load_options2.max_meta_data_size() == 10);
+        munit_assert(load_options2.output_pixel_format() == SAIL_PIXEL_FORMAT_BPP32_BGRA);
     }
 
     return MUNIT_OK;
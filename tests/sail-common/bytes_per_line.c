@@ -163,6 +163,16 @@ static MunitResult test_rgba(const MunitParameter params[], void *user_data) {
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP64_RGBA) == 80);
     munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP64_RGBA) == 88);
 
+    /* Premultiplied RGBA. */
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED) == 44);
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED) == 88);
+
+    /* Floating point RGB(A). */
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP48_RGB_HALF) == 66);
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF) == 88);
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT) == 132);
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT) == 176);
+
     return MUNIT_OK;
 }
 
@@ -230,6 +240,49 @@ static MunitResult test_cie_lab(const MunitParameter params[], void *user_data)
     return MUNIT_OK;
 }
 
+static MunitResult test_planar(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Y plane. */
+    munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP12_YUV420P) == 10);
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP12_YUV420P) == 11);
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP12_NV12) == 11);
+    munit_assert(sail_bytes_per_line(11, SAIL_PIXEL_FORMAT_BPP24_YUV444P) == 11);
+
+    /* All the planes. */
+    munit_assert(sail_pixels_size(4, 10, SAIL_PIXEL_FORMAT_BPP12_YUV420P) == 40 + 2 * 5 * 2);
+    munit_assert(sail_pixels_size(5, 11, SAIL_PIXEL_FORMAT_BPP12_YUV420P) == 55 + 2 * 6 * 3);
+    munit_assert(sail_pixels_size(5, 11, SAIL_PIXEL_FORMAT_BPP12_NV12) == 55 + 12 * 3);
+    munit_assert(sail_pixels_size(5, 11, SAIL_PIXEL_FORMAT_BPP24_YUV444P) == 55 * 3);
+    munit_assert(sail_pixels_size(5, 33, SAIL_PIXEL_FORMAT_BPP24_RGB) == 165);
+
+    unsigned char pixels[200];
+    void *planes[3];
+    unsigned planes_bytes_per_line[3];
+    unsigned planes_height[3];
+
+    munit_assert_uint(sail_planes(SAIL_PIXEL_FORMAT_BPP12_YUV420P, pixels, 5, 11, planes, planes_bytes_per_line, planes_height), ==, 3);
+    munit_assert_ptr_equal(planes[0], pixels);
+    munit_assert_ptr_equal(planes[1], pixels + 55);
+    munit_assert_ptr_equal(planes[2], pixels + 55 + 18);
+    munit_assert_uint(planes_bytes_per_line[1], ==, 6);
+    munit_assert_uint(planes_height[1], ==, 3);
+
+    munit_assert_uint(sail_planes(SAIL_PIXEL_FORMAT_BPP12_NV12, pixels, 5, 11, planes, planes_bytes_per_line, planes_height), ==, 2);
+    munit_assert_ptr_equal(planes[1], pixels + 55);
+    munit_assert_null(planes[2]);
+    munit_assert_uint(planes_bytes_per_line[1], ==, 12);
+
+    munit_assert_uint(sail_planes(SAIL_PIXEL_FORMAT_BPP24_RGB, pixels, 5, 33, planes, planes_bytes_per_line, planes_height), ==, 1);
+    munit_assert_ptr_equal(planes[0], pixels);
+    munit_assert_uint(planes_bytes_per_line[0], ==, 33);
+    munit_assert_uint(planes_height[0], ==, 5);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/indexed",         test_indexed,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/grayscale",       test_grayscale,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
@@ -241,6 +294,7 @@ static MunitTest test_suite_tests[] = {
     { (char *)"/ycbcr",           test_ycbcr,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/ycck",            test_ycck,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/cie-lab",         test_cie_lab,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/planar",          test_planar,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -0,0 +1,118 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail-common/sail-common.h>
+
+#include "munit.h"
+
+static bool always_canceled(void *user_data) {
+    (void)user_data;
+
+    return true;
+}
+
+static bool flag_canceled(void *user_data) {
+
+    return *(bool *)user_data;
+}
+
+static MunitResult test_alloc(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_cancel_token *cancel_token = NULL;
+    munit_assert(sail_alloc_cancel_token(&cancel_token) == SAIL_OK);
+    munit_assert_not_null(cancel_token);
+    munit_assert_null(cancel_token->is_canceled);
+    munit_assert_null(cancel_token->user_data);
+    munit_assert(cancel_token->deadline == 0);
+
+    munit_assert(sail_check_cancel_token(cancel_token) == SAIL_OK);
+
+    sail_destroy_cancel_token(cancel_token);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_null(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_check_cancel_token(NULL) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_callback(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_cancel_token cancel_token = { .is_canceled = always_canceled };
+    munit_assert(sail_check_cancel_token(&cancel_token) == SAIL_ERROR_CANCELED);
+
+    bool canceled = false;
+    cancel_token.is_canceled = flag_canceled;
+    cancel_token.user_data   = &canceled;
+    munit_assert(sail_check_cancel_token(&cancel_token) == SAIL_OK);
+
+    canceled = true;
+    munit_assert(sail_check_cancel_token(&cancel_token) == SAIL_ERROR_CANCELED);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_deadline(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_cancel_token cancel_token = { .deadline = sail_now() + 60 * 1000 };
+    munit_assert(sail_check_cancel_token(&cancel_token) == SAIL_OK);
+
+    cancel_token.deadline = 1;
+    munit_assert(sail_check_cancel_token(&cancel_token) == SAIL_ERROR_CANCELED);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/alloc",    test_alloc,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/null",     test_null,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/callback", test_callback, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/deadline", test_deadline, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/cancel-token",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
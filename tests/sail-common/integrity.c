@@ -159,6 +159,20 @@ static MunitResult test_pixel_format_to_string(const MunitParameter params[], vo
     munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP48_YUVA), "BPP48-YUVA");
     munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_YUVA), "BPP64-YUVA");
 
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP12_YUV420P), "BPP12-YUV420P");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP12_NV12), "BPP12-NV12");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP24_YUV444P), "BPP24-YUV444P");
+
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED), "BPP32-RGBA-PREMULTIPLIED");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED), "BPP32-BGRA-PREMULTIPLIED");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED), "BPP64-RGBA-PREMULTIPLIED");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED), "BPP64-BGRA-PREMULTIPLIED");
+
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP48_RGB_HALF), "BPP48-RGB-HALF");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF), "BPP64-RGBA-HALF");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT), "BPP96-RGB-FLOAT");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT), "BPP128-RGBA-FLOAT");
+
     return MUNIT_OK;
 }
 
@@ -256,6 +270,20 @@ static MunitResult test_pixel_format_from_string(const MunitParameter params[],
     munit_assert(sail_pixel_format_from_string("BPP48-YUVA") == SAIL_PIXEL_FORMAT_BPP48_YUVA);
     munit_assert(sail_pixel_format_from_string("BPP64-YUVA") == SAIL_PIXEL_FORMAT_BPP64_YUVA);
 
+    munit_assert(sail_pixel_format_from_string("BPP12-YUV420P") == SAIL_PIXEL_FORMAT_BPP12_YUV420P);
+    munit_assert(sail_pixel_format_from_string("BPP12-NV12") == SAIL_PIXEL_FORMAT_BPP12_NV12);
+    munit_assert(sail_pixel_format_from_string("BPP24-YUV444P") == SAIL_PIXEL_FORMAT_BPP24_YUV444P);
+
+    munit_assert(sail_pixel_format_from_string("BPP32-RGBA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED);
+    munit_assert(sail_pixel_format_from_string("BPP32-BGRA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED);
+    munit_assert(sail_pixel_format_from_string("BPP64-RGBA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED);
+    munit_assert(sail_pixel_format_from_string("BPP64-BGRA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED);
+
+    munit_assert(sail_pixel_format_from_string("BPP48-RGB-HALF") == SAIL_PIXEL_FORMAT_BPP48_RGB_HALF);
+    munit_assert(sail_pixel_format_from_string("BPP64-RGBA-HALF") == SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF);
+    munit_assert(sail_pixel_format_from_string("BPP96-RGB-FLOAT") == SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT);
+    munit_assert(sail_pixel_format_from_string("BPP128-RGBA-FLOAT") == SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT);
+
     return MUNIT_OK;
 }
 
@@ -561,6 +589,8 @@ static MunitResult test_codec_feature_to_string(const MunitParameter params[], v
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_INTERLACED),   "INTERLACED");
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_ICCP),         "ICCP");
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_SOURCE_IMAGE), "SOURCE-IMAGE");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_ROI),          "ROI");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_VALIDATE),     "VALIDATE");
 
     return MUNIT_OK;
 }
@@ -580,6 +610,8 @@ static MunitResult test_codec_feature_from_string(const MunitParameter params[],
     munit_assert(sail_codec_feature_from_string("INTERLACED")   == SAIL_CODEC_FEATURE_INTERLACED);
     munit_assert(sail_codec_feature_from_string("ICCP")         == SAIL_CODEC_FEATURE_ICCP);
     munit_assert(sail_codec_feature_from_string("SOURCE-IMAGE") == SAIL_CODEC_FEATURE_SOURCE_IMAGE);
+    munit_assert(sail_codec_feature_from_string("ROI")          == SAIL_CODEC_FEATURE_ROI);
+    munit_assert(sail_codec_feature_from_string("VALIDATE")     == SAIL_CODEC_FEATURE_VALIDATE);
 
     return MUNIT_OK;
 }
@@ -36,6 +36,15 @@ static MunitResult test_alloc_options(const MunitParameter params[], void *user_
     munit_assert_not_null(load_options);
     munit_assert(load_options->options == 0);
     munit_assert_null(load_options->tuning);
+    munit_assert(load_options->roi_width == 0);
+    munit_assert(load_options->roi_height == 0);
+    munit_assert(load_options->max_width == 0);
+    munit_assert(load_options->max_height == 0);
+    munit_assert(load_options->max_pixels == 0);
+    munit_assert(load_options->max_memory == 0);
+    munit_assert(load_options->max_frames == 0);
+    munit_assert(load_options->max_meta_data_size == 0);
+    munit_assert(load_options->output_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN);
 
     sail_destroy_load_options(load_options);
 
@@ -49,7 +58,18 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     struct sail_load_options *load_options = NULL;
     munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
 
-    load_options->options = SAIL_OPTION_ICCP;
+    load_options->options    = SAIL_OPTION_ICCP;
+    load_options->roi_x      = 1;
+    load_options->roi_y      = 2;
+    load_options->roi_width  = 3;
+    load_options->roi_height = 4;
+    load_options->max_width           = 5;
+    load_options->max_height          = 6;
+    load_options->max_pixels          = 7;
+    load_options->max_memory          = 8;
+    load_options->max_frames          = 9;
+    load_options->max_meta_data_size  = 10;
+    load_options->output_pixel_format = SAIL_PIXEL_FORMAT_BPP32_BGRA;
 
     struct sail_load_options *load_options_copy = NULL;
     munit_assert(sail_copy_load_options(load_options, &load_options_copy) == SAIL_OK);
@@ -57,6 +77,17 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
 
     munit_assert(load_options_copy->options == load_options->options);
     munit_assert_null(load_options_copy->tuning);
+    munit_assert(load_options_copy->roi_x == load_options->roi_x);
+    munit_assert(load_options_copy->roi_y == load_options->roi_y);
+    munit_assert(load_options_copy->roi_width == load_options->roi_width);
+    munit_assert(load_options_copy->roi_height == load_options->roi_height);
+    munit_assert(load_options_copy->max_width == load_options->max_width);
+    munit_assert(load_options_copy->max_height == load_options->max_height);
+    munit_assert(load_options_copy->max_pixels == load_options->max_pixels);
+    munit_assert(load_options_copy->max_memory == load_options->max_memory);
+    munit_assert(load_options_copy->max_frames == load_options->max_frames);
+    munit_assert(load_options_copy->max_meta_data_size == load_options->max_meta_data_size);
+    munit_assert(load_options_copy->output_pixel_format == load_options->output_pixel_format);
 
     sail_destroy_load_options(load_options_copy);
     sail_destroy_load_options(load_options);
@@ -81,10 +112,80 @@ static MunitResult test_options_from_features(const MunitParameter params[], voi
     return MUNIT_OK;
 }
 
+static MunitResult test_intersect_roi(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_load_options *load_options = NULL;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+
+    unsigned x, y, width, height;
+
+    /* No region of interest. */
+    munit_assert(sail_intersect_roi(load_options, 100, 50, &x, &y, &width, &height) == SAIL_OK);
+    munit_assert(x == 0 && y == 0 && width == 100 && height == 50);
+
+    /* Inside. */
+    load_options->roi_x      = 10;
+    load_options->roi_y      = 20;
+    load_options->roi_width  = 30;
+    load_options->roi_height = 5;
+    munit_assert(sail_intersect_roi(load_options, 100, 50, &x, &y, &width, &height) == SAIL_OK);
+    munit_assert(x == 10 && y == 20 && width == 30 && height == 5);
+
+    /* Clipped. */
+    load_options->roi_width  = 1000;
+    load_options->roi_height = 1000;
+    munit_assert(sail_intersect_roi(load_options, 100, 50, &x, &y, &width, &height) == SAIL_OK);
+    munit_assert(x == 10 && y == 20 && width == 90 && height == 30);
+
+    /* Outside. */
+    load_options->roi_x = 100;
+    munit_assert(sail_intersect_roi(load_options, 100, 50, &x, &y, &width, &height) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_limits(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_load_options *load_options = NULL;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+
+    /* No limits. */
+    munit_assert(sail_check_dimensions_limit(NULL, 100000, 100000) == SAIL_OK);
+    munit_assert(sail_check_memory_limit(NULL, UINT64_MAX) == SAIL_OK);
+    munit_assert(sail_check_dimensions_limit(load_options, 100000, 100000) == SAIL_OK);
+    munit_assert(sail_check_memory_limit(load_options, UINT64_MAX) == SAIL_OK);
+
+    load_options->max_width  = 100;
+    load_options->max_height = 50;
+    munit_assert(sail_check_dimensions_limit(load_options, 100, 50) == SAIL_OK);
+    munit_assert(sail_check_dimensions_limit(load_options, 101, 50) == SAIL_ERROR_LIMIT_EXCEEDED);
+    munit_assert(sail_check_dimensions_limit(load_options, 100, 51) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    load_options->max_pixels = 1000;
+    munit_assert(sail_check_dimensions_limit(load_options, 100, 10) == SAIL_OK);
+    munit_assert(sail_check_dimensions_limit(load_options, 100, 11) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    load_options->max_memory = 1024;
+    munit_assert(sail_check_memory_limit(load_options, 1024) == SAIL_OK);
+    munit_assert(sail_check_memory_limit(load_options, 1025) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/alloc", test_alloc_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/copy", test_copy_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/from-features", test_options_from_features, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/intersect-roi", test_intersect_roi, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/limits", test_limits, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
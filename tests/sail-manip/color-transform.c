@@ -0,0 +1,600 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+/* Colorants in the D50 PCSXYZ as columns of the matrices. */
+static const double SRGB_COLORANTS[3][3] = {
+    { 0.4360747, 0.2225045, 0.0139322 },
+    { 0.3850649, 0.7168786, 0.0971045 },
+    { 0.1430804, 0.0606169, 0.7141733 },
+};
+
+static const double ADOBE_RGB_COLORANTS[3][3] = {
+    { 0.6097559, 0.3111242, 0.0194811 },
+    { 0.2052401, 0.6256560, 0.0608902 },
+    { 0.1492240, 0.0632197, 0.7448387 },
+};
+
+/* u8Fixed8 gamma 2.2 as stored in 'curv' tags. */
+static const double GAMMA = 563 / 256.0;
+
+static void put_be16(uint8_t *data, unsigned value) {
+
+    data[0] = (uint8_t)(value >> 8);
+    data[1] = (uint8_t)value;
+}
+
+static void put_be32(uint8_t *data, uint32_t value) {
+
+    put_be16(data, value >> 16);
+    put_be16(data + 2, value & 0xFFFF);
+}
+
+static void put_signature(uint8_t *data, const char *signature) {
+
+    memcpy(data, signature, 4);
+}
+
+static double s15_fixed16(double value) {
+
+    return floor(value * 65536 + 0.5) / 65536;
+}
+
+struct tag {
+
+    const char *signature;
+    uint8_t data[64];
+    unsigned size;
+};
+
+static void xyz_tag(struct tag *tag, const char *signature, const double xyz[3]) {
+
+    tag->signature = signature;
+    memset(tag->data, 0, sizeof(tag->data));
+    put_signature(tag->data, "XYZ ");
+
+    for (unsigned i = 0; i < 3; i++) {
+        put_be32(tag->data + 8 + i * 4, (uint32_t)(int32_t)floor(xyz[i] * 65536 + 0.5));
+    }
+
+    tag->size = 20;
+}
+
+static void gamma_tag(struct tag *tag, const char *signature, unsigned gamma) {
+
+    tag->signature = signature;
+    memset(tag->data, 0, sizeof(tag->data));
+    put_signature(tag->data, "curv");
+    put_be32(tag->data + 8, 1);
+    put_be16(tag->data + 12, gamma);
+    tag->size = 14;
+}
+
+static void srgb_tag(struct tag *tag, const char *signature) {
+
+    static const double PARAMS[] = { 2.4, 1 / 1.055, 0.055 / 1.055, 1 / 12.92, 0.04045 };
+
+    tag->signature = signature;
+    memset(tag->data, 0, sizeof(tag->data));
+    put_signature(tag->data, "para");
+    put_be16(tag->data + 8, 3);
+
+    for (unsigned i = 0; i < 5; i++) {
+        put_be32(tag->data + 12 + i * 4, (uint32_t)(int32_t)floor(PARAMS[i] * 65536 + 0.5));
+    }
+
+    tag->size = 32;
+}
+
+static sail_status_t build_iccp(const char *color_space, const struct tag *tags, unsigned tag_count, struct sail_iccp **iccp) {
+
+    size_t size = 128 + 4 + 12 * tag_count;
+
+    for (unsigned i = 0; i < tag_count; i++) {
+        size += (tags[i].size + 3) / 4 * 4;
+    }
+
+    struct sail_iccp *iccp_local;
+    SAIL_TRY(sail_alloc_iccp_for_data(size, &iccp_local));
+
+    uint8_t *data = iccp_local->data;
+    memset(data, 0, size);
+
+    put_be32(data, (uint32_t)size);
+    put_signature(data + 12, "mntr");
+    put_signature(data + 16, color_space);
+    put_signature(data + 20, "XYZ ");
+    put_signature(data + 36, "acsp");
+    put_be32(data + 128, tag_count);
+
+    size_t offset = 128 + 4 + 12 * tag_count;
+
+    for (unsigned i = 0; i < tag_count; i++) {
+        uint8_t *entry = data + 128 + 4 + 12 * i;
+
+        put_signature(entry, tags[i].signature);
+        put_be32(entry + 4, (uint32_t)offset);
+        put_be32(entry + 8, tags[i].size);
+        memcpy(data + offset, tags[i].data, tags[i].size);
+
+        offset += (tags[i].size + 3) / 4 * 4;
+    }
+
+    *iccp = iccp_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t build_rgb_iccp(const double colorants[3][3], bool srgb_curves, struct sail_iccp **iccp) {
+
+    static const char *COLORANTS[] = { "rXYZ", "gXYZ", "bXYZ" };
+    static const char *CURVES[]    = { "rTRC", "gTRC", "bTRC" };
+
+    struct tag tags[6];
+
+    for (unsigned i = 0; i < 3; i++) {
+        xyz_tag(&tags[i], COLORANTS[i], colorants[i]);
+
+        if (srgb_curves) {
+            srgb_tag(&tags[3 + i], CURVES[i]);
+        } else {
+            gamma_tag(&tags[3 + i], CURVES[i], 563);
+        }
+    }
+
+    SAIL_TRY(build_iccp("RGB ", tags, 6, iccp));
+
+    return SAIL_OK;
+}
+
+static double srgb_encode(double value) {
+
+    value = (value < 0) ? 0 : (value > 1) ? 1 : value;
+
+    return (value <= 0.0031308) ? value * 12.92 : 1.055 * pow(value, 1 / 2.4) - 0.055;
+}
+
+static void invert_matrix(double m[3][3], double inverse[3][3]) {
+
+    const double determinant = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                                - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                                + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+
+    inverse[0][0] =  (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / determinant;
+    inverse[0][1] = -(m[0][1] * m[2][2] - m[0][2] * m[2][1]) / determinant;
+    inverse[0][2] =  (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / determinant;
+    inverse[1][0] = -(m[1][0] * m[2][2] - m[1][2] * m[2][0]) / determinant;
+    inverse[1][1] =  (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / determinant;
+    inverse[1][2] = -(m[0][0] * m[1][2] - m[0][2] * m[1][0]) / determinant;
+    inverse[2][0] =  (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / determinant;
+    inverse[2][1] = -(m[0][0] * m[2][1] - m[0][1] * m[2][0]) / determinant;
+    inverse[2][2] =  (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / determinant;
+}
+
+/* Reference transform from gamma 2.2 with the colorants into sRGB. */
+static void reference_transform(const double colorants[3][3], const double rgb[3], double output[3]) {
+
+    double source[3][3];
+    double target[3][3];
+
+    /* Columns of the matrices are the colorants rounded as in profiles. */
+    for (unsigned row = 0; row < 3; row++) {
+        for (unsigned column = 0; column < 3; column++) {
+            source[row][column] = s15_fixed16(colorants[column][row]);
+            target[row][column] = s15_fixed16(SRGB_COLORANTS[column][row]);
+        }
+    }
+
+    double target_inverse[3][3];
+    invert_matrix(target, target_inverse);
+
+    double linear[3];
+    double xyz[3];
+
+    for (unsigned i = 0; i < 3; i++) {
+        linear[i] = pow(rgb[i], GAMMA);
+    }
+
+    for (unsigned i = 0; i < 3; i++) {
+        xyz[i] = source[i][0] * linear[0] + source[i][1] * linear[1] + source[i][2] * linear[2];
+    }
+
+    for (unsigned i = 0; i < 3; i++) {
+        output[i] = srgb_encode(target_inverse[i][0] * xyz[0] + target_inverse[i][1] * xyz[1] + target_inverse[i][2] * xyz[2]);
+    }
+}
+
+/* Scan lines are padded to check that the padding is respected. */
+static const unsigned PADDING = 6;
+
+static unsigned get_channel(const struct sail_image *image, unsigned bytes_per_channel, unsigned row, unsigned index) {
+
+    const uint8_t *scan = sail_scan_line(image, row);
+
+    return (bytes_per_channel == 1) ? scan[index] : ((const uint16_t *)scan)[index];
+}
+
+struct rgb_format {
+
+    enum SailPixelFormat pixel_format;
+    unsigned channels;
+    unsigned bytes_per_channel;
+    unsigned r, g, b;
+    /* Alpha or X channel, or channels for no such channel. */
+    unsigned a;
+};
+
+static const struct rgb_format RGB_FORMATS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,  3, 1, 0, 1, 2, 3 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,  3, 1, 2, 1, 0, 3 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA, 4, 1, 0, 1, 2, 3 },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB, 4, 1, 1, 2, 3, 0 },
+    { SAIL_PIXEL_FORMAT_BPP32_XBGR, 4, 1, 3, 2, 1, 0 },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,  3, 2, 2, 1, 0, 3 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA, 4, 2, 0, 1, 2, 3 },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRX, 4, 2, 2, 1, 0, 3 },
+};
+
+/* Checks the transformed pixels against the reference transform from gamma 2.2 with the colorants into sRGB. */
+static void check_rgb_transform(const struct rgb_format *format, const struct sail_image *image,
+                                const struct sail_image *image_output, const double colorants[3][3]) {
+
+    const double max_value = (format->bytes_per_channel == 1) ? 255 : 65535;
+    /* Linear light is quantized into 16 bits, and sRGB is steep near black. */
+    const double tolerance = (format->bytes_per_channel == 1) ? 1 : 8;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        for (unsigned column = 0; column < image->width; column++) {
+            const unsigned pixel = column * format->channels;
+
+            const double rgb[3] = {
+                get_channel(image, format->bytes_per_channel, row, pixel + format->r) / max_value,
+                get_channel(image, format->bytes_per_channel, row, pixel + format->g) / max_value,
+                get_channel(image, format->bytes_per_channel, row, pixel + format->b) / max_value,
+            };
+
+            double expected[3];
+            reference_transform(colorants, rgb, expected);
+
+            munit_assert_double(fabs(get_channel(image_output, format->bytes_per_channel, row, pixel + format->r) - expected[0] * max_value), <=, tolerance);
+            munit_assert_double(fabs(get_channel(image_output, format->bytes_per_channel, row, pixel + format->g) - expected[1] * max_value), <=, tolerance);
+            munit_assert_double(fabs(get_channel(image_output, format->bytes_per_channel, row, pixel + format->b) - expected[2] * max_value), <=, tolerance);
+
+            if (format->a < format->channels) {
+                munit_assert_uint(get_channel(image_output, format->bytes_per_channel, row, pixel + format->a), ==,
+                                    get_channel(image, format->bytes_per_channel, row, pixel + format->a));
+            }
+        }
+    }
+}
+
+static MunitResult test_srgb_identity(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_iccp *srgb_iccp;
+    munit_assert(build_rgb_iccp(SRGB_COLORANTS, true, &srgb_iccp) == SAIL_OK);
+
+    for (size_t f = 0; f < sizeof(RGB_FORMATS) / sizeof(RGB_FORMATS[0]); f++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(RGB_FORMATS[f].pixel_format, 67, 31, PADDING, &image) == SAIL_OK);
+
+        struct sail_image *image_output;
+        munit_assert(sail_copy_image(image, &image_output) == SAIL_OK);
+
+        /* The embedded sRGB profile matches the built-in one. */
+        struct sail_color_transform *transform;
+        munit_assert(sail_alloc_color_transform(srgb_iccp, NULL, image->pixel_format, &transform) == SAIL_OK);
+        munit_assert(sail_apply_color_transform(transform, image_output) == SAIL_OK);
+        munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_output->pixels, image->pixels);
+        sail_destroy_color_transform(transform);
+
+        munit_assert(sail_alloc_color_transform(NULL, NULL, image->pixel_format, &transform) == SAIL_OK);
+        munit_assert(sail_apply_color_transform(transform, image_output) == SAIL_OK);
+        munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_output->pixels, image->pixels);
+        sail_destroy_color_transform(transform);
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_iccp(srgb_iccp);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_rgb(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Curves only, and curves with the matrix. */
+    const double (*COLORANTS[])[3] = { SRGB_COLORANTS, ADOBE_RGB_COLORANTS };
+
+    for (size_t c = 0; c < sizeof(COLORANTS) / sizeof(COLORANTS[0]); c++) {
+        struct sail_iccp *iccp;
+        munit_assert(build_rgb_iccp(COLORANTS[c], false, &iccp) == SAIL_OK);
+
+        for (size_t f = 0; f < sizeof(RGB_FORMATS) / sizeof(RGB_FORMATS[0]); f++) {
+            munit_assert(sail_can_transform_colors(RGB_FORMATS[f].pixel_format));
+
+            struct sail_image *image;
+            munit_assert(sail_test_alloc_image(RGB_FORMATS[f].pixel_format, 67, 31, PADDING, &image) == SAIL_OK);
+
+            struct sail_image *image_output;
+            munit_assert(sail_copy_image(image, &image_output) == SAIL_OK);
+
+            struct sail_color_transform *transform;
+            munit_assert(sail_alloc_color_transform(iccp, NULL, image->pixel_format, &transform) == SAIL_OK);
+            munit_assert(sail_apply_color_transform(transform, image_output) == SAIL_OK);
+            sail_destroy_color_transform(transform);
+
+            check_rgb_transform(&RGB_FORMATS[f], image, image_output, COLORANTS[c]);
+
+            sail_destroy_image(image_output);
+            sail_destroy_image(image);
+        }
+
+        sail_destroy_iccp(iccp);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_gray(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Linear gray. */
+    struct tag tag;
+    gamma_tag(&tag, "kTRC", 256);
+
+    struct sail_iccp *iccp;
+    munit_assert(build_iccp("GRAY", &tag, 1, &iccp) == SAIL_OK);
+
+    static const struct {
+        enum SailPixelFormat pixel_format;
+        unsigned channels;
+        unsigned bytes_per_channel;
+    } GRAY_FORMATS[] = {
+        { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,        1, 1 },
+        { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,       1, 2 },
+        { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA, 2, 1 },
+        { SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA, 2, 2 },
+        /* RGB pixels of converted grayscale frames. */
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,             3, 1 },
+        { SAIL_PIXEL_FORMAT_BPP64_RGBA,            4, 2 },
+    };
+
+    for (size_t f = 0; f < sizeof(GRAY_FORMATS) / sizeof(GRAY_FORMATS[0]); f++) {
+        const unsigned channels = GRAY_FORMATS[f].channels;
+        const unsigned bytes_per_channel = GRAY_FORMATS[f].bytes_per_channel;
+        const double max_value = (bytes_per_channel == 1) ? 255 : 65535;
+        const double tolerance = (bytes_per_channel == 1) ? 1 : 8;
+
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(GRAY_FORMATS[f].pixel_format, 45, 23, PADDING, &image) == SAIL_OK);
+
+        struct sail_image *image_output;
+        munit_assert(sail_copy_image(image, &image_output) == SAIL_OK);
+
+        /* Grayscale profiles with RGB target profiles use the green curve. */
+        struct sail_color_transform *transform;
+        munit_assert(sail_alloc_color_transform(iccp, NULL, image->pixel_format, &transform) == SAIL_OK);
+        munit_assert(sail_apply_color_transform(transform, image_output) == SAIL_OK);
+        sail_destroy_color_transform(transform);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            for (unsigned column = 0; column < image->width; column++) {
+                const unsigned pixel = column * channels;
+                const unsigned color_channels = (channels >= 3) ? 3 : 1;
+
+                for (unsigned channel = 0; channel < color_channels; channel++) {
+                    const double expected = srgb_encode(get_channel(image, bytes_per_channel, row, pixel + channel) / max_value) * max_value;
+
+                    munit_assert_double(fabs(get_channel(image_output, bytes_per_channel, row, pixel + channel) - expected), <=, tolerance);
+                }
+
+                if (channels == 2 || channels == 4) {
+                    munit_assert_uint(get_channel(image_output, bytes_per_channel, row, pixel + channels - 1), ==,
+                                        get_channel(image, bytes_per_channel, row, pixel + channels - 1));
+                }
+            }
+        }
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_iccp(iccp);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_transform_image(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_iccp *adobe_iccp;
+    munit_assert(build_rgb_iccp(ADOBE_RGB_COLORANTS, false, &adobe_iccp) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_BGRA, 129, 257, PADDING, &image) == SAIL_OK);
+
+    struct sail_color_transform *transform;
+    munit_assert(sail_alloc_color_transform(adobe_iccp, NULL, image->pixel_format, &transform) == SAIL_OK);
+
+    /* The same pixels transformed with the cached transforms in many threads. */
+    const unsigned max_threads = sail_max_threads();
+
+    for (unsigned threads = 1; threads <= 4; threads *= 2) {
+        sail_set_max_threads(threads);
+
+        for (unsigned i = 0; i < 3; i++) {
+            struct sail_image *expected;
+            munit_assert(sail_copy_image(image, &expected) == SAIL_OK);
+            munit_assert(sail_apply_color_transform(transform, expected) == SAIL_OK);
+
+            struct sail_image *image_output;
+            munit_assert(sail_copy_image(image, &image_output) == SAIL_OK);
+            munit_assert(sail_copy_iccp(adobe_iccp, &image_output->iccp) == SAIL_OK);
+
+            munit_assert(sail_transform_image_colors(image_output, NULL) == SAIL_OK);
+            munit_assert_null(image_output->iccp);
+            munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_output->pixels, expected->pixels);
+
+            /* And back. The transform is not exact, so only the profile is checked. */
+            munit_assert(sail_transform_image_colors(image_output, adobe_iccp) == SAIL_OK);
+            munit_assert_not_null(image_output->iccp);
+            munit_assert_uint(image_output->iccp->size, ==, adobe_iccp->size);
+            munit_assert_memory_equal(adobe_iccp->size, image_output->iccp->data, adobe_iccp->data);
+
+            sail_destroy_image(image_output);
+            sail_destroy_image(expected);
+        }
+    }
+
+    sail_set_max_threads(max_threads);
+    sail_clear_color_transform_cache();
+
+    /* The cache is rebuilt after clearing. */
+    munit_assert(sail_copy_iccp(adobe_iccp, &image->iccp) == SAIL_OK);
+    munit_assert(sail_transform_image_colors(image, NULL) == SAIL_OK);
+    munit_assert_null(image->iccp);
+
+    sail_clear_color_transform_cache();
+    sail_destroy_color_transform(transform);
+    sail_destroy_image(image);
+    sail_destroy_iccp(adobe_iccp);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_color_transform *transform;
+
+    /* LUT-based profiles have no colorant tags. */
+    struct tag tag;
+    xyz_tag(&tag, "wtpt", SRGB_COLORANTS[0]);
+    memcpy(tag.data, "mft2", 4);
+    tag.signature = "A2B0";
+
+    struct sail_iccp *lut_iccp;
+    munit_assert(build_iccp("RGB ", &tag, 1, &lut_iccp) == SAIL_OK);
+    munit_assert(sail_alloc_color_transform(lut_iccp, NULL, SAIL_PIXEL_FORMAT_BPP24_RGB, &transform) == SAIL_ERROR_UNSUPPORTED_ICCP);
+
+    /* Failed transforms leave images untouched. */
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 16, 16, PADDING, &image) == SAIL_OK);
+    munit_assert(sail_copy_iccp(lut_iccp, &image->iccp) == SAIL_OK);
+
+    struct sail_image *image_copy;
+    munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+
+    munit_assert(sail_transform_image_colors(image, NULL) == SAIL_ERROR_UNSUPPORTED_ICCP);
+    munit_assert_not_null(image->iccp);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image->pixels, image_copy->pixels);
+
+    sail_destroy_image(image_copy);
+    sail_destroy_image(image);
+
+    /* Truncated profiles. */
+    struct sail_iccp *srgb_iccp;
+    munit_assert(build_rgb_iccp(SRGB_COLORANTS, true, &srgb_iccp) == SAIL_OK);
+
+    const size_t size = srgb_iccp->size;
+    srgb_iccp->size = 140;
+    munit_assert(sail_alloc_color_transform(srgb_iccp, NULL, SAIL_PIXEL_FORMAT_BPP24_RGB, &transform) == SAIL_ERROR_UNSUPPORTED_ICCP);
+    srgb_iccp->size = size - 8;
+    munit_assert(sail_alloc_color_transform(srgb_iccp, NULL, SAIL_PIXEL_FORMAT_BPP24_RGB, &transform) == SAIL_ERROR_UNSUPPORTED_ICCP);
+    srgb_iccp->size = size;
+
+    /* Mismatched color spaces. */
+    gamma_tag(&tag, "kTRC", 256);
+
+    struct sail_iccp *gray_iccp;
+    munit_assert(build_iccp("GRAY", &tag, 1, &gray_iccp) == SAIL_OK);
+    munit_assert(sail_alloc_color_transform(NULL, gray_iccp, SAIL_PIXEL_FORMAT_BPP24_RGB, &transform) == SAIL_ERROR_UNSUPPORTED_ICCP);
+    munit_assert(sail_alloc_color_transform(srgb_iccp, NULL, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &transform) == SAIL_ERROR_UNSUPPORTED_ICCP);
+
+    /* Unsupported pixel formats. */
+    munit_assert(!sail_can_transform_colors(SAIL_PIXEL_FORMAT_BPP32_CMYK));
+    munit_assert(!sail_can_transform_colors(SAIL_PIXEL_FORMAT_BPP8_INDEXED));
+    munit_assert(!sail_can_transform_colors(SAIL_PIXEL_FORMAT_BPP16_RGB565));
+    munit_assert(sail_alloc_color_transform(NULL, NULL, SAIL_PIXEL_FORMAT_BPP32_CMYK, &transform) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    /* Transforms apply to their pixel formats only. */
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 4, 4, PADDING, &image) == SAIL_OK);
+    munit_assert(sail_alloc_color_transform(NULL, NULL, SAIL_PIXEL_FORMAT_BPP24_RGB, &transform) == SAIL_OK);
+    munit_assert(sail_apply_color_transform(transform, image) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    sail_destroy_color_transform(transform);
+    sail_destroy_image(image);
+
+    sail_destroy_iccp(gray_iccp);
+    sail_destroy_iccp(srgb_iccp);
+    sail_destroy_iccp(lut_iccp);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/srgb-identity",   test_srgb_identity,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/rgb",             test_rgb,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/gray",            test_gray,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/transform-image", test_transform_image, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported",     test_unsupported,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/color-transform",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
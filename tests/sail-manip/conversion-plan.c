@@ -0,0 +1,212 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+/* Pairs that go through SIMD, row kernels, lookup tables, and the generic path. */
+static const enum SailPixelFormat PIXEL_FORMAT_PAIRS[][2] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,    SAIL_PIXEL_FORMAT_BPP32_BGRA },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,   SAIL_PIXEL_FORMAT_BPP48_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP8_INDEXED, SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,   SAIL_PIXEL_FORMAT_BPP32_RGBA },
+};
+
+static const unsigned WIDTH  = 37;
+static const unsigned HEIGHT = 11;
+
+/* Output images are zeroed to detect untouched scan lines. */
+static sail_status_t alloc_zeroed_image(enum SailPixelFormat pixel_format, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_test_alloc_image(pixel_format, WIDTH, HEIGHT, 0, &image_local));
+
+    memset(image_local->pixels, 0, (size_t)HEIGHT * image_local->bytes_per_line);
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static MunitResult test_convert(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMAT_PAIRS) / sizeof(PIXEL_FORMAT_PAIRS[0]); i++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMAT_PAIRS[i][0], WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+        struct sail_image *image_expected;
+        munit_assert(sail_convert_image(image, PIXEL_FORMAT_PAIRS[i][1], &image_expected) == SAIL_OK);
+
+        struct sail_conversion_plan *plan;
+        munit_assert(sail_alloc_conversion_plan(PIXEL_FORMAT_PAIRS[i][0], PIXEL_FORMAT_PAIRS[i][1], WIDTH,
+                                                image->palette, NULL, &plan) == SAIL_OK);
+
+        /* Whole image, executed twice to make sure the plan is reusable. */
+        for (int pass = 0; pass < 2; pass++) {
+            struct sail_image *image_output;
+            munit_assert(alloc_zeroed_image(PIXEL_FORMAT_PAIRS[i][1], &image_output) == SAIL_OK);
+
+            munit_assert(sail_convert_image_with_plan(plan, image, image_output) == SAIL_OK);
+            munit_assert_memory_equal((size_t)HEIGHT * image_output->bytes_per_line, image_output->pixels, image_expected->pixels);
+
+            sail_destroy_image(image_output);
+        }
+
+        /* Row ranges. */
+        {
+            struct sail_image *image_output;
+            munit_assert(alloc_zeroed_image(PIXEL_FORMAT_PAIRS[i][1], &image_output) == SAIL_OK);
+
+            munit_assert(sail_convert_rows_with_plan(plan, image, 0, 4, image_output) == SAIL_OK);
+            munit_assert(sail_convert_rows_with_plan(plan, image, 4, 0, image_output) == SAIL_OK);
+
+            /* Untouched scan lines stay zero. */
+            const uint8_t *scan = sail_scan_line(image_output, 4);
+            for (unsigned k = 0; k < image_output->bytes_per_line; k++) {
+                munit_assert_uint8(scan[k], ==, 0);
+            }
+
+            munit_assert(sail_convert_rows_with_plan(plan, image, 4, HEIGHT - 4, image_output) == SAIL_OK);
+            munit_assert_memory_equal((size_t)HEIGHT * image_output->bytes_per_line, image_output->pixels, image_expected->pixels);
+
+            sail_destroy_image(image_output);
+        }
+
+        sail_destroy_conversion_plan(plan);
+        sail_destroy_image(image_expected);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_palette_captured(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP8_INDEXED, WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+    struct sail_image *image_expected;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_expected) == SAIL_OK);
+
+    struct sail_conversion_plan *plan;
+    munit_assert(sail_alloc_conversion_plan(SAIL_PIXEL_FORMAT_BPP8_INDEXED, SAIL_PIXEL_FORMAT_BPP24_RGB, WIDTH,
+                                            image->palette, NULL, &plan) == SAIL_OK);
+
+    /* Changing the palette after the plan is created doesn't affect it. */
+    memset(image->palette->data, 0, 256 * 3);
+
+    struct sail_image *image_output;
+    munit_assert(alloc_zeroed_image(SAIL_PIXEL_FORMAT_BPP24_RGB, &image_output) == SAIL_OK);
+
+    munit_assert(sail_convert_image_with_plan(plan, image, image_output) == SAIL_OK);
+    munit_assert_memory_equal((size_t)HEIGHT * image_output->bytes_per_line, image_output->pixels, image_expected->pixels);
+
+    sail_destroy_image(image_output);
+    sail_destroy_conversion_plan(plan);
+    sail_destroy_image(image_expected);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_mismatch(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_plan *plan;
+
+    munit_assert(sail_alloc_conversion_plan(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP32_CMYK, WIDTH,
+                                            NULL, NULL, &plan) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert(sail_alloc_conversion_plan(SAIL_PIXEL_FORMAT_BPP8_INDEXED, SAIL_PIXEL_FORMAT_BPP24_RGB, WIDTH,
+                                            NULL, NULL, &plan) == SAIL_ERROR_NULL_PTR);
+    munit_assert(sail_alloc_conversion_plan(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP32_RGBA, 0,
+                                            NULL, NULL, &plan) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+
+    munit_assert(sail_alloc_conversion_plan(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP32_RGBA, WIDTH,
+                                            NULL, NULL, &plan) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+    struct sail_image *image_output;
+    munit_assert(alloc_zeroed_image(SAIL_PIXEL_FORMAT_BPP32_BGRA, &image_output) == SAIL_OK);
+
+    /* Wrong output pixel format. */
+    munit_assert(sail_convert_image_with_plan(plan, image, image_output) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    image_output->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+
+    /* Wrong rows. */
+    munit_assert(sail_convert_rows_with_plan(plan, image, HEIGHT - 1, 2, image_output) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert(sail_convert_rows_with_plan(plan, image, HEIGHT + 1, 0, image_output) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+
+    /* Wrong width. */
+    image->width--;
+    munit_assert(sail_convert_image_with_plan(plan, image, image_output) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    image->width++;
+
+    munit_assert(sail_convert_image_with_plan(plan, image, image_output) == SAIL_OK);
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(image);
+    sail_destroy_conversion_plan(plan);
+    sail_destroy_conversion_plan(NULL);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/convert",          test_convert,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/palette-captured", test_palette_captured, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/mismatch",         test_mismatch,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/conversion-plan",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
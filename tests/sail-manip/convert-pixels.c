@@ -0,0 +1,191 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static const enum SailPixelFormat PIXEL_FORMAT_PAIRS[][2] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP32_BGRA },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,      SAIL_PIXEL_FORMAT_BPP24_BGR  },
+    { SAIL_PIXEL_FORMAT_BPP8_INDEXED,    SAIL_PIXEL_FORMAT_BPP32_RGBA },
+    { SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE,  SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP16_RGB565,    SAIL_PIXEL_FORMAT_BPP48_RGB  },
+};
+
+static const unsigned WIDTH  = 37;
+static const unsigned HEIGHT = 11;
+
+/* Rectangle inside the image. X is even to start 4-bit pixels at a byte boundary. */
+static const unsigned RECT_X      = 6;
+static const unsigned RECT_Y      = 3;
+static const unsigned RECT_WIDTH  = 20;
+static const unsigned RECT_HEIGHT = 5;
+
+/* Extra bytes at the end of every output scan line. */
+static const unsigned PADDING = 7;
+
+static const uint8_t* pixel_address(const struct sail_image *image, unsigned row, unsigned column) {
+
+    return (const uint8_t *)sail_scan_line(image, row) + column * sail_bits_per_pixel(image->pixel_format) / 8;
+}
+
+static MunitResult test_rectangle(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMAT_PAIRS) / sizeof(PIXEL_FORMAT_PAIRS[0]); i++) {
+        const enum SailPixelFormat output_pixel_format = PIXEL_FORMAT_PAIRS[i][1];
+
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMAT_PAIRS[i][0], WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+        struct sail_image *image_expected;
+        munit_assert(sail_convert_image(image, output_pixel_format, &image_expected) == SAIL_OK);
+
+        const unsigned rect_bytes_per_line = sail_bytes_per_line(RECT_WIDTH, output_pixel_format);
+        const unsigned output_bytes_per_line = rect_bytes_per_line + PADDING;
+
+        void *output;
+        munit_assert(sail_malloc((size_t)RECT_HEIGHT * output_bytes_per_line, &output) == SAIL_OK);
+        memset(output, 0xAB, (size_t)RECT_HEIGHT * output_bytes_per_line);
+
+        munit_assert(sail_convert_pixels(image->pixel_format, pixel_address(image, RECT_Y, RECT_X), image->bytes_per_line,
+                                         output_pixel_format, output, output_bytes_per_line,
+                                         RECT_WIDTH, RECT_HEIGHT, image->palette, NULL) == SAIL_OK);
+
+        for (unsigned row = 0; row < RECT_HEIGHT; row++) {
+            const uint8_t *scan_output = (const uint8_t *)output + (size_t)row * output_bytes_per_line;
+
+            munit_assert_memory_equal(rect_bytes_per_line, scan_output, pixel_address(image_expected, RECT_Y + row, RECT_X));
+
+            /* Padding is untouched. */
+            for (unsigned k = rect_bytes_per_line; k < output_bytes_per_line; k++) {
+                munit_assert_uint8(scan_output[k], ==, 0xAB);
+            }
+        }
+
+        sail_free(output);
+        sail_destroy_image(image_expected);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_stripes_with_plan(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMAT_PAIRS) / sizeof(PIXEL_FORMAT_PAIRS[0]); i++) {
+        const enum SailPixelFormat output_pixel_format = PIXEL_FORMAT_PAIRS[i][1];
+
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMAT_PAIRS[i][0], WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+        struct sail_image *image_expected;
+        munit_assert(sail_convert_image(image, output_pixel_format, &image_expected) == SAIL_OK);
+
+        struct sail_conversion_plan *plan;
+        munit_assert(sail_alloc_conversion_plan(image->pixel_format, output_pixel_format, WIDTH,
+                                                image->palette, NULL, &plan) == SAIL_OK);
+
+        /* Convert stripes of 3 scan lines like a decoder would deliver them. */
+        void *output;
+        munit_assert(sail_malloc((size_t)HEIGHT * image_expected->bytes_per_line, &output) == SAIL_OK);
+
+        for (unsigned row = 0; row < HEIGHT; row += 3) {
+            const unsigned stripe_height = SAIL_MIN(3U, HEIGHT - row);
+
+            munit_assert(sail_convert_pixels_with_plan(plan, sail_scan_line(image, row), image->bytes_per_line,
+                                                       (uint8_t *)output + (size_t)row * image_expected->bytes_per_line,
+                                                       image_expected->bytes_per_line, stripe_height) == SAIL_OK);
+        }
+
+        munit_assert_memory_equal((size_t)HEIGHT * image_expected->bytes_per_line, output, image_expected->pixels);
+
+        sail_free(output);
+        sail_destroy_conversion_plan(plan);
+        sail_destroy_image(image_expected);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_invalid(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    uint8_t input[4 * 3];
+    uint8_t output[4 * 4];
+    memset(input, 0, sizeof(input));
+
+    /* Output scan lines are too short. */
+    munit_assert(sail_convert_pixels(SAIL_PIXEL_FORMAT_BPP24_RGB, input, 4 * 3, SAIL_PIXEL_FORMAT_BPP32_RGBA, output, 4 * 3,
+                                     4, 1, NULL, NULL) == SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+
+    /* Missing palette. */
+    munit_assert(sail_convert_pixels(SAIL_PIXEL_FORMAT_BPP8_INDEXED, input, 4, SAIL_PIXEL_FORMAT_BPP32_RGBA, output, 4 * 4,
+                                     4, 1, NULL, NULL) == SAIL_ERROR_NULL_PTR);
+
+    /* Unsupported output. */
+    munit_assert(sail_convert_pixels(SAIL_PIXEL_FORMAT_BPP24_RGB, input, 4 * 3, SAIL_PIXEL_FORMAT_BPP32_CMYK, output, 4 * 4,
+                                     4, 1, NULL, NULL) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    munit_assert(sail_convert_pixels(SAIL_PIXEL_FORMAT_BPP24_RGB, input, 4 * 3, SAIL_PIXEL_FORMAT_BPP32_RGBA, output, 4 * 4,
+                                     4, 1, NULL, NULL) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/rectangle",         test_rectangle,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/stripes-with-plan", test_stripes_with_plan, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/invalid",           test_invalid,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/convert-pixels",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
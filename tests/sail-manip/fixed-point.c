@@ -0,0 +1,211 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+/* Single scan line image with the specified pixels. */
+static sail_status_t alloc_image_from_pixels(enum SailPixelFormat pixel_format, unsigned width, const void *pixels, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_test_alloc_image(pixel_format, width, 1, 0, &image_local));
+
+    memcpy(image_local->pixels, pixels, image_local->bytes_per_line);
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t alloc_blend_options(struct sail_conversion_options **options) {
+
+    struct sail_conversion_options *options_local;
+    SAIL_TRY(sail_alloc_conversion_options(&options_local));
+
+    options_local->options = SAIL_CONVERSION_OPTION_BLEND_ALPHA;
+    options_local->background24 = (sail_rgb24_t){ 10, 20, 30 };
+    options_local->background48 = (sail_rgb48_t){ 1000, 2000, 3000 };
+
+    *options = options_local;
+
+    return SAIL_OK;
+}
+
+static MunitResult test_gray(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* 8-bit. */
+    {
+        const uint8_t pixels[] = { 10, 200, 30,   255, 255, 255,   1, 2, 3,   0, 0, 0 };
+
+        struct sail_image *image;
+        munit_assert(alloc_image_from_pixels(SAIL_PIXEL_FORMAT_BPP24_RGB, 4, pixels, &image) == SAIL_OK);
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &image_output) == SAIL_OK);
+
+        const uint8_t *output = image_output->pixels;
+        munit_assert_uint8(output[0], ==, 124);
+        munit_assert_uint8(output[1], ==, 255);
+        munit_assert_uint8(output[2], ==, 2);
+        munit_assert_uint8(output[3], ==, 0);
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    /* 8-bit to 16-bit. */
+    {
+        const uint8_t pixels[] = { 10, 200, 30,   255, 255, 255 };
+
+        struct sail_image *image;
+        munit_assert(alloc_image_from_pixels(SAIL_PIXEL_FORMAT_BPP24_RGB, 2, pixels, &image) == SAIL_OK);
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, &image_output) == SAIL_OK);
+
+        const uint16_t *output = image_output->pixels;
+        munit_assert_uint16(output[0], ==, 31819);
+        munit_assert_uint16(output[1], ==, 65535);
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_blend_uint8(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const uint8_t pixels[] = { 200, 100, 50, 128,   200, 100, 50, 0,   200, 100, 50, 255 };
+
+    struct sail_image *image;
+    munit_assert(alloc_image_from_pixels(SAIL_PIXEL_FORMAT_BPP32_RGBA, 3, pixels, &image) == SAIL_OK);
+
+    struct sail_conversion_options *options;
+    munit_assert(alloc_blend_options(&options) == SAIL_OK);
+
+    /* RGB. */
+    {
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP24_RGB, options, &image_output) == SAIL_OK);
+
+        const uint8_t expected[] = { 105, 60, 40,   10, 20, 30,   200, 100, 50 };
+        munit_assert_memory_equal(sizeof(expected), image_output->pixels, expected);
+
+        sail_destroy_image(image_output);
+    }
+
+    /* Grayscale. */
+    {
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &image_output) == SAIL_OK);
+
+        const uint8_t expected[] = { 71, 18, 124 };
+        munit_assert_memory_equal(sizeof(expected), image_output->pixels, expected);
+
+        sail_destroy_image(image_output);
+    }
+
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_blend_uint16(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const uint16_t pixels[] = { 5000, 40000, 60000, 30000 };
+
+    struct sail_image *image;
+    munit_assert(alloc_image_from_pixels(SAIL_PIXEL_FORMAT_BPP64_RGBA, 1, pixels, &image) == SAIL_OK);
+
+    struct sail_conversion_options *options;
+    munit_assert(alloc_blend_options(&options) == SAIL_OK);
+
+    /* 16-bit. */
+    {
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP48_RGB, options, &image_output) == SAIL_OK);
+
+        const uint16_t *output = image_output->pixels;
+        munit_assert_uint16(output[0], ==, 2831);
+        munit_assert_uint16(output[1], ==, 19395);
+        munit_assert_uint16(output[2], ==, 29093);
+
+        sail_destroy_image(image_output);
+    }
+
+    /* 16-bit to 8-bit. */
+    {
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP24_RGB, options, &image_output) == SAIL_OK);
+
+        const uint8_t expected[] = { 11, 75, 113 };
+        munit_assert_memory_equal(sizeof(expected), image_output->pixels, expected);
+
+        sail_destroy_image(image_output);
+    }
+
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/gray",         test_gray,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/blend-uint8",  test_blend_uint8,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/blend-uint16", test_blend_uint16, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/fixed-point",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,412 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+#define MAX_WIDTH 40
+
+/* Converts a single row. */
+static sail_status_t convert(enum SailPixelFormat input_pixel_format, const void *input,
+                                enum SailPixelFormat output_pixel_format, void *output,
+                                unsigned width, const struct sail_conversion_options *options) {
+
+    return sail_convert_pixels(input_pixel_format, input, sail_bytes_per_line(width, input_pixel_format),
+                                output_pixel_format, output, sail_bytes_per_line(width, output_pixel_format),
+                                width, 1, NULL, options);
+}
+
+/* Same float operations as the library does. */
+static unsigned float_to_uint_reference(float value, float max) {
+
+    value = value > 0.0f ? value : 0.0f;
+    value = value < 1.0f ? value : 1.0f;
+
+    return (unsigned)(value * max + 0.5f);
+}
+
+static float tone_map_factor_reference(const float *pixel, float white) {
+
+    float m = pixel[0] > pixel[1] ? pixel[0] : pixel[1];
+    m = m > pixel[2] ? m : pixel[2];
+    m = m > 0.0f ? m : 0.0f;
+
+    return (1.0f + m * (1.0f / (white * white))) / (1.0f + m);
+}
+
+/* Multiples of 1/256 below 4.5 with some negative values. They're exact in half-float. */
+static void fill_values(float *values, unsigned count, unsigned seed) {
+
+    for (unsigned i = 0; i < count; i++) {
+        const unsigned n = (i * 197 + seed * 31) % 1152;
+        values[i] = (i % 11 == 5) ? -(float)n / 256.0f : (float)n / 256.0f;
+    }
+}
+
+static unsigned channels_of(enum SailPixelFormat pixel_format) {
+
+    return (pixel_format == SAIL_PIXEL_FORMAT_BPP48_RGB_HALF || pixel_format == SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT) ? 3 : 4;
+}
+
+/* Converts float values into the input pixel format, then into the output pixel format, and checks the result. */
+static void check_conversion(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format,
+                                unsigned width, const struct sail_conversion_options *options, float white) {
+
+    const unsigned channels = channels_of(input_pixel_format);
+    const unsigned count = width * channels;
+    const enum SailPixelFormat float_pixel_format = (channels == 3) ? SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT : SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT;
+
+    float values[MAX_WIDTH * 4];
+    fill_values(values, count, width);
+
+    uint8_t input[MAX_WIDTH * 4 * sizeof(float)];
+
+    if (input_pixel_format == float_pixel_format) {
+        memcpy(input, values, count * sizeof(float));
+    } else {
+        munit_assert(convert(float_pixel_format, values, input_pixel_format, input, width, NULL) == SAIL_OK);
+
+        /* The values are exact in half-float. */
+        float round_trip[MAX_WIDTH * 4];
+        munit_assert(convert(input_pixel_format, input, float_pixel_format, round_trip, width, NULL) == SAIL_OK);
+        munit_assert_memory_equal(count * sizeof(float), round_trip, values);
+    }
+
+    uint8_t output[MAX_WIDTH * 4 * sizeof(uint16_t)];
+    munit_assert(convert(input_pixel_format, input, output_pixel_format, output, width, options) == SAIL_OK);
+
+    const bool output8 = sail_bits_per_pixel(output_pixel_format) / channels == 8;
+    const float max = output8 ? 255.0f : 65535.0f;
+
+    for (unsigned column = 0; column < width; column++) {
+        float pixel[4];
+        memcpy(pixel, values + column * channels, channels * sizeof(float));
+
+        if (white > 0) {
+            const float factor = tone_map_factor_reference(pixel, white);
+
+            pixel[0] *= factor;
+            pixel[1] *= factor;
+            pixel[2] *= factor;
+        }
+
+        for (unsigned c = 0; c < channels; c++) {
+            const unsigned index = column * channels + c;
+            const unsigned actual = output8 ? output[index] : ((const uint16_t *)output)[index];
+
+            munit_assert_uint(actual, ==, float_to_uint_reference(pixel[c], max));
+        }
+    }
+}
+
+static const enum SailPixelFormat FLOAT_PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP48_RGB_HALF,
+    SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,
+    SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT,
+    SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT,
+};
+
+static void integer_pixel_formats(enum SailPixelFormat pixel_format, enum SailPixelFormat integer_pixel_formats[2]) {
+
+    if (channels_of(pixel_format) == 3) {
+        integer_pixel_formats[0] = SAIL_PIXEL_FORMAT_BPP24_RGB;
+        integer_pixel_formats[1] = SAIL_PIXEL_FORMAT_BPP48_RGB;
+    } else {
+        integer_pixel_formats[0] = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+        integer_pixel_formats[1] = SAIL_PIXEL_FORMAT_BPP64_RGBA;
+    }
+}
+
+static MunitResult test_clip(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(FLOAT_PIXEL_FORMATS) / sizeof(FLOAT_PIXEL_FORMATS[0]); i++) {
+        enum SailPixelFormat outputs[2];
+        integer_pixel_formats(FLOAT_PIXEL_FORMATS[i], outputs);
+
+        for (unsigned width = 1; width <= MAX_WIDTH; width++) {
+            check_conversion(FLOAT_PIXEL_FORMATS[i], outputs[0], width, NULL, 0);
+            check_conversion(FLOAT_PIXEL_FORMATS[i], outputs[1], width, NULL, 0);
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_tone_map(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options = SAIL_CONVERSION_OPTION_TONE_MAP;
+
+    /* Zero white point means 4.0. */
+    const float whites[][2] = { { 0, 4 }, { 2.5f, 2.5f }, { 0.5f, 4 } };
+
+    for (size_t w = 0; w < sizeof(whites) / sizeof(whites[0]); w++) {
+        options->tone_map_white = whites[w][0];
+
+        for (size_t i = 0; i < sizeof(FLOAT_PIXEL_FORMATS) / sizeof(FLOAT_PIXEL_FORMATS[0]); i++) {
+            enum SailPixelFormat outputs[2];
+            integer_pixel_formats(FLOAT_PIXEL_FORMATS[i], outputs);
+
+            for (unsigned width = 1; width <= MAX_WIDTH; width++) {
+                check_conversion(FLOAT_PIXEL_FORMATS[i], outputs[0], width, options, whites[w][1]);
+                check_conversion(FLOAT_PIXEL_FORMATS[i], outputs[1], width, options, whites[w][1]);
+            }
+        }
+    }
+
+    /* The white point becomes white, the hue is kept, and alpha is not touched. */
+    const float pixel[4] = { 4.0f, 2.0f, 0.0f, 0.5f };
+    uint8_t output[4];
+    options->tone_map_white = 0;
+    munit_assert(convert(SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, pixel, SAIL_PIXEL_FORMAT_BPP32_RGBA, output, 1, options) == SAIL_OK);
+    munit_assert_uint8(output[0], ==, 255);
+    munit_assert_uint8(output[1], ==, 128);
+    munit_assert_uint8(output[2], ==, 0);
+    munit_assert_uint8(output[3], ==, 128);
+
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_special_values(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* 0, 0.5, 1, 2, -1, 65504, infinity, NaN. */
+    const uint16_t halves[8] = { 0x0000, 0x3800, 0x3C00, 0x4000, 0xBC00, 0x7BFF, 0x7C00, 0x7E00 };
+    const uint8_t expected[8] = { 0, 128, 255, 255, 0, 255, 255, 0 };
+
+    uint8_t output[8];
+    munit_assert(convert(SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, halves, SAIL_PIXEL_FORMAT_BPP32_RGBA, output, 2, NULL) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(expected), output, expected);
+
+    float floats[8];
+    munit_assert(convert(SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, halves, SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, floats, 2, NULL) == SAIL_OK);
+    munit_assert(floats[0] == 0.0f && floats[1] == 0.5f && floats[2] == 1.0f && floats[3] == 2.0f);
+    munit_assert(floats[4] == -1.0f && floats[5] == 65504.0f && isinf(floats[6]) && isnan(floats[7]));
+
+    /* Rounding to nearest even, overflow, and subnormals. */
+    const float to_round[8] = { 1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, 65520.0f, 1e-7f, 5.9604645e-8f, -0.0f, 3.0f, 2.9802322e-8f };
+    const uint16_t rounded[8] = { 0x3C00, 0x3C02, 0x7C00, 0x0002, 0x0001, 0x8000, 0x4200, 0x0000 };
+    uint16_t output16[8];
+    munit_assert(convert(SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, to_round, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, output16, 2, NULL) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(rounded), output16, rounded);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_generic(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* 8-bit values survive a round trip through every floating point pixel format. */
+    uint8_t rgba[256 * 4];
+    for (unsigned i = 0; i < 256; i++) {
+        rgba[i * 4 + 0] = (uint8_t)i;
+        rgba[i * 4 + 1] = (uint8_t)(255 - i);
+        rgba[i * 4 + 2] = (uint8_t)(i * 7);
+        rgba[i * 4 + 3] = (uint8_t)(i * 13);
+    }
+
+    for (size_t i = 0; i < sizeof(FLOAT_PIXEL_FORMATS) / sizeof(FLOAT_PIXEL_FORMATS[0]); i++) {
+        const enum SailPixelFormat output_pixel_format = channels_of(FLOAT_PIXEL_FORMATS[i]) == 3 ? SAIL_PIXEL_FORMAT_BPP24_RGB : SAIL_PIXEL_FORMAT_BPP32_RGBA;
+        const unsigned channels = channels_of(FLOAT_PIXEL_FORMATS[i]);
+
+        munit_assert(sail_can_convert(SAIL_PIXEL_FORMAT_BPP32_RGBA, FLOAT_PIXEL_FORMATS[i]));
+        munit_assert(sail_can_convert(FLOAT_PIXEL_FORMATS[i], SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE));
+
+        uint8_t floating_point[256 * 4 * sizeof(float)];
+        uint8_t output[256 * 4];
+        munit_assert(convert(SAIL_PIXEL_FORMAT_BPP32_RGBA, rgba, FLOAT_PIXEL_FORMATS[i], floating_point, 256, NULL) == SAIL_OK);
+        munit_assert(convert(FLOAT_PIXEL_FORMATS[i], floating_point, output_pixel_format, output, 256, NULL) == SAIL_OK);
+
+        for (unsigned p = 0; p < 256; p++) {
+            munit_assert_memory_equal(channels, output + p * channels, rgba + p * 4);
+        }
+    }
+
+    /* Generic conversion through the intermediate pixels. */
+    const float pixels[8] = { 1.0f, 0.0f, 0.0f, 1.0f, 2.0f, 2.0f, 2.0f, 0.0f };
+    uint8_t bgr[6];
+    munit_assert(convert(SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, pixels, SAIL_PIXEL_FORMAT_BPP24_BGR, bgr, 2, NULL) == SAIL_OK);
+    munit_assert_uint8(bgr[0], ==, 0);
+    munit_assert_uint8(bgr[2], ==, 255);
+    munit_assert_uint8(bgr[3], ==, 255);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_update_in_place(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width = 33;
+    image->height = 5;
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    float *values = image->pixels;
+    for (unsigned i = 0; i < image->width * image->height * 4; i++) {
+        values[i] = (float)(i % 256) / 255.0f;
+    }
+
+    munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF) == SAIL_OK);
+    munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA) == SAIL_OK);
+    munit_assert(image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned i = 0; i < image->width * 4; i++) {
+            munit_assert_uint8(scan[i], ==, (row * image->width * 4 + i) % 256);
+        }
+    }
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* Indexed and grayscale images are converted with lookup tables of up to 16-byte pixels. */
+static MunitResult test_lookup_table(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    static const enum SailPixelFormat INPUT_PIXEL_FORMATS[] = {
+        SAIL_PIXEL_FORMAT_BPP8_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    };
+
+    /* 12 and 16-byte pixels. */
+    static const enum SailPixelFormat OUTPUT_PIXEL_FORMATS[] = {
+        SAIL_PIXEL_FORMAT_BPP96_RGB_FLOAT,
+        SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT,
+    };
+
+    for (size_t i = 0; i < sizeof(INPUT_PIXEL_FORMATS) / sizeof(INPUT_PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image;
+        munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+        image->width = 256;
+        image->height = 3;
+        image->pixel_format = INPUT_PIXEL_FORMATS[i];
+        image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+        munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            uint8_t *scan = sail_scan_line(image, row);
+
+            for (unsigned column = 0; column < image->width; column++) {
+                scan[column] = (uint8_t)column;
+            }
+        }
+
+        if (sail_is_indexed(image->pixel_format)) {
+            munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 256, &image->palette) == SAIL_OK);
+
+            uint8_t *entry = image->palette->data;
+            for (unsigned c = 0; c < 256; c++, entry += 3) {
+                entry[0] = (uint8_t)c;
+                entry[1] = (uint8_t)(255 - c);
+                entry[2] = (uint8_t)(c * 7);
+            }
+        }
+
+        for (size_t f = 0; f < sizeof(OUTPUT_PIXEL_FORMATS) / sizeof(OUTPUT_PIXEL_FORMATS[0]); f++) {
+            struct sail_image *image_float;
+            munit_assert(sail_convert_image(image, OUTPUT_PIXEL_FORMATS[f], &image_float) == SAIL_OK);
+
+            const unsigned channels = channels_of(OUTPUT_PIXEL_FORMATS[f]);
+
+            for (unsigned row = 0; row < image->height; row++) {
+                const float *pixel = sail_scan_line(image_float, row);
+
+                for (unsigned column = 0; column < image->width; column++, pixel += channels) {
+                    const uint8_t *expected = sail_is_indexed(image->pixel_format)
+                                                ? (const uint8_t *)image->palette->data + column * 3
+                                                : (const uint8_t[3]){ (uint8_t)column, (uint8_t)column, (uint8_t)column };
+
+                    for (unsigned c = 0; c < 3; c++) {
+                        munit_assert_float(fabsf(pixel[c] - expected[c] / 255.0f), <, 1e-6f);
+                    }
+
+                    if (channels == 4) {
+                        munit_assert_float(pixel[3], ==, 1.0f);
+                    }
+                }
+            }
+
+            sail_destroy_image(image_float);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/clip",             test_clip,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/tone-map",         test_tone_map,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/special-values",   test_special_values,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/generic",          test_generic,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/update-in-place",  test_update_in_place,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/lookup-table",     test_lookup_table,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/float-conversion",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,405 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static double srgb_to_linear(double value) {
+
+    return (value <= 0.04045) ? value / 12.92 : pow((value + 0.055) / 1.055, 2.4);
+}
+
+static double linear_to_srgb(double value) {
+
+    return (value <= 0.0031308) ? value * 12.92 : 1.055 * pow(value, 1 / 2.4) - 0.055;
+}
+
+static sail_status_t alloc_options(int options, struct sail_conversion_options **conversion_options) {
+
+    SAIL_TRY(sail_alloc_conversion_options(conversion_options));
+    (*conversion_options)->options = options;
+
+    return SAIL_OK;
+}
+
+/* Luma of every RGB pixel is computed in linear light. */
+static MunitResult test_gray(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(alloc_options(SAIL_CONVERSION_OPTION_LINEAR_LIGHT, &options) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 256, 3, 0, &image) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++, scan += 3) {
+            scan[0] = (uint8_t)column;
+            scan[1] = (uint8_t)(column * (row + 3));
+            scan[2] = (uint8_t)(255 - column * row);
+        }
+    }
+
+    struct sail_image *gray8;
+    struct sail_image *gray16;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &gray8) == SAIL_OK);
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, options, &gray16) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+        const uint8_t *scan8 = sail_scan_line(gray8, row);
+        const uint16_t *scan16 = sail_scan_line(gray16, row);
+
+        for (unsigned column = 0; column < image->width; column++, scan += 3) {
+            const double luma = 0.299 * srgb_to_linear(scan[0] / 255.0)
+                                + 0.587 * srgb_to_linear(scan[1] / 255.0)
+                                + 0.114 * srgb_to_linear(scan[2] / 255.0);
+
+            munit_assert_double(fabs(scan8[column] - linear_to_srgb(luma) * 255), <=, 1);
+            munit_assert_double(fabs(scan16[column] - linear_to_srgb(luma) * 65535), <=, 64);
+        }
+    }
+
+    /* Red becomes much lighter than in gamma-encoded values. */
+    const uint8_t red[3] = { 255, 0, 0 };
+    uint8_t gray;
+    munit_assert(sail_convert_pixels(SAIL_PIXEL_FORMAT_BPP24_RGB, red, 3, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &gray, 1, 1, 1, NULL, options) == SAIL_OK);
+    munit_assert_uint8(gray, ==, 149);
+    munit_assert(sail_convert_pixels(SAIL_PIXEL_FORMAT_BPP24_RGB, red, 3, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &gray, 1, 1, 1, NULL, NULL) == SAIL_OK);
+    munit_assert_uint8(gray, ==, 76);
+
+    sail_destroy_image(gray16);
+    sail_destroy_image(gray8);
+    sail_destroy_image(image);
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+/* Alpha is blended in linear light. Opaque pixels are not changed. */
+static MunitResult test_blend(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(alloc_options(SAIL_CONVERSION_OPTION_BLEND_ALPHA | SAIL_CONVERSION_OPTION_LINEAR_LIGHT, &options) == SAIL_OK);
+    options->background24 = (sail_rgb24_t){ 0, 128, 255 };
+    options->background48 = (sail_rgb48_t){ 0, 128 * 257, 65535 };
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 256, 256, 0, &image) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++, scan += 4) {
+            scan[0] = (uint8_t)column;
+            scan[1] = (uint8_t)(column * 3);
+            scan[2] = (uint8_t)(255 - column);
+            scan[3] = (uint8_t)row;
+        }
+    }
+
+    static const enum SailPixelFormat OUTPUT_PIXEL_FORMATS[] = {
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP24_BGR,
+        SAIL_PIXEL_FORMAT_BPP32_RGBX,
+        SAIL_PIXEL_FORMAT_BPP48_RGB,
+    };
+
+    for (size_t i = 0; i < sizeof(OUTPUT_PIXEL_FORMATS) / sizeof(OUTPUT_PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, OUTPUT_PIXEL_FORMATS[i], options, &image_output) == SAIL_OK);
+
+        struct sail_image *rgb48;
+        munit_assert(sail_convert_image(image_output, SAIL_PIXEL_FORMAT_BPP48_RGB, &rgb48) == SAIL_OK);
+
+        const bool output8 = OUTPUT_PIXEL_FORMATS[i] != SAIL_PIXEL_FORMAT_BPP48_RGB;
+
+        for (unsigned row = 0; row < image->height; row++) {
+            const uint8_t *scan = sail_scan_line(image, row);
+            const uint16_t *scan_output = sail_scan_line(rgb48, row);
+
+            for (unsigned column = 0; column < image->width; column++, scan += 4, scan_output += 3) {
+                const double background[3] = { 0, 128 / 255.0, 1 };
+
+                for (unsigned c = 0; c < 3; c++) {
+                    const double opacity = scan[3] / 255.0;
+                    const double linear = srgb_to_linear(scan[c] / 255.0) * opacity + srgb_to_linear(background[c]) * (1 - opacity);
+                    const double actual = output8 ? scan_output[c] / 257 : scan_output[c];
+                    const double expected = linear_to_srgb(linear) * (output8 ? 255 : 65535);
+
+                    if (scan[3] == 255) {
+                        munit_assert_double(actual, ==, output8 ? scan[c] : scan[c] * 257);
+                    } else {
+                        munit_assert_double(fabs(actual - expected), <=, output8 ? 1 : 64);
+                    }
+                }
+            }
+        }
+
+        sail_destroy_image(rgb48);
+        sail_destroy_image(image_output);
+    }
+
+    /* Half-transparent white over black. */
+    const uint8_t pixel[4] = { 255, 255, 255, 128 };
+    uint8_t rgb[3];
+    options->background24 = (sail_rgb24_t){ 0, 0, 0 };
+    munit_assert(sail_convert_pixels(SAIL_PIXEL_FORMAT_BPP32_RGBA, pixel, 4, SAIL_PIXEL_FORMAT_BPP24_RGB, rgb, 3, 1, 1, NULL, options) == SAIL_OK);
+    munit_assert_uint8(rgb[0], ==, 188);
+    munit_assert_uint8(rgb[1], ==, 188);
+    munit_assert_uint8(rgb[2], ==, 188);
+
+    /* In place. */
+    munit_assert(sail_update_image_with_options(image, SAIL_PIXEL_FORMAT_BPP24_RGB, options) == SAIL_OK);
+    const uint8_t *scan = sail_scan_line(image, 128);
+    munit_assert_uint8(scan[255 * 3 + 0], ==, 188);
+
+    sail_destroy_image(image);
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+/* Palette colors are blended in linear light too. */
+static MunitResult test_indexed(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(alloc_options(SAIL_CONVERSION_OPTION_BLEND_ALPHA | SAIL_CONVERSION_OPTION_LINEAR_LIGHT, &options) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP8_INDEXED, 256, 1, 0, &image) == SAIL_OK);
+    sail_destroy_palette(image->palette);
+    munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP32_RGBA, 256, &image->palette) == SAIL_OK);
+
+    struct sail_image *rgba;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 256, 1, 0, &rgba) == SAIL_OK);
+
+    uint8_t *entry = image->palette->data;
+    uint8_t *scan = image->pixels;
+    uint8_t *scan_rgba = rgba->pixels;
+
+    for (unsigned i = 0; i < 256; i++, entry += 4, scan_rgba += 4) {
+        entry[0] = scan_rgba[0] = (uint8_t)i;
+        entry[1] = scan_rgba[1] = (uint8_t)(i * 5);
+        entry[2] = scan_rgba[2] = (uint8_t)(255 - i);
+        entry[3] = scan_rgba[3] = (uint8_t)(i * 11);
+        scan[i] = (uint8_t)i;
+    }
+
+    static const enum SailPixelFormat OUTPUT_PIXEL_FORMATS[] = {
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP48_BGR,
+    };
+
+    for (size_t i = 0; i < sizeof(OUTPUT_PIXEL_FORMATS) / sizeof(OUTPUT_PIXEL_FORMATS[0]); i++) {
+        struct sail_image *from_indexed;
+        struct sail_image *from_rgba;
+        munit_assert(sail_convert_image_with_options(image, OUTPUT_PIXEL_FORMATS[i], options, &from_indexed) == SAIL_OK);
+        munit_assert(sail_convert_image_with_options(rgba, OUTPUT_PIXEL_FORMATS[i], options, &from_rgba) == SAIL_OK);
+
+        munit_assert_memory_equal(from_rgba->bytes_per_line, from_indexed->pixels, from_rgba->pixels);
+
+        sail_destroy_image(from_rgba);
+        sail_destroy_image(from_indexed);
+    }
+
+    sail_destroy_image(rgba);
+    sail_destroy_image(image);
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+/* Encoding and decoding gammas, gamma from the options, and the default gamma. */
+static MunitResult test_gamma(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(alloc_options(SAIL_CONVERSION_OPTION_LINEAR_LIGHT, &options) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 1, 1, 0, &image) == SAIL_OK);
+    memcpy(image->pixels, (const uint8_t[]){ 255, 0, 0 }, 3);
+
+    const double gammas[][2] = {
+        /* Image gamma, options gamma. */
+        { 2.2, 0 },
+        { 1 / 2.2, 0 },
+        { 1, 2.2 },
+    };
+
+    const unsigned expected_gamma22 = (unsigned)floor(pow(0.299, 1 / 2.2) * 255 + 0.5);
+
+    for (size_t i = 0; i < sizeof(gammas) / sizeof(gammas[0]); i++) {
+        image->gamma = gammas[i][0];
+        options->gamma = gammas[i][1];
+
+        struct sail_image *gray;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &gray) == SAIL_OK);
+        munit_assert_uint(*(uint8_t *)gray->pixels, ==, expected_gamma22);
+        sail_destroy_image(gray);
+    }
+
+    /* The default gamma means sRGB. */
+    image->gamma = 1;
+    options->gamma = 0;
+
+    struct sail_image *gray;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &gray) == SAIL_OK);
+    munit_assert_uint8(*(uint8_t *)gray->pixels, ==, 149);
+    sail_destroy_image(gray);
+
+    /* Conversions that don't mix channels are not affected. */
+    struct sail_image *bgr;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP48_BGR, options, &bgr) == SAIL_OK);
+    munit_assert_uint16(((uint16_t *)bgr->pixels)[2], ==, 65535);
+    munit_assert_uint16(((uint16_t *)bgr->pixels)[0], ==, 0);
+    sail_destroy_image(bgr);
+
+    sail_destroy_image(image);
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+/* A black and white checkerboard is downscaled into the middle gray in linear light. */
+static MunitResult test_scale(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    static const enum SailPixelFormat PIXEL_FORMATS[] = {
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP32_BGRA,
+        SAIL_PIXEL_FORMAT_BPP48_RGB,
+        SAIL_PIXEL_FORMAT_BPP64_RGBA,
+    };
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        const enum SailPixelFormat pixel_format = PIXEL_FORMATS[i];
+
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(pixel_format, 16, 16, 0, &image) == SAIL_OK);
+
+        const bool bytes16 = pixel_format == SAIL_PIXEL_FORMAT_BPP48_RGB || pixel_format == SAIL_PIXEL_FORMAT_BPP64_RGBA;
+        const unsigned values_per_pixel = sail_bits_per_pixel(pixel_format) / (bytes16 ? 16 : 8);
+        const bool has_alpha = pixel_format == SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA || pixel_format == SAIL_PIXEL_FORMAT_BPP32_BGRA
+                                || pixel_format == SAIL_PIXEL_FORMAT_BPP64_RGBA;
+
+        for (unsigned row = 0; row < image->height; row++) {
+            uint8_t *scan = sail_scan_line(image, row);
+
+            for (unsigned column = 0; column < image->width; column++) {
+                const unsigned value = ((row + column) % 2 == 0) ? (bytes16 ? 65535 : 255) : 0;
+
+                for (unsigned c = 0; c < values_per_pixel; c++) {
+                    const bool alpha = has_alpha && c == values_per_pixel - 1;
+                    const unsigned v = alpha ? (bytes16 ? 65535 : 255) : value;
+
+                    if (bytes16) {
+                        ((uint16_t *)scan)[column * values_per_pixel + c] = (uint16_t)v;
+                    } else {
+                        scan[column * values_per_pixel + c] = (uint8_t)v;
+                    }
+                }
+            }
+        }
+
+        struct sail_image *scaled;
+        munit_assert(sail_scale_image_linear(image, 4, 4, SAIL_SCALING_BOX, &scaled) == SAIL_OK);
+        munit_assert(scaled->pixel_format == pixel_format);
+        munit_assert_uint(scaled->width, ==, 4);
+
+        for (unsigned row = 0; row < scaled->height; row++) {
+            const uint8_t *scan = sail_scan_line(scaled, row);
+
+            for (unsigned k = 0; k < scaled->width * values_per_pixel; k++) {
+                const bool alpha = has_alpha && k % values_per_pixel == values_per_pixel - 1;
+
+                if (bytes16) {
+                    munit_assert_uint16(((const uint16_t *)scan)[k], ==, alpha ? 65535 : (uint16_t)floor(linear_to_srgb(0.5) * 65535 + 0.5));
+                } else {
+                    munit_assert_uint8(scan[k], ==, alpha ? 255 : 188);
+                }
+            }
+        }
+
+        sail_destroy_image(scaled);
+        sail_destroy_image(image);
+    }
+
+    /* Premultiplied pixels are not supported. */
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, 2, 2, 0, &image) == SAIL_OK);
+    struct sail_image *scaled;
+    munit_assert(sail_scale_image_linear(image, 1, 1, SAIL_SCALING_BOX, &scaled) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/gray",    test_gray,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/blend",   test_blend,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/indexed", test_indexed, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/gamma",   test_gamma,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/scale",   test_scale,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/linear-light",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
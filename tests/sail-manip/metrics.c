@@ -0,0 +1,285 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static uint32_t next_random(uint32_t *seed) {
+
+    *seed = *seed * 1664525u + 1013904223u;
+
+    return *seed >> 24;
+}
+
+/* Gradient with the specified amount of noise. */
+static struct sail_image* noisy_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height,
+                                       unsigned noise, uint32_t seed) {
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(pixel_format, width, height, 0, &image) == SAIL_OK);
+
+    const unsigned channels = sail_bits_per_pixel(pixel_format) / 8;
+
+    for (unsigned row = 0; row < height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < width; column++) {
+            for (unsigned c = 0; c < channels; c++) {
+                int value = (int)((column * 255 / width + row * 255 / height + c * 40) % 256);
+
+                if (noise > 0) {
+                    value += (int)(next_random(&seed) % (2 * noise + 1)) - (int)noise;
+                }
+
+                *scan++ = (uint8_t)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+            }
+        }
+    }
+
+    return image;
+}
+
+/* Straightforward SSIM over 8x8 windows placed every 4 pixels of grayscale images. */
+static double reference_ssim(const struct sail_image *image1, const struct sail_image *image2) {
+
+    const double c1 = (0.01 * 255) * (0.01 * 255);
+    const double c2 = (0.03 * 255) * (0.03 * 255);
+
+    double sum = 0;
+    unsigned windows = 0;
+
+    for (unsigned y = 0; y + 8 <= image1->height / 4 * 4; y += 4) {
+        for (unsigned x = 0; x + 8 <= image1->width / 4 * 4; x += 4) {
+            double s1 = 0, s2 = 0, ss = 0, s12 = 0;
+
+            for (unsigned row = y; row < y + 8; row++) {
+                const uint8_t *scan1 = sail_scan_line(image1, row);
+                const uint8_t *scan2 = sail_scan_line(image2, row);
+
+                for (unsigned column = x; column < x + 8; column++) {
+                    s1  += scan1[column];
+                    s2  += scan2[column];
+                    ss  += scan1[column] * scan1[column] + scan2[column] * scan2[column];
+                    s12 += scan1[column] * scan2[column];
+                }
+            }
+
+            const double mean1 = s1 / 64;
+            const double mean2 = s2 / 64;
+            const double variances = ss / 64 - mean1 * mean1 - mean2 * mean2;
+            const double covariance = s12 / 64 - mean1 * mean2;
+
+            sum += ((2 * mean1 * mean2 + c1) * (2 * covariance + c2)) /
+                    ((mean1 * mean1 + mean2 * mean2 + c1) * (variances + c2));
+            windows++;
+        }
+    }
+
+    return sum / windows;
+}
+
+static MunitResult test_psnr(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Odd sizes leave samples for the scalar loops. */
+    struct sail_image *image1 = noisy_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 301, 77, 20, 1);
+    struct sail_image *image2 = noisy_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 301, 77, 20, 2);
+
+    double psnr;
+    munit_assert(sail_compute_psnr(image1, image1, &psnr) == SAIL_OK);
+    munit_assert(isinf(psnr));
+
+    uint64_t sum = 0;
+
+    for (unsigned row = 0; row < image1->height; row++) {
+        const uint8_t *scan1 = sail_scan_line(image1, row);
+        const uint8_t *scan2 = sail_scan_line(image2, row);
+
+        for (unsigned i = 0; i < image1->width * 3; i++) {
+            const int diff = (int)scan1[i] - (int)scan2[i];
+            sum += (uint64_t)(diff * diff);
+        }
+    }
+
+    const double expected = 10 * log10(255.0 * 255.0 / ((double)sum / (image1->width * 3.0 * image1->height)));
+
+    munit_assert(sail_compute_psnr(image1, image2, &psnr) == SAIL_OK);
+    munit_assert_double_equal(psnr, expected, 9);
+
+    /* Every sample differs by one. */
+    struct sail_image *image3 = noisy_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 1000, 3, 0, 0);
+    struct sail_image *image4 = noisy_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 1000, 3, 0, 0);
+
+    for (unsigned row = 0; row < image4->height; row++) {
+        uint8_t *scan = sail_scan_line(image4, row);
+
+        for (unsigned column = 0; column < image4->width; column++) {
+            scan[column] = (uint8_t)((scan[column] == 255) ? 254 : scan[column] + 1);
+        }
+    }
+
+    munit_assert(sail_compute_psnr(image3, image4, &psnr) == SAIL_OK);
+    munit_assert_double_equal(psnr, 10 * log10(255.0 * 255.0), 9);
+
+    sail_destroy_image(image4);
+    sail_destroy_image(image3);
+    sail_destroy_image(image2);
+    sail_destroy_image(image1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_ssim(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = noisy_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 203, 150, 0, 0);
+
+    double ssim;
+    munit_assert(sail_compute_ssim(image, image, &ssim) == SAIL_OK);
+    munit_assert_double_equal(ssim, 1.0, 12);
+
+    double previous = 1.0;
+
+    for (unsigned noise = 4; noise <= 64; noise *= 4) {
+        struct sail_image *noisy = noisy_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 203, 150, noise, noise);
+
+        munit_assert(sail_compute_ssim(image, noisy, &ssim) == SAIL_OK);
+        munit_assert_double_equal(ssim, reference_ssim(image, noisy), 9);
+
+        /* More noise, lower similarity. */
+        munit_assert_double(ssim, <, previous);
+        previous = ssim;
+
+        sail_destroy_image(noisy);
+    }
+
+    /* Images smaller than a window. */
+    struct sail_image *small1 = noisy_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 7, 5, 0, 0);
+    struct sail_image *small2 = noisy_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 7, 5, 30, 3);
+
+    munit_assert(sail_compute_ssim(small1, small1, &ssim) == SAIL_OK);
+    munit_assert_double_equal(ssim, 1.0, 12);
+    munit_assert(sail_compute_ssim(small1, small2, &ssim) == SAIL_OK);
+    munit_assert_double(ssim, <, 1.0);
+
+    sail_destroy_image(small2);
+    sail_destroy_image(small1);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_threads(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image1 = noisy_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 640, 480, 10, 1);
+    struct sail_image *image2 = noisy_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 640, 480, 10, 2);
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+
+    double psnr_serial, psnr_parallel, ssim_serial, ssim_parallel;
+
+    options->max_threads = 1;
+    munit_assert(sail_compute_psnr_with_options(image1, image2, options, &psnr_serial) == SAIL_OK);
+    munit_assert(sail_compute_ssim_with_options(image1, image2, options, &ssim_serial) == SAIL_OK);
+
+    options->max_threads = 0;
+    munit_assert(sail_compute_psnr_with_options(image1, image2, options, &psnr_parallel) == SAIL_OK);
+    munit_assert(sail_compute_ssim_with_options(image1, image2, options, &ssim_parallel) == SAIL_OK);
+
+    munit_assert_double(psnr_serial, ==, psnr_parallel);
+    munit_assert_double_equal(ssim_serial, ssim_parallel, 12);
+
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image2);
+    sail_destroy_image(image1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_formats(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *rgb = noisy_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 64, 48, 10, 1);
+
+    /* Alpha is dropped, so the same colors give identical images. */
+    struct sail_image *bgra;
+    munit_assert(sail_convert_image(rgb, SAIL_PIXEL_FORMAT_BPP32_BGRA, &bgra) == SAIL_OK);
+
+    double psnr, ssim;
+    munit_assert(sail_compute_psnr(rgb, bgra, &psnr) == SAIL_OK);
+    munit_assert(isinf(psnr));
+    munit_assert(sail_compute_ssim(bgra, rgb, &ssim) == SAIL_OK);
+    munit_assert_double_equal(ssim, 1.0, 12);
+
+    struct sail_image *cropped = noisy_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 64, 47, 10, 1);
+
+    munit_assert(sail_compute_psnr(rgb, cropped, &psnr) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_compute_ssim(rgb, cropped, &ssim) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    sail_destroy_image(cropped);
+    sail_destroy_image(bgra);
+    sail_destroy_image(rgb);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/psnr",    test_psnr,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/ssim",    test_ssim,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/threads", test_threads, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/formats", test_formats, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/metrics",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
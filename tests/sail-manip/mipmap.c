@@ -0,0 +1,260 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static const enum SailScaling ALGORITHMS[] = {
+    SAIL_SCALING_NEAREST_NEIGHBOR,
+    SAIL_SCALING_BILINEAR,
+    SAIL_SCALING_BOX,
+    SAIL_SCALING_LANCZOS3,
+};
+
+static const enum SailPixelFormat PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,
+    SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA,
+    SAIL_PIXEL_FORMAT_BPP24_RGB,
+    SAIL_PIXEL_FORMAT_BPP48_BGR,
+    SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    SAIL_PIXEL_FORMAT_BPP64_ABGR,
+};
+
+/* Scan lines are padded to check that the padding is respected. */
+static const unsigned PADDING = 5;
+
+static unsigned channel_count(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:       return 1;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: return 2;
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_BGR:             return 3;
+
+        default: return 4;
+    }
+}
+
+/* Rounded averages of 2x2 blocks of 8 or 16-bit values. */
+static void assert_halved(const struct sail_image *image, const struct sail_image *level) {
+
+    munit_assert_uint(level->width * 2,  ==, image->width);
+    munit_assert_uint(level->height * 2, ==, image->height);
+
+    const unsigned channels = channel_count(image->pixel_format);
+    const unsigned bytes_per_channel = sail_bits_per_pixel(image->pixel_format) / 8 / channels;
+    const unsigned values = level->width * channels;
+
+    for (unsigned row = 0; row < level->height; row++) {
+        const uint8_t *top    = sail_scan_line(image, row * 2);
+        const uint8_t *bottom = sail_scan_line(image, row * 2 + 1);
+        const uint8_t *scan   = sail_scan_line(level, row);
+
+        for (unsigned i = 0; i < values; i++) {
+            const unsigned first = (i / channels) * 2 * channels + i % channels;
+            const unsigned second = first + channels;
+
+            if (bytes_per_channel == 1) {
+                munit_assert_uint8(scan[i], ==, (top[first] + top[second] + bottom[first] + bottom[second] + 2) / 4);
+            } else {
+                const uint16_t *top16    = (const uint16_t *)top;
+                const uint16_t *bottom16 = (const uint16_t *)bottom;
+
+                munit_assert_uint16(((const uint16_t *)scan)[i], ==,
+                                    (top16[first] + top16[second] + bottom16[first] + bottom16[second] + 2) / 4);
+            }
+        }
+    }
+}
+
+static MunitResult test_sizes(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 37, 19, PADDING, &image) == SAIL_OK);
+
+    static const unsigned EXPECTED[][2] = { { 18, 9 }, { 9, 4 }, { 4, 2 }, { 2, 1 }, { 1, 1 } };
+
+    struct sail_mipmap_chain *chain;
+    munit_assert(sail_generate_mipmaps(image, 0, SAIL_SCALING_BOX, &chain) == SAIL_OK);
+    munit_assert_uint(chain->levels_count, ==, 5);
+
+    for (unsigned i = 0; i < chain->levels_count; i++) {
+        munit_assert_uint(chain->levels[i]->width,  ==, EXPECTED[i][0]);
+        munit_assert_uint(chain->levels[i]->height, ==, EXPECTED[i][1]);
+        munit_assert(chain->levels[i]->pixel_format == image->pixel_format);
+        munit_assert_uint(chain->levels[i]->bytes_per_line, ==, sail_bytes_per_line(EXPECTED[i][0], image->pixel_format));
+    }
+
+    sail_destroy_mipmap_chain(chain);
+
+    /* The requested number of levels. */
+    munit_assert(sail_generate_mipmaps(image, 2, SAIL_SCALING_LANCZOS3, &chain) == SAIL_OK);
+    munit_assert_uint(chain->levels_count, ==, 2);
+    munit_assert_uint(chain->levels[1]->width, ==, 9);
+    sail_destroy_mipmap_chain(chain);
+
+    munit_assert(sail_generate_mipmaps(image, 100, SAIL_SCALING_BILINEAR, &chain) == SAIL_OK);
+    munit_assert_uint(chain->levels_count, ==, 5);
+    sail_destroy_mipmap_chain(chain);
+
+    sail_destroy_image(image);
+
+    /* Nothing to downscale. */
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 1, 1, PADDING, &image) == SAIL_OK);
+    munit_assert(sail_generate_mipmaps(image, 0, SAIL_SCALING_BOX, &chain) == SAIL_OK);
+    munit_assert_uint(chain->levels_count, ==, 0);
+    sail_destroy_mipmap_chain(chain);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* Levels with even input sizes average 2x2 blocks exactly. */
+static MunitResult test_box(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMATS[i], 168, 40, PADDING, &image) == SAIL_OK);
+
+        struct sail_mipmap_chain *chain;
+        munit_assert(sail_generate_mipmaps(image, 3, SAIL_SCALING_BOX, &chain) == SAIL_OK);
+        munit_assert_uint(chain->levels_count, ==, 3);
+
+        assert_halved(image, chain->levels[0]);
+
+        for (unsigned l = 1; l < chain->levels_count; l++) {
+            assert_halved(chain->levels[l - 1], chain->levels[l]);
+        }
+
+        sail_destroy_mipmap_chain(chain);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+/* Every level equals the previous level scaled with sail_scale_image() unless it's averaged from 2x2 blocks. */
+static MunitResult test_same_as_scale(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMATS[i], 75, 53, PADDING, &image) == SAIL_OK);
+
+        for (size_t a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+            struct sail_mipmap_chain *chain;
+            munit_assert(sail_generate_mipmaps(image, 0, ALGORITHMS[a], &chain) == SAIL_OK);
+            munit_assert_uint(chain->levels_count, ==, 6);
+
+            const struct sail_image *previous = image;
+
+            for (unsigned l = 0; l < chain->levels_count; l++) {
+                const struct sail_image *level = chain->levels[l];
+
+                if (ALGORITHMS[a] == SAIL_SCALING_BOX && previous->width % 2 == 0 && previous->height % 2 == 0) {
+                    assert_halved(previous, level);
+                } else {
+                    struct sail_image *expected;
+                    munit_assert(sail_scale_image(previous, level->width, level->height, ALGORITHMS[a], &expected) == SAIL_OK);
+
+                    sail_test_assert_images_equal(level, expected);
+                    sail_destroy_image(expected);
+                }
+
+                previous = level;
+            }
+
+            sail_destroy_mipmap_chain(chain);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_YCBCR, 16, 16, PADDING, &image) == SAIL_OK);
+
+    struct sail_mipmap_chain *chain = NULL;
+    munit_assert(sail_generate_mipmaps(image, 0, SAIL_SCALING_BOX, &chain) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert_null(chain);
+
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+    munit_assert(sail_generate_mipmaps(image, 0, (enum SailScaling)100, &chain) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert_null(chain);
+
+    munit_assert(sail_generate_mipmaps(image, 0, SAIL_SCALING_BOX, NULL) == SAIL_ERROR_NULL_PTR);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/sizes",         test_sizes,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/box",           test_box,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/same-as-scale", test_same_as_scale, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported",   test_unsupported,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/mipmap",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,222 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static const enum SailPixelFormat INDEXED_PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP1_INDEXED,
+    SAIL_PIXEL_FORMAT_BPP2_INDEXED,
+    SAIL_PIXEL_FORMAT_BPP4_INDEXED,
+    SAIL_PIXEL_FORMAT_BPP8_INDEXED,
+};
+
+static const enum SailPixelFormat GRAYSCALE_PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE,
+};
+
+/* Width that doesn't fill the last byte of 1, 2, and 4-bit scan lines. */
+static const unsigned WIDTH = 13;
+
+/* Random pixels with values in the [0; max_value] range. */
+static sail_status_t alloc_limited_image(enum SailPixelFormat pixel_format, unsigned max_value, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_test_alloc_image(pixel_format, WIDTH, 3, 0, &image_local));
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(pixel_format);
+
+    for (unsigned row = 0; row < image_local->height; row++) {
+        uint8_t *scan = sail_scan_line(image_local, row);
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            const unsigned bit_offset = column * bits_per_pixel;
+            const unsigned shift = 8 - bits_per_pixel - bit_offset % 8;
+            const unsigned mask = ((1U << bits_per_pixel) - 1) << shift;
+            const unsigned value = (unsigned)munit_rand_int_range(0, (int)max_value);
+
+            scan[bit_offset / 8] = (uint8_t)((scan[bit_offset / 8] & ~mask) | (value << shift));
+        }
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static unsigned pixel_value(const struct sail_image *image, unsigned row, unsigned column) {
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+    const unsigned bit_offset = column * bits_per_pixel;
+    const uint8_t *scan = sail_scan_line(image, row);
+
+    return (scan[bit_offset / 8] >> (8 - bits_per_pixel - bit_offset % 8)) & ((1U << bits_per_pixel) - 1);
+}
+
+static MunitResult test_indexed(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(INDEXED_PIXEL_FORMATS) / sizeof(INDEXED_PIXEL_FORMATS[0]); i++) {
+        const unsigned color_count = SAIL_MIN(1U << sail_bits_per_pixel(INDEXED_PIXEL_FORMATS[i]), 200U);
+
+        struct sail_image *image;
+        munit_assert(alloc_limited_image(INDEXED_PIXEL_FORMATS[i], color_count - 1, &image) == SAIL_OK);
+
+        sail_destroy_palette(image->palette);
+        munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP32_RGBA, color_count, &image->palette) == SAIL_OK);
+        munit_rand_memory((size_t)color_count * 4, image->palette->data);
+
+        /* RGBA. */
+        {
+            struct sail_image *image_output;
+            munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA, &image_output) == SAIL_OK);
+
+            for (unsigned row = 0; row < image->height; row++) {
+                const uint8_t *scan_output = sail_scan_line(image_output, row);
+
+                for (unsigned column = 0; column < WIDTH; column++) {
+                    const uint8_t *entry = (const uint8_t *)image->palette->data + pixel_value(image, row, column) * 4;
+                    const uint8_t expected[] = { entry[2], entry[1], entry[0], entry[3] };
+
+                    munit_assert_memory_equal(4, scan_output + column * 4, expected);
+                }
+            }
+
+            sail_destroy_image(image_output);
+        }
+
+        /* 16-bit RGB. */
+        {
+            struct sail_image *image_output;
+            munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP48_RGB, &image_output) == SAIL_OK);
+
+            for (unsigned row = 0; row < image->height; row++) {
+                const uint16_t *scan_output = sail_scan_line(image_output, row);
+
+                for (unsigned column = 0; column < WIDTH; column++) {
+                    const uint8_t *entry = (const uint8_t *)image->palette->data + pixel_value(image, row, column) * 4;
+
+                    munit_assert_uint16(scan_output[column * 3 + 0], ==, entry[0] * 257);
+                    munit_assert_uint16(scan_output[column * 3 + 1], ==, entry[1] * 257);
+                    munit_assert_uint16(scan_output[column * 3 + 2], ==, entry[2] * 257);
+                }
+            }
+
+            sail_destroy_image(image_output);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_indexed_out_of_range(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(alloc_limited_image(SAIL_PIXEL_FORMAT_BPP4_INDEXED, 3, &image) == SAIL_OK);
+
+    sail_destroy_palette(image->palette);
+    munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 4, &image->palette) == SAIL_OK);
+    memset(image->palette->data, 0, 4 * 3);
+
+    /* Index 9 is beyond the 4-color palette. */
+    uint8_t *scan = sail_scan_line(image, 1);
+    scan[2] = 0x19;
+
+    struct sail_image *image_output = NULL;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_output) == SAIL_ERROR_BROKEN_IMAGE);
+    munit_assert_null(image_output);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_grayscale(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(GRAYSCALE_PIXEL_FORMATS) / sizeof(GRAYSCALE_PIXEL_FORMATS[0]); i++) {
+        const unsigned max_value = (1U << sail_bits_per_pixel(GRAYSCALE_PIXEL_FORMATS[i])) - 1;
+
+        struct sail_image *image;
+        munit_assert(alloc_limited_image(GRAYSCALE_PIXEL_FORMATS[i], max_value, &image) == SAIL_OK);
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_output) == SAIL_OK);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            const uint8_t *scan_output = sail_scan_line(image_output, row);
+
+            for (unsigned column = 0; column < WIDTH; column++) {
+                const uint8_t value = (uint8_t)(pixel_value(image, row, column) * (255 / max_value));
+                const uint8_t expected[] = { value, value, value };
+
+                munit_assert_memory_equal(3, scan_output + column * 3, expected);
+            }
+        }
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/indexed",              test_indexed,              NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/indexed-out-of-range", test_indexed_out_of_range, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/grayscale",            test_grayscale,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/palette-conversion",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
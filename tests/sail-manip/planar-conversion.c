@@ -0,0 +1,248 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static const enum SailPixelFormat PLANAR_PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP12_YUV420P,
+    SAIL_PIXEL_FORMAT_BPP12_NV12,
+    SAIL_PIXEL_FORMAT_BPP24_YUV444P,
+};
+
+static MunitResult test_layout(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* 3x3 pixels with Y = index, Cb = 10 * index, Cr = 255 - index. */
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_YCBCR, 3, 3, 0, &image) == SAIL_OK);
+
+    for (unsigned row = 0; row < 3; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < 3; column++) {
+            const unsigned index = row * 3 + column;
+
+            scan[column * 3 + 0] = (uint8_t)index;
+            scan[column * 3 + 1] = (uint8_t)(10 * index);
+            scan[column * 3 + 2] = (uint8_t)(255 - index);
+        }
+    }
+
+    /* Chroma is averaged over 2x2 pixels, edges are replicated. */
+    static const uint8_t EXPECTED_I420[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8,
+        20, 35, 65, 80,
+        253, 252, 249, 247,
+    };
+    static const uint8_t EXPECTED_NV12[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8,
+        20, 253, 35, 252,
+        65, 249, 80, 247,
+    };
+
+    struct sail_image *image_output;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP12_YUV420P, &image_output) == SAIL_OK);
+    munit_assert_uint(image_output->bytes_per_line, ==, 3);
+    munit_assert_memory_equal(sizeof(EXPECTED_I420), image_output->pixels, EXPECTED_I420);
+    sail_destroy_image(image_output);
+
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP12_NV12, &image_output) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(EXPECTED_NV12), image_output->pixels, EXPECTED_NV12);
+    sail_destroy_image(image_output);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_round_trip(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Odd dimensions. Chroma is constant in 2x2 pixels, so subsampling is lossless. */
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_YCBCR, 37, 11, 0, &image) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+        const uint8_t *scan_even = sail_scan_line(image, row / 2 * 2);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan[column * 3 + 1] = scan_even[column / 2 * 2 * 3 + 1];
+            scan[column * 3 + 2] = scan_even[column / 2 * 2 * 3 + 2];
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(PLANAR_PIXEL_FORMATS) / sizeof(PLANAR_PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image_planar;
+        munit_assert(sail_convert_image(image, PLANAR_PIXEL_FORMATS[i], &image_planar) == SAIL_OK);
+
+        /* Between planar pixel formats. */
+        for (size_t k = 0; k < sizeof(PLANAR_PIXEL_FORMATS) / sizeof(PLANAR_PIXEL_FORMATS[0]); k++) {
+            struct sail_image *image_planar2;
+            munit_assert(sail_convert_image(image_planar, PLANAR_PIXEL_FORMATS[k], &image_planar2) == SAIL_OK);
+
+            struct sail_image *image_output;
+            munit_assert(sail_convert_image(image_planar2, SAIL_PIXEL_FORMAT_BPP24_YCBCR, &image_output) == SAIL_OK);
+
+            munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, image_output->pixels, image->pixels);
+
+            sail_destroy_image(image_output);
+            sail_destroy_image(image_planar2);
+        }
+
+        sail_destroy_image(image_planar);
+    }
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_rgb(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Use multiple threads and blocks even on single-core machines. */
+    sail_set_max_threads(4);
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 37, 1999, 0, &image) == SAIL_OK);
+
+    /* Without subsampling, the result matches the conversion through BPP24-YCbCr. */
+    {
+        struct sail_image *image_ycbcr;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_YCBCR, &image_ycbcr) == SAIL_OK);
+
+        struct sail_image *image_expected;
+        munit_assert(sail_convert_image(image_ycbcr, SAIL_PIXEL_FORMAT_BPP32_BGRA, &image_expected) == SAIL_OK);
+
+        struct sail_image *image_planar;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_YUV444P, &image_planar) == SAIL_OK);
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image_planar, SAIL_PIXEL_FORMAT_BPP32_BGRA, &image_output) == SAIL_OK);
+
+        munit_assert_memory_equal((size_t)image->height * image_output->bytes_per_line, image_output->pixels, image_expected->pixels);
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image_planar);
+        sail_destroy_image(image_expected);
+        sail_destroy_image(image_ycbcr);
+    }
+
+    /* Parallel conversion produces the same planes. */
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+
+    for (size_t i = 0; i < sizeof(PLANAR_PIXEL_FORMATS) / sizeof(PLANAR_PIXEL_FORMATS[0]); i++) {
+        options->max_threads = 1;
+
+        struct sail_image *image_serial;
+        munit_assert(sail_convert_image_with_options(image, PLANAR_PIXEL_FORMATS[i], options, &image_serial) == SAIL_OK);
+
+        options->max_threads = 4;
+
+        struct sail_image *image_parallel;
+        munit_assert(sail_convert_image_with_options(image, PLANAR_PIXEL_FORMATS[i], options, &image_parallel) == SAIL_OK);
+
+        munit_assert_memory_equal(sail_pixels_size(image->height, image_serial->bytes_per_line, PLANAR_PIXEL_FORMATS[i]),
+                                  image_parallel->pixels, image_serial->pixels);
+
+        sail_destroy_image(image_parallel);
+        sail_destroy_image(image_serial);
+    }
+
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+    sail_set_max_threads(0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_can_convert(SAIL_PIXEL_FORMAT_BPP12_NV12, SAIL_PIXEL_FORMAT_BPP64_RGBA));
+    munit_assert(sail_can_convert(SAIL_PIXEL_FORMAT_BPP8_INDEXED, SAIL_PIXEL_FORMAT_BPP12_YUV420P));
+    munit_assert(!sail_can_convert(SAIL_PIXEL_FORMAT_BPP24_CIE_LAB, SAIL_PIXEL_FORMAT_BPP12_YUV420P));
+    munit_assert(!sail_can_update(SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP24_YUV444P));
+    munit_assert(!sail_can_update(SAIL_PIXEL_FORMAT_BPP24_YUV444P, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE));
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 8, 8, 0, &image) == SAIL_OK);
+
+    munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP12_YUV420P) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    struct sail_image *image_output;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP12_YUV420P, &image_output) == SAIL_OK);
+
+    /* Planes can't be converted partially. */
+    struct sail_conversion_plan *plan;
+    munit_assert(sail_alloc_conversion_plan(image->pixel_format, image_output->pixel_format, image->width, NULL, NULL, &plan) == SAIL_OK);
+    munit_assert(sail_convert_rows_with_plan(plan, image, 2, 4, image_output) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert(sail_convert_image_with_plan(plan, image, image_output) == SAIL_OK);
+
+    sail_destroy_conversion_plan(plan);
+    sail_destroy_image(image_output);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/layout",      test_layout,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/round-trip",  test_round_trip,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/rgb",         test_rgb,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported", test_unsupported, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/planar-conversion",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,347 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static unsigned premultiply_reference(unsigned value, unsigned alpha, unsigned max_value) {
+
+    return (unsigned)(((uint64_t)value * alpha * 2 + max_value) / (2 * (uint64_t)max_value));
+}
+
+static unsigned unpremultiply_reference(unsigned value, unsigned alpha, unsigned max_value) {
+
+    if (alpha == 0) {
+        return 0;
+    }
+    if (value >= alpha) {
+        return max_value;
+    }
+
+    return (unsigned)(((uint64_t)value * max_value * 2 + alpha) / (2 * (uint64_t)alpha));
+}
+
+/* Every value with every alpha in all the color channels of a 256x256 image. Color channels greater than alpha are included. */
+static sail_status_t alloc_exhaustive_image8(enum SailPixelFormat pixel_format, struct sail_image **image) {
+
+    SAIL_TRY(sail_test_alloc_image(pixel_format, 256, 256, 0, image));
+
+    for (unsigned alpha = 0; alpha < 256; alpha++) {
+        uint8_t *scan = sail_scan_line(*image, alpha);
+
+        for (unsigned value = 0; value < 256; value++, scan += 4) {
+            scan[0] = (uint8_t)value;
+            scan[1] = (uint8_t)(255 - value);
+            scan[2] = (uint8_t)(value * 7);
+            scan[3] = (uint8_t)alpha;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static MunitResult test_exhaustive8(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(alloc_exhaustive_image8(SAIL_PIXEL_FORMAT_BPP32_RGBA, &image) == SAIL_OK);
+
+    struct sail_image *premultiplied;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, &premultiplied) == SAIL_OK);
+    munit_assert(premultiplied->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED);
+
+    /* The same values are treated as premultiplied ones too. */
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+
+    struct sail_image *unpremultiplied;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &unpremultiplied) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan                 = sail_scan_line(image, row);
+        const uint8_t *scan_premultiplied   = sail_scan_line(premultiplied, row);
+        const uint8_t *scan_unpremultiplied = sail_scan_line(unpremultiplied, row);
+
+        for (unsigned i = 0; i < image->width * 4; i += 4) {
+            const unsigned alpha = scan[i + 3];
+
+            for (unsigned c = 0; c < 3; c++) {
+                munit_assert_uint(scan_premultiplied[i + c], ==, premultiply_reference(scan[i + c], alpha, 255));
+                munit_assert_uint(scan_unpremultiplied[i + c], ==, unpremultiply_reference(scan[i + c], alpha, 255));
+            }
+
+            munit_assert_uint(scan_premultiplied[i + 3], ==, alpha);
+            munit_assert_uint(scan_unpremultiplied[i + 3], ==, alpha);
+        }
+    }
+
+    sail_destroy_image(unpremultiplied);
+    sail_destroy_image(premultiplied);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_widths(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Every number of pixels left after SIMD blocks. */
+    for (unsigned width = 1; width <= 40; width++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_BGRA, width, 3, 0, &image) == SAIL_OK);
+        munit_rand_memory((size_t)image->height * image->bytes_per_line, image->pixels);
+
+        struct sail_image *premultiplied;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED, &premultiplied) == SAIL_OK);
+
+        struct sail_image *unpremultiplied;
+        munit_assert(sail_convert_image(premultiplied, SAIL_PIXEL_FORMAT_BPP32_BGRA, &unpremultiplied) == SAIL_OK);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            const uint8_t *scan                 = sail_scan_line(image, row);
+            const uint8_t *scan_premultiplied   = sail_scan_line(premultiplied, row);
+            const uint8_t *scan_unpremultiplied = sail_scan_line(unpremultiplied, row);
+
+            for (unsigned i = 0; i < width * 4; i += 4) {
+                const unsigned alpha = scan[i + 3];
+
+                for (unsigned c = 0; c < 3; c++) {
+                    munit_assert_uint(scan_premultiplied[i + c], ==, premultiply_reference(scan[i + c], alpha, 255));
+                    munit_assert_uint(scan_unpremultiplied[i + c], ==, unpremultiply_reference(scan_premultiplied[i + c], alpha, 255));
+                }
+
+                munit_assert_uint(scan_premultiplied[i + 3], ==, alpha);
+                munit_assert_uint(scan_unpremultiplied[i + 3], ==, alpha);
+            }
+        }
+
+        sail_destroy_image(unpremultiplied);
+        sail_destroy_image(premultiplied);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_16bit(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP64_RGBA, 37, 29, 0, &image) == SAIL_OK);
+    munit_rand_memory((size_t)image->height * image->bytes_per_line, image->pixels);
+
+    /* Include the extreme alphas. */
+    uint16_t *pixels = image->pixels;
+    pixels[3] = 0;
+    pixels[7] = 1;
+    pixels[11] = 65535;
+
+    struct sail_image *premultiplied;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED, &premultiplied) == SAIL_OK);
+
+    struct sail_image *unpremultiplied;
+    munit_assert(sail_convert_image(premultiplied, SAIL_PIXEL_FORMAT_BPP64_RGBA, &unpremultiplied) == SAIL_OK);
+
+    struct sail_image *premultiplied_again;
+    munit_assert(sail_convert_image(unpremultiplied, SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED, &premultiplied_again) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint16_t *scan                 = sail_scan_line(image, row);
+        const uint16_t *scan_premultiplied   = sail_scan_line(premultiplied, row);
+        const uint16_t *scan_unpremultiplied = sail_scan_line(unpremultiplied, row);
+
+        for (unsigned i = 0; i < image->width * 4; i += 4) {
+            const unsigned alpha = scan[i + 3];
+
+            for (unsigned c = 0; c < 3; c++) {
+                munit_assert_uint(scan_premultiplied[i + c], ==, premultiply_reference(scan[i + c], alpha, 65535));
+                munit_assert_uint(scan_unpremultiplied[i + c], ==, unpremultiply_reference(scan_premultiplied[i + c], alpha, 65535));
+            }
+
+            munit_assert_uint(scan_unpremultiplied[i + 3], ==, alpha);
+        }
+    }
+
+    /* Unpremultiplying and premultiplying again restores valid premultiplied pixels. */
+    munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, premultiplied_again->pixels, premultiplied->pixels);
+
+    sail_destroy_image(premultiplied_again);
+    sail_destroy_image(unpremultiplied);
+    sail_destroy_image(premultiplied);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_round_trip8(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* All the valid premultiplied pixels. */
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, 256, 256, 0, &image) == SAIL_OK);
+
+    for (unsigned alpha = 0; alpha < 256; alpha++) {
+        uint8_t *scan = sail_scan_line(image, alpha);
+
+        for (unsigned value = 0; value < 256; value++, scan += 4) {
+            const uint8_t premultiplied_value = (uint8_t)((value <= alpha) ? value : alpha);
+
+            scan[0] = scan[1] = scan[2] = premultiplied_value;
+            scan[3] = (uint8_t)alpha;
+        }
+    }
+
+    struct sail_image *unpremultiplied;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &unpremultiplied) == SAIL_OK);
+
+    /* In place. */
+    munit_assert(sail_update_image(unpremultiplied, SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED) == SAIL_OK);
+    munit_assert(unpremultiplied->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED);
+
+    munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, unpremultiplied->pixels, image->pixels);
+
+    sail_destroy_image(unpremultiplied);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_other_formats(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 19, 7, 0, &image) == SAIL_OK);
+    munit_rand_memory((size_t)image->height * image->bytes_per_line, image->pixels);
+
+    struct sail_image *premultiplied;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, &premultiplied) == SAIL_OK);
+
+    /* Channels are reordered through the intermediate pixels with the same results. */
+    static const enum SailPixelFormat OUTPUT_PIXEL_FORMATS[] = {
+        SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED,
+        SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED,
+        SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED,
+    };
+
+    for (size_t f = 0; f < sizeof(OUTPUT_PIXEL_FORMATS) / sizeof(OUTPUT_PIXEL_FORMATS[0]); f++) {
+        munit_assert(sail_can_convert(SAIL_PIXEL_FORMAT_BPP32_RGBA, OUTPUT_PIXEL_FORMATS[f]));
+        munit_assert(sail_can_convert(OUTPUT_PIXEL_FORMATS[f], SAIL_PIXEL_FORMAT_BPP24_RGB));
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, OUTPUT_PIXEL_FORMATS[f], &image_output) == SAIL_OK);
+
+        struct sail_image *image_back;
+        munit_assert(sail_convert_image(image_output, SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, &image_back) == SAIL_OK);
+
+        const bool bgr = OUTPUT_PIXEL_FORMATS[f] != SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED;
+        const bool deep = OUTPUT_PIXEL_FORMATS[f] != SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED;
+
+        for (unsigned row = 0; row < image->height; row++) {
+            const uint8_t *scan_premultiplied = sail_scan_line(premultiplied, row);
+            const uint8_t *scan_output8       = sail_scan_line(image_output, row);
+            const uint16_t *scan_output16     = sail_scan_line(image_output, row);
+            const uint8_t *scan_back          = sail_scan_line(image_back, row);
+
+            for (unsigned column = 0; column < image->width; column++) {
+                const unsigned pixel = column * 4;
+
+                for (unsigned c = 0; c < 4; c++) {
+                    const unsigned output_c = (bgr && c < 3) ? 2 - c : c;
+
+                    if (deep) {
+                        /* 16-bit premultiplication is more precise. */
+                        const int difference = (int)(scan_output16[pixel + output_c] / 257) - (int)scan_premultiplied[pixel + c];
+                        munit_assert_int(difference, >=, -1);
+                        munit_assert_int(difference, <=, 1);
+                    } else {
+                        munit_assert_uint(scan_output8[pixel + output_c], ==, scan_premultiplied[pixel + c]);
+                    }
+                }
+            }
+
+            if (!deep) {
+                munit_assert_memory_equal(image->width * 4, scan_back, scan_premultiplied);
+            }
+        }
+
+        sail_destroy_image(image_back);
+        sail_destroy_image(image_output);
+    }
+
+    /* Premultiplied pixels are blended into the background like the straight ones. */
+    struct sail_image *rgb;
+    munit_assert(sail_convert_image(premultiplied, SAIL_PIXEL_FORMAT_BPP24_RGB, &rgb) == SAIL_OK);
+    munit_assert(rgb->pixel_format == SAIL_PIXEL_FORMAT_BPP24_RGB);
+    sail_destroy_image(rgb);
+
+    /* Scaling keeps the pixel format. */
+    struct sail_image *scaled;
+    munit_assert(sail_scale_image(premultiplied, 7, 3, SAIL_SCALING_BOX, &scaled) == SAIL_OK);
+    munit_assert(scaled->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED);
+    sail_destroy_image(scaled);
+
+    sail_destroy_image(premultiplied);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/exhaustive8",   test_exhaustive8,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/widths",        test_widths,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/16bit",         test_16bit,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/round-trip8",   test_round_trip8,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/other-formats", test_other_formats, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/premultiply",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
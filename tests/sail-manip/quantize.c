@@ -0,0 +1,350 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+/* Smooth RGB gradient with 65536 colors. */
+static struct sail_image* gradient_image(void) {
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 256, 256, 0, &image) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            *scan++ = (uint8_t)column;
+            *scan++ = (uint8_t)row;
+            *scan++ = (uint8_t)((column + row) / 2);
+        }
+    }
+
+    return image;
+}
+
+static double mean_absolute_error(const struct sail_image *image, const struct sail_image *indexed) {
+
+    struct sail_image *rgb;
+    munit_assert(sail_convert_image(indexed, SAIL_PIXEL_FORMAT_BPP24_RGB, &rgb) == SAIL_OK);
+
+    double error = 0;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+        const uint8_t *scan_rgb = sail_scan_line(rgb, row);
+
+        for (unsigned i = 0; i < image->width * 3; i++) {
+            error += abs((int)scan[i] - (int)scan_rgb[i]);
+        }
+    }
+
+    sail_destroy_image(rgb);
+
+    return error / ((double)image->width * image->height * 3);
+}
+
+/* Images with few colors are converted losslessly. */
+static MunitResult test_exact(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 64, 64, 0, &image) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++, scan += 4) {
+            const unsigned color = (row / 4) * 16 + column / 4;
+
+            scan[0] = (uint8_t)(color * 7);
+            scan[1] = (uint8_t)(color * 13);
+            scan[2] = (uint8_t)(255 - color);
+            scan[3] = (color % 5 == 0) ? 128 : 255;
+        }
+    }
+
+    static const enum SailDithering DITHERINGS[] = { SAIL_DITHERING_NONE, SAIL_DITHERING_FLOYD_STEINBERG, SAIL_DITHERING_ORDERED };
+
+    for (size_t d = 0; d < sizeof(DITHERINGS) / sizeof(DITHERINGS[0]); d++) {
+        struct sail_image *indexed;
+        munit_assert(sail_quantize_image(image, SAIL_PIXEL_FORMAT_BPP8_INDEXED, 0, DITHERINGS[d], &indexed) == SAIL_OK);
+        munit_assert(indexed->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED);
+        munit_assert(indexed->palette->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+        munit_assert_uint(indexed->palette->color_count, ==, 256);
+
+        /* Translucent colors go first. */
+        const uint8_t *entries = indexed->palette->data;
+
+        for (unsigned i = 1; i < indexed->palette->color_count; i++) {
+            munit_assert(!(entries[(i - 1) * 4 + 3] == 255 && entries[i * 4 + 3] != 255));
+        }
+
+        struct sail_image *rgba;
+        munit_assert(sail_convert_image(indexed, SAIL_PIXEL_FORMAT_BPP32_RGBA, &rgba) == SAIL_OK);
+        munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, rgba->pixels, image->pixels);
+
+        sail_destroy_image(rgba);
+        sail_destroy_image(indexed);
+    }
+
+    /* Blended alpha produces opaque palettes. */
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options = SAIL_CONVERSION_OPTION_BLEND_ALPHA;
+
+    struct sail_image *indexed;
+    munit_assert(sail_quantize_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_INDEXED, 0, SAIL_DITHERING_NONE, options, &indexed) == SAIL_OK);
+    munit_assert(indexed->palette->pixel_format == SAIL_PIXEL_FORMAT_BPP24_RGB);
+    sail_destroy_image(indexed);
+
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* Full color images are approximated with 256 colors. */
+static MunitResult test_gradient(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = gradient_image();
+
+    static const enum SailDithering DITHERINGS[] = { SAIL_DITHERING_NONE, SAIL_DITHERING_FLOYD_STEINBERG, SAIL_DITHERING_ORDERED };
+
+    for (size_t d = 0; d < sizeof(DITHERINGS) / sizeof(DITHERINGS[0]); d++) {
+        struct sail_image *indexed;
+        munit_assert(sail_quantize_image(image, SAIL_PIXEL_FORMAT_BPP8_INDEXED, 0, DITHERINGS[d], &indexed) == SAIL_OK);
+        munit_assert(indexed->palette->pixel_format == SAIL_PIXEL_FORMAT_BPP24_RGB);
+        munit_assert_uint(indexed->palette->color_count, <=, 256);
+        munit_assert_uint(indexed->palette->color_count, >, 200);
+
+        /* Dithering trades the error of single pixels for the error of areas. */
+        munit_assert_double(mean_absolute_error(image, indexed), <, (DITHERINGS[d] == SAIL_DITHERING_NONE) ? 4 : 6);
+
+        sail_destroy_image(indexed);
+    }
+
+    /* Floyd-Steinberg keeps the average color of areas. */
+    struct sail_image *indexed;
+    munit_assert(sail_quantize_image(image, SAIL_PIXEL_FORMAT_BPP8_INDEXED, 8, SAIL_DITHERING_FLOYD_STEINBERG, &indexed) == SAIL_OK);
+    munit_assert_uint(indexed->palette->color_count, ==, 8);
+
+    struct sail_image *rgb;
+    munit_assert(sail_convert_image(indexed, SAIL_PIXEL_FORMAT_BPP24_RGB, &rgb) == SAIL_OK);
+
+    /* Palette colors are averages, so colors near the edges of the gradient are out of reach. */
+    for (unsigned block_row = 64; block_row < image->height - 64; block_row += 32) {
+        for (unsigned block_column = 64; block_column < image->width - 64; block_column += 32) {
+            long difference = 0;
+
+            for (unsigned row = block_row; row < block_row + 32; row++) {
+                const uint8_t *scan = (const uint8_t *)sail_scan_line(image, row) + block_column * 3;
+                const uint8_t *scan_rgb = (const uint8_t *)sail_scan_line(rgb, row) + block_column * 3;
+
+                for (unsigned i = 0; i < 32 * 3; i += 3) {
+                    difference += (long)scan[i + 1] - (long)scan_rgb[i + 1];
+                }
+            }
+
+            munit_assert_long(labs(difference) / (32 * 32), <=, 2);
+        }
+    }
+
+    sail_destroy_image(rgb);
+    sail_destroy_image(indexed);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* 1, 2, and 4-bit indexed pixels. */
+static MunitResult test_bits(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = gradient_image();
+
+    static const enum SailPixelFormat PIXEL_FORMATS[] = {
+        SAIL_PIXEL_FORMAT_BPP1_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP2_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP4_INDEXED,
+    };
+
+    double previous_error = 256;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        struct sail_image *indexed;
+        munit_assert(sail_convert_image(image, PIXEL_FORMATS[i], &indexed) == SAIL_OK);
+        munit_assert(indexed->pixel_format == PIXEL_FORMATS[i]);
+        munit_assert_uint(indexed->palette->color_count, ==, 1U << sail_bits_per_pixel(PIXEL_FORMATS[i]));
+
+        const double error = mean_absolute_error(image, indexed);
+        munit_assert_double(error, <, previous_error);
+        previous_error = error;
+
+        sail_destroy_image(indexed);
+    }
+
+    /* Two colors are packed losslessly. */
+    struct sail_image *checkerboard;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 13, 3, 0, &checkerboard) == SAIL_OK);
+
+    for (unsigned row = 0; row < checkerboard->height; row++) {
+        uint8_t *scan = sail_scan_line(checkerboard, row);
+
+        for (unsigned column = 0; column < checkerboard->width; column++) {
+            scan[column] = ((row + column) % 2 == 0) ? 255 : 0;
+        }
+    }
+
+    struct sail_image *indexed;
+    munit_assert(sail_quantize_image(checkerboard, SAIL_PIXEL_FORMAT_BPP1_INDEXED, 0, SAIL_DITHERING_NONE, &indexed) == SAIL_OK);
+
+    struct sail_image *gray;
+    munit_assert(sail_convert_image(indexed, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &gray) == SAIL_OK);
+
+    for (unsigned row = 0; row < checkerboard->height; row++) {
+        munit_assert_memory_equal(checkerboard->width, sail_scan_line(gray, row), sail_scan_line(checkerboard, row));
+    }
+
+    sail_destroy_image(gray);
+    sail_destroy_image(indexed);
+    sail_destroy_image(checkerboard);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* The result doesn't depend on the number of threads. */
+static MunitResult test_threads(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = gradient_image();
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+
+    static const enum SailDithering DITHERINGS[] = { SAIL_DITHERING_NONE, SAIL_DITHERING_FLOYD_STEINBERG, SAIL_DITHERING_ORDERED };
+
+    for (size_t d = 0; d < sizeof(DITHERINGS) / sizeof(DITHERINGS[0]); d++) {
+        struct sail_image *parallel;
+        options->max_threads = 0;
+        munit_assert(sail_quantize_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_INDEXED, 64, DITHERINGS[d], options, &parallel) == SAIL_OK);
+
+        struct sail_image *serial;
+        options->max_threads = 1;
+        munit_assert(sail_quantize_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_INDEXED, 64, DITHERINGS[d], options, &serial) == SAIL_OK);
+
+        munit_assert_uint(parallel->palette->color_count, ==, serial->palette->color_count);
+        munit_assert_memory_equal(serial->palette->color_count * 3, parallel->palette->data, serial->palette->data);
+        munit_assert_memory_equal((size_t)serial->bytes_per_line * serial->height, parallel->pixels, serial->pixels);
+
+        sail_destroy_image(serial);
+        sail_destroy_image(parallel);
+    }
+
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_formats(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_can_quantize(SAIL_PIXEL_FORMAT_BPP24_RGB));
+    munit_assert(sail_can_quantize(SAIL_PIXEL_FORMAT_BPP8_INDEXED));
+    munit_assert(sail_can_quantize(SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF));
+    munit_assert(!sail_can_quantize(SAIL_PIXEL_FORMAT_BPP24_CIE_LAB));
+
+    /* Pixel buffers don't have palettes. */
+    munit_assert(!sail_can_convert(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP8_INDEXED));
+
+    /* Indexed pixels are the last resort when choosing the pixel format for saving. */
+    const enum SailPixelFormat indexed_only[] = { SAIL_PIXEL_FORMAT_BPP8_INDEXED };
+    const enum SailPixelFormat indexed_or_rgb[] = { SAIL_PIXEL_FORMAT_BPP8_INDEXED, SAIL_PIXEL_FORMAT_BPP24_RGB };
+
+    munit_assert(sail_closest_pixel_format(SAIL_PIXEL_FORMAT_BPP32_RGBA, indexed_only, 1) == SAIL_PIXEL_FORMAT_BPP8_INDEXED);
+    munit_assert(sail_closest_pixel_format(SAIL_PIXEL_FORMAT_BPP32_RGBA, indexed_or_rgb, 2) == SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    struct sail_image *image = gradient_image();
+    struct sail_image *output = NULL;
+
+    munit_assert(sail_quantize_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, 0, SAIL_DITHERING_NONE, &output) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert(sail_quantize_image(image, SAIL_PIXEL_FORMAT_BPP4_INDEXED, 17, SAIL_DITHERING_NONE, &output) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert_null(output);
+
+    /* Indexed images are requantized into fewer colors. */
+    struct sail_image *indexed;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_INDEXED, &indexed) == SAIL_OK);
+    munit_assert(sail_quantize_image(indexed, SAIL_PIXEL_FORMAT_BPP4_INDEXED, 0, SAIL_DITHERING_ORDERED, &output) == SAIL_OK);
+    munit_assert_uint(output->palette->color_count, ==, 16);
+
+    sail_destroy_image(output);
+    sail_destroy_image(indexed);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/exact",    test_exact,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/gradient", test_gradient, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/bits",     test_bits,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/threads",  test_threads,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/formats",  test_formats,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/quantize",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
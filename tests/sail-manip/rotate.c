@@ -0,0 +1,305 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static const enum SailOrientation ORIENTATIONS[] = {
+    SAIL_ORIENTATION_NORMAL,
+    SAIL_ORIENTATION_ROTATED_90,
+    SAIL_ORIENTATION_ROTATED_180,
+    SAIL_ORIENTATION_ROTATED_270,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY,
+    SAIL_ORIENTATION_MIRRORED_VERTICALLY,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270,
+};
+
+/* All the pixel sizes with transpose kernels, and some without them. */
+static const enum SailPixelFormat PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP1_INDEXED,
+    SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP24_RGB,
+    SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    SAIL_PIXEL_FORMAT_BPP40_CMYKA,
+    SAIL_PIXEL_FORMAT_BPP48_RGB,
+    SAIL_PIXEL_FORMAT_BPP64_RGBA,
+    SAIL_PIXEL_FORMAT_BPP80_CMYKA,
+};
+
+/* Sizes smaller than a block, not multiples of blocks, and larger than a tile. */
+static const unsigned SIZES[][2] = {
+    { 1,   1   },
+    { 3,   2   },
+    { 8,   8   },
+    { 37,  19  },
+    { 64,  65  },
+    { 133, 70  },
+};
+
+/* Scan lines are padded to check that the padding is respected. */
+static const unsigned PADDING = 5;
+
+/* Bits of the pixel packed starting from the most significant bit, or bytes of larger pixels. */
+static uint64_t get_pixel(const struct sail_image *image, unsigned row, unsigned column) {
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+    const uint8_t *scan = sail_scan_line(image, row);
+
+    if (bits_per_pixel < 8) {
+        const unsigned bit = column * bits_per_pixel;
+        return (scan[bit / 8] >> (8 - bits_per_pixel - bit % 8)) & ((1U << bits_per_pixel) - 1);
+    }
+
+    /* Hash the bytes of pixels larger than 64 bits. */
+    uint64_t value = 0;
+
+    for (unsigned i = 0; i < bits_per_pixel / 8; i++) {
+        value = value * 1099511628211ULL + scan[column * (bits_per_pixel / 8) + i];
+    }
+
+    return value;
+}
+
+/* Input coordinates of the output pixel for the orientation, in terms of the rotations and mirrors. */
+static void input_coordinates(enum SailOrientation orientation, unsigned width, unsigned height,
+                                unsigned row, unsigned column, unsigned *input_row, unsigned *input_column) {
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_NORMAL:                            { *input_row = row;              *input_column = column;            break; }
+        case SAIL_ORIENTATION_ROTATED_90:                        { *input_row = height - 1 - column; *input_column = row;            break; }
+        case SAIL_ORIENTATION_ROTATED_180:                       { *input_row = height - 1 - row; *input_column = width - 1 - column; break; }
+        case SAIL_ORIENTATION_ROTATED_270:                       { *input_row = column;           *input_column = width - 1 - row;   break; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY:             { *input_row = row;              *input_column = width - 1 - column; break; }
+        case SAIL_ORIENTATION_MIRRORED_VERTICALLY:               { *input_row = height - 1 - row; *input_column = column;            break; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90:  { *input_row = height - 1 - column; *input_column = width - 1 - row; break; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270: { *input_row = column;           *input_column = row;               break; }
+
+        default: {
+            munit_error("Unknown orientation");
+        }
+    }
+}
+
+static MunitResult test_orientations(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t f = 0; f < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); f++) {
+        munit_assert(sail_can_rotate(PIXEL_FORMATS[f]));
+
+        for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+            const unsigned width  = SIZES[s][0];
+            const unsigned height = SIZES[s][1];
+
+            struct sail_image *image;
+            munit_assert(sail_test_alloc_image(PIXEL_FORMATS[f], width, height, PADDING, &image) == SAIL_OK);
+
+            for (size_t o = 0; o < sizeof(ORIENTATIONS) / sizeof(ORIENTATIONS[0]); o++) {
+                struct sail_image *image_output;
+                munit_assert(sail_rotate_image(image, ORIENTATIONS[o], &image_output) == SAIL_OK);
+                munit_assert(image_output->pixel_format == image->pixel_format);
+                munit_assert_uint(image_output->bytes_per_line, ==, sail_bytes_per_line(image_output->width, image_output->pixel_format));
+
+                const bool transposed = image_output->width != width || image_output->height != height;
+                munit_assert_uint(image_output->width,  ==, transposed ? height : width);
+                munit_assert_uint(image_output->height, ==, transposed ? width  : height);
+
+                for (unsigned row = 0; row < image_output->height; row++) {
+                    for (unsigned column = 0; column < image_output->width; column++) {
+                        unsigned input_row;
+                        unsigned input_column;
+                        input_coordinates(ORIENTATIONS[o], width, height, row, column, &input_row, &input_column);
+
+                        munit_assert_uint64(get_pixel(image_output, row, column), ==, get_pixel(image, input_row, input_column));
+                    }
+                }
+
+                if (image->palette != NULL) {
+                    munit_assert_not_null(image_output->palette);
+                    munit_assert_memory_equal(6, image_output->palette->data, image->palette->data);
+                }
+
+                sail_destroy_image(image_output);
+            }
+
+            sail_destroy_image(image);
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_transpose(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_BGRA, 211, 97, PADDING, &image) == SAIL_OK);
+
+    munit_assert(sail_alloc_resolution_from_data(SAIL_RESOLUTION_UNIT_INCH, 72, 300, &image->resolution) == SAIL_OK);
+
+    struct sail_image *transposed;
+    munit_assert(sail_transpose_image(image, &transposed) == SAIL_OK);
+    munit_assert_uint(transposed->width,  ==, 97);
+    munit_assert_uint(transposed->height, ==, 211);
+    munit_assert_double(transposed->resolution->x, ==, 300);
+    munit_assert_double(transposed->resolution->y, ==, 72);
+
+    struct sail_image *twice;
+    munit_assert(sail_transpose_image(transposed, &twice) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        munit_assert_memory_equal(image->width * 4, sail_scan_line(twice, row), sail_scan_line(image, row));
+    }
+
+    sail_destroy_image(twice);
+    sail_destroy_image(transposed);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_threads(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 1031, 517, PADDING, &image) == SAIL_OK);
+
+    const unsigned max_threads = sail_max_threads();
+
+    for (size_t o = 0; o < sizeof(ORIENTATIONS) / sizeof(ORIENTATIONS[0]); o++) {
+        sail_set_max_threads(1);
+
+        struct sail_image *single;
+        munit_assert(sail_rotate_image(image, ORIENTATIONS[o], &single) == SAIL_OK);
+
+        sail_set_max_threads(4);
+
+        struct sail_image *multiple;
+        munit_assert(sail_rotate_image(image, ORIENTATIONS[o], &multiple) == SAIL_OK);
+
+        munit_assert_memory_equal((size_t)single->bytes_per_line * single->height, multiple->pixels, single->pixels);
+
+        sail_destroy_image(multiple);
+        sail_destroy_image(single);
+    }
+
+    sail_set_max_threads(max_threads);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* sail_mirror() in sail-common must agree with the rotations, including packed pixels. */
+static MunitResult test_mirror(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t f = 0; f < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); f++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMATS[f], 13, 5, PADDING, &image) == SAIL_OK);
+
+        struct sail_image *expected;
+        munit_assert(sail_rotate_image(image, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY, &expected) == SAIL_OK);
+
+        munit_assert(sail_mirror_horizontally(image) == SAIL_OK);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            for (unsigned column = 0; column < image->width; column++) {
+                munit_assert_uint64(get_pixel(image, row, column), ==, get_pixel(expected, row, column));
+            }
+        }
+
+        sail_destroy_image(expected);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP12_YUV420P, 8, 8, PADDING, &image) == SAIL_OK);
+    munit_assert(!sail_can_rotate(image->pixel_format));
+
+    struct sail_image *image_output = NULL;
+    munit_assert(sail_rotate_image(image, SAIL_ORIENTATION_ROTATED_90, &image_output) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert_null(image_output);
+
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+    munit_assert(sail_rotate_image(image, (enum SailOrientation)100, &image_output) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert_null(image_output);
+
+    munit_assert(!sail_can_rotate(SAIL_PIXEL_FORMAT_BPP30_YUV));
+    munit_assert(!sail_can_rotate(SAIL_PIXEL_FORMAT_UNKNOWN));
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/orientations", test_orientations, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/transpose",    test_transpose,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/threads",      test_threads,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/mirror",       test_mirror,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported",  test_unsupported,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/rotate",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,293 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+struct layout {
+    enum SailPixelFormat pixel_format;
+    unsigned channels;
+    unsigned bytes_per_channel;
+    int r, g, b, a;
+};
+
+static const struct layout INPUT_LAYOUTS[] = {
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,        1, 1, 0, 0, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,       1, 2, 0, 0, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA, 2, 1, 0, 0, 0,  1 },
+    { SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA, 2, 2, 0, 0, 0,  1 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,             3, 1, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,             3, 2, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB,            4, 1, 1, 2, 3,  0 },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRX,            4, 2, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,            4, 2, 0, 1, 2,  3 },
+};
+
+static const struct layout OUTPUT_LAYOUTS[] = {
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  1, 1, 0, 0, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, 1, 2, 0, 0, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,  3, 1, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_ABGR, 4, 1, 3, 2, 1,  0 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBX, 4, 1, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,  3, 2, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_XRGB, 4, 2, 1, 2, 3, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA, 4, 2, 0, 1, 2,  3 },
+    { SAIL_PIXEL_FORMAT_BPP64_ARGB, 4, 2, 1, 2, 3,  0 },
+};
+
+static unsigned load_channel(const uint8_t *pixel, unsigned bytes_per_channel, int index) {
+
+    if (bytes_per_channel == 1) {
+        return pixel[index];
+    } else {
+        uint16_t value;
+        memcpy(&value, pixel + index * 2, sizeof(value));
+        return value;
+    }
+}
+
+static unsigned scale_channel(unsigned value, unsigned input_bytes_per_channel, unsigned output_bytes_per_channel) {
+
+    if (input_bytes_per_channel == output_bytes_per_channel) {
+        return value;
+    } else if (input_bytes_per_channel == 1) {
+        return value * 257;
+    } else {
+        return (unsigned)(value / 257.0);
+    }
+}
+
+static unsigned luma(unsigned r, unsigned g, unsigned b) {
+
+    return (19595 * r + 38470 * g + 7471 * b + 32768) >> 16;
+}
+
+/* Checks every pixel. Missing input alpha and X channels must become opaque. Grayscale output must be luma. */
+static void assert_converted(const struct layout *input_layout, const struct sail_image *input,
+                                const struct layout *output_layout, const struct sail_image *output) {
+
+    const unsigned input_bytes_per_pixel = input_layout->channels * input_layout->bytes_per_channel;
+    const unsigned output_bytes_per_pixel = output_layout->channels * output_layout->bytes_per_channel;
+    const unsigned input_max = (input_layout->bytes_per_channel == 1) ? 255 : 65535;
+    const unsigned output_max = (output_layout->bytes_per_channel == 1) ? 255 : 65535;
+
+    /* Channel indexes of 4-channel pixels add up to 6. */
+    const int output_x = (output_layout->channels == 4 && output_layout->a < 0)
+                            ? 6 - output_layout->r - output_layout->g - output_layout->b
+                            : -1;
+
+    const int input_indexes[4]  = { input_layout->r,  input_layout->g,  input_layout->b,  input_layout->a };
+    const int output_indexes[4] = { output_layout->r, output_layout->g, output_layout->b, output_layout->a };
+
+    for (unsigned row = 0; row < input->height; row++) {
+        const uint8_t *scan_input = sail_scan_line(input, row);
+        const uint8_t *scan_output = sail_scan_line(output, row);
+
+        for (unsigned column = 0; column < input->width; column++) {
+            const uint8_t *input_pixel = scan_input + column * input_bytes_per_pixel;
+            const uint8_t *output_pixel = scan_output + column * output_bytes_per_pixel;
+
+            if (output_layout->channels == 1) {
+                unsigned values[3];
+
+                for (unsigned c = 0; c < 3; c++) {
+                    values[c] = scale_channel(load_channel(input_pixel, input_layout->bytes_per_channel, input_indexes[c]),
+                                                input_layout->bytes_per_channel, output_layout->bytes_per_channel);
+                }
+
+                munit_assert_uint(load_channel(output_pixel, output_layout->bytes_per_channel, 0), ==,
+                                    luma(values[0], values[1], values[2]));
+                continue;
+            }
+
+            for (unsigned c = 0; c < 4; c++) {
+                if (output_indexes[c] < 0) {
+                    continue;
+                }
+
+                const unsigned input_value = (input_indexes[c] >= 0) ? load_channel(input_pixel, input_layout->bytes_per_channel, input_indexes[c]) : input_max;
+
+                munit_assert_uint(load_channel(output_pixel, output_layout->bytes_per_channel, output_indexes[c]), ==,
+                                    scale_channel(input_value, input_layout->bytes_per_channel, output_layout->bytes_per_channel));
+            }
+
+            if (output_x >= 0) {
+                munit_assert_uint(load_channel(output_pixel, output_layout->bytes_per_channel, output_x), ==, output_max);
+            }
+        }
+    }
+}
+
+static MunitResult test_convert(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(INPUT_LAYOUTS) / sizeof(INPUT_LAYOUTS[0]); i++) {
+        for (size_t o = 0; o < sizeof(OUTPUT_LAYOUTS) / sizeof(OUTPUT_LAYOUTS[0]); o++) {
+            struct sail_image *image;
+            munit_assert(sail_test_alloc_image(INPUT_LAYOUTS[i].pixel_format, 19, 3, 0, &image) == SAIL_OK);
+
+            struct sail_image *image_output;
+            munit_assert(sail_convert_image(image, OUTPUT_LAYOUTS[o].pixel_format, &image_output) == SAIL_OK);
+
+            assert_converted(&INPUT_LAYOUTS[i], image, &OUTPUT_LAYOUTS[o], image_output);
+
+            sail_destroy_image(image_output);
+            sail_destroy_image(image);
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_update(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(INPUT_LAYOUTS) / sizeof(INPUT_LAYOUTS[0]); i++) {
+        for (size_t o = 0; o < sizeof(OUTPUT_LAYOUTS) / sizeof(OUTPUT_LAYOUTS[0]); o++) {
+            if (!sail_can_update(INPUT_LAYOUTS[i].pixel_format, OUTPUT_LAYOUTS[o].pixel_format)) {
+                continue;
+            }
+
+            struct sail_image *image;
+            munit_assert(sail_test_alloc_image(INPUT_LAYOUTS[i].pixel_format, 19, 3, 0, &image) == SAIL_OK);
+
+            struct sail_image *image_copy;
+            munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+
+            munit_assert(sail_update_image(image, OUTPUT_LAYOUTS[o].pixel_format) == SAIL_OK);
+
+            assert_converted(&INPUT_LAYOUTS[i], image_copy, &OUTPUT_LAYOUTS[o], image);
+
+            sail_destroy_image(image_copy);
+            sail_destroy_image(image);
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_blend_alpha(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options = SAIL_CONVERSION_OPTION_BLEND_ALPHA;
+    options->background24 = (sail_rgb24_t){ 10, 20, 30 };
+    options->background48 = (sail_rgb48_t){ 1000, 2000, 3000 };
+
+    /* 8-bit input. */
+    {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 1, 1, 0, &image) == SAIL_OK);
+
+        uint8_t *pixel = image->pixels;
+        pixel[0] = 200; pixel[1] = 100; pixel[2] = 50; pixel[3] = 51;
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP48_RGB, options, &image_output) == SAIL_OK);
+
+        const uint16_t *output = image_output->pixels;
+        munit_assert_uint16(output[0], ==, 11080);
+        munit_assert_uint16(output[1], ==, 6740);
+        munit_assert_uint16(output[2], ==, 4970);
+
+        sail_destroy_image(image_output);
+
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &image_output) == SAIL_OK);
+        munit_assert_uint8(*(const uint8_t *)image_output->pixels, ==, 39);
+        sail_destroy_image(image_output);
+
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, options, &image_output) == SAIL_OK);
+        munit_assert_uint16(*(const uint16_t *)image_output->pixels, ==, 7836);
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    /* 16-bit input. */
+    {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP64_BGRA, 1, 1, 0, &image) == SAIL_OK);
+
+        uint16_t *pixel = image->pixels;
+        pixel[0] = 5000; pixel[1] = 40000; pixel[2] = 60000; pixel[3] = 30000;
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP32_XRGB, options, &image_output) == SAIL_OK);
+
+        const uint8_t *output = image_output->pixels;
+        munit_assert_uint8(output[0], ==, 255);
+        munit_assert_uint8(output[1], ==, 108);
+        munit_assert_uint8(output[2], ==, 75);
+        munit_assert_uint8(output[3], ==, 15);
+
+        sail_destroy_image(image_output);
+
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &image_output) == SAIL_OK);
+        munit_assert_uint8(*(const uint8_t *)image_output->pixels, ==, 78);
+        sail_destroy_image(image_output);
+
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, options, &image_output) == SAIL_OK);
+        munit_assert_uint16(*(const uint16_t *)image_output->pixels, ==, 20206);
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/convert",     test_convert,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/update",      test_update,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/blend-alpha", test_blend_alpha, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/row-kernels",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,408 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+static const enum SailScaling ALGORITHMS[] = {
+    SAIL_SCALING_NEAREST_NEIGHBOR,
+    SAIL_SCALING_BILINEAR,
+    SAIL_SCALING_BOX,
+    SAIL_SCALING_LANCZOS3,
+};
+
+static const enum SailPixelFormat PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,
+    SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA,
+    SAIL_PIXEL_FORMAT_BPP24_RGB,
+    SAIL_PIXEL_FORMAT_BPP48_BGR,
+    SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    SAIL_PIXEL_FORMAT_BPP32_XRGB,
+    SAIL_PIXEL_FORMAT_BPP64_ABGR,
+};
+
+/* Scan lines are padded to check that the padding is respected. */
+static const unsigned PADDING = 5;
+
+/* Copies a single channel of every pixel into a grayscale image. */
+static struct sail_image *extract_channel(const struct sail_image *image, unsigned channels, unsigned bytes_per_channel, unsigned channel) {
+
+    struct sail_image *gray;
+    munit_assert(sail_test_alloc_image(bytes_per_channel == 1 ? SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE : SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+                                       image->width, image->height, PADDING, &gray) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+        uint8_t *gray_scan = sail_scan_line(gray, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            memcpy(gray_scan + column * bytes_per_channel, scan + (column * channels + channel) * bytes_per_channel, bytes_per_channel);
+        }
+    }
+
+    return gray;
+}
+
+static MunitResult test_same_size(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        munit_assert(sail_can_scale(PIXEL_FORMATS[i]));
+
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMATS[i], 37, 19, PADDING, &image) == SAIL_OK);
+
+        for (size_t a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+            struct sail_image *image_output;
+            munit_assert(sail_scale_image(image, 37, 19, ALGORITHMS[a], &image_output) == SAIL_OK);
+            munit_assert(image_output->pixel_format == image->pixel_format);
+            munit_assert_uint(image_output->bytes_per_line, ==, sail_bytes_per_line(37, image->pixel_format));
+
+            sail_test_assert_images_equal(image_output, image);
+
+            sail_destroy_image(image_output);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_solid_color(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    static const unsigned SIZES[][2] = { { 5, 3 }, { 100, 77 }, { 37, 200 }, { 1, 1 }, { 300, 2 } };
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMATS[i], 37, 19, PADDING, &image) == SAIL_OK);
+
+        const unsigned bytes_per_pixel = sail_bits_per_pixel(image->pixel_format) / 8;
+        uint8_t pixel[8];
+        munit_rand_memory(sizeof(pixel), pixel);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            for (unsigned column = 0; column < image->width; column++) {
+                memcpy((uint8_t *)sail_scan_line(image, row) + column * bytes_per_pixel, pixel, bytes_per_pixel);
+            }
+        }
+
+        for (size_t a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+            for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+                struct sail_image *image_output;
+                munit_assert(sail_scale_image(image, SIZES[s][0], SIZES[s][1], ALGORITHMS[a], &image_output) == SAIL_OK);
+
+                for (unsigned row = 0; row < image_output->height; row++) {
+                    for (unsigned column = 0; column < image_output->width; column++) {
+                        munit_assert_memory_equal(bytes_per_pixel, (uint8_t *)sail_scan_line(image_output, row) + column * bytes_per_pixel, pixel);
+                    }
+                }
+
+                sail_destroy_image(image_output);
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+/* Channels are scaled independently, so 4-channel SIMD kernels must match scaling every channel alone. */
+static MunitResult test_channels(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    static const unsigned SIZES[][2] = { { 29, 67 }, { 101, 17 }, { 200, 150 }, { 13, 5 } };
+    static const enum SailPixelFormat FORMATS[] = { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP24_BGR, SAIL_PIXEL_FORMAT_BPP64_RGBA };
+
+    for (size_t f = 0; f < sizeof(FORMATS) / sizeof(FORMATS[0]); f++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(FORMATS[f], 53, 41, PADDING, &image) == SAIL_OK);
+
+        const unsigned bytes_per_channel = (FORMATS[f] == SAIL_PIXEL_FORMAT_BPP64_RGBA) ? 2 : 1;
+        const unsigned channels = sail_bits_per_pixel(FORMATS[f]) / 8 / bytes_per_channel;
+
+        for (size_t a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+            for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+                struct sail_image *image_output;
+                munit_assert(sail_scale_image(image, SIZES[s][0], SIZES[s][1], ALGORITHMS[a], &image_output) == SAIL_OK);
+
+                for (unsigned c = 0; c < channels; c++) {
+                    struct sail_image *gray = extract_channel(image, channels, bytes_per_channel, c);
+                    struct sail_image *expected;
+                    munit_assert(sail_scale_image(gray, SIZES[s][0], SIZES[s][1], ALGORITHMS[a], &expected) == SAIL_OK);
+
+                    struct sail_image *actual = extract_channel(image_output, channels, bytes_per_channel, c);
+                    sail_test_assert_images_equal(actual, expected);
+
+                    sail_destroy_image(actual);
+                    sail_destroy_image(expected);
+                    sail_destroy_image(gray);
+                }
+
+                sail_destroy_image(image_output);
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+/* Downscaling by 2 with the box filter averages 2x2 blocks, horizontally first. */
+static MunitResult test_box_average(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 40, 30, PADDING, &image) == SAIL_OK);
+
+    struct sail_image *image_output;
+    munit_assert(sail_scale_image(image, 20, 15, SAIL_SCALING_BOX, &image_output) == SAIL_OK);
+
+    for (unsigned row = 0; row < 15; row++) {
+        const uint8_t *scan1 = sail_scan_line(image, row * 2);
+        const uint8_t *scan2 = sail_scan_line(image, row * 2 + 1);
+        const uint8_t *scan_output = sail_scan_line(image_output, row);
+
+        for (unsigned column = 0; column < 20; column++) {
+            const unsigned top    = (scan1[column * 2] + scan1[column * 2 + 1] + 1) / 2;
+            const unsigned bottom = (scan2[column * 2] + scan2[column * 2 + 1] + 1) / 2;
+
+            munit_assert_uint(scan_output[column], ==, (top + bottom + 1) / 2);
+        }
+    }
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_nearest_neighbor(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 10, 7, PADDING, &image) == SAIL_OK);
+
+    struct sail_image *image_output;
+    munit_assert(sail_scale_image(image, 4, 15, SAIL_SCALING_NEAREST_NEIGHBOR, &image_output) == SAIL_OK);
+
+    for (unsigned row = 0; row < 15; row++) {
+        for (unsigned column = 0; column < 4; column++) {
+            const unsigned input_row    = (row * 2 + 1) * 7 / 30;
+            const unsigned input_column = (column * 2 + 1) * 10 / 8;
+
+            munit_assert_memory_equal(3, (uint8_t *)sail_scan_line(image_output, row) + column * 3,
+                                        (uint8_t *)sail_scan_line(image, input_row) + input_column * 3);
+        }
+    }
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* 16-bit channels keep more precision between the passes, so the results differ slightly. */
+static MunitResult test_bit_depth(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 64, 48, PADDING, &image) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan[column * 3 + 0] = (uint8_t)(column * 4);
+            scan[column * 3 + 1] = (uint8_t)(row * 5);
+            scan[column * 3 + 2] = (uint8_t)((column + row) * 2);
+        }
+    }
+
+    struct sail_image *image48;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP48_RGB, &image48) == SAIL_OK);
+
+    for (size_t a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+        struct sail_image *scaled;
+        struct sail_image *scaled48;
+        struct sail_image *scaled24;
+        munit_assert(sail_scale_image(image, 23, 71, ALGORITHMS[a], &scaled) == SAIL_OK);
+        munit_assert(sail_scale_image(image48, 23, 71, ALGORITHMS[a], &scaled48) == SAIL_OK);
+        munit_assert(sail_convert_image(scaled48, SAIL_PIXEL_FORMAT_BPP24_RGB, &scaled24) == SAIL_OK);
+
+        for (unsigned row = 0; row < scaled->height; row++) {
+            const uint8_t *scan = sail_scan_line(scaled, row);
+            const uint8_t *scan24 = sail_scan_line(scaled24, row);
+
+            for (unsigned i = 0; i < scaled->width * 3; i++) {
+                munit_assert_int(abs(scan[i] - scan24[i]), <=, 2);
+            }
+        }
+
+        sail_destroy_image(scaled24);
+        sail_destroy_image(scaled48);
+        sail_destroy_image(scaled);
+    }
+
+    sail_destroy_image(image48);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_threads(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_BGRA, 300, 200, PADDING, &image) == SAIL_OK);
+
+    const unsigned max_threads = sail_max_threads();
+
+    for (size_t a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++) {
+        struct sail_image *single;
+        struct sail_image *multiple;
+
+        sail_set_max_threads(1);
+        munit_assert(sail_scale_image(image, 123, 457, ALGORITHMS[a], &single) == SAIL_OK);
+
+        sail_set_max_threads(4);
+        munit_assert(sail_scale_image(image, 123, 457, ALGORITHMS[a], &multiple) == SAIL_OK);
+
+        sail_test_assert_images_equal(multiple, single);
+
+        sail_destroy_image(multiple);
+        sail_destroy_image(single);
+    }
+
+    sail_set_max_threads(max_threads);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_into(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 64, 64, PADDING, &image) == SAIL_OK);
+
+    struct sail_image *expected;
+    munit_assert(sail_scale_image(image, 20, 10, SAIL_SCALING_LANCZOS3, &expected) == SAIL_OK);
+
+    /* Padded scan lines. */
+    struct sail_image *image_output;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 20, 10, PADDING, &image_output) == SAIL_OK);
+    munit_assert(sail_scale_image_into(image, SAIL_SCALING_LANCZOS3, image_output) == SAIL_OK);
+
+    sail_test_assert_images_equal(image_output, expected);
+
+    image_output->pixel_format = SAIL_PIXEL_FORMAT_BPP32_BGRA;
+    munit_assert(sail_scale_image_into(image, SAIL_SCALING_LANCZOS3, image_output) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(expected);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    munit_assert(!sail_can_scale(SAIL_PIXEL_FORMAT_BPP8_INDEXED));
+    munit_assert(!sail_can_scale(SAIL_PIXEL_FORMAT_BPP12_YUV420P));
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_YCBCR, 8, 8, PADDING, &image) == SAIL_OK);
+
+    struct sail_image *image_output = NULL;
+    munit_assert(sail_scale_image(image, 4, 4, SAIL_SCALING_BOX, &image_output) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert_null(image_output);
+
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    munit_assert(sail_scale_image(image, 0, 4, SAIL_SCALING_BOX, &image_output) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert_null(image_output);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/same-size",        test_same_size,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/solid-color",      test_solid_color,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/channels",         test_channels,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/box-average",      test_box_average,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/nearest-neighbor", test_nearest_neighbor, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/bit-depth",        test_bit_depth,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/threads",          test_threads,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/into",             test_into,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported",      test_unsupported,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/scale",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
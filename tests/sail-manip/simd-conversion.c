@@ -0,0 +1,229 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+struct layout {
+    enum SailPixelFormat pixel_format;
+    unsigned channels;
+    unsigned bytes_per_channel;
+    int r, g, b, a;
+};
+
+static const struct layout INPUT_LAYOUTS[] = {
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 1, 1, 0, 0, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,      3, 1, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,      3, 1, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBX,     4, 1, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_XBGR,     4, 1, 3, 2, 1, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,     4, 1, 0, 1, 2,  3 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,     4, 1, 2, 1, 0,  3 },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB,     4, 1, 1, 2, 3,  0 },
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,      3, 2, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,      3, 2, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_XRGB,     4, 2, 1, 2, 3, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,     4, 2, 0, 1, 2,  3 },
+    { SAIL_PIXEL_FORMAT_BPP64_ABGR,     4, 2, 3, 2, 1,  0 },
+};
+
+static const struct layout OUTPUT_LAYOUTS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,  3, 1, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,  3, 1, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBX, 4, 1, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_XRGB, 4, 1, 1, 2, 3, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA, 4, 1, 0, 1, 2,  3 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA, 4, 1, 2, 1, 0,  3 },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB, 4, 1, 1, 2, 3,  0 },
+    { SAIL_PIXEL_FORMAT_BPP32_ABGR, 4, 1, 3, 2, 1,  0 },
+};
+
+static const unsigned WIDTHS[] = { 1, 2, 3, 5, 7, 11, 16, 17, 31, 32, 33, 47, 64, 67 };
+
+static unsigned input_channel(const struct layout *layout, const uint8_t *pixel, int index) {
+
+    if (layout->bytes_per_channel == 1) {
+        return pixel[index];
+    } else {
+        uint16_t value;
+        memcpy(&value, pixel + index * 2, sizeof(value));
+        return value / 257;
+    }
+}
+
+/* Checks every pixel except X channels. Missing input alpha must become 255. */
+static void assert_converted(const struct layout *input_layout, const struct sail_image *input,
+                                const struct layout *output_layout, const struct sail_image *output) {
+
+    const unsigned input_bytes_per_pixel = input_layout->channels * input_layout->bytes_per_channel;
+
+    for (unsigned row = 0; row < input->height; row++) {
+        const uint8_t *scan_input = sail_scan_line(input, row);
+        const uint8_t *scan_output = sail_scan_line(output, row);
+
+        for (unsigned column = 0; column < input->width; column++) {
+            const uint8_t *input_pixel = scan_input + column * input_bytes_per_pixel;
+            const uint8_t *output_pixel = scan_output + column * output_layout->channels;
+
+            munit_assert_uint8(output_pixel[output_layout->r], ==, input_channel(input_layout, input_pixel, input_layout->r));
+            munit_assert_uint8(output_pixel[output_layout->g], ==, input_channel(input_layout, input_pixel, input_layout->g));
+            munit_assert_uint8(output_pixel[output_layout->b], ==, input_channel(input_layout, input_pixel, input_layout->b));
+
+            if (output_layout->a >= 0) {
+                const unsigned alpha = (input_layout->a >= 0) ? input_channel(input_layout, input_pixel, input_layout->a) : 255;
+                munit_assert_uint8(output_pixel[output_layout->a], ==, alpha);
+            }
+        }
+    }
+}
+
+static MunitResult test_convert(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(INPUT_LAYOUTS) / sizeof(INPUT_LAYOUTS[0]); i++) {
+        for (size_t o = 0; o < sizeof(OUTPUT_LAYOUTS) / sizeof(OUTPUT_LAYOUTS[0]); o++) {
+            for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w++) {
+                struct sail_image *image;
+                munit_assert(sail_test_alloc_image(INPUT_LAYOUTS[i].pixel_format, WIDTHS[w], 3, 0, &image) == SAIL_OK);
+
+                struct sail_image *image_output;
+                munit_assert(sail_convert_image(image, OUTPUT_LAYOUTS[o].pixel_format, &image_output) == SAIL_OK);
+
+                assert_converted(&INPUT_LAYOUTS[i], image, &OUTPUT_LAYOUTS[o], image_output);
+
+                sail_destroy_image(image_output);
+                sail_destroy_image(image);
+            }
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_update(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(INPUT_LAYOUTS) / sizeof(INPUT_LAYOUTS[0]); i++) {
+        for (size_t o = 0; o < sizeof(OUTPUT_LAYOUTS) / sizeof(OUTPUT_LAYOUTS[0]); o++) {
+            if (!sail_greater_equal_bits_per_pixel(INPUT_LAYOUTS[i].pixel_format, OUTPUT_LAYOUTS[o].pixel_format)) {
+                continue;
+            }
+
+            for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w++) {
+                struct sail_image *image;
+                munit_assert(sail_test_alloc_image(INPUT_LAYOUTS[i].pixel_format, WIDTHS[w], 3, 0, &image) == SAIL_OK);
+
+                struct sail_image *image_copy;
+                munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+
+                munit_assert(sail_update_image(image, OUTPUT_LAYOUTS[o].pixel_format) == SAIL_OK);
+                munit_assert_int(image->pixel_format, ==, OUTPUT_LAYOUTS[o].pixel_format);
+
+                assert_converted(&INPUT_LAYOUTS[i], image_copy, &OUTPUT_LAYOUTS[o], image);
+
+                sail_destroy_image(image_copy);
+                sail_destroy_image(image);
+            }
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_blend_alpha(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Blending is not a plain channel shuffle, so it must not change the result of the generic conversion. */
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width = 37;
+    image->height = 1;
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+    munit_assert(sail_malloc(image->bytes_per_line, &image->pixels) == SAIL_OK);
+
+    uint8_t *pixels = image->pixels;
+    for (unsigned column = 0; column < image->width; column++) {
+        pixels[column * 4 + 0] = 200;
+        pixels[column * 4 + 1] = 100;
+        pixels[column * 4 + 2] = 50;
+        pixels[column * 4 + 3] = 0;
+    }
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options = SAIL_CONVERSION_OPTION_BLEND_ALPHA;
+    options->background24 = (sail_rgb24_t){ 10, 20, 30 };
+
+    struct sail_image *image_output;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP24_RGB, options, &image_output) == SAIL_OK);
+
+    const uint8_t *output = image_output->pixels;
+    for (unsigned column = 0; column < image->width; column++) {
+        munit_assert_uint8(output[column * 3 + 0], ==, 10);
+        munit_assert_uint8(output[column * 3 + 1], ==, 20);
+        munit_assert_uint8(output[column * 3 + 2], ==, 30);
+    }
+
+    sail_destroy_image(image_output);
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/convert",     test_convert,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/update",      test_update,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/blend-alpha", test_blend_alpha, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/simd-conversion",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,525 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+/* Multiple parallel blocks with an odd width to check the tails of the vectorized scan lines. */
+enum { WIDTH = 97, HEIGHT = 1500 };
+
+static const enum SailPixelFormat PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,
+    SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA,
+    SAIL_PIXEL_FORMAT_BPP24_RGB,
+    SAIL_PIXEL_FORMAT_BPP24_BGR,
+    SAIL_PIXEL_FORMAT_BPP48_RGB,
+    SAIL_PIXEL_FORMAT_BPP32_RGBX,
+    SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    SAIL_PIXEL_FORMAT_BPP32_ABGR,
+    SAIL_PIXEL_FORMAT_BPP64_BGRA,
+    SAIL_PIXEL_FORMAT_BPP64_ARGB,
+};
+
+enum Pixels {
+    PIXELS_RANDOM,
+    PIXELS_OPAQUE,
+    PIXELS_GRAY,
+    PIXELS_FEW_COLORS,
+};
+
+/* BPP64-RGBA image with the pixels of the kind. */
+static struct sail_image* source_image(enum Pixels pixels) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = WIDTH;
+    image->height         = HEIGHT;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP64_RGBA;
+    image->bytes_per_line = sail_bytes_per_line(WIDTH, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * HEIGHT, &image->pixels) == SAIL_OK);
+    munit_rand_memory((size_t)image->bytes_per_line * HEIGHT, image->pixels);
+
+    uint16_t palette[5][4];
+    munit_rand_memory(sizeof(palette), (uint8_t *)palette);
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        uint16_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < WIDTH; column++, scan += 4) {
+            switch (pixels) {
+                case PIXELS_RANDOM: {
+                    break;
+                }
+                case PIXELS_OPAQUE: {
+                    scan[3] = 65535;
+                    break;
+                }
+                case PIXELS_GRAY: {
+                    scan[1] = scan[2] = scan[0];
+                    break;
+                }
+                case PIXELS_FEW_COLORS: {
+                    /* Runs of equal pixels. */
+                    memcpy(scan, palette[(row + column / 7) % 5], sizeof(palette[0]));
+                    break;
+                }
+            }
+        }
+    }
+
+    return image;
+}
+
+/* Grayscale-alpha pixels are not produced by conversions, so red and alpha values are copied. */
+static struct sail_image* gray_alpha_image(const struct sail_image *source, enum SailPixelFormat pixel_format) {
+
+    struct sail_image *image;
+    munit_assert(sail_copy_image_skeleton(source, &image) == SAIL_OK);
+
+    image->pixel_format   = pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(image->width, pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    const bool bits8 = pixel_format == SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint16_t *source_scan = sail_scan_line(source, row);
+        uint8_t *scan8 = sail_scan_line(image, row);
+        uint16_t *scan16 = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++, source_scan += 4) {
+            if (bits8) {
+                *scan8++ = (uint8_t)(source_scan[0] >> 8);
+                *scan8++ = (uint8_t)(source_scan[3] >> 8);
+            } else {
+                *scan16++ = source_scan[0];
+                *scan16++ = source_scan[3];
+            }
+        }
+    }
+
+    return image;
+}
+
+/* Straightforward statistics of BPP32-RGBA or BPP64-RGBA pixels. */
+static void reference_statistics(const struct sail_image *image, struct sail_image_statistics *statistics) {
+
+    const bool bits8 = image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA;
+
+    memset(statistics, 0, sizeof(*statistics));
+
+    statistics->pixel_count = (uint64_t)image->width * image->height;
+    statistics->max_value   = bits8 ? 255 : 65535;
+    statistics->grayscale   = true;
+
+    uint64_t sums[4] = { 0, 0, 0, 0 };
+
+    for (unsigned c = 0; c < 4; c++) {
+        statistics->min[c] = statistics->max_value;
+    }
+
+    uint64_t colors[SAIL_STATISTICS_MAX_COLORS + 1];
+    unsigned color_count = 0;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            unsigned values[4];
+            uint64_t color = 0;
+
+            for (unsigned c = 0; c < 4; c++) {
+                if (bits8) {
+                    values[c] = scan[column * 4 + c];
+                } else {
+                    uint16_t value;
+                    memcpy(&value, scan + (column * 4 + c) * 2, sizeof(value));
+                    values[c] = value;
+                }
+
+                statistics->histograms[c][bits8 ? values[c] : values[c] >> 8]++;
+                statistics->min[c] = SAIL_MIN(statistics->min[c], values[c]);
+                statistics->max[c] = SAIL_MAX(statistics->max[c], values[c]);
+                sums[c] += values[c];
+
+                color = (color << 16) | values[c];
+            }
+
+            if (values[0] != values[1] || values[1] != values[2]) {
+                statistics->grayscale = false;
+            }
+
+            if (color_count <= SAIL_STATISTICS_MAX_COLORS) {
+                unsigned i = 0;
+
+                while (i < color_count && colors[i] != color) {
+                    i++;
+                }
+
+                if (i == color_count) {
+                    colors[color_count++] = color;
+                }
+            }
+        }
+    }
+
+    for (unsigned c = 0; c < 4; c++) {
+        statistics->mean[c] = (double)sums[c] / (double)statistics->pixel_count;
+    }
+
+    statistics->opaque      = statistics->min[SAIL_STATISTICS_CHANNEL_ALPHA] == statistics->max_value;
+    statistics->color_count = (color_count > SAIL_STATISTICS_MAX_COLORS) ? 0 : color_count;
+}
+
+static void assert_statistics_equal(const struct sail_image_statistics *statistics1, const struct sail_image_statistics *statistics2) {
+
+    munit_assert_uint64(statistics1->pixel_count, ==, statistics2->pixel_count);
+    munit_assert_uint(statistics1->max_value, ==, statistics2->max_value);
+    munit_assert_memory_equal(sizeof(statistics1->histograms), statistics1->histograms, statistics2->histograms);
+
+    for (unsigned c = 0; c < 4; c++) {
+        munit_assert_uint(statistics1->min[c], ==, statistics2->min[c]);
+        munit_assert_uint(statistics1->max[c], ==, statistics2->max[c]);
+        munit_assert_double_equal(statistics1->mean[c], statistics2->mean[c], 9);
+    }
+
+    munit_assert(statistics1->opaque == statistics2->opaque);
+    munit_assert(statistics1->grayscale == statistics2->grayscale);
+    munit_assert_uint(statistics1->color_count, ==, statistics2->color_count);
+}
+
+/* Statistics match the ones of the same pixels converted into BPP32-RGBA or BPP64-RGBA. */
+static void check_against_reference(const struct sail_image *image) {
+
+    struct sail_image_statistics *statistics;
+    munit_assert(sail_compute_image_statistics(image, &statistics) == SAIL_OK);
+
+    const enum SailPixelFormat reference_pixel_format = (statistics->max_value == 255)
+                                                            ? SAIL_PIXEL_FORMAT_BPP32_RGBA
+                                                            : SAIL_PIXEL_FORMAT_BPP64_RGBA;
+
+    struct sail_image *reference_image;
+    munit_assert(sail_convert_image(image, reference_pixel_format, &reference_image) == SAIL_OK);
+
+    struct sail_image_statistics reference;
+    reference_statistics(reference_image, &reference);
+
+    assert_statistics_equal(statistics, &reference);
+
+    sail_destroy_image(reference_image);
+    sail_destroy_image_statistics(statistics);
+}
+
+static MunitResult test_formats(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    static const enum Pixels PIXELS[] = { PIXELS_RANDOM, PIXELS_OPAQUE, PIXELS_GRAY, PIXELS_FEW_COLORS };
+
+    for (size_t p = 0; p < sizeof(PIXELS) / sizeof(PIXELS[0]); p++) {
+        struct sail_image *source = source_image(PIXELS[p]);
+
+        for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+            struct sail_image *image;
+
+            if (sail_can_convert(source->pixel_format, PIXEL_FORMATS[i])) {
+                munit_assert(sail_convert_image(source, PIXEL_FORMATS[i], &image) == SAIL_OK);
+            } else {
+                image = gray_alpha_image(source, PIXEL_FORMATS[i]);
+            }
+
+            check_against_reference(image);
+
+            sail_destroy_image(image);
+        }
+
+        sail_destroy_image(source);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_analysis(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *source = source_image(PIXELS_GRAY);
+    struct sail_image_statistics *statistics;
+
+    /* Random alpha. */
+    munit_assert(sail_compute_image_statistics(source, &statistics) == SAIL_OK);
+    munit_assert_uint(statistics->max_value, ==, 65535);
+    munit_assert(statistics->grayscale);
+    munit_assert_false(statistics->opaque);
+    munit_assert_uint(statistics->color_count, ==, 0);
+    sail_destroy_image_statistics(statistics);
+
+    /* No alpha. */
+    struct sail_image *image;
+    munit_assert(sail_convert_image(source, SAIL_PIXEL_FORMAT_BPP24_RGB, &image) == SAIL_OK);
+
+    munit_assert(sail_compute_image_statistics(image, &statistics) == SAIL_OK);
+    munit_assert_uint(statistics->max_value, ==, 255);
+    munit_assert(statistics->grayscale);
+    munit_assert(statistics->opaque);
+    munit_assert_uint64(statistics->histograms[SAIL_STATISTICS_CHANNEL_ALPHA][255], ==, (uint64_t)WIDTH * HEIGHT);
+    munit_assert_double(statistics->mean[SAIL_STATISTICS_CHANNEL_ALPHA], ==, 255);
+    sail_destroy_image_statistics(statistics);
+
+    /* A single different pixel at the end. */
+    uint8_t *pixel = (uint8_t *)sail_scan_line(image, HEIGHT - 1) + (WIDTH - 1) * 3;
+    pixel[1] ^= 1;
+
+    munit_assert(sail_compute_image_statistics(image, &statistics) == SAIL_OK);
+    munit_assert_false(statistics->grayscale);
+    sail_destroy_image_statistics(statistics);
+
+    /* Exactly SAIL_STATISTICS_MAX_COLORS colors and one more. */
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < WIDTH; column++, scan += 3) {
+            scan[0] = scan[1] = 0;
+            scan[2] = (uint8_t)(row * WIDTH + column);
+        }
+    }
+
+    munit_assert(sail_compute_image_statistics(image, &statistics) == SAIL_OK);
+    munit_assert_uint(statistics->color_count, ==, SAIL_STATISTICS_MAX_COLORS);
+    sail_destroy_image_statistics(statistics);
+
+    ((uint8_t *)image->pixels)[0] = 1;
+
+    munit_assert(sail_compute_image_statistics(image, &statistics) == SAIL_OK);
+    munit_assert_uint(statistics->color_count, ==, 0);
+    sail_destroy_image_statistics(statistics);
+
+    sail_destroy_image(image);
+    sail_destroy_image(source);
+
+    return MUNIT_OK;
+}
+
+/* Pixel formats without a direct analysis are converted. */
+static MunitResult test_fallback(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *source = source_image(PIXELS_FEW_COLORS);
+
+    struct sail_image *image;
+    munit_assert(sail_quantize_image(source, SAIL_PIXEL_FORMAT_BPP8_INDEXED, 0 /* max colors */, SAIL_DITHERING_NONE, &image) == SAIL_OK);
+    munit_assert(sail_can_compute_image_statistics(image->pixel_format));
+
+    struct sail_image_statistics *statistics;
+    munit_assert(sail_compute_image_statistics(image, &statistics) == SAIL_OK);
+    munit_assert_uint(statistics->color_count, ==, image->palette->color_count);
+    sail_destroy_image_statistics(statistics);
+
+    check_against_reference(image);
+
+    sail_destroy_image(image);
+    sail_destroy_image(source);
+
+    return MUNIT_OK;
+}
+
+/* The result doesn't depend on the number of threads. */
+static MunitResult test_threads(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = source_image(PIXELS_RANDOM);
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+
+    struct sail_image_statistics *parallel;
+    options->max_threads = 0;
+    munit_assert(sail_compute_image_statistics_with_options(image, options, &parallel) == SAIL_OK);
+
+    struct sail_image_statistics *serial;
+    options->max_threads = 1;
+    munit_assert(sail_compute_image_statistics_with_options(image, options, &serial) == SAIL_OK);
+
+    assert_statistics_equal(parallel, serial);
+
+    /* Copies are equal too. */
+    struct sail_image_statistics *copy;
+    munit_assert(sail_copy_image_statistics(serial, &copy) == SAIL_OK);
+    assert_statistics_equal(copy, serial);
+
+    sail_destroy_image_statistics(copy);
+    sail_destroy_image_statistics(serial);
+    sail_destroy_image_statistics(parallel);
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static enum SailPixelFormat closest(enum SailPixelFormat input_pixel_format, const struct sail_image_statistics *statistics,
+                                    enum SailPixelFormat *pixel_formats, unsigned pixel_formats_length) {
+
+    struct sail_save_features save_features;
+    memset(&save_features, 0, sizeof(save_features));
+
+    save_features.pixel_formats        = pixel_formats;
+    save_features.pixel_formats_length = pixel_formats_length;
+
+    return sail_closest_pixel_format_from_statistics(input_pixel_format, statistics, &save_features);
+}
+
+static MunitResult test_closest_pixel_format(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image_statistics statistics;
+    memset(&statistics, 0, sizeof(statistics));
+    statistics.max_value = 255;
+
+    enum SailPixelFormat pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP32_RGBA,
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,
+        SAIL_PIXEL_FORMAT_BPP8_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    };
+    const unsigned length = sizeof(pixel_formats) / sizeof(pixel_formats[0]);
+
+    /* Nothing to drop. */
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP32_RGBA, &statistics, pixel_formats, length), ==, SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    /* Only the supported conversions are selected. */
+    statistics.grayscale = true;
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP32_RGBA, &statistics, pixel_formats, length), ==, SAIL_PIXEL_FORMAT_BPP32_RGBA);
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA, &statistics, pixel_formats, length), ==, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA);
+
+    statistics.opaque = true;
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP32_RGBA, &statistics, pixel_formats, length), ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+
+    statistics.grayscale = false;
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP32_RGBA, &statistics, pixel_formats, length), ==, SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    statistics.color_count = 10;
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP32_RGBA, &statistics, pixel_formats, length), ==, SAIL_PIXEL_FORMAT_BPP8_INDEXED);
+
+    /* Only the listed pixel formats are selected. */
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP32_RGBA, &statistics, pixel_formats, 3), ==, SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    /* 16-bit pixels. */
+    enum SailPixelFormat pixel_formats16[] = {
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP64_RGBA,
+        SAIL_PIXEL_FORMAT_BPP48_RGB,
+        SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    };
+    const unsigned length16 = sizeof(pixel_formats16) / sizeof(pixel_formats16[0]);
+
+    statistics.max_value   = 65535;
+    statistics.grayscale   = true;
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP64_RGBA, &statistics, pixel_formats16, length16), ==, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE);
+
+    statistics.grayscale = false;
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP64_RGBA, &statistics, pixel_formats16, length16), ==, SAIL_PIXEL_FORMAT_BPP48_RGB);
+
+    statistics.opaque = false;
+    munit_assert_int(closest(SAIL_PIXEL_FORMAT_BPP64_RGBA, &statistics, pixel_formats16, length16), ==, SAIL_PIXEL_FORMAT_BPP64_RGBA);
+
+    /* No cheaper candidates. */
+    struct sail_save_features save_features;
+    memset(&save_features, 0, sizeof(save_features));
+    save_features.pixel_formats        = pixel_formats16;
+    save_features.pixel_formats_length = 1;
+
+    munit_assert_int(sail_closest_pixel_format_from_statistics(SAIL_PIXEL_FORMAT_BPP64_RGBA, &statistics, &save_features), ==,
+                     sail_closest_pixel_format_from_save_features(SAIL_PIXEL_FORMAT_BPP64_RGBA, &save_features));
+
+    munit_assert_int(sail_closest_pixel_format_from_statistics(SAIL_PIXEL_FORMAT_BPP64_RGBA, NULL, &save_features), ==, SAIL_PIXEL_FORMAT_UNKNOWN);
+    munit_assert_int(sail_closest_pixel_format_from_statistics(SAIL_PIXEL_FORMAT_BPP64_RGBA, &statistics, NULL), ==, SAIL_PIXEL_FORMAT_UNKNOWN);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = source_image(PIXELS_RANDOM);
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP64_CMYK;
+
+    munit_assert_false(sail_can_compute_image_statistics(image->pixel_format));
+
+    struct sail_image_statistics *statistics = NULL;
+    munit_assert(sail_compute_image_statistics(image, &statistics) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert_null(statistics);
+
+    munit_assert(sail_compute_image_statistics(image, NULL) == SAIL_ERROR_NULL_PTR);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/formats",              test_formats,              NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/analysis",             test_analysis,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/fallback",             test_fallback,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/threads",              test_threads,              NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/closest-pixel-format", test_closest_pixel_format, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported",          test_unsupported,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/statistics",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
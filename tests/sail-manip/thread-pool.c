@@ -0,0 +1,154 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+/* Large enough to be split into many blocks of scan lines. */
+static const unsigned WIDTH  = 1000;
+static const unsigned HEIGHT = 300;
+
+static MunitResult test_max_threads(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    munit_assert_uint(sail_max_threads(), ==, 0);
+
+    sail_set_max_threads(3);
+    munit_assert_uint(sail_max_threads(), ==, 3);
+
+    sail_set_max_threads(0);
+    munit_assert_uint(sail_max_threads(), ==, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_same_result(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* SIMD, row kernel, and generic conversions. */
+    static const enum SailPixelFormat PIXEL_FORMAT_PAIRS[][2] = {
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,  SAIL_PIXEL_FORMAT_BPP32_BGRA },
+        { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP48_RGB  },
+        { SAIL_PIXEL_FORMAT_BPP32_CMYK, SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    };
+
+    /* Use multiple threads even on single-core machines. */
+    sail_set_max_threads(4);
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMAT_PAIRS) / sizeof(PIXEL_FORMAT_PAIRS[0]); i++) {
+        struct sail_image *image;
+        munit_assert(sail_test_alloc_image(PIXEL_FORMAT_PAIRS[i][0], WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+        options->max_threads = 1;
+
+        struct sail_image *image_serial;
+        munit_assert(sail_convert_image_with_options(image, PIXEL_FORMAT_PAIRS[i][1], options, &image_serial) == SAIL_OK);
+
+        for (unsigned max_threads = 0; max_threads <= 4; max_threads++) {
+            options->max_threads = max_threads;
+
+            struct sail_image *image_parallel;
+            munit_assert(sail_convert_image_with_options(image, PIXEL_FORMAT_PAIRS[i][1], options, &image_parallel) == SAIL_OK);
+
+            munit_assert_memory_equal((size_t)HEIGHT * image_serial->bytes_per_line, image_parallel->pixels, image_serial->pixels);
+
+            sail_destroy_image(image_parallel);
+        }
+
+        sail_destroy_image(image_serial);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_conversion_options(options);
+    sail_set_max_threads(0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_error(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP8_INDEXED, WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+    /* Every other scan line has an index beyond the 16-color palette. */
+    memset(image->pixels, 0, (size_t)HEIGHT * image->bytes_per_line);
+
+    for (unsigned row = 1; row < HEIGHT; row += 2) {
+        uint8_t *scan = sail_scan_line(image, row);
+        scan[WIDTH / 2] = 200;
+    }
+
+    sail_destroy_palette(image->palette);
+    munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 16, &image->palette) == SAIL_OK);
+    memset(image->palette->data, 0, 16 * 3);
+
+    sail_set_max_threads(4);
+
+    struct sail_image *image_output = NULL;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_output) == SAIL_ERROR_BROKEN_IMAGE);
+    munit_assert_null(image_output);
+
+    sail_set_max_threads(0);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/max-threads", test_max_threads, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/same-result", test_same_result, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/error",       test_error,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/thread-pool",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,147 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+/* Odd width to test the scalar tails of SIMD conversions. */
+static const unsigned WIDTH  = 37;
+static const unsigned HEIGHT = 11;
+
+/* Compares the images in BPP64-RGBA to ignore X channels that may be left undefined. */
+static void assert_images_equal_in_rgba64(const struct sail_image *image1, const struct sail_image *image2) {
+
+    struct sail_image *image1_rgba;
+    munit_assert(sail_convert_image(image1, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image1_rgba) == SAIL_OK);
+
+    struct sail_image *image2_rgba;
+    munit_assert(sail_convert_image(image2, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image2_rgba) == SAIL_OK);
+
+    sail_test_assert_images_equal(image1_rgba, image2_rgba);
+
+    sail_destroy_image(image2_rgba);
+    sail_destroy_image(image1_rgba);
+}
+
+static MunitResult test_same_result(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Use multiple threads even on single-core machines. */
+    sail_set_max_threads(4);
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->background24 = (sail_rgb24_t){ 10, 20, 30 };
+    options->background48 = (sail_rgb48_t){ 1000, 2000, 3000 };
+
+    static const int OPTIONS[] = { 0, SAIL_CONVERSION_OPTION_BLEND_ALPHA };
+
+    for (size_t k = 0; k < sizeof(OPTIONS) / sizeof(OPTIONS[0]); k++) {
+        options->options = OPTIONS[k];
+
+        for (int input = SAIL_PIXEL_FORMAT_UNKNOWN + 1; input <= SAIL_PIXEL_FORMAT_BPP64_YUVA; input++) {
+            for (int output = SAIL_PIXEL_FORMAT_UNKNOWN + 1; output <= SAIL_PIXEL_FORMAT_BPP64_YUVA; output++) {
+                if (input == output || !sail_can_update(input, output)) {
+                    continue;
+                }
+
+                struct sail_image *image;
+                munit_assert(sail_test_alloc_image(input, WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+                struct sail_image *image_expected;
+                munit_assert(sail_convert_image_with_options(image, output, options, &image_expected) == SAIL_OK);
+
+                const unsigned bytes_per_line = image->bytes_per_line;
+                const void *pixels = image->pixels;
+
+                munit_assert(sail_update_image_with_options(image, output, options) == SAIL_OK);
+
+                /* Pixels are neither reallocated nor moved between scan lines. */
+                munit_assert_int(image->pixel_format, ==, output);
+                munit_assert_uint(image->bytes_per_line, ==, bytes_per_line);
+                munit_assert_ptr_equal(image->pixels, pixels);
+
+                assert_images_equal_in_rgba64(image, image_expected);
+
+                sail_destroy_image(image_expected);
+                sail_destroy_image(image);
+            }
+        }
+    }
+
+    sail_destroy_conversion_options(options);
+    sail_set_max_threads(0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_larger_output(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_can_update(SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP24_RGB));
+    munit_assert(sail_can_update(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP24_BGR));
+    munit_assert(!sail_can_update(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP32_RGBA));
+    munit_assert(!sail_can_update(SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP24_CIE_LAB));
+
+    struct sail_image *image;
+    munit_assert(sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, WIDTH, HEIGHT, 0, &image) == SAIL_OK);
+
+    munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/same-result",   test_same_result,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/larger-output", test_larger_output, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/update-in-place",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
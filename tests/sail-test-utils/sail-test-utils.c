@@ -0,0 +1,77 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020-2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail-common/sail-common.h>
+
+#include "sail-test-utils.h"
+
+#include "munit.h"
+
+sail_status_t sail_test_alloc_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height, unsigned padding,
+                                    struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width = width;
+    image_local->height = height;
+    image_local->pixel_format = pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(width, pixel_format) + padding;
+
+    const size_t pixels_size = sail_pixels_size(height, image_local->bytes_per_line, pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    munit_rand_memory(pixels_size, image_local->pixels);
+
+    if (sail_is_indexed(pixel_format)) {
+        const unsigned color_count = 1U << sail_bits_per_pixel(pixel_format);
+
+        SAIL_TRY_OR_CLEANUP(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, color_count, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+        munit_rand_memory((size_t)color_count * 3, image_local->palette->data);
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+void sail_test_assert_images_equal(const struct sail_image *image1, const struct sail_image *image2) {
+
+    munit_assert_not_null(image1);
+    munit_assert_not_null(image2);
+
+    munit_assert_uint(image1->width,  ==, image2->width);
+    munit_assert_uint(image1->height, ==, image2->height);
+    munit_assert_int(image1->pixel_format, ==, image2->pixel_format);
+
+    const unsigned bytes_per_line = sail_bytes_per_line(image1->width, image1->pixel_format);
+
+    for (unsigned row = 0; row < image1->height; row++) {
+        munit_assert_memory_equal(bytes_per_line, sail_scan_line(image1, row), sail_scan_line(image2, row));
+    }
+}
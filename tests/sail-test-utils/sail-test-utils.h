@@ -0,0 +1,48 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020-2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_TEST_UTILS_H
+#define SAIL_TEST_UTILS_H
+
+#include <sail-common/export.h>
+#include <sail-common/pixel.h>
+#include <sail-common/status.h>
+
+struct sail_image;
+
+/*
+ * Allocates a new image with random pixels. Scan lines are padded with the specified number of bytes.
+ * Indexed images get a random BPP24-RGB palette with all the colors addressable by their bits per pixel.
+ */
+SAIL_EXPORT sail_status_t sail_test_alloc_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height, unsigned padding,
+                                                struct sail_image **image);
+
+/*
+ * Asserts that the images have the same dimensions, pixel format, and pixels. Unlike sail_test_compare_images(),
+ * ignores scan line padding, palettes, and other image properties.
+ */
+SAIL_EXPORT void sail_test_assert_images_equal(const struct sail_image *image1, const struct sail_image *image2);
+
+#endif
@@ -0,0 +1,237 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#ifdef SAIL_HAVE_BUILTIN_PNG
+enum { WIDTH = 5, HEIGHT = 3, BUFFER_SIZE = 16 * 1024 };
+
+/* TIFF header and IFD0 with the only orientation tag. The value is at offset 18. */
+static void build_exif(uint16_t orientation, bool big_endian, uint8_t exif[26]) {
+
+    static const uint8_t EXIF_BIG_ENDIAN[26] = {
+        'M', 'M', 0, 42, 0, 0, 0, 8,
+        0, 1,
+        0x01, 0x12, 0, 3, 0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 0, 0,
+    };
+    static const uint8_t EXIF_LITTLE_ENDIAN[26] = {
+        'I', 'I', 42, 0, 8, 0, 0, 0,
+        1, 0,
+        0x12, 0x01, 3, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0,
+    };
+
+    memcpy(exif, big_endian ? EXIF_BIG_ENDIAN : EXIF_LITTLE_ENDIAN, 26);
+
+    exif[big_endian ? 19 : 18] = (uint8_t)orientation;
+}
+
+/* Every pixel stores its coordinates. */
+static sail_status_t save_png_into_memory(uint16_t orientation, bool big_endian, void *buffer) {
+
+    struct sail_image *image;
+    SAIL_TRY(sail_alloc_image(&image));
+
+    image->width          = WIDTH;
+    image->height         = HEIGHT;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(WIDTH, image->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image->bytes_per_line * HEIGHT, &image->pixels),
+                        /* cleanup */ sail_destroy_image(image));
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            *scan++ = (uint8_t)column;
+            *scan++ = (uint8_t)row;
+            *scan++ = 0x55;
+        }
+    }
+
+    uint8_t exif[26];
+    build_exif(orientation, big_endian, exif);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_node(&image->meta_data_node),
+                        /* cleanup */ sail_destroy_image(image));
+    SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_EXIF, &image->meta_data_node->meta_data),
+                        /* cleanup */ sail_destroy_image(image));
+    SAIL_TRY_OR_CLEANUP(sail_set_variant_data(image->meta_data_node->meta_data->value, exif, sizeof(exif)),
+                        /* cleanup */ sail_destroy_image(image));
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY_OR_CLEANUP(sail_codec_info_from_extension("png", &codec_info),
+                        /* cleanup */ sail_destroy_image(image));
+
+    struct sail_save_options *save_options;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_save_options_from_features(codec_info->save_features, &save_options),
+                        /* cleanup */ sail_destroy_image(image));
+    save_options->options |= SAIL_OPTION_META_DATA;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_memory_with_options(buffer, BUFFER_SIZE, codec_info, save_options, &state),
+                        /* cleanup */ sail_destroy_save_options(save_options),
+                                      sail_destroy_image(image));
+    sail_destroy_save_options(save_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image));
+    sail_destroy_image(image);
+
+    SAIL_TRY(sail_stop_saving(state));
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_png_from_memory(const void *buffer, int options, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_extension("png", &codec_info));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    load_options->options = options;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_memory_with_options(buffer, BUFFER_SIZE, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+    sail_destroy_load_options(load_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
+                        /* cleanup */ sail_stop_loading(state));
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
+
+/* Stored coordinates of the pixel that must appear at the row and column when the EXIF orientation is applied. */
+static void stored_coordinates(uint16_t orientation, unsigned row, unsigned column, unsigned *stored_row, unsigned *stored_column) {
+
+    switch (orientation) {
+        case 2:  { *stored_row = row;                 *stored_column = WIDTH - 1 - column; break; }
+        case 3:  { *stored_row = HEIGHT - 1 - row;    *stored_column = WIDTH - 1 - column; break; }
+        case 4:  { *stored_row = HEIGHT - 1 - row;    *stored_column = column;             break; }
+        case 5:  { *stored_row = column;              *stored_column = row;                break; }
+        case 6:  { *stored_row = HEIGHT - 1 - column; *stored_column = row;                break; }
+        case 7:  { *stored_row = HEIGHT - 1 - column; *stored_column = WIDTH - 1 - row;    break; }
+        case 8:  { *stored_row = column;              *stored_column = WIDTH - 1 - row;    break; }
+        default: { *stored_row = row;                 *stored_column = column;             break; }
+    }
+}
+
+static MunitResult test_auto_orient(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *buffer = munit_malloc(BUFFER_SIZE);
+
+    for (uint16_t orientation = 1; orientation <= 8; orientation++) {
+        const bool big_endian = orientation % 2 == 0;
+
+        memset(buffer, 0, BUFFER_SIZE);
+        munit_assert(save_png_into_memory(orientation, big_endian, buffer) == SAIL_OK);
+
+        /* EXIF is loaded only to rotate the frame. */
+        struct sail_image *image;
+        munit_assert(load_png_from_memory(buffer, SAIL_OPTION_AUTO_ORIENT | SAIL_OPTION_SOURCE_IMAGE, &image) == SAIL_OK);
+        munit_assert_null(image->meta_data_node);
+        munit_assert_not_null(image->source_image);
+
+        const bool transposed = orientation >= 5;
+        munit_assert_uint(image->width,  ==, transposed ? HEIGHT : WIDTH);
+        munit_assert_uint(image->height, ==, transposed ? WIDTH  : HEIGHT);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            const uint8_t *scan = sail_scan_line(image, row);
+
+            for (unsigned column = 0; column < image->width; column++) {
+                unsigned stored_row;
+                unsigned stored_column;
+                stored_coordinates(orientation, row, column, &stored_row, &stored_column);
+
+                munit_assert_uint8(scan[column * 3],     ==, stored_column);
+                munit_assert_uint8(scan[column * 3 + 1], ==, stored_row);
+            }
+        }
+
+        sail_destroy_image(image);
+
+        /* The orientation tag is reset in kept EXIF. */
+        munit_assert(load_png_from_memory(buffer, SAIL_OPTION_AUTO_ORIENT | SAIL_OPTION_META_DATA, &image) == SAIL_OK);
+        munit_assert_not_null(image->meta_data_node);
+        munit_assert(image->meta_data_node->meta_data->key == SAIL_META_DATA_EXIF);
+
+        const uint8_t *exif = sail_variant_to_data(image->meta_data_node->meta_data->value);
+        munit_assert_uint8(exif[big_endian ? 19 : 18], ==, 1);
+
+        sail_destroy_image(image);
+
+        /* No rotation without the option. */
+        munit_assert(load_png_from_memory(buffer, SAIL_OPTION_META_DATA, &image) == SAIL_OK);
+        munit_assert_uint(image->width,  ==, WIDTH);
+        munit_assert_uint(image->height, ==, HEIGHT);
+
+        exif = sail_variant_to_data(image->meta_data_node->meta_data->value);
+        munit_assert_uint8(exif[big_endian ? 19 : 18], ==, orientation);
+
+        sail_destroy_image(image);
+    }
+
+    free(buffer);
+
+    return MUNIT_OK;
+}
+#endif
+
+static MunitTest test_suite_tests[] = {
+#ifdef SAIL_HAVE_BUILTIN_PNG
+    { (char *)"/auto-orient", test_auto_orient, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#endif
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/auto-orient",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,240 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static bool always_canceled(void *user_data) {
+    (void)user_data;
+
+    return true;
+}
+
+/* Cancels on the second check to abort in the middle of a frame. */
+static bool canceled_after_first_check(void *user_data) {
+
+    unsigned *checks = user_data;
+
+    return ++(*checks) > 1;
+}
+
+static bool can_save_pixel_format(const struct sail_save_features *save_features, enum SailPixelFormat pixel_format) {
+
+    for (unsigned i = 0; i < save_features->pixel_formats_length; i++) {
+        if (save_features->pixel_formats[i] == pixel_format) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static sail_status_t load_with_token(const char *path, const struct sail_cancel_token *cancel_token, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    load_options->cancel_token = cancel_token;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
+                        /* cleanup */ sail_stop_loading(state));
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
+
+static MunitResult test_load_canceled(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_cancel_token cancel_token = { .is_canceled = always_canceled };
+
+    struct sail_image *image = NULL;
+    munit_assert(load_with_token(path, &cancel_token, &image) == SAIL_ERROR_CANCELED);
+    munit_assert_null(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_deadline(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image = NULL;
+
+    /* Far deadline. */
+    struct sail_cancel_token cancel_token = { .deadline = sail_now() + 60 * 1000 };
+    munit_assert(load_with_token(path, &cancel_token, &image) == SAIL_OK);
+    munit_assert_not_null(image);
+    sail_destroy_image(image);
+    image = NULL;
+
+    /* Expired deadline. */
+    cancel_token.deadline = 1;
+    munit_assert(load_with_token(path, &cancel_token, &image) == SAIL_ERROR_CANCELED);
+    munit_assert_null(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_mid_frame(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    unsigned checks = 0;
+    struct sail_cancel_token cancel_token = { .is_canceled = canceled_after_first_check, .user_data = &checks };
+
+    /* Codecs without per scan line checks finish the frame. */
+    struct sail_image *image = NULL;
+    const sail_status_t status = load_with_token(path, &cancel_token, &image);
+
+    if (status == SAIL_OK) {
+        munit_assert_not_null(image);
+        sail_destroy_image(image);
+    } else {
+        munit_assert(status == SAIL_ERROR_CANCELED);
+        munit_assert_null(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save_canceled(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    if (!can_save_pixel_format(codec_info->save_features, image->pixel_format)) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+
+    struct sail_cancel_token cancel_token = { .is_canceled = always_canceled };
+    save_options->cancel_token = &cancel_token;
+
+    const size_t buffer_size = (size_t)image->bytes_per_line * image->height * 2 + 64 * 1024;
+    void *buffer = munit_malloc(buffer_size);
+
+    void *state;
+    munit_assert(sail_start_saving_into_memory_with_options(buffer, buffer_size, codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_ERROR_CANCELED);
+    sail_stop_saving(state);
+
+    free(buffer);
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_canceled(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    if (!sail_can_convert(image->pixel_format, SAIL_PIXEL_FORMAT_BPP32_RGBA)) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+
+    struct sail_cancel_token cancel_token = { .is_canceled = always_canceled };
+    options->cancel_token = &cancel_token;
+
+    struct sail_image *image_output = NULL;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, options, &image_output) == SAIL_ERROR_CANCELED);
+    munit_assert_null(image_output);
+
+    options->cancel_token = NULL;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, options, &image_output) == SAIL_OK);
+    munit_assert_not_null(image_output);
+
+    sail_destroy_image(image_output);
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load-canceled",    test_load_canceled,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-deadline",    test_load_deadline,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-mid-frame",   test_load_mid_frame,   NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/save-canceled",    test_save_canceled,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/convert-canceled", test_convert_canceled, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/cancel",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
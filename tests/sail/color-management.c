@@ -0,0 +1,252 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#ifdef SAIL_HAVE_BUILTIN_PNG
+enum { WIDTH = 256, BUFFER_SIZE = 16 * 1024 };
+
+static void put_be32(uint8_t *data, uint32_t value) {
+
+    data[0] = (uint8_t)(value >> 24);
+    data[1] = (uint8_t)(value >> 16);
+    data[2] = (uint8_t)(value >> 8);
+    data[3] = (uint8_t)value;
+}
+
+/*
+ * Grayscale profile with the kTRC tag of the type. 'curv' tags with no entries are linear.
+ * libpng doesn't read tiny compressed profiles, so a private tag with noise is added.
+ */
+static sail_status_t build_gray_iccp(const char *curve_type, struct sail_iccp **iccp) {
+
+    enum { NOISE_SIZE = 1024, SIZE = 128 + 4 + 2 * 12 + 12 + NOISE_SIZE };
+
+    struct sail_iccp *iccp_local;
+    SAIL_TRY(sail_alloc_iccp_for_data(SIZE, &iccp_local));
+
+    uint8_t *data = iccp_local->data;
+    memset(data, 0, SIZE);
+
+    put_be32(data, SIZE);
+    put_be32(data + 8, 0x02100000);
+    memcpy(data + 12, "mntr", 4);
+    memcpy(data + 16, "GRAY", 4);
+    memcpy(data + 20, "XYZ ", 4);
+    memcpy(data + 36, "acsp", 4);
+
+    /* D50 illuminant. */
+    put_be32(data + 68, 0xF6D6);
+    put_be32(data + 72, 0x10000);
+    put_be32(data + 76, 0xD32D);
+
+    put_be32(data + 128, 2);
+
+    memcpy(data + 132, "kTRC", 4);
+    put_be32(data + 136, 156);
+    put_be32(data + 140, 12);
+    memcpy(data + 156, curve_type, 4);
+
+    memcpy(data + 144, "zzzz", 4);
+    put_be32(data + 148, 168);
+    put_be32(data + 152, NOISE_SIZE);
+
+    uint32_t seed = 1;
+
+    for (unsigned i = 0; i < NOISE_SIZE; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[168 + i] = (uint8_t)(seed >> 16);
+    }
+
+    *iccp = iccp_local;
+
+    return SAIL_OK;
+}
+
+/* The scan line has all the grayscale values. */
+static sail_status_t save_png_into_memory(const char *curve_type, void *buffer) {
+
+    struct sail_image *image;
+    SAIL_TRY(sail_alloc_image(&image));
+
+    image->width          = WIDTH;
+    image->height         = 1;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+    image->bytes_per_line = sail_bytes_per_line(WIDTH, image->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(image->bytes_per_line, &image->pixels),
+                        /* cleanup */ sail_destroy_image(image));
+
+    for (unsigned column = 0; column < WIDTH; column++) {
+        ((uint8_t *)image->pixels)[column] = (uint8_t)column;
+    }
+
+    SAIL_TRY_OR_CLEANUP(build_gray_iccp(curve_type, &image->iccp),
+                        /* cleanup */ sail_destroy_image(image));
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY_OR_CLEANUP(sail_codec_info_from_extension("png", &codec_info),
+                        /* cleanup */ sail_destroy_image(image));
+
+    struct sail_save_options *save_options;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_save_options_from_features(codec_info->save_features, &save_options),
+                        /* cleanup */ sail_destroy_image(image));
+    save_options->options |= SAIL_OPTION_ICCP;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_memory_with_options(buffer, BUFFER_SIZE, codec_info, save_options, &state),
+                        /* cleanup */ sail_destroy_save_options(save_options),
+                                      sail_destroy_image(image));
+    sail_destroy_save_options(save_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image));
+    sail_destroy_image(image);
+
+    SAIL_TRY(sail_stop_saving(state));
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_png_from_memory(const void *buffer, int options, enum SailPixelFormat output_pixel_format,
+                                            struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_extension("png", &codec_info));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    load_options->options             = options;
+    load_options->output_pixel_format = output_pixel_format;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_memory_with_options(buffer, BUFFER_SIZE, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+    sail_destroy_load_options(load_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
+                        /* cleanup */ sail_stop_loading(state));
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
+
+static double srgb_encode(double value) {
+
+    return (value <= 0.0031308) ? value * 12.92 : 1.055 * pow(value, 1 / 2.4) - 0.055;
+}
+
+static MunitResult test_linear_gray(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *buffer = munit_malloc(BUFFER_SIZE);
+    munit_assert(save_png_into_memory("curv", buffer) == SAIL_OK);
+
+    /* Without color management, pixels are stored values. */
+    struct sail_image *image;
+    munit_assert(load_png_from_memory(buffer, SAIL_OPTION_ICCP, SAIL_PIXEL_FORMAT_UNKNOWN, &image) == SAIL_OK);
+    munit_assert_not_null(image->iccp);
+
+    for (unsigned column = 0; column < WIDTH; column++) {
+        munit_assert_uint8(((const uint8_t *)image->pixels)[column], ==, column);
+    }
+
+    sail_destroy_image(image);
+
+    /* The profile is loaded only to transform the colors, and RGB frames get sRGB gray values. */
+    static const enum SailPixelFormat OUTPUT_PIXEL_FORMATS[] = { SAIL_PIXEL_FORMAT_UNKNOWN, SAIL_PIXEL_FORMAT_BPP32_RGBA };
+
+    for (size_t i = 0; i < sizeof(OUTPUT_PIXEL_FORMATS) / sizeof(OUTPUT_PIXEL_FORMATS[0]); i++) {
+        munit_assert(load_png_from_memory(buffer, SAIL_OPTION_COLOR_MANAGEMENT, OUTPUT_PIXEL_FORMATS[i], &image) == SAIL_OK);
+        munit_assert_null(image->iccp);
+
+        const unsigned channels = (image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA) ? 4 : 1;
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            const double expected = srgb_encode(column / 255.0) * 255;
+            munit_assert_double(fabs(((const uint8_t *)image->pixels)[column * channels] - expected), <=, 1);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *buffer = munit_malloc(BUFFER_SIZE);
+    munit_assert(save_png_into_memory("mft2", buffer) == SAIL_OK);
+
+    /* Frames are loaded as is and keep their profiles. */
+    struct sail_image *image;
+    munit_assert(load_png_from_memory(buffer, SAIL_OPTION_COLOR_MANAGEMENT, SAIL_PIXEL_FORMAT_UNKNOWN, &image) == SAIL_OK);
+    munit_assert_not_null(image->iccp);
+
+    for (unsigned column = 0; column < WIDTH; column++) {
+        munit_assert_uint8(((const uint8_t *)image->pixels)[column], ==, column);
+    }
+
+    sail_destroy_image(image);
+    free(buffer);
+
+    return MUNIT_OK;
+}
+#endif
+
+static MunitTest test_suite_tests[] = {
+#ifdef SAIL_HAVE_BUILTIN_PNG
+    { (char *)"/linear-gray", test_linear_gray, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported", test_unsupported, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#endif
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/color-management",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
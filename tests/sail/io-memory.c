@@ -0,0 +1,197 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+enum { BUFFER_SIZE = 100 };
+
+static MunitResult test_write(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    uint8_t buffer[BUFFER_SIZE];
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_memory(buffer, sizeof(buffer), &io) == SAIL_OK);
+
+    /* The stream is empty. */
+    bool eof;
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert(eof);
+
+    static const char DATA[] = "0123456789";
+    munit_assert(io->strict_write(io->stream, DATA, 10) == SAIL_OK);
+
+    /* The end of the stream is the end of the written data. */
+    size_t offset;
+    munit_assert(io->seek(io->stream, 0, SEEK_END) == SAIL_OK);
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, 10);
+
+    /* Only the written data is read back. */
+    char data[BUFFER_SIZE];
+    size_t read_size;
+    munit_assert(io->seek(io->stream, 0, SEEK_SET) == SAIL_OK);
+    munit_assert(io->tolerant_read(io->stream, data, sizeof(data), &read_size) == SAIL_OK);
+    munit_assert_size(read_size, ==, 10);
+    munit_assert_memory_equal(10, data, DATA);
+
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert(eof);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_seek(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    uint8_t buffer[BUFFER_SIZE];
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_memory(buffer, sizeof(buffer), &io) == SAIL_OK);
+
+    /* Seeking past the end grows the stream exactly to the position. */
+    size_t offset;
+    munit_assert(io->seek(io->stream, 40, SEEK_SET) == SAIL_OK);
+    munit_assert(io->seek(io->stream, 0, SEEK_END) == SAIL_OK);
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, 40);
+
+    /* Seeking back doesn't shrink it. */
+    munit_assert(io->seek(io->stream, 10, SEEK_SET) == SAIL_OK);
+    munit_assert(io->seek(io->stream, 0, SEEK_END) == SAIL_OK);
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, 40);
+
+    /* Positions are clamped to the buffer. */
+    munit_assert(io->seek(io->stream, 1000, SEEK_SET) == SAIL_OK);
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, BUFFER_SIZE);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+/* Read/write memory streams keep the whole buffer accessible. */
+static MunitResult test_read_write(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    uint8_t buffer[BUFFER_SIZE];
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_write_memory(buffer, sizeof(buffer), &io) == SAIL_OK);
+
+    size_t offset;
+    munit_assert(io->seek(io->stream, 0, SEEK_END) == SAIL_OK);
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, BUFFER_SIZE);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+#ifdef SAIL_HAVE_BUILTIN_PNG
+enum { WIDTH = 16, HEIGHT = 16, IMAGE_BUFFER_SIZE = 64 * 1024 };
+
+/* The written size is the size of the saved image, not the buffer size. */
+static MunitResult test_saved_size(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = WIDTH;
+    image->height         = HEIGHT;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(WIDTH, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * HEIGHT, &image->pixels) == SAIL_OK);
+    memset(image->pixels, 0x80, (size_t)image->bytes_per_line * HEIGHT);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("png", &codec_info) == SAIL_OK);
+
+    void *buffer = munit_malloc(IMAGE_BUFFER_SIZE);
+
+    void *state;
+    munit_assert(sail_start_saving_into_memory(buffer, IMAGE_BUFFER_SIZE, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    size_t written;
+    munit_assert(sail_stop_saving_with_written(state, &written) == SAIL_OK);
+    munit_assert_size(written, >, 0);
+    munit_assert_size(written, <, IMAGE_BUFFER_SIZE);
+
+    /* The written bytes are the whole image. */
+    struct sail_image *loaded;
+    munit_assert(sail_load_from_memory(buffer, written, &loaded) == SAIL_OK);
+    munit_assert_uint(loaded->width, ==, WIDTH);
+    munit_assert_uint(loaded->height, ==, HEIGHT);
+
+    sail_destroy_image(loaded);
+    free(buffer);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+#endif
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/write",       test_write,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/seek",        test_seek,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/read-write",  test_read_write,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#ifdef SAIL_HAVE_BUILTIN_PNG
+    { (char *)"/saved-size",  test_saved_size,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#endif
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/io-memory",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
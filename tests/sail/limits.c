@@ -0,0 +1,196 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Loads all the frames with the specified limits and returns the number of loaded frames. */
+static sail_status_t load_with_limits(const char *path, const struct sail_load_options *limits, unsigned *frames) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    load_options->max_width          = limits->max_width;
+    load_options->max_height         = limits->max_height;
+    load_options->max_pixels         = limits->max_pixels;
+    load_options->max_memory         = limits->max_memory;
+    load_options->max_frames         = limits->max_frames;
+    load_options->max_meta_data_size = limits->max_meta_data_size;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    *frames = 0;
+
+    struct sail_image *image;
+    sail_status_t status;
+
+    while ((status = sail_load_next_frame(state, &image)) == SAIL_OK) {
+        (*frames)++;
+        sail_destroy_image(image);
+    }
+
+    sail_stop_loading(state);
+
+    return (status == SAIL_ERROR_NO_MORE_FRAMES) ? SAIL_OK : status;
+}
+
+static MunitResult test_dimensions(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    struct sail_load_options limits = { 0 };
+    unsigned frames;
+
+    limits.max_width  = image->width;
+    limits.max_height = image->height;
+    limits.max_pixels = (uint64_t)image->width * image->height;
+    munit_assert(load_with_limits(path, &limits, &frames) == SAIL_OK);
+
+    limits.max_height = image->height - 1;
+    if (limits.max_height > 0) {
+        munit_assert(load_with_limits(path, &limits, &frames) == SAIL_ERROR_LIMIT_EXCEEDED);
+        munit_assert_uint(frames, ==, 0);
+    }
+
+    limits.max_height = 0;
+    limits.max_pixels = (uint64_t)image->width * image->height - 1;
+    if (limits.max_pixels > 0) {
+        munit_assert(load_with_limits(path, &limits, &frames) == SAIL_ERROR_LIMIT_EXCEEDED);
+        munit_assert_uint(frames, ==, 0);
+    }
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_memory(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    struct sail_load_options limits = { 0 };
+    unsigned frames;
+
+    /* Pixels of the frame are the largest allocation. */
+    limits.max_memory = (size_t)image->bytes_per_line * image->height - 1;
+    munit_assert(load_with_limits(path, &limits, &frames) == SAIL_ERROR_LIMIT_EXCEEDED);
+    munit_assert_uint(frames, ==, 0);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_frames(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_load_options limits = { 0 };
+    unsigned frames;
+    munit_assert(load_with_limits(path, &limits, &frames) == SAIL_OK);
+    munit_assert_uint(frames, >, 0);
+
+    const unsigned all_frames = frames;
+
+    limits.max_frames = all_frames;
+    munit_assert(load_with_limits(path, &limits, &frames) == SAIL_OK);
+    munit_assert_uint(frames, ==, all_frames);
+
+    if (all_frames > 1) {
+        limits.max_frames = all_frames - 1;
+        munit_assert(load_with_limits(path, &limits, &frames) == SAIL_ERROR_LIMIT_EXCEEDED);
+        munit_assert_uint(frames, ==, all_frames - 1);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_meta_data(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    const bool has_meta_data = image->meta_data_node != NULL || image->iccp != NULL;
+    sail_destroy_image(image);
+
+    if (!has_meta_data) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_load_options limits = { .max_meta_data_size = 1 };
+    unsigned frames;
+    munit_assert(load_with_limits(path, &limits, &frames) == SAIL_ERROR_LIMIT_EXCEEDED);
+    munit_assert_uint(frames, ==, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/dimensions", test_dimensions, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/memory",     test_memory,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/frames",     test_frames,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/meta-data",  test_meta_data,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/limits",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,188 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+#ifdef SAIL_HAVE_BUILTIN_PNG
+enum { WIDTH = 200, HEIGHT = 50, BUFFER_SIZE = 256 * 1024 };
+
+/* Opaque gray BPP32-RGBA pixels with the column values. */
+static struct sail_image* gray_rgba_image(void) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = WIDTH;
+    image->height         = HEIGHT;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image->bytes_per_line = sail_bytes_per_line(WIDTH, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * HEIGHT, &image->pixels) == SAIL_OK);
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            *scan++ = (uint8_t)column;
+            *scan++ = (uint8_t)column;
+            *scan++ = (uint8_t)column;
+            *scan++ = 255;
+        }
+    }
+
+    return image;
+}
+
+static size_t save_png_into_memory(const struct sail_image *image, void *buffer) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("png", &codec_info) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_saving_into_memory(buffer, BUFFER_SIZE, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    size_t written;
+    munit_assert(sail_stop_saving_with_written(state, &written) == SAIL_OK);
+
+    return written;
+}
+
+static struct sail_image* load_png_from_memory(const void *buffer, size_t size, int options) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("png", &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    load_options->options = options;
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer, size, codec_info, load_options, &state) == SAIL_OK);
+    sail_destroy_load_options(load_options);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    return image;
+}
+
+static MunitResult test_load_statistics(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    void *buffer = munit_malloc(BUFFER_SIZE);
+
+    struct sail_image *image = gray_rgba_image();
+    size_t written = save_png_into_memory(image, buffer);
+    sail_destroy_image(image);
+
+    /* No statistics without the option. */
+    image = load_png_from_memory(buffer, written, SAIL_OPTION_META_DATA);
+    munit_assert_null(image->statistics);
+    sail_destroy_image(image);
+
+    image = load_png_from_memory(buffer, written, SAIL_OPTION_META_DATA | SAIL_OPTION_STATISTICS);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    const struct sail_image_statistics *statistics = image->statistics;
+    munit_assert_not_null(statistics);
+    munit_assert_uint64(statistics->pixel_count, ==, WIDTH * HEIGHT);
+    munit_assert(statistics->opaque);
+    munit_assert(statistics->grayscale);
+    munit_assert_uint(statistics->color_count, ==, WIDTH);
+    munit_assert_uint(statistics->min[SAIL_STATISTICS_CHANNEL_GREEN], ==, 0);
+    munit_assert_uint(statistics->max[SAIL_STATISTICS_CHANNEL_GREEN], ==, WIDTH - 1);
+
+    /* Copies keep the statistics. */
+    struct sail_image *copy;
+    munit_assert(sail_copy_image(image, &copy) == SAIL_OK);
+    munit_assert_not_null(copy->statistics);
+    munit_assert_uint(copy->statistics->color_count, ==, WIDTH);
+    sail_destroy_image(copy);
+
+    /* The cheapest pixel format keeps the pixels intact. */
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("png", &codec_info) == SAIL_OK);
+
+    const enum SailPixelFormat pixel_format = sail_closest_pixel_format_from_statistics(image->pixel_format, statistics,
+                                                                                        codec_info->save_features);
+    munit_assert_int(pixel_format, ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+
+    struct sail_image *gray;
+    munit_assert(sail_convert_image(image, pixel_format, &gray) == SAIL_OK);
+    sail_destroy_image(image);
+
+    written = save_png_into_memory(gray, buffer);
+    sail_destroy_image(gray);
+
+    image = load_png_from_memory(buffer, written, 0);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            munit_assert_uint8(scan[column], ==, column);
+        }
+    }
+
+    sail_destroy_image(image);
+    free(buffer);
+
+    return MUNIT_OK;
+}
+#endif
+
+static MunitTest test_suite_tests[] = {
+#ifdef SAIL_HAVE_BUILTIN_PNG
+    { (char *)"/load-statistics", test_load_statistics, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#endif
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/load-statistics",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,358 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static const enum SailPixelFormat OUTPUT_PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP24_RGB,
+    SAIL_PIXEL_FORMAT_BPP24_BGR,
+    SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    SAIL_PIXEL_FORMAT_BPP32_BGRA,
+    SAIL_PIXEL_FORMAT_BPP32_ARGB,
+    SAIL_PIXEL_FORMAT_BPP32_BGRX,
+    SAIL_PIXEL_FORMAT_BPP32_XRGB,
+    SAIL_PIXEL_FORMAT_BPP64_RGBA,
+};
+
+static sail_status_t load_as(const char *path, enum SailPixelFormat output_pixel_format, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    load_options->output_pixel_format = output_pixel_format;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
+                        /* cleanup */ sail_stop_loading(state));
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
+
+static const enum SailPixelFormat PLANAR_PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP12_YUV420P,
+    SAIL_PIXEL_FORMAT_BPP12_NV12,
+    SAIL_PIXEL_FORMAT_BPP24_YUV444P,
+};
+
+static bool has_filler(enum SailPixelFormat pixel_format) {
+
+    return pixel_format == SAIL_PIXEL_FORMAT_BPP32_BGRX || pixel_format == SAIL_PIXEL_FORMAT_BPP32_XRGB;
+}
+
+/*
+ * Codecs may convert colors with a slightly different rounding, for example, take
+ * the JPEG luma as is instead of computing it from RGB. Filler bytes are undefined,
+ * so such images are compared as RGB.
+ */
+static void assert_pixels_close(const struct sail_image *image, const struct sail_image *expected) {
+
+    if (has_filler(image->pixel_format)) {
+        struct sail_image *image_rgb;
+        struct sail_image *expected_rgb;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_rgb) == SAIL_OK);
+        munit_assert(sail_convert_image(expected, SAIL_PIXEL_FORMAT_BPP24_RGB, &expected_rgb) == SAIL_OK);
+
+        assert_pixels_close(image_rgb, expected_rgb);
+
+        sail_destroy_image(expected_rgb);
+        sail_destroy_image(image_rgb);
+        return;
+    }
+
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned char *actual_scan = sail_scan_line(image, row);
+        const unsigned char *expected_scan = sail_scan_line(expected, row);
+
+        for (unsigned byte = 0; byte < bytes_per_line; byte++) {
+            munit_assert_int(abs(actual_scan[byte] - expected_scan[byte]), <=, 2);
+        }
+    }
+}
+
+static MunitResult test_output_pixel_format(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *original;
+    munit_assert(sail_load_from_file(path, &original) == SAIL_OK);
+
+    for (size_t i = 0; i < sizeof(OUTPUT_PIXEL_FORMATS) / sizeof(OUTPUT_PIXEL_FORMATS[0]); i++) {
+        const enum SailPixelFormat output_pixel_format = OUTPUT_PIXEL_FORMATS[i];
+
+        if (!sail_can_convert(original->pixel_format, output_pixel_format)) {
+            continue;
+        }
+
+        struct sail_image *image = NULL;
+        munit_assert(load_as(path, output_pixel_format, &image) == SAIL_OK);
+        munit_assert(sail_check_image_valid(image) == SAIL_OK);
+        munit_assert(image->pixel_format == output_pixel_format);
+        munit_assert_uint(image->width,  ==, original->width);
+        munit_assert_uint(image->height, ==, original->height);
+
+        struct sail_image *expected;
+        munit_assert(sail_convert_image(original, output_pixel_format, &expected) == SAIL_OK);
+
+        assert_pixels_close(image, expected);
+
+        sail_destroy_image(expected);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_image(original);
+
+    return MUNIT_OK;
+}
+
+/*
+ * JPEG reads the chroma planes as stored, while the reference converts upsampled
+ * and rounded RGB pixels back, so the planes are compared by the mean difference.
+ */
+static void assert_planes_close(const struct sail_image *image, const struct sail_image *expected) {
+
+    void *planes[3];
+    void *expected_planes[3];
+    unsigned planes_bytes_per_line[3];
+    unsigned planes_height[3];
+
+    const unsigned planes_count = sail_planes(image->pixel_format, image->pixels, image->height, image->bytes_per_line,
+                                                planes, planes_bytes_per_line, planes_height);
+    munit_assert_uint(sail_planes(expected->pixel_format, expected->pixels, expected->height, expected->bytes_per_line,
+                                    expected_planes, planes_bytes_per_line, planes_height), ==, planes_count);
+
+    for (unsigned plane = 0; plane < planes_count; plane++) {
+        const size_t size = (size_t)planes_bytes_per_line[plane] * planes_height[plane];
+        const unsigned char *actual_bytes = planes[plane];
+        const unsigned char *expected_bytes = expected_planes[plane];
+        size_t difference = 0;
+
+        for (size_t i = 0; i < size; i++) {
+            difference += abs(actual_bytes[i] - expected_bytes[i]);
+        }
+
+        munit_assert_double((double)difference / size, <=, 2.0);
+    }
+}
+
+static MunitResult test_planar(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *original;
+    munit_assert(sail_load_from_file(path, &original) == SAIL_OK);
+
+    for (size_t i = 0; i < sizeof(PLANAR_PIXEL_FORMATS) / sizeof(PLANAR_PIXEL_FORMATS[0]); i++) {
+        const enum SailPixelFormat output_pixel_format = PLANAR_PIXEL_FORMATS[i];
+
+        if (!sail_can_convert(original->pixel_format, output_pixel_format)) {
+            continue;
+        }
+
+        struct sail_image *image = NULL;
+        munit_assert(load_as(path, output_pixel_format, &image) == SAIL_OK);
+        munit_assert(sail_check_image_valid(image) == SAIL_OK);
+        munit_assert(image->pixel_format == output_pixel_format);
+        munit_assert_uint(image->bytes_per_line, ==, original->width);
+
+        struct sail_image *expected;
+        munit_assert(sail_convert_image(original, output_pixel_format, &expected) == SAIL_OK);
+
+        assert_planes_close(image, expected);
+
+        sail_destroy_image(expected);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_image(original);
+
+    return MUNIT_OK;
+}
+
+#ifdef SAIL_HAVE_BUILTIN_JPEG
+static sail_status_t load_from_memory_as(const void *buffer, size_t buffer_size, enum SailPixelFormat output_pixel_format, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_extension("jpeg", &codec_info));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    load_options->output_pixel_format = output_pixel_format;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_memory_with_options(buffer, buffer_size, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
+                        /* cleanup */ sail_stop_loading(state));
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
+
+/* libjpeg subsamples YCbCr images 2x2 by default, so the planes of such an image are read as is. */
+static MunitResult test_jpeg_raw_data(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    enum { WIDTH = 37, HEIGHT = 23, BUFFER_SIZE = 64 * 1024 };
+
+    struct sail_image *gradient;
+    munit_assert(sail_alloc_image(&gradient) == SAIL_OK);
+
+    gradient->width          = WIDTH;
+    gradient->height         = HEIGHT;
+    gradient->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    gradient->bytes_per_line = sail_bytes_per_line(WIDTH, gradient->pixel_format);
+    gradient->pixels         = munit_malloc((size_t)gradient->bytes_per_line * HEIGHT);
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        unsigned char *scan = sail_scan_line(gradient, row);
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            *scan++ = (unsigned char)(column * 6);
+            *scan++ = (unsigned char)(row * 10);
+            *scan++ = (unsigned char)(255 - column * 3 - row * 4);
+        }
+    }
+
+    struct sail_image *ycbcr;
+    munit_assert(sail_convert_image(gradient, SAIL_PIXEL_FORMAT_BPP24_YCBCR, &ycbcr) == SAIL_OK);
+    sail_destroy_image(gradient);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpeg", &codec_info) == SAIL_OK);
+
+    void *buffer = munit_malloc(BUFFER_SIZE);
+    void *state;
+    munit_assert(sail_start_saving_into_memory(buffer, BUFFER_SIZE, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, ycbcr) == SAIL_OK);
+    munit_assert(sail_stop_saving(state) == SAIL_OK);
+    sail_destroy_image(ycbcr);
+
+    struct sail_image *original;
+    munit_assert(load_from_memory_as(buffer, BUFFER_SIZE, SAIL_PIXEL_FORMAT_BPP24_RGB, &original) == SAIL_OK);
+
+    for (size_t i = 0; i < sizeof(PLANAR_PIXEL_FORMATS) / sizeof(PLANAR_PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image;
+        munit_assert(load_from_memory_as(buffer, BUFFER_SIZE, PLANAR_PIXEL_FORMATS[i], &image) == SAIL_OK);
+        munit_assert(image->pixel_format == PLANAR_PIXEL_FORMATS[i]);
+        munit_assert_uint(image->width,  ==, WIDTH);
+        munit_assert_uint(image->height, ==, HEIGHT);
+
+        struct sail_image *expected;
+        munit_assert(sail_convert_image(original, PLANAR_PIXEL_FORMATS[i], &expected) == SAIL_OK);
+
+        assert_planes_close(image, expected);
+
+        sail_destroy_image(expected);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_image(original);
+    free(buffer);
+
+    return MUNIT_OK;
+}
+#endif
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_probe_file(path, &image, NULL) == SAIL_OK);
+
+    const bool convertible = image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED ||
+                                sail_can_convert(image->pixel_format, SAIL_PIXEL_FORMAT_BPP8_INDEXED);
+
+    sail_destroy_image(image);
+
+    if (convertible) {
+        return MUNIT_SKIP;
+    }
+
+    image = NULL;
+    munit_assert(load_as(path, SAIL_PIXEL_FORMAT_BPP8_INDEXED, &image) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert_null(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/output-pixel-format", test_output_pixel_format, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/planar",              test_planar,              NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/unsupported",         test_unsupported,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+#ifdef SAIL_HAVE_BUILTIN_JPEG
+    { (char *)"/jpeg-raw-data",       test_jpeg_raw_data,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#endif
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/output-pixel-format",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,168 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static sail_status_t load_roi(const char *path, unsigned x, unsigned y, unsigned width, unsigned height, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    load_options->roi_x      = x;
+    load_options->roi_y      = y;
+    load_options->roi_width  = width;
+    load_options->roi_height = height;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
+                        /* cleanup */ sail_stop_loading(state));
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    return SAIL_OK;
+}
+
+static void assert_roi_equal(const struct sail_image *full, const struct sail_image *roi, unsigned x, unsigned y) {
+
+    munit_assert(roi->pixel_format == full->pixel_format);
+
+    const unsigned bytes_per_line = sail_bytes_per_line(roi->width, roi->pixel_format);
+
+    unsigned char *expected = munit_malloc(bytes_per_line);
+    unsigned char *actual   = munit_malloc(bytes_per_line);
+
+    for (unsigned row = 0; row < roi->height; row++) {
+        /* Copy both scan lines to get rid of garbage in unused bits. */
+        sail_copy_scan_line_pixels(sail_scan_line(full, y + row), x, roi->width, roi->pixel_format, expected);
+        sail_copy_scan_line_pixels(sail_scan_line(roi, row), 0, roi->width, roi->pixel_format, actual);
+
+        munit_assert_memory_equal(bytes_per_line, actual, expected);
+    }
+
+    free(actual);
+    free(expected);
+}
+
+static MunitResult test_roi(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *full;
+    munit_assert(sail_load_from_file(path, &full) == SAIL_OK);
+
+    const struct {
+        unsigned x;
+        unsigned y;
+        unsigned width;
+        unsigned height;
+    } rects[] = {
+        { 0,               0,                1,               1                },
+        { 1,               2,                full->width / 2, full->height / 3 },
+        { full->width / 3, full->height / 2, 100000,          100000           },
+        { full->width - 1, full->height - 1, 100000,          100000           },
+        { 0,               0,                full->width,     full->height     },
+    };
+
+    for (size_t i = 0; i < sizeof(rects) / sizeof(rects[0]); i++) {
+        if (rects[i].x >= full->width || rects[i].y >= full->height || rects[i].width == 0 || rects[i].height == 0) {
+            continue;
+        }
+
+        struct sail_image *roi = NULL;
+        munit_assert(load_roi(path, rects[i].x, rects[i].y, rects[i].width, rects[i].height, &roi) == SAIL_OK);
+        munit_assert(sail_check_image_valid(roi) == SAIL_OK);
+
+        munit_assert_uint(roi->width,  ==, SAIL_MIN(rects[i].width,  full->width  - rects[i].x));
+        munit_assert_uint(roi->height, ==, SAIL_MIN(rects[i].height, full->height - rects[i].y));
+        munit_assert_uint(roi->bytes_per_line, >=, sail_bytes_per_line(roi->width, roi->pixel_format));
+
+        assert_roi_equal(full, roi, rects[i].x, rects[i].y);
+
+        sail_destroy_image(roi);
+    }
+
+    sail_destroy_image(full);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_roi_outside(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_probe_file(path, &image, NULL) == SAIL_OK);
+
+    const unsigned width = image->width;
+
+    sail_destroy_image(image);
+
+    struct sail_image *roi = NULL;
+    munit_assert(load_roi(path, width, 0, 10, 10, &roi) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert_null(roi);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/roi",     test_roi,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/outside", test_roi_outside, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/roi",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,239 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+#ifdef SAIL_HAVE_BUILTIN_JPEG
+enum { WIDTH = 160, HEIGHT = 120, BUFFER_SIZE = 1024 * 1024 };
+
+/* Gradient with noise, so the output size and quality depend on the compression level noticeably. */
+static struct sail_image* noisy_image(void) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = WIDTH;
+    image->height         = HEIGHT;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(WIDTH, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * HEIGHT, &image->pixels) == SAIL_OK);
+
+    uint32_t seed = 1;
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            for (unsigned c = 0; c < 3; c++) {
+                seed = seed * 1664525u + 1013904223u;
+
+                const int value = (int)(column + row + c * 60) % 256 + (int)(seed >> 28) - 8;
+                *scan++ = (uint8_t)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+            }
+        }
+    }
+
+    return image;
+}
+
+static double decoded_ssim(const struct sail_image *image, const void *buffer, size_t size) {
+
+    struct sail_image *decoded;
+    munit_assert(sail_load_from_memory(buffer, size, &decoded) == SAIL_OK);
+
+    double ssim;
+    munit_assert(sail_compute_ssim(image, decoded, &ssim) == SAIL_OK);
+
+    sail_destroy_image(decoded);
+
+    return ssim;
+}
+
+static size_t save_with_level(const struct sail_image *image, const struct sail_codec_info *codec_info,
+                              double compression_level, void *buffer) {
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->compression_level = compression_level;
+
+    void *state;
+    munit_assert(sail_start_saving_into_memory_with_options(buffer, BUFFER_SIZE, codec_info, save_options, &state) == SAIL_OK);
+    sail_destroy_save_options(save_options);
+
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    size_t written;
+    munit_assert(sail_stop_saving_with_written(state, &written) == SAIL_OK);
+
+    return written;
+}
+
+static MunitResult test_ssim_target(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = noisy_image();
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpeg", &codec_info) == SAIL_OK);
+    const struct sail_compression_level *levels = codec_info->save_features->compression_level;
+
+    void *buffer = malloc(BUFFER_SIZE);
+    void *other_buffer = malloc(BUFFER_SIZE);
+
+    static const double TARGETS[] = { 0.8, 0.9, 0.97 };
+    size_t previous_written = 0;
+
+    for (size_t i = 0; i < sizeof(TARGETS) / sizeof(TARGETS[0]); i++) {
+        size_t written;
+        double compression_level;
+        munit_assert(sail_save_into_memory_with_target_quality(buffer, BUFFER_SIZE, image, codec_info, NULL,
+                                                               TARGETS[i], &written, &compression_level) == SAIL_OK);
+
+        /* The target is met. */
+        munit_assert_double(decoded_ssim(image, buffer, written), >=, TARGETS[i]);
+
+        /* The next compression level misses it. */
+        if (compression_level < levels->max_level) {
+            const size_t other_written = save_with_level(image, codec_info, compression_level + levels->step, other_buffer);
+            munit_assert_double(decoded_ssim(image, other_buffer, other_written), <, TARGETS[i]);
+        }
+
+        /* Higher targets need more bytes. */
+        munit_assert_size(written, >, previous_written);
+        previous_written = written;
+    }
+
+    free(other_buffer);
+    free(buffer);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_byte_budget(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = noisy_image();
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpeg", &codec_info) == SAIL_OK);
+    const struct sail_compression_level *levels = codec_info->save_features->compression_level;
+
+    void *buffer = malloc(BUFFER_SIZE);
+
+    /* Everything fits, so the best quality is selected. */
+    size_t best_written;
+    double compression_level;
+    munit_assert(sail_save_into_memory_with_target_quality(buffer, BUFFER_SIZE, image, codec_info, NULL,
+                                                           0, &best_written, &compression_level) == SAIL_OK);
+    munit_assert_double(compression_level, ==, levels->min_level);
+
+    /* The budget takes precedence over the quality. */
+    const size_t budget = best_written / 3;
+    size_t written;
+    munit_assert(sail_save_into_memory_with_target_quality(buffer, budget, image, codec_info, NULL,
+                                                           0.999, &written, &compression_level) == SAIL_OK);
+    munit_assert_size(written, <=, budget);
+    munit_assert_double(compression_level, >, levels->min_level);
+
+    /* The output is a valid image. */
+    struct sail_image *decoded;
+    munit_assert(sail_load_from_memory(buffer, written, &decoded) == SAIL_OK);
+    munit_assert_uint(decoded->width, ==, WIDTH);
+    munit_assert_uint(decoded->height, ==, HEIGHT);
+    sail_destroy_image(decoded);
+
+    /* The previous compression level doesn't fit. */
+    void *other_buffer = malloc(BUFFER_SIZE);
+    munit_assert_size(save_with_level(image, codec_info, compression_level - levels->step, other_buffer), >, budget);
+    free(other_buffer);
+
+    /* Nothing fits. */
+    munit_assert(sail_save_into_memory_with_target_quality(buffer, 100, image, codec_info, NULL,
+                                                           0, &written, NULL) == SAIL_ERROR_WRITE_IO);
+
+    free(buffer);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+#ifdef SAIL_HAVE_BUILTIN_BMP
+    struct sail_image *image = noisy_image();
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("bmp", &codec_info) == SAIL_OK);
+
+    void *buffer = malloc(BUFFER_SIZE);
+
+    size_t written;
+    munit_assert(sail_save_into_memory_with_target_quality(buffer, BUFFER_SIZE, image, codec_info, NULL,
+                                                           0.9, &written, NULL) == SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+
+    free(buffer);
+    sail_destroy_image(image);
+#endif
+
+    return MUNIT_OK;
+}
+#endif
+
+static MunitTest test_suite_tests[] = {
+#ifdef SAIL_HAVE_BUILTIN_JPEG
+    { (char *)"/ssim-target", test_ssim_target, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/byte-budget", test_byte_budget, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported", test_unsupported, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#endif
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/target-quality",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,219 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_thumbnail_size(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_probe_file(path, &image, NULL) == SAIL_OK);
+
+    const unsigned width  = image->width;
+    const unsigned height = image->height;
+
+    sail_destroy_image(image);
+
+    static const unsigned max_sizes[] = { 1, 16, 100000 };
+
+    for (size_t i = 0; i < sizeof(max_sizes) / sizeof(max_sizes[0]); i++) {
+        struct sail_image *thumbnail = NULL;
+        munit_assert(sail_load_thumbnail_from_file(path, max_sizes[i], &thumbnail) == SAIL_OK);
+        munit_assert_not_null(thumbnail);
+        munit_assert(sail_check_image_valid(thumbnail) == SAIL_OK);
+
+        munit_assert_uint(thumbnail->width,  <=, SAIL_MAX(width,  max_sizes[i]));
+        munit_assert_uint(thumbnail->height, <=, SAIL_MAX(height, max_sizes[i]));
+        munit_assert_uint(SAIL_MAX(thumbnail->width, thumbnail->height), <=, max_sizes[i]);
+
+        sail_destroy_image(thumbnail);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_thumbnail_invalid_size(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *thumbnail = NULL;
+    munit_assert(sail_load_thumbnail_from_file(path, 0, &thumbnail) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert_null(thumbnail);
+
+    return MUNIT_OK;
+}
+
+#ifdef SAIL_HAVE_BUILTIN_JPEG
+static sail_status_t fill_rgb_image(unsigned width, unsigned height, uint8_t r, uint8_t g, uint8_t b, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image_local->bytes_per_line = sail_bytes_per_line(width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)image_local->bytes_per_line * height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    for (unsigned row = 0; row < height; row++) {
+        uint8_t *scan = sail_scan_line(image_local, row);
+
+        for (unsigned column = 0; column < width; column++) {
+            *scan++ = r;
+            *scan++ = g;
+            *scan++ = b;
+        }
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t save_jpeg_into_memory(const struct sail_image *image, void *buffer, size_t buffer_size) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_extension("jpeg", &codec_info));
+
+    void *state;
+    SAIL_TRY(sail_start_saving_into_memory(buffer, buffer_size, codec_info, &state));
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image),
+                        /* cleanup */ sail_stop_saving(state));
+    SAIL_TRY(sail_stop_saving(state));
+
+    return SAIL_OK;
+}
+
+static MunitResult test_exif_thumbnail(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    enum { BUFFER_SIZE = 64 * 1024, PREVIEW_SIZE = 4 * 1024, EXIF_HEADER_SIZE = 8 + 2 + 4 + 2 + 2 * 12 + 4 };
+
+    /* Blue embedded thumbnail. */
+    struct sail_image *preview;
+    munit_assert(fill_rgb_image(20, 15, 0, 0, 255, &preview) == SAIL_OK);
+
+    uint8_t *exif = munit_malloc(EXIF_HEADER_SIZE + PREVIEW_SIZE);
+    munit_assert(save_jpeg_into_memory(preview, exif + EXIF_HEADER_SIZE, PREVIEW_SIZE) == SAIL_OK);
+    sail_destroy_image(preview);
+
+    /* Little-endian TIFF header, empty IFD0, and IFD1 pointing to the thumbnail. */
+    static const uint8_t header[] = {
+        'I', 'I', 42, 0, 8, 0, 0, 0,
+        /* IFD0. */
+        0, 0, 14, 0, 0, 0,
+        /* IFD1. */
+        2, 0,
+        0x01, 0x02, 4, 0, 1, 0, 0, 0, EXIF_HEADER_SIZE, 0, 0, 0,
+        0x02, 0x02, 4, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0,
+    };
+    munit_assert_size(sizeof(header), ==, EXIF_HEADER_SIZE);
+    memcpy(exif, header, sizeof(header));
+    exif[14 + 2 + 12 + 8] = (uint8_t)(PREVIEW_SIZE & 0xFF);
+    exif[14 + 2 + 12 + 9] = (uint8_t)(PREVIEW_SIZE >> 8);
+
+    /* Red main image. */
+    struct sail_image *image;
+    munit_assert(fill_rgb_image(256, 192, 255, 0, 0, &image) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_node(&image->meta_data_node) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_EXIF, &image->meta_data_node->meta_data) == SAIL_OK);
+    munit_assert(sail_set_variant_data(image->meta_data_node->meta_data->value, exif, EXIF_HEADER_SIZE + PREVIEW_SIZE) == SAIL_OK);
+
+    void *buffer = munit_malloc(BUFFER_SIZE);
+    munit_assert(save_jpeg_into_memory(image, buffer, BUFFER_SIZE) == SAIL_OK);
+    sail_destroy_image(image);
+
+    /* The embedded thumbnail is larger than requested, so it's used and downscaled. */
+    struct sail_image *thumbnail;
+    munit_assert(sail_load_thumbnail_from_memory(buffer, BUFFER_SIZE, 16, &thumbnail) == SAIL_OK);
+
+    munit_assert_uint(thumbnail->width,  ==, 16);
+    munit_assert_uint(thumbnail->height, ==, 12);
+
+    const uint8_t *pixel = sail_scan_line(thumbnail, 6);
+    munit_assert_uint8(pixel[0], <, 64);
+    munit_assert_uint8(pixel[2], >, 192);
+
+    sail_destroy_image(thumbnail);
+
+    /* The embedded thumbnail is too small, so the main image is decoded. */
+    munit_assert(sail_load_thumbnail_from_memory(buffer, BUFFER_SIZE, 64, &thumbnail) == SAIL_OK);
+
+    munit_assert_uint(thumbnail->width,  ==, 64);
+    munit_assert_uint(thumbnail->height, ==, 48);
+
+    pixel = sail_scan_line(thumbnail, 24);
+    munit_assert_uint8(pixel[0], >, 192);
+    munit_assert_uint8(pixel[2], <, 64);
+
+    sail_destroy_image(thumbnail);
+
+    free(buffer);
+    free(exif);
+
+    return MUNIT_OK;
+}
+#endif
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/size",         test_thumbnail_size,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/invalid-size", test_thumbnail_invalid_size, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+#ifdef SAIL_HAVE_BUILTIN_JPEG
+    { (char *)"/exif",         test_exif_thumbnail,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+#endif
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/thumbnail",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
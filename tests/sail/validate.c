@@ -0,0 +1,289 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static void put_le16(uint8_t *data, uint16_t value) {
+
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void put_le32(uint8_t *data, uint32_t value) {
+
+    put_le16(data, (uint16_t)value);
+    put_le16(data + 2, (uint16_t)(value >> 16));
+}
+
+/* 4x4 RLE8 BMP with a 200-pixel run in the first scan line. Returns the file size. */
+static size_t build_long_rle8_run_bmp(uint8_t data[128]) {
+
+    static const uint8_t RLE_DATA[] = { 200, 1, 0, 0, 4, 1, 0, 0, 4, 1, 0, 0, 4, 1, 0, 1 };
+
+    const uint32_t pixels_offset = 14 + 40 + 2 * 4;
+    const uint32_t file_size = pixels_offset + sizeof(RLE_DATA);
+
+    memset(data, 0, 128);
+
+    /* File header. */
+    data[0] = 'B';
+    data[1] = 'M';
+    put_le32(data + 2, file_size);
+    put_le32(data + 10, pixels_offset);
+
+    /* BITMAPINFOHEADER with BI_RLE8 compression and two palette colors. */
+    put_le32(data + 14, 40);
+    put_le32(data + 18, 4);
+    put_le32(data + 22, 4);
+    put_le16(data + 26, 1);
+    put_le16(data + 28, 8);
+    put_le32(data + 30, 1);
+    put_le32(data + 34, sizeof(RLE_DATA));
+    put_le32(data + 46, 2);
+
+    /* White palette color. */
+    memset(data + 58, 0xFF, 3);
+
+    memcpy(data + pixels_offset, RLE_DATA, sizeof(RLE_DATA));
+
+    return file_size;
+}
+
+/* Loads all the frames to get the expected statistics. */
+static sail_status_t load_stats(const char *path, struct sail_validation_stats *stats) {
+
+    *stats = (struct sail_validation_stats) {
+        .pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN,
+    };
+
+    void *state;
+    SAIL_TRY(sail_start_loading_from_file(path, NULL, &state));
+
+    struct sail_image *image;
+    sail_status_t status;
+
+    while ((status = sail_load_next_frame(state, &image)) == SAIL_OK) {
+        if (stats->frames == 0) {
+            stats->pixel_format = image->pixel_format;
+        }
+
+        stats->frames++;
+        stats->width       = SAIL_MAX(stats->width, image->width);
+        stats->height      = SAIL_MAX(stats->height, image->height);
+        stats->pixels     += (uint64_t)image->width * image->height;
+        stats->buffer_size = SAIL_MAX(stats->buffer_size, (size_t)image->bytes_per_line);
+
+        sail_destroy_image(image);
+    }
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    if (status != SAIL_ERROR_NO_MORE_FRAMES) {
+        return status;
+    }
+
+    return SAIL_OK;
+}
+
+static void assert_stats_equal(const struct sail_validation_stats *stats, const struct sail_validation_stats *expected,
+                                const struct sail_codec_info *codec_info) {
+
+    munit_assert_uint(stats->frames, ==, expected->frames);
+    munit_assert_uint(stats->width,  ==, expected->width);
+    munit_assert_uint(stats->height, ==, expected->height);
+    munit_assert(stats->pixel_format == expected->pixel_format);
+    munit_assert_uint64(stats->pixels, ==, expected->pixels);
+
+    /* Codecs with validation support need a single scan line. */
+    if (codec_info->load_features->features & SAIL_CODEC_FEATURE_VALIDATE) {
+        munit_assert_size(stats->buffer_size, ==, expected->buffer_size);
+    } else {
+        munit_assert_size(stats->buffer_size, >=, expected->buffer_size);
+    }
+}
+
+static MunitResult test_validate_file(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_validation_stats expected;
+    munit_assert(load_stats(path, &expected) == SAIL_OK);
+
+    struct sail_validation_stats stats;
+    munit_assert(sail_validate_file(path, &stats) == SAIL_OK);
+
+    assert_stats_equal(&stats, &expected, codec_info);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_validate_memory(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    /* Some formats cannot be detected by magic numbers. */
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_by_magic_number_from_memory(data, data_size, &codec_info) != SAIL_OK) {
+        sail_free(data);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_validation_stats expected;
+    munit_assert(load_stats(path, &expected) == SAIL_OK);
+
+    struct sail_validation_stats stats;
+    munit_assert(sail_validate_memory(data, data_size, &stats) == SAIL_OK);
+
+    assert_stats_equal(&stats, &expected, codec_info);
+
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_validate_truncated(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    /* Only codecs with validation support are guaranteed to detect truncated pixels. */
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_by_magic_number_from_memory(data, data_size, &codec_info) != SAIL_OK ||
+            !(codec_info->load_features->features & SAIL_CODEC_FEATURE_VALIDATE)) {
+        sail_free(data);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_validation_stats stats;
+    munit_assert(sail_validate_memory(data, data_size / 2, &stats) != SAIL_OK);
+    munit_assert_uint(stats.frames, ==, 0);
+
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_validate_long_rle_run(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    uint8_t data[128];
+    const size_t data_size = build_long_rle8_run_bmp(data);
+
+    struct sail_validation_stats stats;
+    munit_assert(sail_validate_memory(data, data_size, &stats) == SAIL_ERROR_BROKEN_IMAGE);
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_memory(data, data_size, &image) == SAIL_ERROR_BROKEN_IMAGE);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_validate_limits(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_validation_stats expected;
+    munit_assert(load_stats(path, &expected) == SAIL_OK);
+
+    struct sail_load_options limits = { 0 };
+    struct sail_validation_stats stats;
+
+    limits.max_width  = expected.width;
+    limits.max_height = expected.height;
+    limits.max_frames = expected.frames;
+    munit_assert(sail_validate_file_with_options(path, &limits, &stats) == SAIL_OK);
+    munit_assert_uint(stats.frames, ==, expected.frames);
+
+    limits.max_frames = expected.frames - 1;
+    if (limits.max_frames > 0) {
+        munit_assert(sail_validate_file_with_options(path, &limits, &stats) == SAIL_ERROR_LIMIT_EXCEEDED);
+        munit_assert_uint(stats.frames, ==, limits.max_frames);
+    }
+
+    limits.max_frames = 0;
+    limits.max_width  = expected.width - 1;
+    if (limits.max_width > 0) {
+        munit_assert(sail_validate_file_with_options(path, &limits, &stats) == SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    /* Every frame needs more than a single byte of pixels. */
+    limits = (struct sail_load_options) { .max_memory = 1 };
+    if (expected.buffer_size > 1) {
+        munit_assert(sail_validate_file_with_options(path, &limits, &stats) == SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/file",      test_validate_file,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/memory",    test_validate_memory,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/truncated", test_validate_truncated, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/limits",    test_validate_limits,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { (char *)"/long-rle-run", test_validate_long_rle_run, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/validate",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}